@@ -0,0 +1,36 @@
+#-------------------------------------------------
+#
+# QML tools benchmarks
+#
+#-------------------------------------------------
+
+QT += core xml
+
+CONFIG   += console
+
+TEMPLATE = app
+
+SOURCES += \
+    source/cpp/Test/benchmarks-main.cpp
+
+DEPENDPATH += qt-plus
+
+win32 {
+    LIBS += -lpsapi
+}
+
+DESTDIR = $$PWD/bin
+MOC_DIR = $$PWD/moc/qt-plus-benchmarks
+OBJECTS_DIR = $$PWD/obj/qt-plus-benchmarks
+
+QMAKE_CLEAN *= $$DESTDIR/*$$TARGET*
+QMAKE_CLEAN *= $$MOC_DIR/*$$TARGET*
+QMAKE_CLEAN *= $$OBJECTS_DIR/*$$TARGET*
+
+CONFIG(debug, debug|release) {
+    TARGET = qt-plus-benchmarksd
+    LIBS += -L$$PWD/bin/ -lqt-plusd
+} else {
+    TARGET = qt-plus-benchmarks
+    LIBS += -L$$PWD/bin/ -lqt-plus
+}
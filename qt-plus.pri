@@ -19,7 +19,9 @@ HEADERS += \
     source/cpp/Image/CLargeMatrix.h \
     source/cpp/Image/CImageHistogram.h \
     source/cpp/Image/CImageUtilities.h \
+    source/cpp/CSoundRingBuffer.h \
     source/cpp/CSoundSynth.h \
+    source/cpp/CSoundVoiceBank.h \
     source/cpp/CTextGenerator.h \
     source/cpp/CSecureContext.h \
     source/cpp/CTDMADevice.h \
@@ -30,6 +32,7 @@ HEADERS += \
     source/cpp/File/CFileUtilities.h \
     source/cpp/File/CRollingFiles.h \
     source/cpp/Assembly/CAssemblyEngine.h \
+    source/cpp/Assembly/CAssemblyHeap.h \
     source/cpp/RemoteControl/CRemoteControl.h \
     source/cpp/RemoteControl/CRemoteControlData.h \
     source/cpp/RemoteControl/CRemoteControlUser.h \
@@ -56,13 +59,17 @@ HEADERS += \
     source/cpp/CInterpolator.h \
     source/cpp/GeoTools/coordcnv.h \
     source/cpp/GeoTools/geocent.h \
+    source/cpp/GeoTools/geobatch.h \
     source/cpp/GeoTools/mgrs.h \
     source/cpp/GeoTools/polarst.h \
     source/cpp/GeoTools/tranmerc.h \
     source/cpp/GeoTools/ups.h \
     source/cpp/GeoTools/utm.h \
+    source/cpp/GeoTools/wmm.h \
     source/cpp/GeoTools/UtmMgrs.h \
     source/cpp/GeoTools/geotrans.h \
+    source/cpp/CGeoIndex.h \
+    source/cpp/CGeoReferenceFrame.h \
     source/cpp/CGeoUtilities.h \
     source/cpp/QMLTree/QMLFormatter.h \
     source/cpp/QMLTree/QMLEntity.h \
@@ -94,6 +101,12 @@ HEADERS += \
     source/cpp/QMLTree/QMLConditional.h \
     source/cpp/QMLTree/QMLComment.h \
     source/cpp/QMLTree/QMLTreeContext.h \
+    source/cpp/QMLTree/QMLTreeCache.h \
+    source/cpp/QMLTree/QMLEntityFactory.h \
+    source/cpp/QMLTree/QMLEntityArena.h \
+    source/cpp/QMLTree/QMLNameTable.h \
+    source/cpp/QMLTree/QMLXMLWriter.h \
+    source/cpp/QMLTree/QMLCorpusGenerator.h \
     source/cpp/QMLTree/QMLAnalyzer.h \
     source/cpp/rsa/source/BigInt.h \
     source/cpp/rsa/source/Key.h \
@@ -116,6 +129,7 @@ SOURCES += \
     source/cpp/Image/CLargeMatrix.cpp \
     source/cpp/Image/CImageHistogram.cpp \
     source/cpp/Image/CImageUtilities.cpp \
+    source/cpp/CSoundRingBuffer.cpp \
     source/cpp/CSoundSynth.cpp \
     source/cpp/CTextGenerator.cpp \
     source/cpp/CSecureContext.cpp \
@@ -129,6 +143,9 @@ SOURCES += \
     source/cpp/Assembly/CAssemblyEngine.cpp \
     source/cpp/Assembly/CAssemblyEngine_Compile.cpp \
     source/cpp/Assembly/CAssemblyEngine_Interrupts.cpp \
+    source/cpp/Assembly/CAssemblyEngine_Debug.cpp \
+    source/cpp/Assembly/CAssemblyEngine_Optimize.cpp \
+    source/cpp/Assembly/CAssemblyHeap.cpp \
     source/cpp/RemoteControl/CRemoteControl.cpp \
     source/cpp/RemoteControl/CRemoteControlData.cpp \
     source/cpp/RemoteControl/CRemoteControlUser.cpp \
@@ -158,8 +175,11 @@ SOURCES += \
     source/cpp/GeoTools/tranmerc.cpp \
     source/cpp/GeoTools/ups.cpp \
     source/cpp/GeoTools/utm.cpp \
+    source/cpp/GeoTools/wmm.cpp \
     source/cpp/GeoTools/UtmMgrs.cpp \
     source/cpp/GeoTools/geotrans.cpp \
+    source/cpp/CGeoIndex.cpp \
+    source/cpp/CGeoReferenceFrame.cpp \
     source/cpp/CGeoUtilities.cpp \
     source/cpp/QMLTree/QMLFormatter.cpp \
     source/cpp/QMLTree/QMLEntity.cpp \
@@ -191,6 +211,12 @@ SOURCES += \
     source/cpp/QMLTree/QMLConditional.cpp \
     source/cpp/QMLTree/QMLComment.cpp \
     source/cpp/QMLTree/QMLTreeContext.cpp \
+    source/cpp/QMLTree/QMLTreeCache.cpp \
+    source/cpp/QMLTree/QMLEntityFactory.cpp \
+    source/cpp/QMLTree/QMLEntityArena.cpp \
+    source/cpp/QMLTree/QMLNameTable.cpp \
+    source/cpp/QMLTree/QMLXMLWriter.cpp \
+    source/cpp/QMLTree/QMLCorpusGenerator.cpp \
     source/cpp/QMLTree/QMLGrammarParser.cpp \
     source/cpp/QMLTree/QMLAnalyzer.cpp \
     source/cpp/rsa/source/BigInt.cpp \
@@ -202,3 +228,27 @@ SOURCES += \
 
 RESOURCES += \
     resources.qrc
+
+# Sources whose loops GCC must turn into SIMD code at -O2 : sqrt must not set errno and the loops need the cost model of -O3
+# The flags are given to these files only, through a compiler of their own
+SIMD_SOURCES = \
+    source/cpp/CSoundVoiceBank.cpp \
+    source/cpp/GeoTools/geobatch.cpp
+
+*-g++* {
+    CONFIG(release, debug|release) {
+        SIMD_CXXFLAGS = -fno-math-errno -fvect-cost-model=dynamic
+    }
+
+    simd_cxx.name = Compiling ${QMAKE_FILE_IN} with SIMD flags
+    simd_cxx.input = SIMD_SOURCES
+    simd_cxx.dependency_type = TYPE_C
+    simd_cxx.variable_out = OBJECTS
+    simd_cxx.output = ${QMAKE_VAR_OBJECTS_DIR}${QMAKE_FILE_IN_BASE}$${first(QMAKE_EXT_OBJ)}
+    simd_cxx.commands = $${QMAKE_CXX} $(CXXFLAGS) $${SIMD_CXXFLAGS} $(INCPATH) -c ${QMAKE_FILE_IN} -o ${QMAKE_FILE_OUT}
+
+    QMAKE_EXTRA_COMPILERS += simd_cxx
+    OTHER_FILES += $${SIMD_SOURCES}
+} else {
+    SOURCES += $${SIMD_SOURCES}
+}
@@ -13,28 +13,15 @@
 
 //-------------------------------------------------------------------------------------------------
 
-static void msleep(unsigned long msecs)
-{
-    QMutex mutex;
-    mutex.lock();
-
-    QWaitCondition waitCondition;
-    waitCondition.wait(&mutex, msecs);
-
-    mutex.unlock(); // Not necessary since new mutex will always be created,
-    // but since destroying locked mutex
-    // is bringing undefined behavior, let's follow some ethics
-}
-
-//-------------------------------------------------------------------------------------------------
-
 CAssemblyEngine::CAssemblyEngine()
     : m_pMachine(new CAssemblyMachine())
     , m_iColumns(CONSOLE_W)
     , m_iRows(CONSOLE_H)
+    , m_bOptimize(false)
 {
     connect(m_pMachine, SIGNAL(executing(const QString&)), this, SLOT(onExecuting(const QString&)));
-    connect(m_pMachine, SIGNAL(consoleCharChanged(qint32, qint32, qint32)), this, SLOT(onConsoleCharChanged(qint32, qint32, qint32)));
+    connect(m_pMachine, SIGNAL(consoleRegionChanged(const QRect&, const QVector<qint32>&)), this, SLOT(onConsoleRegionChanged(const QRect&, const QVector<qint32>&)));
+    connect(m_pMachine, SIGNAL(debugPaused(int, qint32)), this, SLOT(onDebugPaused(int, qint32)));
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -81,6 +68,95 @@ CAssemblyMachine::CRegisters CAssemblyEngine::registers() const
 
 //-------------------------------------------------------------------------------------------------
 
+QVector<qint32> CAssemblyEngine::console() const
+{
+    return m_pMachine->consoleSnapshot(QRect(0, 0, CONSOLE_W, CONSOLE_H));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyEngine::setConsoleFrameInterval(int value)
+{
+    m_pMachine->setConsoleFrameInterval(value);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyEngine::setOptimize(bool value)
+{
+    m_bOptimize = value;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int CAssemblyEngine::addLineBreakpoint(int iLine)
+{
+    CAssemblyMachine::CBreakpoint tBreakpoint;
+    tBreakpoint.iLine = iLine;
+
+    return m_pMachine->addBreakpoint(tBreakpoint);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int CAssemblyEngine::addBreakpoint(const CAssemblyMachine::CBreakpoint& tBreakpoint)
+{
+    return m_pMachine->addBreakpoint(tBreakpoint);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyEngine::removeBreakpoint(int iIdentifier)
+{
+    m_pMachine->removeBreakpoint(iIdentifier);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyEngine::clearBreakpoints()
+{
+    m_pMachine->clearBreakpoints();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyEngine::debugStep()
+{
+    m_pMachine->debugCommand(CAssemblyMachine::dcStep);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyEngine::debugStepOver()
+{
+    m_pMachine->debugCommand(CAssemblyMachine::dcStepOver);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyEngine::debugContinue()
+{
+    m_pMachine->debugCommand(CAssemblyMachine::dcContinue);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyEngine::debugPause()
+{
+    m_pMachine->debugPause();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyEngine::debugStop()
+{
+    // Pausing makes the machine read the stop command even if it is running
+    m_pMachine->debugCommand(CAssemblyMachine::dcStop);
+    m_pMachine->debugPause();
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QByteArray CAssemblyEngine::stack(int iFrom, int iCount) const
 {
     return m_pMachine->stack().mid(iFrom, iCount);
@@ -88,14 +164,45 @@ QByteArray CAssemblyEngine::stack(int iFrom, int iCount) const
 
 //-------------------------------------------------------------------------------------------------
 
+QByteArray CAssemblyEngine::ram(int iFrom, int iCount) const
+{
+    return m_pMachine->data().mid(iFrom, iCount);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+CAssemblyHeapStatistics CAssemblyEngine::heapStatistics() const
+{
+    return m_pMachine->heapStatistics();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool CAssemblyEngine::isOptimized() const
+{
+    return m_pMachine->isOptimized();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int CAssemblyEngine::codeSize() const
+{
+    return m_pMachine->codeSize();
+}
+
+//-------------------------------------------------------------------------------------------------
+
 int CAssemblyEngine::evaluate(const QString& sCode, int iOperand1, int iOperand2, int iOperand3, int iOperand4, bool bDebug)
 {
     m_pMachine->setDebug(bDebug);
 
-    if (m_pMachine->code() != sCode)
+    if (m_pMachine->code() != sCode || m_pMachine->isOptimizeAttempted() != m_bOptimize)
     {
         m_pMachine->setCode(sCode);
         m_pMachine->compile();
+
+        if (m_bOptimize)
+            m_pMachine->optimize();
     }
 
     return m_pMachine->run(iOperand1, iOperand2, iOperand3, iOperand4);
@@ -110,9 +217,16 @@ void CAssemblyEngine::onExecuting(const QString& sText)
 
 //-------------------------------------------------------------------------------------------------
 
-void CAssemblyEngine::onConsoleCharChanged(qint32 x, qint32 y, qint32 c)
+void CAssemblyEngine::onConsoleRegionChanged(const QRect& rRegion, const QVector<qint32>& vSnapshot)
+{
+    emit consoleRegionChanged(rRegion, vSnapshot);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyEngine::onDebugPaused(int iLine, qint32 iAddress)
 {
-    emit consoleCharChanged(x, y, c);
+    emit debugPaused(iLine, iAddress);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -121,6 +235,15 @@ CAssemblyMachine::CAssemblyMachine()
     : m_iLine(0)
     , m_iColumn(0)
     , m_bDebug(false)
+    , m_bOptimized(false)
+    , m_bOptimizeAttempted(false)
+    , m_iConsoleFrameInterval(CONSOLE_FRAME_INTERVAL)
+    , m_eDebugCommand(dcNone)
+    , m_eDebugMode(dcContinue)
+    , m_iStepOverIP(0)
+    , m_iStepOverSP(0)
+    , m_iNextBreakpoint(1)
+    , m_bDebugStop(false)
 {
     m_mOpcodeToString[Op_A1] = "A1";
     m_mOpcodeToString[Op_A2] = "A2";
@@ -193,15 +316,42 @@ int CAssemblyMachine::run(int iOperand1, int iOperand2, int iOperand3, int iOper
 
     pushInt32(0);
 
+    m_tConsoleTimer.start();
+
+    m_eDebugMode = dcContinue;
+    m_bDebugStop = false;
+
+    // A pause requested while not running, or outside debug mode, must not break this run
+    m_iPauseRequested.storeRelease(0);
+
+    m_tDebugMutex.lock();
+    m_eDebugCommand = dcNone;
+    m_tDebugMutex.unlock();
+
+    if (m_bDebug)
+        updateBreakpointIndex();
+
     while (true)
     {
+        // Between breakpoints, the only debug overhead is a bit test
+        if (m_bDebug && mustBreak())
+        {
+            waitForDebugCommand();
+
+            if (m_bDebugStop)
+                break;
+        }
+
         if (processNextInstruction())
             break;
 
-        if (m_bDebug)
-            msleep(10);
+        // Console writes are coalesced and notified at most once per frame interval
+        if (m_rConsoleDirty.isNull() == false && m_tConsoleTimer.elapsed() >= m_iConsoleFrameInterval)
+            flushConsole();
     }
 
+    flushConsole();
+
     return m_rCPU.D1;
 }
 
@@ -221,6 +371,13 @@ void CAssemblyMachine::setDebug(bool value)
 
 //-------------------------------------------------------------------------------------------------
 
+void CAssemblyMachine::setConsoleFrameInterval(int value)
+{
+    m_iConsoleFrameInterval = value;
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QString CAssemblyMachine::code() const
 {
     return m_sCode;
@@ -228,6 +385,13 @@ QString CAssemblyMachine::code() const
 
 //-------------------------------------------------------------------------------------------------
 
+int CAssemblyMachine::codeSize() const
+{
+    return m_baCode.count();
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QByteArray& CAssemblyMachine::data()
 {
     return m_baData;
@@ -254,9 +418,6 @@ bool CAssemblyMachine::processNextInstruction()
     {
         qint32 offset = readOpcodes(m_baData.constData() + m_rCPU.IP, &leftOpCode, &centerOpCode, &rightOpCode, &iLeftValue, &iRightValue);
 
-        if (m_bDebug)
-            emit executing(QString("%1 : %2").arg(currentLine()).arg(disassemble(m_baData.constData() + m_rCPU.IP).first));
-
         m_rCPU.IP += offset;
 
         if (leftOpCode == Op_Nop)
@@ -487,15 +648,19 @@ bool CAssemblyMachine::processNextInstruction()
             {
             case INT_MEM:
                 handleInt_Mem();
+                break;
 
             case INT_TIME:
                 handleInt_Time();
+                break;
 
             case INT_FILE:
                 handleInt_File();
+                break;
 
             case INT_THREAD:
                 handleInt_Thread();
+                break;
 
             default:
                 break;
@@ -803,12 +968,67 @@ void CAssemblyMachine::writeRam(qint32 iAddress, qint32 iValue)
 
     if (iAddress >= RAM_CONSOLE_LOW && iAddress < RAM_CONSOLE_HIGH)
     {
-        qint32 stride = CONSOLE_W * sizeof(qint32);
-        qint32 y = (iAddress - RAM_CONSOLE_LOW) / stride;
-        qint32 x = ((iAddress - RAM_CONSOLE_LOW) % stride) / sizeof(qint32);
+        markConsoleDirty(iAddress);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyMachine::markConsoleDirty(qint32 iAddress)
+{
+    qint32 stride = CONSOLE_W * sizeof(qint32);
+    qint32 y = (iAddress - RAM_CONSOLE_LOW) / stride;
+    qint32 x = ((iAddress - RAM_CONSOLE_LOW) % stride) / sizeof(qint32);
+
+    if (m_rConsoleDirty.isNull())
+    {
+        m_rConsoleDirty = QRect(x, y, 1, 1);
+    }
+    else
+    {
+        m_rConsoleDirty |= QRect(x, y, 1, 1);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyMachine::flushConsole()
+{
+    if (m_rConsoleDirty.isNull() == false)
+    {
+        QRect rRegion = m_rConsoleDirty;
+        m_rConsoleDirty = QRect();
+        m_tConsoleTimer.restart();
+
+        emit consoleRegionChanged(rRegion, consoleSnapshot(rRegion));
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+QVector<qint32> CAssemblyMachine::consoleSnapshot(const QRect& rRegion) const
+{
+    QRect rClipped = rRegion & QRect(0, 0, CONSOLE_W, CONSOLE_H);
+    QVector<qint32> vSnapshot;
+
+    if (rClipped.isEmpty() || m_baData.count() < RAM_CONSOLE_HIGH)
+        return vSnapshot;
+
+    vSnapshot.reserve(rClipped.width() * rClipped.height());
+
+    const qint32* pConsole = (const qint32*) (m_baData.constData() + RAM_CONSOLE_LOW);
+
+    for (int y = rClipped.top(); y <= rClipped.bottom(); y++)
+    {
+        const qint32* pRow = pConsole + y * CONSOLE_W;
 
-        emit consoleCharChanged(x, y, iValue);
+        for (int x = rClipped.left(); x <= rClipped.right(); x++)
+        {
+            vSnapshot << pRow[x];
+        }
     }
+
+    return vSnapshot;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -865,7 +1085,11 @@ void CAssemblyMachine::reset()
 
     // Reset OS
 
-    m_baMemAlloc.clear();
+    m_tHeap.reset(0, 0);
+
+    // Reset console
+
+    m_rConsoleDirty = QRect();
 
     for (QFile* pFile : m_vFiles)
 		delete pFile;
@@ -909,6 +1133,13 @@ CAssemblyMachine::CRegisters CAssemblyMachine::registers() const
 
 //-------------------------------------------------------------------------------------------------
 
+CAssemblyHeapStatistics CAssemblyMachine::heapStatistics() const
+{
+    return m_tHeap.statistics();
+}
+
+//-------------------------------------------------------------------------------------------------
+
 bool CAssemblyMachine::isOperand(EOpCode eOpCode) const
 {
     return (eOpCode >= Op_A1 && eOpCode <= Op_Literal);
@@ -9,10 +9,19 @@
 #include <QString>
 #include <QVector>
 #include <QMap>
+#include <QHash>
 #include <QPair>
 #include <QByteArray>
 #include <QMutex>
 #include <QFile>
+#include <QRect>
+#include <QElapsedTimer>
+#include <QWaitCondition>
+#include <QBitArray>
+#include <QAtomicInt>
+
+// Application
+#include "CAssemblyHeap.h"
 
 //-------------------------------------------------------------------------------------------------
 
@@ -36,6 +45,7 @@
 #define CONSOLE_H               25
 #define INPUT_RAM_SIZE          512
 #define OS_RAM_SIZE             4096
+#define CONSOLE_FRAME_INTERVAL  16          // Milliseconds between two console notifications
 
 #define REG_SIZE_BYTE           0
 #define REG_SIZE_WORD           1
@@ -51,6 +61,9 @@
 #define INT_MEM_ALLOC           1
 #define INT_MEM_FREE            2
 
+// Returned by INT_MEM_ALLOC when asked for another heap region while blocks are still allocated
+#define INT_MEM_ERROR_HEAP_IN_USE   (-1)
+
 #define INT_FILE_OPEN           1
 #define INT_FILE_CLOSE          2
 #define INT_FILE_DELETE         3
@@ -180,6 +193,87 @@ public:
         } Flags;
     };
 
+    enum EDebugCommand
+    {
+        dcNone,
+        dcStep,
+        dcStepOver,
+        dcContinue,
+        dcStop
+    };
+
+    class CBreakpoint
+    {
+    public:
+
+        enum ECondition
+        {
+            bcNone,
+            bcRegister,         // Compare the register eRegister with iValue
+            bcRam               // Compare the long at iRamAddress with iValue
+        };
+
+        enum EComparison
+        {
+            bcEqual,
+            bcNotEqual,
+            bcGreater,
+            bcLower
+        };
+
+        CBreakpoint()
+            : iAddress(0)
+            , iLine(0)
+            , eCondition(bcNone)
+            , eComparison(bcEqual)
+            , eRegister(Op_None)
+            , iRamAddress(0)
+            , iValue(0)
+            , bEnabled(true)
+        {
+        }
+
+        qint32                              iAddress;           // Absolute address, used when iLine is 0
+        int                                 iLine;              // 1-based source line
+        ECondition                          eCondition;
+        EComparison                         eComparison;
+        EOpCode                             eRegister;
+        qint32                              iRamAddress;
+        qint32                              iValue;
+        bool                                bEnabled;
+    };
+
+    class CInstruction
+    {
+    public:
+
+        CInstruction()
+            : iOffset(0)
+            , iLine(0)
+            , eLeft(Op_None)
+            , eCenter(Op_None)
+            , eRight(Op_None)
+            , iValue(0)
+            , iTarget(-1)
+            , bData(false)
+            , bLeader(false)
+            , bRemoved(false)
+        {
+        }
+
+        qint32                              iOffset;            // Offset in the compiled code
+        int                                 iLine;
+        EOpCode                             eLeft;
+        EOpCode                             eCenter;
+        EOpCode                             eRight;
+        qint32                              iValue;             // Value of a constant right operand
+        qint32                              iTarget;            // Code offset referenced by the constant, -1 if not a label
+        QByteArray                          baData;             // Reserved bytes
+        bool                                bData;
+        bool                                bLeader;            // First instruction of a basic block
+        bool                                bRemoved;
+    };
+
     //-------------------------------------------------------------------------------------------------
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
@@ -196,16 +290,25 @@ public:
 
     void setDebug(bool value);
 
+    //! Sets the minimum delay in milliseconds between two consoleRegionChanged notifications
+    void setConsoleFrameInterval(int value);
+
     //-------------------------------------------------------------------------------------------------
     // Getters
     //-------------------------------------------------------------------------------------------------
 
     QString code() const;
 
+    //! Returns the size in bytes of the compiled code
+    int codeSize() const;
+
     QByteArray& data();
 
     QByteArray& stack();
 
+    //! Returns the characters of a console region, row by row
+    QVector<qint32> consoleSnapshot(const QRect& rRegion) const;
+
     //-------------------------------------------------------------------------------------------------
     // Control methods
     //-------------------------------------------------------------------------------------------------
@@ -222,6 +325,12 @@ public:
     //! Return registers
     CRegisters registers() const;
 
+    //! Return heap allocation statistics
+    CAssemblyHeapStatistics heapStatistics() const;
+
+    //! Notifies the console region modified since the last call, if any
+    void flushConsole();
+
     int run(int iOperand1 = 0, int iOperand2 = 0, int iOperand3 = 0, int iOperand4 = 0);
 
     //! Register read/write
@@ -244,19 +353,56 @@ public:
     //! Return copmile errors
     QString compileErrors() const;
 
+    //! File : CAssemblyEngine_Optimize
+
+    //! Rewrites the compiled code : jump threading, peephole rewrites and constant folding
+    void optimize();
+
+    //! Returns true if the compiled code went through optimize()
+    bool isOptimized() const;
+
+    //! Returns true if optimize() was called on the compiled code, even if it left it unchanged
+    bool isOptimizeAttempted() const;
+
     //! Disassembles an instruction
     QPair<QString, int> disassemble(const char* pCode) const;
 
+    //! File : CAssemblyEngine_Debug
+
+    //! Adds a breakpoint, returns its identifier
+    int addBreakpoint(const CBreakpoint& tBreakpoint);
+
+    //! Removes a breakpoint
+    void removeBreakpoint(int iIdentifier);
+
+    //! Removes all breakpoints
+    void clearBreakpoints();
+
+    //! Returns all breakpoints by identifier
+    QMap<int, CBreakpoint> breakpoints() const;
+
+    //! Sends a command to the paused machine, may be called from any thread
+    void debugCommand(EDebugCommand eCommand);
+
+    //! Requests the running machine to pause at the next instruction, may be called from any thread
+    //! Only honored while running in debug mode, the request is dropped when the next run starts
+    void debugPause();
+
 signals:
 
     void executing(const QString& sText);
 
-    void consoleCharChanged(qint32 x, qint32 y, qint32 c);
+    void consoleRegionChanged(const QRect& rRegion, const QVector<qint32>& vSnapshot);
+
+    void debugPaused(int iLine, qint32 iAddress);
 
 protected:
 
     bool processNextInstruction();
 
+    //! Adds a console cell to the dirty region
+    void markConsoleDirty(qint32 iAddress);
+
     qint32 readOpcodes(const char* pCode, EOpCode* leftOpCode, EOpCode* centerOpCode, EOpCode* rightOpCode, qint32* iLeftValue, qint32* iRightValue) const;
 
     void pushInt8(quint8 iValue);
@@ -277,6 +423,37 @@ protected:
     bool isLiteral(EOpCode eOpCode) const;
     bool isSize(EOpCode eOpCode) const;
 
+    //! File : CAssemblyEngine_Optimize
+
+    //! Splits the compiled code into instructions, returns an empty list if it cannot be decoded
+    QVector<CInstruction> decodeInstructions() const;
+
+    //! Retargets jumps and calls that land on unconditional jumps
+    void threadJumps(QVector<CInstruction>& vInstructions) const;
+
+    //! Applies peephole rewrites and constant folding inside basic blocks
+    void rewriteInstructions(QVector<CInstruction>& vInstructions) const;
+
+    //! Rebuilds the code, labels and line mapping from instructions
+    void encodeInstructions(const QVector<CInstruction>& vInstructions);
+
+    //! File : CAssemblyEngine_Debug
+
+    //! Returns true if execution must pause before the current instruction
+    bool mustBreak();
+
+    //! Returns true if the condition of a breakpoint is met
+    bool breakpointConditionMet(const CBreakpoint& tBreakpoint) const;
+
+    //! Resolves breakpoints to instruction addresses
+    void updateBreakpointIndex();
+
+    //! Blocks until a debug command is received
+    void waitForDebugCommand();
+
+    //! Returns the address of a source line's first instruction
+    qint32 lineToAddress(int iLine) const;
+
     //! File : CAssemblyEngine_Interrupts
 
     //! Interrupts
@@ -308,6 +485,7 @@ protected:
     QVector<QPair<qint32, QString> >    m_mLabelReferences;
     QMap<QString, qint32>               m_mIdentifiers;
     QMap<qint32, qint32>                m_mLines;
+    QMap<qint32, qint32>                m_mDataBlocks;              // Offset -> size of reserved bytes
     QString                             m_sCode;
     QString                             m_sCompileErrors;
     QString                             m_sConstant;
@@ -318,6 +496,8 @@ protected:
     int                                 m_iLine;
     int                                 m_iColumn;
     bool                                m_bDebug;
+    bool                                m_bOptimized;
+    bool                                m_bOptimizeAttempted;
 
     // CPU
 
@@ -331,8 +511,30 @@ protected:
 
     // OS
 
-    QVector<QPair<qint32, qint32> >     m_baMemAlloc;
+    CAssemblyHeap                       m_tHeap;
     QVector<QFile*>                     m_vFiles;
+
+    // Console
+
+    QRect                               m_rConsoleDirty;
+    QElapsedTimer                       m_tConsoleTimer;
+    int                                 m_iConsoleFrameInterval;
+
+    // Debug
+
+    mutable QMutex                      m_tDebugMutex;
+    QWaitCondition                      m_tDebugCondition;
+    QMap<int, CBreakpoint>              m_mBreakpoints;             // Guarded by m_tDebugMutex
+    QMultiHash<qint32, CBreakpoint>     m_hBreakpointsByAddress;    // Owned by the running thread
+    QBitArray                           m_baBreakpointAddresses;    // One bit per byte of code
+    QAtomicInt                          m_iBreakpointsChanged;
+    QAtomicInt                          m_iPauseRequested;
+    EDebugCommand                       m_eDebugCommand;            // Guarded by m_tDebugMutex
+    EDebugCommand                       m_eDebugMode;
+    qint32                              m_iStepOverIP;
+    qint32                              m_iStepOverSP;
+    int                                 m_iNextBreakpoint;
+    bool                                m_bDebugStop;
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -372,13 +574,61 @@ public:
     //!
     CAssemblyMachine::CRegisters registers() const;
 
+    //! Returns the characters of the whole console, row by row
+    QVector<qint32> console() const;
+
     //!
     QByteArray stack(int iFrom, int iCount) const;
 
+    //!
+    QByteArray ram(int iFrom, int iCount) const;
+
+    //! Returns heap allocation statistics
+    CAssemblyHeapStatistics heapStatistics() const;
+
+    //! Returns true if the compiled code went through the optimization pass
+    bool isOptimized() const;
+
+    //! Returns the size in bytes of the compiled code
+    int codeSize() const;
+
     //-------------------------------------------------------------------------------------------------
     // Control methods
     //-------------------------------------------------------------------------------------------------
 
+    //! Sets the minimum delay in milliseconds between two consoleRegionChanged notifications
+    void setConsoleFrameInterval(int value);
+
+    //! Enables the optimization pass after compilation
+    void setOptimize(bool value);
+
+    //! Adds a breakpoint on a 1-based source line, returns its identifier
+    int addLineBreakpoint(int iLine);
+
+    //! Adds a breakpoint, returns its identifier
+    int addBreakpoint(const CAssemblyMachine::CBreakpoint& tBreakpoint);
+
+    //! Removes a breakpoint
+    void removeBreakpoint(int iIdentifier);
+
+    //! Removes all breakpoints
+    void clearBreakpoints();
+
+    //! Executes one instruction when paused
+    void debugStep();
+
+    //! Executes one instruction when paused, running calls to completion
+    void debugStepOver();
+
+    //! Resumes execution when paused
+    void debugContinue();
+
+    //! Pauses execution at the next instruction
+    void debugPause();
+
+    //! Aborts execution
+    void debugStop();
+
     //! Evaluates code
     int evaluate(const QString& sCode, int iOperand1, int iOperand2, int iOperand3, int iOperand4, bool bDebug = false);
 
@@ -396,7 +646,8 @@ signals:
 
     void executing(const QString& sText);
     void consoleChanged();
-    void consoleCharChanged(qint32 x, qint32 y, qint32 c);
+    void consoleRegionChanged(const QRect& rRegion, const QVector<qint32>& vSnapshot);
+    void debugPaused(int iLine, qint32 iAddress);
 
     //-------------------------------------------------------------------------------------------------
     // Slots
@@ -408,7 +659,10 @@ protected slots:
     void onExecuting(const QString& sText);
 
     //!
-    void onConsoleCharChanged(qint32 x, qint32 y, qint32 c);
+    void onConsoleRegionChanged(const QRect& rRegion, const QVector<qint32>& vSnapshot);
+
+    //!
+    void onDebugPaused(int iLine, qint32 iAddress);
 
     //-------------------------------------------------------------------------------------------------
     // Properties
@@ -420,4 +674,5 @@ protected:
     QString             m_sText;
     int                 m_iColumns;
     int                 m_iRows;
+    bool                m_bOptimize;
 };
@@ -19,7 +19,10 @@ void CAssemblyMachine::compile()
     m_mLabelReferences.clear();
     m_mIdentifiers.clear();
     m_mLines.clear();
+    m_mDataBlocks.clear();
     m_sCompileErrors.clear();
+    m_bOptimized = false;
+    m_bOptimizeAttempted = false;
 
     QDataStream sCodeStream(&m_baCode, QIODevice::WriteOnly);
     sCodeStream.setByteOrder(QDataStream::LittleEndian);
@@ -128,6 +131,8 @@ void CAssemblyMachine::compile()
                     {
                         if (leftOpCode == Op_ResBytes)
                         {
+                            qint32 iDataStart = m_baCode.count();
+
                             if (isConstant(rightOpCode))
                             {
                                 int count = m_sConstant.toInt();
@@ -153,6 +158,11 @@ void CAssemblyMachine::compile()
                                 addError("Reserved data can only be made with a constant or a literal");
                                 break;
                             }
+
+                            if (m_baCode.count() > iDataStart)
+                            {
+                                m_mDataBlocks[iDataStart] = m_baCode.count() - iDataStart;
+                            }
                         }
                         else
                         {
@@ -0,0 +1,253 @@
+
+// Qt
+#include <QDebug>
+#include <QMutexLocker>
+
+// Application
+#include "CAssemblyEngine.h"
+
+//-------------------------------------------------------------------------------------------------
+
+int CAssemblyMachine::addBreakpoint(const CBreakpoint& tBreakpoint)
+{
+    QMutexLocker locker(&m_tDebugMutex);
+
+    int iIdentifier = m_iNextBreakpoint++;
+    m_mBreakpoints[iIdentifier] = tBreakpoint;
+    m_iBreakpointsChanged.storeRelease(1);
+
+    return iIdentifier;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyMachine::removeBreakpoint(int iIdentifier)
+{
+    QMutexLocker locker(&m_tDebugMutex);
+
+    m_mBreakpoints.remove(iIdentifier);
+    m_iBreakpointsChanged.storeRelease(1);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyMachine::clearBreakpoints()
+{
+    QMutexLocker locker(&m_tDebugMutex);
+
+    m_mBreakpoints.clear();
+    m_iBreakpointsChanged.storeRelease(1);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+QMap<int, CAssemblyMachine::CBreakpoint> CAssemblyMachine::breakpoints() const
+{
+    QMutexLocker locker(&m_tDebugMutex);
+
+    return m_mBreakpoints;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyMachine::debugCommand(EDebugCommand eCommand)
+{
+    QMutexLocker locker(&m_tDebugMutex);
+
+    m_eDebugCommand = eCommand;
+    m_tDebugCondition.wakeAll();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyMachine::debugPause()
+{
+    m_iPauseRequested.storeRelease(1);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool CAssemblyMachine::mustBreak()
+{
+    if (m_iBreakpointsChanged.testAndSetOrdered(1, 0))
+    {
+        updateBreakpointIndex();
+    }
+
+    if (m_iPauseRequested.testAndSetOrdered(1, 0))
+    {
+        return true;
+    }
+
+    if (m_eDebugMode == dcStep)
+    {
+        return true;
+    }
+
+    if (m_eDebugMode == dcStepOver && m_rCPU.IP == m_iStepOverIP && m_rCPU.SP <= m_iStepOverSP)
+    {
+        return true;
+    }
+
+    // The bit array avoids a hash lookup for instructions without breakpoints
+    qint32 iOffset = m_rCPU.IP - RAM_USER;
+
+    if (iOffset >= 0 && iOffset < m_baBreakpointAddresses.size() && m_baBreakpointAddresses.testBit(iOffset))
+    {
+        QMultiHash<qint32, CBreakpoint>::const_iterator iter = m_hBreakpointsByAddress.constFind(m_rCPU.IP);
+
+        for (; iter != m_hBreakpointsByAddress.constEnd() && iter.key() == m_rCPU.IP; ++iter)
+        {
+            if (breakpointConditionMet(iter.value()))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool CAssemblyMachine::breakpointConditionMet(const CBreakpoint& tBreakpoint) const
+{
+    qint32 iValue = 0;
+
+    switch (tBreakpoint.eCondition)
+    {
+    case CBreakpoint::bcNone:
+        return true;
+
+    case CBreakpoint::bcRegister:
+        iValue = readRegister(tBreakpoint.eRegister);
+        break;
+
+    case CBreakpoint::bcRam:
+        if (tBreakpoint.iRamAddress >= 0 && tBreakpoint.iRamAddress + int(sizeof(qint32)) < m_baData.count())
+        {
+            iValue = *((const qint32*)(m_baData.constData() + tBreakpoint.iRamAddress));
+        }
+        break;
+    }
+
+    switch (tBreakpoint.eComparison)
+    {
+    case CBreakpoint::bcEqual:
+        return iValue == tBreakpoint.iValue;
+
+    case CBreakpoint::bcNotEqual:
+        return iValue != tBreakpoint.iValue;
+
+    case CBreakpoint::bcGreater:
+        return iValue > tBreakpoint.iValue;
+
+    case CBreakpoint::bcLower:
+        return iValue < tBreakpoint.iValue;
+    }
+
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyMachine::updateBreakpointIndex()
+{
+    QMap<int, CBreakpoint> mBreakpoints = breakpoints();
+
+    m_hBreakpointsByAddress.clear();
+    m_baBreakpointAddresses.fill(false, m_baCode.count());
+
+    for (const CBreakpoint& tBreakpoint : mBreakpoints)
+    {
+        if (tBreakpoint.bEnabled)
+        {
+            qint32 iAddress = tBreakpoint.iLine > 0 ? lineToAddress(tBreakpoint.iLine) : tBreakpoint.iAddress;
+            qint32 iOffset = iAddress - RAM_USER;
+
+            if (iOffset >= 0 && iOffset < m_baBreakpointAddresses.size())
+            {
+                m_baBreakpointAddresses.setBit(iOffset);
+                m_hBreakpointsByAddress.insert(iAddress, tBreakpoint);
+            }
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyMachine::waitForDebugCommand()
+{
+    // Let the host see the current state of the console
+    flushConsole();
+
+    emit executing(QString("%1 : %2").arg(currentLine()).arg(currentInstruction()));
+    emit debugPaused(currentLine(), m_rCPU.IP);
+
+    EDebugCommand eCommand = dcNone;
+
+    {
+        QMutexLocker locker(&m_tDebugMutex);
+
+        while (m_eDebugCommand == dcNone)
+        {
+            m_tDebugCondition.wait(&m_tDebugMutex);
+        }
+
+        eCommand = m_eDebugCommand;
+        m_eDebugCommand = dcNone;
+    }
+
+    switch (eCommand)
+    {
+    case dcStepOver:
+    {
+        m_eDebugMode = dcStep;
+
+        if (m_rCPU.IP < m_baData.size())
+        {
+            EOpCode leftOpCode = Op_Nop;
+            EOpCode centerOpCode = Op_Nop;
+            EOpCode rightOpCode = Op_Nop;
+            qint32 iLeftValue = 0;
+            qint32 iRightValue = 0;
+
+            qint32 offset = readOpcodes(m_baData.constData() + m_rCPU.IP, &leftOpCode, &centerOpCode, &rightOpCode, &iLeftValue, &iRightValue);
+
+            // Run calls to completion : break when back after the call with the same stack
+            if (centerOpCode == Op_Call)
+            {
+                m_eDebugMode = dcStepOver;
+                m_iStepOverIP = m_rCPU.IP + offset;
+                m_iStepOverSP = m_rCPU.SP;
+            }
+        }
+
+        break;
+    }
+
+    case dcStop:
+        m_bDebugStop = true;
+        break;
+
+    default:
+        m_eDebugMode = eCommand;
+        break;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+qint32 CAssemblyMachine::lineToAddress(int iLine) const
+{
+    // Lines grow with addresses : the first instruction at or after the line is the one to break on
+    for (QMap<qint32, qint32>::const_iterator iter = m_mLines.constBegin(); iter != m_mLines.constEnd(); ++iter)
+    {
+        if (iter.value() >= iLine - 1)
+        {
+            return RAM_USER + iter.key();
+        }
+    }
+
+    return -1;
+}
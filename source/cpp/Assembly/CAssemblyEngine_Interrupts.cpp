@@ -130,6 +130,8 @@ void CAssemblyMachine::handleInt_Thread()
     }
     case INT_THREAD_SLEEP:
     {
+        // The script yields : a good time to show what it has drawn so far
+        flushConsole();
         m_rCPU.D1 = 0;
         break;
     }
@@ -149,40 +151,22 @@ qint32 CAssemblyMachine::getTime(qint32 iPrec)
 
 //-------------------------------------------------------------------------------------------------
 
-static bool compareMemAlloc(QPair<qint32, qint32>& left, QPair<qint32, qint32>& right)
-{
-    return left.first < right.first;
-}
-
 qint32 CAssemblyMachine::findFreeMemoryBlock(qint32 iBase, qint32 iLimit, qint32 iRequestedSize)
 {
-    // qDebug() << "iBase : " << iBase << " , iLimit : " << iLimit << " , iRequestedSize : " << iRequestedSize;
-
     if (iBase > 0 && iLimit > 0)
     {
-        qSort(m_baMemAlloc.begin(), m_baMemAlloc.end(), compareMemAlloc);
-
-        for (int index = 0; index < m_baMemAlloc.count(); index++)
+        // The heap region is set by the first allocation and may only move once all blocks are freed
+        if (m_tHeap.covers(iBase, iLimit) == false)
         {
-            qint32 iBlockStart = m_baMemAlloc[index].first;
-            qint32 iBlockEnd = iBlockStart + m_baMemAlloc[index].second;
-
-            // qDebug() << "iBlockStart : " << iBlockStart << " , iBlockEnd : " << iBlockEnd;
-
-            if (iBlockStart - iBase >= iRequestedSize)
+            if (m_tHeap.isEmpty() == false)
             {
-                m_baMemAlloc << QPair<qint32, qint32>(iBase, iRequestedSize);
-                return iBase;
+                return INT_MEM_ERROR_HEAP_IN_USE;
             }
 
-            iBase = iBlockEnd;
+            m_tHeap.reset(iBase, iLimit);
         }
 
-        if (iBase + iRequestedSize < iLimit)
-        {
-            m_baMemAlloc << QPair<qint32, qint32>(iBase, iRequestedSize);
-            return iBase;
-        }
+        return m_tHeap.alloc(iRequestedSize);
     }
 
     return 0;
@@ -194,14 +178,7 @@ void CAssemblyMachine::freeMemoryBlock(qint32 iBase, qint32 iLimit, qint32 iAddr
 {
     if (iBase > 0 && iLimit > 0)
     {
-        for (int index = 0; index < m_baMemAlloc.count(); index++)
-        {
-            if (m_baMemAlloc[index].first == iAddress)
-            {
-                m_baMemAlloc.removeAt(index);
-                return;
-            }
-        }
+        m_tHeap.free(iAddress);
     }
 }
 
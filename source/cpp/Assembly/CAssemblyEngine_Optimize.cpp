@@ -0,0 +1,502 @@
+
+// std
+#include <limits>
+
+// Qt
+#include <QDebug>
+#include <QDataStream>
+#include <QSet>
+
+// Application
+#include "CAssemblyEngine.h"
+
+//-------------------------------------------------------------------------------------------------
+// Notes
+//
+// The optimizer works on the compiled code, one instruction per source statement.
+// Reserved bytes are kept as is, and every constant that was a label reference is relocated, so
+// code and data addressed through labels survive the change of layout. Code that computes jump
+// addresses with arithmetic on labels is not supported by this pass.
+
+//-------------------------------------------------------------------------------------------------
+
+static bool isPlainRegister(CAssemblyMachine::EOpCode eOpCode)
+{
+    return (eOpCode >= CAssemblyMachine::Op_A1 && eOpCode <= CAssemblyMachine::Op_D8);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static bool isJump(CAssemblyMachine::EOpCode eOpCode)
+{
+    return (eOpCode >= CAssemblyMachine::Op_Jump && eOpCode <= CAssemblyMachine::Op_JumpIfLower);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static bool isControl(CAssemblyMachine::EOpCode eOpCode)
+{
+    return isJump(eOpCode)
+            || eOpCode == CAssemblyMachine::Op_Call
+            || eOpCode == CAssemblyMachine::Op_Ret
+            || eOpCode == CAssemblyMachine::Op_Int;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static bool isFoldable(CAssemblyMachine::EOpCode eOpCode)
+{
+    return (eOpCode >= CAssemblyMachine::Op_Add && eOpCode <= CAssemblyMachine::Op_Xor);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+//! Returns true if reading eOperand reads the register eRegister
+static bool readsRegister(CAssemblyMachine::EOpCode eOperand, CAssemblyMachine::EOpCode eRegister)
+{
+    if (eOperand == eRegister)
+        return true;
+
+    if (eRegister >= CAssemblyMachine::Op_A1 && eRegister <= CAssemblyMachine::Op_A8)
+        return eOperand == CAssemblyMachine::EOpCode(eRegister - CAssemblyMachine::Op_A1 + CAssemblyMachine::Op_AtA1);
+
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+//! Computes an operation exactly as processNextInstruction does, returns false if it cannot be folded
+template <typename T>
+static bool foldTyped(CAssemblyMachine::EOpCode eOperation, qint32 iLeft, qint32 iRight, qint32* pResult)
+{
+    T left = T(iLeft);
+    T right = T(iRight);
+
+    switch (eOperation)
+    {
+    case CAssemblyMachine::Op_Add: *pResult = qint32(quint32(left) + quint32(right)); return true;
+    case CAssemblyMachine::Op_Sub: *pResult = qint32(quint32(left) - quint32(right)); return true;
+    case CAssemblyMachine::Op_Mul: *pResult = qint32(quint32(left) * quint32(right)); return true;
+    case CAssemblyMachine::Op_And: *pResult = left & right; return true;
+    case CAssemblyMachine::Op_Or: *pResult = left | right; return true;
+    case CAssemblyMachine::Op_Xor: *pResult = left ^ right; return true;
+
+    case CAssemblyMachine::Op_Div:
+        if (iRight == 0)
+        {
+            *pResult = 0;
+            return true;
+        }
+        if (right == 0 || (left == std::numeric_limits<T>::min() && right == T(-1)))
+            return false;
+        *pResult = left / right;
+        return true;
+
+    case CAssemblyMachine::Op_Shl:
+        if (right < 0 || right >= 32 || left < 0)
+            return false;
+        *pResult = qint32(quint32(left) << right);
+        return true;
+
+    case CAssemblyMachine::Op_Shr:
+        if (right < 0 || right >= 32)
+            return false;
+        *pResult = left >> right;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static bool foldOperation(CAssemblyMachine::EOpCode eOperation, int iSize, qint32 iLeft, qint32 iRight, qint32* pResult)
+{
+    switch (iSize)
+    {
+    case REG_SIZE_BYTE: return foldTyped<qint8>(eOperation, iLeft, iRight, pResult);
+    case REG_SIZE_WORD: return foldTyped<qint16>(eOperation, iLeft, iRight, pResult);
+    case REG_SIZE_LONG: return foldTyped<qint32>(eOperation, iLeft, iRight, pResult);
+    }
+
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyMachine::optimize()
+{
+    m_bOptimizeAttempted = true;
+
+    if (m_sCompileErrors.isEmpty() == false || m_baCode.isEmpty())
+        return;
+
+    QVector<CInstruction> vInstructions = decodeInstructions();
+
+    if (vInstructions.isEmpty())
+        return;
+
+    threadJumps(vInstructions);
+    rewriteInstructions(vInstructions);
+    encodeInstructions(vInstructions);
+
+    m_bOptimized = true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool CAssemblyMachine::isOptimized() const
+{
+    return m_bOptimized;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool CAssemblyMachine::isOptimizeAttempted() const
+{
+    return m_bOptimizeAttempted;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+QVector<CAssemblyMachine::CInstruction> CAssemblyMachine::decodeInstructions() const
+{
+    QVector<CInstruction> vInstructions;
+    QMap<qint32, qint32> mReferences;
+    QSet<qint32> sTargets;
+
+    // Code positions of label references and the code offsets they point to
+    for (auto tReference : m_mLabelReferences)
+    {
+        mReferences[tReference.first] = m_mLabels.value(tReference.second, 0);
+    }
+
+    for (qint32 iOffset : m_mLabels)
+    {
+        sTargets << iOffset;
+    }
+
+    // Each line entry starts a statement, which ends where the next one starts
+    QList<qint32> lStarts = m_mLines.keys();
+
+    for (int index = 0; index < lStarts.count(); index++)
+    {
+        qint32 iStart = lStarts[index];
+        qint32 iEnd = index < lStarts.count() - 1 ? lStarts[index + 1] : m_baCode.count();
+
+        if (iStart >= m_baCode.count())
+            break;
+
+        CInstruction tInstruction;
+        tInstruction.iOffset = iStart;
+        tInstruction.iLine = m_mLines[iStart];
+        tInstruction.bLeader = (iStart == 0) || sTargets.contains(iStart);
+
+        if (vInstructions.count() > 0)
+        {
+            const CInstruction& tPrevious = vInstructions.last();
+            tInstruction.bLeader = tInstruction.bLeader || tPrevious.bData || isControl(tPrevious.eCenter);
+        }
+
+        if (m_mDataBlocks.contains(iStart))
+        {
+            if (m_mDataBlocks[iStart] != iEnd - iStart)
+                return QVector<CInstruction>();
+
+            tInstruction.bData = true;
+            tInstruction.baData = m_baCode.mid(iStart, iEnd - iStart);
+            vInstructions << tInstruction;
+            continue;
+        }
+
+        const char* pCode = m_baCode.constData() + iStart;
+        qint32 iSize = 0;
+
+        tInstruction.eLeft = EOpCode(quint8(pCode[iSize++]));
+
+        if (tInstruction.eLeft == Op_Ret || isSize(tInstruction.eLeft))
+        {
+            tInstruction.eCenter = tInstruction.eLeft;
+        }
+        else
+        {
+            if (iEnd - iStart < 2)
+                return QVector<CInstruction>();
+
+            tInstruction.eCenter = isOperand(tInstruction.eLeft) ? EOpCode(quint8(pCode[iSize++])) : tInstruction.eLeft;
+
+            if (iSize >= iEnd - iStart)
+                return QVector<CInstruction>();
+
+            tInstruction.eRight = EOpCode(quint8(pCode[iSize++]));
+
+            if (isConstant(tInstruction.eRight))
+            {
+                if (iSize + int(sizeof(qint32)) > iEnd - iStart)
+                    return QVector<CInstruction>();
+
+                tInstruction.iValue = *((const qint32*)(pCode + iSize));
+
+                if (mReferences.contains(iStart + iSize))
+                {
+                    tInstruction.iTarget = mReferences[iStart + iSize];
+                }
+
+                iSize += sizeof(qint32);
+            }
+        }
+
+        // Anything else than exactly one instruction per statement is not something we can rewrite
+        if (iSize != iEnd - iStart)
+            return QVector<CInstruction>();
+
+        vInstructions << tInstruction;
+    }
+
+    return vInstructions;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyMachine::threadJumps(QVector<CInstruction>& vInstructions) const
+{
+    QMap<qint32, int> mIndexOfOffset;
+
+    for (int index = 0; index < vInstructions.count(); index++)
+    {
+        mIndexOfOffset[vInstructions[index].iOffset] = index;
+    }
+
+    for (CInstruction& tInstruction : vInstructions)
+    {
+        if ((isJump(tInstruction.eCenter) || tInstruction.eCenter == Op_Call) && tInstruction.iTarget >= 0)
+        {
+            // Follow chains of unconditional jumps, bounded to survive jump cycles
+            for (int iHops = 0; iHops < vInstructions.count(); iHops++)
+            {
+                if (mIndexOfOffset.contains(tInstruction.iTarget) == false)
+                    break;
+
+                const CInstruction& tTarget = vInstructions[mIndexOfOffset[tInstruction.iTarget]];
+
+                if (tTarget.bData || tTarget.eCenter != Op_Jump || tTarget.iTarget < 0 || tTarget.iTarget == tInstruction.iTarget)
+                    break;
+
+                tInstruction.iTarget = tTarget.iTarget;
+            }
+        }
+    }
+
+    // Retargeted instructions start new blocks
+    for (CInstruction& tInstruction : vInstructions)
+    {
+        if (tInstruction.iTarget >= 0 && mIndexOfOffset.contains(tInstruction.iTarget))
+        {
+            vInstructions[mIndexOfOffset[tInstruction.iTarget]].bLeader = true;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyMachine::rewriteInstructions(QVector<CInstruction>& vInstructions) const
+{
+    int iPrevious = -1;
+    int iSize = -1;
+
+    for (int index = 0; index < vInstructions.count(); index++)
+    {
+        CInstruction& tCurrent = vInstructions[index];
+
+        if (tCurrent.bData)
+        {
+            iPrevious = -1;
+            iSize = -1;
+            continue;
+        }
+
+        // Nothing is known at the start of a block, except the size set by reset() at the entry point
+        if (tCurrent.bLeader)
+        {
+            iPrevious = -1;
+            iSize = (index == 0 && tCurrent.iOffset == 0 && m_mLabels.values().contains(0) == false) ? REG_SIZE_LONG : -1;
+        }
+
+        // Operand size already set
+        if (isSize(tCurrent.eLeft))
+        {
+            int iNewSize = tCurrent.eLeft == Op_Byte ? REG_SIZE_BYTE : (tCurrent.eLeft == Op_Word ? REG_SIZE_WORD : REG_SIZE_LONG);
+
+            if (iNewSize == iSize)
+            {
+                tCurrent.bRemoved = true;
+                continue;
+            }
+
+            iSize = iNewSize;
+            iPrevious = index;
+            continue;
+        }
+
+        // Move of a register to itself
+        if (tCurrent.eCenter == Op_Move && isPlainRegister(tCurrent.eLeft) && tCurrent.eRight == tCurrent.eLeft)
+        {
+            tCurrent.bRemoved = true;
+            continue;
+        }
+
+        // Jump to the next instruction
+        if (isJump(tCurrent.eCenter) && tCurrent.iTarget >= 0)
+        {
+            int iNext = index + 1;
+
+            while (iNext < vInstructions.count() && vInstructions[iNext].bRemoved)
+                iNext++;
+
+            qint32 iNextOffset = iNext < vInstructions.count() ? vInstructions[iNext].iOffset : m_baCode.count();
+
+            if (tCurrent.iTarget == iNextOffset)
+            {
+                tCurrent.bRemoved = true;
+                continue;
+            }
+        }
+
+        if (iPrevious >= 0)
+        {
+            CInstruction& tPrevious = vInstructions[iPrevious];
+
+            // Load of a constant followed by an operation with a constant : fold
+            if (tPrevious.eCenter == Op_Move && isPlainRegister(tPrevious.eLeft) && isConstant(tPrevious.eRight) && tPrevious.iTarget < 0
+                    && tCurrent.eLeft == tPrevious.eLeft && isFoldable(tCurrent.eCenter) && isConstant(tCurrent.eRight) && tCurrent.iTarget < 0
+                    && iSize >= 0)
+            {
+                qint32 iResult = 0;
+
+                if (foldOperation(tCurrent.eCenter, iSize, tPrevious.iValue, tCurrent.iValue, &iResult))
+                {
+                    tPrevious.iValue = iResult;
+                    tCurrent.bRemoved = true;
+                    continue;
+                }
+            }
+
+            // Push followed by pop : move, or nothing if the operand is the same register
+            if (tPrevious.eCenter == Op_Push && tCurrent.eCenter == Op_Pop && tCurrent.eRight >= Op_A1 && tCurrent.eRight <= Op_AtA8)
+            {
+                if (tPrevious.eRight == tCurrent.eRight && isPlainRegister(tCurrent.eRight))
+                {
+                    tPrevious.bRemoved = true;
+                    tCurrent.bRemoved = true;
+                    iPrevious = -1;
+                    continue;
+                }
+
+                tPrevious.eLeft = tCurrent.eRight;
+                tPrevious.eCenter = Op_Move;
+                tCurrent.bRemoved = true;
+                continue;
+            }
+
+            // Register loaded twice : the first load is dead
+            if (tPrevious.eCenter == Op_Move && isPlainRegister(tPrevious.eLeft)
+                    && tCurrent.eCenter == Op_Move && tCurrent.eLeft == tPrevious.eLeft
+                    && readsRegister(tCurrent.eRight, tCurrent.eLeft) == false)
+            {
+                tPrevious.bRemoved = true;
+            }
+        }
+
+        iPrevious = index;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyMachine::encodeInstructions(const QVector<CInstruction>& vInstructions)
+{
+    // Compute the new offset of every old offset, removed instructions map to the next survivor
+    QMap<qint32, qint32> mNewOffsets;
+    qint32 iNewOffset = 0;
+
+    for (const CInstruction& tInstruction : vInstructions)
+    {
+        mNewOffsets[tInstruction.iOffset] = iNewOffset;
+
+        if (tInstruction.bRemoved == false)
+        {
+            if (tInstruction.bData)
+                iNewOffset += tInstruction.baData.count();
+            else if (tInstruction.eLeft == Op_Ret || isSize(tInstruction.eLeft))
+                iNewOffset += sizeof(quint8);
+            else
+                iNewOffset += (isOperand(tInstruction.eLeft) ? 3 : 2) * sizeof(quint8) + (isConstant(tInstruction.eRight) ? sizeof(qint32) : 0);
+        }
+    }
+
+    mNewOffsets[m_baCode.count()] = iNewOffset;
+
+    QMap<qint32, QString> mLabelOfOffset;
+
+    for (auto iter = m_mLabels.constBegin(); iter != m_mLabels.constEnd(); ++iter)
+    {
+        mLabelOfOffset[iter.value()] = iter.key();
+    }
+
+    // Write the code
+    QByteArray baCode;
+    QDataStream sCodeStream(&baCode, QIODevice::WriteOnly);
+    sCodeStream.setByteOrder(QDataStream::LittleEndian);
+
+    m_mLines.clear();
+    m_mDataBlocks.clear();
+    m_mLabelReferences.clear();
+
+    for (const CInstruction& tInstruction : vInstructions)
+    {
+        if (tInstruction.bRemoved)
+            continue;
+
+        m_mLines[baCode.count()] = tInstruction.iLine;
+
+        if (tInstruction.bData)
+        {
+            m_mDataBlocks[baCode.count()] = tInstruction.baData.count();
+            sCodeStream.writeRawData(tInstruction.baData.constData(), tInstruction.baData.count());
+            continue;
+        }
+
+        sCodeStream << quint8(tInstruction.eLeft);
+
+        if (tInstruction.eLeft == Op_Ret || isSize(tInstruction.eLeft))
+            continue;
+
+        if (isOperand(tInstruction.eLeft))
+            sCodeStream << quint8(tInstruction.eCenter);
+
+        sCodeStream << quint8(tInstruction.eRight);
+
+        if (isConstant(tInstruction.eRight))
+        {
+            if (tInstruction.iTarget >= 0)
+            {
+                m_mLabelReferences << QPair<qint32, QString>(baCode.count(), mLabelOfOffset.value(tInstruction.iTarget));
+
+                sCodeStream << qint32(RAM_USER + mNewOffsets.value(tInstruction.iTarget, tInstruction.iTarget));
+            }
+            else
+            {
+                sCodeStream << qint32(tInstruction.iValue);
+            }
+        }
+    }
+
+    // Relocate labels
+    for (auto iter = m_mLabels.begin(); iter != m_mLabels.end(); ++iter)
+    {
+        iter.value() = mNewOffsets.value(iter.value(), iter.value());
+    }
+
+    m_baCode = baCode;
+}
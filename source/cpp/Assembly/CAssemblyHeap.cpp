@@ -0,0 +1,277 @@
+
+// Application
+#include "CAssemblyHeap.h"
+
+//-------------------------------------------------------------------------------------------------
+
+CAssemblyHeap::CAssemblyHeap(qint32 iBase, qint32 iLimit)
+    : m_iBase(0)
+    , m_iLimit(0)
+{
+    reset(iBase, iLimit);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+CAssemblyHeap::~CAssemblyHeap()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+qint32 CAssemblyHeap::base() const
+{
+    return m_iBase;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+qint32 CAssemblyHeap::limit() const
+{
+    return m_iLimit;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool CAssemblyHeap::covers(qint32 iBase, qint32 iLimit) const
+{
+    return alignUp(iBase) == m_iBase && qMax(alignUp(iBase), alignDown(iLimit)) == m_iLimit;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool CAssemblyHeap::isEmpty() const
+{
+    return m_hAllocatedBlocks.isEmpty();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+qint32 CAssemblyHeap::blockSize(qint32 iAddress) const
+{
+    return m_hAllocatedBlocks.value(iAddress, 0);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+CAssemblyHeapStatistics CAssemblyHeap::statistics() const
+{
+    CAssemblyHeapStatistics tStatistics = m_tStatistics;
+
+    tStatistics.iBytesFree = tStatistics.iHeapSize - tStatistics.iBytesAllocated;
+    tStatistics.iAllocatedBlocks = m_hAllocatedBlocks.count();
+    tStatistics.iFreeBlocks = m_mFreeBlocks.count();
+    tStatistics.iLargestFreeBlock = 0;
+
+    // Only the highest non-empty bin can hold the largest block
+    for (int iBin = HEAP_NUM_BINS - 1; iBin >= 0; iBin--)
+    {
+        if (m_vBins[iBin].isEmpty() == false)
+        {
+            for (qint32 iAddress : m_vBins[iBin])
+            {
+                tStatistics.iLargestFreeBlock = qMax(tStatistics.iLargestFreeBlock, m_mFreeBlocks[iAddress]);
+            }
+
+            break;
+        }
+    }
+
+    return tStatistics;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyHeap::reset(qint32 iBase, qint32 iLimit)
+{
+    m_iBase = alignUp(iBase);
+    m_iLimit = qMax(m_iBase, alignDown(iLimit));
+
+    m_mFreeBlocks.clear();
+    m_hAllocatedBlocks.clear();
+    m_vBins.clear();
+    m_vBins.resize(HEAP_NUM_BINS);
+
+    m_tStatistics = CAssemblyHeapStatistics();
+    m_tStatistics.iHeapSize = m_iLimit - m_iBase;
+
+    if (m_iLimit > m_iBase)
+    {
+        insertFreeBlock(m_iBase, m_iLimit - m_iBase);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+qint32 CAssemblyHeap::alloc(qint32 iSize)
+{
+    if (iSize <= 0 || iSize > m_iLimit - m_iBase)
+    {
+        m_tStatistics.iFailedAllocCount++;
+        return 0;
+    }
+
+    iSize = alignUp(iSize);
+
+    qint32 iAddress = 0;
+    qint32 iBlockSize = 0;
+
+    // Any block in a bin at or above the fitting bin is large enough
+    for (int iBin = firstFittingBin(iSize); iBin < HEAP_NUM_BINS; iBin++)
+    {
+        if (m_vBins[iBin].isEmpty() == false)
+        {
+            iAddress = *m_vBins[iBin].constBegin();
+            iBlockSize = m_mFreeBlocks[iAddress];
+            break;
+        }
+    }
+
+    // Otherwise look for a fitting block among those of the same size class
+    if (iBlockSize == 0)
+    {
+        int iBin = binOf(iSize);
+
+        for (qint32 iCandidate : m_vBins[iBin])
+        {
+            qint32 iCandidateSize = m_mFreeBlocks[iCandidate];
+
+            if (iCandidateSize >= iSize)
+            {
+                iAddress = iCandidate;
+                iBlockSize = iCandidateSize;
+                break;
+            }
+        }
+    }
+
+    if (iBlockSize == 0)
+    {
+        m_tStatistics.iFailedAllocCount++;
+        return 0;
+    }
+
+    // Split the block and give back the remainder
+    removeFreeBlock(iAddress, iBlockSize);
+
+    if (iBlockSize > iSize)
+    {
+        insertFreeBlock(iAddress + iSize, iBlockSize - iSize);
+    }
+
+    m_hAllocatedBlocks[iAddress] = iSize;
+
+    m_tStatistics.iAllocCount++;
+    m_tStatistics.iBytesAllocated += iSize;
+    m_tStatistics.iPeakBytesAllocated = qMax(m_tStatistics.iPeakBytesAllocated, m_tStatistics.iBytesAllocated);
+
+    return iAddress;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool CAssemblyHeap::free(qint32 iAddress)
+{
+    QHash<qint32, qint32>::iterator iter = m_hAllocatedBlocks.find(iAddress);
+
+    if (iter == m_hAllocatedBlocks.end())
+    {
+        m_tStatistics.iInvalidFreeCount++;
+        return false;
+    }
+
+    qint32 iSize = iter.value();
+    m_hAllocatedBlocks.erase(iter);
+
+    m_tStatistics.iFreeCount++;
+    m_tStatistics.iBytesAllocated -= iSize;
+
+    // Coalesce with the following free block
+    QMap<qint32, qint32>::iterator iNext = m_mFreeBlocks.find(iAddress + iSize);
+
+    if (iNext != m_mFreeBlocks.end())
+    {
+        qint32 iNextSize = iNext.value();
+        removeFreeBlock(iAddress + iSize, iNextSize);
+        iSize += iNextSize;
+    }
+
+    // Coalesce with the preceding free block
+    QMap<qint32, qint32>::iterator iPrevious = m_mFreeBlocks.lowerBound(iAddress);
+
+    if (iPrevious != m_mFreeBlocks.begin())
+    {
+        --iPrevious;
+
+        if (iPrevious.key() + iPrevious.value() == iAddress)
+        {
+            qint32 iPreviousAddress = iPrevious.key();
+            qint32 iPreviousSize = iPrevious.value();
+            removeFreeBlock(iPreviousAddress, iPreviousSize);
+            iAddress = iPreviousAddress;
+            iSize += iPreviousSize;
+        }
+    }
+
+    insertFreeBlock(iAddress, iSize);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+qint32 CAssemblyHeap::alignUp(qint32 iValue)
+{
+    return (iValue + HEAP_ALIGNMENT - 1) & ~(HEAP_ALIGNMENT - 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+qint32 CAssemblyHeap::alignDown(qint32 iValue)
+{
+    return iValue & ~(HEAP_ALIGNMENT - 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int CAssemblyHeap::binOf(qint32 iSize)
+{
+    int iBin = 0;
+
+    while (iBin < HEAP_NUM_BINS - 1 && (qint64(1) << (iBin + 1)) <= iSize)
+    {
+        iBin++;
+    }
+
+    return iBin;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int CAssemblyHeap::firstFittingBin(qint32 iSize)
+{
+    int iBin = binOf(iSize);
+
+    if ((qint64(1) << iBin) < iSize)
+    {
+        iBin++;
+    }
+
+    return iBin;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyHeap::insertFreeBlock(qint32 iAddress, qint32 iSize)
+{
+    m_mFreeBlocks[iAddress] = iSize;
+    m_vBins[binOf(iSize)].insert(iAddress);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CAssemblyHeap::removeFreeBlock(qint32 iAddress, qint32 iSize)
+{
+    m_mFreeBlocks.remove(iAddress);
+    m_vBins[binOf(iSize)].remove(iAddress);
+}
@@ -0,0 +1,145 @@
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+
+// Qt
+#include <QMap>
+#include <QHash>
+#include <QVector>
+#include <QSet>
+
+// Application
+#include "../qtplus_global.h"
+
+//-------------------------------------------------------------------------------------------------
+
+#define HEAP_ALIGNMENT          4
+#define HEAP_NUM_BINS           32
+
+//-------------------------------------------------------------------------------------------------
+
+//! Allocation statistics of a CAssemblyHeap
+class QTPLUSSHARED_EXPORT CAssemblyHeapStatistics
+{
+public:
+
+    CAssemblyHeapStatistics()
+        : iHeapSize(0)
+        , iBytesAllocated(0)
+        , iBytesFree(0)
+        , iPeakBytesAllocated(0)
+        , iLargestFreeBlock(0)
+        , iAllocatedBlocks(0)
+        , iFreeBlocks(0)
+        , iAllocCount(0)
+        , iFreeCount(0)
+        , iFailedAllocCount(0)
+        , iInvalidFreeCount(0)
+    {
+    }
+
+    qint32      iHeapSize;
+    qint32      iBytesAllocated;
+    qint32      iBytesFree;
+    qint32      iPeakBytesAllocated;
+    qint32      iLargestFreeBlock;
+    qint32      iAllocatedBlocks;
+    qint32      iFreeBlocks;
+    qint64      iAllocCount;
+    qint64      iFreeCount;
+    qint64      iFailedAllocCount;
+    qint64      iInvalidFreeCount;
+};
+
+//-------------------------------------------------------------------------------------------------
+
+//! Segregated free-list allocator over a region of the machine's RAM
+//! Free blocks are kept both in an address-ordered map (for coalescing) and in power-of-two size bins (for allocation)
+class QTPLUSSHARED_EXPORT CAssemblyHeap
+{
+public:
+
+    //-------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    //-------------------------------------------------------------------------------------------------
+
+    //! Constructor
+    CAssemblyHeap(qint32 iBase = 0, qint32 iLimit = 0);
+
+    //! Destructor
+    virtual ~CAssemblyHeap();
+
+    //-------------------------------------------------------------------------------------------------
+    // Getters
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the first address of the heap
+    qint32 base() const;
+
+    //! Returns the address just after the heap
+    qint32 limit() const;
+
+    //! Returns true if the heap was reset with iBase and iLimit
+    bool covers(qint32 iBase, qint32 iLimit) const;
+
+    //! Returns true if no block is allocated
+    bool isEmpty() const;
+
+    //! Returns the size of the block allocated at iAddress, 0 if not allocated
+    qint32 blockSize(qint32 iAddress) const;
+
+    //! Returns allocation statistics
+    CAssemblyHeapStatistics statistics() const;
+
+    //-------------------------------------------------------------------------------------------------
+    // Control methods
+    //-------------------------------------------------------------------------------------------------
+
+    //! Resets the heap to cover [iBase, iLimit[
+    void reset(qint32 iBase, qint32 iLimit);
+
+    //! Allocates iSize bytes, returns the block address or 0 if out of memory
+    qint32 alloc(qint32 iSize);
+
+    //! Frees the block at iAddress, returns false if iAddress is not an allocated block
+    bool free(qint32 iAddress);
+
+    //-------------------------------------------------------------------------------------------------
+    // Protected control methods
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! Rounds iValue up to the heap alignment
+    static qint32 alignUp(qint32 iValue);
+
+    //! Rounds iValue down to the heap alignment
+    static qint32 alignDown(qint32 iValue);
+
+    //! Returns the bin holding blocks of iSize bytes (floor of log2)
+    static int binOf(qint32 iSize);
+
+    //! Returns the first bin whose blocks are all at least iSize bytes (ceil of log2)
+    static int firstFittingBin(qint32 iSize);
+
+    //! Adds a free block to the address map and its bin
+    void insertFreeBlock(qint32 iAddress, qint32 iSize);
+
+    //! Removes a free block from the address map and its bin
+    void removeFreeBlock(qint32 iAddress, qint32 iSize);
+
+    //-------------------------------------------------------------------------------------------------
+    // Properties
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    qint32                          m_iBase;
+    qint32                          m_iLimit;
+    QMap<qint32, qint32>            m_mFreeBlocks;              // Address -> size, ordered for coalescing
+    QVector<QSet<qint32> >          m_vBins;                    // Free block addresses by size class
+    QHash<qint32, qint32>           m_hAllocatedBlocks;         // Address -> size
+    CAssemblyHeapStatistics         m_tStatistics;
+};
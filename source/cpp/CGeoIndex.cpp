@@ -0,0 +1,603 @@
+
+// Std
+#include <math.h>
+#include <algorithm>
+#include <queue>
+
+// Application
+#include "CGeoIndex.h"
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    \class CGeoIndex
+    \inmodule qt-plus
+    \brief An in-memory index of geodetic points, for nearest neighbour and range queries. \br\br
+    Points are stored as unit vectors of the sphere in a k-d tree. The straight-line (chord) distance between
+    two unit vectors grows with their great-circle distance, so the tree can be searched with plain 3D boxes and
+    the results are exact great-circle neighbours, without any special case at the poles or the antimeridian. \br\br
+    build() loads many points at once. Points added by insert() wait in a pending list that queries scan, and
+    points removed by remove() are only marked; the tree is rebuilt once the pending or removed points get too
+    many. \br\br
+    Queries are const and may run on several threads at once, but not while the index is modified.
+*/
+
+//-------------------------------------------------------------------------------------------------
+
+// Mean radius of the Earth (IUGG), in meters
+const double CGeoIndex::EARTH_RADIUS = 6371008.8;
+
+// Maximum number of entries in a leaf of the tree
+#define GEOINDEX_LEAF_SIZE      8
+
+// Pending or removed entries above which the tree is rebuilt
+#define GEOINDEX_MIN_REBUILD    64
+
+// Tolerance on the half-plane tests of withinBox()
+#define GEOINDEX_EPSILON        1e-12
+
+//-------------------------------------------------------------------------------------------------
+
+//! Returns the squared distance from dPosition to the box of tNode
+template <class N>
+static inline double boxDistance2(const N& tNode, const double* dPosition)
+{
+    double dResult = 0.0;
+
+    for (int iAxis = 0; iAxis < 3; iAxis++)
+    {
+        double dDelta = qMax(qMax(tNode.dMin[iAxis] - dPosition[iAxis], dPosition[iAxis] - tNode.dMax[iAxis]), 0.0);
+        dResult += dDelta * dDelta;
+    }
+
+    return dResult;
+}
+
+//! Returns the largest value of dNormal . P for P in the box of tNode
+template <class N>
+static inline double boxMaxDot(const N& tNode, const double* dNormal)
+{
+    double dResult = 0.0;
+
+    for (int iAxis = 0; iAxis < 3; iAxis++)
+    {
+        dResult += qMax(dNormal[iAxis] * tNode.dMin[iAxis], dNormal[iAxis] * tNode.dMax[iAxis]);
+    }
+
+    return dResult;
+}
+
+//! Returns the squared distance between two points
+static inline double distance2(const double* dPosition1, const double* dPosition2)
+{
+    double dX = dPosition1[0] - dPosition2[0];
+    double dY = dPosition1[1] - dPosition2[1];
+    double dZ = dPosition1[2] - dPosition2[2];
+
+    return dX * dX + dY * dY + dZ * dZ;
+}
+
+//! Returns the great-circle distance between two unit vectors, in meters
+static inline double arcDistance(const double* dPosition1, const double* dPosition2)
+{
+    double dCrossX = dPosition1[1] * dPosition2[2] - dPosition1[2] * dPosition2[1];
+    double dCrossY = dPosition1[2] * dPosition2[0] - dPosition1[0] * dPosition2[2];
+    double dCrossZ = dPosition1[0] * dPosition2[1] - dPosition1[1] * dPosition2[0];
+    double dDot = dPosition1[0] * dPosition2[0] + dPosition1[1] * dPosition2[1] + dPosition1[2] * dPosition2[2];
+
+    return atan2(sqrt(dCrossX * dCrossX + dCrossY * dCrossY + dCrossZ * dCrossZ), dDot) * CGeoIndex::EARTH_RADIUS;
+}
+
+//! Returns dLongitude in [-PI, PI]
+static inline double normalizedLongitude(double dLongitude)
+{
+    return (dLongitude > M_PI || dLongitude < -M_PI) ? remainder(dLongitude, 2.0 * M_PI) : dLongitude;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Constructs an empty index.
+*/
+CGeoIndex::CGeoIndex()
+    : m_iTreeCount(0)
+    , m_iRemoved(0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Destroys a CGeoIndex.
+*/
+CGeoIndex::~CGeoIndex()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of points in the index.
+*/
+int CGeoIndex::count() const
+{
+    return m_hIndices.count();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns \c true if a point has the identifier \a iId.
+*/
+bool CGeoIndex::contains(qint64 iId) const
+{
+    return m_hIndices.contains(iId);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Replaces all points with the points of \a vIds, \a vLatitudes and \a vLongitudes, and builds a balanced tree
+    over them. The three vectors must have the same size. If an identifier appears several times, its last point
+    is kept.
+*/
+void CGeoIndex::build(const QVector<qint64>& vIds, const QVector<double>& vLatitudes, const QVector<double>& vLongitudes)
+{
+    clear();
+
+    m_vEntries.reserve(vIds.count());
+
+    for (int iIndex = 0; iIndex < vIds.count(); iIndex++)
+    {
+        int iExisting = m_hIndices.value(vIds[iIndex], -1);
+
+        if (iExisting >= 0)
+        {
+            m_vEntries[iExisting].bRemoved = true;
+        }
+
+        m_hIndices[vIds[iIndex]] = m_vEntries.count();
+        m_vEntries << makeEntry(vIds[iIndex], vLatitudes[iIndex], vLongitudes[iIndex]);
+    }
+
+    rebuild();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Adds a point with the identifier \a iId at \a dLatitude, \a dLongitude. If \a iId is already indexed, its point
+    is moved.
+*/
+void CGeoIndex::insert(qint64 iId, double dLatitude, double dLongitude)
+{
+    remove(iId);
+
+    m_hIndices[iId] = m_vEntries.count();
+    m_vEntries << makeEntry(iId, dLatitude, dLongitude);
+
+    rebuildIfNeeded();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Removes the point \a iId. Returns \c false if no point has this identifier.
+*/
+bool CGeoIndex::remove(qint64 iId)
+{
+    int iIndex = m_hIndices.value(iId, -1);
+
+    if (iIndex < 0)
+        return false;
+
+    m_hIndices.remove(iId);
+
+    if (iIndex >= m_iTreeCount)
+    {
+        // Pending entries are not in the tree and can move
+        if (iIndex != m_vEntries.count() - 1)
+        {
+            m_vEntries[iIndex] = m_vEntries.last();
+            m_hIndices[m_vEntries[iIndex].iId] = iIndex;
+        }
+
+        m_vEntries.removeLast();
+    }
+    else
+    {
+        m_vEntries[iIndex].bRemoved = true;
+        m_iRemoved++;
+
+        rebuildIfNeeded();
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Removes all points.
+*/
+void CGeoIndex::clear()
+{
+    m_vEntries.clear();
+    m_vNodes.clear();
+    m_hIndices.clear();
+    m_iTreeCount = 0;
+    m_iRemoved = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the \a iCount points nearest to \a dLatitude, \a dLongitude, nearest first. Returns fewer points if the
+    index holds fewer.
+*/
+QVector<CGeoIndex::Neighbour> CGeoIndex::nearest(double dLatitude, double dLongitude, int iCount) const
+{
+    QVector<Neighbour> vResult;
+
+    if (iCount <= 0)
+        return vResult;
+
+    Entry tQuery = makeEntry(0, dLatitude, dLongitude);
+
+    // Farthest of the best entries found so far on top
+    std::priority_queue<QPair<double, const Entry*>> qBest;
+
+    // Any chord is at most 2
+    double dChord2 = 5.0;
+
+    visit(tQuery.dPosition, dChord2, [&](const Entry& tEntry, double dDistance2)
+    {
+        qBest.push(QPair<double, const Entry*>(dDistance2, &tEntry));
+
+        if (int(qBest.size()) > iCount)
+            qBest.pop();
+
+        if (int(qBest.size()) == iCount)
+            dChord2 = qBest.top().first;
+    });
+
+    vResult.resize(int(qBest.size()));
+
+    for (int iIndex = vResult.count() - 1; iIndex >= 0; iIndex--)
+    {
+        vResult[iIndex].iId = qBest.top().second->iId;
+        vResult[iIndex].dDistance = arcDistance(tQuery.dPosition, qBest.top().second->dPosition);
+        qBest.pop();
+    }
+
+    return vResult;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the points within \a dDistance meters of \a dLatitude, \a dLongitude, nearest first.
+*/
+QVector<CGeoIndex::Neighbour> CGeoIndex::withinDistance(double dLatitude, double dLongitude, double dDistance) const
+{
+    QVector<QPair<double, const Entry*>> vFound;
+    QVector<Neighbour> vResult;
+
+    if (dDistance < 0.0)
+        return vResult;
+
+    Entry tQuery = makeEntry(0, dLatitude, dLongitude);
+
+    // Chord of the distance, with a margin for rounding, the exact distance is checked below
+    double dAngle = dDistance / EARTH_RADIUS;
+    double dChord = dAngle >= M_PI ? 2.0 : 2.0 * sin(dAngle / 2.0);
+    double dChord2 = dChord * dChord * (1.0 + 1e-9) + 1e-18;
+
+    visit(tQuery.dPosition, dChord2, [&](const Entry& tEntry, double dDistance2)
+    {
+        vFound << QPair<double, const Entry*>(dDistance2, &tEntry);
+    });
+
+    std::sort(vFound.begin(), vFound.end());
+
+    vResult.reserve(vFound.count());
+
+    for (const QPair<double, const Entry*>& pFound : vFound)
+    {
+        Neighbour tNeighbour;
+        tNeighbour.iId = pFound.second->iId;
+        tNeighbour.dDistance = arcDistance(tQuery.dPosition, pFound.second->dPosition);
+
+        if (tNeighbour.dDistance <= dDistance)
+            vResult << tNeighbour;
+    }
+
+    return vResult;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the identifiers of the points whose latitude is within [\a dMinLatitude, \a dMaxLatitude] and whose
+    longitude is within [\a dMinLongitude, \a dMaxLongitude]. If \a dMinLongitude is greater than \a dMaxLongitude,
+    the box crosses the antimeridian.
+*/
+QVector<qint64> CGeoIndex::withinBox(double dMinLatitude, double dMinLongitude, double dMaxLatitude, double dMaxLongitude) const
+{
+    QVector<qint64> vResult;
+
+    dMinLongitude = normalizedLongitude(dMinLongitude);
+    dMaxLongitude = normalizedLongitude(dMaxLongitude);
+
+    bool bCrossing = dMinLongitude > dMaxLongitude;
+    double dSpan = bCrossing ? dMaxLongitude - dMinLongitude + 2.0 * M_PI : dMaxLongitude - dMinLongitude;
+    double dMinZ = sin(dMinLatitude);
+    double dMaxZ = sin(dMaxLatitude);
+
+    // Within half a turn, the box is on the inner side of the planes of its two meridians
+    bool bUsePlanes = dSpan <= M_PI;
+    double dMinPlane[3] = { -sin(dMinLongitude), cos(dMinLongitude), 0.0 };
+    double dMaxPlane[3] = { sin(dMaxLongitude), -cos(dMaxLongitude), 0.0 };
+
+    auto isInside = [&](const Entry& tEntry)
+    {
+        if (tEntry.dLatitude < dMinLatitude || tEntry.dLatitude > dMaxLatitude)
+            return false;
+
+        if (bCrossing)
+            return tEntry.dLongitude >= dMinLongitude || tEntry.dLongitude <= dMaxLongitude;
+
+        return tEntry.dLongitude >= dMinLongitude && tEntry.dLongitude <= dMaxLongitude;
+    };
+
+    for (int iIndex = m_iTreeCount; iIndex < m_vEntries.count(); iIndex++)
+    {
+        if (isInside(m_vEntries[iIndex]))
+            vResult << m_vEntries[iIndex].iId;
+    }
+
+    if (m_vNodes.isEmpty())
+        return vResult;
+
+    QVector<int> vStack;
+    vStack << 0;
+
+    while (vStack.isEmpty() == false)
+    {
+        const Node& tNode = m_vNodes[vStack.takeLast()];
+
+        if (tNode.dMax[2] < dMinZ - GEOINDEX_EPSILON || tNode.dMin[2] > dMaxZ + GEOINDEX_EPSILON)
+            continue;
+
+        if (bUsePlanes && (boxMaxDot(tNode, dMinPlane) < -GEOINDEX_EPSILON || boxMaxDot(tNode, dMaxPlane) < -GEOINDEX_EPSILON))
+            continue;
+
+        if (tNode.iLeft < 0)
+        {
+            for (int iIndex = tNode.iBegin; iIndex < tNode.iEnd; iIndex++)
+            {
+                if (m_vEntries[iIndex].bRemoved == false && isInside(m_vEntries[iIndex]))
+                    vResult << m_vEntries[iIndex].iId;
+            }
+        }
+        else
+        {
+            vStack << tNode.iLeft << tNode.iRight;
+        }
+    }
+
+    return vResult;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the great-circle distance in meters between \a dLatitude1, \a dLongitude1 and \a dLatitude2,
+    \a dLongitude2, on a sphere of EARTH_RADIUS. The formula stays accurate for close and antipodal points.
+*/
+double CGeoIndex::greatCircleDistance(double dLatitude1, double dLongitude1, double dLatitude2, double dLongitude2)
+{
+    Entry tEntry1 = makeEntry(0, dLatitude1, dLongitude1);
+    Entry tEntry2 = makeEntry(0, dLatitude2, dLongitude2);
+
+    return arcDistance(tEntry1.dPosition, tEntry2.dPosition);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the entry of \a iId at \a dLatitude, \a dLongitude.
+*/
+CGeoIndex::Entry CGeoIndex::makeEntry(qint64 iId, double dLatitude, double dLongitude)
+{
+    Entry tEntry;
+
+    tEntry.dPosition[0] = cos(dLatitude) * cos(dLongitude);
+    tEntry.dPosition[1] = cos(dLatitude) * sin(dLongitude);
+    tEntry.dPosition[2] = sin(dLatitude);
+    tEntry.dLatitude = dLatitude;
+    tEntry.dLongitude = normalizedLongitude(dLongitude);
+    tEntry.iId = iId;
+    tEntry.bRemoved = false;
+
+    return tEntry;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Drops removed entries and builds a balanced tree over all the others.
+*/
+void CGeoIndex::rebuild()
+{
+    QVector<Entry> vLive;
+    vLive.reserve(m_vEntries.count() - m_iRemoved);
+
+    for (const Entry& tEntry : m_vEntries)
+    {
+        if (tEntry.bRemoved == false)
+            vLive << tEntry;
+    }
+
+    m_vEntries = vLive;
+    m_vNodes.clear();
+    m_vNodes.reserve(4 * m_vEntries.count() / GEOINDEX_LEAF_SIZE + 1);
+
+    if (m_vEntries.isEmpty() == false)
+    {
+        buildNode(0, m_vEntries.count(), 0);
+    }
+
+    m_hIndices.clear();
+    m_hIndices.reserve(m_vEntries.count());
+
+    for (int iIndex = 0; iIndex < m_vEntries.count(); iIndex++)
+    {
+        m_hIndices[m_vEntries[iIndex].iId] = iIndex;
+    }
+
+    m_iTreeCount = m_vEntries.count();
+    m_iRemoved = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Builds the subtree over the entries [\a iBegin, \a iEnd), splitting them at the median of the widest axis of
+    their box. Returns the index of its node.
+*/
+int CGeoIndex::buildNode(int iBegin, int iEnd, int iDepth)
+{
+    Node tNode;
+    tNode.iBegin = iBegin;
+    tNode.iEnd = iEnd;
+    tNode.iLeft = -1;
+    tNode.iRight = -1;
+
+    for (int iAxis = 0; iAxis < 3; iAxis++)
+    {
+        tNode.dMin[iAxis] = m_vEntries[iBegin].dPosition[iAxis];
+        tNode.dMax[iAxis] = m_vEntries[iBegin].dPosition[iAxis];
+    }
+
+    for (int iIndex = iBegin + 1; iIndex < iEnd; iIndex++)
+    {
+        for (int iAxis = 0; iAxis < 3; iAxis++)
+        {
+            tNode.dMin[iAxis] = qMin(tNode.dMin[iAxis], m_vEntries[iIndex].dPosition[iAxis]);
+            tNode.dMax[iAxis] = qMax(tNode.dMax[iAxis], m_vEntries[iIndex].dPosition[iAxis]);
+        }
+    }
+
+    int iNode = m_vNodes.count();
+    m_vNodes << tNode;
+
+    if (iEnd - iBegin > GEOINDEX_LEAF_SIZE)
+    {
+        int iAxis = 0;
+
+        for (int iOther = 1; iOther < 3; iOther++)
+        {
+            if (tNode.dMax[iOther] - tNode.dMin[iOther] > tNode.dMax[iAxis] - tNode.dMin[iAxis])
+                iAxis = iOther;
+        }
+
+        int iMiddle = (iBegin + iEnd) / 2;
+
+        std::nth_element(m_vEntries.begin() + iBegin, m_vEntries.begin() + iMiddle, m_vEntries.begin() + iEnd,
+                         [iAxis](const Entry& tEntry1, const Entry& tEntry2)
+        {
+            return tEntry1.dPosition[iAxis] < tEntry2.dPosition[iAxis];
+        });
+
+        int iLeft = buildNode(iBegin, iMiddle, iDepth + 1);
+        int iRight = buildNode(iMiddle, iEnd, iDepth + 1);
+
+        m_vNodes[iNode].iLeft = iLeft;
+        m_vNodes[iNode].iRight = iRight;
+    }
+
+    return iNode;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Rebuilds the tree when pending entries, which every query scans, or removed entries, which every query skips,
+    exceed a sixteenth and a quarter of the tree.
+*/
+void CGeoIndex::rebuildIfNeeded()
+{
+    int iPending = m_vEntries.count() - m_iTreeCount;
+
+    if (iPending > qMax(GEOINDEX_MIN_REBUILD, m_iTreeCount / 16) || m_iRemoved > qMax(GEOINDEX_MIN_REBUILD, m_iTreeCount / 4))
+    {
+        rebuild();
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Calls \a fVisit with each live entry whose squared chord to \a dPosition is at most \a dChord2, and this squared
+    chord. \a fVisit may lower \a dChord2 to narrow the search. Nearer subtrees are visited first.
+*/
+template <class T>
+void CGeoIndex::visit(const double* dPosition, double& dChord2, T fVisit) const
+{
+    for (int iIndex = m_iTreeCount; iIndex < m_vEntries.count(); iIndex++)
+    {
+        double dDistance2 = distance2(dPosition, m_vEntries[iIndex].dPosition);
+
+        if (dDistance2 <= dChord2)
+            fVisit(m_vEntries[iIndex], dDistance2);
+    }
+
+    if (m_vNodes.isEmpty())
+        return;
+
+    // Nodes to visit, with the squared distance to their box
+    QVector<QPair<int, double>> vStack;
+    vStack << QPair<int, double>(0, boxDistance2(m_vNodes[0], dPosition));
+
+    while (vStack.isEmpty() == false)
+    {
+        QPair<int, double> pTop = vStack.takeLast();
+
+        if (pTop.second > dChord2)
+            continue;
+
+        const Node& tNode = m_vNodes[pTop.first];
+
+        if (tNode.iLeft < 0)
+        {
+            for (int iIndex = tNode.iBegin; iIndex < tNode.iEnd; iIndex++)
+            {
+                const Entry& tEntry = m_vEntries[iIndex];
+
+                if (tEntry.bRemoved)
+                    continue;
+
+                double dDistance2 = distance2(dPosition, tEntry.dPosition);
+
+                if (dDistance2 <= dChord2)
+                    fVisit(tEntry, dDistance2);
+            }
+        }
+        else
+        {
+            double dLeft = boxDistance2(m_vNodes[tNode.iLeft], dPosition);
+            double dRight = boxDistance2(m_vNodes[tNode.iRight], dPosition);
+
+            // The nearer child is pushed last to be visited first
+            if (dLeft <= dRight)
+            {
+                vStack << QPair<int, double>(tNode.iRight, dRight) << QPair<int, double>(tNode.iLeft, dLeft);
+            }
+            else
+            {
+                vStack << QPair<int, double>(tNode.iLeft, dLeft) << QPair<int, double>(tNode.iRight, dRight);
+            }
+        }
+    }
+}
@@ -0,0 +1,140 @@
+
+#pragma once
+
+#include "qtplus_global.h"
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+
+// Qt
+#include <QVector>
+#include <QHash>
+
+//-------------------------------------------------------------------------------------------------
+
+//! Defines an in-memory index of geodetic points for nearest neighbour and range queries
+//! Latitudes and longitudes are in radians, distances are great-circle distances in meters on a sphere of EARTH_RADIUS
+class QTPLUSSHARED_EXPORT CGeoIndex
+{
+public:
+
+    //! A point found by a query
+    struct Neighbour
+    {
+        qint64  iId;
+        double  dDistance;      // Great-circle distance to the query point, in meters
+    };
+
+    // Constants
+
+    static const double EARTH_RADIUS;
+
+    //-------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    //-------------------------------------------------------------------------------------------------
+
+    //! Constructor
+    CGeoIndex();
+
+    //! Destructor
+    virtual ~CGeoIndex();
+
+    //-------------------------------------------------------------------------------------------------
+    // Getters
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the number of points
+    int count() const;
+
+    //! Returns true if a point has the identifier iId
+    bool contains(qint64 iId) const;
+
+    //-------------------------------------------------------------------------------------------------
+    // Control methods
+    //-------------------------------------------------------------------------------------------------
+
+    //! Replaces all points with the points of vIds, vLatitudes and vLongitudes
+    void build(const QVector<qint64>& vIds, const QVector<double>& vLatitudes, const QVector<double>& vLongitudes);
+
+    //! Adds a point, or moves it if iId is already indexed
+    void insert(qint64 iId, double dLatitude, double dLongitude);
+
+    //! Removes the point iId, returns false if it is not indexed
+    bool remove(qint64 iId);
+
+    //! Removes all points
+    void clear();
+
+    //! Returns the iCount points nearest to dLatitude, dLongitude, nearest first
+    QVector<Neighbour> nearest(double dLatitude, double dLongitude, int iCount) const;
+
+    //! Returns the points within dDistance meters of dLatitude, dLongitude, nearest first
+    QVector<Neighbour> withinDistance(double dLatitude, double dLongitude, double dDistance) const;
+
+    //! Returns the identifiers of the points inside a latitude / longitude box, which may cross the antimeridian
+    QVector<qint64> withinBox(double dMinLatitude, double dMinLongitude, double dMaxLatitude, double dMaxLongitude) const;
+
+    //! Returns the great-circle distance between two points, in meters
+    static double greatCircleDistance(double dLatitude1, double dLongitude1, double dLatitude2, double dLongitude2);
+
+    //-------------------------------------------------------------------------------------------------
+    // Protected types
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! A point on the unit sphere
+    struct Entry
+    {
+        double  dPosition[3];
+        double  dLatitude;
+        double  dLongitude;
+        qint64  iId;
+        bool    bRemoved;
+    };
+
+    //! A node of the k-d tree, over the entries [iBegin, iEnd)
+    struct Node
+    {
+        double  dMin[3];
+        double  dMax[3];
+        int     iBegin;
+        int     iEnd;
+        int     iLeft;          // -1 for a leaf
+        int     iRight;
+    };
+
+    //-------------------------------------------------------------------------------------------------
+    // Protected control methods
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! Returns a point of the unit sphere
+    static Entry makeEntry(qint64 iId, double dLatitude, double dLongitude);
+
+    //! Builds the tree over all live entries
+    void rebuild();
+
+    //! Builds the subtree over the entries [iBegin, iEnd), returns its node
+    int buildNode(int iBegin, int iEnd, int iDepth);
+
+    //! Rebuilds the tree when pending or removed entries make queries slow
+    void rebuildIfNeeded();
+
+    //! Calls fVisit on each live entry that may be within dChord2 of dPosition, the squared chord being updated by fVisit
+    template <class T>
+    void visit(const double* dPosition, double& dChord2, T fVisit) const;
+
+    //-------------------------------------------------------------------------------------------------
+    // Properties
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    QVector<Entry>      m_vEntries;         // Tree entries, then pending entries
+    QVector<Node>       m_vNodes;
+    QHash<qint64, int>  m_hIndices;         // Entry of each identifier
+    int                 m_iTreeCount;       // Entries covered by the tree
+    int                 m_iRemoved;         // Removed entries still in the tree
+};
@@ -0,0 +1,201 @@
+
+// Std
+#include <math.h>
+
+// Application
+#include "GeoTools/geobatch.h"
+#include "CGeoReferenceFrame.h"
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    \class CGeoReferenceFrame
+    \inmodule qt-plus
+    \brief A local East, North, Up frame on the WGS 84 ellipsoid. \br
+    The geocentric position of the origin and the rotation to the local axes are computed once by the
+    constructor, so converting points only costs a subtraction and a matrix product per point. \br
+    Geodetic coordinates are in radians and meters. Geocentric coordinates follow GeoTools : X towards
+    latitude and longitude 0, Z towards the north pole. Up is the normal to the ellipsoid at the origin.
+    \sa CGeoUtilities::referenceFrame()
+*/
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Constructs a frame at latitude and longitude 0.
+*/
+CGeoReferenceFrame::CGeoReferenceFrame()
+    : CGeoReferenceFrame(0.0, 0.0, 0.0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Constructs a frame whose origin is the geodetic point \a dLatitude, \a dLongitude, \a dAltitude.
+*/
+CGeoReferenceFrame::CGeoReferenceFrame(double dLatitude, double dLongitude, double dAltitude)
+    : m_dLatitude(dLatitude)
+    , m_dLongitude(dLongitude)
+    , m_dAltitude(dAltitude)
+{
+    Init_Geocentric_Context(&m_tEllipsoid);
+
+    Convert_Geodetic_To_Geocentric_Ctx(&m_tEllipsoid, dLatitude, dLongitude, dAltitude, &m_dOrigin[0], &m_dOrigin[1], &m_dOrigin[2]);
+
+    double dSinLat = sin(dLatitude);
+    double dCosLat = cos(dLatitude);
+    double dSinLon = sin(dLongitude);
+    double dCosLon = cos(dLongitude);
+
+    // East
+    m_dRotation[0][0] = -dSinLon;
+    m_dRotation[0][1] = dCosLon;
+    m_dRotation[0][2] = 0.0;
+
+    // North
+    m_dRotation[1][0] = -dSinLat * dCosLon;
+    m_dRotation[1][1] = -dSinLat * dSinLon;
+    m_dRotation[1][2] = dCosLat;
+
+    // Up
+    m_dRotation[2][0] = dCosLat * dCosLon;
+    m_dRotation[2][1] = dCosLat * dSinLon;
+    m_dRotation[2][2] = dSinLat;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Converts \a iCount geocentric points \a pX, \a pY, \a pZ to \a pEast, \a pNorth, \a pUp. \br
+    The output arrays may be the input arrays.
+*/
+void CGeoReferenceFrame::geocentricToENU(int iCount, const double* pX, const double* pY, const double* pZ, double* pEast, double* pNorth, double* pUp) const
+{
+    for (int iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        double dX = pX[iIndex] - m_dOrigin[0];
+        double dY = pY[iIndex] - m_dOrigin[1];
+        double dZ = pZ[iIndex] - m_dOrigin[2];
+
+        pEast[iIndex] = m_dRotation[0][0] * dX + m_dRotation[0][1] * dY;
+        pNorth[iIndex] = m_dRotation[1][0] * dX + m_dRotation[1][1] * dY + m_dRotation[1][2] * dZ;
+        pUp[iIndex] = m_dRotation[2][0] * dX + m_dRotation[2][1] * dY + m_dRotation[2][2] * dZ;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Converts \a iCount local points \a pEast, \a pNorth, \a pUp to geocentric \a pX, \a pY, \a pZ. \br
+    The output arrays may be the input arrays.
+*/
+void CGeoReferenceFrame::ENUToGeocentric(int iCount, const double* pEast, const double* pNorth, const double* pUp, double* pX, double* pY, double* pZ) const
+{
+    for (int iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        double dEast = pEast[iIndex];
+        double dNorth = pNorth[iIndex];
+        double dUp = pUp[iIndex];
+
+        pX[iIndex] = m_dOrigin[0] + m_dRotation[0][0] * dEast + m_dRotation[1][0] * dNorth + m_dRotation[2][0] * dUp;
+        pY[iIndex] = m_dOrigin[1] + m_dRotation[0][1] * dEast + m_dRotation[1][1] * dNorth + m_dRotation[2][1] * dUp;
+        pZ[iIndex] = m_dOrigin[2] + m_dRotation[1][2] * dNorth + m_dRotation[2][2] * dUp;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Converts \a iCount geocentric points \a pX, \a pY, \a pZ to \a pNorth, \a pEast, \a pDown. \br
+    The output arrays may be the input arrays.
+*/
+void CGeoReferenceFrame::geocentricToNED(int iCount, const double* pX, const double* pY, const double* pZ, double* pNorth, double* pEast, double* pDown) const
+{
+    geocentricToENU(iCount, pX, pY, pZ, pEast, pNorth, pDown);
+
+    for (int iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        pDown[iIndex] = -pDown[iIndex];
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Converts \a iCount local points \a pNorth, \a pEast, \a pDown to geocentric \a pX, \a pY, \a pZ. \br
+    The output arrays may be the input arrays.
+*/
+void CGeoReferenceFrame::NEDToGeocentric(int iCount, const double* pNorth, const double* pEast, const double* pDown, double* pX, double* pY, double* pZ) const
+{
+    for (int iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        double dEast = pEast[iIndex];
+        double dNorth = pNorth[iIndex];
+        double dUp = -pDown[iIndex];
+
+        pX[iIndex] = m_dOrigin[0] + m_dRotation[0][0] * dEast + m_dRotation[1][0] * dNorth + m_dRotation[2][0] * dUp;
+        pY[iIndex] = m_dOrigin[1] + m_dRotation[0][1] * dEast + m_dRotation[1][1] * dNorth + m_dRotation[2][1] * dUp;
+        pZ[iIndex] = m_dOrigin[2] + m_dRotation[1][2] * dNorth + m_dRotation[2][2] * dUp;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Converts \a iCount geodetic points \a pLatitudes, \a pLongitudes, \a pAltitudes to \a pEast, \a pNorth, \a pUp. \br
+    Returns \c false and converts nothing if a latitude or longitude is out of range.
+*/
+bool CGeoReferenceFrame::geodeticToENU(int iCount, const double* pLatitudes, const double* pLongitudes, const double* pAltitudes, double* pEast, double* pNorth, double* pUp) const
+{
+    // The output arrays hold geocentric coordinates until they are rotated in place
+    if (Convert_Geodetic_To_Geocentric_Batch(&m_tEllipsoid, iCount, pLatitudes, pLongitudes, pAltitudes, pEast, pNorth, pUp) != GEOCENT_NO_ERROR)
+        return false;
+
+    geocentricToENU(iCount, pEast, pNorth, pUp, pEast, pNorth, pUp);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Converts \a iCount local points \a pEast, \a pNorth, \a pUp to geodetic \a pLatitudes, \a pLongitudes, \a pAltitudes. \br
+    The output arrays may be the input arrays.
+*/
+void CGeoReferenceFrame::ENUToGeodetic(int iCount, const double* pEast, const double* pNorth, const double* pUp, double* pLatitudes, double* pLongitudes, double* pAltitudes) const
+{
+    // The output arrays hold geocentric coordinates until they are converted in place
+    ENUToGeocentric(iCount, pEast, pNorth, pUp, pLatitudes, pLongitudes, pAltitudes);
+
+    Convert_Geocentric_To_Geodetic_Batch(&m_tEllipsoid, iCount, pLatitudes, pLongitudes, pAltitudes, pLatitudes, pLongitudes, pAltitudes);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Converts \a iCount geodetic points \a pLatitudes, \a pLongitudes, \a pAltitudes to \a pNorth, \a pEast, \a pDown. \br
+    Returns \c false and converts nothing if a latitude or longitude is out of range.
+*/
+bool CGeoReferenceFrame::geodeticToNED(int iCount, const double* pLatitudes, const double* pLongitudes, const double* pAltitudes, double* pNorth, double* pEast, double* pDown) const
+{
+    if (Convert_Geodetic_To_Geocentric_Batch(&m_tEllipsoid, iCount, pLatitudes, pLongitudes, pAltitudes, pNorth, pEast, pDown) != GEOCENT_NO_ERROR)
+        return false;
+
+    geocentricToNED(iCount, pNorth, pEast, pDown, pNorth, pEast, pDown);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Converts \a iCount local points \a pNorth, \a pEast, \a pDown to geodetic \a pLatitudes, \a pLongitudes, \a pAltitudes. \br
+    The output arrays may be the input arrays.
+*/
+void CGeoReferenceFrame::NEDToGeodetic(int iCount, const double* pNorth, const double* pEast, const double* pDown, double* pLatitudes, double* pLongitudes, double* pAltitudes) const
+{
+    NEDToGeocentric(iCount, pNorth, pEast, pDown, pLatitudes, pLongitudes, pAltitudes);
+
+    Convert_Geocentric_To_Geodetic_Batch(&m_tEllipsoid, iCount, pLatitudes, pLongitudes, pAltitudes, pLatitudes, pLongitudes, pAltitudes);
+}
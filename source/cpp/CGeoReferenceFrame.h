@@ -0,0 +1,95 @@
+
+#pragma once
+
+#include "qtplus_global.h"
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+
+// Application
+#include "GeoTools/geocent.h"
+
+//-------------------------------------------------------------------------------------------------
+
+//! Defines a local East, North, Up frame on the WGS 84 ellipsoid
+//! Geodetic coordinates are in radians and meters, geocentric and local coordinates in meters
+class QTPLUSSHARED_EXPORT CGeoReferenceFrame
+{
+public:
+
+    //-------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    //-------------------------------------------------------------------------------------------------
+
+    //! Constructs a frame at latitude and longitude 0
+    CGeoReferenceFrame();
+
+    //! Constructs a frame whose origin is the geodetic point dLatitude, dLongitude, dAltitude
+    CGeoReferenceFrame(double dLatitude, double dLongitude, double dAltitude);
+
+    //-------------------------------------------------------------------------------------------------
+    // Getters
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the latitude of the origin
+    double latitude() const { return m_dLatitude; }
+
+    //! Returns the longitude of the origin
+    double longitude() const { return m_dLongitude; }
+
+    //! Returns the altitude of the origin
+    double altitude() const { return m_dAltitude; }
+
+    //! Returns the geocentric X coordinate of the origin
+    double originX() const { return m_dOrigin[0]; }
+
+    //! Returns the geocentric Y coordinate of the origin
+    double originY() const { return m_dOrigin[1]; }
+
+    //! Returns the geocentric Z coordinate of the origin
+    double originZ() const { return m_dOrigin[2]; }
+
+    //! Returns the geocentric component iComponent of the local axis iAxis, 0 for East, 1 for North, 2 for Up
+    double axis(int iAxis, int iComponent) const { return m_dRotation[iAxis][iComponent]; }
+
+    //-------------------------------------------------------------------------------------------------
+    // Control methods
+    //-------------------------------------------------------------------------------------------------
+
+    //! Converts iCount geocentric points to East, North, Up
+    void geocentricToENU(int iCount, const double* pX, const double* pY, const double* pZ, double* pEast, double* pNorth, double* pUp) const;
+
+    //! Converts iCount East, North, Up points to geocentric
+    void ENUToGeocentric(int iCount, const double* pEast, const double* pNorth, const double* pUp, double* pX, double* pY, double* pZ) const;
+
+    //! Converts iCount geocentric points to North, East, Down
+    void geocentricToNED(int iCount, const double* pX, const double* pY, const double* pZ, double* pNorth, double* pEast, double* pDown) const;
+
+    //! Converts iCount North, East, Down points to geocentric
+    void NEDToGeocentric(int iCount, const double* pNorth, const double* pEast, const double* pDown, double* pX, double* pY, double* pZ) const;
+
+    //! Converts iCount geodetic points to East, North, Up, returns false if a coordinate is out of range
+    bool geodeticToENU(int iCount, const double* pLatitudes, const double* pLongitudes, const double* pAltitudes, double* pEast, double* pNorth, double* pUp) const;
+
+    //! Converts iCount East, North, Up points to geodetic
+    void ENUToGeodetic(int iCount, const double* pEast, const double* pNorth, const double* pUp, double* pLatitudes, double* pLongitudes, double* pAltitudes) const;
+
+    //! Converts iCount geodetic points to North, East, Down, returns false if a coordinate is out of range
+    bool geodeticToNED(int iCount, const double* pLatitudes, const double* pLongitudes, const double* pAltitudes, double* pNorth, double* pEast, double* pDown) const;
+
+    //! Converts iCount North, East, Down points to geodetic
+    void NEDToGeodetic(int iCount, const double* pNorth, const double* pEast, const double* pDown, double* pLatitudes, double* pLongitudes, double* pAltitudes) const;
+
+    //-------------------------------------------------------------------------------------------------
+    // Properties
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    Geocentric_Context  m_tEllipsoid;
+    double              m_dLatitude;
+    double              m_dLongitude;
+    double              m_dAltitude;
+    double              m_dOrigin[3];       // Geocentric coordinates of the origin
+    double              m_dRotation[3][3];  // Rows are the East, North and Up axes in geocentric coordinates
+};
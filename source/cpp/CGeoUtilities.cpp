@@ -22,6 +22,9 @@ const double CGeoUtilities::TWO_PI = 2.0 * M_PI;
 const double CGeoUtilities::HALF_PI = 0.5 * M_PI;
 const double CGeoUtilities::fDeg2Rad = M_PI / 180.0;
 const double CGeoUtilities::fRad2Deg = 180.0 / M_PI;
+const double CGeoUtilities::FRAME_ANGLE_STEP = 1e-9;
+const double CGeoUtilities::FRAME_ALTITUDE_STEP = 0.01;
+const int CGeoUtilities::FRAME_CACHE_SIZE = 64;
 
 //-------------------------------------------------------------------------------------------------
 
@@ -32,6 +35,18 @@ static QString Vector3DString(const QVector3D& vec)
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Constructs the CGeoUtilities singleton.
+*/
+CGeoUtilities::CGeoUtilities()
+    : m_cFrames(FRAME_CACHE_SIZE)
+    , m_iFrameHits(0)
+    , m_iFrameMisses(0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Returns a quaternion that would rotate a point from \a vFrom to \a vTo.
 */
@@ -49,36 +64,127 @@ QQuaternion CGeoUtilities::getRotationBetween(const QVector3D& vFrom, const QVec
 //-------------------------------------------------------------------------------------------------
 
 /*!
-    Returns a transform matrix that rotates a point from the geocentric coordinate \a vReference to the geocentric coordinate of lat/lon = 0.
+    Returns a transform matrix that rotates a point from the geocentric coordinate \a vReference to the geocentric coordinate of lat/lon = 0. \br
+    \a vReference has its Y and Z components swapped. The matrix is built from the cached frame of the reference, see referenceFrame() :
+    multiplying a vector by it gives East, Up and North.
 */
 QMatrix4x4 CGeoUtilities::getGeoReferenceMatrix(const QVector3D& vReference)
 {
-    QMatrix4x4 mRotationInverseY;
-
-    QVector3D vReferenceCopy = vReference;
+    double dLatitude;
+    double dLongitude;
+    double dAltitude;
 
-    // Get a quaternion that brings reference to <1, 0, 0> without taking Y component into account
-    QQuaternion mQuat1 = getRotationBetween(QVector3D(1.0, 0.0, 0.0), QVector3D(vReferenceCopy.x(), 0.0, vReferenceCopy.z()));
+    // Reverse Y and Z components of reference (axis conventions)
+    Convert_Geocentric_To_Geodetic(vReference.x(), vReference.z(), vReference.y(), &dLatitude, &dLongitude, &dAltitude);
 
-    mRotationInverseY.rotate(mQuat1);
-    vReferenceCopy = vReferenceCopy * mRotationInverseY;
+    CGeoReferenceFrame tFrame = referenceFrame(dLatitude, dLongitude, dAltitude);
 
-    // Get a quaternion for the X axis rotation
-    QQuaternion mQuat2 = getRotationBetween(QVector3D(1.0, 0.0, 0.0), QVector3D(vReferenceCopy));
+    // Columns are the East, Up and North axes of the frame, rows the X, Z and Y geocentric components
+    const int iSwapped[3] = { 0, 2, 1 };
 
-    // Create a matrix using both quats and 90 degrees about Y and X axis
     QMatrix4x4 mResult;
-    mResult.rotate(mQuat1);
-    mResult.rotate(mQuat2);
-    mResult.rotate(-90.0, 0.0, 1.0, 0.0);
-    mResult.rotate(-90.0, 1.0, 0.0, 0.0);
 
-    // Return the result matrix
+    for (int iRow = 0; iRow < 3; iRow++)
+    {
+        for (int iColumn = 0; iColumn < 3; iColumn++)
+        {
+            mResult(iRow, iColumn) = float(tFrame.axis(iSwapped[iColumn], iSwapped[iRow]));
+        }
+    }
+
     return mResult;
 }
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Returns the local frame whose origin is \a dLatitude, \a dLongitude (in radians) and \a dAltitude, rounded to
+    FRAME_ANGLE_STEP and FRAME_ALTITUDE_STEP. \br
+    The frames of the most recently used origins are kept, so callers that only have coordinates get an already
+    computed frame. Rounding the origin, rather than keeping the first one that falls in a step, makes the result
+    independent of the order of the calls. Safe to call from several threads.
+    \sa setReferenceFrameCacheSize()
+*/
+CGeoReferenceFrame CGeoUtilities::referenceFrame(double dLatitude, double dLongitude, double dAltitude)
+{
+    CGeoFrameKey key;
+    key.iLatitude = qRound64(dLatitude / FRAME_ANGLE_STEP);
+    key.iLongitude = qRound64(dLongitude / FRAME_ANGLE_STEP);
+    key.iAltitude = qRound64(dAltitude / FRAME_ALTITUDE_STEP);
+
+    QMutexLocker locker(&m_mFramesMutex);
+
+    CGeoReferenceFrame* pFrame = m_cFrames.object(key);
+
+    if (pFrame != nullptr)
+    {
+        m_iFrameHits++;
+        return *pFrame;
+    }
+
+    m_iFrameMisses++;
+
+    CGeoReferenceFrame tFrame(key.iLatitude * FRAME_ANGLE_STEP, key.iLongitude * FRAME_ANGLE_STEP, key.iAltitude * FRAME_ALTITUDE_STEP);
+    m_cFrames.insert(key, new CGeoReferenceFrame(tFrame));
+
+    return tFrame;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the number of frames kept by referenceFrame() to \a iFrames. The least recently used frames are dropped first.
+*/
+void CGeoUtilities::setReferenceFrameCacheSize(int iFrames)
+{
+    QMutexLocker locker(&m_mFramesMutex);
+
+    m_cFrames.setMaxCost(iFrames);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of calls to referenceFrame() that found their frame in the cache.
+*/
+int CGeoUtilities::referenceFrameHits() const
+{
+    QMutexLocker locker(&m_mFramesMutex);
+
+    return m_iFrameHits;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of calls to referenceFrame() that had to compute their frame.
+*/
+int CGeoUtilities::referenceFrameMisses() const
+{
+    QMutexLocker locker(&m_mFramesMutex);
+
+    return m_iFrameMisses;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the local frame whose origin is \a gReference, from the frame cache.
+    \sa referenceFrame()
+*/
+#ifdef QT_POSITIONING_LIB
+
+CGeoReferenceFrame CGeoUtilities::referenceFrame(const QGeoCoordinate& gReference)
+{
+    double dAltitude = qIsNaN(gReference.altitude()) ? 0.0 : gReference.altitude();
+
+    return referenceFrame(gReference.latitude() * fDeg2Rad, gReference.longitude() * fDeg2Rad, dAltitude);
+}
+
+#endif
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Returns a 3D point which is the xyz equivalent of \a gPosition relative to \a gReference. \br\br
     Imagining that you are standing at \a gReference on earth, looking to true north, the resulting vector is: \br
@@ -87,53 +193,31 @@ QMatrix4x4 CGeoUtilities::getGeoReferenceMatrix(const QVector3D& vReference)
     \li Y = positive above your head
     \li Z = positive in front of you
     \endlist
+    The axes are those of the cached frame of \a gReference, see referenceFrame() : Y is the normal to the ellipsoid.
     \sa Vector3DToGeoCoordinate()
 */
 #ifdef QT_POSITIONING_LIB
 
 QVector3D CGeoUtilities::GeoCoordinateToVector3D(const QGeoCoordinate& gPosition, const QGeoCoordinate& gReference)
 {
-    double dReference3D_X;
-    double dReference3D_Y;
-    double dReference3D_Z;
-    double dPosition3D_X;
-    double dPosition3D_Y;
-    double dPosition3D_Z;
-    double dTemp;
+    CGeoReferenceFrame tFrame = referenceFrame(gReference);
 
-    // Get geocentric coordinates of reference
-    Convert_Geodetic_To_Geocentric(
-                gReference.latitude() * fDeg2Rad,
-                gReference.longitude() * fDeg2Rad,
-                gReference.altitude(),
-                &dReference3D_X, &dReference3D_Y, &dReference3D_Z
-                );
-
-    // Get geocentric coordinates of position
-    Convert_Geodetic_To_Geocentric(
-                gPosition.latitude() * fDeg2Rad,
-                gPosition.longitude() * fDeg2Rad,
-                gPosition.altitude(),
-                &dPosition3D_X, &dPosition3D_Y, &dPosition3D_Z
-                );
-
-    // Reverse Y and Z components of position and reference (axis conventions)
-    dTemp = dReference3D_Y; dReference3D_Y = dReference3D_Z; dReference3D_Z = dTemp;
-    dTemp = dPosition3D_Y; dPosition3D_Y = dPosition3D_Z; dPosition3D_Z = dTemp;
-
-    // Create vectors using doubles
-    QVector3D vReference3D(dReference3D_X, dReference3D_Y, dReference3D_Z);
-    QVector3D vPosition3D(dPosition3D_X, dPosition3D_Y, dPosition3D_Z);
-
-    // Get the magic transform matrix
-    QMatrix4x4 mRotationInverse = getGeoReferenceMatrix(vReference3D);
-
-    // Transform both position and reference using the matrix
-    vReference3D = vReference3D * mRotationInverse;
-    vPosition3D = vPosition3D * mRotationInverse;
-
-    // Return the difference between position and reference in xyz coord system
-    return vPosition3D - vReference3D;
+    double dX[2];
+    double dY[2];
+    double dZ[2];
+    double dEast[2];
+    double dNorth[2];
+    double dUp[2];
+
+    // Get geocentric coordinates of position and reference
+    Convert_Geodetic_To_Geocentric(gPosition.latitude() * fDeg2Rad, gPosition.longitude() * fDeg2Rad, gPosition.altitude(), &dX[0], &dY[0], &dZ[0]);
+    Convert_Geodetic_To_Geocentric(gReference.latitude() * fDeg2Rad, gReference.longitude() * fDeg2Rad, gReference.altitude(), &dX[1], &dY[1], &dZ[1]);
+
+    // The frame origin is the reference rounded to the frame steps, so the reference is subtracted in the frame
+    tFrame.geocentricToENU(2, dX, dY, dZ, dEast, dNorth, dUp);
+
+    // Reverse Y and Z components (axis conventions)
+    return QVector3D(dEast[0] - dEast[1], dUp[0] - dUp[1], dNorth[0] - dNorth[1]);
 }
 
 #endif
@@ -149,52 +233,35 @@ QVector3D CGeoUtilities::GeoCoordinateToVector3D(const QGeoCoordinate& gPosition
 
 QGeoCoordinate CGeoUtilities::Vector3DToGeoCoordinate(const QVector3D& vPosition, const QGeoCoordinate& gReference)
 {
-    double dReference3D_X;
-    double dReference3D_Y;
-    double dReference3D_Z;
+    CGeoReferenceFrame tFrame = referenceFrame(gReference);
+
+    double dReferenceX;
+    double dReferenceY;
+    double dReferenceZ;
+    double dX;
+    double dY;
+    double dZ;
     double dLatitude;
     double dLongitude;
     double dAltitude;
-    double dTemp;
 
-    //-----------------------------------------------
-    // Rcupration des coordonnes gocentriques
-
-    Convert_Geodetic_To_Geocentric(
-                gReference.latitude() * fDeg2Rad,
-                gReference.longitude() * fDeg2Rad,
-                gReference.altitude(),
-                &dReference3D_X, &dReference3D_Y, &dReference3D_Z
-                );
-
-    // Reverse Y and Z components of reference (axis conventions)
-    dTemp = dReference3D_Y; dReference3D_Y = dReference3D_Z; dReference3D_Z = dTemp;
-
-    // Create a vector using doubles
-    QVector3D vReference3D(dReference3D_X, dReference3D_Y, dReference3D_Z);
-
-    // Get the magic transform matrix
-    QMatrix4x4 mRotationInverse = getGeoReferenceMatrix(vReference3D);
-
-    // Transform reference using the matrix
-    vReference3D = vReference3D * mRotationInverse;
+    // Get geocentric coordinates of reference
+    Convert_Geodetic_To_Geocentric(gReference.latitude() * fDeg2Rad, gReference.longitude() * fDeg2Rad, gReference.altitude(), &dReferenceX, &dReferenceY, &dReferenceZ);
 
-    // Add reference and position
-    QVector3D vPosition3D = vReference3D + vPosition;
+    // Reverse Y and Z components of position (axis conventions)
+    double dEast = vPosition.x();
+    double dNorth = vPosition.z();
+    double dUp = vPosition.y();
 
-    // Transform position using the matrix' inverse
-    vPosition3D = vPosition3D * mRotationInverse.inverted();
+    tFrame.ENUToGeocentric(1, &dEast, &dNorth, &dUp, &dX, &dY, &dZ);
 
-    // Reverse Y and Z components of position (axis conventions)
-    dTemp = vPosition3D.y(); vPosition3D.setY(vPosition3D.z()); vPosition3D.setZ(dTemp);
+    // Move from the frame origin, which is rounded, to the reference
+    dX += dReferenceX - tFrame.originX();
+    dY += dReferenceY - tFrame.originY();
+    dZ += dReferenceZ - tFrame.originZ();
 
     // Get geodetic coordinates of position
-    Convert_Geocentric_To_Geodetic(
-        vPosition3D.x(), vPosition3D.y(), vPosition3D.z(),
-        &dLatitude,
-        &dLongitude,
-        &dAltitude
-        );
+    Convert_Geocentric_To_Geodetic(dX, dY, dZ, &dLatitude, &dLongitude, &dAltitude);
 
     // Return a geo coordinate using result
     return QGeoCoordinate(dLatitude * fRad2Deg, dLongitude * fRad2Deg, dAltitude);
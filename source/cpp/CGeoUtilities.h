@@ -16,6 +16,8 @@
 #include <QVector3D>
 #include <QMatrix4x4>
 #include <QQuaternion>
+#include <QCache>
+#include <QMutex>
 
 #ifdef QT_POSITIONING_LIB
 #include <QGeoCoordinate>
@@ -23,6 +25,27 @@
 
 // Application
 #include "CSingleton.h"
+#include "CGeoReferenceFrame.h"
+
+//-------------------------------------------------------------------------------------------------
+
+//! Key of a cached reference frame : its origin in steps of the frame cache
+struct CGeoFrameKey
+{
+    qint64 iLatitude;
+    qint64 iLongitude;
+    qint64 iAltitude;
+
+    bool operator == (const CGeoFrameKey& target) const
+    {
+        return iLatitude == target.iLatitude && iLongitude == target.iLongitude && iAltitude == target.iAltitude;
+    }
+};
+
+inline uint qHash(const CGeoFrameKey& key, uint uiSeed = 0)
+{
+    return qHash(key.iLatitude, uiSeed) ^ (qHash(key.iLongitude, uiSeed) * 31) ^ (qHash(key.iAltitude, uiSeed) * 131);
+}
 
 //-------------------------------------------------------------------------------------------------
 
@@ -42,6 +65,9 @@ public:
     static const double HALF_PI;
     static const double fDeg2Rad;
     static const double fRad2Deg;
+    static const double FRAME_ANGLE_STEP;       // Radians between cached frame origins
+    static const double FRAME_ALTITUDE_STEP;    // Meters between cached frame origins
+    static const int FRAME_CACHE_SIZE;          // Default number of cached frames
 
     //-------------------------------------------------------------------------------------------------
     // Control methods
@@ -53,8 +79,24 @@ public:
     //! Returns a transform matrix that rotates a point from the geocentric coordinate \a vReference to the geocentric coordinate of lat/lon = 0.
     QMatrix4x4 getGeoReferenceMatrix(const QVector3D& vReference);
 
+    //! Returns the frame whose origin is dLatitude, dLongitude (radians), dAltitude rounded to the frame steps.
+    //! Frames are kept in a cache of the most recently used ones.
+    CGeoReferenceFrame referenceFrame(double dLatitude, double dLongitude, double dAltitude);
+
+    //! Sets the number of frames kept by referenceFrame()
+    void setReferenceFrameCacheSize(int iFrames);
+
+    //! Returns the number of frames found in the cache
+    int referenceFrameHits() const;
+
+    //! Returns the number of frames that had to be computed
+    int referenceFrameMisses() const;
+
 #ifdef QT_POSITIONING_LIB
 
+    //! Returns the frame whose origin is gReference rounded to the frame steps, from the frame cache.
+    CGeoReferenceFrame referenceFrame(const QGeoCoordinate& gReference);
+
     //! Returns a 3D point which is the xyz equivalent of \a gPosition relative to \a gReference.
     QVector3D GeoCoordinateToVector3D(const QGeoCoordinate& gPosition, const QGeoCoordinate& gReference);
 
@@ -63,4 +105,23 @@ public:
 
 #endif
 
+    //-------------------------------------------------------------------------------------------------
+    // Protected methods
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! Constructor
+    CGeoUtilities();
+
+    //-------------------------------------------------------------------------------------------------
+    // Properties
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    mutable QMutex                              m_mFramesMutex;
+    QCache<CGeoFrameKey, CGeoReferenceFrame>    m_cFrames;              // Most recently used frames
+    int                                         m_iFrameHits;
+    int                                         m_iFrameMisses;
 };
@@ -40,7 +40,7 @@ public:
     //-------------------------------------------------------------------------------------------------
 
     //! Set folder
-    void setGrammar(const CXMLNode& xGrammar);
+    virtual void setGrammar(const CXMLNode& xGrammar);
 
     //-------------------------------------------------------------------------------------------------
     // Getters
@@ -6,6 +6,7 @@
 
 // Qt
 #include <QString>
+#include <QMutexLocker>
 
 // Application
 #include "CSingletonPool.h"
@@ -25,6 +26,8 @@ public:
     //! Gets the unique instance of the class
     static T* getInstance()
     {
+        QMutexLocker locker(CSingletonPool::mutex());
+
         CSingletonPool::init();
 
         QString sClassName(typeid(T).name());
@@ -40,6 +43,8 @@ public:
     //! Destroys the unique instance of the class
     static void killInstance()
     {
+        QMutexLocker locker(CSingletonPool::mutex());
+
         QString sClassName(typeid(T).name());
 
         if (CSingletonPool::s_pSingletons->contains(sClassName))
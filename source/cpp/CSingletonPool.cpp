@@ -18,3 +18,16 @@ void CSingletonPool::init()
         s_pSingletons = new QMap<QString, void*>;
     }
 }
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the mutex guarding s_pSingletons. It is recursive because a singleton may get other singletons
+    in its constructor.
+*/
+QMutex* CSingletonPool::mutex()
+{
+    static QMutex s_mMutex(QMutex::Recursive);
+
+    return &s_mMutex;
+}
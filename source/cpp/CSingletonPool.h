@@ -4,6 +4,7 @@
 // Qt
 #include <QString>
 #include <QMap>
+#include <QMutex>
 
 // Application
 #include "qtplus_global.h"
@@ -21,6 +22,9 @@ public:
     //!
     static void init();
 
+    //! Returns the mutex guarding s_pSingletons
+    static QMutex* mutex();
+
     //-------------------------------------------------------------------------------------------------
     // Properties
     //-------------------------------------------------------------------------------------------------
@@ -0,0 +1,199 @@
+
+// Std
+#include <string.h>
+
+// Application
+#include "CSoundRingBuffer.h"
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    \class CSoundRingBuffer
+    \inmodule qt-plus
+    \brief A single-producer, single-consumer ring buffer of bytes.
+
+    The producer and the consumer each own one counter of bytes, published with release semantics,
+    so neither side ever locks or allocates. The counters are allowed to wrap around since the size
+    is a power of two. \br\br
+    A read that gets less bytes than requested, or than the size of the buffer, is counted as an
+    underrun, except before the first fully satisfied read so that start-up is not counted. A write
+    that does not fit entirely is counted as an overrun.
+    \sa CSoundSynth
+*/
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Constructs a ring buffer of \a iSize bytes. \a iSize must be a power of two.
+*/
+CSoundRingBuffer::CSoundRingBuffer(int iSize)
+    : m_baData(iSize, 0)
+    , m_uMask(quint32(iSize - 1))
+    , m_iReadCount(0)
+    , m_iWriteCount(0)
+    , m_iUnderruns(0)
+    , m_iOverruns(0)
+    , m_bFilled(false)
+{
+    Q_ASSERT(iSize > 0 && (iSize & (iSize - 1)) == 0);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Destroys a CSoundRingBuffer.
+*/
+CSoundRingBuffer::~CSoundRingBuffer()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the capacity of the buffer in bytes.
+*/
+int CSoundRingBuffer::size() const
+{
+    return m_baData.count();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of bytes waiting to be read.
+*/
+qint64 CSoundRingBuffer::bufferedBytes() const
+{
+    return qint64(quint32(m_iWriteCount.loadAcquire() - m_iReadCount.loadAcquire()));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of bytes that can be written.
+*/
+qint64 CSoundRingBuffer::freeBytes() const
+{
+    return size() - bufferedBytes();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of calls to read() that got less bytes than requested after the buffer was first filled.
+*/
+qint64 CSoundRingBuffer::underrunCount() const
+{
+    return m_iUnderruns.load();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of calls to write() that could not copy all their bytes.
+*/
+qint64 CSoundRingBuffer::overrunCount() const
+{
+    return m_iOverruns.load();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Copies at most \a iLength bytes of \a pData to the buffer. \br
+    Returns the number of bytes copied. Must only be called by the producer.
+*/
+qint64 CSoundRingBuffer::write(const char* pData, qint64 iLength)
+{
+    char* pFirst = nullptr;
+    char* pSecond = nullptr;
+    qint64 iFirst = 0;
+    qint64 iCount = reserve(iLength, pFirst, iFirst, pSecond);
+
+    if (iCount > 0)
+    {
+        memcpy(pFirst, pData, size_t(iFirst));
+        memcpy(pSecond, pData + iFirst, size_t(iCount - iFirst));
+
+        commit(iCount);
+    }
+
+    if (iCount < iLength)
+    {
+        m_iOverruns.fetchAndAddRelaxed(1);
+    }
+
+    return iCount;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Reserves at most \a iLength bytes of free space : \a iFirst bytes at \a pFirst, followed by the
+    rest at \a pSecond, which is the start of the buffer. \br
+    Returns the number of bytes reserved. The producer fills them, then calls commit().
+*/
+qint64 CSoundRingBuffer::reserve(qint64 iLength, char*& pFirst, qint64& iFirst, char*& pSecond)
+{
+    quint32 uWrite = m_iWriteCount.load();
+    quint32 uRead = m_iReadCount.loadAcquire();
+    qint64 iCount = qMax(qMin(iLength, qint64(size()) - qint64(quint32(uWrite - uRead))), qint64(0));
+    int iStart = int(uWrite & m_uMask);
+
+    pFirst = m_baData.data() + iStart;
+    pSecond = m_baData.data();
+    iFirst = qMin(iCount, qint64(size() - iStart));
+
+    return iCount;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Makes \a iLength bytes filled after a call to reserve() available to the consumer. \br
+    Must only be called by the producer.
+*/
+void CSoundRingBuffer::commit(qint64 iLength)
+{
+    m_iWriteCount.storeRelease(m_iWriteCount.load() + quint32(iLength));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Copies at most \a iLength bytes of the buffer to \a pData. \br
+    Returns the number of bytes copied. Must only be called by the consumer.
+*/
+qint64 CSoundRingBuffer::read(char* pData, qint64 iLength)
+{
+    quint32 uRead = m_iReadCount.load();
+    quint32 uWrite = m_iWriteCount.loadAcquire();
+    qint64 iCount = qMax(qMin(iLength, qint64(quint32(uWrite - uRead))), qint64(0));
+
+    if (iCount > 0)
+    {
+        int iStart = int(uRead & m_uMask);
+        int iFirst = int(qMin(iCount, qint64(size() - iStart)));
+        const char* pBuffer = m_baData.constData();
+
+        memcpy(pData, pBuffer + iStart, size_t(iFirst));
+        memcpy(pData + iFirst, pBuffer, size_t(iCount - iFirst));
+
+        m_iReadCount.storeRelease(uRead + quint32(iCount));
+    }
+
+    // A read larger than the buffer can not be satisfied, it is only short if it got less than the size
+    if (iCount < qMin(iLength, qint64(size())))
+    {
+        if (m_bFilled)
+        {
+            m_iUnderruns.fetchAndAddRelaxed(1);
+        }
+    }
+    else if (iLength > 0)
+    {
+        m_bFilled = true;
+    }
+
+    return iCount;
+}
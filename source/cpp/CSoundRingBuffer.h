@@ -0,0 +1,82 @@
+
+#pragma once
+
+#include "qtplus_global.h"
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+
+// Qt
+#include <QAtomicInteger>
+#include <QByteArray>
+
+//-------------------------------------------------------------------------------------------------
+
+//! Defines a lock-free ring buffer of bytes between one producer thread and one consumer thread
+class QTPLUSSHARED_EXPORT CSoundRingBuffer
+{
+public:
+
+    //-------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    //-------------------------------------------------------------------------------------------------
+
+    //! Constructor, iSize must be a power of two
+    CSoundRingBuffer(int iSize);
+
+    //! Destructor
+    virtual ~CSoundRingBuffer();
+
+    //-------------------------------------------------------------------------------------------------
+    // Getters
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the capacity in bytes
+    int size() const;
+
+    //! Returns the number of bytes waiting to be read
+    qint64 bufferedBytes() const;
+
+    //! Returns the number of bytes that can be written
+    qint64 freeBytes() const;
+
+    //! Returns the number of reads that found the buffer short of data after it was first filled
+    qint64 underrunCount() const;
+
+    //! Returns the number of writes that did not fit in the buffer
+    qint64 overrunCount() const;
+
+    //-------------------------------------------------------------------------------------------------
+    // Control methods
+    //-------------------------------------------------------------------------------------------------
+
+    //! Copies at most iLength bytes of pData to the buffer, returns the number of bytes copied
+    //! Must only be called by the producer
+    qint64 write(const char* pData, qint64 iLength);
+
+    //! Reserves at most iLength bytes of free space, as iFirst bytes at pFirst followed by the rest at pSecond
+    //! Returns the number of bytes reserved, must only be called by the producer
+    qint64 reserve(qint64 iLength, char*& pFirst, qint64& iFirst, char*& pSecond);
+
+    //! Makes iLength reserved bytes available to the consumer
+    //! Must only be called by the producer
+    void commit(qint64 iLength);
+
+    //! Copies at most iLength bytes of the buffer to pData, returns the number of bytes copied
+    //! Must only be called by the consumer
+    qint64 read(char* pData, qint64 iLength);
+
+    //-------------------------------------------------------------------------------------------------
+    // Properties
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    QByteArray              m_baData;           // The bytes, its size is a power of two
+    quint32                 m_uMask;            // Size minus one
+    QAtomicInteger<quint32> m_iReadCount;       // Bytes read, written by the consumer only
+    QAtomicInteger<quint32> m_iWriteCount;      // Bytes written, written by the producer only
+    QAtomicInteger<qint64>  m_iUnderruns;
+    QAtomicInteger<qint64>  m_iOverruns;
+    bool                    m_bFilled;          // True once a read was fully satisfied, used by the consumer only
+};
@@ -1,12 +1,25 @@
 
 // Qt
 #include <QDebug>
+#include <QSysInfo>
 
 // Application
 #include "CSoundSynth.h"
 
 const int DataSampleRateHz  = 44100;
 
+// Size of the ring buffer, about 185 ms of 16 bit mono samples at 44100 Hz, must be a power of two
+const int RingBufferBytes   = 16384;
+
+// The generator is woken up when the ring buffer holds less than this, if it runs synthesize()
+const int RingLowWaterBytes = RingBufferBytes / 2;
+
+// Fill level the voice bank is rendered to, about 6 ms, raised to two reads of the audio output if they are larger
+const int RenderTargetBytes = 512;
+
+// Longest time the generator sleeps without being woken up, in milliseconds
+const int GeneratorTimeoutMs = 50;
+
 //-------------------------------------------------------------------------------------------------
 
 /*!
@@ -14,17 +27,29 @@ const int DataSampleRateHz  = 44100;
     \inmodule qt-plus
     \brief A real-time sound generation class.
 
-    Base class for sound synths, the synthesize must be overridden
+    Base class for sound synths, the synthesize must be overridden unless the synth is constructed
+    with voices : in that case a CSoundVoiceBank renders 16 bit samples directly to the ring buffer
+    and its notes are played with voiceBank(). \br\br
+    Synthesized bytes go through a CSoundRingBuffer : the generator thread writes to it and
+    readData(), called by the audio output, reads from it without locking or allocating. \br
+    Blocks of synthesize() are written while they fit and the generator sleeps until the ring buffer
+    holds less than half its size. The voice bank is only rendered up to a few milliseconds ahead of
+    the audio output, so that notes are heard shortly after noteOn().
 */
 
 //-------------------------------------------------------------------------------------------------
 
 /*!
-    Constructs a CSoundSynth.
+    Constructs a CSoundSynth. \br
+    If \a iVoiceCount is not zero, a voice bank of \a iVoiceCount voices feeds the audio output,
+    provided the output takes 16 bit signed mono samples in native byte order.
 */
-CSoundSynth::CSoundSynth()
+CSoundSynth::CSoundSynth(int iVoiceCount)
     : m_tGenerator(this)
     , m_tDevice(QAudioDeviceInfo::defaultOutputDevice())
+    , m_pVoiceBank(nullptr)
+    , m_tRing(RingBufferBytes)
+    , m_iLargestRead(0)
 {
     m_tFormat.setSampleRate(DataSampleRateHz);
     m_tFormat.setChannelCount(1);
@@ -41,6 +66,19 @@ CSoundSynth::CSoundSynth()
         m_tFormat = info.nearestFormat(m_tFormat);
     }
 
+    if (iVoiceCount > 0)
+    {
+        if (m_tFormat.sampleSize() != 16 || m_tFormat.channelCount() != 1 || m_tFormat.sampleType() != QAudioFormat::SignedInt
+                || m_tFormat.byteOrder() != QAudioFormat::Endian(QSysInfo::ByteOrder))
+        {
+            qWarning() << "Voice bank needs 16 bit signed mono samples - output format not supported, no voices created";
+        }
+        else
+        {
+            m_pVoiceBank = new CSoundVoiceBank(iVoiceCount, m_tFormat.sampleRate());
+        }
+    }
+
     open(QIODevice::ReadOnly);
 
     m_tAudioOutput = new QAudioOutput(m_tDevice, m_tFormat, this);
@@ -56,7 +94,54 @@ CSoundSynth::CSoundSynth()
 */
 CSoundSynth::~CSoundSynth()
 {
+    m_tGenerator.stopMe();
+
     close();
+
+    delete m_pVoiceBank;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the built-in voice bank, or \c nullptr if the synth was constructed without voices or
+    if the output format does not suit them.
+*/
+CSoundVoiceBank* CSoundSynth::voiceBank()
+{
+    return m_pVoiceBank;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of bytes waiting in the ring buffer.
+*/
+qint64 CSoundSynth::bufferedBytes() const
+{
+    return m_tRing.bufferedBytes();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of calls to readData() that found less bytes than requested in the ring buffer. \br
+    Reads made before the ring buffer was first filled are not counted.
+*/
+qint64 CSoundSynth::underrunCount() const
+{
+    return m_tRing.underrunCount();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of synthesized blocks that did not fit in the ring buffer. \br
+    Such a block is not lost, the generator writes the rest of it when space is available.
+*/
+qint64 CSoundSynth::overrunCount() const
+{
+    return m_tRing.overrunCount();
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -73,42 +158,74 @@ QByteArray CSoundSynth::synthesize(qint64 pos)
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Returns the fill level the voice bank is rendered to : RenderTargetBytes, or twice the largest
+    read of the audio output if it is larger, within the size of the ring buffer.
+*/
+qint64 CSoundSynth::renderTargetBytes() const
+{
+    return qMin(qMax(qint64(RenderTargetBytes), 2 * m_iLargestRead.loadAcquire()), qint64(m_tRing.size())) & ~1;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the level under which the generator is woken up.
+*/
+qint64 CSoundSynth::lowWaterBytes() const
+{
+    return m_pVoiceBank != nullptr ? renderTargetBytes() / 2 : RingLowWaterBytes;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Renders the voice bank to the ring buffer, without intermediate copy, until it holds
+    renderTargetBytes(). \br
+    Returns the number of bytes written. Must only be called by the generator thread.
+*/
+qint64 CSoundSynth::renderRing()
+{
+    char* pFirst = nullptr;
+    char* pSecond = nullptr;
+    qint64 iFirst = 0;
+
+    // Whole samples only, so that samples never straddle the end of the ring buffer
+    qint64 iCount = m_tRing.reserve((renderTargetBytes() - m_tRing.bufferedBytes()) & ~1, pFirst, iFirst, pSecond);
+
+    if (iCount > 0)
+    {
+        m_pVoiceBank->render(reinterpret_cast<qint16*>(pFirst), int(iFirst / 2));
+        m_pVoiceBank->render(reinterpret_cast<qint16*>(pSecond), int((iCount - iFirst) / 2));
+
+        m_tRing.commit(iCount);
+    }
+
+    return iCount;
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Overrides QIODevice::readData. \br\br
-    Returns number of bytes read to \a data, limited by \a len
+    Returns number of bytes read to \a data, limited by \a len. \br
+    Never blocks : if the ring buffer holds less than \a len bytes once playing, an underrun is counted.
 */
 qint64 CSoundSynth::readData(char* data, qint64 len)
 {
-    qint64 iRemaining = len;
-    char* pCurrentData = data;
+    qint64 iRead = m_tRing.read(data, len);
 
-    if (m_lBuffers.count() == 0)
+    if (len > m_iLargestRead.load())
     {
-        m_lBuffers << m_tGenerator.getBuffers();
+        m_iLargestRead.storeRelease(len);
     }
 
-    while (true)
+    if (bufferedBytes() < lowWaterBytes())
     {
-        if (iRemaining == 0) break;
-        if (m_lBuffers.count() == 0) break;
-
-        if (iRemaining >= m_lBuffers[0].count())
-        {
-            memcpy(pCurrentData, m_lBuffers[0].constData(), m_lBuffers[0].count());
-            pCurrentData += m_lBuffers[0].count();
-            iRemaining -= m_lBuffers[0].count();
-            m_lBuffers.removeAt(0);
-        }
-        else
-        {
-            memcpy(pCurrentData, m_lBuffers[0].constData(), iRemaining);
-            m_lBuffers[0].remove(0, iRemaining);
-            iRemaining = 0;
-            pCurrentData += iRemaining;
-        }
+        m_tGenerator.wakeUp();
     }
 
-    return len - iRemaining;
+    return iRead;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -133,23 +250,17 @@ qint64 CSoundSynth::writeData(const char *data, qint64 len)
 */
 qint64 CSoundSynth::bytesAvailable() const
 {
-    qint64 total = 0;
-
-    for (QByteArray baData : m_lBuffers)
-    {
-        total += baData.count();
-    }
-
-    return total + QIODevice::bytesAvailable();
+    return bufferedBytes() + QIODevice::bytesAvailable();
 }
 
 //-------------------------------------------------------------------------------------------------
 
 CSoundSynth::CSoundSynthGenerator::CSoundSynthGenerator(CSoundSynth* pSynth)
-    : m_tMutex(QMutex::Recursive)
-    , m_pSynth(pSynth)
+    : m_pSynth(pSynth)
+    , m_iPendingOffset(0)
     , m_iPosition(0)
-    , m_bRun(true)
+    , m_iWaiting(0)
+    , m_iRun(1)
 {
 }
 
@@ -163,40 +274,27 @@ CSoundSynth::CSoundSynthGenerator::~CSoundSynthGenerator()
 //-------------------------------------------------------------------------------------------------
 
 /*!
-    Returns the audio buffers.
+    Stops the synthesize thread.
 */
-QList<QByteArray> CSoundSynth::CSoundSynthGenerator::getBuffers()
+void CSoundSynth::CSoundSynthGenerator::stopMe()
 {
-    QList<QByteArray> baReturnValue;
-
-    if (m_tMutex.tryLock(200))
-    {
-        for (QByteArray baBuffer : m_lBuffers)
-        {
-            baReturnValue << baBuffer;
-        }
-
-        m_lBuffers.clear();
-
-        m_tMutex.unlock();
-    }
-    else
-    {
-        qWarning() << "Unable to lock audio mutex";
-    }
-
-    return baReturnValue;
+    m_iRun.storeRelease(0);
+    m_tWakeUp.release();
+    wait();
 }
 
 //-------------------------------------------------------------------------------------------------
 
 /*!
-    Stops the synthesize thread.
+    Wakes the synthesize thread up if it is waiting. \br
+    Called by the audio thread, only releases the semaphore once per wait.
 */
-void CSoundSynth::CSoundSynthGenerator::stopMe()
+void CSoundSynth::CSoundSynthGenerator::wakeUp()
 {
-    m_bRun = false;
-    wait();
+    if (m_iWaiting.testAndSetOrdered(1, 0))
+    {
+        m_tWakeUp.release();
+    }
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -205,35 +303,62 @@ void CSoundSynth::CSoundSynthGenerator::run()
 {
     if (m_pSynth != nullptr)
     {
-        while (m_bRun)
+        while (m_iRun.loadAcquire() != 0)
         {
-            if (m_tMutex.tryLock(200))
-            {
-                int iBufferCount = m_lBuffers.count();
-                m_tMutex.unlock();
+            bool bIdle = false;
 
-                if (iBufferCount < 3)
+            if (m_pSynth->m_pVoiceBank != nullptr)
+            {
+                m_iPosition += m_pSynth->renderRing();
+            }
+            else
+            {
+                // Fill the ring buffer, synthesizing a new block only when the last one fits
+                while (m_iRun.loadAcquire() != 0)
                 {
-                    QByteArray baNewData = m_pSynth->synthesize(m_iPosition);
-
-                    if (m_tMutex.tryLock(200))
+                    if (m_iPendingOffset < m_baPending.count())
                     {
-                        m_lBuffers << baNewData;
-                        m_iPosition += m_lBuffers.last().count();
-                        m_tMutex.unlock();
+                        // The rest of a block that overran is written as space frees up, without counting again
+                        qint64 iLength = qMin(qint64(m_baPending.count() - m_iPendingOffset), m_pSynth->m_tRing.freeBytes());
+
+                        m_iPendingOffset += int(m_pSynth->m_tRing.write(m_baPending.constData() + m_iPendingOffset, iLength));
+
+                        if (m_iPendingOffset < m_baPending.count())
+                            break;
+
+                        continue;
                     }
-                    else
+
+                    qint64 iFree = m_pSynth->m_tRing.freeBytes();
+
+                    if (iFree < qMin(m_baPending.count(), RingLowWaterBytes))
+                        break;
+
+                    m_baPending = m_pSynth->synthesize(m_iPosition);
+                    m_iPendingOffset = int(m_pSynth->m_tRing.write(m_baPending.constData(), m_baPending.count()));
+                    m_iPosition += m_baPending.count();
+
+                    if (m_baPending.isEmpty())
                     {
-                        qWarning() << "Unable to lock audio mutex";
+                        bIdle = true;
+                        break;
                     }
+
+                    if (m_iPendingOffset < m_baPending.count())
+                        break;
                 }
             }
-            else
+
+            // Sleep until the audio thread drains the ring buffer below the low water mark
+            // The level is checked after raising the flag so that a wake up is not missed
+            m_iWaiting.storeRelease(1);
+
+            if (bIdle || m_pSynth->bufferedBytes() >= m_pSynth->lowWaterBytes())
             {
-                qWarning() << "Unable to lock audio mutex";
+                m_tWakeUp.tryAcquire(1, GeneratorTimeoutMs);
             }
 
-            msleep(50);
+            m_iWaiting.storeRelease(0);
         }
     }
 }
@@ -8,13 +8,17 @@
 
 // Qt
 #include <QAudioOutput>
+#include <QAtomicInt>
+#include <QAtomicInteger>
 #include <QByteArray>
 #include <QIODevice>
+#include <QSemaphore>
 #include <QThread>
-#include <QMutex>
 
 // Application
 #include "CInterpolator.h"
+#include "CSoundRingBuffer.h"
+#include "CSoundVoiceBank.h"
 
 //-------------------------------------------------------------------------------------------------
 
@@ -30,12 +34,28 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
-    //! Default constructor
-    CSoundSynth();
+    //! Constructor, iVoiceCount voices of the built-in voice bank are rendered instead of calling synthesize()
+    CSoundSynth(int iVoiceCount = 0);
 
     //! Destructor
     virtual ~CSoundSynth() Q_DECL_OVERRIDE;
 
+    //-------------------------------------------------------------------------------------------------
+    // Getters
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the built-in voice bank, nullptr if the synth was constructed without voices
+    CSoundVoiceBank* voiceBank();
+
+    //! Returns the number of bytes waiting in the ring buffer
+    qint64 bufferedBytes() const;
+
+    //! Returns the number of reads that the ring buffer could not fully satisfy once playing
+    qint64 underrunCount() const;
+
+    //! Returns the number of synthesized blocks that did not fit in the ring buffer
+    qint64 overrunCount() const;
+
     //-------------------------------------------------------------------------------------------------
     // Control methods
     //-------------------------------------------------------------------------------------------------
@@ -52,6 +72,18 @@ public:
     //! Method to implement when overriding this class
     virtual QByteArray synthesize(qint64 pos);
 
+protected:
+
+    //! Returns the fill level of the ring buffer the voice bank is rendered to
+    qint64 renderTargetBytes() const;
+
+    //! Returns the fill level of the ring buffer under which the generator is woken up
+    qint64 lowWaterBytes() const;
+
+    //! Renders the voice bank to the ring buffer up to renderTargetBytes(), returns the number of bytes written
+    //! Must only be called by the generator thread
+    qint64 renderRing();
+
     //-------------------------------------------------------------------------------------------------
     // Slots
     //-------------------------------------------------------------------------------------------------
@@ -76,13 +108,6 @@ protected:
 
         virtual ~CSoundSynthGenerator() Q_DECL_OVERRIDE;
 
-        //-------------------------------------------------------------------------------------------------
-        // Getters
-        //-------------------------------------------------------------------------------------------------
-
-        //! Returns the generated audio buffers if any
-        QList<QByteArray> getBuffers();
-
         //-------------------------------------------------------------------------------------------------
         // Control methods
         //-------------------------------------------------------------------------------------------------
@@ -90,6 +115,9 @@ protected:
         //! Stops the thread
         void stopMe();
 
+        //! Wakes the thread up if it is waiting for the ring buffer to drain
+        void wakeUp();
+
         //! The main thread method
         virtual void run() Q_DECL_OVERRIDE;
 
@@ -99,11 +127,13 @@ protected:
 
     protected:
 
-        QMutex                  m_tMutex;       // For data protection
         CSoundSynth*            m_pSynth;       // The master of this class
-        QList<QByteArray>       m_lBuffers;     // The generated buffers
-        qint64                  m_iPosition;    // The current position in samples
-        bool                    m_bRun;         // Running flag
+        QByteArray              m_baPending;    // Synthesized bytes not yet in the ring buffer
+        int                     m_iPendingOffset;   // Start of the bytes of m_baPending left to write
+        qint64                  m_iPosition;    // The current position in bytes
+        QSemaphore              m_tWakeUp;      // Released when the ring buffer needs data
+        QAtomicInt              m_iWaiting;     // 1 while the thread waits on m_tWakeUp
+        QAtomicInt              m_iRun;         // Running flag
     };
 
     //-------------------------------------------------------------------------------------------------
@@ -116,5 +146,7 @@ protected:
     QAudioDeviceInfo        m_tDevice;          // The output device
     QAudioOutput*           m_tAudioOutput;     // The audio output
     QAudioFormat            m_tFormat;          // The audio format
-    QList<QByteArray>       m_lBuffers;         // The buffers comming from CSoundSynthGenerator
+    CSoundVoiceBank*        m_pVoiceBank;       // The built-in voices, if any
+    CSoundRingBuffer        m_tRing;            // Samples from the generator to the audio output
+    QAtomicInteger<qint64>  m_iLargestRead;     // Largest length asked to readData(), written by the audio thread only
 };
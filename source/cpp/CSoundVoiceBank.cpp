@@ -0,0 +1,400 @@
+
+// Std
+#include <math.h>
+
+// Application
+#include "CSoundVoiceBank.h"
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    \class CSoundVoiceBank
+    \inmodule qt-plus
+    \brief A bank of oscillator voices for real-time synthesis.
+
+    Each voice has a sine, sawtooth, square or noise oscillator driven by a phase accumulator, and a
+    linear ADSR envelope. Voices are rendered by blocks of BlockFrames samples : the envelope is
+    advanced once per block and ramped linearly over it, so the per-sample loops only hold
+    arithmetic and vectorize. Oscillators are not band-limited. \br\br
+    Notes may be started and released from any thread while another thread renders.
+    \sa CSoundSynth
+*/
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Constructs a bank of \a iVoiceCount voices rendering at \a iSampleRate samples per second.
+*/
+CSoundVoiceBank::CSoundVoiceBank(int iVoiceCount, int iSampleRate)
+    : m_iSampleRate(qMax(iSampleRate, 1))
+    , m_fMasterGain(1.0f)
+    , m_uNoteCount(0)
+    , m_vWaveform(iVoiceCount, wSine)
+    , m_vStage(iVoiceCount, sIdle)
+    , m_vPhase(iVoiceCount, 0.0f)
+    , m_vIncrement(iVoiceCount, 0.0f)
+    , m_vAmplitude(iVoiceCount, 0.0f)
+    , m_vLevel(iVoiceCount, 0.0f)
+    , m_vAttackRate(iVoiceCount, 0.0f)
+    , m_vDecayRate(iVoiceCount, 0.0f)
+    , m_vSustain(iVoiceCount, 0.0f)
+    , m_vReleaseFrames(iVoiceCount, 0.0f)
+    , m_vReleaseRate(iVoiceCount, 0.0f)
+    , m_vNoiseState(iVoiceCount, 0)
+{
+    setEnvelope(0.01, 0.1, 0.7, 0.2);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Destroys a CSoundVoiceBank.
+*/
+CSoundVoiceBank::~CSoundVoiceBank()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the envelope of the notes started after this call. \br
+    \a dAttack, \a dDecay and \a dRelease are in seconds, \a dSustain is a level between 0 and 1.
+*/
+void CSoundVoiceBank::setEnvelope(double dAttack, double dDecay, double dSustain, double dRelease)
+{
+    QMutexLocker locker(&m_tMutex);
+
+    m_fAttackFrames = float(qMax(dAttack, 0.0) * m_iSampleRate);
+    m_fDecayFrames = float(qMax(dDecay, 0.0) * m_iSampleRate);
+    m_fSustain = float(qBound(0.0, dSustain, 1.0));
+    m_fReleaseFrames = float(qMax(dRelease, 0.0) * m_iSampleRate);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the gain applied to the mix of all voices to \a dGain.
+*/
+void CSoundVoiceBank::setMasterGain(double dGain)
+{
+    QMutexLocker locker(&m_tMutex);
+
+    m_fMasterGain = float(dGain);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the frequency of \a iVoice to \a dFrequency, in Hertz. \br
+    Frequencies are limited to half the sample rate.
+*/
+void CSoundVoiceBank::setFrequency(int iVoice, double dFrequency)
+{
+    QMutexLocker locker(&m_tMutex);
+
+    if (iVoice >= 0 && iVoice < m_vIncrement.count())
+    {
+        m_vIncrement[iVoice] = float(qBound(0.0, dFrequency / m_iSampleRate, 0.5));
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of voices.
+*/
+int CSoundVoiceBank::voiceCount() const
+{
+    return m_vStage.count();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of voices currently sounding, including released ones.
+*/
+int CSoundVoiceBank::activeVoiceCount() const
+{
+    QMutexLocker locker(&m_tMutex);
+
+    int iCount = 0;
+
+    for (int iStage : m_vStage)
+    {
+        if (iStage != sIdle)
+            iCount++;
+    }
+
+    return iCount;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the sample rate.
+*/
+int CSoundVoiceBank::sampleRate() const
+{
+    return m_iSampleRate;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Starts a note of waveform \a eWaveform, frequency \a dFrequency in Hertz and peak amplitude \a dAmplitude. \br
+    Uses an idle voice, or else steals the quietest voice, preferring released ones. \br
+    Returns the voice playing the note, or -1 if the bank has no voices.
+*/
+int CSoundVoiceBank::noteOn(EWaveform eWaveform, double dFrequency, double dAmplitude)
+{
+    QMutexLocker locker(&m_tMutex);
+
+    int iVoice = -1;
+    bool bReleased = false;
+    float fLevel = 0.0f;
+
+    for (int iIndex = 0; iIndex < m_vStage.count(); iIndex++)
+    {
+        if (m_vStage[iIndex] == sIdle)
+        {
+            iVoice = iIndex;
+            break;
+        }
+
+        bool bIndexReleased = m_vStage[iIndex] == sRelease;
+
+        if (iVoice == -1 || (bIndexReleased && !bReleased) || (bIndexReleased == bReleased && m_vLevel[iIndex] < fLevel))
+        {
+            iVoice = iIndex;
+            bReleased = bIndexReleased;
+            fLevel = m_vLevel[iIndex];
+        }
+    }
+
+    if (iVoice != -1)
+    {
+        // A stolen voice starts its attack from its current level to avoid a click
+        if (m_vStage[iVoice] == sIdle)
+        {
+            m_vPhase[iVoice] = 0.0f;
+            m_vLevel[iVoice] = 0.0f;
+        }
+
+        m_vWaveform[iVoice] = eWaveform;
+        m_vStage[iVoice] = sAttack;
+        m_vIncrement[iVoice] = float(qBound(0.0, dFrequency / m_iSampleRate, 0.5));
+        m_vAmplitude[iVoice] = float(dAmplitude);
+        m_vAttackRate[iVoice] = 1.0f / qMax(m_fAttackFrames, 1.0f);
+        m_vDecayRate[iVoice] = (1.0f - m_fSustain) / qMax(m_fDecayFrames, 1.0f);
+        m_vSustain[iVoice] = m_fSustain;
+        m_vReleaseFrames[iVoice] = m_fReleaseFrames;
+        m_vNoiseState[iVoice] = ++m_uNoteCount * 0x01000193u;
+    }
+
+    return iVoice;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Releases the note played by \a iVoice, which then fades out over the release time.
+*/
+void CSoundVoiceBank::noteOff(int iVoice)
+{
+    QMutexLocker locker(&m_tMutex);
+
+    if (iVoice >= 0 && iVoice < m_vStage.count() && m_vStage[iVoice] != sIdle)
+    {
+        m_vStage[iVoice] = sRelease;
+        m_vReleaseRate[iVoice] = m_vLevel[iVoice] / qMax(m_vReleaseFrames[iVoice], 1.0f);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Releases all notes.
+*/
+void CSoundVoiceBank::allNotesOff()
+{
+    for (int iVoice = 0; iVoice < voiceCount(); iVoice++)
+    {
+        noteOff(iVoice);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Renders \a iFrames samples of the mix to \a pOutput. \br
+    Samples are scaled by the master gain but not clipped.
+*/
+void CSoundVoiceBank::render(float* pOutput, int iFrames)
+{
+    QMutexLocker locker(&m_tMutex);
+
+    for (int iStart = 0; iStart < iFrames; iStart += BlockFrames)
+    {
+        renderBlock(pOutput + iStart, qMin(iFrames - iStart, int(BlockFrames)));
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Renders \a iFrames 16 bit samples of the mix to \a pOutput. \br
+    Samples are scaled by the master gain and clipped.
+*/
+void CSoundVoiceBank::render(qint16* pOutput, int iFrames)
+{
+    QMutexLocker locker(&m_tMutex);
+
+    for (int iStart = 0; iStart < iFrames; iStart += BlockFrames)
+    {
+        int iCount = qMin(iFrames - iStart, int(BlockFrames));
+        qint16* pBlock = pOutput + iStart;
+
+        renderBlock(m_fMix, iCount);
+
+        for (int iIndex = 0; iIndex < iCount; iIndex++)
+        {
+            pBlock[iIndex] = qint16(qBound(-1.0f, m_fMix[iIndex], 1.0f) * 32767.0f);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Mixes \a iFrames samples of all voices to \a pMix. \a iFrames is at most BlockFrames.
+*/
+void CSoundVoiceBank::renderBlock(float* pMix, int iFrames)
+{
+    for (int iIndex = 0; iIndex < iFrames; iIndex++)
+    {
+        pMix[iIndex] = 0.0f;
+    }
+
+    for (int iVoice = 0; iVoice < m_vStage.count(); iVoice++)
+    {
+        if (m_vStage[iVoice] == sIdle)
+            continue;
+
+        // The gain ramps linearly from the envelope level at the start of the block to the level at its end
+        float fGain = m_fMasterGain * m_vAmplitude[iVoice] * m_vLevel[iVoice];
+        advanceEnvelope(iVoice, iFrames);
+        float fStep = (m_fMasterGain * m_vAmplitude[iVoice] * m_vLevel[iVoice] - fGain) / float(iFrames);
+
+        float fPhase = m_vPhase[iVoice];
+        float fIncrement = m_vIncrement[iVoice];
+
+        switch (m_vWaveform[iVoice])
+        {
+            case wSine:
+            {
+                // Parabolic approximation of sin(2 pi p), error about 0.1 %
+                for (int iIndex = 0; iIndex < iFrames; iIndex++)
+                {
+                    float fPosition = fPhase + float(iIndex) * fIncrement;
+                    fPosition -= float(int(fPosition));
+                    float fT = 2.0f * fPosition - 1.0f;
+                    float fY = 4.0f * fT * (1.0f - fabsf(fT));
+                    fY *= 0.775f + 0.225f * fabsf(fY);
+                    pMix[iIndex] -= (fGain + float(iIndex) * fStep) * fY;
+                }
+                break;
+            }
+
+            case wSaw:
+            {
+                for (int iIndex = 0; iIndex < iFrames; iIndex++)
+                {
+                    float fPosition = fPhase + float(iIndex) * fIncrement;
+                    fPosition -= float(int(fPosition));
+                    pMix[iIndex] += (fGain + float(iIndex) * fStep) * (2.0f * fPosition - 1.0f);
+                }
+                break;
+            }
+
+            case wSquare:
+            {
+                for (int iIndex = 0; iIndex < iFrames; iIndex++)
+                {
+                    float fPosition = fPhase + float(iIndex) * fIncrement;
+                    fPosition -= float(int(fPosition));
+                    pMix[iIndex] += (fGain + float(iIndex) * fStep) * (fPosition < 0.5f ? 1.0f : -1.0f);
+                }
+                break;
+            }
+
+            case wNoise:
+            {
+                // Hash of the sample counter, so that samples do not depend on each other
+                quint32 uState = m_vNoiseState[iVoice];
+
+                for (int iIndex = 0; iIndex < iFrames; iIndex++)
+                {
+                    quint32 uValue = uState + quint32(iIndex) * 0x9E3779B9u;
+                    uValue ^= uValue >> 16;
+                    uValue *= 0x7FEB352Du;
+                    uValue ^= uValue >> 15;
+                    uValue *= 0x846CA68Bu;
+                    uValue ^= uValue >> 16;
+                    pMix[iIndex] += (fGain + float(iIndex) * fStep) * (float(qint32(uValue)) * (1.0f / 2147483648.0f));
+                }
+
+                m_vNoiseState[iVoice] = uState + quint32(iFrames) * 0x9E3779B9u;
+                break;
+            }
+        }
+
+        fPhase += float(iFrames) * fIncrement;
+        m_vPhase[iVoice] = fPhase - floorf(fPhase);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Advances the envelope of \a iVoice by \a iFrames samples.
+*/
+void CSoundVoiceBank::advanceEnvelope(int iVoice, int iFrames)
+{
+    float& fLevel = m_vLevel[iVoice];
+
+    switch (m_vStage[iVoice])
+    {
+        case sAttack:
+            fLevel += m_vAttackRate[iVoice] * float(iFrames);
+
+            if (fLevel >= 1.0f)
+            {
+                fLevel = 1.0f;
+                m_vStage[iVoice] = sDecay;
+            }
+            break;
+
+        case sDecay:
+            fLevel -= m_vDecayRate[iVoice] * float(iFrames);
+
+            if (fLevel <= m_vSustain[iVoice])
+            {
+                fLevel = m_vSustain[iVoice];
+                m_vStage[iVoice] = sSustain;
+            }
+            break;
+
+        case sRelease:
+            fLevel -= m_vReleaseRate[iVoice] * float(iFrames);
+
+            if (fLevel <= 0.0f)
+            {
+                fLevel = 0.0f;
+                m_vStage[iVoice] = sIdle;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,141 @@
+
+#pragma once
+
+#include "qtplus_global.h"
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+
+// Qt
+#include <QVector>
+#include <QMutex>
+
+//-------------------------------------------------------------------------------------------------
+
+//! Defines a bank of oscillator voices with ADSR envelopes, mixed to mono
+//! Voices are stored as structure of arrays and rendered in blocks so that the inner loops vectorize
+class QTPLUSSHARED_EXPORT CSoundVoiceBank
+{
+public:
+
+    //! Oscillator waveforms
+    enum EWaveform
+    {
+        wSine,
+        wSaw,
+        wSquare,
+        wNoise
+    };
+
+    //! Envelope stages
+    enum EStage
+    {
+        sIdle,
+        sAttack,
+        sDecay,
+        sSustain,
+        sRelease
+    };
+
+    // Constants
+
+    static const int BlockFrames = 64;
+
+    //-------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    //-------------------------------------------------------------------------------------------------
+
+    //! Constructor
+    CSoundVoiceBank(int iVoiceCount, int iSampleRate);
+
+    //! Destructor
+    virtual ~CSoundVoiceBank();
+
+    //-------------------------------------------------------------------------------------------------
+    // Setters
+    //-------------------------------------------------------------------------------------------------
+
+    //! Sets the envelope of the next notes, times are in seconds, dSustain is a level between 0 and 1
+    void setEnvelope(double dAttack, double dDecay, double dSustain, double dRelease);
+
+    //! Sets the gain applied to the mix
+    void setMasterGain(double dGain);
+
+    //! Sets the frequency of a voice, in Hertz
+    void setFrequency(int iVoice, double dFrequency);
+
+    //-------------------------------------------------------------------------------------------------
+    // Getters
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the number of voices
+    int voiceCount() const;
+
+    //! Returns the number of voices currently sounding
+    int activeVoiceCount() const;
+
+    //! Returns the sample rate
+    int sampleRate() const;
+
+    //-------------------------------------------------------------------------------------------------
+    // Control methods
+    //-------------------------------------------------------------------------------------------------
+
+    //! Starts a note, returns the voice playing it
+    int noteOn(EWaveform eWaveform, double dFrequency, double dAmplitude);
+
+    //! Releases the note played by iVoice
+    void noteOff(int iVoice);
+
+    //! Releases all notes
+    void allNotesOff();
+
+    //! Renders iFrames samples to pOutput, between -1 and 1
+    void render(float* pOutput, int iFrames);
+
+    //! Renders iFrames 16 bit samples to pOutput
+    void render(qint16* pOutput, int iFrames);
+
+    //-------------------------------------------------------------------------------------------------
+    // Protected control methods
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! Mixes iFrames samples, at most BlockFrames, of all voices to pMix
+    void renderBlock(float* pMix, int iFrames);
+
+    //! Advances the envelope of iVoice by iFrames samples
+    void advanceEnvelope(int iVoice, int iFrames);
+
+    //-------------------------------------------------------------------------------------------------
+    // Properties
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    mutable QMutex          m_tMutex;           // Protects the voices between the control and render threads
+    int                     m_iSampleRate;
+    float                   m_fMasterGain;
+    float                   m_fAttackFrames;    // Envelope of the next notes, in samples
+    float                   m_fDecayFrames;
+    float                   m_fSustain;
+    float                   m_fReleaseFrames;
+    quint32                 m_uNoteCount;       // Number of notes started, seeds the noise voices
+
+    // Voices
+    QVector<int>            m_vWaveform;
+    QVector<int>            m_vStage;
+    QVector<float>          m_vPhase;           // Oscillator phase, between 0 and 1
+    QVector<float>          m_vIncrement;       // Phase increment per sample
+    QVector<float>          m_vAmplitude;
+    QVector<float>          m_vLevel;           // Envelope level
+    QVector<float>          m_vAttackRate;      // Envelope level changes per sample
+    QVector<float>          m_vDecayRate;
+    QVector<float>          m_vSustain;
+    QVector<float>          m_vReleaseFrames;
+    QVector<float>          m_vReleaseRate;
+    QVector<quint32>        m_vNoiseState;      // Sample counter of the noise voices
+
+    float                   m_fMix[BlockFrames];
+};
@@ -9,69 +9,7 @@
 #endif
 
 ////    Static Data    ////
-static GEO saved_geo;
-static FLOAT_64 ellipse_a,          /* equatorial radius   */
-ellipse_a_sq,       /* radius squared      */
-ellipse_f,          /* flattening (a-b)/a  */
-ellipse_b,          /* polar semi-diameter */
-ellipse_b_sq,       /* polar semi-diameter squared */
-ellipse_a_sq_over_b,/* a*a/b                       */
-ellipse_e,          /* ellipticity 2f-f*f          */
-ellipse_c1,         /* (1-f)*(1-f)                 */
-
-topo_radius,        /* z value at origin of topocentric systemc */
-
-topo_sin_lat,       /* sin of angle between normal & equ plane  */
-topo_cos_lat,       /* cos of angle between normal & equ plane  */
-topo_sin_lon,       /* sin of angle between normal & PM plane   */
-topo_cos_lon,       /* cos of angle between normal & PM plane   */
-
-topo_sin_cos,       /* sin(lat) * cos(lon)                      */
-topo_sin_sin,       /* sin(lat) * sin(lon)                      */
-topo_cos_cos,       /* cos(lat) * cos(lon)                      */
-topo_cos_sin,       /* cos(lat) * sin(lon)                      */
-
-xo, yo, zo, /* origin of the database in geocentric coordinates */
-
-ellipse_a_b,           /* (a * b)         */
-ellipse_a_sq_sq,       /* (a * a * a * a) */
-ellipse_b_sq_sq,       /* (b * b * b * b) */
-two_over_ellipse_a,    /* (2/a)           */
-two_over_ellipse_b,    /* (2/b)           */
-two_over_ellipse_a_sq, /* 2/(a * a)       */
-two_over_ellipse_b_sq, /* 2/(b * b)       */
-
-saved_geod_sin_lat,       /* sin of angle latitude (phi)     */
-saved_geod_cos_lat,       /* cos of angle latitude (phi)     */
-saved_geod_sin_lon,       /* sin of angle longitude (lambda) */
-saved_geod_cos_lon,       /* cos of angle longitude (lambda) */
-saved_geod_sin_cos,       /* sin(lat) * cos(lon)             */
-saved_geod_sin_sin,       /* sin(lat) * sin(lon)             */
-saved_geod_cos_cos,       /* cos(lat) * cos(lon)             */
-saved_geod_cos_sin,       /* cos(lat) * sin(lon)             */
-
-False_North,
-False_East,
-Zone,
-Database_Origin_X,
-Database_Origin_Y,
-Lambda0,
-e_sq,     /* eccentricity squared */
-ep_sq,    /* e-prime squared      */
-ef,       /* e-factor             */
-e_sq_to_3,/* pow(e_sq,3.0) */
-ef_to_3,  /* pow(ef,3.0) */
-ef_to_4,  /* pow(ef,4.0) */
-
-poly1_a,
-poly2_a,
-poly3_a,
-poly4_a,
-poly5_a,
-poly1_b,
-poly2_b,
-poly3_b,
-poly4_b;
+static COORDCNV_CONTEXT default_context; /* state of the methods that do not take one */
 
 ////    Functions    ////
 
@@ -103,33 +41,34 @@ poly4_b;
 *                                                                          *
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
-void CoordCnv::InitializeEllipsoid( FLOAT_64 a, FLOAT_64 f)
+void CoordCnv::InitializeEllipsoid( COORDCNV_CONTEXT *context,
+                                    FLOAT_64 a, FLOAT_64 f)
 {
 
-    ellipse_a = a;
-    ellipse_a_sq = ellipse_a * ellipse_a;
-    ellipse_f = f;
-    ellipse_b = ellipse_a * (1.0 - ellipse_f);
+    context->ellipse_a = a;
+    context->ellipse_a_sq = context->ellipse_a * context->ellipse_a;
+    context->ellipse_f = f;
+    context->ellipse_b = context->ellipse_a * (1.0 - context->ellipse_f);
 
-    ellipse_b_sq = ellipse_b * ellipse_b;
-    ellipse_a_sq_over_b = ellipse_a_sq / ellipse_b;
+    context->ellipse_b_sq = context->ellipse_b * context->ellipse_b;
+    context->ellipse_a_sq_over_b = context->ellipse_a_sq / context->ellipse_b;
 
     /* changed by Huat Ng                         */
     /* ellipse_e = ellipse_f * (2.0 + ellipse_f); */
 
-    ellipse_e  = ellipse_f*(2.0 - ellipse_f);
-    ellipse_c1 = (1.0 - ellipse_f) * (1.0 - ellipse_f);
+    context->ellipse_e  = context->ellipse_f*(2.0 - context->ellipse_f);
+    context->ellipse_c1 = (1.0 - context->ellipse_f) * (1.0 - context->ellipse_f);
 
-    ellipse_a_b     = ellipse_a * ellipse_b;           /* (a * b)         */
+    context->ellipse_a_b     = context->ellipse_a * context->ellipse_b;           /* (a * b)         */
 
-    ellipse_a_sq_sq = ellipse_a_sq * ellipse_a_sq;     /* (a * a * a * a) */
-    ellipse_b_sq_sq = ellipse_b_sq * ellipse_b_sq;     /* (b * b * b * b) */
+    context->ellipse_a_sq_sq = context->ellipse_a_sq * context->ellipse_a_sq;     /* (a * a * a * a) */
+    context->ellipse_b_sq_sq = context->ellipse_b_sq * context->ellipse_b_sq;     /* (b * b * b * b) */
 
-    two_over_ellipse_a = 2.0 / ellipse_a;              /* (2/a)           */
-    two_over_ellipse_b = 2.0 / ellipse_b;              /* (2/b)           */
+    context->two_over_ellipse_a = 2.0 / context->ellipse_a;              /* (2/a)           */
+    context->two_over_ellipse_b = 2.0 / context->ellipse_b;              /* (2/b)           */
 
-    two_over_ellipse_a_sq = 2.0 / ellipse_a_sq;        /* 2/(a * a)       */
-    two_over_ellipse_b_sq = 2.0 / ellipse_b_sq;        /* 2/(b * b)       */
+    context->two_over_ellipse_a_sq = 2.0 / context->ellipse_a_sq;        /* 2/(a * a)       */
+    context->two_over_ellipse_b_sq = 2.0 / context->ellipse_b_sq;        /* 2/(b * b)       */
 
 } /* end of InitializeEllipsoid */
 
@@ -159,28 +98,29 @@ void CoordCnv::InitializeEllipsoid( FLOAT_64 a, FLOAT_64 f)
 *                                                                          *
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
-void CoordCnv::ComputeTopocentricConstants( FLOAT_64 x, FLOAT_64 y, FLOAT_64 z )
+void CoordCnv::ComputeTopocentricConstants( COORDCNV_CONTEXT *context,
+                                            FLOAT_64 x, FLOAT_64 y, FLOAT_64 z )
 {
     FLOAT_64        w, wsq;
-    static FLOAT_64 lat, lon, dummy;
+    FLOAT_64        lat, lon, dummy;
 
     wsq = x * x + y * y;
-    topo_radius = sqrt(wsq + z * z);
+    context->topo_radius = sqrt(wsq + z * z);
 
-    NIU_GeocentricToGeodetic(x, y, z, &lat, &lon, &dummy);
+    NIU_GeocentricToGeodetic(context, x, y, z, &lat, &lon, &dummy);
 
     w = sqrt(wsq);
 
-    topo_cos_lat = cos(lat);
-    topo_sin_lat = sqrt(1.0 - topo_cos_lat * topo_cos_lat);
+    context->topo_cos_lat = cos(lat);
+    context->topo_sin_lat = sqrt(1.0 - context->topo_cos_lat * context->topo_cos_lat);
 
-    topo_cos_lon = x / w;
-    topo_sin_lon = y / w;
+    context->topo_cos_lon = x / w;
+    context->topo_sin_lon = y / w;
 
-    topo_sin_sin = topo_sin_lat * topo_sin_lon;
-    topo_sin_cos = topo_sin_lat * topo_cos_lon;
-    topo_cos_sin = topo_cos_lat * topo_sin_lon;
-    topo_cos_cos = topo_cos_lat * topo_cos_lon;
+    context->topo_sin_sin = context->topo_sin_lat * context->topo_sin_lon;
+    context->topo_sin_cos = context->topo_sin_lat * context->topo_cos_lon;
+    context->topo_cos_sin = context->topo_cos_lat * context->topo_sin_lon;
+    context->topo_cos_cos = context->topo_cos_lat * context->topo_cos_lon;
 
 } /* end of ComputeTopocentricConstants */
 
@@ -206,23 +146,24 @@ void CoordCnv::ComputeTopocentricConstants( FLOAT_64 x, FLOAT_64 y, FLOAT_64 z )
 *                                                                          *
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
-void CoordCnv::NIU_InitializeTopocentric(FLOAT_64 x,FLOAT_64 y,FLOAT_64 z)
+void CoordCnv::NIU_InitializeTopocentric(COORDCNV_CONTEXT *context,
+                                         FLOAT_64 x,FLOAT_64 y,FLOAT_64 z)
 {
-    static FLOAT_64 gx, gy, gz;
+    FLOAT_64 gx, gy, gz;
 
-    InitializeEllipsoid(6378137.0,(1.0 / 298.257223563));
+    InitializeEllipsoid(context, 6378137.0,(1.0 / 298.257223563));
 
-    NIU_GeodeticToGeocentric(x, y, z, &gx, &gy, &gz);
+    NIU_GeodeticToGeocentric(context, x, y, z, &gx, &gy, &gz);
 
-    ComputeTopocentricConstants(gx, gy, gz);
+    ComputeTopocentricConstants(context, gx, gy, gz);
 
     /* save the origin of the database in       */
     /* geocentric coordinates to be used later. */
     /* added by Huat Ng                         */
 
-    xo = gx;
-    yo = gy;
-    zo = gz;
+    context->xo = gx;
+    context->yo = gy;
+    context->zo = gz;
 
 } /* end of NIU_InitializeTopocentric */
 
@@ -251,6 +192,7 @@ void CoordCnv::NIU_InitializeTopocentric(FLOAT_64 x,FLOAT_64 y,FLOAT_64 z)
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
 void CoordCnv::NIU_GeodeticToGeocentric(
+        COORDCNV_CONTEXT *context,
         FLOAT_64 lat,
         FLOAT_64 lon,
         FLOAT_64 height,
@@ -266,7 +208,7 @@ void CoordCnv::NIU_GeodeticToGeocentric(
     /* point on the ellipsoid                                    */
 
     sinlat = sin(lat);
-    sqrt_term = 1.0 - (ellipse_e * (sinlat * sinlat));
+    sqrt_term = 1.0 - (context->ellipse_e * (sinlat * sinlat));
 
     if (sqrt_term == 0.0)
     {
@@ -277,8 +219,8 @@ void CoordCnv::NIU_GeodeticToGeocentric(
         sqrt_term *= -1.0;
     }
 
-    temp1 = ellipse_a / sqrt(sqrt_term);
-    temp2 = temp1 * ellipse_c1;
+    temp1 = context->ellipse_a / sqrt(sqrt_term);
+    temp2 = temp1 * context->ellipse_c1;
 
     temp1 += height;
     temp2 += height;
@@ -329,6 +271,7 @@ void CoordCnv::NIU_GeodeticToGeocentric(
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
 void CoordCnv::NIU_GeocentricToGeodetic(
+        COORDCNV_CONTEXT *context,
         FLOAT_64 xp,
         FLOAT_64 yp,
         FLOAT_64 zp,
@@ -419,7 +362,7 @@ void CoordCnv::NIU_GeocentricToGeodetic(
         /*****************/
         /* Initial guess */
         /*****************/
-        temp_m = ellipse_a_sq*zp_sq + ellipse_b_sq*wp_sq;
+        temp_m = context->ellipse_a_sq*zp_sq + context->ellipse_b_sq*wp_sq;
 
         /*
       m = 0.5 * ((ellipse_a_b*temp_m*(sqrt(temp_m) - ellipse_a_b))/
@@ -427,14 +370,14 @@ void CoordCnv::NIU_GeocentricToGeodetic(
 */
 
         /* EA Simplify initial guess to avoid FLOAT_32ing overflow on the VAX */
-        m = 0.5 * (sqrt(temp_m)-ellipse_a_b);
+        m = 0.5 * (sqrt(temp_m)-context->ellipse_a_b);
 
         /*******************/
         /* calculate x,y,z */
         /*******************/
-        x = (1.0/(1.0+(two_over_ellipse_a_sq*m)))*xp; /* RAT, Save 1 divide */
-        y = (1.0/(1.0+(two_over_ellipse_a_sq*m)))*yp; /* RAT, Save 1 divide */
-        z = (1.0/(1.0+(two_over_ellipse_b_sq*m)))*zp; /* RAT, Save 1 divide */
+        x = (1.0/(1.0+(context->two_over_ellipse_a_sq*m)))*xp; /* RAT, Save 1 divide */
+        y = (1.0/(1.0+(context->two_over_ellipse_a_sq*m)))*yp; /* RAT, Save 1 divide */
+        z = (1.0/(1.0+(context->two_over_ellipse_b_sq*m)))*zp; /* RAT, Save 1 divide */
 
         /********************/
         /* calculate height */
@@ -448,8 +391,8 @@ void CoordCnv::NIU_GeocentricToGeodetic(
         {
             h_previous = h;
 
-            temp1 = ellipse_a + (two_over_ellipse_a*m); /* RAT, Save 1 divide */
-            temp2 = ellipse_b + (two_over_ellipse_b*m); /* RAT, Save 1 divide */
+            temp1 = context->ellipse_a + (context->two_over_ellipse_a*m); /* RAT, Save 1 divide */
+            temp2 = context->ellipse_b + (context->two_over_ellipse_b*m); /* RAT, Save 1 divide */
             temp1_sq = temp1*temp1;
             temp2_sq = temp2*temp2;
 
@@ -458,16 +401,16 @@ void CoordCnv::NIU_GeocentricToGeodetic(
             /***************************/
             f = wp_sq/temp1_sq + zp_sq/temp2_sq - 1.0;
 
-            f_prime = - 4.0*(wp_sq/(ellipse_a*temp1*temp1_sq) +
-                             zp_sq/(ellipse_b*temp2*temp2_sq)); /* RAT, Save 1 mult */
+            f_prime = - 4.0*(wp_sq/(context->ellipse_a*temp1*temp1_sq) +
+                             zp_sq/(context->ellipse_b*temp2*temp2_sq)); /* RAT, Save 1 mult */
 
             /******************************************/
             /* Newton-Raphson's convergence algorithm */
             /******************************************/
             m = m - f/f_prime;
 
-            w = (1.0/(1.0+(two_over_ellipse_a_sq*m)))*wp;  /* RAT, Save 1 divide */
-            z = (1.0/(1.0+(two_over_ellipse_b_sq*m)))*zp;  /* RAT,Save 1 divide */
+            w = (1.0/(1.0+(context->two_over_ellipse_a_sq*m)))*wp;  /* RAT, Save 1 divide */
+            z = (1.0/(1.0+(context->two_over_ellipse_b_sq*m)))*zp;  /* RAT,Save 1 divide */
 
             /**************************/
             /* recalculate the height */
@@ -500,10 +443,10 @@ void CoordCnv::NIU_GeocentricToGeodetic(
         if(special_case2 == FALSE)
         {
 
-            sqrt_term = fabs(1.0 - w_sq / ellipse_a_sq);
+            sqrt_term = fabs(1.0 - w_sq / context->ellipse_a_sq);
             if (sqrt_term < 0.0)
                 sqrt_term *= -1.0;
-            tanphi = (ellipse_a_sq_over_b *
+            tanphi = (context->ellipse_a_sq_over_b *
                       sqrt(sqrt_term)) / w;
 
             *lat = atan(tanphi);
@@ -537,6 +480,7 @@ void CoordCnv::NIU_GeocentricToGeodetic(
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
 void CoordCnv::NIU_TopocentricToGeocentric(
+        COORDCNV_CONTEXT *context,
         FLOAT_64 xt,
         FLOAT_64 yt,
         FLOAT_64 zt,
@@ -546,16 +490,16 @@ void CoordCnv::NIU_TopocentricToGeocentric(
         )
 {
 
-    *xg = xt * (-topo_sin_lon) -
-            yt * topo_sin_cos +
-            zt * topo_cos_cos + xo;
+    *xg = xt * (-context->topo_sin_lon) -
+            yt * context->topo_sin_cos +
+            zt * context->topo_cos_cos + context->xo;
 
-    *yg = xt * topo_cos_lon -
-            yt * topo_sin_sin +
-            zt * topo_cos_sin + yo;
+    *yg = xt * context->topo_cos_lon -
+            yt * context->topo_sin_sin +
+            zt * context->topo_cos_sin + context->yo;
 
-    *zg = yt * topo_cos_lat +
-            zt * topo_sin_lat + zo;
+    *zg = yt * context->topo_cos_lat +
+            zt * context->topo_sin_lat + context->zo;
 
 } /* end of NIU_TopocentricToGeocentric */
 
@@ -579,6 +523,7 @@ void CoordCnv::NIU_TopocentricToGeocentric(
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
 void CoordCnv::NIU_GeocentricToTopocentric(
+        COORDCNV_CONTEXT *context,
         FLOAT_64 xg,
         FLOAT_64 yg,
         FLOAT_64 zg,
@@ -587,16 +532,16 @@ void CoordCnv::NIU_GeocentricToTopocentric(
         FLOAT_64 *zt
         )
 {
-    *xt = (xg - xo) * (-topo_sin_lon) +
-            (yg - yo) * topo_cos_lon;
+    *xt = (xg - context->xo) * (-context->topo_sin_lon) +
+            (yg - context->yo) * context->topo_cos_lon;
 
-    *yt = (xg - xo) * (-topo_sin_cos) -
-            (yg - yo) * topo_sin_sin +
-            (zg - zo) * topo_cos_lat;
+    *yt = (xg - context->xo) * (-context->topo_sin_cos) -
+            (yg - context->yo) * context->topo_sin_sin +
+            (zg - context->zo) * context->topo_cos_lat;
 
-    *zt = (xg - xo) * topo_cos_cos +
-            (yg - yo) * topo_cos_sin +
-            (zg - zo) * topo_sin_lat;
+    *zt = (xg - context->xo) * context->topo_cos_cos +
+            (yg - context->yo) * context->topo_cos_sin +
+            (zg - context->zo) * context->topo_sin_lat;
 
 } /* end of NIU_GeocentricToTopocentric */
 
@@ -699,6 +644,7 @@ void CoordCnv::NIU_RadianToGeodetic( FLOAT_64 radian, FLOAT_64 *deg, FLOAT_64 *m
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
 void CoordCnv::NIU_TopovelocityToGeovelocity(
+        COORDCNV_CONTEXT *context,
         FLOAT_32  vxt,
         FLOAT_32  vyt,
         FLOAT_32  vzt,
@@ -708,16 +654,16 @@ void CoordCnv::NIU_TopovelocityToGeovelocity(
         )
 {
 
-    *vxg = (FLOAT_32) (vxt * (-topo_sin_lon) -
-                       vyt * topo_sin_cos +
-                       vzt * topo_cos_cos);
+    *vxg = (FLOAT_32) (vxt * (-context->topo_sin_lon) -
+                       vyt * context->topo_sin_cos +
+                       vzt * context->topo_cos_cos);
 
-    *vyg = (FLOAT_32) (vxt * topo_cos_lon -
-                       vyt * topo_sin_sin +
-                       vzt * topo_cos_sin);
+    *vyg = (FLOAT_32) (vxt * context->topo_cos_lon -
+                       vyt * context->topo_sin_sin +
+                       vzt * context->topo_cos_sin);
 
-    *vzg = (FLOAT_32) (vyt * topo_cos_lat +
-                       vzt * topo_sin_lat);
+    *vzg = (FLOAT_32) (vyt * context->topo_cos_lat +
+                       vzt * context->topo_sin_lat);
 
 } /* end of NIU_TopovelocityToGeovelocity */
 
@@ -737,6 +683,7 @@ void CoordCnv::NIU_TopovelocityToGeovelocity(
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
 void CoordCnv::NIU_GeovelocityToTopovelocity(
+        COORDCNV_CONTEXT *context,
         FLOAT_32 vxg,
         FLOAT_32 vyg,
         FLOAT_32 vzg,
@@ -745,16 +692,16 @@ void CoordCnv::NIU_GeovelocityToTopovelocity(
         FLOAT_32 *vzt
         )
 {
-    *vxt = (FLOAT_32) (vxg * (-topo_sin_lon) +
-                       vyg * topo_cos_lon);
+    *vxt = (FLOAT_32) (vxg * (-context->topo_sin_lon) +
+                       vyg * context->topo_cos_lon);
 
-    *vyt = (FLOAT_32) (vxg * (-topo_sin_cos) -
-                       vyg * topo_sin_sin +
-                       vzg * topo_cos_lat);
+    *vyt = (FLOAT_32) (vxg * (-context->topo_sin_cos) -
+                       vyg * context->topo_sin_sin +
+                       vzg * context->topo_cos_lat);
 
-    *vzt = (FLOAT_32) (vxg * topo_cos_cos +
-                       vyg * topo_cos_sin +
-                       vzg * topo_sin_lat);
+    *vzt = (FLOAT_32) (vxg * context->topo_cos_cos +
+                       vyg * context->topo_cos_sin +
+                       vzg * context->topo_sin_lat);
 
 } /* end of NIU_GeovelocityToTopovelocity */
 
@@ -783,6 +730,7 @@ void CoordCnv::NIU_GeovelocityToTopovelocity(
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
 void CoordCnv::NIU_TopoeulerToGeoeuler(
+        COORDCNV_CONTEXT *context,
         FLOAT_32 inRoll,  FLOAT_32 inPitch,  FLOAT_32 inYaw,
         FLOAT_32 *psi,    FLOAT_32 *theta,   FLOAT_32 *phi)
 {
@@ -823,7 +771,7 @@ void CoordCnv::NIU_TopoeulerToGeoeuler(
     /* */
     /* Calculate pitch for DIS */
     /* */
-    val = (-topo_cos_lat*cosInYaw*cosInPitch -  topo_sin_lat*sinInPitch);
+    val = (-context->topo_cos_lat*cosInYaw*cosInPitch -  context->topo_sin_lat*sinInPitch);
     pitch = asin(val);
 
     /* */
@@ -832,21 +780,21 @@ void CoordCnv::NIU_TopoeulerToGeoeuler(
     poly1 = sinInYaw*cosInPitch;
     poly2 = cosInYaw*cosInPitch;
 
-    A_sub_12 =  topo_cos_lon*poly1-topo_sin_sin*poly2+topo_cos_sin*sinInPitch;
-    A_sub_11 = -topo_sin_lon*poly1-topo_sin_cos*poly2+topo_cos_cos*sinInPitch;
+    A_sub_12 =  context->topo_cos_lon*poly1-context->topo_sin_sin*poly2+context->topo_cos_sin*sinInPitch;
+    A_sub_11 = -context->topo_sin_lon*poly1-context->topo_sin_cos*poly2+context->topo_cos_cos*sinInPitch;
 
     yaw = atan2(A_sub_12,A_sub_11);
 
     /* */
     /* Calculate roll for DIS */
     /* */
-    A_sub_23 = topo_cos_lat *
+    A_sub_23 = context->topo_cos_lat *
             (-sinInYaw*cosInRoll+cosInYaw*sinInPitch*sinInRoll) -
-            topo_sin_lat*cosInPitch*sinInRoll;
+            context->topo_sin_lat*cosInPitch*sinInRoll;
 
-    A_sub_33 = topo_cos_lat *
+    A_sub_33 = context->topo_cos_lat *
             ( sinInYaw*sinInRoll+cosInYaw*sinInPitch*cosInRoll) -
-            topo_sin_lat*cosInPitch*cosInRoll;
+            context->topo_sin_lat*cosInPitch*cosInRoll;
 
     roll = atan2(A_sub_23,A_sub_33);
 
@@ -884,6 +832,7 @@ void CoordCnv::NIU_TopoeulerToGeoeuler(
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
 void CoordCnv::NIU_GeoeulerToTopoeuler(
+        COORDCNV_CONTEXT *context,
         FLOAT_32 psi,      FLOAT_32 theta,     FLOAT_32 phi,
         FLOAT_32 *outRoll, FLOAT_32 *outPitch, FLOAT_32 *outYaw )
 {
@@ -931,9 +880,9 @@ void CoordCnv::NIU_GeoeulerToTopoeuler(
     /* Calculate pitch for the simulator */
     /* */
 
-    val = (topo_cos_cos * cosInPitch * cosInYaw   +
-           topo_cos_sin * cosInPitch * sinInYaw   -
-           topo_sin_lat * sinInPitch);
+    val = (context->topo_cos_cos * cosInPitch * cosInYaw   +
+           context->topo_cos_sin * cosInPitch * sinInYaw   -
+           context->topo_sin_lat * sinInPitch);
     pitch = asin(val);
 
 
@@ -943,26 +892,26 @@ void CoordCnv::NIU_GeoeulerToTopoeuler(
     poly1 = cosInPitch*cosInYaw;
     poly2 = cosInPitch*sinInYaw;
 
-    B_sub_11 = -topo_sin_lon*poly1+topo_cos_lon*poly2;
-    B_sub_12 = -topo_sin_cos*poly1-topo_sin_sin*poly2 - topo_cos_lat*sinInPitch;
+    B_sub_11 = -context->topo_sin_lon*poly1+context->topo_cos_lon*poly2;
+    B_sub_12 = -context->topo_sin_cos*poly1-context->topo_sin_sin*poly2 - context->topo_cos_lat*sinInPitch;
 
     yaw = atan2(B_sub_11,B_sub_12);
 
     /* */
     /* Calculate the roll for the simulator */
     /* */
-    B_sub_23 = topo_cos_cos *
+    B_sub_23 = context->topo_cos_cos *
             (-cosInRoll*sinInYaw+sinInRoll*sinInPitch*cosInYaw)     +
-            topo_cos_sin *
+            context->topo_cos_sin *
             ( cosInRoll*cosInYaw + sinInRoll*sinInPitch*sinInYaw)   +
-            topo_sin_lat *
+            context->topo_sin_lat *
             ( sinInRoll*cosInPitch);
 
-    B_sub_33 =  topo_cos_cos *
+    B_sub_33 =  context->topo_cos_cos *
             ( sinInRoll*sinInYaw + cosInRoll*sinInPitch*cosInYaw)   +
-            topo_cos_sin *
+            context->topo_cos_sin *
             (-sinInRoll*cosInYaw + cosInRoll*sinInPitch*sinInYaw)   +
-            topo_sin_lat *
+            context->topo_sin_lat *
             ( cosInRoll*cosInPitch);
 
     roll = atan2(-B_sub_23,-B_sub_33);
@@ -976,16 +925,16 @@ void CoordCnv::NIU_GeoeulerToTopoeuler(
 /******************************************************************************/
 /* RAT, Added to save values for optimized                                    */
 /******************************************************************************/
-void CoordCnv::SaveGeocentricSinCos( void )
+void CoordCnv::SaveGeocentricSinCos( COORDCNV_CONTEXT *context )
 {
-    saved_geod_sin_lat = sin(saved_geo.phi);
-    saved_geod_cos_lat = cos(saved_geo.phi);
-    saved_geod_sin_lon = sin(saved_geo.lambda);
-    saved_geod_cos_lon = cos(saved_geo.lambda);
-    saved_geod_sin_cos = saved_geod_sin_lat * saved_geod_cos_lon;
-    saved_geod_sin_sin = saved_geod_sin_lat * saved_geod_sin_lon;
-    saved_geod_cos_cos = saved_geod_cos_lat * saved_geod_cos_lon;
-    saved_geod_cos_sin = saved_geod_cos_lat * saved_geod_sin_lon;
+    context->saved_geod_sin_lat = sin(context->saved_geo.phi);
+    context->saved_geod_cos_lat = cos(context->saved_geo.phi);
+    context->saved_geod_sin_lon = sin(context->saved_geo.lambda);
+    context->saved_geod_cos_lon = cos(context->saved_geo.lambda);
+    context->saved_geod_sin_cos = context->saved_geod_sin_lat * context->saved_geod_cos_lon;
+    context->saved_geod_sin_sin = context->saved_geod_sin_lat * context->saved_geod_sin_lon;
+    context->saved_geod_cos_cos = context->saved_geod_cos_lat * context->saved_geod_cos_lon;
+    context->saved_geod_cos_sin = context->saved_geod_cos_lat * context->saved_geod_sin_lon;
 
 } /* end of SaveGeocentricSinCos */
 
@@ -1004,37 +953,37 @@ void CoordCnv::SaveGeocentricSinCos( void )
 *                                                                          *
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
-void CoordCnv::NIU_Initialize_WGS84()
+void CoordCnv::NIU_Initialize_WGS84( COORDCNV_CONTEXT *context )
 {
     FLOAT_64 f;  /* WGS84 flattening constant */
 
     f = 1.0 - SEMI_MINOR/SEMI_MAJOR;
 
-    e_sq  = f *  ( 2.0 - f );
-    ep_sq = e_sq / ( 1.0 - e_sq );
-    ef    = f / ( 2.0 - f );
+    context->e_sq  = f *  ( 2.0 - f );
+    context->ep_sq = context->e_sq / ( 1.0 - context->e_sq );
+    context->ef    = f / ( 2.0 - f );
 
-    e_sq_to_3 = e_sq * e_sq * e_sq;
-    ef_to_3   = ef * ef * ef;
-    ef_to_4   = ef_to_3 * ef;
+    context->e_sq_to_3 = context->e_sq * context->e_sq * context->e_sq;
+    context->ef_to_3   = context->ef * context->ef * context->ef;
+    context->ef_to_4   = context->ef_to_3 * context->ef;
 
     /********************************************************************/
     /* (RAT, 9/30/92) Added the following variables for optimization... */
     /********************************************************************/
-    poly1_a = 1.0 - e_sq / 4.0 - 3.0 * e_sq * e_sq
-            / 64.0 - 5.0 * e_sq_to_3 / 256.0;
+    context->poly1_a = 1.0 - context->e_sq / 4.0 - 3.0 * context->e_sq * context->e_sq
+            / 64.0 - 5.0 * context->e_sq_to_3 / 256.0;
 
-    poly2_a = 3.0 * ef / 2.0 - 27.0 * ef_to_3 / 32.0;
-    poly3_a = 21.0 * ef * ef / 16.0 - 55.0 * ef_to_4 / 32.0;
-    poly4_a = 151.0 * ef_to_3 / 96.0;
-    poly5_a = 1097.0 * ef_to_4 / 512.0;
+    context->poly2_a = 3.0 * context->ef / 2.0 - 27.0 * context->ef_to_3 / 32.0;
+    context->poly3_a = 21.0 * context->ef * context->ef / 16.0 - 55.0 * context->ef_to_4 / 32.0;
+    context->poly4_a = 151.0 * context->ef_to_3 / 96.0;
+    context->poly5_a = 1097.0 * context->ef_to_4 / 512.0;
 
-    poly1_b = 1.0 - (e_sq / 4.0) - (3.0 * e_sq * e_sq)
-            / 64.0 - 5.0 * e_sq_to_3 / 256.0;
+    context->poly1_b = 1.0 - (context->e_sq / 4.0) - (3.0 * context->e_sq * context->e_sq)
+            / 64.0 - 5.0 * context->e_sq_to_3 / 256.0;
 
-    poly2_b = 3.0*e_sq/8.0 + (3.0*e_sq*e_sq)/32.0 + 45.0*e_sq_to_3/1024.0;
-    poly3_b = 15.0*e_sq*e_sq/256.0 + 45.0*e_sq_to_3/1024.0;
-    poly4_b = 35.0*e_sq_to_3/3072.0;
+    context->poly2_b = 3.0*context->e_sq/8.0 + (3.0*context->e_sq*context->e_sq)/32.0 + 45.0*context->e_sq_to_3/1024.0;
+    context->poly3_b = 15.0*context->e_sq*context->e_sq/256.0 + 45.0*context->e_sq_to_3/1024.0;
+    context->poly4_b = 35.0*context->e_sq_to_3/3072.0;
 
 } /* end of NIU_Initialize_WGS84 */
 
@@ -1065,7 +1014,8 @@ void CoordCnv::NIU_Initialize_WGS84()
 *                                                                          *
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
-void CoordCnv::NIU_UTMToGeodetic( UTM *utm, GEO *geo )
+void CoordCnv::NIU_UTMToGeodetic( COORDCNV_CONTEXT *context,
+                                  UTM *utm, GEO *geo )
 {
     FLOAT_64 northing,   /* UTM Northing coordinate       */
             easting,    /* UTM Easting coordinate        */
@@ -1100,13 +1050,13 @@ void CoordCnv::NIU_UTMToGeodetic( UTM *utm, GEO *geo )
     /* Calculate false easting and northing.   Since Hunter_Liggett */
     /* is northern hemisphere, the northing will not change.        */
 
-    northing = utm->northing - False_North;
-    easting  = utm->easting  - False_East;
+    northing = utm->northing - context->False_North;
+    easting  = utm->easting  - context->False_East;
 
     /* Calculate longitude of the central meridian.  Hunter-Ligget  */
     /* is in zone 10.  lambda0 (in radians) = (zone*6-183)*2PI/360  */
 
-    lambda0 = Lambda0;
+    lambda0 = context->Lambda0;
 
     /* Calculate true distance along central meridian from equator  */
     /* to phi.  Scale on central meridian for UTM is 0.9996.        */
@@ -1119,9 +1069,9 @@ void CoordCnv::NIU_UTMToGeodetic( UTM *utm, GEO *geo )
     /* (RAT, 9/30/92) Changed mu and phi1 calc. to use poly#_a */
     /* instead of local variables poly#.                       */
     /***********************************************************/
-    mu = M/(SEMI_MAJOR*poly1_a);
-    phi1 = mu + poly2_a*sin(2.0*mu) + poly3_a*sin(4.0*mu) +
-            poly4_a*sin(6.0*mu) + poly5_a*sin(8.0*mu);
+    mu = M/(SEMI_MAJOR*context->poly1_a);
+    phi1 = mu + context->poly2_a*sin(2.0*mu) + context->poly3_a*sin(4.0*mu) +
+            context->poly4_a*sin(6.0*mu) + context->poly5_a*sin(8.0*mu);
 
     /* Calculate the trigonometric functions for phi1 */
 
@@ -1133,9 +1083,9 @@ void CoordCnv::NIU_UTMToGeodetic( UTM *utm, GEO *geo )
     /* NOTE: the constant names have been kept the same as the */
     /* referenced text as stated above.                        */
 
-    C1    = ep_sq*cos_phi1*cos_phi1;
+    C1    = context->ep_sq*cos_phi1*cos_phi1;
     T1    = tan_phi1*tan_phi1;
-    poly1 = e_sq*sin_phi1*sin_phi1;
+    poly1 = context->e_sq*sin_phi1*sin_phi1;
 
     sqrt_term = 1.0 - poly1;
 
@@ -1151,7 +1101,7 @@ void CoordCnv::NIU_UTMToGeodetic( UTM *utm, GEO *geo )
     sqrt_1_minus_poly1 = sqrt(sqrt_term);
 
     N1    = SEMI_MAJOR / sqrt_1_minus_poly1;
-    R1    = ( SEMI_MAJOR * ( 1.0 - e_sq ) ) /
+    R1    = ( SEMI_MAJOR * ( 1.0 - context->e_sq ) ) /
             ( ( 1.0 - poly1 ) * sqrt_1_minus_poly1 );
     D     = easting /( N1 * CENTRAL_SCALE );
 
@@ -1169,8 +1119,8 @@ void CoordCnv::NIU_UTMToGeodetic( UTM *utm, GEO *geo )
     /* calculate the latitude (phi) */
 
     poly1 = D_sq/2.0;
-    poly2 = 5.0 + 3.0*T1 + 10.0*C1 - 4.0*C1_sq - 9.0*ep_sq;
-    poly3 = 61.0 + 90.0*T1 + 298.0*C1 + 45.0*T1_sq - 252.0*ep_sq - 3.0*C1_sq;
+    poly2 = 5.0 + 3.0*T1 + 10.0*C1 - 4.0*C1_sq - 9.0*context->ep_sq;
+    poly3 = 61.0 + 90.0*T1 + 298.0*C1 + 45.0*T1_sq - 252.0*context->ep_sq - 3.0*C1_sq;
 
     geo->phi = phi1 - ( N1 * tan_phi1 / R1 )
             * ( poly1-poly2 * D_four / 24.0 + poly3 * D_six / 720.0 );
@@ -1178,7 +1128,7 @@ void CoordCnv::NIU_UTMToGeodetic( UTM *utm, GEO *geo )
     /* calculate the longitude (lambda) */
 
     poly1 = 1.0 + 2.0*T1 + C1;
-    poly2 = 5.0 - 2.0*C1 + 28.0*T1 - 3.0*C1_sq + 8.0*ep_sq + 24.0*T1_sq;
+    poly2 = 5.0 - 2.0*C1 + 28.0*T1 - 3.0*C1_sq + 8.0*context->ep_sq + 24.0*T1_sq;
 
     geo->lambda = lambda0 +(D - poly1*D_cube/6.0 + poly2*D_five/120.0)/cos_phi1;
 } /* end of NIU_UTMToGeodetic */
@@ -1210,7 +1160,8 @@ void CoordCnv::NIU_UTMToGeodetic( UTM *utm, GEO *geo )
 *                                                                          *
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
-void CoordCnv::NIU_GeodeticToUTM( GEO *geo, UTM *utm )
+void CoordCnv::NIU_GeodeticToUTM( COORDCNV_CONTEXT *context,
+                                  GEO *geo, UTM *utm )
 {
     FLOAT_64 lambda0,   /* longitude of central meridian          */
             cos_phi,   /* cosine of phi                          */
@@ -1235,7 +1186,7 @@ void CoordCnv::NIU_GeodeticToUTM( GEO *geo, UTM *utm )
     /* Hunter-Liggett database lies.  lambda0 is in radians.     */
     /* lambda0 = (zone*6 - 183)*(2PI/360)                        */
 
-    lambda0 = Lambda0;
+    lambda0 = context->Lambda0;
 
     /* calculate the trigonometry functions of phi and lambda    */
 
@@ -1265,7 +1216,7 @@ void CoordCnv::NIU_GeodeticToUTM( GEO *geo, UTM *utm )
     /* note: the constants names have been kept the same as the */
     /* referenced text as stated above.                         */
 
-    sqrt_term = 1.0 - e_sq*sin_phi*sin_phi;
+    sqrt_term = 1.0 - context->e_sq*sin_phi*sin_phi;
 
     if (sqrt_term == 0.0)
     {
@@ -1278,16 +1229,16 @@ void CoordCnv::NIU_GeodeticToUTM( GEO *geo, UTM *utm )
 
     N = SEMI_MAJOR/sqrt(sqrt_term);
     T = tan_phi*tan_phi;
-    C = ep_sq*cos_phi*cos_phi;
+    C = context->ep_sq*cos_phi*cos_phi;
     A = (geo->lambda - lambda0)*cos_phi;
 
     /******************************************************/
     /* (RAT, 9/30/92) replaced poly# with globals poly#_b */
     /******************************************************/
-    M = SEMI_MAJOR * ( poly1_b * geo->phi -
-                       poly2_b * sin( 2.0 * geo->phi ) +
-                       poly3_b * sin( 4.0 * geo->phi ) -
-                       poly4_b * sin( 6.0 * geo->phi ) );
+    M = SEMI_MAJOR * ( context->poly1_b * geo->phi -
+                       context->poly2_b * sin( 2.0 * geo->phi ) +
+                       context->poly3_b * sin( 4.0 * geo->phi ) -
+                       context->poly4_b * sin( 6.0 * geo->phi ) );
 
     /* calculate the powers of T, C, and A from above */
 
@@ -1302,21 +1253,21 @@ void CoordCnv::NIU_GeodeticToUTM( GEO *geo, UTM *utm )
     /* calculate easting (x) */
 
     poly1  =  1.0 - T + C;
-    poly2  =  5.0 - 18.0*T + T_sq + 72.0*C - 58.0*ep_sq;
+    poly2  =  5.0 - 18.0*T + T_sq + 72.0*C - 58.0*context->ep_sq;
     utm->easting = CENTRAL_SCALE*N*(A + poly1*A_cube/6.0 + poly2*A_five/120.0);
 
     /* calculate the northing (y) */
 
     poly1  =  5.0 - T + 9.0*C + 4.0*C_sq;
-    poly2  =  61.0 - 58.0*T + T_sq + 600.0*C - 330.0*ep_sq;
+    poly2  =  61.0 - 58.0*T + T_sq + 600.0*C - 330.0*context->ep_sq;
     utm->northing = CENTRAL_SCALE * ( M + N * tan_phi * ( A_sq / 2.0 +
                                                           poly1 * A_four / 24.0
                                                           + poly2 * A_six  / 720.0));
 
     /* add false northing and easting */
 
-    utm->northing += False_North;
-    utm->easting  += False_East;
+    utm->northing += context->False_North;
+    utm->easting  += context->False_East;
 
 } /* end of NIU_GeodeticToUTM */
 
@@ -1341,7 +1292,8 @@ void CoordCnv::NIU_GeodeticToUTM( GEO *geo, UTM *utm )
 *                                                                          *
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
-void CoordCnv::NIU_UTMToGeocentric( FLOAT_64 xu,  FLOAT_64 yu,  FLOAT_64 zu,
+void CoordCnv::NIU_UTMToGeocentric( COORDCNV_CONTEXT *context,
+                                    FLOAT_64 xu,  FLOAT_64 yu,  FLOAT_64 zu,
                                     FLOAT_64 *xg, FLOAT_64 *yg, FLOAT_64 *zg )
 {
     UTM     database_utm;
@@ -1352,11 +1304,11 @@ void CoordCnv::NIU_UTMToGeocentric( FLOAT_64 xu,  FLOAT_64 yu,  FLOAT_64 zu,
 
     /* calls NIU_UTMToGeodetic to perform utm to geodetic conversion */
 
-    NIU_UTMToGeodetic(&database_utm, &saved_geo);
+    NIU_UTMToGeodetic(context, &database_utm, &context->saved_geo);
 
     /* converts geodetic to geocentric */
 
-    NIU_GeodeticToGeocentric(saved_geo.phi, saved_geo.lambda, zu,
+    NIU_GeodeticToGeocentric(context, context->saved_geo.phi, context->saved_geo.lambda, zu,
                              &X, &Y, &Z);
 
     /* assigns the geocentric coordinates */
@@ -1368,7 +1320,7 @@ void CoordCnv::NIU_UTMToGeocentric( FLOAT_64 xu,  FLOAT_64 yu,  FLOAT_64 zu,
     /*************************************************************/
     /* (RAT, 10/7/92) Calculate sin and cos for optimizing...... */
     /*************************************************************/
-    SaveGeocentricSinCos();
+    SaveGeocentricSinCos(context);
 
 } /* end of NIU_UTMToGeocentric */
 
@@ -1391,13 +1343,14 @@ void CoordCnv::NIU_UTMToGeocentric( FLOAT_64 xu,  FLOAT_64 yu,  FLOAT_64 zu,
 *                                                                          *
 *  10-Sept 1996 Documented                                                 *
 ***************************************************************************/
-void CoordCnv::NIU_UTMLocalToUTM( FLOAT_64  xl, FLOAT_64  yl, FLOAT_64  zl,
+void CoordCnv::NIU_UTMLocalToUTM( COORDCNV_CONTEXT *context,
+                                  FLOAT_64  xl, FLOAT_64  yl, FLOAT_64  zl,
                                   FLOAT_64 *xu, FLOAT_64 *yu, FLOAT_64 *zu )
 {
     /* add the utm offset to the x and y coordinates */
 
-    *xu = Database_Origin_X + xl;
-    *yu = Database_Origin_Y + yl;
+    *xu = context->Database_Origin_X + xl;
+    *yu = context->Database_Origin_Y + yl;
     *zu = zl;
 
 } /* end of NIU_UTMLocalToUTM */
@@ -1421,13 +1374,14 @@ void CoordCnv::NIU_UTMLocalToUTM( FLOAT_64  xl, FLOAT_64  yl, FLOAT_64  zl,
 *                                                                          *
 *  10-Sept 1996 Documented                                                 *
 ***************************************************************************/
-void CoordCnv::NIU_UTMToUTMLocal( FLOAT_64  xu, FLOAT_64  yu, FLOAT_64  zu,
+void CoordCnv::NIU_UTMToUTMLocal( COORDCNV_CONTEXT *context,
+                                  FLOAT_64  xu, FLOAT_64  yu, FLOAT_64  zu,
                                   FLOAT_64 *xl, FLOAT_64 *yl, FLOAT_64 *zl )
 {
     /* add the utm offset to the x and y coordinates */
 
-    *xl = xu - Database_Origin_X;
-    *yl = yu - Database_Origin_Y;
+    *xl = xu - context->Database_Origin_X;
+    *yl = yu - context->Database_Origin_Y;
     *zl = zu;
 
 } /* end of NIU_UTMToUTMLocal */
@@ -1455,17 +1409,18 @@ void CoordCnv::NIU_UTMToUTMLocal( FLOAT_64  xu, FLOAT_64  yu, FLOAT_64  zu,
 *                                                                          *
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
-void CoordCnv::NIU_UTMLocalToGeocentric( FLOAT_64  xu, FLOAT_64  yu, FLOAT_64  zu,
+void CoordCnv::NIU_UTMLocalToGeocentric( COORDCNV_CONTEXT *context,
+                                         FLOAT_64  xu, FLOAT_64  yu, FLOAT_64  zu,
                                          FLOAT_64 *xg, FLOAT_64 *yg, FLOAT_64 *zg )
 {
     FLOAT_64  adj_xu, adj_yu;
 
     /* add the utm offset to the x and y coordinates */
 
-    adj_xu = Database_Origin_X + xu;
-    adj_yu = Database_Origin_Y + yu;
+    adj_xu = context->Database_Origin_X + xu;
+    adj_yu = context->Database_Origin_Y + yu;
 
-    NIU_UTMToGeocentric( adj_xu, adj_yu, zu,
+    NIU_UTMToGeocentric( context, adj_xu, adj_yu, zu,
                          xg,     yg, zg );
 
 } /* end of NIU_UTMLocalToGeocentric */
@@ -1492,7 +1447,8 @@ void CoordCnv::NIU_UTMLocalToGeocentric( FLOAT_64  xu, FLOAT_64  yu, FLOAT_64  z
 *                                                                          *
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
-void CoordCnv::NIU_GeocentricToUTM( FLOAT_64 xg,  FLOAT_64 yg,  FLOAT_64 zg,
+void CoordCnv::NIU_GeocentricToUTM( COORDCNV_CONTEXT *context,
+                                    FLOAT_64 xg,  FLOAT_64 yg,  FLOAT_64 zg,
                                     FLOAT_64 *xu, FLOAT_64 *yu, FLOAT_64 *zu )
 {
 
@@ -1501,21 +1457,21 @@ void CoordCnv::NIU_GeocentricToUTM( FLOAT_64 xg,  FLOAT_64 yg,  FLOAT_64 zg,
 
     /* Converts geocentric to geodetic */
 
-    NIU_GeocentricToGeodetic(xg, yg, zg, &latitude, &longitude, &height);
+    NIU_GeocentricToGeodetic(context, xg, yg, zg, &latitude, &longitude, &height);
 
     /* Assigns the variables */
 
-    saved_geo.phi    = latitude;
-    saved_geo.lambda = longitude;
+    context->saved_geo.phi    = latitude;
+    context->saved_geo.lambda = longitude;
 
     /*************************************************************/
     /* (RAT, 10/7/92) Calculate sin and cos for optimizing...... */
     /*************************************************************/
-    SaveGeocentricSinCos();
+    SaveGeocentricSinCos(context);
 
     /* converts geodetic to utm */
 
-    NIU_GeodeticToUTM(&saved_geo, &database_utm);
+    NIU_GeodeticToUTM(context, &context->saved_geo, &database_utm);
 
     /* Compensate for the UTM origin */
 
@@ -1548,14 +1504,15 @@ void CoordCnv::NIU_GeocentricToUTM( FLOAT_64 xg,  FLOAT_64 yg,  FLOAT_64 zg,
 *                                                                          *
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
-void CoordCnv::NIU_GeocentricToUTMLocal( FLOAT_64  xg, FLOAT_64  yg, FLOAT_64  zg,
+void CoordCnv::NIU_GeocentricToUTMLocal( COORDCNV_CONTEXT *context,
+                                         FLOAT_64  xg, FLOAT_64  yg, FLOAT_64  zg,
                                          FLOAT_64 *xu, FLOAT_64 *yu, FLOAT_64 *zu )
 {
 
-    NIU_GeocentricToUTM( xg, yg, zg, xu, yu, zu );
+    NIU_GeocentricToUTM( context, xg, yg, zg, xu, yu, zu );
 
-    *xu -= Database_Origin_X;
-    *yu -= Database_Origin_Y;
+    *xu -= context->Database_Origin_X;
+    *yu -= context->Database_Origin_Y;
 
 } /* end of NIU_GeocentricToUTM */
 
@@ -1574,17 +1531,18 @@ void CoordCnv::NIU_GeocentricToUTMLocal( FLOAT_64  xg, FLOAT_64  yg, FLOAT_64  z
 *                                                                          *
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
-void CoordCnv::CalcFalseNorthEast ( FLOAT_64 latitude_radians )
+void CoordCnv::CalcFalseNorthEast ( COORDCNV_CONTEXT *context,
+                                    FLOAT_64 latitude_radians )
 {
     if (latitude_radians  >= 0.0)
     {
-        False_North = 0.0;
-        False_East  = 500000.0;
+        context->False_North = 0.0;
+        context->False_East  = 500000.0;
     }
     else
     {
-        False_North = 10000000.0;
-        False_East  =   500000.0;
+        context->False_North = 10000000.0;
+        context->False_East  =   500000.0;
     }
 }
 
@@ -1636,16 +1594,17 @@ FLOAT_64 CoordCnv::CalcZone(FLOAT_64 longitude_radians)
 *                                                                          *
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
-void CoordCnv::CalcLambda0(FLOAT_64 zone)
+void CoordCnv::CalcLambda0(COORDCNV_CONTEXT *context,
+                           FLOAT_64 zone)
 {
-    Lambda0 = 0;
+    context->Lambda0 = 0;
     if ( (zone < 31) && ( zone > 0) )      /* 1-30 */
     {
-        Lambda0 = (zone * 6.0 - 183.0) * (M_PI/180.0);
+        context->Lambda0 = (zone * 6.0 - 183.0) * (M_PI/180.0);
     }
     else if ( (zone > 30) && (zone < 61) ) /* 31-60 */
     {
-        Lambda0 = ((zone - 31.0) * 6.0 + 3.0) * (M_PI/180.0);
+        context->Lambda0 = ((zone - 31.0) * 6.0 + 3.0) * (M_PI/180.0);
     }
 
 }
@@ -1668,6 +1627,7 @@ void CoordCnv::CalcLambda0(FLOAT_64 zone)
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
 void CoordCnv::CalcDatabaseOrigin(
+        COORDCNV_CONTEXT *context,
         FLOAT_64 latitude,
         FLOAT_64 longitude,
         FLOAT_64 height)
@@ -1676,20 +1636,20 @@ void CoordCnv::CalcDatabaseOrigin(
     FLOAT_64 utmx, utmy, utmz; /* UTM */
 
     /* Zero Origin -- ie. used in NIU_GeocentricToUTM */
-    Database_Origin_X = 0.0;
-    Database_Origin_Y = 0.0;
+    context->Database_Origin_X = 0.0;
+    context->Database_Origin_Y = 0.0;
 
-    NIU_GeodeticToGeocentric(latitude, longitude, height, &gcx, &gcy, &gcz);
+    NIU_GeodeticToGeocentric(context, latitude, longitude, height, &gcx, &gcy, &gcz);
 
-    NIU_GeocentricToUTM(gcx, gcy, gcz, &utmx, &utmy, &utmz);
+    NIU_GeocentricToUTM(context, gcx, gcy, gcz, &utmx, &utmy, &utmz);
 
-    Database_Origin_X = utmx;
-    Database_Origin_Y = utmy;
+    context->Database_Origin_X = utmx;
+    context->Database_Origin_Y = utmy;
 
 #ifdef FNIU_DEBUG
 
-    fprintf(stderr, "Debug Database_Origin_X %lf \n", Database_Origin_X );
-    fprintf(stderr, "Debug Database_Origin_Y %lf \n", Database_Origin_Y );
+    fprintf(stderr, "Debug Database_Origin_X %lf \n", context->Database_Origin_X );
+    fprintf(stderr, "Debug Database_Origin_Y %lf \n", context->Database_Origin_Y );
 
 #endif
 
@@ -1711,19 +1671,20 @@ void CoordCnv::CalcDatabaseOrigin(
 *                                                                          *
 *  29-Nov 1995 Documented                                                  *
 ***************************************************************************/
-void CoordCnv::NIU_InitializeCoordinates( FLOAT_64 lat_rad,
+void CoordCnv::NIU_InitializeCoordinates( COORDCNV_CONTEXT *context,
+                                          FLOAT_64 lat_rad,
                                           FLOAT_64 lon_rad,
                                           FLOAT_64 hgt_mtr)
 {
-    NIU_InitializeTopocentric(lat_rad, lon_rad, hgt_mtr);
-    NIU_Initialize_WGS84();
+    NIU_InitializeTopocentric(context, lat_rad, lon_rad, hgt_mtr);
+    NIU_Initialize_WGS84(context);
 
-    CalcFalseNorthEast(lat_rad);
+    CalcFalseNorthEast(context, lat_rad);
 
-    Zone = CalcZone(lon_rad);
+    context->Zone = CalcZone(lon_rad);
 
-    CalcLambda0(Zone);
-    CalcDatabaseOrigin(lat_rad,lon_rad,hgt_mtr);
+    CalcLambda0(context, context->Zone);
+    CalcDatabaseOrigin(context, lat_rad,lon_rad,hgt_mtr);
 }
 
 /***************************************************************************
@@ -1744,22 +1705,23 @@ void CoordCnv::NIU_InitializeCoordinates( FLOAT_64 lat_rad,
 ***************************************************************************/
 void CoordCnv::NIU_UTMVelocityToGeoVelocity
 (
+        COORDCNV_CONTEXT *context,
         FLOAT_32 srcx,   FLOAT_32 srcy,   FLOAT_32 srcz,
         FLOAT_32 *destx, FLOAT_32 *desty, FLOAT_32 *destz
         )
 {
     /* apply the rotation matrix to the velocity vector */
 
-    *destx = (FLOAT_32) (srcx * (-saved_geod_sin_lon) -
-                         srcy * saved_geod_sin_cos +
-                         srcz * saved_geod_cos_cos);
+    *destx = (FLOAT_32) (srcx * (-context->saved_geod_sin_lon) -
+                         srcy * context->saved_geod_sin_cos +
+                         srcz * context->saved_geod_cos_cos);
 
-    *desty = (FLOAT_32) (srcx * saved_geod_cos_lon -
-                         srcy * saved_geod_sin_sin +
-                         srcz * saved_geod_cos_sin);
+    *desty = (FLOAT_32) (srcx * context->saved_geod_cos_lon -
+                         srcy * context->saved_geod_sin_sin +
+                         srcz * context->saved_geod_cos_sin);
 
-    *destz = (FLOAT_32) (srcy * saved_geod_cos_lat +
-                         srcz * saved_geod_sin_lat);
+    *destz = (FLOAT_32) (srcy * context->saved_geod_cos_lat +
+                         srcz * context->saved_geod_sin_lat);
 }
 
 /***************************************************************************
@@ -1780,21 +1742,185 @@ void CoordCnv::NIU_UTMVelocityToGeoVelocity
 ***************************************************************************/
 void CoordCnv::NIU_GeoVelocityToUTMVelocity
 (
+        COORDCNV_CONTEXT *context,
         FLOAT_32 srcx,   FLOAT_32 srcy,   FLOAT_32 srcz,
         FLOAT_32 *destx, FLOAT_32 *desty, FLOAT_32 *destz
         )
 {
     /* multiplying the velocity vector in DIS with the rotation matrix */
 
-    *destx = (FLOAT_32) (srcx * (-saved_geod_sin_lon) +
-                         srcy * saved_geod_cos_lon);
+    *destx = (FLOAT_32) (srcx * (-context->saved_geod_sin_lon) +
+                         srcy * context->saved_geod_cos_lon);
+
+    *desty = (FLOAT_32) (srcx * (-context->saved_geod_sin_cos) -
+                         srcy * context->saved_geod_sin_sin +
+                         srcz * context->saved_geod_cos_lat);
 
-    *desty = (FLOAT_32) (srcx * (-saved_geod_sin_cos) -
-                         srcy * saved_geod_sin_sin +
-                         srcz * saved_geod_cos_lat);
+    *destz = (FLOAT_32) (srcx * context->saved_geod_cos_cos +
+                         srcy * context->saved_geod_cos_sin +
+                         srcz * context->saved_geod_sin_lat);
+}
+
+/***************************************************************************
+*  Methods using the default context                                       *
+*                                                                          *
+*  Description :  The methods below keep the interface that does not take  *
+*                 a context. They share one default context, so they are   *
+*                 not re-entrant.                                          *
+***************************************************************************/
+void CoordCnv::NIU_GeodeticToGeocentric(
+        FLOAT_64 lat,
+        FLOAT_64 lon,
+        FLOAT_64 height,
+        FLOAT_64 *x,
+        FLOAT_64 *y,
+        FLOAT_64 *z
+        )
+{
+    NIU_GeodeticToGeocentric(&default_context, lat, lon, height, x, y, z);
+}
 
-    *destz = (FLOAT_32) (srcx * saved_geod_cos_cos +
-                         srcy * saved_geod_cos_sin +
-                         srcz * saved_geod_sin_lat);
+void CoordCnv::NIU_GeocentricToGeodetic(
+        FLOAT_64 xp,
+        FLOAT_64 yp,
+        FLOAT_64 zp,
+        FLOAT_64 *lat,
+        FLOAT_64 *lon,
+        FLOAT_64 *height
+        )
+{
+    NIU_GeocentricToGeodetic(&default_context, xp, yp, zp, lat, lon, height);
 }
 
+void CoordCnv::NIU_TopocentricToGeocentric(
+        FLOAT_64 xt,
+        FLOAT_64 yt,
+        FLOAT_64 zt,
+        FLOAT_64 *xg,
+        FLOAT_64 *yg,
+        FLOAT_64 *zg
+        )
+{
+    NIU_TopocentricToGeocentric(&default_context, xt, yt, zt, xg, yg, zg);
+}
+
+void CoordCnv::NIU_GeocentricToTopocentric(
+        FLOAT_64 xg,
+        FLOAT_64 yg,
+        FLOAT_64 zg,
+        FLOAT_64 *xt,
+        FLOAT_64 *yt,
+        FLOAT_64 *zt
+        )
+{
+    NIU_GeocentricToTopocentric(&default_context, xg, yg, zg, xt, yt, zt);
+}
+
+void CoordCnv::NIU_TopovelocityToGeovelocity(
+        FLOAT_32  vxt,
+        FLOAT_32  vyt,
+        FLOAT_32  vzt,
+        FLOAT_32 *vxg,
+        FLOAT_32 *vyg,
+        FLOAT_32 *vzg
+        )
+{
+    NIU_TopovelocityToGeovelocity(&default_context, vxt, vyt, vzt, vxg, vyg, vzg);
+}
+
+void CoordCnv::NIU_GeovelocityToTopovelocity(
+        FLOAT_32 vxg,
+        FLOAT_32 vyg,
+        FLOAT_32 vzg,
+        FLOAT_32 *vxt,
+        FLOAT_32 *vyt,
+        FLOAT_32 *vzt
+        )
+{
+    NIU_GeovelocityToTopovelocity(&default_context, vxg, vyg, vzg, vxt, vyt, vzt);
+}
+
+void CoordCnv::NIU_TopoeulerToGeoeuler(
+        FLOAT_32 inRoll,  FLOAT_32 inPitch,  FLOAT_32 inYaw,
+        FLOAT_32 *psi,    FLOAT_32 *theta,   FLOAT_32 *phi)
+{
+    NIU_TopoeulerToGeoeuler(&default_context, inRoll, inPitch, inYaw, psi, theta, phi);
+}
+
+void CoordCnv::NIU_GeoeulerToTopoeuler(
+        FLOAT_32 psi,      FLOAT_32 theta,     FLOAT_32 phi,
+        FLOAT_32 *outRoll, FLOAT_32 *outPitch, FLOAT_32 *outYaw )
+{
+    NIU_GeoeulerToTopoeuler(&default_context, psi, theta, phi, outRoll, outPitch, outYaw);
+}
+
+void CoordCnv::NIU_UTMToGeodetic( UTM *utm, GEO *geo )
+{
+    NIU_UTMToGeodetic(&default_context, utm, geo);
+}
+
+void CoordCnv::NIU_GeodeticToUTM( GEO *geo, UTM *utm )
+{
+    NIU_GeodeticToUTM(&default_context, geo, utm);
+}
+
+void CoordCnv::NIU_UTMToGeocentric( FLOAT_64 xu,  FLOAT_64 yu,  FLOAT_64 zu,
+                                    FLOAT_64 *xg, FLOAT_64 *yg, FLOAT_64 *zg )
+{
+    NIU_UTMToGeocentric(&default_context, xu, yu, zu, xg, yg, zg);
+}
+
+void CoordCnv::NIU_UTMLocalToUTM( FLOAT_64  xl, FLOAT_64  yl, FLOAT_64  zl,
+                                  FLOAT_64 *xu, FLOAT_64 *yu, FLOAT_64 *zu )
+{
+    NIU_UTMLocalToUTM(&default_context, xl, yl, zl, xu, yu, zu);
+}
+
+void CoordCnv::NIU_UTMToUTMLocal( FLOAT_64  xu, FLOAT_64  yu, FLOAT_64  zu,
+                                  FLOAT_64 *xl, FLOAT_64 *yl, FLOAT_64 *zl )
+{
+    NIU_UTMToUTMLocal(&default_context, xu, yu, zu, xl, yl, zl);
+}
+
+void CoordCnv::NIU_UTMLocalToGeocentric( FLOAT_64  xu, FLOAT_64  yu, FLOAT_64  zu,
+                                         FLOAT_64 *xg, FLOAT_64 *yg, FLOAT_64 *zg )
+{
+    NIU_UTMLocalToGeocentric(&default_context, xu, yu, zu, xg, yg, zg);
+}
+
+void CoordCnv::NIU_GeocentricToUTM( FLOAT_64 xg,  FLOAT_64 yg,  FLOAT_64 zg,
+                                    FLOAT_64 *xu, FLOAT_64 *yu, FLOAT_64 *zu )
+{
+    NIU_GeocentricToUTM(&default_context, xg, yg, zg, xu, yu, zu);
+}
+
+void CoordCnv::NIU_GeocentricToUTMLocal( FLOAT_64  xg, FLOAT_64  yg, FLOAT_64  zg,
+                                         FLOAT_64 *xu, FLOAT_64 *yu, FLOAT_64 *zu )
+{
+    NIU_GeocentricToUTMLocal(&default_context, xg, yg, zg, xu, yu, zu);
+}
+
+void CoordCnv::NIU_InitializeCoordinates( FLOAT_64 lat_rad,
+                                          FLOAT_64 lon_rad,
+                                          FLOAT_64 hgt_mtr)
+{
+    NIU_InitializeCoordinates(&default_context, lat_rad, lon_rad, hgt_mtr);
+}
+
+void CoordCnv::NIU_UTMVelocityToGeoVelocity
+(
+        FLOAT_32 srcx,   FLOAT_32 srcy,   FLOAT_32 srcz,
+        FLOAT_32 *destx, FLOAT_32 *desty, FLOAT_32 *destz
+        )
+{
+    NIU_UTMVelocityToGeoVelocity(&default_context, srcx, srcy, srcz, destx, desty, destz);
+}
+
+void CoordCnv::NIU_GeoVelocityToUTMVelocity
+(
+        FLOAT_32 srcx,   FLOAT_32 srcy,   FLOAT_32 srcz,
+        FLOAT_32 *destx, FLOAT_32 *desty, FLOAT_32 *destz
+        )
+{
+    NIU_GeoVelocityToUTMVelocity(&default_context, srcx, srcy, srcz, destx, desty, destz);
+}
@@ -49,21 +49,96 @@ typedef struct
     FLOAT_64     lambda;     /* geodetic longitude in radians */
 } GEO;
 
+/* State of the conversions : ellipsoid model, topocentric and UTM origins of the */
+/* database and the values saved by the last geodetic conversion.                 */
+typedef struct
+{
+    GEO      saved_geo;
+    FLOAT_64 ellipse_a,          /* equatorial radius   */
+             ellipse_a_sq,       /* radius squared      */
+             ellipse_f,          /* flattening (a-b)/a  */
+             ellipse_b,          /* polar semi-diameter */
+             ellipse_b_sq,       /* polar semi-diameter squared */
+             ellipse_a_sq_over_b,/* a*a/b                       */
+             ellipse_e,          /* ellipticity 2f-f*f          */
+             ellipse_c1,         /* (1-f)*(1-f)                 */
+
+             topo_radius,        /* z value at origin of topocentric systemc */
+
+             topo_sin_lat,       /* sin of angle between normal & equ plane  */
+             topo_cos_lat,       /* cos of angle between normal & equ plane  */
+             topo_sin_lon,       /* sin of angle between normal & PM plane   */
+             topo_cos_lon,       /* cos of angle between normal & PM plane   */
+
+             topo_sin_cos,       /* sin(lat) * cos(lon)                      */
+             topo_sin_sin,       /* sin(lat) * sin(lon)                      */
+             topo_cos_cos,       /* cos(lat) * cos(lon)                      */
+             topo_cos_sin,       /* cos(lat) * sin(lon)                      */
+
+             xo, yo, zo, /* origin of the database in geocentric coordinates */
+
+             ellipse_a_b,           /* (a * b)         */
+             ellipse_a_sq_sq,       /* (a * a * a * a) */
+             ellipse_b_sq_sq,       /* (b * b * b * b) */
+             two_over_ellipse_a,    /* (2/a)           */
+             two_over_ellipse_b,    /* (2/b)           */
+             two_over_ellipse_a_sq, /* 2/(a * a)       */
+             two_over_ellipse_b_sq, /* 2/(b * b)       */
+
+             saved_geod_sin_lat,       /* sin of angle latitude (phi)     */
+             saved_geod_cos_lat,       /* cos of angle latitude (phi)     */
+             saved_geod_sin_lon,       /* sin of angle longitude (lambda) */
+             saved_geod_cos_lon,       /* cos of angle longitude (lambda) */
+             saved_geod_sin_cos,       /* sin(lat) * cos(lon)             */
+             saved_geod_sin_sin,       /* sin(lat) * sin(lon)             */
+             saved_geod_cos_cos,       /* cos(lat) * cos(lon)             */
+             saved_geod_cos_sin,       /* cos(lat) * sin(lon)             */
+
+             False_North,
+             False_East,
+             Zone,
+             Database_Origin_X,
+             Database_Origin_Y,
+             Lambda0,
+             e_sq,     /* eccentricity squared */
+             ep_sq,    /* e-prime squared      */
+             ef,       /* e-factor             */
+             e_sq_to_3,/* pow(e_sq,3.0) */
+             ef_to_3,  /* pow(ef,3.0) */
+             ef_to_4,  /* pow(ef,4.0) */
+
+             poly1_a,
+             poly2_a,
+             poly3_a,
+             poly4_a,
+             poly5_a,
+             poly1_b,
+             poly2_b,
+             poly3_b,
+             poly4_b;
+} COORDCNV_CONTEXT;
+
 class QTPLUSSHARED_EXPORT CoordCnv
 {
 private:
-    static void CalcFalseNorthEast ( FLOAT_64 latitude_radians );
+    static void CalcFalseNorthEast ( COORDCNV_CONTEXT *context,
+                                     FLOAT_64 latitude_radians );
     static FLOAT_64 CalcZone(FLOAT_64 longitude_radians);
-    static void CalcLambda0(FLOAT_64 zone);
+    static void CalcLambda0(COORDCNV_CONTEXT *context,
+                            FLOAT_64 zone);
     static void CalcDatabaseOrigin(
+            COORDCNV_CONTEXT *context,
             FLOAT_64 latitude,
             FLOAT_64 longitude,
             FLOAT_64 height);
-    static void SaveGeocentricSinCos( void );
-    static void InitializeEllipsoid( FLOAT_64 a, FLOAT_64 f );
-    static void NIU_Initialize_WGS84( void );
-    static void ComputeTopocentricConstants( FLOAT_64 x, FLOAT_64 y, FLOAT_64 z );
-    static void NIU_InitializeTopocentric( FLOAT_64 x, FLOAT_64 y, FLOAT_64 z );
+    static void SaveGeocentricSinCos( COORDCNV_CONTEXT *context );
+    static void InitializeEllipsoid( COORDCNV_CONTEXT *context,
+                                     FLOAT_64 a, FLOAT_64 f );
+    static void NIU_Initialize_WGS84( COORDCNV_CONTEXT *context );
+    static void ComputeTopocentricConstants( COORDCNV_CONTEXT *context,
+                                             FLOAT_64 x, FLOAT_64 y, FLOAT_64 z );
+    static void NIU_InitializeTopocentric( COORDCNV_CONTEXT *context,
+                                           FLOAT_64 x, FLOAT_64 y, FLOAT_64 z );
 
 public:
 
@@ -120,5 +195,71 @@ public:
             FLOAT_32 inRoll,  FLOAT_32 inPitch,  FLOAT_32 inYaw,
             FLOAT_32 *psi,    FLOAT_32 *theta,   FLOAT_32 *phi );
 
+
+    // Re-entrant versions of the methods above : the state is held by context instead of
+    // a default one shared by all threads. Conversions update their context, each thread
+    // must use its own.
+
+    static void NIU_InitializeCoordinates( COORDCNV_CONTEXT *context,
+                                           FLOAT_64 lat_rad,
+                                           FLOAT_64 lon_rad,
+                                           FLOAT_64 hgt_mtr);
+    static void NIU_GeocentricToGeodetic( COORDCNV_CONTEXT *context,
+                                          FLOAT_64 xp,   FLOAT_64 yp,   FLOAT_64 zp,
+                                          FLOAT_64 *lat, FLOAT_64 *lon, FLOAT_64 *height );
+    static void NIU_GeocentricToUTM( COORDCNV_CONTEXT *context,
+                                     FLOAT_64 xg,  FLOAT_64 yg,  FLOAT_64 zg,
+                                     FLOAT_64 *xu, FLOAT_64 *yu, FLOAT_64 *zu );
+    static void NIU_GeocentricToUTMLocal( COORDCNV_CONTEXT *context,
+                                          FLOAT_64 xg,  FLOAT_64 yg,  FLOAT_64 zg,
+                                          FLOAT_64 *xu, FLOAT_64 *yu, FLOAT_64 *zu );
+    static void NIU_GeocentricToTopocentric( COORDCNV_CONTEXT *context,
+                                             FLOAT_64 xg,  FLOAT_64 yg,  FLOAT_64 zg,
+                                             FLOAT_64 *xt, FLOAT_64 *yt, FLOAT_64 *zt );
+    static void NIU_GeodeticToGeocentric( COORDCNV_CONTEXT *context,
+                                          FLOAT_64 lat,  FLOAT_64 lon,  FLOAT_64 height,
+                                          FLOAT_64 *x,   FLOAT_64 *y,   FLOAT_64 *z );
+    static void NIU_GeodeticToUTM( COORDCNV_CONTEXT *context,
+                                   GEO *geo, UTM *utm );
+    static void NIU_UTMToGeodetic( COORDCNV_CONTEXT *context,
+                                   UTM *utm, GEO *geo );
+    static void NIU_UTMToGeocentric( COORDCNV_CONTEXT *context,
+                                     FLOAT_64 xu,  FLOAT_64 yu,  FLOAT_64 zu,
+                                     FLOAT_64 *xg, FLOAT_64 *yg, FLOAT_64 *zg );
+    static void NIU_UTMLocalToGeocentric( COORDCNV_CONTEXT *context,
+                                          FLOAT_64  xu, FLOAT_64  yu, FLOAT_64  zu,
+                                          FLOAT_64 *xg, FLOAT_64 *yg, FLOAT_64 *zg );
+    static void NIU_UTMLocalToUTM ( COORDCNV_CONTEXT *context,
+                                    FLOAT_64 xl,  FLOAT_64 yl,  FLOAT_64 zl,
+                                    FLOAT_64 *xu, FLOAT_64 *yu, FLOAT_64 *zu );
+    static void NIU_UTMToUTMLocal ( COORDCNV_CONTEXT *context,
+                                    FLOAT_64 xu,  FLOAT_64 yu,  FLOAT_64 zu,
+                                    FLOAT_64 *xl, FLOAT_64 *yl, FLOAT_64 *zl );
+    static void NIU_TopocentricToGeocentric( COORDCNV_CONTEXT *context,
+                                             FLOAT_64 xt,  FLOAT_64 yt,  FLOAT_64 zt,
+                                             FLOAT_64 *xg, FLOAT_64 *yg, FLOAT_64 *zg );
+    static void NIU_TopovelocityToGeovelocity(COORDCNV_CONTEXT *context,
+                                              FLOAT_32  vxt, FLOAT_32  vyt, FLOAT_32  vzt,
+                                              FLOAT_32 *vxg, FLOAT_32 *vyg, FLOAT_32 *vzg);
+    static void NIU_GeoVelocityToUTMVelocity(
+            COORDCNV_CONTEXT *context,
+            FLOAT_32 srcx,   FLOAT_32 srcy,   FLOAT_32 srcz,
+            FLOAT_32 *destx, FLOAT_32 *desty, FLOAT_32 *destz );
+    static void NIU_GeovelocityToTopovelocity(COORDCNV_CONTEXT *context,
+                                              FLOAT_32  vxg, FLOAT_32  vyg, FLOAT_32  vzg,
+                                              FLOAT_32 *vxt, FLOAT_32 *vyt, FLOAT_32 *vzt);
+    static void NIU_UTMVelocityToGeoVelocity(
+            COORDCNV_CONTEXT *context,
+            FLOAT_32 srcx,   FLOAT_32 srcy,   FLOAT_32 srcz,
+            FLOAT_32 *destx, FLOAT_32 *desty, FLOAT_32 *destz );
+    static void NIU_GeoeulerToTopoeuler(
+            COORDCNV_CONTEXT *context,
+            FLOAT_32 psi,      FLOAT_32 theta,     FLOAT_32 phi,
+            FLOAT_32 *outRoll, FLOAT_32 *outPitch, FLOAT_32 *outYaw );
+    static void NIU_TopoeulerToGeoeuler(
+            COORDCNV_CONTEXT *context,
+            FLOAT_32 inRoll,  FLOAT_32 inPitch,  FLOAT_32 inYaw,
+            FLOAT_32 *psi,    FLOAT_32 *theta,   FLOAT_32 *phi );
+
 };
 #endif
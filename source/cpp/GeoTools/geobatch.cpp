@@ -0,0 +1,576 @@
+/***************************************************************************/
+/* RSC IDENTIFIER:  GEOCENTRIC BATCH
+ *
+ * ABSTRACT
+ *
+ *    This component converts arrays of points between Geodetic coordinates
+ *    (latitude, longitude in radians and height in meters), Geocentric
+ *    coordinates (X, Y, Z) in meters and local East, North, Up coordinates
+ *    in meters.
+ *
+ *    See geobatch.h for the accuracy of the approximations.
+ *
+ * ERROR HANDLING
+ *
+ *    The geodetic coordinates of all points are checked before converting
+ *    any of them.  The error codes are those of GEOCENTRIC :
+ *
+ *      GEOCENT_NO_ERROR        : No errors occurred in function
+ *      GEOCENT_LAT_ERROR       : A latitude is out of valid range
+ *                                 (-90 to 90 degrees)
+ *      GEOCENT_LON_ERROR       : A longitude is out of valid range
+ *                                 (-180 to 360 degrees)
+ *
+ * REFERENCES
+ *
+ *    Direct transformation from geocentric coordinates to geodetic
+ *    coordinates, H. Vermeille, Journal of Geodesy (2002) 76:451-454.
+ *
+ *    Cephes Mathematical Library, S. L. Moshier, for the polynomial
+ *    coefficients.
+ *
+ */
+
+
+/***************************************************************************/
+/*
+ *                               INCLUDES
+ */
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include "geobatch.h"
+
+/*
+ *    float.h     - is needed for DBL_MIN.
+ *    math.h      - is needed for sqrt, fabs, copysign and the trigonometry of
+ *                  the local frame origins.
+ *    string.h    - is needed for memcpy.
+ *    geobatch.h  - is needed for Error codes and prototype error checking.
+ */
+
+
+/***************************************************************************/
+/*
+ *                               DEFINES
+ */
+#define PI              3.14159265358979323e0
+#define PI_OVER_2       (PI / 2.0e0)
+#define PI_OVER_4       (PI / 4.0e0)
+#define TWO_OVER_PI     0.63661977236758134308
+#define TAN_PI_OVER_8   0.41421356237309504880
+
+/* PI / 2 in three parts, the first two exact in 33 bits (fdlibm) */
+#define PIO2_1          1.57079632673412561417e+00
+#define PIO2_2          6.07710050630396597660e-11
+#define PIO2_3          2.02226624871116645580e-21
+
+/* Adding and subtracting 1.5 * 2^52 rounds a double to the nearest integer */
+#define ROUND_MAGIC     6755399441055744.0
+
+/* Low bits of PI / 4, added back by the arctangent */
+#define MOREBITS        6.123233995736765886130E-17
+
+/*
+ * Conversions write blocks of BATCH_BLOCK points into local arrays, then
+ * copy them to the output arrays : their loops then need no check for
+ * overlapping arrays, which compilers give up on past a few arrays, and the
+ * output arrays may be the input arrays.
+ */
+#define BATCH_BLOCK     256
+
+
+/***************************************************************************/
+/*
+ *                              APPROXIMATIONS
+ */
+
+/*
+ * The functions below are inlined in the loops of the conversions.  They
+ * do not branch, so that compilers can turn these loops into SIMD code.
+ */
+
+static Q_ALWAYS_INLINE void Sin_Cos_Approx (double Angle,
+                                            double *Sin,
+                                            double *Cos)
+/*
+ * Reduces Angle to [-PI / 4, PI / 4] around the nearest multiple of PI / 2,
+ * evaluates the minimax polynomials of Cephes on the reduced angle and
+ * swaps or negates them according to the quadrant.
+ */
+{ /* BEGIN Sin_Cos_Approx */
+    double Quadrant = (Angle * TWO_OVER_PI + ROUND_MAGIC) - ROUND_MAGIC;
+    int Index = (int) Quadrant;
+    double R = ((Angle - Quadrant * PIO2_1) - Quadrant * PIO2_2) - Quadrant * PIO2_3;
+    double R2 = R * R;
+
+    double S = R + R * R2 * (((((1.58962301576546568060E-10 * R2
+                                 - 2.50507477628578072866E-8) * R2
+                                + 2.75573136213857245213E-6) * R2
+                               - 1.98412698295895385996E-4) * R2
+                              + 8.33333333332211858878E-3) * R2
+                             - 1.66666666666666307295E-1);
+
+    double C = 1.0 - 0.5 * R2 + R2 * R2 * (((((-1.13585365213876817300E-11 * R2
+                                               + 2.08757008419747316778E-9) * R2
+                                              - 2.75573141792967388112E-7) * R2
+                                             + 2.48015872888517045348E-5) * R2
+                                            - 1.38888888888730564116E-3) * R2
+                                           + 4.16666666666665929218E-2);
+
+    double Swapped_Sin = (Index & 1) ? C : S;
+    double Swapped_Cos = (Index & 1) ? S : C;
+
+    *Sin = (Index & 2) ? -Swapped_Sin : Swapped_Sin;
+    *Cos = ((Index + 1) & 2) ? -Swapped_Cos : Swapped_Cos;
+} /* END OF Sin_Cos_Approx */
+
+
+static Q_ALWAYS_INLINE double Atan2_Approx (double Y,
+                                            double X)
+/*
+ * Brings the ratio of the smallest to the largest absolute value to
+ * [0, tan(PI / 8)], evaluates the rational approximation of Cephes and
+ * unfolds the result to the octant, then to the quadrant of (X, Y).
+ */
+{ /* BEGIN Atan2_Approx */
+    double Abs_X = fabs(X);
+    double Abs_Y = fabs(Y);
+
+    /*
+     * The selections are products with masks of 0 or 1, which are exact.
+     * The masks come from copysign : compilers turn comparisons back into
+     * branches.
+     */
+    double Swap = 0.5 - 0.5 * copysign(1.0, Abs_X - Abs_Y);
+    double Max = Swap * Abs_Y + (1.0 - Swap) * Abs_X;
+    double Min = Swap * Abs_X + (1.0 - Swap) * Abs_Y;
+    double Ratio = Min / (Max + DBL_MIN);
+
+    double Upper = 0.5 + 0.5 * copysign(1.0, Ratio - TAN_PI_OVER_8);
+    double T = (Ratio - Upper) / (1.0 + Upper * Ratio);
+    double Z = T * T;
+
+    double P = (((-8.750608600031904122785E-1 * Z
+                  - 1.615753718733365076637E1) * Z
+                 - 7.500855792314704667340E1) * Z
+                - 1.228866684490136173410E2) * Z
+               - 6.485021904942025371773E1;
+    double Q = ((((Z + 2.485846490142306297962E1) * Z
+                  + 1.650270098316988542046E2) * Z
+                 + 4.328810604912902668951E2) * Z
+                + 4.853903996359136964868E2) * Z
+               + 1.945506571482613964425E2;
+
+    double Angle = Upper * PI_OVER_4 + (T + (T * Z * P / Q + Upper * 0.5 * MOREBITS));
+
+    /* Octant, then quadrant : PI / 2 - Angle above the diagonal, PI - Angle left of the Y axis */
+    Angle = Swap * PI_OVER_2 + (1.0 - 2.0 * Swap) * Angle;
+    Angle = (0.5 - 0.5 * copysign(1.0, X)) * PI + copysign(Angle, X);
+
+    return copysign(Angle, Y);
+} /* END OF Atan2_Approx */
+
+
+/* Largest value given to Cbrt_Near_One : it covers points more than about 550 km away from the center of the Earth */
+#define CBRT_NEAR_ONE_MAX 1.5
+
+static Q_ALWAYS_INLINE double Cbrt_Near_One (double Value)
+/*
+ * Cube root of a value slightly above 1.  Starts from the first order
+ * expansion and refines it with three Newton steps, enough for values up
+ * to CBRT_NEAR_ONE_MAX.
+ */
+{ /* BEGIN Cbrt_Near_One */
+    double Root = 1.0 + (Value - 1.0) / 3.0;
+
+    Root = Root - (Root * Root * Root - Value) / (3.0 * Root * Root);
+    Root = Root - (Root * Root * Root - Value) / (3.0 * Root * Root);
+    Root = Root - (Root * Root * Root - Value) / (3.0 * Root * Root);
+
+    return Root;
+} /* END OF Cbrt_Near_One */
+
+
+static long Check_Geodetic (long Count,
+                            const double *Latitudes,
+                            const double *Longitudes)
+/*
+ * Returns the error codes of the geodetic coordinates of Count points.
+ */
+{ /* BEGIN Check_Geodetic */
+    int Lat_Error = 0;
+    int Lon_Error = 0;
+    long Index;
+
+    for (Index = 0; Index < Count; Index++)
+    {
+        Lat_Error |= (Latitudes[Index] < -PI_OVER_2) | (Latitudes[Index] > PI_OVER_2);
+        Lon_Error |= (Longitudes[Index] < -PI) | (Longitudes[Index] > (2 * PI));
+    }
+
+    return (Lat_Error ? GEOCENT_LAT_ERROR : GEOCENT_NO_ERROR) | (Lon_Error ? GEOCENT_LON_ERROR : GEOCENT_NO_ERROR);
+} /* END OF Check_Geodetic */
+
+
+static void Geodetic_To_Geocentric (const Geocentric_Context *Context,
+                                    long Count,
+                                    const double *Latitudes,
+                                    const double *Longitudes,
+                                    const double *Heights,
+                                    double *X,
+                                    double *Y,
+                                    double *Z)
+/*
+ * Converts Count geodetic coordinates that were checked, BATCH_BLOCK at a
+ * time.
+ */
+{ /* BEGIN Geodetic_To_Geocentric */
+    const double a = Context->a;
+    const double e2 = Context->e2;
+    double Block_X[BATCH_BLOCK];
+    double Block_Y[BATCH_BLOCK];
+    double Block_Z[BATCH_BLOCK];
+    long Start;
+    long Index;
+
+    for (Start = 0; Start < Count; Start += BATCH_BLOCK)
+    {
+        long Size = Count - Start < BATCH_BLOCK ? Count - Start : BATCH_BLOCK;
+
+        for (Index = 0; Index < Size; Index++)
+        {
+            double Sin_Lat, Cos_Lat, Sin_Lon, Cos_Lon;
+            double Height = Heights[Start + Index];
+
+            Sin_Cos_Approx (Latitudes[Start + Index], &Sin_Lat, &Cos_Lat);
+            Sin_Cos_Approx (Longitudes[Start + Index], &Sin_Lon, &Cos_Lon);
+
+            double Rn = a / sqrt(1.0 - e2 * Sin_Lat * Sin_Lat);
+
+            Block_X[Index] = (Rn + Height) * Cos_Lat * Cos_Lon;
+            Block_Y[Index] = (Rn + Height) * Cos_Lat * Sin_Lon;
+            Block_Z[Index] = (Rn * (1.0 - e2) + Height) * Sin_Lat;
+        }
+
+        memcpy (X + Start, Block_X, Size * sizeof(double));
+        memcpy (Y + Start, Block_Y, Size * sizeof(double));
+        memcpy (Z + Start, Block_Z, Size * sizeof(double));
+    }
+} /* END OF Geodetic_To_Geocentric */
+
+
+static Q_ALWAYS_INLINE void Closed_Form (double e2,
+                                         double e4,
+                                         double W,
+                                         double Z,
+                                         double q,
+                                         double r,
+                                         double t,
+                                         double *Latitude,
+                                         double *Height)
+/*
+ * Ends the closed form of Vermeille for a point at distance W from the
+ * polar axis, given the cube root t.
+ */
+{ /* BEGIN Closed_Form */
+    double u = r * (1.0 + t + 1.0 / t);
+    double v = sqrt(u * u + e4 * q);
+    double w = e2 * (u + v - q) / (2.0 * v);
+    double k = sqrt(u + v + w * w) - w;
+    double D = k * W / (k + e2);
+    double Hypot = sqrt(D * D + Z * Z);
+
+    *Latitude = 2.0 * Atan2_Approx (Z, D + Hypot);
+    *Height = (k + e2 - 1.0) / k * Hypot;
+} /* END OF Closed_Form */
+
+
+static void Geocentric_To_Geodetic (const Geocentric_Context *Context,
+                                    long Count,
+                                    const double *X,
+                                    const double *Y,
+                                    const double *Z,
+                                    double *Latitudes,
+                                    double *Longitudes,
+                                    double *Heights)
+/*
+ * Converts Count geocentric coordinates with the closed form of Vermeille,
+ * BATCH_BLOCK at a time.  Points closer to the center of the Earth than
+ * about 550 km are outside the range of Cbrt_Near_One : they are converted
+ * again with cbrt().  Points inside the evolute of the ellipse, closer than
+ * about e2 * a, are outside the domain of the closed form : they are
+ * converted again with GEOCENTRIC.
+ */
+{ /* BEGIN Geocentric_To_Geodetic */
+    const double e2 = Context->e2;
+    const double e4 = e2 * e2;
+    const double Inv_a2 = 1.0 / (Context->a * Context->a);
+    double Block_Latitudes[BATCH_BLOCK];
+    double Block_Longitudes[BATCH_BLOCK];
+    double Block_Heights[BATCH_BLOCK];
+    double Block_r[BATCH_BLOCK];
+    double Block_Cube[BATCH_BLOCK];
+    long Start;
+    long Index;
+
+    for (Start = 0; Start < Count; Start += BATCH_BLOCK)
+    {
+        long Size = Count - Start < BATCH_BLOCK ? Count - Start : BATCH_BLOCK;
+
+        for (Index = 0; Index < Size; Index++)
+        {
+            double Xi = X[Start + Index];
+            double Yi = Y[Start + Index];
+            double Zi = Z[Start + Index];
+
+            double W2 = Xi * Xi + Yi * Yi;
+            double W = sqrt(W2);
+            double p = W2 * Inv_a2;
+            double q = (1.0 - e2) * Inv_a2 * Zi * Zi;
+            double r = (p + q - e4) / 6.0;
+            double s = e4 * p * q / (4.0 * r * r * r);
+
+            double Cube = 1.0 + s + sqrt(s * (2.0 + s));
+
+            /* Kept to find the points outside the domain of the closed form, without a branch here */
+            Block_r[Index] = r;
+            Block_Cube[Index] = Cube;
+
+            Block_Longitudes[Index] = Atan2_Approx (Yi, Xi);
+
+            Closed_Form (e2, e4, W, Zi, q, r, Cbrt_Near_One (Cube), &Block_Latitudes[Index], &Block_Heights[Index]);
+        }
+
+        /* The input arrays are intact until the block is copied */
+        for (Index = 0; Index < Size; Index++)
+        {
+            if (Block_r[Index] <= 0.0)
+            {
+                Convert_Geocentric_To_Geodetic_Ctx (Context, X[Start + Index], Y[Start + Index], Z[Start + Index],
+                                                    &Block_Latitudes[Index], &Block_Longitudes[Index], &Block_Heights[Index]);
+            }
+            else if (!(Block_Cube[Index] <= CBRT_NEAR_ONE_MAX))
+            {
+                double Xi = X[Start + Index];
+                double Yi = Y[Start + Index];
+                double Zi = Z[Start + Index];
+                double W = sqrt(Xi * Xi + Yi * Yi);
+                double q = (1.0 - e2) * Inv_a2 * Zi * Zi;
+
+                Closed_Form (e2, e4, W, Zi, q, Block_r[Index], cbrt(Block_Cube[Index]), &Block_Latitudes[Index], &Block_Heights[Index]);
+            }
+        }
+
+        memcpy (Latitudes + Start, Block_Latitudes, Size * sizeof(double));
+        memcpy (Longitudes + Start, Block_Longitudes, Size * sizeof(double));
+        memcpy (Heights + Start, Block_Heights, Size * sizeof(double));
+    }
+} /* END OF Geocentric_To_Geodetic */
+
+
+static void Local_Frame (const Geocentric_Context *Context,
+                         double Origin_Latitude,
+                         double Origin_Longitude,
+                         double Origin_Height,
+                         double Origin[3],
+                         double Rotation[3][3])
+/*
+ * Computes the geocentric position of the origin of a local East, North, Up
+ * frame and the rotation from geocentric axes to the axes of this frame.
+ */
+{ /* BEGIN Local_Frame */
+    double Sin_Lat = sin(Origin_Latitude);
+    double Cos_Lat = cos(Origin_Latitude);
+    double Sin_Lon = sin(Origin_Longitude);
+    double Cos_Lon = cos(Origin_Longitude);
+
+    Convert_Geodetic_To_Geocentric_Ctx (Context, Origin_Latitude, Origin_Longitude, Origin_Height,
+                                        &Origin[0], &Origin[1], &Origin[2]);
+
+    /* East */
+    Rotation[0][0] = -Sin_Lon;
+    Rotation[0][1] = Cos_Lon;
+    Rotation[0][2] = 0.0;
+
+    /* North */
+    Rotation[1][0] = -Sin_Lat * Cos_Lon;
+    Rotation[1][1] = -Sin_Lat * Sin_Lon;
+    Rotation[1][2] = Cos_Lat;
+
+    /* Up */
+    Rotation[2][0] = Cos_Lat * Cos_Lon;
+    Rotation[2][1] = Cos_Lat * Sin_Lon;
+    Rotation[2][2] = Sin_Lat;
+} /* END OF Local_Frame */
+
+
+/***************************************************************************/
+/*
+ *                              FUNCTIONS
+ */
+
+long Convert_Geodetic_To_Geocentric_Batch (const Geocentric_Context *Context,
+                                           long Count,
+                                           const double *Latitudes,
+                                           const double *Longitudes,
+                                           const double *Heights,
+                                           double *X,
+                                           double *Y,
+                                           double *Z)
+{ /* BEGIN Convert_Geodetic_To_Geocentric_Batch */
+    long Error_Code = Check_Geodetic (Count, Latitudes, Longitudes);
+
+    if (!Error_Code)
+    { /* no errors */
+        Geodetic_To_Geocentric (Context, Count, Latitudes, Longitudes, Heights, X, Y, Z);
+    }
+    return (Error_Code);
+} /* END OF Convert_Geodetic_To_Geocentric_Batch */
+
+
+void Convert_Geocentric_To_Geodetic_Batch (const Geocentric_Context *Context,
+                                           long Count,
+                                           const double *X,
+                                           const double *Y,
+                                           const double *Z,
+                                           double *Latitudes,
+                                           double *Longitudes,
+                                           double *Heights)
+{ /* BEGIN Convert_Geocentric_To_Geodetic_Batch */
+    Geocentric_To_Geodetic (Context, Count, X, Y, Z, Latitudes, Longitudes, Heights);
+} /* END OF Convert_Geocentric_To_Geodetic_Batch */
+
+
+long Convert_Geodetic_To_Local_ENU_Batch (const Geocentric_Context *Context,
+                                          double Origin_Latitude,
+                                          double Origin_Longitude,
+                                          double Origin_Height,
+                                          long Count,
+                                          const double *Latitudes,
+                                          const double *Longitudes,
+                                          const double *Heights,
+                                          double *East,
+                                          double *North,
+                                          double *Up)
+{ /* BEGIN Convert_Geodetic_To_Local_ENU_Batch */
+    long Error_Code = Check_Geodetic (1, &Origin_Latitude, &Origin_Longitude);
+    double Origin[3];
+    double Rotation[3][3];
+    long Index;
+
+    Error_Code |= Check_Geodetic (Count, Latitudes, Longitudes);
+
+    if (!Error_Code)
+    { /* no errors */
+        Local_Frame (Context, Origin_Latitude, Origin_Longitude, Origin_Height, Origin, Rotation);
+
+        /* The output arrays hold the geocentric coordinates until they are rotated */
+        Geodetic_To_Geocentric (Context, Count, Latitudes, Longitudes, Heights, East, North, Up);
+
+        for (Index = 0; Index < Count; Index++)
+        {
+            double dX = East[Index] - Origin[0];
+            double dY = North[Index] - Origin[1];
+            double dZ = Up[Index] - Origin[2];
+
+            East[Index] = Rotation[0][0] * dX + Rotation[0][1] * dY;
+            North[Index] = Rotation[1][0] * dX + Rotation[1][1] * dY + Rotation[1][2] * dZ;
+            Up[Index] = Rotation[2][0] * dX + Rotation[2][1] * dY + Rotation[2][2] * dZ;
+        }
+    }
+    return (Error_Code);
+} /* END OF Convert_Geodetic_To_Local_ENU_Batch */
+
+
+long Convert_Local_ENU_To_Geodetic_Batch (const Geocentric_Context *Context,
+                                          double Origin_Latitude,
+                                          double Origin_Longitude,
+                                          double Origin_Height,
+                                          long Count,
+                                          const double *East,
+                                          const double *North,
+                                          const double *Up,
+                                          double *Latitudes,
+                                          double *Longitudes,
+                                          double *Heights)
+{ /* BEGIN Convert_Local_ENU_To_Geodetic_Batch */
+    long Error_Code = Check_Geodetic (1, &Origin_Latitude, &Origin_Longitude);
+    double Block_X[BATCH_BLOCK];
+    double Block_Y[BATCH_BLOCK];
+    double Block_Z[BATCH_BLOCK];
+    double Origin[3];
+    double Rotation[3][3];
+    long Start;
+    long Index;
+
+    if (!Error_Code)
+    { /* no errors */
+        Local_Frame (Context, Origin_Latitude, Origin_Longitude, Origin_Height, Origin, Rotation);
+
+        for (Start = 0; Start < Count; Start += BATCH_BLOCK)
+        {
+            long Size = Count - Start < BATCH_BLOCK ? Count - Start : BATCH_BLOCK;
+
+            for (Index = 0; Index < Size; Index++)
+            {
+                double E = East[Start + Index];
+                double N = North[Start + Index];
+                double U = Up[Start + Index];
+
+                Block_X[Index] = Origin[0] + Rotation[0][0] * E + Rotation[1][0] * N + Rotation[2][0] * U;
+                Block_Y[Index] = Origin[1] + Rotation[0][1] * E + Rotation[1][1] * N + Rotation[2][1] * U;
+                Block_Z[Index] = Origin[2] + Rotation[1][2] * N + Rotation[2][2] * U;
+            }
+
+            Geocentric_To_Geodetic (Context, Size, Block_X, Block_Y, Block_Z,
+                                    Latitudes + Start, Longitudes + Start, Heights + Start);
+        }
+    }
+    return (Error_Code);
+} /* END OF Convert_Local_ENU_To_Geodetic_Batch */
+
+
+void Sin_Cos_Batch (long Count,
+                    const double *Angles,
+                    double *Sines,
+                    double *Cosines)
+{ /* BEGIN Sin_Cos_Batch */
+/*
+ * The function Sin_Cos_Batch computes the sine and cosine of Count angles.
+ *
+ *    Count   : Number of angles                                  (input)
+ *    Angles  : Angles in radians                                 (input)
+ *    Sines   : Sines of the angles                               (output)
+ *    Cosines : Cosines of the angles                             (output)
+ */
+    long Index;
+
+    for (Index = 0; Index < Count; Index++)
+    {
+        Sin_Cos_Approx (Angles[Index], &Sines[Index], &Cosines[Index]);
+    }
+} /* END OF Sin_Cos_Batch */
+
+
+void Atan2_Batch (long Count,
+                  const double *Y,
+                  const double *X,
+                  double *Angles)
+{ /* BEGIN Atan2_Batch */
+/*
+ * The function Atan2_Batch computes the arctangent of Y / X for Count
+ * pairs, in the quadrant given by the signs of Y and X.
+ *
+ *    Count   : Number of pairs                                   (input)
+ *    Y       : Ordinates                                         (input)
+ *    X       : Abscissas                                         (input)
+ *    Angles  : Angles in radians, within [-PI, PI]               (output)
+ */
+    long Index;
+
+    for (Index = 0; Index < Count; Index++)
+    {
+        Angles[Index] = Atan2_Approx (Y[Index], X[Index]);
+    }
+} /* END OF Atan2_Batch */
@@ -0,0 +1,223 @@
+#ifndef GEOBATCH_H
+#define GEOBATCH_H
+
+#include "../qtplus_global.h"
+#include "geocent.h"
+
+/***************************************************************************/
+/* RSC IDENTIFIER:  GEOCENTRIC BATCH
+ *
+ * ABSTRACT
+ *
+ *    This component converts arrays of points between Geodetic coordinates
+ *    (latitude, longitude in radians and height in meters), Geocentric
+ *    coordinates (X, Y, Z) in meters and local East, North, Up coordinates
+ *    in meters.
+ *
+ *    Points are passed as structures of arrays : one array per coordinate.
+ *    The loops contain no branches and no calls to the math library other
+ *    than sqrt, so that compilers turn them into SIMD code : sine, cosine
+ *    and arctangent are polynomial approximations and the inverse
+ *    conversion uses the closed form of Vermeille instead of an iteration.
+ *
+ * ACCURACY
+ *
+ *    The sine and cosine approximations have an absolute error below
+ *    2.0e-16 for angles within [-2 PI, 2 PI], the arctangent below 6.0e-16.
+ *    Against an extended precision reference, conversions to geocentric
+ *    coordinates are within 2.0e-8 meters and conversions to geodetic
+ *    coordinates within 1.0e-15 radians and 2.0e-8 meters, for points
+ *    whose distance to the center of the Earth is more than 1000 km.
+ *    The closed form is not defined for points closer to the center than
+ *    about e2 * a (43 km for WGS 84) : these points are converted with
+ *    GEOCENTRIC, which is slower but gives finite results.
+ *
+ * ERROR HANDLING
+ *
+ *    The geodetic coordinates of all points are checked before converting
+ *    any of them.  The error codes are those of GEOCENTRIC :
+ *
+ *      GEOCENT_NO_ERROR        : No errors occurred in function
+ *      GEOCENT_LAT_ERROR       : A latitude is out of valid range
+ *                                 (-90 to 90 degrees)
+ *      GEOCENT_LON_ERROR       : A longitude is out of valid range
+ *                                 (-180 to 360 degrees)
+ *
+ * REUSE NOTES
+ *
+ *    GEOCENTRIC BATCH is meant for large sets of points, such as tracks.
+ *    Single points are better converted with GEOCENTRIC.
+ *
+ * REFERENCES
+ *
+ *    Direct transformation from geocentric coordinates to geodetic
+ *    coordinates, H. Vermeille, Journal of Geodesy (2002) 76:451-454.
+ *
+ *    Cephes Mathematical Library, S. L. Moshier, for the polynomial
+ *    coefficients.
+ *
+ */
+
+
+/***************************************************************************/
+/*
+ *                              FUNCTION PROTOTYPES
+ */
+
+/* ensure proper linkage to c++ programs */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+long QTPLUSSHARED_EXPORT Convert_Geodetic_To_Geocentric_Batch (const Geocentric_Context *Context,
+                                                                long Count,
+                                                                const double *Latitudes,
+                                                                const double *Longitudes,
+                                                                const double *Heights,
+                                                                double *X,
+                                                                double *Y,
+                                                                double *Z);
+/*
+ * The function Convert_Geodetic_To_Geocentric_Batch converts Count geodetic
+ * coordinates to geocentric coordinates, according to the ellipsoid
+ * parameters of Context.  Nothing is converted if an error occurs.
+ *
+ *    Context    : Ellipsoid parameters                           (input)
+ *    Count      : Number of points                               (input)
+ *    Latitudes  : Geodetic latitudes in radians                  (input)
+ *    Longitudes : Geodetic longitudes in radians                 (input)
+ *    Heights    : Geodetic heights, in meters                    (input)
+ *    X          : Geocentric X coordinates, in meters            (output)
+ *    Y          : Geocentric Y coordinates, in meters            (output)
+ *    Z          : Geocentric Z coordinates, in meters            (output)
+ */
+
+
+void QTPLUSSHARED_EXPORT Convert_Geocentric_To_Geodetic_Batch (const Geocentric_Context *Context,
+                                                                long Count,
+                                                                const double *X,
+                                                                const double *Y,
+                                                                const double *Z,
+                                                                double *Latitudes,
+                                                                double *Longitudes,
+                                                                double *Heights);
+/*
+ * The function Convert_Geocentric_To_Geodetic_Batch converts Count
+ * geocentric coordinates to geodetic coordinates, according to the
+ * ellipsoid parameters of Context.  The output arrays may be the input
+ * arrays.  Points within about e2 * a of the center of the Earth are
+ * converted with Convert_Geocentric_To_Geodetic_Ctx.
+ *
+ *    Context    : Ellipsoid parameters                           (input)
+ *    Count      : Number of points                               (input)
+ *    X          : Geocentric X coordinates, in meters            (input)
+ *    Y          : Geocentric Y coordinates, in meters            (input)
+ *    Z          : Geocentric Z coordinates, in meters            (input)
+ *    Latitudes  : Geodetic latitudes in radians                  (output)
+ *    Longitudes : Geodetic longitudes in radians                 (output)
+ *    Heights    : Geodetic heights, in meters                    (output)
+ */
+
+
+long QTPLUSSHARED_EXPORT Convert_Geodetic_To_Local_ENU_Batch (const Geocentric_Context *Context,
+                                                               double Origin_Latitude,
+                                                               double Origin_Longitude,
+                                                               double Origin_Height,
+                                                               long Count,
+                                                               const double *Latitudes,
+                                                               const double *Longitudes,
+                                                               const double *Heights,
+                                                               double *East,
+                                                               double *North,
+                                                               double *Up);
+/*
+ * The function Convert_Geodetic_To_Local_ENU_Batch converts Count geodetic
+ * coordinates to the local East, North, Up frame whose origin is the
+ * geodetic point Origin_Latitude, Origin_Longitude, Origin_Height.  Up is
+ * the normal to the ellipsoid at the origin.  Nothing is converted if an
+ * error occurs.
+ *
+ *    Context          : Ellipsoid parameters                     (input)
+ *    Origin_Latitude  : Latitude of the origin in radians        (input)
+ *    Origin_Longitude : Longitude of the origin in radians       (input)
+ *    Origin_Height    : Height of the origin, in meters          (input)
+ *    Count            : Number of points                         (input)
+ *    Latitudes        : Geodetic latitudes in radians            (input)
+ *    Longitudes       : Geodetic longitudes in radians           (input)
+ *    Heights          : Geodetic heights, in meters              (input)
+ *    East             : East coordinates, in meters              (output)
+ *    North            : North coordinates, in meters             (output)
+ *    Up               : Up coordinates, in meters                (output)
+ */
+
+
+long QTPLUSSHARED_EXPORT Convert_Local_ENU_To_Geodetic_Batch (const Geocentric_Context *Context,
+                                                               double Origin_Latitude,
+                                                               double Origin_Longitude,
+                                                               double Origin_Height,
+                                                               long Count,
+                                                               const double *East,
+                                                               const double *North,
+                                                               const double *Up,
+                                                               double *Latitudes,
+                                                               double *Longitudes,
+                                                               double *Heights);
+/*
+ * The function Convert_Local_ENU_To_Geodetic_Batch converts Count local
+ * East, North, Up coordinates, relative to the geodetic point
+ * Origin_Latitude, Origin_Longitude, Origin_Height, to geodetic
+ * coordinates.  Only the origin is checked.  The output arrays may be the
+ * input arrays.
+ *
+ *    Context          : Ellipsoid parameters                     (input)
+ *    Origin_Latitude  : Latitude of the origin in radians        (input)
+ *    Origin_Longitude : Longitude of the origin in radians       (input)
+ *    Origin_Height    : Height of the origin, in meters          (input)
+ *    Count            : Number of points                         (input)
+ *    East             : East coordinates, in meters              (input)
+ *    North            : North coordinates, in meters             (input)
+ *    Up               : Up coordinates, in meters                (input)
+ *    Latitudes        : Geodetic latitudes in radians            (output)
+ *    Longitudes       : Geodetic longitudes in radians           (output)
+ *    Heights          : Geodetic heights, in meters              (output)
+ */
+
+
+void QTPLUSSHARED_EXPORT Sin_Cos_Batch (long Count,
+                                        const double *Angles,
+                                        double *Sines,
+                                        double *Cosines);
+/*
+ * The function Sin_Cos_Batch computes the sine and cosine of Count angles
+ * with the approximations used by the conversions.
+ *
+ *    Count   : Number of angles                                  (input)
+ *    Angles  : Angles in radians                                 (input)
+ *    Sines   : Sines of the angles                               (output)
+ *    Cosines : Cosines of the angles                             (output)
+ */
+
+
+void QTPLUSSHARED_EXPORT Atan2_Batch (long Count,
+                                      const double *Y,
+                                      const double *X,
+                                      double *Angles);
+/*
+ * The function Atan2_Batch computes the arctangent of Y / X for Count
+ * pairs, in the quadrant given by the signs of Y and X, with the
+ * approximation used by the conversions.  Like atan2, the result is 0 or
+ * PI when both are 0, depending on the sign of X.
+ *
+ *    Count   : Number of pairs                                   (input)
+ *    Y       : Ordinates                                         (input)
+ *    X       : Abscissas                                         (input)
+ *    Angles  : Angles in radians, within [-PI, PI]               (output)
+ */
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOBATCH_H */
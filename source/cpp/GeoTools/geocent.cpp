@@ -100,14 +100,19 @@
  *                              GLOBAL DECLARATIONS
  */
 /* Ellipsoid parameters, default to WGS 84 */
-double Geocent_a = 6378137.0;          /* Semi-major axis of ellipsoid in meters */
-double Geocent_f = 1 / 298.257223563;  /* Flattening of ellipsoid           */
+#define GEOCENT_DEFAULT_CONTEXT { \
+  6378137.0,                /* Semi-major axis of ellipsoid in meters */ \
+  1 / 298.257223563,        /* Flattening of ellipsoid */ \
+  0.0066943799901413800,    /* Eccentricity squared */ \
+  0.00673949675658690300 }  /* 2nd eccentricity squared */
 
-double Geocent_e2 = 0.0066943799901413800;   /* Eccentricity squared  */
-double Geocent_ep2 = 0.00673949675658690300; /* 2nd eccentricity squared */
+static const Geocentric_Context Geocent_WGS84 = GEOCENT_DEFAULT_CONTEXT;
+
+/* Context of the functions that do not take one */
+static Geocentric_Context Geocent_Default = GEOCENT_DEFAULT_CONTEXT;
 /*
- * These state variables are for optimization purposes.  The only function
- * that should modify them is Set_Geocentric_Parameters.
+ * The eccentricities of a context are for optimization purposes.  The only
+ * function that should modify them is Set_Geocentric_Parameters_Ctx.
  */
 
 
@@ -117,9 +122,23 @@ double Geocent_ep2 = 0.00673949675658690300; /* 2nd eccentricity squared */
  */
 
 
-long Set_Geocentric_Parameters (double a, 
-                                double f)
-{ /* BEGIN Set_Geocentric_Parameters */
+void Init_Geocentric_Context (Geocentric_Context *Context)
+{ /* BEGIN Init_Geocentric_Context */
+    /*
+ * The function Init_Geocentric_Context sets Context to the default
+ * ellipsoid parameters (WGS 84).
+ *
+ *    Context   : Context to initialize.                     (output)
+ */
+
+    *Context = Geocent_WGS84;
+} /* END OF Init_Geocentric_Context */
+
+
+long Set_Geocentric_Parameters_Ctx (Geocentric_Context *Context,
+                                    double a,
+                                    double f)
+{ /* BEGIN Set_Geocentric_Parameters_Ctx */
     /*
  * The function Set_Geocentric_Parameters receives the ellipsoid parameters
  * as inputs and sets the corresponding state variables.
@@ -139,18 +158,19 @@ long Set_Geocentric_Parameters (double a,
     }
     if (!Error_Code)
     {
-        Geocent_a = a;
-        Geocent_f = f;
-        Geocent_e2 = 2 * Geocent_f - Geocent_f * Geocent_f;
-        Geocent_ep2 = (1 / (1 - Geocent_e2)) - 1;
+        Context->a = a;
+        Context->f = f;
+        Context->e2 = 2 * Context->f - Context->f * Context->f;
+        Context->ep2 = (1 / (1 - Context->e2)) - 1;
     }
     return (Error_Code);
-} /* END OF Set_Geocentric_Parameters */
+} /* END OF Set_Geocentric_Parameters_Ctx */
 
 
-void Get_Geocentric_Parameters (double *a, 
-                                double *f)
-{ /* BEGIN Get_Geocentric_Parameters */
+void Get_Geocentric_Parameters_Ctx (const Geocentric_Context *Context,
+                                    double *a,
+                                    double *f)
+{ /* BEGIN Get_Geocentric_Parameters_Ctx */
     /*
  * The function Get_Geocentric_Parameters returns the ellipsoid parameters
  * to be used in geocentric coordinate conversions.
@@ -159,18 +179,19 @@ void Get_Geocentric_Parameters (double *a,
  *    f  : Flattening of ellipsoid.						               (output)
  */
 
-    *a = Geocent_a;
-    *f = Geocent_f;
-} /* END OF Get_Geocentric_Parameters */
+    *a = Context->a;
+    *f = Context->f;
+} /* END OF Get_Geocentric_Parameters_Ctx */
 
 
-long Convert_Geodetic_To_Geocentric (double Latitude,
-                                     double Longitude,
-                                     double Height,
-                                     double *X,
-                                     double *Y,
-                                     double *Z)
-{ /* BEGIN Convert_Geodetic_To_Geocentric */
+long Convert_Geodetic_To_Geocentric_Ctx (const Geocentric_Context *Context,
+                                         double Latitude,
+                                         double Longitude,
+                                         double Height,
+                                         double *X,
+                                         double *Y,
+                                         double *Z)
+{ /* BEGIN Convert_Geodetic_To_Geocentric_Ctx */
     /*
  * The function Convert_Geodetic_To_Geocentric converts geodetic coordinates
  * (latitude, longitude, and height) to geocentric coordinates (X, Y, Z),
@@ -205,23 +226,24 @@ long Convert_Geodetic_To_Geocentric (double Latitude,
         Sin_Lat = sin(Latitude);
         Cos_Lat = cos(Latitude);
         Sin2_Lat = Sin_Lat * Sin_Lat;
-        Rn = Geocent_a / (sqrt(1.0e0 - Geocent_e2 * Sin2_Lat));
+        Rn = Context->a / (sqrt(1.0e0 - Context->e2 * Sin2_Lat));
         *X = (Rn + Height) * Cos_Lat * cos(Longitude);
         *Y = (Rn + Height) * Cos_Lat * sin(Longitude);
-        *Z = ((Rn * (1 - Geocent_e2)) + Height) * Sin_Lat;
+        *Z = ((Rn * (1 - Context->e2)) + Height) * Sin_Lat;
 
     }
     return (Error_Code);
-} /* END OF Convert_Geodetic_To_Geocentric */
+} /* END OF Convert_Geodetic_To_Geocentric_Ctx */
 
 
-void Convert_Geocentric_To_Geodetic (double X,
-                                     double Y,
-                                     double Z,
-                                     double *Latitude,
-                                     double *Longitude,
-                                     double *Height)
-{ /* BEGIN Convert_Geocentric_To_Geodetic */
+void Convert_Geocentric_To_Geodetic_Ctx (const Geocentric_Context *Context,
+                                         double X,
+                                         double Y,
+                                         double Z,
+                                         double *Latitude,
+                                         double *Longitude,
+                                         double *Height)
+{ /* BEGIN Convert_Geocentric_To_Geodetic_Ctx */
     /*
  * The function Convert_Geocentric_To_Geodetic converts geocentric
  * coordinates (X, Y, Z) to geodetic coordinates (latitude, longitude,
@@ -254,7 +276,7 @@ void Convert_Geocentric_To_Geodetic (double X,
     double Rn;       /* Earth radius at location */
     double Sum;      /* numerator of cos(phi1) */
     int At_Pole;     /* indicates location is in polar region */
-    double Geocent_b = Geocent_a * (1 - Geocent_f); /* Semi-minor axis of ellipsoid, in meters */
+    double Geocent_b = Context->a * (1 - Context->f); /* Semi-minor axis of ellipsoid, in meters */
 
     At_Pole = FALSE;
     if (X != 0.0)
@@ -298,12 +320,12 @@ void Convert_Geocentric_To_Geodetic (double X,
     Sin_B0 = T0 / S0;
     Cos_B0 = W / S0;
     Sin3_B0 = Sin_B0 * Sin_B0 * Sin_B0;
-    T1 = Z + Geocent_b * Geocent_ep2 * Sin3_B0;
-    Sum = W - Geocent_a * Geocent_e2 * Cos_B0 * Cos_B0 * Cos_B0;
+    T1 = Z + Geocent_b * Context->ep2 * Sin3_B0;
+    Sum = W - Context->a * Context->e2 * Cos_B0 * Cos_B0 * Cos_B0;
     S1 = sqrt(T1*T1 + Sum * Sum);
     Sin_p1 = T1 / S1;
     Cos_p1 = Sum / S1;
-    Rn = Geocent_a / sqrt(1.0 - Geocent_e2 * Sin_p1 * Sin_p1);
+    Rn = Context->a / sqrt(1.0 - Context->e2 * Sin_p1 * Sin_p1);
     if (Cos_p1 >= COS_67P5)
     {
         *Height = W / Cos_p1 - Rn;
@@ -314,10 +336,52 @@ void Convert_Geocentric_To_Geodetic (double X,
     }
     else
     {
-        *Height = Z / Sin_p1 + Rn * (Geocent_e2 - 1.0);
+        *Height = Z / Sin_p1 + Rn * (Context->e2 - 1.0);
     }
     if (At_Pole == FALSE)
     {
         *Latitude = atan(Sin_p1 / Cos_p1);
     }
+} /* END OF Convert_Geocentric_To_Geodetic_Ctx */
+
+
+/***************************************************************************/
+/*
+ *                    FUNCTIONS USING THE DEFAULT CONTEXT
+ */
+
+
+long Set_Geocentric_Parameters (double a,
+                                double f)
+{ /* BEGIN Set_Geocentric_Parameters */
+    return Set_Geocentric_Parameters_Ctx (&Geocent_Default, a, f);
+} /* END OF Set_Geocentric_Parameters */
+
+
+void Get_Geocentric_Parameters (double *a,
+                                double *f)
+{ /* BEGIN Get_Geocentric_Parameters */
+    Get_Geocentric_Parameters_Ctx (&Geocent_Default, a, f);
+} /* END OF Get_Geocentric_Parameters */
+
+
+long Convert_Geodetic_To_Geocentric (double Latitude,
+                                     double Longitude,
+                                     double Height,
+                                     double *X,
+                                     double *Y,
+                                     double *Z)
+{ /* BEGIN Convert_Geodetic_To_Geocentric */
+    return Convert_Geodetic_To_Geocentric_Ctx (&Geocent_Default, Latitude, Longitude, Height, X, Y, Z);
+} /* END OF Convert_Geodetic_To_Geocentric */
+
+
+void Convert_Geocentric_To_Geodetic (double X,
+                                     double Y,
+                                     double Z,
+                                     double *Latitude,
+                                     double *Longitude,
+                                     double *Height)
+{ /* BEGIN Convert_Geocentric_To_Geodetic */
+    Convert_Geocentric_To_Geodetic_Ctx (&Geocent_Default, X, Y, Z, Latitude, Longitude, Height);
 } /* END OF Convert_Geocentric_To_Geodetic */
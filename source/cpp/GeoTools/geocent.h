@@ -84,6 +84,25 @@
 #define GEOCENT_INV_F_ERROR     0x0008
 
 
+/***************************************************************************/
+/*
+ *                              TYPES
+ */
+
+/*
+ * Geocentric_Context holds the ellipsoid parameters of geocentric
+ * conversions.  Conversions only read their context : threads may share
+ * one, or each use their own with a different ellipsoid.
+ */
+typedef struct Geocentric_Context_Value
+{
+  double a;               /* Semi-major axis of ellipsoid in meters */
+  double f;               /* Flattening of ellipsoid */
+  double e2;              /* Eccentricity squared */
+  double ep2;             /* 2nd eccentricity squared */
+} Geocentric_Context;
+
+
 /***************************************************************************/
 /*
  *                              FUNCTION PROTOTYPES
@@ -158,6 +177,48 @@ void QTPLUSSHARED_EXPORT Convert_Geocentric_To_Geodetic (double X,
  */
 
 
+/*
+ * The functions below are the re-entrant versions of the functions above :
+ * they use the state variables of Context instead of the default ones, which
+ * are only changed by Set_Geocentric_Parameters.
+ */
+
+void QTPLUSSHARED_EXPORT Init_Geocentric_Context (Geocentric_Context *Context);
+/*
+ * The function Init_Geocentric_Context sets Context to the default
+ * ellipsoid parameters (WGS 84).
+ *    Context   : Context to initialize.                     (output)
+ */
+
+
+long QTPLUSSHARED_EXPORT Set_Geocentric_Parameters_Ctx (Geocentric_Context *Context,
+                                                         double a,
+                                                         double f);
+
+
+void QTPLUSSHARED_EXPORT Get_Geocentric_Parameters_Ctx (const Geocentric_Context *Context,
+                                                         double *a,
+                                                         double *f);
+
+
+long QTPLUSSHARED_EXPORT Convert_Geodetic_To_Geocentric_Ctx (const Geocentric_Context *Context,
+                                                              double Latitude,
+                                                              double Longitude,
+                                                              double Height,
+                                                              double *X,
+                                                              double *Y,
+                                                              double *Z);
+
+
+void QTPLUSSHARED_EXPORT Convert_Geocentric_To_Geodetic_Ctx (const Geocentric_Context *Context,
+                                                              double X,
+                                                              double Y,
+                                                              double Z,
+                                                              double *Latitude,
+                                                              double *Longitude,
+                                                              double *Height);
+
+
 #ifdef __cplusplus
 }
 #endif
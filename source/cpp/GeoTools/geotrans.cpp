@@ -8,10 +8,16 @@
 #include "geotrans.h"
 
 #include <vector>
+#include <functional>
+#include <memory>
 #include <float.h>
 #include <limits>
 #include <string.h>
 
+#include <QFile>
+#include <QThreadPool>
+#include <QRunnable>
+
 #ifndef WIN32
 #include <cstdio>
 #endif
@@ -20,6 +26,7 @@
 #include "geocent.h"
 #include "coordcnv.h"
 #include "mgrs.h"
+#include "wmm.h"
 
 using namespace std;
 
@@ -32,6 +39,74 @@ const double GeoTrans::TWO_PI = 2.0 * PI;
 const double GeoTrans::HALF_PI = 0.5 * PI;
 const double GeoTrans::fDeg2Rad = PI / 180.0;
 const double GeoTrans::fRad2Deg = 180.0 / PI;
+const long GeoTrans::BatchChunkSize = 4096;
+
+//-------------------------------------------------------------------------------------------------
+
+//! Converts a range of a batch on a thread of the pool
+class GeoBatchChunk : public QRunnable
+{
+public:
+
+    GeoBatchChunk(const std::function<long(long, long)>& fConvert, long lStart, long lCount, long* pResult)
+        : m_fConvert(fConvert)
+        , m_lStart(lStart)
+        , m_lCount(lCount)
+        , m_pResult(pResult)
+    {
+    }
+
+    virtual void run() Q_DECL_OVERRIDE
+    {
+        *m_pResult = m_fConvert(m_lStart, m_lCount);
+    }
+
+protected:
+
+    const std::function<long(long, long)>&  m_fConvert;
+    long                                    m_lStart;
+    long                                    m_lCount;
+    long*                                   m_pResult;
+};
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Calls \a fConvert on ranges of \a lCount points, on up to \a iMaxThreads threads,
+    and returns the OR of the error codes of all ranges.
+*/
+static long runBatch(long lCount, int iMaxThreads, const std::function<long(long, long)>& fConvert)
+{
+        long lChunks = (lCount + GeoTrans::BatchChunkSize - 1) / GeoTrans::BatchChunkSize;
+
+        if (lChunks > iMaxThreads)
+                lChunks = iMaxThreads;
+
+        if (lChunks <= 1)
+                return fConvert(0, lCount);
+
+        std::vector<long> vResults(lChunks, 0);
+        QThreadPool tThreadPool;
+        tThreadPool.setMaxThreadCount(lChunks);
+
+        long lStart = 0;
+
+        for (long lChunk = 0; lChunk < lChunks; lChunk++)
+        {
+                long lEnd = (lCount * (lChunk + 1)) / lChunks;
+                tThreadPool.start(new GeoBatchChunk(fConvert, lStart, lEnd - lStart, &vResults[lChunk]));
+                lStart = lEnd;
+        }
+
+        tThreadPool.waitForDone();
+
+        long lErrors = 0;
+
+        for (long lResult : vResults)
+                lErrors |= lResult;
+
+        return lErrors;
+}
 
 //-------------------------------------------------------------------------------------------------
 
@@ -124,6 +199,137 @@ long GeoTrans::Convert_Geodetic_To_MGRS (double Latitude, double Longitude, long
 
 //-------------------------------------------------------------------------------------------------
 
+long GeoTrans::Convert_Geodetic_To_UTM_Batch (long Count, const double* Latitudes, const double* Longitudes, long* Zones, char* Hemispheres, double* Eastings, double* Northings, long* Error_Codes, int iMaxThreads)
+{
+        UTM_Context tParameters;
+        std::unique_ptr<UTM_Zone_Cache> pCache(new UTM_Zone_Cache);
+
+        Get_UTM_Parameters(&tParameters.a, &tParameters.f, &tParameters.Override);
+
+        long lErrors = Init_UTM_Zone_Cache(pCache.get(), &tParameters);
+
+        if (lErrors)
+                return lErrors;
+
+        return runBatch(Count, iMaxThreads, [&](long lStart, long lCount)
+        {
+                return ::Convert_Geodetic_To_UTM_Batch(pCache.get(), lCount, Latitudes + lStart, Longitudes + lStart,
+                                                       Zones + lStart, Hemispheres + lStart, Eastings + lStart, Northings + lStart,
+                                                       Error_Codes ? Error_Codes + lStart : nullptr);
+        });
+}
+
+//-------------------------------------------------------------------------------------------------
+
+long GeoTrans::Convert_UTM_To_Geodetic_Batch (long Count, const long* Zones, const char* Hemispheres, const double* Eastings, const double* Northings, double* Latitudes, double* Longitudes, long* Error_Codes, int iMaxThreads)
+{
+        UTM_Context tParameters;
+        std::unique_ptr<UTM_Zone_Cache> pCache(new UTM_Zone_Cache);
+
+        Get_UTM_Parameters(&tParameters.a, &tParameters.f, &tParameters.Override);
+
+        long lErrors = Init_UTM_Zone_Cache(pCache.get(), &tParameters);
+
+        if (lErrors)
+                return lErrors;
+
+        return runBatch(Count, iMaxThreads, [&](long lStart, long lCount)
+        {
+                return ::Convert_UTM_To_Geodetic_Batch(pCache.get(), lCount, Zones + lStart, Hemispheres + lStart,
+                                                       Eastings + lStart, Northings + lStart, Latitudes + lStart, Longitudes + lStart,
+                                                       Error_Codes ? Error_Codes + lStart : nullptr);
+        });
+}
+
+//-------------------------------------------------------------------------------------------------
+
+long GeoTrans::Convert_Geodetic_To_MGRS_Batch (long Count, const double* Latitudes, const double* Longitudes, long Precision, char* MGRS, long* Error_Codes, int iMaxThreads)
+{
+        MGRS_Context tParameters;
+        std::unique_ptr<MGRS_Zone_Cache> pCache(new MGRS_Zone_Cache);
+
+        Get_MGRS_Parameters(&tParameters.a, &tParameters.f, tParameters.Ellipsoid_Code);
+
+        long lErrors = Init_MGRS_Zone_Cache(pCache.get(), &tParameters);
+
+        if (lErrors)
+                return lErrors;
+
+        return runBatch(Count, iMaxThreads, [&](long lStart, long lCount)
+        {
+                return ::Convert_Geodetic_To_MGRS_Batch(pCache.get(), lCount, Latitudes + lStart, Longitudes + lStart, Precision,
+                                                        MGRS + lStart * MGRS_STRING_SIZE,
+                                                        Error_Codes ? Error_Codes + lStart : nullptr);
+        });
+}
+
+//-------------------------------------------------------------------------------------------------
+
+long GeoTrans::Convert_MGRS_To_Geodetic_Batch (long Count, const char* MGRS, double* Latitudes, double* Longitudes, long* Error_Codes, int iMaxThreads)
+{
+        MGRS_Context tParameters;
+        std::unique_ptr<MGRS_Zone_Cache> pCache(new MGRS_Zone_Cache);
+
+        Get_MGRS_Parameters(&tParameters.a, &tParameters.f, tParameters.Ellipsoid_Code);
+
+        long lErrors = Init_MGRS_Zone_Cache(pCache.get(), &tParameters);
+
+        if (lErrors)
+                return lErrors;
+
+        return runBatch(Count, iMaxThreads, [&](long lStart, long lCount)
+        {
+                return ::Convert_MGRS_To_Geodetic_Batch(pCache.get(), lCount, MGRS + lStart * MGRS_STRING_SIZE,
+                                                        Latitudes + lStart, Longitudes + lStart,
+                                                        Error_Codes ? Error_Codes + lStart : nullptr);
+        });
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the World Magnetic Model of the resource :/WMM.COF, read on first use, or nullptr if it can't be read.
+*/
+static const WMM_Model* bundledMagneticModel()
+{
+        static WMM_Model tModel;
+        static const long lError = []()
+        {
+                QFile file(":/WMM.COF");
+
+                if (file.open(QIODevice::ReadOnly) == false)
+                        return long(WMM_FILE_ERROR);
+
+                QByteArray baText = file.readAll();
+                return Parse_WMM_Coefficients(&tModel, baText.constData());
+        }();
+
+        return lError ? nullptr : &tModel;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+long GeoTrans::Compute_Magnetic_Declination (double Latitude, double Longitude, double Height, double Decimal_Year, double* Declination, double* Inclination)
+{
+        const WMM_Model* pModel = bundledMagneticModel();
+
+        if (pModel == nullptr)
+                return WMM_FILE_ERROR;
+
+        WMM_Field tField;
+        long lErrors = Compute_WMM_Field(pModel, Latitude, Longitude, Height, Decimal_Year, &tField);
+
+        if ((lErrors & ~WMM_DATE_WARNING) == 0)
+        {
+                *Declination = tField.Declination;
+                *Inclination = tField.Inclination;
+        }
+
+        return lErrors;
+}
+
+//-------------------------------------------------------------------------------------------------
+
 void GeoTrans::DegreeToDegMinSec(double Degree, int* Deg, int* Min, int* Sec)
 {
         *Deg = (int) Degree;
@@ -26,6 +26,19 @@ public:
         static long Convert_UTM_To_Geodetic(long Zone, char Hemisphere, double Easting, double Northing, double *Latitude, double *Longitude);
         static long Convert_Geodetic_To_MGRS (double Latitude, double Longitude, long Precision, char* MGRS);
 
+        // Batch conversions, with the current parameters of the UTM and MGRS modules.
+        // The zone projections are set up once per call. Batches of at least
+        // BatchChunkSize points are split among up to iMaxThreads threads.
+        // Error_Codes may be NULL, the codes of all points are OR'ed in the result.
+        static long Convert_Geodetic_To_UTM_Batch (long Count, const double* Latitudes, const double* Longitudes, long* Zones, char* Hemispheres, double* Eastings, double* Northings, long* Error_Codes = nullptr, int iMaxThreads = 1);
+        static long Convert_UTM_To_Geodetic_Batch (long Count, const long* Zones, const char* Hemispheres, const double* Eastings, const double* Northings, double* Latitudes, double* Longitudes, long* Error_Codes = nullptr, int iMaxThreads = 1);
+        static long Convert_Geodetic_To_MGRS_Batch (long Count, const double* Latitudes, const double* Longitudes, long Precision, char* MGRS, long* Error_Codes = nullptr, int iMaxThreads = 1);
+        static long Convert_MGRS_To_Geodetic_Batch (long Count, const char* MGRS, double* Latitudes, double* Longitudes, long* Error_Codes = nullptr, int iMaxThreads = 1);
+
+        // Magnetic declination and inclination in radians, with the World Magnetic Model bundled
+        // as the resource :/WMM.COF. Height is above the WGS 84 ellipsoid, in meters.
+        static long Compute_Magnetic_Declination (double Latitude, double Longitude, double Height, double Decimal_Year, double* Declination, double* Inclination);
+
         static void DegreeToDegMinSec (double Degree, int* Deg, int* Min, int* Sec);
 
 public:
@@ -37,6 +50,7 @@ public:
     static const double HALF_PI;
         static const double fDeg2Rad;
         static const double fRad2Deg;
+        static const long BatchChunkSize;
 };
 
 #endif // _GEOTRANS_H_
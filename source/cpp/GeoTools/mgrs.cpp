@@ -152,9 +152,15 @@
 
 
 /* Ellipsoid parameters, default to WGS 84 */
-double MGRS_a = 6378137.0;    /* Semi-major axis of ellipsoid in meters */
-double MGRS_f = 1 / 298.257223563; /* Flattening of ellipsoid           */
-char   MGRS_Ellipsoid_Code[3] = {'W','E',0};
+#define MGRS_DEFAULT_CONTEXT { \
+  6378137.0,          /* Semi-major axis of ellipsoid in meters */ \
+  1 / 298.257223563,  /* Flattening of ellipsoid                */ \
+  {'W','E',0} }       /* 2-letter code for ellipsoid            */
+
+static const MGRS_Context MGRS_WGS84 = MGRS_DEFAULT_CONTEXT;
+
+/* Context of the functions that do not take one */
+static MGRS_Context MGRS_Default = MGRS_DEFAULT_CONTEXT;
 
 
 /* 
@@ -517,7 +523,8 @@ long Break_MGRS_String (char* MGRS,
 } /* Break_MGRS_String */
 
 
-void Get_Grid_Values (long zone, 
+void Get_Grid_Values (const MGRS_Context *Context,
+                      long zone,
                       long* ltr2_low_value, 
                       long* ltr2_high_value, 
                       double *false_northing)
@@ -528,6 +535,7 @@ void Get_Grid_Values (long zone,
  * value of A for the second letter of the grid square, based on 
  * the grid pattern and set number of the utm zone.
  *
+ *    Context         : Ellipsoid parameters    (input)
  *    zone            : Zone number             (input)
  *    ltr2_low_value  : 2nd letter low number   (output)
  *    ltr2_high_value : 2nd letter high number  (output)
@@ -542,8 +550,8 @@ void Get_Grid_Values (long zone,
   if (!set_number)
     set_number = 6;
 
-  if (!strcmp(MGRS_Ellipsoid_Code,CLARKE_1866) || !strcmp(MGRS_Ellipsoid_Code, CLARKE_1880) || 
-      !strcmp(MGRS_Ellipsoid_Code,BESSEL_1841) || !strcmp(MGRS_Ellipsoid_Code,BESSEL_1841_NAMIBIA))
+  if (!strcmp(Context->Ellipsoid_Code,CLARKE_1866) || !strcmp(Context->Ellipsoid_Code, CLARKE_1880) || 
+      !strcmp(Context->Ellipsoid_Code,BESSEL_1841) || !strcmp(Context->Ellipsoid_Code,BESSEL_1841_NAMIBIA))
     aa_pattern = FALSE;
   else
     aa_pattern = TRUE;
@@ -582,7 +590,8 @@ void Get_Grid_Values (long zone,
 } /* END OF Get_Grid_Values */
 
 
-long UTM_To_MGRS (long Zone,
+long UTM_To_MGRS (const MGRS_Context *Context,
+                  long Zone,
                   double Latitude,
                   double Easting,
                   double Northing,
@@ -592,6 +601,7 @@ long UTM_To_MGRS (long Zone,
  * The function UTM_To_MGRS calculates an MGRS coordinate string
  * based on the zone, latitude, easting and northing.
  *
+ *    Context   : Ellipsoid parameters    (input)
  *    Zone      : Zone number             (input)
  *    Latitude  : Latitude in radians     (input)
  *    Easting   : Easting                 (input)
@@ -620,7 +630,7 @@ long UTM_To_MGRS (long Zone,
     Northing = 0.0;
   }
 
-  Get_Grid_Values(Zone, &ltr2_low_value, &ltr2_high_value, &false_northing);
+  Get_Grid_Values(Context, Zone, &ltr2_low_value, &ltr2_high_value, &false_northing);
 
   error_code = Get_Latitude_Letter(Latitude, &letters[0]);
    
@@ -658,9 +668,22 @@ long UTM_To_MGRS (long Zone,
 } /* END UTM_To_MGRS */
 
 
-long Set_MGRS_Parameters (double a,
-                          double f,
-                          char   *Ellipsoid_Code)
+void Init_MGRS_Context (MGRS_Context *Context)
+/*
+ * The function Init_MGRS_Context sets Context to the default ellipsoid
+ * parameters (WGS 84).
+ *
+ *   Context          : Context to initialize                   (output)
+ */
+{ /* Init_MGRS_Context */
+  *Context = MGRS_WGS84;
+} /* Init_MGRS_Context */
+
+
+long Set_MGRS_Parameters_Ctx (MGRS_Context *Context,
+                              double a,
+                              double f,
+                              char   *Ellipsoid_Code)
 /*
  * The function SET_MGRS_PARAMETERS receives the ellipsoid parameters and sets
  * the corresponding state variables. If any errors occur, the error code(s)
@@ -670,7 +693,7 @@ long Set_MGRS_Parameters (double a,
  *   f                : Flattening of ellipsoid					        (input)
  *   Ellipsoid_Code   : 2-letter code for ellipsoid             (input)
  */
-{ /* Set_MGRS_Parameters  */
+{ /* Set_MGRS_Parameters_Ctx  */
 
   double inv_f = 1 / f;
   long Error_Code = MGRS_NO_ERROR;
@@ -685,17 +708,18 @@ long Set_MGRS_Parameters (double a,
   }
   if (!Error_Code)
   { /* no errors */
-    MGRS_a = a;
-    MGRS_f = f;
-    strcpy (MGRS_Ellipsoid_Code, Ellipsoid_Code);
+    Context->a = a;
+    Context->f = f;
+    strcpy (Context->Ellipsoid_Code, Ellipsoid_Code);
   }
   return (Error_Code);
-}  /* Set_MGRS_Parameters  */
+}  /* Set_MGRS_Parameters_Ctx  */
 
 
-void Get_MGRS_Parameters (double *a,
-                          double *f,
-                          char* Ellipsoid_Code)
+void Get_MGRS_Parameters_Ctx (const MGRS_Context *Context,
+                              double *a,
+                              double *f,
+                              char* Ellipsoid_Code)
 /*
  * The function Get_MGRS_Parameters returns the current ellipsoid
  * parameters.
@@ -704,31 +728,36 @@ void Get_MGRS_Parameters (double *a,
  *  f                : Flattening of ellipsoid					       (output)
  *  Ellipsoid_Code   : 2-letter code for ellipsoid             (output)
  */
-{ /* Get_MGRS_Parameters */
-  *a = MGRS_a;
-  *f = MGRS_f;
-  strcpy (Ellipsoid_Code, MGRS_Ellipsoid_Code);
+{ /* Get_MGRS_Parameters_Ctx */
+  *a = Context->a;
+  *f = Context->f;
+  strcpy (Ellipsoid_Code, Context->Ellipsoid_Code);
   return;
-} /* Get_MGRS_Parameters */
+} /* Get_MGRS_Parameters_Ctx */
 
 
-long Convert_Geodetic_To_MGRS (double Latitude,
-                               double Longitude,
-                               long Precision,
-                               char* MGRS)
+static long MGRS_To_UTM (const MGRS_Context *Context,
+                         const UTM_Zone_Cache *Cache,
+                         char   *MGRS,
+                         long   *Zone,
+                         char   *Hemisphere,
+                         double *Easting,
+                         double *Northing);
+
+
+static long Geodetic_To_MGRS (const MGRS_Context *Context,
+                              const UTM_Zone_Cache *Cache,
+                              double Latitude,
+                              double Longitude,
+                              long Precision,
+                              char* MGRS)
 /*
- * The function Convert_Geodetic_To_MGRS converts Geodetic (latitude and
- * longitude) coordinates to an MGRS coordinate string, according to the 
- * current ellipsoid parameters.  If any errors occur, the error code(s) 
- * are returned by the function, otherwise MGRS_NO_ERROR is returned.
- *
- *    Latitude   : Latitude in radians              (input)
- *    Longitude  : Longitude in radians             (input)
- *    Precision  : Precision level of MGRS string   (input)
- *    MGRS       : MGRS coordinate string           (output)
- *  
+ * The function Geodetic_To_MGRS is Convert_Geodetic_To_MGRS_Ctx.  When Cache
+ * is not NULL, UTM conversions use its zone projections.
  */
-{ /* Convert_Geodetic_To_MGRS */
+{ /* Geodetic_To_MGRS */
+  UTM_Context UTM_Params;
+  UPS_Context UPS_Params;
   long zone;
   char hemisphere;
   double easting;
@@ -752,10 +781,10 @@ long Convert_Geodetic_To_MGRS (double Latitude,
   {
     if ((Latitude < MIN_UTM_LAT) || (Latitude > MAX_UTM_LAT))
     {
-      temp_error_code = Set_UPS_Parameters (MGRS_a, MGRS_f);
+      temp_error_code = Set_UPS_Parameters_Ctx (&UPS_Params, Context->a, Context->f);
       if(!temp_error_code)
       {
-        temp_error_code = Convert_Geodetic_To_UPS (Latitude, Longitude, &hemisphere, &easting, &northing);
+        temp_error_code = Convert_Geodetic_To_UPS_Ctx (&UPS_Params, Latitude, Longitude, &hemisphere, &easting, &northing);
         if(!temp_error_code)
         {
           error_code |= Convert_UPS_To_MGRS (hemisphere, easting, northing, Precision, MGRS);
@@ -778,10 +807,13 @@ long Convert_Geodetic_To_MGRS (double Latitude,
     }
     else
     {
-      temp_error_code = Set_UTM_Parameters (MGRS_a, MGRS_f, 0);
+      temp_error_code = Set_UTM_Parameters_Ctx (&UTM_Params, Context->a, Context->f, 0);
       if(!temp_error_code)
       {
-        temp_error_code = Convert_Geodetic_To_UTM (Latitude, Longitude, &zone, &hemisphere, &easting, &northing);
+        if (Cache)
+          temp_error_code = Convert_Geodetic_To_UTM_Cached (Cache, Latitude, Longitude, &zone, &hemisphere, &easting, &northing);
+        else
+          temp_error_code = Convert_Geodetic_To_UTM_Ctx (&UTM_Params, Latitude, Longitude, &zone, &hemisphere, &easting, &northing);
         if(!temp_error_code)
         {
 	        divisor = pow (10.0, (5 - Precision));
@@ -790,8 +822,8 @@ long Convert_Geodetic_To_MGRS (double Latitude,
 	        /* Special check for rounding to (truncated) eastern edge of zone 31V */
 	        if ((zone == 31) && (((Latitude >= 56.0 * DEG_TO_RAD) && (Latitude < 64.0 * DEG_TO_RAD)) && ((Longitude >= 3.0 * DEG_TO_RAD) || (rounded_easting >= 500000.0))))
 	        { /* Reconvert to UTM zone 32 */
-            Set_UTM_Parameters (MGRS_a, MGRS_f, 32);
-            temp_error_code = Convert_Geodetic_To_UTM (Latitude, Longitude, &zone, &hemisphere, &easting, &northing);
+            Set_UTM_Parameters_Ctx (&UTM_Params, Context->a, Context->f, 32);
+            temp_error_code = Convert_Geodetic_To_UTM_Ctx (&UTM_Params, Latitude, Longitude, &zone, &hemisphere, &easting, &northing);
             if(temp_error_code)
             {
               if(temp_error_code & UTM_LAT_ERROR)
@@ -807,7 +839,7 @@ long Convert_Geodetic_To_MGRS (double Latitude,
             }
 	        }
 
-          error_code |= UTM_To_MGRS (zone, Latitude, easting, northing, Precision, MGRS);
+          error_code |= UTM_To_MGRS (Context, zone, Latitude, easting, northing, Precision, MGRS);
         }
         else
         {
@@ -835,25 +867,21 @@ long Convert_Geodetic_To_MGRS (double Latitude,
     }
   }
   return (error_code);
-} /* Convert_Geodetic_To_MGRS */
+} /* Geodetic_To_MGRS */
 
 
-long Convert_MGRS_To_Geodetic (char* MGRS, 
-                               double *Latitude, 
-                               double *Longitude)
+static long MGRS_To_Geodetic (const MGRS_Context *Context,
+                              const UTM_Zone_Cache *Cache,
+                              char* MGRS,
+                              double *Latitude,
+                              double *Longitude)
 /*
- * The function Convert_MGRS_To_Geodetic converts an MGRS coordinate string
- * to Geodetic (latitude and longitude) coordinates 
- * according to the current ellipsoid parameters.  If any errors occur, 
- * the error code(s) are returned by the function, otherwise UTM_NO_ERROR 
- * is returned.
- *
- *    MGRS       : MGRS coordinate string           (input)
- *    Latitude   : Latitude in radians              (output)
- *    Longitude  : Longitude in radians             (output)
- *  
+ * The function MGRS_To_Geodetic is Convert_MGRS_To_Geodetic_Ctx.  When Cache
+ * is not NULL, UTM conversions use its zone projections.
  */
-{ /* Convert_MGRS_To_Geodetic */
+{ /* MGRS_To_Geodetic */
+  UTM_Context UTM_Params;
+  UPS_Context UPS_Params;
   long zone;
   char hemisphere;
   double easting;
@@ -866,13 +894,16 @@ long Convert_MGRS_To_Geodetic (char* MGRS,
   if (!error_code)
     if (zone_exists)
     {
-      error_code |= Convert_MGRS_To_UTM (MGRS, &zone, &hemisphere, &easting, &northing);
+      error_code |= MGRS_To_UTM (Context, Cache, MGRS, &zone, &hemisphere, &easting, &northing);
       if(!error_code || (error_code & MGRS_LAT_WARNING))
       {
-        temp_error_code = Set_UTM_Parameters (MGRS_a, MGRS_f, 0);
+        temp_error_code = Set_UTM_Parameters_Ctx (&UTM_Params, Context->a, Context->f, 0);
         if(!temp_error_code)
         {
-          temp_error_code = Convert_UTM_To_Geodetic (zone, hemisphere, easting, northing, Latitude, Longitude);
+          if (Cache)
+            temp_error_code = Convert_UTM_To_Geodetic_Cached (Cache, zone, hemisphere, easting, northing, Latitude, Longitude);
+          else
+            temp_error_code = Convert_UTM_To_Geodetic_Ctx (&UTM_Params, zone, hemisphere, easting, northing, Latitude, Longitude);
           if(temp_error_code)
           {
             if((temp_error_code & UTM_ZONE_ERROR) || (temp_error_code & UTM_HEMISPHERE_ERROR))
@@ -899,10 +930,10 @@ long Convert_MGRS_To_Geodetic (char* MGRS,
       error_code |= Convert_MGRS_To_UPS (MGRS, &hemisphere, &easting, &northing);
       if(!error_code)
       {
-        temp_error_code = Set_UPS_Parameters (MGRS_a, MGRS_f);
+        temp_error_code = Set_UPS_Parameters_Ctx (&UPS_Params, Context->a, Context->f);
         if(!temp_error_code)
         {
-          temp_error_code = Convert_UPS_To_Geodetic (hemisphere, easting, northing, Latitude, Longitude);
+          temp_error_code = Convert_UPS_To_Geodetic_Ctx (&UPS_Params, hemisphere, easting, northing, Latitude, Longitude);
           if(temp_error_code)
           {
             if(temp_error_code & UPS_HEMISPHERE_ERROR)
@@ -923,15 +954,16 @@ long Convert_MGRS_To_Geodetic (char* MGRS,
       }
     }
   return (error_code);
-} /* END OF Convert_MGRS_To_Geodetic */
+} /* END OF MGRS_To_Geodetic */
 
 
-long Convert_UTM_To_MGRS (long Zone,
-                          char Hemisphere,
-                          double Easting,
-                          double Northing,
-                          long Precision,
-                          char* MGRS)
+long Convert_UTM_To_MGRS_Ctx (const MGRS_Context *Context,
+                              long Zone,
+                              char Hemisphere,
+                              double Easting,
+                              double Northing,
+                              long Precision,
+                              char* MGRS)
 /*
  * The function Convert_UTM_To_MGRS converts UTM (zone, easting, and
  * northing) coordinates to an MGRS coordinate string, according to the 
@@ -945,7 +977,8 @@ long Convert_UTM_To_MGRS (long Zone,
  *    Precision  : Precision level of MGRS string   (input)
  *    MGRS       : MGRS coordinate string           (output)
  */
-{ /* Convert_UTM_To_MGRS */
+{ /* Convert_UTM_To_MGRS_Ctx */
+  UTM_Context UTM_Params;
   double latitude;           /* Latitude of UTM point */
   double longitude;          /* Longitude of UTM point */
   double divisor;
@@ -965,8 +998,8 @@ long Convert_UTM_To_MGRS (long Zone,
     error_code |= MGRS_PRECISION_ERROR;
   if (!error_code)
   {
-    Set_UTM_Parameters (MGRS_a, MGRS_f, 0);
-    utm_error_code = Convert_UTM_To_Geodetic (Zone, Hemisphere, Easting, Northing, &latitude, &longitude);
+    Set_UTM_Parameters_Ctx (&UTM_Params, Context->a, Context->f, 0);
+    utm_error_code = Convert_UTM_To_Geodetic_Ctx (&UTM_Params, Zone, Hemisphere, Easting, Northing, &latitude, &longitude);
     if(utm_error_code)
     {
       if((utm_error_code & UTM_ZONE_ERROR) || (utm_error_code & UTM_HEMISPHERE_ERROR))
@@ -983,8 +1016,8 @@ long Convert_UTM_To_MGRS (long Zone,
 	  /* Special check for rounding to (truncated) eastern edge of zone 31V */
 	  if ((Zone == 31) && (((latitude >= 56.0 * DEG_TO_RAD) && (latitude < 64.0 * DEG_TO_RAD)) && ((longitude >= 3.0 * DEG_TO_RAD) || (rounded_easting >= 500000.0))))
 	  { /* Reconvert to UTM zone 32 */
-      Set_UTM_Parameters (MGRS_a, MGRS_f, 32);
-      utm_error_code = Convert_Geodetic_To_UTM (latitude, longitude, &Zone, &Hemisphere, &Easting, &Northing);
+      Set_UTM_Parameters_Ctx (&UTM_Params, Context->a, Context->f, 32);
+      utm_error_code = Convert_Geodetic_To_UTM_Ctx (&UTM_Params, latitude, longitude, &Zone, &Hemisphere, &Easting, &Northing);
       if(utm_error_code)
       {
         if(utm_error_code & UTM_LAT_ERROR)
@@ -1000,31 +1033,25 @@ long Convert_UTM_To_MGRS (long Zone,
       }
 	  }
 
-	  error_code = UTM_To_MGRS (Zone, latitude, Easting, Northing, Precision, MGRS);
+	  error_code = UTM_To_MGRS (Context, Zone, latitude, Easting, Northing, Precision, MGRS);
   }
   return (error_code);
-} /* Convert_UTM_To_MGRS */
+} /* Convert_UTM_To_MGRS_Ctx */
 
 
-long Convert_MGRS_To_UTM (char   *MGRS,
-                          long   *Zone,
-                          char   *Hemisphere,
-                          double *Easting,
-                          double *Northing)
+static long MGRS_To_UTM (const MGRS_Context *Context,
+                         const UTM_Zone_Cache *Cache,
+                         char   *MGRS,
+                         long   *Zone,
+                         char   *Hemisphere,
+                         double *Easting,
+                         double *Northing)
 /*
- * The function Convert_MGRS_To_UTM converts an MGRS coordinate string
- * to UTM projection (zone, hemisphere, easting and northing) coordinates 
- * according to the current ellipsoid parameters.  If any errors occur, 
- * the error code(s) are returned by the function, otherwise UTM_NO_ERROR 
- * is returned.
- *
- *    MGRS       : MGRS coordinate string           (input)
- *    Zone       : UTM zone                         (output)
- *    Hemisphere : North or South hemisphere        (output)
- *    Easting    : Easting (X) in meters            (output)
- *    Northing   : Northing (Y) in meters           (output)
+ * The function MGRS_To_UTM is Convert_MGRS_To_UTM_Ctx.  When Cache is not
+ * NULL, UTM conversions use its zone projections.
  */
-{ /* Convert_MGRS_To_UTM */
+{ /* MGRS_To_UTM */
+  UTM_Context UTM_Params;
   double scaled_min_northing;
   double min_northing;
   long ltr2_low_value;
@@ -1060,7 +1087,7 @@ long Convert_MGRS_To_UTM (char   *MGRS,
         else
           *Hemisphere = 'N';
 
-        Get_Grid_Values(*Zone, &ltr2_low_value, &ltr2_high_value, &false_northing);
+        Get_Grid_Values(Context, *Zone, &ltr2_low_value, &ltr2_high_value, &false_northing);
 
         /* Check that the second letter of the MGRS string is within
          * the range of valid second letter values 
@@ -1120,10 +1147,13 @@ long Convert_MGRS_To_UTM (char   *MGRS,
             *Northing = grid_northing + *Northing;
 
             /* check that point is within Zone Letter bounds */
-            utm_error_code = Set_UTM_Parameters(MGRS_a,MGRS_f,*Zone);
+            utm_error_code = Set_UTM_Parameters_Ctx (&UTM_Params, Context->a, Context->f, *Zone);
             if (!utm_error_code)
             {
-              utm_error_code = Convert_UTM_To_Geodetic(*Zone,*Hemisphere,*Easting,*Northing,&latitude,&longitude);
+              if (Cache)
+                utm_error_code = Convert_UTM_To_Geodetic_Cached (Cache, *Zone,*Hemisphere,*Easting,*Northing,&latitude,&longitude);
+              else
+                utm_error_code = Convert_UTM_To_Geodetic_Ctx (&UTM_Params, *Zone,*Hemisphere,*Easting,*Northing,&latitude,&longitude);
               if (!utm_error_code)
               {
                 divisor = pow (10.0, in_precision);
@@ -1159,7 +1189,176 @@ long Convert_MGRS_To_UTM (char   *MGRS,
     }
   }
   return (error_code);
-} /* Convert_MGRS_To_UTM */
+} /* MGRS_To_UTM */
+
+
+long Convert_Geodetic_To_MGRS_Ctx (const MGRS_Context *Context,
+                                   double Latitude,
+                                   double Longitude,
+                                   long Precision,
+                                   char* MGRS)
+/*
+ * The function Convert_Geodetic_To_MGRS converts Geodetic (latitude and
+ * longitude) coordinates to an MGRS coordinate string, according to the 
+ * current ellipsoid parameters.  If any errors occur, the error code(s) 
+ * are returned by the function, otherwise MGRS_NO_ERROR is returned.
+ *
+ *    Latitude   : Latitude in radians              (input)
+ *    Longitude  : Longitude in radians             (input)
+ *    Precision  : Precision level of MGRS string   (input)
+ *    MGRS       : MGRS coordinate string           (output)
+ *  
+ */
+{ /* Convert_Geodetic_To_MGRS_Ctx */
+  return Geodetic_To_MGRS (Context, NULL, Latitude, Longitude, Precision, MGRS);
+} /* Convert_Geodetic_To_MGRS_Ctx */
+
+
+long Convert_MGRS_To_Geodetic_Ctx (const MGRS_Context *Context,
+                                   char* MGRS,
+                                   double *Latitude,
+                                   double *Longitude)
+/*
+ * The function Convert_MGRS_To_Geodetic converts an MGRS coordinate string
+ * to Geodetic (latitude and longitude) coordinates 
+ * according to the current ellipsoid parameters.  If any errors occur, 
+ * the error code(s) are returned by the function, otherwise UTM_NO_ERROR 
+ * is returned.
+ *
+ *    MGRS       : MGRS coordinate string           (input)
+ *    Latitude   : Latitude in radians              (output)
+ *    Longitude  : Longitude in radians             (output)
+ *  
+ */
+{ /* Convert_MGRS_To_Geodetic_Ctx */
+  return MGRS_To_Geodetic (Context, NULL, MGRS, Latitude, Longitude);
+} /* END OF Convert_MGRS_To_Geodetic_Ctx */
+
+
+long Convert_MGRS_To_UTM_Ctx (const MGRS_Context *Context,
+                              char   *MGRS,
+                              long   *Zone,
+                              char   *Hemisphere,
+                              double *Easting,
+                              double *Northing)
+/*
+ * The function Convert_MGRS_To_UTM converts an MGRS coordinate string
+ * to UTM projection (zone, hemisphere, easting and northing) coordinates 
+ * according to the current ellipsoid parameters.  If any errors occur, 
+ * the error code(s) are returned by the function, otherwise UTM_NO_ERROR 
+ * is returned.
+ *
+ *    MGRS       : MGRS coordinate string           (input)
+ *    Zone       : UTM zone                         (output)
+ *    Hemisphere : North or South hemisphere        (output)
+ *    Easting    : Easting (X) in meters            (output)
+ *    Northing   : Northing (Y) in meters           (output)
+ */
+{ /* Convert_MGRS_To_UTM_Ctx */
+  return MGRS_To_UTM (Context, NULL, MGRS, Zone, Hemisphere, Easting, Northing);
+} /* Convert_MGRS_To_UTM_Ctx */
+
+
+long Init_MGRS_Zone_Cache (MGRS_Zone_Cache *Cache,
+                           const MGRS_Context *Context)
+/*
+ * The function Init_MGRS_Zone_Cache sets up the UTM zone projections of
+ * Cache for the ellipsoid of Context.  If any errors occur, the error
+ * code(s) are returned by the function, otherwise MGRS_NO_ERROR is
+ * returned.
+ *
+ *    Cache      : Cache to initialize              (output)
+ *    Context    : Ellipsoid parameters             (input)
+ */
+{ /* Init_MGRS_Zone_Cache */
+  UTM_Context UTM_Params;
+  long temp_error_code = MGRS_NO_ERROR;
+  long error_code = MGRS_NO_ERROR;
+
+  Cache->MGRS = *Context;
+  temp_error_code = Set_UTM_Parameters_Ctx (&UTM_Params, Context->a, Context->f, 0);
+  if(!temp_error_code)
+    temp_error_code = Init_UTM_Zone_Cache (&Cache->UTM, &UTM_Params);
+  if(temp_error_code & UTM_A_ERROR)
+    error_code |= MGRS_A_ERROR;
+  if(temp_error_code & UTM_INV_F_ERROR)
+    error_code |= MGRS_INV_F_ERROR;
+  return (error_code);
+} /* Init_MGRS_Zone_Cache */
+
+
+long Convert_Geodetic_To_MGRS_Batch (const MGRS_Zone_Cache *Cache,
+                                     long Count,
+                                     const double *Latitudes,
+                                     const double *Longitudes,
+                                     long Precision,
+                                     char *MGRS,
+                                     long *Error_Codes)
+/*
+ * The function Convert_Geodetic_To_MGRS_Batch converts Count geodetic
+ * coordinates to MGRS coordinate strings, with the ellipsoid and UTM zone
+ * projections of Cache.  The error code(s) of all points are combined and
+ * returned by the function.
+ *
+ *    Cache       : Ellipsoid and zone projections   (input)
+ *    Count       : Number of points                 (input)
+ *    Latitudes   : Latitudes in radians             (input)
+ *    Longitudes  : Longitudes in radians            (input)
+ *    Precision   : Precision level of MGRS strings  (input)
+ *    MGRS        : Count strings of MGRS_STRING_SIZE characters (output)
+ *    Error_Codes : Error code(s) of each point, or NULL (output)
+ */
+{ /* Convert_Geodetic_To_MGRS_Batch */
+  long index;
+  long point_error_code;
+  long error_code = MGRS_NO_ERROR;
+
+  for (index = 0; index < Count; index++)
+  {
+    point_error_code = Geodetic_To_MGRS (&Cache->MGRS, &Cache->UTM, Latitudes[index], Longitudes[index], Precision,
+                                         &MGRS[index * MGRS_STRING_SIZE]);
+    if (Error_Codes)
+      Error_Codes[index] = point_error_code;
+    error_code |= point_error_code;
+  }
+  return (error_code);
+} /* Convert_Geodetic_To_MGRS_Batch */
+
+
+long Convert_MGRS_To_Geodetic_Batch (const MGRS_Zone_Cache *Cache,
+                                     long Count,
+                                     const char *MGRS,
+                                     double *Latitudes,
+                                     double *Longitudes,
+                                     long *Error_Codes)
+/*
+ * The function Convert_MGRS_To_Geodetic_Batch converts Count MGRS
+ * coordinate strings to geodetic coordinates, with the ellipsoid and UTM
+ * zone projections of Cache.  The error code(s) of all points are combined
+ * and returned by the function.
+ *
+ *    Cache       : Ellipsoid and zone projections   (input)
+ *    Count       : Number of points                 (input)
+ *    MGRS        : Count strings of MGRS_STRING_SIZE characters (input)
+ *    Latitudes   : Latitudes in radians             (output)
+ *    Longitudes  : Longitudes in radians            (output)
+ *    Error_Codes : Error code(s) of each point, or NULL (output)
+ */
+{ /* Convert_MGRS_To_Geodetic_Batch */
+  long index;
+  long point_error_code;
+  long error_code = MGRS_NO_ERROR;
+
+  for (index = 0; index < Count; index++)
+  {
+    point_error_code = MGRS_To_Geodetic (&Cache->MGRS, &Cache->UTM, (char *) &MGRS[index * MGRS_STRING_SIZE],
+                                         &Latitudes[index], &Longitudes[index]);
+    if (Error_Codes)
+      Error_Codes[index] = point_error_code;
+    error_code |= point_error_code;
+  }
+  return (error_code);
+} /* Convert_MGRS_To_Geodetic_Batch */
 
 
 long Convert_UPS_To_MGRS (char   Hemisphere,
@@ -1376,4 +1575,61 @@ long Convert_MGRS_To_UPS ( char   *MGRS,
 } /* Convert_MGRS_To_UPS */
 
 
+/***************************************************************************/
+/*
+ *                    FUNCTIONS USING THE DEFAULT CONTEXT
+ */
+
+
+long Set_MGRS_Parameters (double a,
+                          double f,
+                          char   *Ellipsoid_Code)
+{ /* Set_MGRS_Parameters */
+  return Set_MGRS_Parameters_Ctx (&MGRS_Default, a, f, Ellipsoid_Code);
+} /* Set_MGRS_Parameters */
+
+
+void Get_MGRS_Parameters (double *a,
+                          double *f,
+                          char* Ellipsoid_Code)
+{ /* Get_MGRS_Parameters */
+  Get_MGRS_Parameters_Ctx (&MGRS_Default, a, f, Ellipsoid_Code);
+} /* Get_MGRS_Parameters */
+
 
+long Convert_Geodetic_To_MGRS (double Latitude,
+                               double Longitude,
+                               long Precision,
+                               char* MGRS)
+{ /* Convert_Geodetic_To_MGRS */
+  return Convert_Geodetic_To_MGRS_Ctx (&MGRS_Default, Latitude, Longitude, Precision, MGRS);
+} /* Convert_Geodetic_To_MGRS */
+
+
+long Convert_MGRS_To_Geodetic (char* MGRS,
+                               double *Latitude,
+                               double *Longitude)
+{ /* Convert_MGRS_To_Geodetic */
+  return Convert_MGRS_To_Geodetic_Ctx (&MGRS_Default, MGRS, Latitude, Longitude);
+} /* Convert_MGRS_To_Geodetic */
+
+
+long Convert_UTM_To_MGRS (long Zone,
+                          char Hemisphere,
+                          double Easting,
+                          double Northing,
+                          long Precision,
+                          char* MGRS)
+{ /* Convert_UTM_To_MGRS */
+  return Convert_UTM_To_MGRS_Ctx (&MGRS_Default, Zone, Hemisphere, Easting, Northing, Precision, MGRS);
+} /* Convert_UTM_To_MGRS */
+
+
+long Convert_MGRS_To_UTM (char   *MGRS,
+                          long   *Zone,
+                          char   *Hemisphere,
+                          double *Easting,
+                          double *Northing)
+{ /* Convert_MGRS_To_UTM */
+  return Convert_MGRS_To_UTM_Ctx (&MGRS_Default, MGRS, Zone, Hemisphere, Easting, Northing);
+} /* Convert_MGRS_To_UTM */
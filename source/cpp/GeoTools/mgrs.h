@@ -2,6 +2,7 @@
 #define MGRS_H
 
 #include "../qtplus_global.h"
+#include "utm.h"
 
 /***************************************************************************/
 /* RSC IDENTIFIER:  MGRS
@@ -96,6 +97,38 @@
 #define MGRS_LAT_WARNING             0x0400
 
 #define MGRS_LETTERS            3  /* NUMBER OF LETTERS IN MGRS              */
+#define MGRS_STRING_SIZE       16  /* SIZE OF AN MGRS STRING IN BATCHES     */
+
+
+/***************************************************************************/
+/*
+ *                              TYPES
+ */
+
+/*
+ * MGRS_Context holds the ellipsoid parameters of MGRS conversions.
+ * Conversions only read their context : threads may share one, or each use
+ * their own with a different ellipsoid.
+ */
+typedef struct MGRS_Context_Value
+{
+  double a;                     /* Semi-major axis of ellipsoid in meters */
+  double f;                     /* Flattening of ellipsoid */
+  char   Ellipsoid_Code[3];     /* 2-letter code for ellipsoid */
+} MGRS_Context;
+
+/*
+ * MGRS_Zone_Cache holds an MGRS context and the UTM zone projections for its
+ * ellipsoid, for batch conversions.  Like contexts, caches are only read by
+ * conversions.
+ */
+typedef struct MGRS_Zone_Cache_Value
+{
+  MGRS_Context MGRS;            /* Parameters of the cache */
+  UTM_Zone_Cache UTM;           /* UTM zone projections */
+} MGRS_Zone_Cache;
+
+
 /***************************************************************************/
 /*
  *                              FUNCTION PROTOTYPES
@@ -263,6 +296,123 @@ long QTPLUSSHARED_EXPORT Make_MGRS_String (char* MGRS,
  *	  Precision	    : Number of digits of Easting and Northing (input)
  */
 
+/*
+ * The functions below are the re-entrant versions of the functions above :
+ * they use the state variables of Context instead of the default ones, which
+ * are only changed by Set_MGRS_Parameters.  Conversions between UPS and MGRS
+ * do not depend on the ellipsoid and are re-entrant as they are.
+ */
+
+void QTPLUSSHARED_EXPORT Init_MGRS_Context (MGRS_Context *Context);
+/*
+ * The function Init_MGRS_Context sets Context to the default ellipsoid
+ * parameters (WGS 84).
+ *
+ *   Context          : Context to initialize                   (output)
+ */
+
+
+long QTPLUSSHARED_EXPORT Set_MGRS_Parameters_Ctx(MGRS_Context *Context,
+                                                 double a,
+                                                 double f,
+                                                 char   *Ellipsoid_Code);
+
+
+void QTPLUSSHARED_EXPORT Get_MGRS_Parameters_Ctx(const MGRS_Context *Context,
+                                                 double *a,
+                                                 double *f,
+                                                 char   *Ellipsoid_Code);
+
+
+long QTPLUSSHARED_EXPORT Convert_Geodetic_To_MGRS_Ctx (const MGRS_Context *Context,
+                                                       double Latitude,
+                                                       double Longitude,
+                                                       long   Precision,
+                                                       char *MGRS);
+
+
+long QTPLUSSHARED_EXPORT Convert_MGRS_To_Geodetic_Ctx (const MGRS_Context *Context,
+                                                       char *MGRS,
+                                                       double *Latitude,
+                                                       double *Longitude);
+
+
+long QTPLUSSHARED_EXPORT Convert_UTM_To_MGRS_Ctx (const MGRS_Context *Context,
+                                                  long Zone,
+                                                  char Hemisphere,
+                                                  double Easting,
+                                                  double Northing,
+                                                  long Precision,
+                                                  char *MGRS);
+
+
+long QTPLUSSHARED_EXPORT Convert_MGRS_To_UTM_Ctx (const MGRS_Context *Context,
+                                                  char   *MGRS,
+                                                  long   *Zone,
+                                                  char   *Hemisphere,
+                                                  double *Easting,
+                                                  double *Northing);
+
+
+long QTPLUSSHARED_EXPORT Init_MGRS_Zone_Cache (MGRS_Zone_Cache *Cache,
+                                               const MGRS_Context *Context);
+/*
+ * The function Init_MGRS_Zone_Cache sets up the UTM zone projections of
+ * Cache for the ellipsoid of Context.  If any errors occur, the error
+ * code(s) are returned by the function, otherwise MGRS_NO_ERROR is
+ * returned.
+ *
+ *    Cache       : Cache to initialize                         (output)
+ *    Context     : Ellipsoid parameters                        (input)
+ */
+
+
+long QTPLUSSHARED_EXPORT Convert_Geodetic_To_MGRS_Batch (const MGRS_Zone_Cache *Cache,
+                                                         long Count,
+                                                         const double *Latitudes,
+                                                         const double *Longitudes,
+                                                         long Precision,
+                                                         char *MGRS,
+                                                         long *Error_Codes);
+/*
+ * The function Convert_Geodetic_To_MGRS_Batch converts Count geodetic
+ * coordinates to MGRS coordinate strings.  String i starts at
+ * MGRS[i * MGRS_STRING_SIZE].  The results are those of
+ * Convert_Geodetic_To_MGRS_Ctx.  The error code(s) of all points are
+ * combined and returned by the function.
+ *
+ *    Cache       : Ellipsoid and zone projections              (input)
+ *    Count       : Number of points                            (input)
+ *    Latitudes   : Latitudes in radians                        (input)
+ *    Longitudes  : Longitudes in radians                       (input)
+ *    Precision   : Precision level of MGRS strings             (input)
+ *    MGRS        : MGRS coordinate strings                     (output)
+ *    Error_Codes : Error code(s) of each point, may be NULL    (output)
+ */
+
+
+long QTPLUSSHARED_EXPORT Convert_MGRS_To_Geodetic_Batch (const MGRS_Zone_Cache *Cache,
+                                                         long Count,
+                                                         const char *MGRS,
+                                                         double *Latitudes,
+                                                         double *Longitudes,
+                                                         long *Error_Codes);
+/*
+ * The function Convert_MGRS_To_Geodetic_Batch converts Count MGRS
+ * coordinate strings, string i starting at MGRS[i * MGRS_STRING_SIZE], to
+ * geodetic coordinates.  The results are those of
+ * Convert_MGRS_To_Geodetic_Ctx.  The error code(s) of all points are
+ * combined and returned by the function.
+ *
+ *    Cache       : Ellipsoid and zone projections              (input)
+ *    Count       : Number of points                            (input)
+ *    MGRS        : MGRS coordinate strings                     (input)
+ *    Latitudes   : Latitudes in radians                        (output)
+ *    Longitudes  : Longitudes in radians                       (output)
+ *    Error_Codes : Error code(s) of each point, may be NULL    (output)
+ */
+
+
 #ifdef __cplusplus
 }
 #endif
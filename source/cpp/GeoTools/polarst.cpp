@@ -110,7 +110,7 @@
 #define PI           3.14159265358979323e0       /* PI     */
 #define PI_OVER_2    (PI / 2.0)           
 #define TWO_PI       (2.0 * PI)
-#define POLAR_POW(EsSin)     pow((1.0 - EsSin) / (1.0 + EsSin), es_OVER_2)
+#define POLAR_POW(EsSin)     pow((1.0 - EsSin) / (1.0 + EsSin), Context->es_OVER_2)
 
 /************************************************************************/
 /*                           GLOBAL DECLARATIONS
@@ -119,30 +119,32 @@
 
 const double PI_Over_4 = (PI / 4.0);
 
-/* Ellipsoid Parameters, default to WGS 84  */
-static double Polar_a = 6378137.0;                    /* Semi-major axis of ellipsoid in meters  */
-static double Polar_f = 1 / 298.257223563;            /* Flattening of ellipsoid  */
-static double es = 0.08181919084262188000;            /* Eccentricity of ellipsoid    */
-static double es_OVER_2 = .040909595421311;           /* es / 2.0 */
-static double Southern_Hemisphere = 0;                /* Flag variable */
-static double mc = 1.0;                    
-static double tc = 1.0;
-static double e4 = 1.0033565552493;
-static double Polar_a_mc = 6378137.0;                 /* Polar_a * mc */
-static double two_Polar_a = 12756274.0;               /* 2.0 * Polar_a */
-
-/* Polar Stereographic projection Parameters */
-static double Polar_Origin_Lat = ((PI * 90) / 180);   /* Latitude of origin in radians */
-static double Polar_Origin_Long = 0.0;                /* Longitude of origin in radians */
-static double Polar_False_Easting = 0.0;              /* False easting in meters */
-static double Polar_False_Northing = 0.0;             /* False northing in meters */
-
-/* Maximum variance for easting and northing values for WGS 84. */
-static double Polar_Delta_Easting = 12713601.0;
-static double Polar_Delta_Northing = 12713601.0;
-
-/* These state variables are for optimization purposes. The only function
- * that should modify them is Set_Polar_Stereographic_Parameters.         
+/* Default parameters : WGS 84 ellipsoid, origin at the north pole */
+#define POLAR_DEFAULT_CONTEXT { \
+  6378137.0,               /* a */ \
+  1 / 298.257223563,       /* f */ \
+  0.08181919084262188000,  /* es */ \
+  .040909595421311,        /* es_OVER_2 */ \
+  0,                       /* Southern_Hemisphere */ \
+  1.0,                     /* mc */ \
+  1.0,                     /* tc */ \
+  1.0033565552493,         /* e4 */ \
+  6378137.0,               /* a_mc */ \
+  12756274.0,              /* two_a */ \
+  ((PI * 90) / 180),       /* Origin_Lat */ \
+  0.0,                     /* Origin_Long */ \
+  0.0,                     /* False_Easting */ \
+  0.0,                     /* False_Northing */ \
+  12713601.0,              /* Delta_Easting */ \
+  12713601.0 }             /* Delta_Northing */
+
+static const Polar_Stereographic_Context Polar_WGS84 = POLAR_DEFAULT_CONTEXT;
+
+/* Context of the functions that do not take one */
+static Polar_Stereographic_Context Polar_Default = POLAR_DEFAULT_CONTEXT;
+
+/* The derived members of a context are for optimization purposes. The only
+ * function that should modify them is Set_Polar_Stereographic_Parameters_Ctx.
  */
 
 
@@ -152,12 +154,27 @@ static double Polar_Delta_Northing = 12713601.0;
  */
 
 
-long Set_Polar_Stereographic_Parameters (double a,
-                                         double f,
-                                         double Latitude_of_True_Scale,
-                                         double Longitude_Down_from_Pole,
-                                         double False_Easting,
-                                         double False_Northing)
+void Init_Polar_Stereographic_Context (Polar_Stereographic_Context *Context)
+{ /* BEGIN Init_Polar_Stereographic_Context */
+/*
+ * The function Init_Polar_Stereographic_Context sets Context to the default
+ * parameters : WGS 84 ellipsoid, origin at the north pole, no false easting
+ * or northing.
+ *
+ *  Context          : Context to initialize                           (output)
+ */
+
+  *Context = Polar_WGS84;
+} /* END OF Init_Polar_Stereographic_Context */
+
+
+long Set_Polar_Stereographic_Parameters_Ctx (Polar_Stereographic_Context *Context,
+                                             double a,
+                                             double f,
+                                             double Latitude_of_True_Scale,
+                                             double Longitude_Down_from_Pole,
+                                             double False_Easting,
+                                             double False_Northing)
 
 {  /* BEGIN Set_Polar_Stereographic_Parameters   */
 /*  
@@ -204,79 +221,80 @@ long Set_Polar_Stereographic_Parameters (double a,
   if (!Error_Code)
   { /* no errors */
 
-    Polar_a = a;
-    two_Polar_a = 2.0 * Polar_a;
-    Polar_f = f;
+    Context->a = a;
+    Context->two_a = 2.0 * Context->a;
+    Context->f = f;
 
     if (Longitude_Down_from_Pole > PI)
       Longitude_Down_from_Pole -= TWO_PI;
     if (Latitude_of_True_Scale < 0)
     {
-      Southern_Hemisphere = 1;
-      Polar_Origin_Lat = -Latitude_of_True_Scale;
-      Polar_Origin_Long = -Longitude_Down_from_Pole;
+      Context->Southern_Hemisphere = 1;
+      Context->Origin_Lat = -Latitude_of_True_Scale;
+      Context->Origin_Long = -Longitude_Down_from_Pole;
     }
     else
     {
-      Southern_Hemisphere = 0;
-      Polar_Origin_Lat = Latitude_of_True_Scale;
-      Polar_Origin_Long = Longitude_Down_from_Pole;
+      Context->Southern_Hemisphere = 0;
+      Context->Origin_Lat = Latitude_of_True_Scale;
+      Context->Origin_Long = Longitude_Down_from_Pole;
     }
-    Polar_False_Easting = False_Easting;
-    Polar_False_Northing = False_Northing;
+    Context->False_Easting = False_Easting;
+    Context->False_Northing = False_Northing;
 
-    es2 = 2 * Polar_f - Polar_f * Polar_f;
-    es = sqrt(es2);
-    es_OVER_2 = es / 2.0;
+    es2 = 2 * Context->f - Context->f * Context->f;
+    Context->es = sqrt(es2);
+    Context->es_OVER_2 = Context->es / 2.0;
 
-    if (fabs(fabs(Polar_Origin_Lat) - PI_OVER_2) > 1.0e-10)
+    if (fabs(fabs(Context->Origin_Lat) - PI_OVER_2) > 1.0e-10)
     {
-      slat = sin(Polar_Origin_Lat);
-      essin = es * slat;
+      slat = sin(Context->Origin_Lat);
+      essin = Context->es * slat;
       pow_es = POLAR_POW(essin);
-      clat = cos(Polar_Origin_Lat);
-      mc = clat / sqrt(1.0 - essin * essin);
-      Polar_a_mc = Polar_a * mc;
-      tc = tan(PI_Over_4 - Polar_Origin_Lat / 2.0) / pow_es;
+      clat = cos(Context->Origin_Lat);
+      Context->mc = clat / sqrt(1.0 - essin * essin);
+      Context->a_mc = Context->a * Context->mc;
+      Context->tc = tan(PI_Over_4 - Context->Origin_Lat / 2.0) / pow_es;
     }
     else
     {
-      one_PLUS_es = 1.0 + es;
-      one_MINUS_es = 1.0 - es;
-      e4 = sqrt(pow(one_PLUS_es, one_PLUS_es) * pow(one_MINUS_es, one_MINUS_es));
+      one_PLUS_es = 1.0 + Context->es;
+      one_MINUS_es = 1.0 - Context->es;
+      Context->e4 = sqrt(pow(one_PLUS_es, one_PLUS_es) * pow(one_MINUS_es, one_MINUS_es));
     }
   }
   /* Calculate Radius */
-  Convert_Geodetic_To_Polar_Stereographic(0, Longitude_Down_from_Pole, 
-                                          &temp, &temp_northing);
+  Convert_Geodetic_To_Polar_Stereographic_Ctx(Context, 0, Longitude_Down_from_Pole,
+                                              &temp, &temp_northing);
 
-  Polar_Delta_Northing = temp_northing;
-  if(Polar_False_Northing)
-    Polar_Delta_Northing -= Polar_False_Northing;
-  if (Polar_Delta_Northing < 0)
-    Polar_Delta_Northing = -Polar_Delta_Northing;
-  Polar_Delta_Northing *= 1.01;
+  Context->Delta_Northing = temp_northing;
+  if(Context->False_Northing)
+    Context->Delta_Northing -= Context->False_Northing;
+  if (Context->Delta_Northing < 0)
+    Context->Delta_Northing = -Context->Delta_Northing;
+  Context->Delta_Northing *= 1.01;
 
-  Polar_Delta_Easting = Polar_Delta_Northing;
+  Context->Delta_Easting = Context->Delta_Northing;
 
-/*  Polar_Delta_Easting = temp_northing;
-  if(Polar_False_Easting)
-    Polar_Delta_Easting -= Polar_False_Easting;
-  if (Polar_Delta_Easting < 0)
-    Polar_Delta_Easting = -Polar_Delta_Easting;
-  Polar_Delta_Easting *= 1.01;*/
+/*  Context->Delta_Easting = temp_northing;
+  if(Context->False_Easting)
+    Context->Delta_Easting -= Context->False_Easting;
+  if (Context->Delta_Easting < 0)
+    Context->Delta_Easting = -Context->Delta_Easting;
+  Context->Delta_Easting *= 1.01;*/
 
   return (Error_Code);
-} /* END OF Set_Polar_Stereographic_Parameters */
+} /* END OF Set_Polar_Stereographic_Parameters_Ctx */
 
 
 
-void Get_Polar_Stereographic_Parameters (double *a,
-                                         double *f,
-                                         double *Latitude_of_True_Scale,
-                                         double *Longitude_Down_from_Pole,
-                                         double *False_Easting,
-                                         double *False_Northing)
+void Get_Polar_Stereographic_Parameters_Ctx (const Polar_Stereographic_Context *Context,
+                                             double *a,
+                                             double *f,
+                                             double *Latitude_of_True_Scale,
+                                             double *Longitude_Down_from_Pole,
+                                             double *False_Easting,
+                                             double *False_Northing)
 
 { /* BEGIN Get_Polar_Stereographic_Parameters  */
 /*
@@ -291,22 +309,23 @@ void Get_Polar_Stereographic_Parameters (double *a,
  *  False_Northing   : Northing (Y) at center of projection, in meters (output)
  */
 
-  *a = Polar_a;
-  *f = Polar_f;
-  *Latitude_of_True_Scale = Polar_Origin_Lat;
-  *Longitude_Down_from_Pole = Polar_Origin_Long;
-  *False_Easting = Polar_False_Easting;
-  *False_Northing = Polar_False_Northing;
+  *a = Context->a;
+  *f = Context->f;
+  *Latitude_of_True_Scale = Context->Origin_Lat;
+  *Longitude_Down_from_Pole = Context->Origin_Long;
+  *False_Easting = Context->False_Easting;
+  *False_Northing = Context->False_Northing;
   return;
-} /* END OF Get_Polar_Stereographic_Parameters */
+} /* END OF Get_Polar_Stereographic_Parameters_Ctx */
 
 
-long Convert_Geodetic_To_Polar_Stereographic (double Latitude,
-                                              double Longitude,
-                                              double *Easting,
-                                              double *Northing)
+long Convert_Geodetic_To_Polar_Stereographic_Ctx (const Polar_Stereographic_Context *Context,
+                                                  double Latitude,
+                                                  double Longitude,
+                                                  double *Easting,
+                                                  double *Northing)
 
-{  /* BEGIN Convert_Geodetic_To_Polar_Stereographic */
+{  /* BEGIN Convert_Geodetic_To_Polar_Stereographic_Ctx */
 
 /*
  * The function Convert_Geodetic_To_Polar_Stereographic converts geodetic
@@ -333,11 +352,11 @@ long Convert_Geodetic_To_Polar_Stereographic (double Latitude,
   {   /* Latitude out of range */
     Error_Code |= POLAR_LAT_ERROR;
   }
-  if ((Latitude < 0) && (Southern_Hemisphere == 0))
+  if ((Latitude < 0) && (Context->Southern_Hemisphere == 0))
   {   /* Latitude and Origin Latitude in different hemispheres */
     Error_Code |= POLAR_LAT_ERROR;
   }
-  if ((Latitude > 0) && (Southern_Hemisphere == 1))
+  if ((Latitude > 0) && (Context->Southern_Hemisphere == 1))
   {   /* Latitude and Origin Latitude in different hemispheres */
     Error_Code |= POLAR_LAT_ERROR;
   }
@@ -357,12 +376,12 @@ long Convert_Geodetic_To_Polar_Stereographic (double Latitude,
     }
     else
     {
-      if (Southern_Hemisphere != 0)
+      if (Context->Southern_Hemisphere != 0)
       {
         Longitude *= -1.0;
         Latitude *= -1.0;
       }
-      dlam = Longitude - Polar_Origin_Long;
+      dlam = Longitude - Context->Origin_Long;
       if (dlam > PI)
       {
         dlam -= TWO_PI;
@@ -372,38 +391,39 @@ long Convert_Geodetic_To_Polar_Stereographic (double Latitude,
         dlam += TWO_PI;
       }
       slat = sin(Latitude);
-      essin = es * slat;
+      essin = Context->es * slat;
       pow_es = POLAR_POW(essin);
       t = tan(PI_Over_4 - Latitude / 2.0) / pow_es;
 
-      if (fabs(fabs(Polar_Origin_Lat) - PI_OVER_2) > 1.0e-10)
-        rho = Polar_a_mc * t / tc;
+      if (fabs(fabs(Context->Origin_Lat) - PI_OVER_2) > 1.0e-10)
+        rho = Context->a_mc * t / Context->tc;
       else
-        rho = two_Polar_a * t / e4;
+        rho = Context->two_a * t / Context->e4;
 
 
-      if (Southern_Hemisphere != 0)
+      if (Context->Southern_Hemisphere != 0)
       {
-        *Easting = -(rho * sin(dlam) - Polar_False_Easting);
+        *Easting = -(rho * sin(dlam) - Context->False_Easting);
      //   *Easting *= -1.0;
-        *Northing = rho * cos(dlam) + Polar_False_Northing;
+        *Northing = rho * cos(dlam) + Context->False_Northing;
       }
       else
       {
-        *Easting = rho * sin(dlam) + Polar_False_Easting;
-        *Northing = -rho * cos(dlam) + Polar_False_Northing;
+        *Easting = rho * sin(dlam) + Context->False_Easting;
+        *Northing = -rho * cos(dlam) + Context->False_Northing;
       }
 
     }
   }
   return (Error_Code);
-} /* END OF Convert_Geodetic_To_Polar_Stereographic */
+} /* END OF Convert_Geodetic_To_Polar_Stereographic_Ctx */
 
 
-long Convert_Polar_Stereographic_To_Geodetic (double Easting,
-                                              double Northing,
-                                              double *Latitude,
-                                              double *Longitude)
+long Convert_Polar_Stereographic_To_Geodetic_Ctx (const Polar_Stereographic_Context *Context,
+                                                  double Easting,
+                                                  double Northing,
+                                                  double *Latitude,
+                                                  double *Longitude)
 
 { /*  BEGIN Convert_Polar_Stereographic_To_Geodetic  */
 /*
@@ -430,10 +450,10 @@ long Convert_Polar_Stereographic_To_Geodetic (double Easting,
   double pow_es;
   double delta_radius;
   long Error_Code = POLAR_NO_ERROR;
-  double min_easting = Polar_False_Easting - Polar_Delta_Easting;
-  double max_easting = Polar_False_Easting + Polar_Delta_Easting;
-  double min_northing = Polar_False_Northing - Polar_Delta_Northing;
-  double max_northing = Polar_False_Northing + Polar_Delta_Northing;
+  double min_easting = Context->False_Easting - Context->Delta_Easting;
+  double max_easting = Context->False_Easting + Context->Delta_Easting;
+  double min_northing = Context->False_Northing - Context->Delta_Northing;
+  double max_northing = Context->False_Northing + Context->Delta_Northing;
 
   if (Easting > max_easting || Easting < min_easting)
   { /* Easting out of range */
@@ -446,13 +466,13 @@ long Convert_Polar_Stereographic_To_Geodetic (double Easting,
 
   if (!Error_Code)
   {
-    dy = Northing - Polar_False_Northing;
-    dx = Easting - Polar_False_Easting;
+    dy = Northing - Context->False_Northing;
+    dx = Easting - Context->False_Easting;
 
     /* Radius of point with origin of false easting, false northing */
     rho = sqrt(dx * dx + dy * dy);   
     
-    delta_radius = sqrt(Polar_Delta_Easting * Polar_Delta_Easting + Polar_Delta_Northing * Polar_Delta_Northing);
+    delta_radius = sqrt(Context->Delta_Easting * Context->Delta_Easting + Context->Delta_Northing * Context->Delta_Northing);
 
     if(rho > delta_radius)
     { /* Point is outside of projection area */
@@ -465,32 +485,32 @@ long Convert_Polar_Stereographic_To_Geodetic (double Easting,
     if ((dy == 0.0) && (dx == 0.0))
     {
       *Latitude = PI_OVER_2;
-      *Longitude = Polar_Origin_Long;
+      *Longitude = Context->Origin_Long;
 
     }
     else
     {
-      if (Southern_Hemisphere != 0)
+      if (Context->Southern_Hemisphere != 0)
       {
         dy *= -1.0;
         dx *= -1.0;
       }
 
-      if (fabs(fabs(Polar_Origin_Lat) - PI_OVER_2) > 1.0e-10)
-        t = rho * tc / (Polar_a_mc);
+      if (fabs(fabs(Context->Origin_Lat) - PI_OVER_2) > 1.0e-10)
+        t = rho * Context->tc / (Context->a_mc);
       else
-        t = rho * e4 / (two_Polar_a);
+        t = rho * Context->e4 / (Context->two_a);
       PHI = PI_OVER_2 - 2.0 * atan(t);
       while (fabs(PHI - tempPHI) > 1.0e-10)
       {
         tempPHI = PHI;
         sin_PHI = sin(PHI);
-        essin =  es * sin_PHI;
+        essin =  Context->es * sin_PHI;
         pow_es = POLAR_POW(essin);
         PHI = PI_OVER_2 - 2.0 * atan(t * pow_es);
       }
       *Latitude = PHI;
-      *Longitude = Polar_Origin_Long + atan2(dx, -dy);
+      *Longitude = Context->Origin_Long + atan2(dx, -dy);
 
       if (*Longitude > PI)
         *Longitude -= TWO_PI;
@@ -509,7 +529,7 @@ long Convert_Polar_Stereographic_To_Geodetic (double Easting,
         *Longitude = -PI;
 
     }
-    if (Southern_Hemisphere != 0)
+    if (Context->Southern_Hemisphere != 0)
     {
       *Latitude *= -1.0;
       *Longitude *= -1.0;
@@ -517,7 +537,50 @@ long Convert_Polar_Stereographic_To_Geodetic (double Easting,
 
   }
   return (Error_Code);
-} /* END OF Convert_Polar_Stereographic_To_Geodetic */
+} /* END OF Convert_Polar_Stereographic_To_Geodetic_Ctx */
+
+
+/************************************************************************/
+/*                    FUNCTIONS USING THE DEFAULT CONTEXT
+ *
+ */
+
+
+long Set_Polar_Stereographic_Parameters (double a,
+                                         double f,
+                                         double Latitude_of_True_Scale,
+                                         double Longitude_Down_from_Pole,
+                                         double False_Easting,
+                                         double False_Northing)
+{ /* BEGIN Set_Polar_Stereographic_Parameters */
+  return Set_Polar_Stereographic_Parameters_Ctx (&Polar_Default, a, f, Latitude_of_True_Scale, Longitude_Down_from_Pole, False_Easting, False_Northing);
+} /* END OF Set_Polar_Stereographic_Parameters */
+
+
+void Get_Polar_Stereographic_Parameters (double *a,
+                                         double *f,
+                                         double *Latitude_of_True_Scale,
+                                         double *Longitude_Down_from_Pole,
+                                         double *False_Easting,
+                                         double *False_Northing)
+{ /* BEGIN Get_Polar_Stereographic_Parameters */
+  Get_Polar_Stereographic_Parameters_Ctx (&Polar_Default, a, f, Latitude_of_True_Scale, Longitude_Down_from_Pole, False_Easting, False_Northing);
+} /* END OF Get_Polar_Stereographic_Parameters */
+
 
+long Convert_Geodetic_To_Polar_Stereographic (double Latitude,
+                                              double Longitude,
+                                              double *Easting,
+                                              double *Northing)
+{ /* BEGIN Convert_Geodetic_To_Polar_Stereographic */
+  return Convert_Geodetic_To_Polar_Stereographic_Ctx (&Polar_Default, Latitude, Longitude, Easting, Northing);
+} /* END OF Convert_Geodetic_To_Polar_Stereographic */
 
 
+long Convert_Polar_Stereographic_To_Geodetic (double Easting,
+                                              double Northing,
+                                              double *Latitude,
+                                              double *Longitude)
+{ /* BEGIN Convert_Polar_Stereographic_To_Geodetic */
+  return Convert_Polar_Stereographic_To_Geodetic_Ctx (&Polar_Default, Easting, Northing, Latitude, Longitude);
+} /* END OF Convert_Polar_Stereographic_To_Geodetic */
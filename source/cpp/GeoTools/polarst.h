@@ -108,6 +108,38 @@
 #define POLAR_INV_F_ERROR             0x0080
 #define POLAR_RADIUS_ERROR            0x0100
 
+
+/**********************************************************************/
+/*
+ *                        TYPES
+ */
+
+/*
+ * Polar_Stereographic_Context holds the ellipsoid and projection parameters
+ * of a Polar Stereographic projection, and the constants derived from them.
+ * Conversions only read their context : threads may share one, or each use
+ * their own with different parameters.
+ */
+typedef struct Polar_Stereographic_Context_Value
+{
+  double a;                             /* Semi-major axis of ellipsoid in meters */
+  double f;                             /* Flattening of ellipsoid */
+  double es;                            /* Eccentricity of ellipsoid */
+  double es_OVER_2;                     /* es / 2.0 */
+  double Southern_Hemisphere;           /* Flag variable */
+  double mc;
+  double tc;
+  double e4;
+  double a_mc;                          /* a * mc */
+  double two_a;                         /* 2.0 * a */
+  double Origin_Lat;                    /* Latitude of origin in radians */
+  double Origin_Long;                   /* Longitude of origin in radians */
+  double False_Easting;                 /* False easting in meters */
+  double False_Northing;                /* False northing in meters */
+  double Delta_Easting;                 /* Maximum variance for easting */
+  double Delta_Northing;                /* Maximum variance for northing */
+} Polar_Stereographic_Context;
+
 /**********************************************************************/
 /*
  *                        FUNCTION PROTOTYPES
@@ -197,6 +229,54 @@ long QTPLUSSHARED_EXPORT Convert_Polar_Stereographic_To_Geodetic (double Easting
  *
  */
 
+/*
+ * The functions below are the re-entrant versions of the functions above :
+ * they use the state variables of Context instead of the default ones, which
+ * are only changed by Set_Polar_Stereographic_Parameters.
+ */
+
+void QTPLUSSHARED_EXPORT Init_Polar_Stereographic_Context (Polar_Stereographic_Context *Context);
+/*
+ * The function Init_Polar_Stereographic_Context sets Context to the default
+ * parameters : WGS 84 ellipsoid, origin at the north pole, no false easting
+ * or northing.
+ *
+ *  Context          : Context to initialize                           (output)
+ */
+
+
+long QTPLUSSHARED_EXPORT Set_Polar_Stereographic_Parameters_Ctx (Polar_Stereographic_Context *Context,
+                                                                 double a,
+                                                                 double f,
+                                                                 double Latitude_of_True_Scale,
+                                                                 double Longitude_Down_from_Pole,
+                                                                 double False_Easting,
+                                                                 double False_Northing);
+
+
+void QTPLUSSHARED_EXPORT Get_Polar_Stereographic_Parameters_Ctx (const Polar_Stereographic_Context *Context,
+                                                                 double *a,
+                                                                 double *f,
+                                                                 double *Latitude_of_True_Scale,
+                                                                 double *Longitude_Down_from_Pole,
+                                                                 double *False_Easting,
+                                                                 double *False_Northing);
+
+
+long QTPLUSSHARED_EXPORT Convert_Geodetic_To_Polar_Stereographic_Ctx (const Polar_Stereographic_Context *Context,
+                                                                      double Latitude,
+                                                                      double Longitude,
+                                                                      double *Easting,
+                                                                      double *Northing);
+
+
+long QTPLUSSHARED_EXPORT Convert_Polar_Stereographic_To_Geodetic_Ctx (const Polar_Stereographic_Context *Context,
+                                                                      double Easting,
+                                                                      double Northing,
+                                                                      double *Latitude,
+                                                                      double *Longitude);
+
+
 #ifdef __cplusplus
 }
 #endif
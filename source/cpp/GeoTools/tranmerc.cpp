@@ -106,17 +106,17 @@
 #define MIN_SCALE_FACTOR  0.3
 #define MAX_SCALE_FACTOR  3.0
 
-#define SPHTMD(Latitude) ((double) (TranMerc_ap * Latitude \
-      - TranMerc_bp * sin(2.e0 * Latitude) + TranMerc_cp * sin(4.e0 * Latitude) \
-      - TranMerc_dp * sin(6.e0 * Latitude) + TranMerc_ep * sin(8.e0 * Latitude) ) )
+#define SPHTMD(Latitude) ((double) (Context->ap * Latitude \
+      - Context->bp * sin(2.e0 * Latitude) + Context->cp * sin(4.e0 * Latitude) \
+      - Context->dp * sin(6.e0 * Latitude) + Context->ep * sin(8.e0 * Latitude) ) )
 
-#define SPHSN(Latitude) ((double) (TranMerc_a / sqrt( 1.e0 - TranMerc_es * \
+#define SPHSN(Latitude) ((double) (Context->a / sqrt( 1.e0 - Context->es * \
       pow(sin(Latitude), 2))))
 
-#define SPHSR(Latitude) ((double) (TranMerc_a * (1.e0 - TranMerc_es) / \
+#define SPHSR(Latitude) ((double) (Context->a * (1.e0 - Context->es) / \
     pow(DENOM(Latitude), 3)))
 
-#define DENOM(Latitude) ((double) (sqrt(1.e0 - TranMerc_es * pow(sin(Latitude),2))))
+#define DENOM(Latitude) ((double) (sqrt(1.e0 - Context->es * pow(sin(Latitude),2))))
 
 
 /**************************************************************************/
@@ -124,32 +124,32 @@
  *
  */
 
-/* Ellipsoid Parameters, default to WGS 84  */
-static double TranMerc_a = 6378137.0;              /* Semi-major axis of ellipsoid in meters */
-static double TranMerc_f = 1 / 298.257223563;      /* Flattening of ellipsoid  */
-static double TranMerc_es = 0.0066943799901413800; /* Eccentricity (0.08181919084262188000) squared */
-static double TranMerc_ebs = 0.0067394967565869;   /* Second Eccentricity squared */
-
-/* Transverse_Mercator projection Parameters */
-static double TranMerc_Origin_Lat = 0.0;           /* Latitude of origin in radians */
-static double TranMerc_Origin_Long = 0.0;          /* Longitude of origin in radians */
-static double TranMerc_False_Northing = 0.0;       /* False northing in meters */
-static double TranMerc_False_Easting = 0.0;        /* False easting in meters */
-static double TranMerc_Scale_Factor = 1.0;         /* Scale factor  */
-
-/* Isometeric to geodetic latitude parameters, default to WGS 84 */
-static double TranMerc_ap = 6367449.1458008;
-static double TranMerc_bp = 16038.508696861;
-static double TranMerc_cp = 16.832613334334;
-static double TranMerc_dp = 0.021984404273757;
-static double TranMerc_ep = 3.1148371319283e-005;
-
-/* Maximum variance for easting and northing values for WGS 84. */
-static double TranMerc_Delta_Easting = 40000000.0;
-static double TranMerc_Delta_Northing = 40000000.0;
-
-/* These state variables are for optimization purposes. The only function
- * that should modify them is Set_Tranverse_Mercator_Parameters.         */
+/* Default parameters : WGS 84 ellipsoid, origin at 0,0, scale factor 1 */
+#define TRANMERC_DEFAULT_CONTEXT { \
+  6378137.0,               /* a */ \
+  1 / 298.257223563,       /* f */ \
+  0.0066943799901413800,   /* es */ \
+  0.0067394967565869,      /* ebs */ \
+  0.0,                     /* Origin_Lat */ \
+  0.0,                     /* Origin_Long */ \
+  0.0,                     /* False_Northing */ \
+  0.0,                     /* False_Easting */ \
+  1.0,                     /* Scale_Factor */ \
+  6367449.1458008,         /* ap */ \
+  16038.508696861,         /* bp */ \
+  16.832613334334,         /* cp */ \
+  0.021984404273757,       /* dp */ \
+  3.1148371319283e-005,    /* ep */ \
+  40000000.0,              /* Delta_Easting */ \
+  40000000.0 }            /* Delta_Northing */
+
+static const Transverse_Mercator_Context TranMerc_WGS84 = TRANMERC_DEFAULT_CONTEXT;
+
+/* Context of the functions that do not take one */
+static Transverse_Mercator_Context TranMerc_Default = TRANMERC_DEFAULT_CONTEXT;
+
+/* The derived members of a context are for optimization purposes. The only
+ * function that should modify them is Set_Tranverse_Mercator_Parameters_Ctx. */
 
 
 /************************************************************************/
@@ -158,13 +158,28 @@ static double TranMerc_Delta_Northing = 40000000.0;
  */
 
 
-long Set_Transverse_Mercator_Parameters(double a,
-                                        double f,
-                                        double Origin_Latitude,
-                                        double Central_Meridian,
-                                        double False_Easting,
-                                        double False_Northing,
-                                        double Scale_Factor)
+void Init_Transverse_Mercator_Context (Transverse_Mercator_Context *Context)
+{ /* BEGIN Init_Transverse_Mercator_Context */
+  /*
+   * The function Init_Transverse_Mercator_Context sets Context to the default
+   * parameters : WGS 84 ellipsoid, origin at latitude and longitude zero,
+   * no false easting or northing and a scale factor of 1.
+   *
+   *    Context           : Context to initialize                      (output)
+   */
+
+  *Context = TranMerc_WGS84;
+} /* END OF Init_Transverse_Mercator_Context */
+
+
+long Set_Transverse_Mercator_Parameters_Ctx(Transverse_Mercator_Context *Context,
+                                            double a,
+                                            double f,
+                                            double Origin_Latitude,
+                                            double Central_Meridian,
+                                            double False_Easting,
+                                            double False_Northing,
+                                            double Scale_Factor)
 
 { /* BEGIN Set_Tranverse_Mercator_Parameters */
   /*
@@ -217,61 +232,64 @@ long Set_Transverse_Mercator_Parameters(double a,
   }
   if (!Error_Code)
   { /* no errors */
-    TranMerc_a = a;
-    TranMerc_f = f;
-    TranMerc_Origin_Lat = 0;
-    TranMerc_Origin_Long = 0;
-    TranMerc_False_Northing = 0;
-    TranMerc_False_Easting = 0; 
-    TranMerc_Scale_Factor = 1;
+    Context->a = a;
+    Context->f = f;
+    Context->Origin_Lat = 0;
+    Context->Origin_Long = 0;
+    Context->False_Northing = 0;
+    Context->False_Easting = 0; 
+    Context->Scale_Factor = 1;
 
     /* Eccentricity Squared */
-    TranMerc_es = 2 * TranMerc_f - TranMerc_f * TranMerc_f;
+    Context->es = 2 * Context->f - Context->f * Context->f;
     /* Second Eccentricity Squared */
-    TranMerc_ebs = (1 / (1 - TranMerc_es)) - 1;
+    Context->ebs = (1 / (1 - Context->es)) - 1;
 
-    TranMerc_b = TranMerc_a * (1 - TranMerc_f);    
+    TranMerc_b = Context->a * (1 - Context->f);    
     /*True meridianal constants  */
-    tn = (TranMerc_a - TranMerc_b) / (TranMerc_a + TranMerc_b);
+    tn = (Context->a - TranMerc_b) / (Context->a + TranMerc_b);
     tn2 = tn * tn;
     tn3 = tn2 * tn;
     tn4 = tn3 * tn;
     tn5 = tn4 * tn;
 
-    TranMerc_ap = TranMerc_a * (1.e0 - tn + 5.e0 * (tn2 - tn3)/4.e0
+    Context->ap = Context->a * (1.e0 - tn + 5.e0 * (tn2 - tn3)/4.e0
                                 + 81.e0 * (tn4 - tn5)/64.e0 );
-    TranMerc_bp = 3.e0 * TranMerc_a * (tn - tn2 + 7.e0 * (tn3 - tn4)
+    Context->bp = 3.e0 * Context->a * (tn - tn2 + 7.e0 * (tn3 - tn4)
                                        /8.e0 + 55.e0 * tn5/64.e0 )/2.e0;
-    TranMerc_cp = 15.e0 * TranMerc_a * (tn2 - tn3 + 3.e0 * (tn4 - tn5 )/4.e0) /16.0;
-    TranMerc_dp = 35.e0 * TranMerc_a * (tn3 - tn4 + 11.e0 * tn5 / 16.e0) / 48.e0;
-    TranMerc_ep = 315.e0 * TranMerc_a * (tn4 - tn5) / 512.e0;
-    Convert_Geodetic_To_Transverse_Mercator(MAX_LAT,
-                                            MAX_DELTA_LONG,
-                                            &TranMerc_Delta_Easting,
-                                            &TranMerc_Delta_Northing);
-    Convert_Geodetic_To_Transverse_Mercator(0,
-                                            MAX_DELTA_LONG,
-                                            &TranMerc_Delta_Easting,
-                                            &dummy_northing);
-    TranMerc_Origin_Lat = Origin_Latitude;
+    Context->cp = 15.e0 * Context->a * (tn2 - tn3 + 3.e0 * (tn4 - tn5 )/4.e0) /16.0;
+    Context->dp = 35.e0 * Context->a * (tn3 - tn4 + 11.e0 * tn5 / 16.e0) / 48.e0;
+    Context->ep = 315.e0 * Context->a * (tn4 - tn5) / 512.e0;
+    Convert_Geodetic_To_Transverse_Mercator_Ctx(Context,
+                                                MAX_LAT,
+                                                MAX_DELTA_LONG,
+                                                &Context->Delta_Easting,
+                                                &Context->Delta_Northing);
+    Convert_Geodetic_To_Transverse_Mercator_Ctx(Context,
+                                                0,
+                                                MAX_DELTA_LONG,
+                                                &Context->Delta_Easting,
+                                                &dummy_northing);
+    Context->Origin_Lat = Origin_Latitude;
     if (Central_Meridian > PI)
       Central_Meridian -= (2*PI);
-    TranMerc_Origin_Long = Central_Meridian;
-    TranMerc_False_Northing = False_Northing;
-    TranMerc_False_Easting = False_Easting; 
-    TranMerc_Scale_Factor = Scale_Factor;
+    Context->Origin_Long = Central_Meridian;
+    Context->False_Northing = False_Northing;
+    Context->False_Easting = False_Easting; 
+    Context->Scale_Factor = Scale_Factor;
   } /* END OF if(!Error_Code) */
   return (Error_Code);
 }  /* END of Set_Transverse_Mercator_Parameters  */
 
 
-void Get_Transverse_Mercator_Parameters(double *a,
-                                        double *f,
-                                        double *Origin_Latitude,
-                                        double *Central_Meridian,
-                                        double *False_Easting,
-                                        double *False_Northing,
-                                        double *Scale_Factor)
+void Get_Transverse_Mercator_Parameters_Ctx(const Transverse_Mercator_Context *Context,
+                                            double *a,
+                                            double *f,
+                                            double *Origin_Latitude,
+                                            double *Central_Meridian,
+                                            double *False_Easting,
+                                            double *False_Northing,
+                                            double *Scale_Factor)
 
 { /* BEGIN Get_Tranverse_Mercator_Parameters  */
   /*
@@ -289,24 +307,25 @@ void Get_Transverse_Mercator_Parameters(double *a,
    *    Scale_Factor      : Projection scale factor                    (output) 
    */
 
-  *a = TranMerc_a;
-  *f = TranMerc_f;
-  *Origin_Latitude = TranMerc_Origin_Lat;
-  *Central_Meridian = TranMerc_Origin_Long;
-  *False_Easting = TranMerc_False_Easting;
-  *False_Northing = TranMerc_False_Northing;
-  *Scale_Factor = TranMerc_Scale_Factor;
+  *a = Context->a;
+  *f = Context->f;
+  *Origin_Latitude = Context->Origin_Lat;
+  *Central_Meridian = Context->Origin_Long;
+  *False_Easting = Context->False_Easting;
+  *False_Northing = Context->False_Northing;
+  *Scale_Factor = Context->Scale_Factor;
   return;
 } /* END OF Get_Tranverse_Mercator_Parameters */
 
 
 
-long Convert_Geodetic_To_Transverse_Mercator (double Latitude,
-                                              double Longitude,
-                                              double *Easting,
-                                              double *Northing)
+long Convert_Geodetic_To_Transverse_Mercator_Ctx (const Transverse_Mercator_Context *Context,
+                                                  double Latitude,
+                                                  double Longitude,
+                                                  double *Easting,
+                                                  double *Northing)
 
-{      /* BEGIN Convert_Geodetic_To_Transverse_Mercator */
+{      /* BEGIN Convert_Geodetic_To_Transverse_Mercator_Ctx */
 
   /*
    * The function Convert_Geodetic_To_Transverse_Mercator converts geodetic
@@ -328,7 +347,7 @@ long Convert_Geodetic_To_Transverse_Mercator (double Latitude,
   double c5;
   double c7;
   double dlam;    /* Delta longitude - Difference in Longitude       */
-  double eta;     /* constant - TranMerc_ebs *c *c                   */
+  double eta;     /* constant - Context->ebs *c *c                   */
   double eta2;
   double eta3;
   double eta4;
@@ -361,17 +380,17 @@ long Convert_Geodetic_To_Transverse_Mercator (double Latitude,
   }
   if (Longitude > PI)
     Longitude -= (2 * PI);
-  if ((Longitude < (TranMerc_Origin_Long - MAX_DELTA_LONG))
-      || (Longitude > (TranMerc_Origin_Long + MAX_DELTA_LONG)))
+  if ((Longitude < (Context->Origin_Long - MAX_DELTA_LONG))
+      || (Longitude > (Context->Origin_Long + MAX_DELTA_LONG)))
   {
     if (Longitude < 0)
       temp_Long = Longitude + 2 * PI;
     else
       temp_Long = Longitude;
-    if (TranMerc_Origin_Long < 0)
-      temp_Origin = TranMerc_Origin_Long + 2 * PI;
+    if (Context->Origin_Long < 0)
+      temp_Origin = Context->Origin_Long + 2 * PI;
     else
-      temp_Origin = TranMerc_Origin_Long;
+      temp_Origin = Context->Origin_Long;
     if ((temp_Long < (temp_Origin - MAX_DELTA_LONG))
         || (temp_Long > (temp_Origin + MAX_DELTA_LONG)))
       Error_Code|= TRANMERC_LON_ERROR;
@@ -382,7 +401,7 @@ long Convert_Geodetic_To_Transverse_Mercator (double Latitude,
     /* 
      *  Delta Longitude
      */
-    dlam = Longitude - TranMerc_Origin_Long;
+    dlam = Longitude - Context->Origin_Long;
 
     if (fabs(dlam) > (9.0 * PI / 180))
     { /* Distortion will result if Longitude is more than 9 degrees from the Central Meridian */
@@ -408,7 +427,7 @@ long Convert_Geodetic_To_Transverse_Mercator (double Latitude,
     tan4 = tan3 * t;
     tan5 = tan4 * t;
     tan6 = tan5 * t;
-    eta = TranMerc_ebs * c2;
+    eta = Context->ebs * c2;
     eta2 = eta * eta;
     eta3 = eta2 * eta;
     eta4 = eta3 * eta;
@@ -420,48 +439,48 @@ long Convert_Geodetic_To_Transverse_Mercator (double Latitude,
     tmd = SPHTMD(Latitude);
 
     /*  Origin  */
-    tmdo = SPHTMD (TranMerc_Origin_Lat);
+    tmdo = SPHTMD (Context->Origin_Lat);
 
     /* northing */
-    t1 = (tmd - tmdo) * TranMerc_Scale_Factor;
-    t2 = sn * s * c * TranMerc_Scale_Factor/ 2.e0;
-    t3 = sn * s * c3 * TranMerc_Scale_Factor * (5.e0 - tan2 + 9.e0 * eta 
+    t1 = (tmd - tmdo) * Context->Scale_Factor;
+    t2 = sn * s * c * Context->Scale_Factor/ 2.e0;
+    t3 = sn * s * c3 * Context->Scale_Factor * (5.e0 - tan2 + 9.e0 * eta 
                                                 + 4.e0 * eta2) /24.e0; 
 
-    t4 = sn * s * c5 * TranMerc_Scale_Factor * (61.e0 - 58.e0 * tan2
+    t4 = sn * s * c5 * Context->Scale_Factor * (61.e0 - 58.e0 * tan2
                                                 + tan4 + 270.e0 * eta - 330.e0 * tan2 * eta + 445.e0 * eta2
                                                 + 324.e0 * eta3 -680.e0 * tan2 * eta2 + 88.e0 * eta4 
                                                 -600.e0 * tan2 * eta3 - 192.e0 * tan2 * eta4) / 720.e0;
 
-    t5 = sn * s * c7 * TranMerc_Scale_Factor * (1385.e0 - 3111.e0 * 
+    t5 = sn * s * c7 * Context->Scale_Factor * (1385.e0 - 3111.e0 * 
                                                 tan2 + 543.e0 * tan4 - tan6) / 40320.e0;
 
-    *Northing = TranMerc_False_Northing + t1 + pow(dlam,2.e0) * t2
+    *Northing = Context->False_Northing + t1 + pow(dlam,2.e0) * t2
                 + pow(dlam,4.e0) * t3 + pow(dlam,6.e0) * t4
                 + pow(dlam,8.e0) * t5; 
 
     /* Easting */
-    t6 = sn * c * TranMerc_Scale_Factor;
-    t7 = sn * c3 * TranMerc_Scale_Factor * (1.e0 - tan2 + eta ) /6.e0;
-    t8 = sn * c5 * TranMerc_Scale_Factor * (5.e0 - 18.e0 * tan2 + tan4
+    t6 = sn * c * Context->Scale_Factor;
+    t7 = sn * c3 * Context->Scale_Factor * (1.e0 - tan2 + eta ) /6.e0;
+    t8 = sn * c5 * Context->Scale_Factor * (5.e0 - 18.e0 * tan2 + tan4
                                             + 14.e0 * eta - 58.e0 * tan2 * eta + 13.e0 * eta2 + 4.e0 * eta3 
                                             - 64.e0 * tan2 * eta2 - 24.e0 * tan2 * eta3 )/ 120.e0;
-    t9 = sn * c7 * TranMerc_Scale_Factor * ( 61.e0 - 479.e0 * tan2
+    t9 = sn * c7 * Context->Scale_Factor * ( 61.e0 - 479.e0 * tan2
                                              + 179.e0 * tan4 - tan6 ) /5040.e0;
 
-    *Easting = TranMerc_False_Easting + dlam * t6 + pow(dlam,3.e0) * t7 
+    *Easting = Context->False_Easting + dlam * t6 + pow(dlam,3.e0) * t7 
                + pow(dlam,5.e0) * t8 + pow(dlam,7.e0) * t9;
   }
   return (Error_Code);
-} /* END OF Convert_Geodetic_To_Transverse_Mercator */
+} /* END OF Convert_Geodetic_To_Transverse_Mercator_Ctx */
 
 
-long Convert_Transverse_Mercator_To_Geodetic (
-                                             double Easting,
-                                             double Northing,
-                                             double *Latitude,
-                                             double *Longitude)
-{      /* BEGIN Convert_Transverse_Mercator_To_Geodetic */
+long Convert_Transverse_Mercator_To_Geodetic_Ctx (const Transverse_Mercator_Context *Context,
+                                                  double Easting,
+                                                  double Northing,
+                                                  double *Latitude,
+                                                  double *Longitude)
+{      /* BEGIN Convert_Transverse_Mercator_To_Geodetic_Ctx */
 
   /*
    * The function Convert_Transverse_Mercator_To_Geodetic converts Transverse
@@ -480,7 +499,7 @@ long Convert_Transverse_Mercator_To_Geodetic (
   double c;       /* Cosine of latitude                          */
   double de;      /* Delta easting - Difference in Easting (Easting-Fe)    */
   double dlam;    /* Delta longitude - Difference in Longitude       */
-  double eta;     /* constant - TranMerc_ebs *c *c                   */
+  double eta;     /* constant - Context->ebs *c *c                   */
   double eta2;
   double eta3;
   double eta4;
@@ -504,13 +523,13 @@ long Convert_Transverse_Mercator_To_Geodetic (
   double tmdo;    /* True Meridional distance for latitude of origin */
   long Error_Code = TRANMERC_NO_ERROR;
 
-  if ((Easting < (TranMerc_False_Easting - TranMerc_Delta_Easting))
-      ||(Easting > (TranMerc_False_Easting + TranMerc_Delta_Easting)))
+  if ((Easting < (Context->False_Easting - Context->Delta_Easting))
+      ||(Easting > (Context->False_Easting + Context->Delta_Easting)))
   { /* Easting out of range  */
     Error_Code |= TRANMERC_EASTING_ERROR;
   }
-  if ((Northing < (TranMerc_False_Northing - TranMerc_Delta_Northing))
-      || (Northing > (TranMerc_False_Northing + TranMerc_Delta_Northing)))
+  if ((Northing < (Context->False_Northing - Context->Delta_Northing))
+      || (Northing > (Context->False_Northing + Context->Delta_Northing)))
   { /* Northing out of range */
     Error_Code |= TRANMERC_NORTHING_ERROR;
   }
@@ -518,10 +537,10 @@ long Convert_Transverse_Mercator_To_Geodetic (
   if (!Error_Code)
   {
     /* True Meridional Distances for latitude of origin */
-    tmdo = SPHTMD(TranMerc_Origin_Lat);
+    tmdo = SPHTMD(Context->Origin_Lat);
 
     /*  Origin  */
-    tmd = tmdo +  (Northing - TranMerc_False_Northing) / TranMerc_Scale_Factor; 
+    tmd = tmdo +  (Northing - Context->False_Northing) / Context->Scale_Factor; 
 
     /* First Estimate */
     sr = SPHSR(0.e0);
@@ -548,50 +567,50 @@ long Convert_Transverse_Mercator_To_Geodetic (
     t = tan(ftphi);
     tan2 = t * t;
     tan4 = tan2 * tan2;
-    eta = TranMerc_ebs * pow(c,2);
+    eta = Context->ebs * pow(c,2);
     eta2 = eta * eta;
     eta3 = eta2 * eta;
     eta4 = eta3 * eta;
-    de = Easting - TranMerc_False_Easting;
+    de = Easting - Context->False_Easting;
     if (fabs(de) < 0.0001)
       de = 0.0;
 
     /* Latitude */
-    t10 = t / (2.e0 * sr * sn * pow(TranMerc_Scale_Factor, 2));
+    t10 = t / (2.e0 * sr * sn * pow(Context->Scale_Factor, 2));
     t11 = t * (5.e0  + 3.e0 * tan2 + eta - 4.e0 * pow(eta,2)
                - 9.e0 * tan2 * eta) / (24.e0 * sr * pow(sn,3) 
-                                       * pow(TranMerc_Scale_Factor,4));
+                                       * pow(Context->Scale_Factor,4));
     t12 = t * (61.e0 + 90.e0 * tan2 + 46.e0 * eta + 45.E0 * tan4
                - 252.e0 * tan2 * eta  - 3.e0 * eta2 + 100.e0 
                * eta3 - 66.e0 * tan2 * eta2 - 90.e0 * tan4
                * eta + 88.e0 * eta4 + 225.e0 * tan4 * eta2
                + 84.e0 * tan2* eta3 - 192.e0 * tan2 * eta4)
-          / ( 720.e0 * sr * pow(sn,5) * pow(TranMerc_Scale_Factor, 6) );
+          / ( 720.e0 * sr * pow(sn,5) * pow(Context->Scale_Factor, 6) );
     t13 = t * ( 1385.e0 + 3633.e0 * tan2 + 4095.e0 * tan4 + 1575.e0 
-                * pow(t,6))/ (40320.e0 * sr * pow(sn,7) * pow(TranMerc_Scale_Factor,8));
+                * pow(t,6))/ (40320.e0 * sr * pow(sn,7) * pow(Context->Scale_Factor,8));
     *Latitude = ftphi - pow(de,2) * t10 + pow(de,4) * t11 - pow(de,6) * t12 
                 + pow(de,8) * t13;
 
-    t14 = 1.e0 / (sn * c * TranMerc_Scale_Factor);
+    t14 = 1.e0 / (sn * c * Context->Scale_Factor);
 
     t15 = (1.e0 + 2.e0 * tan2 + eta) / (6.e0 * pow(sn,3) * c * 
-                                        pow(TranMerc_Scale_Factor,3));
+                                        pow(Context->Scale_Factor,3));
 
     t16 = (5.e0 + 6.e0 * eta + 28.e0 * tan2 - 3.e0 * eta2
            + 8.e0 * tan2 * eta + 24.e0 * tan4 - 4.e0 
            * eta3 + 4.e0 * tan2 * eta2 + 24.e0 
            * tan2 * eta3) / (120.e0 * pow(sn,5) * c  
-                             * pow(TranMerc_Scale_Factor,5));
+                             * pow(Context->Scale_Factor,5));
 
     t17 = (61.e0 +  662.e0 * tan2 + 1320.e0 * tan4 + 720.e0 
            * pow(t,6)) / (5040.e0 * pow(sn,7) * c 
-                          * pow(TranMerc_Scale_Factor,7));
+                          * pow(Context->Scale_Factor,7));
 
     /* Difference in Longitude */
     dlam = de * t14 - pow(de,3) * t15 + pow(de,5) * t16 - pow(de,7) * t17;
 
     /* Longitude */
-    (*Longitude) = TranMerc_Origin_Long + dlam;
+    (*Longitude) = Context->Origin_Long + dlam;
 
     if((fabs)(*Latitude) > (90.0 * PI / 180.0))
       Error_Code |= TRANMERC_NORTHING_ERROR;
@@ -614,4 +633,52 @@ long Convert_Transverse_Mercator_To_Geodetic (
       Error_Code  |= TRANMERC_LON_WARNING;
   }
   return (Error_Code);
+} /* END OF Convert_Transverse_Mercator_To_Geodetic_Ctx */
+
+
+/************************************************************************/
+/*                    FUNCTIONS USING THE DEFAULT CONTEXT
+ *
+ */
+
+
+long Set_Transverse_Mercator_Parameters(double a,
+                                        double f,
+                                        double Origin_Latitude,
+                                        double Central_Meridian,
+                                        double False_Easting,
+                                        double False_Northing,
+                                        double Scale_Factor)
+{ /* BEGIN Set_Transverse_Mercator_Parameters */
+  return Set_Transverse_Mercator_Parameters_Ctx(&TranMerc_Default, a, f, Origin_Latitude, Central_Meridian, False_Easting, False_Northing, Scale_Factor);
+} /* END OF Set_Transverse_Mercator_Parameters */
+
+
+void Get_Transverse_Mercator_Parameters(double *a,
+                                        double *f,
+                                        double *Origin_Latitude,
+                                        double *Central_Meridian,
+                                        double *False_Easting,
+                                        double *False_Northing,
+                                        double *Scale_Factor)
+{ /* BEGIN Get_Transverse_Mercator_Parameters */
+  Get_Transverse_Mercator_Parameters_Ctx(&TranMerc_Default, a, f, Origin_Latitude, Central_Meridian, False_Easting, False_Northing, Scale_Factor);
+} /* END OF Get_Transverse_Mercator_Parameters */
+
+
+long Convert_Geodetic_To_Transverse_Mercator (double Latitude,
+                                              double Longitude,
+                                              double *Easting,
+                                              double *Northing)
+{ /* BEGIN Convert_Geodetic_To_Transverse_Mercator */
+  return Convert_Geodetic_To_Transverse_Mercator_Ctx (&TranMerc_Default, Latitude, Longitude, Easting, Northing);
+} /* END OF Convert_Geodetic_To_Transverse_Mercator */
+
+
+long Convert_Transverse_Mercator_To_Geodetic (double Easting,
+                                              double Northing,
+                                              double *Latitude,
+                                              double *Longitude)
+{ /* BEGIN Convert_Transverse_Mercator_To_Geodetic */
+  return Convert_Transverse_Mercator_To_Geodetic_Ctx (&TranMerc_Default, Easting, Northing, Latitude, Longitude);
 } /* END OF Convert_Transverse_Mercator_To_Geodetic */
@@ -103,6 +103,38 @@
 #define TRANMERC_LON_WARNING        0x0200
 
 
+/***************************************************************************/
+/*
+ *                              TYPES
+ */
+
+/*
+ * Transverse_Mercator_Context holds the ellipsoid and projection parameters
+ * of a Transverse Mercator projection, and the constants derived from them.
+ * Conversions only read their context : threads may share one, or each use
+ * their own with different parameters.
+ */
+typedef struct Transverse_Mercator_Context_Value
+{
+  double a;                 /* Semi-major axis of ellipsoid in meters */
+  double f;                 /* Flattening of ellipsoid */
+  double es;                /* Eccentricity (0.08181919084262188000) squared */
+  double ebs;               /* Second Eccentricity squared */
+  double Origin_Lat;        /* Latitude of origin in radians */
+  double Origin_Long;       /* Longitude of origin in radians */
+  double False_Northing;    /* False northing in meters */
+  double False_Easting;     /* False easting in meters */
+  double Scale_Factor;      /* Scale factor */
+  double ap;                /* Isometric to geodetic latitude parameters */
+  double bp;
+  double cp;
+  double dp;
+  double ep;
+  double Delta_Easting;     /* Maximum variance for easting */
+  double Delta_Northing;    /* Maximum variance for northing */
+} Transverse_Mercator_Context;
+
+
 /***************************************************************************/
 /*
  *                              FUNCTION PROTOTYPES
@@ -204,6 +236,56 @@ long QTPLUSSHARED_EXPORT Convert_Transverse_Mercator_To_Geodetic (double Easting
  */
 
 
+/*
+ * The functions below are the re-entrant versions of the functions above :
+ * they use the state variables of Context instead of the default ones, which
+ * are only changed by Set_Transverse_Mercator_Parameters.
+ */
+
+void QTPLUSSHARED_EXPORT Init_Transverse_Mercator_Context (Transverse_Mercator_Context *Context);
+/*
+ * The function Init_Transverse_Mercator_Context sets Context to the default
+ * parameters : WGS 84 ellipsoid, origin at latitude and longitude zero,
+ * no false easting or northing and a scale factor of 1.
+ *
+ *    Context           : Context to initialize                      (output)
+ */
+
+
+long QTPLUSSHARED_EXPORT Set_Transverse_Mercator_Parameters_Ctx(Transverse_Mercator_Context *Context,
+                                                                 double a,
+                                                                 double f,
+                                                                 double Origin_Latitude,
+                                                                 double Central_Meridian,
+                                                                 double False_Easting,
+                                                                 double False_Northing,
+                                                                 double Scale_Factor);
+
+
+void QTPLUSSHARED_EXPORT Get_Transverse_Mercator_Parameters_Ctx(const Transverse_Mercator_Context *Context,
+                                                                 double *a,
+                                                                 double *f,
+                                                                 double *Origin_Latitude,
+                                                                 double *Central_Meridian,
+                                                                 double *False_Easting,
+                                                                 double *False_Northing,
+                                                                 double *Scale_Factor);
+
+
+long QTPLUSSHARED_EXPORT Convert_Geodetic_To_Transverse_Mercator_Ctx (const Transverse_Mercator_Context *Context,
+                                                                       double Latitude,
+                                                                       double Longitude,
+                                                                       double *Easting,
+                                                                       double *Northing);
+
+
+long QTPLUSSHARED_EXPORT Convert_Transverse_Mercator_To_Geodetic_Ctx (const Transverse_Mercator_Context *Context,
+                                                                       double Easting,
+                                                                       double Northing,
+                                                                       double *Latitude,
+                                                                       double *Longitude);
+
+
 #ifdef __cplusplus
 }
 #endif
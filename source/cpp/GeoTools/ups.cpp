@@ -108,14 +108,18 @@
 #define MAX_EAST_NORTH 4000000
 
 /* Ellipsoid Parameters, default to WGS 84  */
-static double UPS_a = 6378137.0;          /* Semi-major axis of ellipsoid in meters   */
-static double UPS_f = 1 / 298.257223563;  /* Flattening of ellipsoid  */
+#define UPS_DEFAULT_CONTEXT { \
+  6378137.0,                /* Semi-major axis of ellipsoid in meters */ \
+  1 / 298.257223563 }       /* Flattening of ellipsoid */
+
+static const UPS_Context UPS_WGS84 = UPS_DEFAULT_CONTEXT;
+
+/* Context of the functions that do not take one */
+static UPS_Context UPS_Default = UPS_DEFAULT_CONTEXT;
+
 const double UPS_False_Easting = 2000000;
 const double UPS_False_Northing = 2000000;
-static double UPS_Origin_Latitude = MAX_ORIGIN_LAT;  /*set default = North Hemisphere */
-static double UPS_Origin_Longitude = 0.0;
-static double UPS_Easting = 0.0;
-static double UPS_Northing = 0.0;
+const double UPS_Origin_Longitude = 0.0;
 
 
 /************************************************************************/
@@ -124,8 +128,22 @@ static double UPS_Northing = 0.0;
  */
 
 
-long Set_UPS_Parameters( double a,
-                         double f)
+void Init_UPS_Context (UPS_Context *Context)
+{
+/*
+ * The function Init_UPS_Context sets Context to the default ellipsoid
+ * parameters (WGS 84).
+ *
+ *   Context  : Context to initialize           (output)
+ */
+
+  *Context = UPS_WGS84;
+}  /* END of Init_UPS_Context  */
+
+
+long Set_UPS_Parameters_Ctx(UPS_Context *Context,
+                            double a,
+                            double f)
 {
 /*
  * The function SET_UPS_PARAMETERS receives the ellipsoid parameters and sets
@@ -150,15 +168,16 @@ long Set_UPS_Parameters( double a,
 
   if (!Error_Code)
   { /* no errors */
-    UPS_a = a;
-    UPS_f = f;
+    Context->a = a;
+    Context->f = f;
   }
   return (Error_Code);
 }  /* END of Set_UPS_Parameters  */
 
 
-void Get_UPS_Parameters( double *a,
-                         double *f)
+void Get_UPS_Parameters_Ctx(const UPS_Context *Context,
+                            double *a,
+                            double *f)
 {
 /*
  * The function Get_UPS_Parameters returns the current ellipsoid parameters.
@@ -167,17 +186,18 @@ void Get_UPS_Parameters( double *a,
  *  f      : Flattening of ellipsoid					       (output)
  */
 
-  *a = UPS_a;
-  *f = UPS_f;
+  *a = Context->a;
+  *f = Context->f;
   return;
-} /* END OF Get_UPS_Parameters */
+} /* END OF Get_UPS_Parameters_Ctx */
 
 
-long Convert_Geodetic_To_UPS ( double Latitude,
-                               double Longitude,
-                               char   *Hemisphere,
-                               double *Easting,
-                               double *Northing)
+long Convert_Geodetic_To_UPS_Ctx (const UPS_Context *Context,
+                                  double Latitude,
+                                  double Longitude,
+                                  char   *Hemisphere,
+                                  double *Easting,
+                                  double *Northing)
 {
 /*
  *  The function Convert_Geodetic_To_UPS converts geodetic (latitude and
@@ -193,6 +213,8 @@ long Convert_Geodetic_To_UPS ( double Latitude,
  *    Northing      : Northing/Y in meters                      (output)
  */
 
+  Polar_Stereographic_Context Polar;
+  double Origin_Latitude;
   double tempEasting, tempNorthing;
   long Error_Code = UPS_NO_ERROR;
 
@@ -213,45 +235,44 @@ long Convert_Geodetic_To_UPS ( double Latitude,
   {  /* no errors */
     if (Latitude < 0)
     {
-      UPS_Origin_Latitude = -MAX_ORIGIN_LAT; 
+      Origin_Latitude = -MAX_ORIGIN_LAT; 
       *Hemisphere = 'S';
     }
     else
     {
-      UPS_Origin_Latitude = MAX_ORIGIN_LAT; 
+      Origin_Latitude = MAX_ORIGIN_LAT; 
       *Hemisphere = 'N';
     }
 
 
-    Set_Polar_Stereographic_Parameters( UPS_a,
-                                        UPS_f,
-                                        UPS_Origin_Latitude,
-                                        UPS_Origin_Longitude,
-                                        0.0,
-                                        0.0);
-
-    Convert_Geodetic_To_Polar_Stereographic(Latitude,
-                                            Longitude,
-                                            &tempEasting,
-                                            &tempNorthing);
+    Set_Polar_Stereographic_Parameters_Ctx( &Polar,
+                                            Context->a,
+                                            Context->f,
+                                            Origin_Latitude,
+                                            UPS_Origin_Longitude,
+                                            0.0,
+                                            0.0);
 
-    UPS_Easting = UPS_False_Easting + tempEasting;
-    UPS_Northing = UPS_False_Northing + tempNorthing;
+    Convert_Geodetic_To_Polar_Stereographic_Ctx(&Polar,
+                                                Latitude,
+                                                Longitude,
+                                                &tempEasting,
+                                                &tempNorthing);
 
-
-    *Easting = UPS_Easting;
-    *Northing = UPS_Northing;
+    *Easting = UPS_False_Easting + tempEasting;
+    *Northing = UPS_False_Northing + tempNorthing;
   }  /*  END of if(!Error_Code)   */
 
   return (Error_Code);
 }  /* END OF Convert_Geodetic_To_UPS  */
 
 
-long Convert_UPS_To_Geodetic(char   Hemisphere,
-                             double Easting,
-                             double Northing,
-                             double *Latitude,
-                             double *Longitude)
+long Convert_UPS_To_Geodetic_Ctx(const UPS_Context *Context,
+                                 char   Hemisphere,
+                                 double Easting,
+                                 double Northing,
+                                 double *Latitude,
+                                 double *Longitude)
 {
 /*
  *  The function Convert_UPS_To_Geodetic converts UPS (hemisphere, easting, 
@@ -267,6 +288,8 @@ long Convert_UPS_To_Geodetic(char   Hemisphere,
  *    Longitude     : Longitude in radians                      (output)
  */
 
+  Polar_Stereographic_Context Polar;
+  double Origin_Latitude = MAX_ORIGIN_LAT;
   long Error_Code = UPS_NO_ERROR;
 
   if ((Hemisphere != 'N') && (Hemisphere != 'S'))
@@ -277,25 +300,27 @@ long Convert_UPS_To_Geodetic(char   Hemisphere,
     Error_Code |= UPS_NORTHING_ERROR;
 
   if (Hemisphere =='N')
-  {UPS_Origin_Latitude = MAX_ORIGIN_LAT;}
+  {Origin_Latitude = MAX_ORIGIN_LAT;}
   if (Hemisphere =='S')
-  {UPS_Origin_Latitude = -MAX_ORIGIN_LAT;}
+  {Origin_Latitude = -MAX_ORIGIN_LAT;}
 
   if (!Error_Code)
   {   /*  no errors   */
-    Set_Polar_Stereographic_Parameters( UPS_a,
-                                        UPS_f,
-                                        UPS_Origin_Latitude,
-                                        UPS_Origin_Longitude,
-                                        UPS_False_Easting,
-                                        UPS_False_Northing);
+    Set_Polar_Stereographic_Parameters_Ctx( &Polar,
+                                            Context->a,
+                                            Context->f,
+                                            Origin_Latitude,
+                                            UPS_Origin_Longitude,
+                                            UPS_False_Easting,
+                                            UPS_False_Northing);
 
 
 
-    Convert_Polar_Stereographic_To_Geodetic( Easting,
-                                             Northing,
-                                             Latitude,
-                                             Longitude); 
+    Convert_Polar_Stereographic_To_Geodetic_Ctx( &Polar,
+                                                 Easting,
+                                                 Northing,
+                                                 Latitude,
+                                                 Longitude); 
 
 
     if ((*Latitude < 0) && (*Latitude > MIN_SOUTH_LAT))
@@ -306,3 +331,42 @@ long Convert_UPS_To_Geodetic(char   Hemisphere,
   return (Error_Code);
 }  /*  END OF Convert_UPS_To_Geodetic  */ 
 
+
+/************************************************************************/
+/*                    FUNCTIONS USING THE DEFAULT CONTEXT
+ *
+ */
+
+
+long Set_UPS_Parameters(double a,
+                        double f)
+{ /* BEGIN Set_UPS_Parameters */
+  return Set_UPS_Parameters_Ctx(&UPS_Default, a, f);
+} /* END OF Set_UPS_Parameters */
+
+
+void Get_UPS_Parameters(double *a,
+                        double *f)
+{ /* BEGIN Get_UPS_Parameters */
+  Get_UPS_Parameters_Ctx(&UPS_Default, a, f);
+} /* END OF Get_UPS_Parameters */
+
+
+long Convert_Geodetic_To_UPS (double Latitude,
+                              double Longitude,
+                              char   *Hemisphere,
+                              double *Easting,
+                              double *Northing)
+{ /* BEGIN Convert_Geodetic_To_UPS */
+  return Convert_Geodetic_To_UPS_Ctx (&UPS_Default, Latitude, Longitude, Hemisphere, Easting, Northing);
+} /* END OF Convert_Geodetic_To_UPS */
+
+
+long Convert_UPS_To_Geodetic(char   Hemisphere,
+                             double Easting,
+                             double Northing,
+                             double *Latitude,
+                             double *Longitude)
+{ /* BEGIN Convert_UPS_To_Geodetic */
+  return Convert_UPS_To_Geodetic_Ctx(&UPS_Default, Hemisphere, Easting, Northing, Latitude, Longitude);
+} /* END OF Convert_UPS_To_Geodetic */
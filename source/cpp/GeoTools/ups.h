@@ -98,6 +98,23 @@
 #define UPS_INV_F_ERROR             0x0040
 
 
+/**********************************************************************/
+/*
+ *                              TYPES
+ */
+
+/*
+ * UPS_Context holds the ellipsoid parameters of UPS conversions.
+ * Conversions only read their context : threads may share one, or each use
+ * their own with a different ellipsoid.
+ */
+typedef struct UPS_Context_Value
+{
+  double a;                   /* Semi-major axis of ellipsoid in meters */
+  double f;                   /* Flattening of ellipsoid */
+} UPS_Context;
+
+
 /**********************************************************************/
 /*
  *                        FUNCTION PROTOTYPES
@@ -171,6 +188,47 @@ long QTPLUSSHARED_EXPORT Convert_UPS_To_Geodetic(char   Hemisphere,
  *    Longitude     : Longitude in radians                      (output)
  */
 
+/*
+ * The functions below are the re-entrant versions of the functions above :
+ * they use the state variables of Context instead of the default ones, which
+ * are only changed by Set_UPS_Parameters.
+ */
+
+void QTPLUSSHARED_EXPORT Init_UPS_Context (UPS_Context *Context);
+/*
+ * The function Init_UPS_Context sets Context to the default ellipsoid
+ * parameters (WGS 84).
+ *
+ *   Context  : Context to initialize           (output)
+ */
+
+
+long QTPLUSSHARED_EXPORT Set_UPS_Parameters_Ctx(UPS_Context *Context,
+                                                double a,
+                                                double f);
+
+
+void QTPLUSSHARED_EXPORT Get_UPS_Parameters_Ctx(const UPS_Context *Context,
+                                                double *a,
+                                                double *f);
+
+
+long QTPLUSSHARED_EXPORT Convert_Geodetic_To_UPS_Ctx (const UPS_Context *Context,
+                                                      double Latitude,
+                                                      double Longitude,
+                                                      char   *Hemisphere,
+                                                      double *Easting,
+                                                      double *Northing);
+
+
+long QTPLUSSHARED_EXPORT Convert_UPS_To_Geodetic_Ctx(const UPS_Context *Context,
+                                                     char   Hemisphere,
+                                                     double Easting,
+                                                     double Northing,
+                                                     double *Latitude,
+                                                     double *Longitude);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -73,9 +73,11 @@
 /*
  *                              INCLUDES
  */
+#include <stddef.h>
 #include "tranmerc.h"
 #include "utm.h"
 /*
+ *    stddef.h      - Defines NULL.
  *    tranmerc.h    - Is used to convert transverse mercator coordinates
  *    utm.h         - Defines the function prototypes for the utm module.
  */
@@ -99,9 +101,16 @@
  *                              GLOBAL DECLARATIONS
  */
 
-static double UTM_a = 6378137.0;         /* Semi-major axis of ellipsoid in meters  */
-static double UTM_f = 1 / 298.257223563; /* Flattening of ellipsoid                 */
-static long   UTM_Override = 0;          /* Zone override flag                      */
+/* Default parameters : WGS 84 ellipsoid, no zone override */
+#define UTM_DEFAULT_CONTEXT { \
+  6378137.0,              /* Semi-major axis of ellipsoid in meters  */ \
+  1 / 298.257223563,      /* Flattening of ellipsoid                 */ \
+  0 }                     /* Zone override flag                      */
+
+static const UTM_Context UTM_WGS84 = UTM_DEFAULT_CONTEXT;
+
+/* Context of the functions that do not take one */
+static UTM_Context UTM_Default = UTM_DEFAULT_CONTEXT;
 
 
 /***************************************************************************/
@@ -110,9 +119,23 @@ static long   UTM_Override = 0;          /* Zone override flag
  *
  */
 
-long Set_UTM_Parameters(double a,      
-                        double f,
-                        long   override)
+void Init_UTM_Context (UTM_Context *Context)
+{
+/*
+ * The function Init_UTM_Context sets Context to the default parameters :
+ * WGS 84 ellipsoid and no zone override.
+ *
+ *    Context           : Context to initialize                         (output)
+ */
+
+  *Context = UTM_WGS84;
+} /* END OF Init_UTM_Context */
+
+
+long Set_UTM_Parameters_Ctx(UTM_Context *Context,
+                            double a,
+                            double f,
+                            long   override)
 {
 /*
  * The function Set_UTM_Parameters receives the ellipsoid parameters and
@@ -142,17 +165,18 @@ long Set_UTM_Parameters(double a,
   }
   if (!Error_Code)
   { /* no errors */
-    UTM_a = a;
-    UTM_f = f;
-    UTM_Override = override;
+    Context->a = a;
+    Context->f = f;
+    Context->Override = override;
   }
   return (Error_Code);
-} /* END OF Set_UTM_Parameters */
+} /* END OF Set_UTM_Parameters_Ctx */
 
 
-void Get_UTM_Parameters(double *a,
-                        double *f,
-                        long   *override)
+void Get_UTM_Parameters_Ctx(const UTM_Context *Context,
+                            double *a,
+                            double *f,
+                            long   *override)
 {
 /*
  * The function Get_UTM_Parameters returns the current ellipsoid
@@ -163,37 +187,32 @@ void Get_UTM_Parameters(double *a,
  *    override          : UTM override zone, zero indicates no override (output)
  */
 
-  *a = UTM_a;
-  *f = UTM_f;
-  *override = UTM_Override;
-} /* END OF Get_UTM_Parameters */
+  *a = Context->a;
+  *f = Context->f;
+  *override = Context->Override;
+} /* END OF Get_UTM_Parameters_Ctx */
 
 
-long Convert_Geodetic_To_UTM (double Latitude,
-                              double Longitude,
-                              long   *Zone,
-                              char   *Hemisphere,
-                              double *Easting,
-                              double *Northing)
-{ 
+static long Geodetic_To_UTM (const UTM_Context *Context,
+                             const UTM_Zone_Cache *Cache,
+                             double Latitude,
+                             double Longitude,
+                             long   *Zone,
+                             char   *Hemisphere,
+                             double *Easting,
+                             double *Northing)
+{
 /*
- * The function Convert_Geodetic_To_UTM converts geodetic (latitude and
- * longitude) coordinates to UTM projection (zone, hemisphere, easting and
- * northing) coordinates according to the current ellipsoid and UTM zone
- * override parameters.  If any errors occur, the error code(s) are returned
- * by the function, otherwise UTM_NO_ERROR is returned.
- *
- *    Latitude          : Latitude in radians                 (input)
- *    Longitude         : Longitude in radians                (input)
- *    Zone              : UTM zone                            (output)
- *    Hemisphere        : North or South hemisphere           (output)
- *    Easting           : Easting (X) in meters               (output)
- *    Northing          : Northing (Y) in meters              (output)
+ * The function Geodetic_To_UTM is Convert_Geodetic_To_UTM_Ctx.  When Cache
+ * is not NULL, it takes the projection of the zone from the cache instead
+ * of setting it up.
  */
 
   long Lat_Degrees;
   long Long_Degrees;
   long temp_zone;
+  Transverse_Mercator_Context TranMerc;
+  const Transverse_Mercator_Context *Zone_TranMerc = &TranMerc;
   long Error_Code = UTM_NO_ERROR;
   double Origin_Latitude = 0;
   double Central_Meridian = 0;
@@ -238,14 +257,14 @@ long Convert_Geodetic_To_UTM (double Latitude,
     if ((Lat_Degrees > 71) && (Long_Degrees > 32) && (Long_Degrees < 42))
       temp_zone = 37;
 
-    if (UTM_Override)
+    if (Context->Override)
     {
-      if ((temp_zone == 1) && (UTM_Override == 60))
-        temp_zone = UTM_Override;
-      else if ((temp_zone == 60) && (UTM_Override == 1))
-        temp_zone = UTM_Override;
-      else if (((temp_zone-1) <= UTM_Override) && (UTM_Override <= (temp_zone+1)))
-        temp_zone = UTM_Override;
+      if ((temp_zone == 1) && (Context->Override == 60))
+        temp_zone = Context->Override;
+      else if ((temp_zone == 60) && (Context->Override == 1))
+        temp_zone = Context->Override;
+      else if (((temp_zone-1) <= Context->Override) && (Context->Override <= (temp_zone+1)))
+        temp_zone = Context->Override;
       else
         Error_Code = UTM_ZONE_OVERRIDE_ERROR;
     }
@@ -263,10 +282,13 @@ long Convert_Geodetic_To_UTM (double Latitude,
       }
       else
         *Hemisphere = 'N';
-      Set_Transverse_Mercator_Parameters(UTM_a, UTM_f, Origin_Latitude,
-                                         Central_Meridian, False_Easting, False_Northing, Scale);
-      Convert_Geodetic_To_Transverse_Mercator(Latitude, Longitude, Easting,
-                                              Northing);
+      if (Cache)
+        Zone_TranMerc = &Cache->Zones[(Latitude < 0) ? 1 : 0][temp_zone - 1];
+      else
+        Set_Transverse_Mercator_Parameters_Ctx(&TranMerc, Context->a, Context->f, Origin_Latitude,
+                                               Central_Meridian, False_Easting, False_Northing, Scale);
+      Convert_Geodetic_To_Transverse_Mercator_Ctx(Zone_TranMerc, Latitude, Longitude, Easting,
+                                                  Northing);
       if ((*Easting < MIN_EASTING) || (*Easting > MAX_EASTING))
         Error_Code = UTM_EASTING_ERROR;
       if ((*Northing < MIN_NORTHING) || (*Northing > MAX_NORTHING))
@@ -274,30 +296,25 @@ long Convert_Geodetic_To_UTM (double Latitude,
     }
   } /* END OF if (!Error_Code) */
   return (Error_Code);
-} /* END OF Convert_Geodetic_To_UTM */
+} /* END OF Geodetic_To_UTM */
 
 
-long Convert_UTM_To_Geodetic(long   Zone,
-                             char   Hemisphere,
-                             double Easting,
-                             double Northing,
-                             double *Latitude,
-                             double *Longitude)
+static long UTM_To_Geodetic(const UTM_Context *Context,
+                            const UTM_Zone_Cache *Cache,
+                            long   Zone,
+                            char   Hemisphere,
+                            double Easting,
+                            double Northing,
+                            double *Latitude,
+                            double *Longitude)
 {
 /*
- * The function Convert_UTM_To_Geodetic converts UTM projection (zone, 
- * hemisphere, easting and northing) coordinates to geodetic(latitude
- * and  longitude) coordinates, according to the current ellipsoid
- * parameters.  If any errors occur, the error code(s) are returned
- * by the function, otherwise UTM_NO_ERROR is returned.
- *
- *    Zone              : UTM zone                               (input)
- *    Hemisphere        : North or South hemisphere              (input)
- *    Easting           : Easting (X) in meters                  (input)
- *    Northing          : Northing (Y) in meters                 (input)
- *    Latitude          : Latitude in radians                    (output)
- *    Longitude         : Longitude in radians                   (output)
+ * The function UTM_To_Geodetic is Convert_UTM_To_Geodetic_Ctx.  When Cache
+ * is not NULL, it takes the projection of the zone from the cache instead
+ * of setting it up.
  */
+  Transverse_Mercator_Context TranMerc;
+  const Transverse_Mercator_Context *Zone_TranMerc = &TranMerc;
   long Error_Code = UTM_NO_ERROR;
   long tm_error_code = UTM_NO_ERROR;
   double Origin_Latitude = 0;
@@ -322,10 +339,13 @@ long Convert_UTM_To_Geodetic(long   Zone,
       Central_Meridian = ((6 * Zone + 177) * PI / 180.0 /*+ 0.00000005*/);
     if (Hemisphere == 'S')
       False_Northing = 10000000;
-    Set_Transverse_Mercator_Parameters(UTM_a, UTM_f, Origin_Latitude,
-                                       Central_Meridian, False_Easting, False_Northing, Scale);
+    if (Cache)
+      Zone_TranMerc = &Cache->Zones[(Hemisphere == 'S') ? 1 : 0][Zone - 1];
+    else
+      Set_Transverse_Mercator_Parameters_Ctx(&TranMerc, Context->a, Context->f, Origin_Latitude,
+                                             Central_Meridian, False_Easting, False_Northing, Scale);
 
-    tm_error_code = Convert_Transverse_Mercator_To_Geodetic(Easting, Northing, Latitude, Longitude);
+    tm_error_code = Convert_Transverse_Mercator_To_Geodetic_Ctx(Zone_TranMerc, Easting, Northing, Latitude, Longitude);
     if(tm_error_code)
     {
       if((tm_error_code & TRANMERC_EASTING_ERROR) || (tm_error_code & TRANMERC_LON_WARNING))
@@ -340,4 +360,278 @@ long Convert_UTM_To_Geodetic(long   Zone,
     }
   }
   return (Error_Code);
+} /* END OF UTM_To_Geodetic */
+
+
+long Convert_Geodetic_To_UTM_Ctx (const UTM_Context *Context,
+                                  double Latitude,
+                                  double Longitude,
+                                  long   *Zone,
+                                  char   *Hemisphere,
+                                  double *Easting,
+                                  double *Northing)
+{
+/*
+ * The function Convert_Geodetic_To_UTM converts geodetic (latitude and
+ * longitude) coordinates to UTM projection (zone, hemisphere, easting and
+ * northing) coordinates according to the current ellipsoid and UTM zone
+ * override parameters.  If any errors occur, the error code(s) are returned
+ * by the function, otherwise UTM_NO_ERROR is returned.
+ *
+ *    Latitude          : Latitude in radians                 (input)
+ *    Longitude         : Longitude in radians                (input)
+ *    Zone              : UTM zone                            (output)
+ *    Hemisphere        : North or South hemisphere           (output)
+ *    Easting           : Easting (X) in meters               (output)
+ *    Northing          : Northing (Y) in meters              (output)
+ */
+
+  return Geodetic_To_UTM (Context, NULL, Latitude, Longitude, Zone, Hemisphere, Easting, Northing);
+} /* END OF Convert_Geodetic_To_UTM_Ctx */
+
+
+long Convert_UTM_To_Geodetic_Ctx(const UTM_Context *Context,
+                                 long   Zone,
+                                 char   Hemisphere,
+                                 double Easting,
+                                 double Northing,
+                                 double *Latitude,
+                                 double *Longitude)
+{
+/*
+ * The function Convert_UTM_To_Geodetic converts UTM projection (zone, 
+ * hemisphere, easting and northing) coordinates to geodetic(latitude
+ * and  longitude) coordinates, according to the current ellipsoid
+ * parameters.  If any errors occur, the error code(s) are returned
+ * by the function, otherwise UTM_NO_ERROR is returned.
+ *
+ *    Zone              : UTM zone                               (input)
+ *    Hemisphere        : North or South hemisphere              (input)
+ *    Easting           : Easting (X) in meters                  (input)
+ *    Northing          : Northing (Y) in meters                 (input)
+ *    Latitude          : Latitude in radians                    (output)
+ *    Longitude         : Longitude in radians                   (output)
+ */
+
+  return UTM_To_Geodetic (Context, NULL, Zone, Hemisphere, Easting, Northing, Latitude, Longitude);
+} /* END OF Convert_UTM_To_Geodetic_Ctx */
+
+
+long Init_UTM_Zone_Cache (UTM_Zone_Cache *Cache,
+                          const UTM_Context *Context)
+{
+/*
+ * The function Init_UTM_Zone_Cache sets up the Transverse Mercator
+ * projection of each UTM zone and hemisphere for the parameters of Context.
+ * If any errors occur, the error code(s) are returned by the function,
+ * otherwise UTM_NO_ERROR is returned.
+ *
+ *    Cache             : Cache to initialize                           (output)
+ *    Context           : Ellipsoid and zone override parameters        (input)
+ */
+
+  long Zone;
+  long tm_error_code = TRANMERC_NO_ERROR;
+  long Error_Code = UTM_NO_ERROR;
+  double Central_Meridian;
+
+  Cache->UTM = *Context;
+  for (Zone = 1; Zone <= 60; Zone++)
+  {
+    if (Zone >= 31)
+      Central_Meridian = (6 * Zone - 183) * PI / 180.0;
+    else
+      Central_Meridian = (6 * Zone + 177) * PI / 180.0;
+    tm_error_code |= Set_Transverse_Mercator_Parameters_Ctx(&Cache->Zones[0][Zone - 1], Context->a, Context->f, 0,
+                                                            Central_Meridian, 500000, 0, 0.9996);
+    tm_error_code |= Set_Transverse_Mercator_Parameters_Ctx(&Cache->Zones[1][Zone - 1], Context->a, Context->f, 0,
+                                                            Central_Meridian, 500000, 10000000, 0.9996);
+  }
+  if (tm_error_code & TRANMERC_A_ERROR)
+    Error_Code |= UTM_A_ERROR;
+  if (tm_error_code & TRANMERC_INV_F_ERROR)
+    Error_Code |= UTM_INV_F_ERROR;
+  return (Error_Code);
+} /* END OF Init_UTM_Zone_Cache */
+
+
+long Convert_Geodetic_To_UTM_Cached (const UTM_Zone_Cache *Cache,
+                                     double Latitude,
+                                     double Longitude,
+                                     long   *Zone,
+                                     char   *Hemisphere,
+                                     double *Easting,
+                                     double *Northing)
+{
+/*
+ * The function Convert_Geodetic_To_UTM_Cached converts geodetic coordinates
+ * to UTM projection coordinates like Convert_Geodetic_To_UTM_Ctx, with the
+ * parameters and zone projections of Cache.
+ *
+ *    Cache             : Zone projections                    (input)
+ *    Latitude          : Latitude in radians                 (input)
+ *    Longitude         : Longitude in radians                (input)
+ *    Zone              : UTM zone                            (output)
+ *    Hemisphere        : North or South hemisphere           (output)
+ *    Easting           : Easting (X) in meters               (output)
+ *    Northing          : Northing (Y) in meters              (output)
+ */
+
+  return Geodetic_To_UTM (&Cache->UTM, Cache, Latitude, Longitude, Zone, Hemisphere, Easting, Northing);
+} /* END OF Convert_Geodetic_To_UTM_Cached */
+
+
+long Convert_UTM_To_Geodetic_Cached (const UTM_Zone_Cache *Cache,
+                                     long   Zone,
+                                     char   Hemisphere,
+                                     double Easting,
+                                     double Northing,
+                                     double *Latitude,
+                                     double *Longitude)
+{
+/*
+ * The function Convert_UTM_To_Geodetic_Cached converts UTM projection
+ * coordinates to geodetic coordinates like Convert_UTM_To_Geodetic_Ctx,
+ * with the parameters and zone projections of Cache.
+ *
+ *    Cache             : Zone projections                       (input)
+ *    Zone              : UTM zone                               (input)
+ *    Hemisphere        : North or South hemisphere              (input)
+ *    Easting           : Easting (X) in meters                  (input)
+ *    Northing          : Northing (Y) in meters                 (input)
+ *    Latitude          : Latitude in radians                    (output)
+ *    Longitude         : Longitude in radians                   (output)
+ */
+
+  return UTM_To_Geodetic (&Cache->UTM, Cache, Zone, Hemisphere, Easting, Northing, Latitude, Longitude);
+} /* END OF Convert_UTM_To_Geodetic_Cached */
+
+
+long Convert_Geodetic_To_UTM_Batch (const UTM_Zone_Cache *Cache,
+                                    long   Count,
+                                    const double *Latitudes,
+                                    const double *Longitudes,
+                                    long   *Zones,
+                                    char   *Hemispheres,
+                                    double *Eastings,
+                                    double *Northings,
+                                    long   *Error_Codes)
+{
+/*
+ * The function Convert_Geodetic_To_UTM_Batch converts Count geodetic
+ * coordinates to UTM projection coordinates, with the parameters and zone
+ * projections of Cache.  The error code(s) of all points are combined and
+ * returned by the function.
+ *
+ *    Cache             : Zone projections                    (input)
+ *    Count             : Number of points                    (input)
+ *    Latitudes         : Latitudes in radians                (input)
+ *    Longitudes        : Longitudes in radians               (input)
+ *    Zones             : UTM zones                           (output)
+ *    Hemispheres       : North or South hemispheres          (output)
+ *    Eastings          : Eastings (X) in meters              (output)
+ *    Northings         : Northings (Y) in meters             (output)
+ *    Error_Codes       : Error code(s) of each point, or NULL (output)
+ */
+
+  long Index;
+  long Point_Error_Code;
+  long Error_Code = UTM_NO_ERROR;
+
+  for (Index = 0; Index < Count; Index++)
+  {
+    Point_Error_Code = Geodetic_To_UTM (&Cache->UTM, Cache, Latitudes[Index], Longitudes[Index], &Zones[Index],
+                                        &Hemispheres[Index], &Eastings[Index], &Northings[Index]);
+    if (Error_Codes)
+      Error_Codes[Index] = Point_Error_Code;
+    Error_Code |= Point_Error_Code;
+  }
+  return (Error_Code);
+} /* END OF Convert_Geodetic_To_UTM_Batch */
+
+
+long Convert_UTM_To_Geodetic_Batch (const UTM_Zone_Cache *Cache,
+                                    long   Count,
+                                    const long *Zones,
+                                    const char *Hemispheres,
+                                    const double *Eastings,
+                                    const double *Northings,
+                                    double *Latitudes,
+                                    double *Longitudes,
+                                    long   *Error_Codes)
+{
+/*
+ * The function Convert_UTM_To_Geodetic_Batch converts Count UTM projection
+ * coordinates to geodetic coordinates, with the parameters and zone
+ * projections of Cache.  The error code(s) of all points are combined and
+ * returned by the function.
+ *
+ *    Cache             : Zone projections                    (input)
+ *    Count             : Number of points                    (input)
+ *    Zones             : UTM zones                           (input)
+ *    Hemispheres       : North or South hemispheres          (input)
+ *    Eastings          : Eastings (X) in meters              (input)
+ *    Northings         : Northings (Y) in meters             (input)
+ *    Latitudes         : Latitudes in radians                (output)
+ *    Longitudes        : Longitudes in radians               (output)
+ *    Error_Codes       : Error code(s) of each point, or NULL (output)
+ */
+
+  long Index;
+  long Point_Error_Code;
+  long Error_Code = UTM_NO_ERROR;
+
+  for (Index = 0; Index < Count; Index++)
+  {
+    Point_Error_Code = UTM_To_Geodetic (&Cache->UTM, Cache, Zones[Index], Hemispheres[Index], Eastings[Index],
+                                        Northings[Index], &Latitudes[Index], &Longitudes[Index]);
+    if (Error_Codes)
+      Error_Codes[Index] = Point_Error_Code;
+    Error_Code |= Point_Error_Code;
+  }
+  return (Error_Code);
+} /* END OF Convert_UTM_To_Geodetic_Batch */
+
+
+/***************************************************************************/
+/*
+ *                    FUNCTIONS USING THE DEFAULT CONTEXT
+ */
+
+
+long Set_UTM_Parameters(double a,
+                        double f,
+                        long   override)
+{ /* BEGIN Set_UTM_Parameters */
+  return Set_UTM_Parameters_Ctx(&UTM_Default, a, f, override);
+} /* END OF Set_UTM_Parameters */
+
+
+void Get_UTM_Parameters(double *a,
+                        double *f,
+                        long   *override)
+{ /* BEGIN Get_UTM_Parameters */
+  Get_UTM_Parameters_Ctx(&UTM_Default, a, f, override);
+} /* END OF Get_UTM_Parameters */
+
+
+long Convert_Geodetic_To_UTM (double Latitude,
+                              double Longitude,
+                              long   *Zone,
+                              char   *Hemisphere,
+                              double *Easting,
+                              double *Northing)
+{ /* BEGIN Convert_Geodetic_To_UTM */
+  return Convert_Geodetic_To_UTM_Ctx (&UTM_Default, Latitude, Longitude, Zone, Hemisphere, Easting, Northing);
+} /* END OF Convert_Geodetic_To_UTM */
+
+
+long Convert_UTM_To_Geodetic(long   Zone,
+                             char   Hemisphere,
+                             double Easting,
+                             double Northing,
+                             double *Latitude,
+                             double *Longitude)
+{ /* BEGIN Convert_UTM_To_Geodetic */
+  return Convert_UTM_To_Geodetic_Ctx(&UTM_Default, Zone, Hemisphere, Easting, Northing, Latitude, Longitude);
 } /* END OF Convert_UTM_To_Geodetic */
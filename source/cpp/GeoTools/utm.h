@@ -3,6 +3,7 @@
 
 
 #include "../qtplus_global.h"
+#include "tranmerc.h"
 
 
 /***************************************************************************/
@@ -93,6 +94,36 @@
 #define UTM_INV_F_ERROR         0x0100
 
 
+/***************************************************************************/
+/*
+ *                              TYPES
+ */
+
+/*
+ * UTM_Context holds the ellipsoid parameters and zone override of UTM
+ * conversions.  Conversions only read their context : threads may share one,
+ * or each use their own with different parameters.
+ */
+typedef struct UTM_Context_Value
+{
+  double a;                   /* Semi-major axis of ellipsoid in meters */
+  double f;                   /* Flattening of ellipsoid */
+  long   Override;            /* Zone override flag */
+} UTM_Context;
+
+/*
+ * UTM_Zone_Cache holds a UTM context and the Transverse Mercator projection
+ * of each zone and hemisphere for its ellipsoid, set up once for all the
+ * conversions that use the cache instead of at each conversion.  Like
+ * contexts, caches are only read by conversions.
+ */
+typedef struct UTM_Zone_Cache_Value
+{
+  UTM_Context UTM;                              /* Parameters of the cache */
+  Transverse_Mercator_Context Zones[2][60];     /* North then South, by zone - 1 */
+} UTM_Zone_Cache;
+
+
 /***************************************************************************/
 /*
  *                              FUNCTION PROTOTYPES
@@ -175,6 +206,141 @@ long QTPLUSSHARED_EXPORT Convert_UTM_To_Geodetic(long   Zone,
  *    Longitude         : Longitude in radians                   (output)
  */
 
+/*
+ * The functions below are the re-entrant versions of the functions above :
+ * they use the state variables of Context instead of the default ones, which
+ * are only changed by Set_UTM_Parameters.
+ */
+
+void QTPLUSSHARED_EXPORT Init_UTM_Context (UTM_Context *Context);
+/*
+ * The function Init_UTM_Context sets Context to the default parameters :
+ * WGS 84 ellipsoid and no zone override.
+ *
+ *    Context           : Context to initialize                         (output)
+ */
+
+
+long QTPLUSSHARED_EXPORT Set_UTM_Parameters_Ctx(UTM_Context *Context,
+                                                double a,
+                                                double f,
+                                                long   override);
+
+
+void QTPLUSSHARED_EXPORT Get_UTM_Parameters_Ctx(const UTM_Context *Context,
+                                                double *a,
+                                                double *f,
+                                                long   *override);
+
+
+long QTPLUSSHARED_EXPORT Convert_Geodetic_To_UTM_Ctx (const UTM_Context *Context,
+                                                      double Latitude,
+                                                      double Longitude,
+                                                      long   *Zone,
+                                                      char   *Hemisphere,
+                                                      double *Easting,
+                                                      double *Northing);
+
+
+long QTPLUSSHARED_EXPORT Convert_UTM_To_Geodetic_Ctx(const UTM_Context *Context,
+                                                     long   Zone,
+                                                     char   Hemisphere,
+                                                     double Easting,
+                                                     double Northing,
+                                                     double *Latitude,
+                                                     double *Longitude);
+
+/*
+ * The functions below use the zone projections of a cache, which makes them
+ * much faster than the functions above when many points are converted with
+ * the same parameters.  Their results are the same.
+ */
+
+long QTPLUSSHARED_EXPORT Init_UTM_Zone_Cache (UTM_Zone_Cache *Cache,
+                                              const UTM_Context *Context);
+/*
+ * The function Init_UTM_Zone_Cache sets up the Transverse Mercator
+ * projection of each UTM zone and hemisphere for the parameters of Context.
+ * If any errors occur, the error code(s) are returned by the function,
+ * otherwise UTM_NO_ERROR is returned.
+ *
+ *    Cache             : Cache to initialize                           (output)
+ *    Context           : Ellipsoid and zone override parameters        (input)
+ */
+
+
+long QTPLUSSHARED_EXPORT Convert_Geodetic_To_UTM_Cached (const UTM_Zone_Cache *Cache,
+                                                         double Latitude,
+                                                         double Longitude,
+                                                         long   *Zone,
+                                                         char   *Hemisphere,
+                                                         double *Easting,
+                                                         double *Northing);
+
+
+long QTPLUSSHARED_EXPORT Convert_UTM_To_Geodetic_Cached (const UTM_Zone_Cache *Cache,
+                                                         long   Zone,
+                                                         char   Hemisphere,
+                                                         double Easting,
+                                                         double Northing,
+                                                         double *Latitude,
+                                                         double *Longitude);
+
+
+long QTPLUSSHARED_EXPORT Convert_Geodetic_To_UTM_Batch (const UTM_Zone_Cache *Cache,
+                                                        long   Count,
+                                                        const double *Latitudes,
+                                                        const double *Longitudes,
+                                                        long   *Zones,
+                                                        char   *Hemispheres,
+                                                        double *Eastings,
+                                                        double *Northings,
+                                                        long   *Error_Codes);
+/*
+ * The function Convert_Geodetic_To_UTM_Batch converts Count geodetic
+ * coordinates to UTM projection coordinates, with the parameters and zone
+ * projections of Cache.  The error code(s) of all points are combined and
+ * returned by the function.
+ *
+ *    Cache             : Zone projections                    (input)
+ *    Count             : Number of points                    (input)
+ *    Latitudes         : Latitudes in radians                (input)
+ *    Longitudes        : Longitudes in radians               (input)
+ *    Zones             : UTM zones                           (output)
+ *    Hemispheres       : North or South hemispheres          (output)
+ *    Eastings          : Eastings (X) in meters              (output)
+ *    Northings         : Northings (Y) in meters             (output)
+ *    Error_Codes       : Error code(s) of each point, or NULL (output)
+ */
+
+
+long QTPLUSSHARED_EXPORT Convert_UTM_To_Geodetic_Batch (const UTM_Zone_Cache *Cache,
+                                                        long   Count,
+                                                        const long *Zones,
+                                                        const char *Hemispheres,
+                                                        const double *Eastings,
+                                                        const double *Northings,
+                                                        double *Latitudes,
+                                                        double *Longitudes,
+                                                        long   *Error_Codes);
+/*
+ * The function Convert_UTM_To_Geodetic_Batch converts Count UTM projection
+ * coordinates to geodetic coordinates, with the parameters and zone
+ * projections of Cache.  The error code(s) of all points are combined and
+ * returned by the function.
+ *
+ *    Cache             : Zone projections                    (input)
+ *    Count             : Number of points                    (input)
+ *    Zones             : UTM zones                           (input)
+ *    Hemispheres       : North or South hemispheres          (input)
+ *    Eastings          : Eastings (X) in meters              (input)
+ *    Northings         : Northings (Y) in meters             (input)
+ *    Latitudes         : Latitudes in radians                (output)
+ *    Longitudes        : Longitudes in radians               (output)
+ *    Error_Codes       : Error code(s) of each point, or NULL (output)
+ */
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,384 @@
+/***************************************************************************/
+/* RSC IDENTIFIER:  WORLD MAGNETIC MODEL
+ *
+ * ABSTRACT
+ *
+ *    This component computes the main magnetic field of the Earth with the
+ *    World Magnetic Model, from the coefficients of a WMM.COF file.
+ *
+ *    The field is the gradient of a spherical harmonic expansion of degree
+ *    12 in geocentric spherical coordinates.  Positions are first converted
+ *    from geodetic to spherical coordinates, the field is summed there and
+ *    rotated back to the geodetic frame.
+ *
+ * ERROR HANDLING
+ *
+ *    This component checks parameters for valid values.  If an invalid value
+ *    is found, the error code is combined with the current error code using
+ *    the bitwise or.  The error codes are listed in wmm.h.
+ *
+ * REFERENCES
+ *
+ *    The US/UK World Magnetic Model for 2015-2020, A. Chulliat et al.,
+ *    NOAA National Geophysical Data Center (2015).
+ *
+ */
+
+
+/***************************************************************************/
+/*
+ *                               INCLUDES
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "wmm.h"
+
+/*
+ *    math.h      - is needed for sqrt, sin, cos and atan2.
+ *    stdio.h     - is needed to read coefficient files and for sscanf.
+ *    stdlib.h    - is needed for malloc and free.
+ *    string.h    - is needed for memset, strchr and strncmp.
+ *    wmm.h       - is needed for Error codes and prototype error checking.
+ */
+
+
+/***************************************************************************/
+/*
+ *                               DEFINES
+ */
+#define PI              3.14159265358979323e0
+#define PI_OVER_2       (PI / 2.0e0)
+
+#define WGS84_A         6378137.0                   /* Semi-major axis of the WGS 84 ellipsoid */
+#define WGS84_F         (1 / 298.257223563)         /* Flattening of the WGS 84 ellipsoid */
+#define WMM_RADIUS      6371200.0                   /* Reference radius of the model, in meters */
+#define WMM_VALIDITY    5.0                         /* Years of validity after the epoch */
+
+/* Below this cosine of the latitude, the eastward component uses the polar summation */
+#define POLAR_COSINE    1.0e-10
+
+#define INDEX(n, m)     ((n) * ((n) + 1) / 2 + (m))
+
+
+/***************************************************************************/
+/*
+ *                              EVALUATION
+ */
+
+static long Check_Geodetic (long Count,
+                            const double *Latitudes,
+                            const double *Longitudes)
+/*
+ * Returns the error codes of the geodetic coordinates of Count points.
+ */
+{ /* BEGIN Check_Geodetic */
+    int Lat_Error = 0;
+    int Lon_Error = 0;
+    long Index;
+
+    for (Index = 0; Index < Count; Index++)
+    {
+        Lat_Error |= (Latitudes[Index] < -PI_OVER_2) | (Latitudes[Index] > PI_OVER_2);
+        Lon_Error |= (Longitudes[Index] < -PI) | (Longitudes[Index] > (2 * PI));
+    }
+
+    return (Lat_Error ? WMM_LAT_ERROR : WMM_NO_ERROR) | (Lon_Error ? WMM_LON_ERROR : WMM_NO_ERROR);
+} /* END OF Check_Geodetic */
+
+
+static long Time_Coefficients (const WMM_Model *Model,
+                               double Decimal_Year,
+                               double *G,
+                               double *H)
+/*
+ * Brings the Gauss coefficients of Model to Decimal_Year.  Returns
+ * WMM_DATE_WARNING if the date is outside of the validity of the model.
+ */
+{ /* BEGIN Time_Coefficients */
+    double Years = Decimal_Year - Model->Epoch;
+    long Index;
+
+    for (Index = 0; Index < WMM_TERMS; Index++)
+    {
+        G[Index] = Model->Main_G[Index] + Years * Model->Secular_G[Index];
+        H[Index] = Model->Main_H[Index] + Years * Model->Secular_H[Index];
+    }
+
+    if ((Years < 0.0) || (Years > WMM_VALIDITY))
+        return (WMM_DATE_WARNING);
+    return (WMM_NO_ERROR);
+} /* END OF Time_Coefficients */
+
+
+static void Evaluate (const WMM_Model *Model,
+                      const double *G,
+                      const double *H,
+                      double Latitude,
+                      double Longitude,
+                      double Height,
+                      WMM_Field *Field)
+/*
+ * Computes the field of the coefficients G and H at a geodetic position.
+ */
+{ /* BEGIN Evaluate */
+    double P[WMM_TERMS];                    /* Schmidt semi-normalized Legendre functions */
+    double dP[WMM_TERMS];                   /* Their derivatives with respect to latitude */
+    double Radius_Power[WMM_MAX_DEGREE + 1];
+    double Cos_Lambda[WMM_MAX_DEGREE + 1];
+    double Sin_Lambda[WMM_MAX_DEGREE + 1];
+    double Es = WGS84_F * (2 - WGS84_F);
+    double Sin_Lat = sin(Latitude);
+    double Cos_Lat = cos(Latitude);
+    double Rn = WGS84_A / sqrt(1.0 - Es * Sin_Lat * Sin_Lat);
+    double Xp = (Rn + Height) * Cos_Lat;
+    double Zp = (Rn * (1.0 - Es) + Height) * Sin_Lat;
+    double R = sqrt(Xp * Xp + Zp * Zp);
+    double Sin_Phi = Zp / R;                /* Sine and cosine of the spherical latitude */
+    double Cos_Phi = Xp / R;
+    double Psi;
+    double Bx = 0.0;
+    double By = 0.0;
+    double Bz = 0.0;
+    double Term;
+    long n, m, Index;
+
+    /* Associated Legendre functions of sin(phi), by their recurrence on the degree */
+    P[0] = 1.0;
+    dP[0] = 0.0;
+    for (n = 1; n <= Model->Degree; n++)
+    {
+        for (m = 0; m <= n; m++)
+        {
+            Index = INDEX(n, m);
+            if (n == m)
+            {
+                P[Index] = Cos_Phi * P[INDEX(n - 1, m - 1)];
+                dP[Index] = Cos_Phi * dP[INDEX(n - 1, m - 1)] + Sin_Phi * P[INDEX(n - 1, m - 1)];
+            }
+            else if (m > n - 2)
+            {
+                P[Index] = Sin_Phi * P[INDEX(n - 1, m)];
+                dP[Index] = Sin_Phi * dP[INDEX(n - 1, m)] - Cos_Phi * P[INDEX(n - 1, m)];
+            }
+            else
+            {
+                P[Index] = Sin_Phi * P[INDEX(n - 1, m)] - Model->Recurrence[Index] * P[INDEX(n - 2, m)];
+                dP[Index] = Sin_Phi * dP[INDEX(n - 1, m)] - Cos_Phi * P[INDEX(n - 1, m)]
+                          - Model->Recurrence[Index] * dP[INDEX(n - 2, m)];
+            }
+        }
+    }
+
+    /* (a / r) ^ (n + 2) and the multiples of the longitude, by angle addition */
+    Radius_Power[0] = (WMM_RADIUS / R) * (WMM_RADIUS / R);
+    Cos_Lambda[0] = 1.0;
+    Sin_Lambda[0] = 0.0;
+    Cos_Lambda[1] = cos(Longitude);
+    Sin_Lambda[1] = sin(Longitude);
+    for (n = 1; n <= Model->Degree; n++)
+        Radius_Power[n] = Radius_Power[n - 1] * (WMM_RADIUS / R);
+    for (m = 2; m <= Model->Degree; m++)
+    {
+        Cos_Lambda[m] = Cos_Lambda[m - 1] * Cos_Lambda[1] - Sin_Lambda[m - 1] * Sin_Lambda[1];
+        Sin_Lambda[m] = Sin_Lambda[m - 1] * Cos_Lambda[1] + Cos_Lambda[m - 1] * Sin_Lambda[1];
+    }
+
+    /* Gradient of the potential in spherical coordinates */
+    for (n = 1; n <= Model->Degree; n++)
+    {
+        for (m = 0; m <= n; m++)
+        {
+            Index = INDEX(n, m);
+            Term = G[Index] * Cos_Lambda[m] + H[Index] * Sin_Lambda[m];
+            Bz -= Radius_Power[n] * Term * (n + 1) * Model->Schmidt[Index] * P[Index];
+            By += Radius_Power[n] * (G[Index] * Sin_Lambda[m] - H[Index] * Cos_Lambda[m]) * m * Model->Schmidt[Index] * P[Index];
+            Bx += Radius_Power[n] * Term * Model->Schmidt[Index] * dP[Index];
+        }
+    }
+
+    if (fabs(Cos_Phi) > POLAR_COSINE)
+    {
+        By /= Cos_Phi;
+    }
+    else
+    { /* At the poles, By / cos(phi) is the limit of the order 1 terms */
+        double P_Polar[WMM_MAX_DEGREE + 1];
+
+        By = 0.0;
+        P_Polar[0] = 1.0;
+        for (n = 1; n <= Model->Degree; n++)
+        {
+            Index = INDEX(n, 1);
+            if (n == 1)
+                P_Polar[n] = P_Polar[n - 1];
+            else
+                P_Polar[n] = Sin_Phi * P_Polar[n - 1] - Model->Recurrence[Index] * P_Polar[n - 2];
+            By += Radius_Power[n] * (G[Index] * Sin_Lambda[1] - H[Index] * Cos_Lambda[1]) * P_Polar[n] * Model->Schmidt[Index];
+        }
+    }
+
+    /* Rotation from the spherical to the geodetic frame */
+    Psi = atan2(Sin_Phi, Cos_Phi) - Latitude;
+    Field->X = Bx * cos(Psi) - Bz * sin(Psi);
+    Field->Y = By;
+    Field->Z = Bx * sin(Psi) + Bz * cos(Psi);
+    Field->H = sqrt(Field->X * Field->X + Field->Y * Field->Y);
+    Field->F = sqrt(Field->H * Field->H + Field->Z * Field->Z);
+    Field->Declination = atan2(Field->Y, Field->X);
+    Field->Inclination = atan2(Field->Z, Field->H);
+} /* END OF Evaluate */
+
+
+/***************************************************************************/
+/*
+ *                              FUNCTIONS
+ */
+
+long Parse_WMM_Coefficients (WMM_Model *Model,
+                             const char *Text)
+{ /* BEGIN Parse_WMM_Coefficients */
+    const char *Line = Text;
+    long Error_Code = WMM_NO_ERROR;
+    long n, m, Index;
+    double G, H, Secular_G, Secular_H;
+
+    memset(Model, 0, sizeof(WMM_Model));
+
+    if (sscanf(Line, "%lf %31s", &Model->Epoch, Model->Name) != 2)
+        return (WMM_FORMAT_ERROR);
+
+    while ((Line = strchr(Line, '\n')) != NULL)
+    {
+        Line++;
+        while ((*Line == ' ') || (*Line == '\t') || (*Line == '\r'))
+            Line++;
+        if ((*Line == '\n') || (*Line == '\0'))
+            continue;
+        if (strncmp(Line, "9999", 4) == 0)
+            break;
+
+        if ((sscanf(Line, "%ld %ld %lf %lf %lf %lf", &n, &m, &G, &H, &Secular_G, &Secular_H) != 6)
+            || (n < 1) || (n > WMM_MAX_DEGREE) || (m < 0) || (m > n))
+        {
+            Error_Code |= WMM_FORMAT_ERROR;
+            break;
+        }
+
+        Index = INDEX(n, m);
+        Model->Main_G[Index] = G;
+        Model->Main_H[Index] = H;
+        Model->Secular_G[Index] = Secular_G;
+        Model->Secular_H[Index] = Secular_H;
+        if (n > Model->Degree)
+            Model->Degree = n;
+    }
+
+    if (Model->Degree == 0)
+        Error_Code |= WMM_FORMAT_ERROR;
+
+    /* Schmidt semi-normalization factors, by recurrence on the degree then the order */
+    Model->Schmidt[0] = 1.0;
+    for (n = 1; n <= WMM_MAX_DEGREE; n++)
+    {
+        Model->Schmidt[INDEX(n, 0)] = Model->Schmidt[INDEX(n - 1, 0)] * (2 * n - 1) / (double) n;
+        for (m = 1; m <= n; m++)
+        {
+            Model->Schmidt[INDEX(n, m)] = Model->Schmidt[INDEX(n, m - 1)]
+                                        * sqrt((double) ((n - m + 1) * ((m == 1) ? 2 : 1)) / (double) (n + m));
+        }
+    }
+
+    /* Coefficients of the recurrence of the Legendre functions on the degree */
+    for (n = 2; n <= WMM_MAX_DEGREE; n++)
+    {
+        for (m = 0; m <= n - 2; m++)
+        {
+            Model->Recurrence[INDEX(n, m)] = (double) ((n - 1) * (n - 1) - m * m) / (double) ((2 * n - 1) * (2 * n - 3));
+        }
+    }
+
+    return (Error_Code);
+} /* END OF Parse_WMM_Coefficients */
+
+
+long Read_WMM_Coefficients (WMM_Model *Model,
+                            const char *File_Name)
+{ /* BEGIN Read_WMM_Coefficients */
+    FILE *File = fopen(File_Name, "rb");
+    char *Text;
+    long Size;
+    long Error_Code;
+
+    if (File == NULL)
+        return (WMM_FILE_ERROR);
+
+    fseek(File, 0, SEEK_END);
+    Size = ftell(File);
+    fseek(File, 0, SEEK_SET);
+
+    Text = (Size >= 0) ? (char *) malloc(Size + 1) : NULL;
+    if ((Text == NULL) || ((long) fread(Text, 1, Size, File) != Size))
+    {
+        free(Text);
+        fclose(File);
+        return (WMM_FILE_ERROR);
+    }
+    fclose(File);
+
+    Text[Size] = '\0';
+    Error_Code = Parse_WMM_Coefficients(Model, Text);
+    free(Text);
+    return (Error_Code);
+} /* END OF Read_WMM_Coefficients */
+
+
+double WMM_Decimal_Year (long Year,
+                         long Month,
+                         long Day)
+{ /* BEGIN WMM_Decimal_Year */
+    static const int Month_Days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    int Leap = ((Year % 4 == 0) && (Year % 100 != 0)) || (Year % 400 == 0);
+    long Day_Of_Year = Day - 1;
+    long Index;
+
+    for (Index = 1; (Index < Month) && (Index <= 12); Index++)
+        Day_Of_Year += Month_Days[Index - 1] + ((Index == 2) ? Leap : 0);
+
+    return (Year + Day_Of_Year / (365.0 + Leap));
+} /* END OF WMM_Decimal_Year */
+
+
+long Compute_WMM_Field (const WMM_Model *Model,
+                        double Latitude,
+                        double Longitude,
+                        double Height,
+                        double Decimal_Year,
+                        WMM_Field *Field)
+{ /* BEGIN Compute_WMM_Field */
+    return (Compute_WMM_Field_Batch(Model, Decimal_Year, 1, &Latitude, &Longitude, &Height, Field));
+} /* END OF Compute_WMM_Field */
+
+
+long Compute_WMM_Field_Batch (const WMM_Model *Model,
+                              double Decimal_Year,
+                              long Count,
+                              const double *Latitudes,
+                              const double *Longitudes,
+                              const double *Heights,
+                              WMM_Field *Fields)
+{ /* BEGIN Compute_WMM_Field_Batch */
+    double G[WMM_TERMS];
+    double H[WMM_TERMS];
+    long Error_Code = Check_Geodetic (Count, Latitudes, Longitudes);
+    long Index;
+
+    if (!Error_Code)
+    { /* no errors */
+        Error_Code = Time_Coefficients (Model, Decimal_Year, G, H);
+        for (Index = 0; Index < Count; Index++)
+            Evaluate (Model, G, H, Latitudes[Index], Longitudes[Index], Heights[Index], &Fields[Index]);
+    }
+    return (Error_Code);
+} /* END OF Compute_WMM_Field_Batch */
@@ -0,0 +1,201 @@
+#ifndef WMM_H
+#define WMM_H
+
+#include "../qtplus_global.h"
+
+/***************************************************************************/
+/* RSC IDENTIFIER:  WORLD MAGNETIC MODEL
+ *
+ * ABSTRACT
+ *
+ *    This component computes the main magnetic field of the Earth with the
+ *    World Magnetic Model : field components, declination and inclination at
+ *    a geodetic position (latitude, longitude in radians and height above the
+ *    WGS 84 ellipsoid in meters) and a date, in decimal years.
+ *
+ *    The coefficients are read once from a WMM.COF file into a model.  The
+ *    normalization factors and recurrence coefficients of the Legendre
+ *    functions are computed at the same time, so that evaluations only run
+ *    the recurrences.  Like the contexts of the other components, models are
+ *    only read by evaluations : threads may share one.
+ *
+ * ERROR HANDLING
+ *
+ *    This component checks parameters for valid values.  If an invalid value
+ *    is found, the error code is combined with the current error code using
+ *    the bitwise or.  This combining allows multiple error codes to be
+ *    returned. The possible error codes are:
+ *
+ *      WMM_NO_ERROR            : No errors occurred in function
+ *      WMM_FILE_ERROR          : Coefficient file could not be read
+ *      WMM_FORMAT_ERROR        : Invalid header or coefficient line
+ *      WMM_LAT_ERROR           : Latitude out of valid range
+ *                                 (-90 to 90 degrees)
+ *      WMM_LON_ERROR           : Longitude out of valid range
+ *                                 (-180 to 360 degrees)
+ *      WMM_DATE_WARNING        : Date outside of the 5 years of validity of
+ *                                 the model, the field is still computed
+ *
+ * REFERENCES
+ *
+ *    The US/UK World Magnetic Model for 2015-2020, A. Chulliat et al.,
+ *    NOAA National Geophysical Data Center (2015).  The model, its
+ *    equations and the test values come from this report.
+ *
+ */
+
+
+/***************************************************************************/
+/*
+ *                              DEFINES
+ */
+
+#define WMM_NO_ERROR                0x0000
+#define WMM_FILE_ERROR              0x0001
+#define WMM_FORMAT_ERROR            0x0002
+#define WMM_LAT_ERROR               0x0004
+#define WMM_LON_ERROR               0x0008
+#define WMM_DATE_WARNING            0x0010
+
+#define WMM_MAX_DEGREE              12    /* Highest degree of WMM.COF files */
+#define WMM_TERMS                   (((WMM_MAX_DEGREE) + 1) * ((WMM_MAX_DEGREE) + 2) / 2)
+
+
+/***************************************************************************/
+/*
+ *                              TYPES
+ */
+
+/*
+ * WMM_Model holds the coefficients of a World Magnetic Model file, indexed
+ * by n * (n + 1) / 2 + m for degree n and order m, and the factors that
+ * evaluations derive from them.
+ */
+typedef struct WMM_Model_Value
+{
+  double Epoch;                           /* Decimal year of the coefficients */
+  char   Name[32];                        /* Name of the model, as WMM-2015 */
+  long   Degree;                          /* Highest degree of the coefficients */
+  double Main_G[WMM_TERMS];               /* Gauss coefficients g, in nT */
+  double Main_H[WMM_TERMS];               /* Gauss coefficients h, in nT */
+  double Secular_G[WMM_TERMS];            /* Secular variation of g, in nT per year */
+  double Secular_H[WMM_TERMS];            /* Secular variation of h, in nT per year */
+  double Schmidt[WMM_TERMS];              /* Schmidt semi-normalization factors */
+  double Recurrence[WMM_TERMS];           /* Coefficients of the Legendre recurrence */
+} WMM_Model;
+
+/*
+ * WMM_Field holds the magnetic field at a point, in the geodetic frame.
+ */
+typedef struct WMM_Field_Value
+{
+  double X;                               /* Northward component, in nT */
+  double Y;                               /* Eastward component, in nT */
+  double Z;                               /* Downward component, in nT */
+  double H;                               /* Horizontal intensity, in nT */
+  double F;                               /* Total intensity, in nT */
+  double Declination;                     /* Angle from true north to H, east positive, in radians */
+  double Inclination;                     /* Angle from H to the field, down positive, in radians */
+} WMM_Field;
+
+
+/***************************************************************************/
+/*
+ *                              FUNCTION PROTOTYPES
+ *                                for WMM.C
+ */
+
+/* ensure proper linkage to c++ programs */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+long QTPLUSSHARED_EXPORT Parse_WMM_Coefficients (WMM_Model *Model,
+                                                 const char *Text);
+/*
+ * The function Parse_WMM_Coefficients reads the contents of a WMM.COF file
+ * into Model and computes the factors used by evaluations.  Reading stops
+ * at the end of Text or at the line of 9s that ends the file.  If any
+ * errors occur, the error code(s) are returned by the function, otherwise
+ * WMM_NO_ERROR is returned.
+ *
+ *    Model      : Model to set up                                (output)
+ *    Text       : Contents of the coefficient file, 0 terminated (input)
+ */
+
+
+long QTPLUSSHARED_EXPORT Read_WMM_Coefficients (WMM_Model *Model,
+                                                const char *File_Name);
+/*
+ * The function Read_WMM_Coefficients reads the coefficient file File_Name
+ * into Model, as Parse_WMM_Coefficients.  If any errors occur, the error
+ * code(s) are returned by the function, otherwise WMM_NO_ERROR is returned.
+ *
+ *    Model      : Model to set up                                (output)
+ *    File_Name  : Path of the coefficient file                   (input)
+ */
+
+
+double QTPLUSSHARED_EXPORT WMM_Decimal_Year (long Year,
+                                             long Month,
+                                             long Day);
+/*
+ * The function WMM_Decimal_Year returns the date Year, Month, Day as a
+ * decimal year, the unit of dates of the model.
+ *
+ *    Year       : Year                                           (input)
+ *    Month      : Month, 1 to 12                                 (input)
+ *    Day        : Day of the month, 1 to 31                      (input)
+ */
+
+
+long QTPLUSSHARED_EXPORT Compute_WMM_Field (const WMM_Model *Model,
+                                            double Latitude,
+                                            double Longitude,
+                                            double Height,
+                                            double Decimal_Year,
+                                            WMM_Field *Field);
+/*
+ * The function Compute_WMM_Field computes the magnetic field of Model at a
+ * geodetic position and date.  If any errors occur, the error code(s) are
+ * returned by the function, otherwise WMM_NO_ERROR is returned.
+ *
+ *    Model        : Coefficients of the model                    (input)
+ *    Latitude     : Geodetic latitude in radians                 (input)
+ *    Longitude    : Geodetic longitude in radians                (input)
+ *    Height       : Height above the ellipsoid, in meters        (input)
+ *    Decimal_Year : Date in decimal years                        (input)
+ *    Field        : Magnetic field at the position               (output)
+ */
+
+
+long QTPLUSSHARED_EXPORT Compute_WMM_Field_Batch (const WMM_Model *Model,
+                                                  double Decimal_Year,
+                                                  long Count,
+                                                  const double *Latitudes,
+                                                  const double *Longitudes,
+                                                  const double *Heights,
+                                                  WMM_Field *Fields);
+/*
+ * The function Compute_WMM_Field_Batch computes the magnetic field of Model
+ * at Count geodetic positions, all at the same date.  The coefficients are
+ * brought to the date once for all positions.  Nothing is computed if a
+ * position is out of range.  If any errors occur, the error code(s) are
+ * returned by the function, otherwise WMM_NO_ERROR is returned.
+ *
+ *    Model        : Coefficients of the model                    (input)
+ *    Decimal_Year : Date in decimal years                        (input)
+ *    Count        : Number of positions                          (input)
+ *    Latitudes    : Geodetic latitudes in radians                (input)
+ *    Longitudes   : Geodetic longitudes in radians               (input)
+ *    Heights      : Heights above the ellipsoid, in meters       (input)
+ *    Fields       : Magnetic field at each position              (output)
+ */
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WMM_H */
@@ -3,8 +3,11 @@
 #include <QMessageBox>
 #include <QFileInfo>
 #include <QDir>
-#include <QRegExp>
+#include <QThreadPool>
+#include <QRunnable>
 #include <QMutexLocker>
+#include <QDirIterator>
+#include <QCryptographicHash>
 #include <QDebug>
 
 // Application
@@ -22,6 +25,12 @@
     \section1 How it works
     This class runs checks over all contents of a QML file using a grammar file in XML format.
 
+    \section1 Watch mode
+    startWatching() runs a first analysis, then keeps the parsed files in memory and watches them with a QFileSystemWatcher.
+    When files change, only those are parsed again. Files importing the folder of a changed, added or removed file are
+    analyzed again as well, since their analysis depends on that folder. Errors of the analyzed files are emitted
+    through analyzeError() and each pass ends with analysisUpdated().
+
     \section1 Format of the XML grammar file.
 
     \section2 \c <Macro> tag
@@ -416,6 +425,36 @@
 
 //-------------------------------------------------------------------------------------------------
 
+//! Runs the grammar on one file on a thread of the pool
+class QMLFileChecker : public QRunnable
+{
+public:
+
+    QMLFileChecker(QMLAnalyzer* pAnalyzer, QMLFile* pFile, QVector<QMLAnalyzerError>* pErrors)
+        : m_pAnalyzer(pAnalyzer)
+        , m_pFile(pFile)
+        , m_pErrors(pErrors)
+    {
+    }
+
+    virtual void run() Q_DECL_OVERRIDE
+    {
+        // Files still waiting in the pool are skipped once a stop is requested
+        if (m_pAnalyzer->m_iStopAnalyzeRequested.loadAcquire() == 0)
+        {
+            m_pAnalyzer->runGrammar(m_pFile, *m_pErrors);
+        }
+    }
+
+protected:
+
+    QMLAnalyzer*                m_pAnalyzer;
+    QMLFile*                    m_pFile;
+    QVector<QMLAnalyzerError>*  m_pErrors;
+};
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Constructs a QMLAnalyzer.
 */
@@ -427,8 +466,15 @@ QMLAnalyzer::QMLAnalyzer()
     , m_bIncludeSubFolders(false)
     , m_bRewriteFiles(false)
     , m_bRemoveUnreferencedSymbols(false)
-    , m_bStopAnalyzeRequested(false)
+    , m_iStopAnalyzeRequested(0)
+    , m_iMaxThreads(1)
+    , m_bRulesCompiled(false)
+    , m_pWatcher(nullptr)
 {
+    m_tWatchTimer.setSingleShot(true);
+    m_tWatchTimer.setInterval(ANALYZER_WATCH_DELAY);
+
+    connect(&m_tWatchTimer, SIGNAL(timeout()), this, SLOT(onWatchTimeout()));
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -438,6 +484,8 @@ QMLAnalyzer::QMLAnalyzer()
 */
 QMLAnalyzer::~QMLAnalyzer()
 {
+    stopWatching();
+
     if (m_pContext != nullptr)
     {
         delete m_pContext;
@@ -506,6 +554,26 @@ void QMLAnalyzer::setRemoveUnreferencedSymbols(bool bValue)
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Sets the maximum number of parsing threads to \a iValue. With more than one thread, all files of the base folder are parsed in one go on a thread pool.
+*/
+void QMLAnalyzer::setMaxThreads(int iValue)
+{
+    m_iMaxThreads = qMax(1, iValue);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the folder of the parse cache to \a sFolder. Files that did not change since a previous run are read from the cache instead of being parsed.
+*/
+void QMLAnalyzer::setCacheFolder(const QString& sFolder)
+{
+    m_sCacheFolder = sFolder;
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Returns the name of the base folder.
 */
@@ -538,6 +606,16 @@ QMLTreeContext* QMLAnalyzer::context()
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Returns \c true between startWatching() and stopWatching().
+*/
+bool QMLAnalyzer::isWatching() const
+{
+    return m_pWatcher != nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Deletes the parsing context and allocates a new one.
 */
@@ -554,15 +632,10 @@ void QMLAnalyzer::clear()
 //-------------------------------------------------------------------------------------------------
 
 /*!
-    Runs an analysis on the specified folder or file using \a xGrammar. Returns \c true on success.
+    Replaces the parsing context with a new one and clears the error list.
 */
-bool QMLAnalyzer::analyze(const CXMLNode& xRules, const CXMLNode& xFormat)
+void QMLAnalyzer::resetContext()
 {
-    m_xNewRules = xRules;
-    m_xNewFormat = xFormat;
-
-    setGrammar(m_xNewRules);
-
     {
         QMutexLocker locker(&m_mContextMutex);
 
@@ -572,6 +645,8 @@ bool QMLAnalyzer::analyze(const CXMLNode& xRules, const CXMLNode& xFormat)
         }
 
         m_pContext = new QMLTreeContext();
+        m_pContext->setMaxThreads(m_iMaxThreads);
+        m_pContext->setCacheFolder(m_sCacheFolder);
 
         m_vErrors.clear();
     }
@@ -579,10 +654,35 @@ bool QMLAnalyzer::analyze(const CXMLNode& xRules, const CXMLNode& xFormat)
     connect(m_pContext, SIGNAL(parsingStarted(QString)), this, SIGNAL(parsingStarted(QString)), Qt::DirectConnection);
     connect(m_pContext, SIGNAL(parsingFinished(QString)), this, SIGNAL(parsingFinished(QString)), Qt::DirectConnection);
     connect(m_pContext, SIGNAL(importParsingStarted(QString)), this, SIGNAL(importParsingStarted(QString)), Qt::DirectConnection);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Runs an analysis on the specified folder or file using \a xGrammar. Returns \c true on success.
+*/
+bool QMLAnalyzer::analyze(const CXMLNode& xRules, const CXMLNode& xFormat)
+{
+    m_xNewRules = xRules;
+    m_xNewFormat = xFormat;
+
+    setGrammar(m_xNewRules);
+    compileRules();
+
+    resetContext();
 
     if (m_sFolder.isEmpty() == false)
     {
-        analyzeRecurse(m_sFolder);
+        if (m_iMaxThreads > 1)
+        {
+            QStringList lFileNames;
+            collectFiles(m_sFolder, lFileNames);
+            analyzeFiles(lFileNames);
+        }
+        else
+        {
+            analyzeRecurse(m_sFolder);
+        }
     }
     else if (m_sFile.isEmpty() == false)
     {
@@ -617,9 +717,9 @@ void QMLAnalyzer::stopThreadedAnalyze()
 {
     if (isRunning())
     {
-        m_bStopAnalyzeRequested = true;
+        m_iStopAnalyzeRequested.storeRelease(1);
         wait();
-        m_bStopAnalyzeRequested = false;
+        m_iStopAnalyzeRequested.storeRelease(0);
     }
 }
 
@@ -646,43 +746,579 @@ bool QMLAnalyzer::analyzeFile(const QString& sFileName)
 
     if (m_pContext->parse() == QMLTreeContext::peSuccess)
     {
-        QMLFile* pFile = m_pContext->fileByFileName(sFileName);
+        checkFile(sFileName);
+    }
+    else
+    {
+        m_vErrors << m_pContext->error();
 
-        if (pFile != nullptr)
-        {
-            runGrammar(pFile);
+        emit analyzeError(m_vErrors.last());
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Runs an analysis on all files in \a lFileNames, parsing them together and running the grammar on them in parallel. Returns \c true on success.
+*/
+bool QMLAnalyzer::analyzeFiles(const QStringList& lFileNames)
+{
+    for (const QString& sFileName : lFileNames)
+    {
+        m_pContext->addFile(sFileName);
+    }
+
+    m_pContext->setIncludeImports(m_bIncludeImports);
+    m_pContext->parse();
+
+    return checkFiles(lFileNames, m_pContext->fileErrors());
+}
+
+//-------------------------------------------------------------------------------------------------
 
-            if (m_bRewriteFiles)
+/*!
+    Runs the grammar in parallel on the parsed files of \a lFileNames, then reports errors and rewrites files in list order. \br\br
+    Files listed in \a mFileErrors did not parse : their parse error is reported instead. Returns \c false if stopped.
+*/
+bool QMLAnalyzer::checkFiles(const QStringList& lFileNames, const QMap<QString, QMLAnalyzerError>& mFileErrors)
+{
+    if (m_bRulesCompiled == false)
+    {
+        compileRules();
+    }
+
+    QVector<QMLFile*> vFiles(lFileNames.count(), nullptr);
+    QVector<QVector<QMLAnalyzerError> > vGrammarErrors(lFileNames.count());
+
+    // The grammar only reads the tree of the file it checks : run it on all files at once
+    {
+        QThreadPool tThreadPool;
+        tThreadPool.setMaxThreadCount(m_iMaxThreads);
+
+        for (int iIndex = 0; iIndex < lFileNames.count(); iIndex++)
+        {
+            if (mFileErrors.contains(lFileNames[iIndex]) == false)
             {
-                if (m_bRemoveUnreferencedSymbols)
+                vFiles[iIndex] = m_pContext->fileByFileName(lFileNames[iIndex]);
+
+                if (vFiles[iIndex] != nullptr)
                 {
-                    pFile->removeUnreferencedSymbols(m_pContext);
+                    tThreadPool.start(new QMLFileChecker(this, vFiles[iIndex], &vGrammarErrors[iIndex]));
                 }
+            }
+        }
 
-                pFile->sortContents();
+        tThreadPool.waitForDone();
+    }
 
-                m_pContext->writeFile(pFile, m_xNewFormat);
-            }
+    // Errors are reported and files are rewritten in the order of the list
+    for (int iIndex = 0; iIndex < lFileNames.count(); iIndex++)
+    {
+        if (m_iStopAnalyzeRequested.loadAcquire() != 0)
+            return false;
+
+        if (mFileErrors.contains(lFileNames[iIndex]))
+        {
+            m_vErrors << mFileErrors[lFileNames[iIndex]];
+
+            emit analyzeError(m_vErrors.last());
+        }
+        else if (vFiles[iIndex] != nullptr)
+        {
+            publishErrors(vGrammarErrors[iIndex]);
+            rewriteFile(vFiles[iIndex]);
         }
     }
-    else
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Analyzes the folder or file using \a xRules and \a xFormat, then watches it for changes. Returns \c true on success. \br\br
+    Parsed files stay in memory : when files change, are added or are removed, only those are parsed again and only the
+    files depending on them are analyzed again. Changes are handled by the event loop of the analyzer's thread.
+    Each file owns the arena of its tree, so the memory of a replaced tree is given back as soon as its file is replaced.
+*/
+bool QMLAnalyzer::startWatching(const CXMLNode& xRules, const CXMLNode& xFormat)
+{
+    stopWatching();
+
+    m_xNewRules = xRules;
+    m_xNewFormat = xFormat;
+
+    setGrammar(m_xNewRules);
+    compileRules();
+
+    resetContext();
+
+    QMutexLocker locker(&m_mContextMutex);
+
+    m_hFileStamps.clear();
+    m_hFileImports.clear();
+    m_hImporters.clear();
+    m_mParseErrors.clear();
+
+    m_lWatchedFiles = analyzedFileNames();
+
+    for (const QString& sFileName : m_lWatchedFiles)
     {
-        m_vErrors << m_pContext->error();
+        m_pContext->addFile(sFileName);
+    }
 
-        emit analyzeError(m_vErrors.last());
+    parseWatchedFiles(m_lWatchedFiles);
+    checkFiles(m_lWatchedFiles, m_mParseErrors);
+
+    // Stamps are taken after a possible rewrite, which must not trigger a new analysis
+    for (const QString& sFileName : m_lWatchedFiles)
+    {
+        m_hFileStamps[sFileName] = fileStamp(sFileName);
     }
 
+    m_pWatcher = new QFileSystemWatcher(this);
+
+    connect(m_pWatcher, SIGNAL(fileChanged(QString)), this, SLOT(onWatchedPathChanged(QString)));
+    connect(m_pWatcher, SIGNAL(directoryChanged(QString)), this, SLOT(onWatchedPathChanged(QString)));
+
+    updateWatchedPaths();
+
     return true;
 }
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Stops watching. Parsed files and errors are kept until the next analysis.
+*/
+void QMLAnalyzer::stopWatching()
+{
+    m_tWatchTimer.stop();
+    m_sPendingPaths.clear();
+
+    if (m_pWatcher != nullptr)
+    {
+        delete m_pWatcher;
+        m_pWatcher = nullptr;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Analyzes again what depends on the files or folders in \a lPaths. \br\br
+    Changed and added files are parsed again, removed files are dropped. Files that import the folder of any of them,
+    or one of the folders in \a lPaths, are analyzed again without being parsed. Errors of all these files are removed
+    from the error list before their new errors are emitted. Does nothing when not watching.
+*/
+void QMLAnalyzer::reanalyzeFiles(const QStringList& lPaths)
+{
+    if (isWatching() == false)
+        return;
+
+    // The file list of the context changes : readers of context() must wait
+    QMutexLocker locker(&m_mContextMutex);
+
+    QStringList lFileNames = analyzedFileNames();
+    QSet<QString> sCurrentFiles = lFileNames.toSet();
+    QSet<QString> sKnownFiles = m_lWatchedFiles.toSet();
+    QSet<QString> sParsedFiles;
+    QSet<QString> sAffectedFiles;
+    QSet<QString> sChangedFolders;
+
+    // Removed files
+    for (const QString& sFileName : m_lWatchedFiles)
+    {
+        if (sCurrentFiles.contains(sFileName) == false)
+        {
+            forgetFile(sFileName);
+            sAffectedFiles << sFileName;
+            sChangedFolders << pathKey(QFileInfo(sFileName).absolutePath());
+        }
+    }
+
+    // Added files
+    for (const QString& sFileName : lFileNames)
+    {
+        if (sKnownFiles.contains(sFileName) == false)
+        {
+            sParsedFiles << sFileName;
+            sChangedFolders << pathKey(QFileInfo(sFileName).absolutePath());
+        }
+    }
+
+    // Changed files and folders, contents that did not change are ignored
+    for (const QString& sPath : lPaths)
+    {
+        if (sCurrentFiles.contains(sPath))
+        {
+            if (sKnownFiles.contains(sPath) && fileStamp(sPath) != m_hFileStamps.value(sPath))
+            {
+                sParsedFiles << sPath;
+                sChangedFolders << pathKey(QFileInfo(sPath).absolutePath());
+            }
+        }
+        else if (QFileInfo(sPath).isDir())
+        {
+            sChangedFolders << pathKey(sPath);
+        }
+    }
+
+    // Files importing a changed folder
+    for (const QString& sFolder : sChangedFolders)
+    {
+        for (const QString& sImporter : m_hImporters.value(sFolder))
+        {
+            if (sCurrentFiles.contains(sImporter))
+            {
+                sAffectedFiles << sImporter;
+            }
+        }
+    }
+
+    sAffectedFiles += sParsedFiles;
+
+    m_lWatchedFiles = lFileNames;
+
+    if (sAffectedFiles.isEmpty())
+        return;
+
+    for (const QString& sFileName : sParsedFiles)
+    {
+        m_pContext->removeFile(sFileName);
+        m_pContext->addFile(sFileName);
+    }
+
+    parseWatchedFiles(sParsedFiles.toList());
+
+    // Previous errors of the affected files are replaced
+    for (int iIndex = 0; iIndex < m_vErrors.count(); iIndex++)
+    {
+        if (sAffectedFiles.contains(m_vErrors[iIndex].fileName()))
+        {
+            m_vErrors.removeAt(iIndex);
+            iIndex--;
+        }
+    }
+
+    QStringList lAffectedFiles;
+
+    for (const QString& sFileName : lFileNames)
+    {
+        if (sAffectedFiles.contains(sFileName))
+        {
+            lAffectedFiles << sFileName;
+        }
+    }
+
+    checkFiles(lAffectedFiles, m_mParseErrors);
+
+    for (const QString& sFileName : lAffectedFiles)
+    {
+        m_hFileStamps[sFileName] = fileStamp(sFileName);
+    }
+
+    updateWatchedPaths();
+
+    QStringList lUpdatedFiles = sAffectedFiles.toList();
+    lUpdatedFiles.sort();
+
+    emit analysisUpdated(lUpdatedFiles);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Queues the change of \a sPath, changes are handled together once they settle.
+*/
+void QMLAnalyzer::onWatchedPathChanged(const QString& sPath)
+{
+    m_sPendingPaths << sPath;
+    m_tWatchTimer.start();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Handles the queued changes.
+*/
+void QMLAnalyzer::onWatchTimeout()
+{
+    QStringList lPaths = m_sPendingPaths.toList();
+    m_sPendingPaths.clear();
+
+    reanalyzeFiles(lPaths);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the files to analyze : those of the folder, in the order of \c analyzeRecurse(), or the single file.
+*/
+QStringList QMLAnalyzer::analyzedFileNames()
+{
+    QStringList lFileNames;
+
+    if (m_sFolder.isEmpty() == false)
+    {
+        collectFiles(m_sFolder, lFileNames);
+    }
+    else if (m_sFile.isEmpty() == false && QFileInfo(m_sFile).exists())
+    {
+        lFileNames << m_sFile;
+    }
+
+    return lFileNames;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Parses the files added to the context and records the parse errors and imports of \a lFileNames.
+*/
+void QMLAnalyzer::parseWatchedFiles(const QStringList& lFileNames)
+{
+    m_pContext->setIncludeImports(m_bIncludeImports);
+    m_pContext->parse();
+
+    QMap<QString, QMLAnalyzerError> mFileErrors = m_pContext->fileErrors();
+
+    for (const QString& sFileName : lFileNames)
+    {
+        if (mFileErrors.contains(sFileName))
+            m_mParseErrors[sFileName] = mFileErrors[sFileName];
+        else
+            m_mParseErrors.remove(sFileName);
+
+        updateImports(sFileName);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Records the folders imported by \a sFileName, as \c runGrammar_importUsed() resolves them.
+*/
+void QMLAnalyzer::updateImports(const QString& sFileName)
+{
+    for (const QString& sFolder : m_hFileImports.take(sFileName))
+    {
+        m_hImporters[sFolder].remove(sFileName);
+
+        if (m_hImporters[sFolder].isEmpty())
+            m_hImporters.remove(sFolder);
+    }
+
+    QMLFile* pFile = nullptr;
+
+    for (QMLFile* pCandidate : m_pContext->files())
+    {
+        if (pCandidate->fileName() == sFileName)
+        {
+            pFile = pCandidate;
+            break;
+        }
+    }
+
+    if (pFile == nullptr)
+        return;
+
+    QString sFileFolder = QFileInfo(sFileName).absolutePath();
+    QStringList lFolders;
+
+    for (QMLEntity* pEntity : pFile->contents())
+    {
+        QMLImport* pImport = dynamic_cast<QMLImport*>(pEntity);
+
+        if (pImport != nullptr && pImport->name() != nullptr)
+        {
+            QString sFolder = pathKey(sFileFolder + "/" + pImport->name()->value().toString());
+
+            if (lFolders.contains(sFolder) == false)
+            {
+                lFolders << sFolder;
+                m_hImporters[sFolder] << sFileName;
+            }
+        }
+    }
+
+    if (lFolders.isEmpty() == false)
+    {
+        m_hFileImports[sFileName] = lFolders;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Removes \a sFileName from the context, the dependency graph and the error list.
+*/
+void QMLAnalyzer::forgetFile(const QString& sFileName)
+{
+    m_pContext->removeFile(sFileName);
+    m_mParseErrors.remove(sFileName);
+    m_hFileStamps.remove(sFileName);
+
+    for (const QString& sFolder : m_hFileImports.take(sFileName))
+    {
+        m_hImporters[sFolder].remove(sFileName);
+
+        if (m_hImporters[sFolder].isEmpty())
+            m_hImporters.remove(sFolder);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Makes the watcher follow the analyzed files, the folders holding them, the base folder and its subfolders if
+    included, and the imported folders. Files replaced on disk are watched again.
+*/
+void QMLAnalyzer::updateWatchedPaths()
+{
+    if (m_pWatcher == nullptr)
+        return;
+
+    QSet<QString> sFiles;
+    QSet<QString> sFolders;
+
+    for (const QString& sFileName : m_lWatchedFiles)
+    {
+        sFiles << sFileName;
+        sFolders << QFileInfo(sFileName).absolutePath();
+    }
+
+    if (m_sFolder.isEmpty() == false)
+    {
+        sFolders << QFileInfo(m_sFolder).absoluteFilePath();
+
+        if (m_bIncludeSubFolders)
+        {
+            QDirIterator tIterator(m_sFolder, QDir::AllDirs | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDirIterator::Subdirectories);
+
+            while (tIterator.hasNext())
+            {
+                sFolders << QFileInfo(tIterator.next()).absoluteFilePath();
+            }
+        }
+    }
+
+    for (QHash<QString, QSet<QString> >::const_iterator iter = m_hImporters.constBegin(); iter != m_hImporters.constEnd(); ++iter)
+    {
+        if (QFileInfo(iter.key()).isDir())
+        {
+            sFolders << iter.key();
+        }
+    }
+
+    QStringList lObsolete;
+
+    for (const QString& sFileName : m_pWatcher->files())
+    {
+        if (sFiles.remove(sFileName) == false)
+            lObsolete << sFileName;
+    }
+
+    for (const QString& sFolder : m_pWatcher->directories())
+    {
+        if (sFolders.remove(sFolder) == false)
+            lObsolete << sFolder;
+    }
+
+    if (lObsolete.isEmpty() == false)
+        m_pWatcher->removePaths(lObsolete);
+
+    QStringList lNewPaths = (sFiles + sFolders).toList();
+
+    if (lNewPaths.isEmpty() == false)
+        m_pWatcher->addPaths(lNewPaths);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the canonical path of \a sPath, or its clean absolute path if it does not exist.
+*/
+QString QMLAnalyzer::pathKey(const QString& sPath)
+{
+    QFileInfo tInfo(sPath);
+    QString sCanonical = tInfo.canonicalFilePath();
+
+    return sCanonical.isEmpty() ? QDir::cleanPath(tInfo.absoluteFilePath()) : sCanonical;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns a hash of the contents of \a sFileName, empty if the file cannot be read.
+*/
+QByteArray QMLAnalyzer::fileStamp(const QString& sFileName)
+{
+    QFile tFile(sFileName);
+
+    if (tFile.open(QIODevice::ReadOnly) == false)
+        return QByteArray();
+
+    QCryptographicHash tHash(QCryptographicHash::Sha1);
+    tHash.addData(&tFile);
+
+    return tHash.result();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Runs the grammar on the parsed file \a sFileName and rewrites it if required.
+*/
+void QMLAnalyzer::checkFile(const QString& sFileName)
+{
+    QMLFile* pFile = m_pContext->fileByFileName(sFileName);
+
+    if (pFile != nullptr)
+    {
+        if (m_bRulesCompiled == false)
+        {
+            compileRules();
+        }
+
+        QVector<QMLAnalyzerError> vErrors;
+
+        runGrammar(pFile, vErrors);
+        publishErrors(vErrors);
+        rewriteFile(pFile);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Rewrites \a pFile if the rewrite files flag is set.
+*/
+void QMLAnalyzer::rewriteFile(QMLFile* pFile)
+{
+    if (m_bRewriteFiles)
+    {
+        if (m_bRemoveUnreferencedSymbols)
+        {
+            pFile->removeUnreferencedSymbols(m_pContext);
+        }
+
+        pFile->sortContents();
+
+        m_pContext->writeFile(pFile, m_xNewFormat);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Runs an analysis on the files in \a sDirectory. Returns \c true on success.
 */
 bool QMLAnalyzer::analyzeRecurse(QString sDirectory)
 {
-    if (m_bStopAnalyzeRequested)
+    if (m_iStopAnalyzeRequested.loadAcquire() != 0)
         return false;
 
     QStringList slNameFilter;
@@ -699,7 +1335,7 @@ bool QMLAnalyzer::analyzeRecurse(QString sDirectory)
 
         analyzeFile(sFullName);
 
-        if (m_bStopAnalyzeRequested)
+        if (m_iStopAnalyzeRequested.loadAcquire() != 0)
             return false;
     }
 
@@ -725,67 +1361,162 @@ bool QMLAnalyzer::analyzeRecurse(QString sDirectory)
 //-------------------------------------------------------------------------------------------------
 
 /*!
-    Runs a check on the contents of \a pFile.
+    Appends the names of the files to analyze in \a sDirectory to \a lFileNames, in the order used by \c analyzeRecurse().
 */
-void QMLAnalyzer::runGrammar(QMLFile* pFile)
+void QMLAnalyzer::collectFiles(QString sDirectory, QStringList& lFileNames)
 {
-    for (QMLEntity* pEntity : pFile->contents())
+    QStringList slNameFilter;
+    slNameFilter << "*.qml" << "*.js";
+
+    QDir dDirectory(sDirectory);
+
+    dDirectory.setFilter(QDir::NoDotAndDotDot | QDir::NoSymLinks | QDir::Files);
+    QStringList lFiles = dDirectory.entryList(slNameFilter);
+
+    for (QString sFile : lFiles)
     {
-        runGrammar_Recurse(pFile, pEntity);
+        lFileNames << QString("%1/%2").arg(sDirectory).arg(sFile);
+    }
+
+    if (m_bIncludeSubFolders)
+    {
+        dDirectory.setFilter(QDir::AllDirs | QDir::NoDotAndDotDot | QDir::NoSymLinks);
+        QStringList lDirectories = dDirectory.entryList();
+
+        for (QString sNewDirectory : lDirectories)
+        {
+            collectFiles(QString("%1/%2").arg(sDirectory).arg(sNewDirectory), lFileNames);
+        }
     }
 }
 
 //-------------------------------------------------------------------------------------------------
 
 /*!
-    Runs a check on the contents of \a pEntity. \br\br
-    \a pFile is the file being analyzed.
+    Compiles the grammar into a table of rules dispatched by class name. \br\br
+    Macros are expanded, regular expressions and lists are built once here instead of once per entity.
+    The table is built by \c analyze(), or by the first analysis of a file.
 */
-void QMLAnalyzer::runGrammar_Recurse(QMLFile* pFile, QMLEntity* pEntity)
+void QMLAnalyzer::compileRules()
 {
-    if (pEntity != nullptr)
-    {
-        bool bHasRejects = false;
+    m_hRules.clear();
 
-        QMap<QString, QMLEntity*> mMembers = pEntity->members();
+    CXMLNodeList vChecks = grammar().getNodesByTagName(ANALYZER_TOKEN_CHECK);
 
-        CXMLNodeList vChecks = grammar().getNodesByTagName(ANALYZER_TOKEN_CHECK);
+    for (CXMLNode xCheck : vChecks)
+    {
+        QVector<QMLAnalyzerRule>& vRules = m_hRules[xCheck.attributes()[ANALYZER_TOKEN_CLASS].toLatin1()];
+
+        // Rejects come before accepts, as they always did
+        CXMLNodeList vRuleNodes = xCheck.getNodesByTagName(ANALYZER_TOKEN_REJECT);
+        int iFirstAccept = vRuleNodes.count();
+        vRuleNodes.append(xCheck.getNodesByTagName(ANALYZER_TOKEN_ACCEPT));
 
-        for (CXMLNode xCheck : vChecks)
+        for (int iIndex = 0; iIndex < vRuleNodes.count(); iIndex++)
         {
-            QString sClassName = xCheck.attributes()[ANALYZER_TOKEN_CLASS];
+            CXMLNode xRule = vRuleNodes[iIndex];
+            QMLAnalyzerRule tRule;
+
+            tRule.bInverseLogic = iIndex >= iFirstAccept;
+            tRule.sMember = processMacros(xRule.attributes()[ANALYZER_TOKEN_MEMBER].toLower());
+            tRule.sValue = processMacros(xRule.attributes()[TOKEN_VALUE]);
+            tRule.sType = processMacros(xRule.attributes()[ANALYZER_TOKEN_TYPE]);
+            tRule.sText = processMacros(xRule.attributes()[ANALYZER_TOKEN_TEXT]);
+            tRule.sNestedCount = processMacros(xRule.attributes()[ANALYZER_TOKEN_NESTED_COUNT]);
+            tRule.sUnrefedSymbol = processMacros(xRule.attributes()[ANALYZER_TOKEN_UNREFED_SYMBOL]);
+            tRule.sCount = processMacros(xRule.attributes()[ANALYZER_TOKEN_COUNT]);
+            tRule.sRegExp = processMacros(xRule.attributes()[ANALYZER_TOKEN_REGEXP]);
+            tRule.sPath = processMacros(xRule.attributes()[ANALYZER_TOKEN_PATH]);
+            tRule.sClass = processMacros(xRule.attributes()[ANALYZER_TOKEN_CLASS]);
+            tRule.sUsed = processMacros(xRule.attributes()[ANALYZER_TOKEN_USED]);
+            tRule.sDeadCode = processMacros(xRule.attributes()[ANALYZER_TOKEN_DEAD_CODE]);
+
+            QString sList = processMacros(xRule.attributes()[ANALYZER_TOKEN_LIST]);
+
+            if (sList.isEmpty() == false)
+                tRule.lList = sList.split(",");
+
+            tRule.iNestedCount = tRule.sNestedCount.toInt();
+            tRule.iCount = tRule.sCount.toInt();
 
-            if (pEntity->metaObject()->className() == sClassName)
+            if (tRule.sRegExp.isEmpty() == false)
             {
-                CXMLNodeList vAccepts = xCheck.getNodesByTagName(ANALYZER_TOKEN_ACCEPT);
-                CXMLNodeList vRejects = xCheck.getNodesByTagName(ANALYZER_TOKEN_REJECT);
+                tRule.tRegExp.setPattern(QString("\\A(?:%1)\\z").arg(tRule.sRegExp));
+                tRule.tRegExp.optimize();
+            }
 
-                for (CXMLNode xReject : vRejects)
-                {
-                    if (runGrammar_Reject(pFile, sClassName, pEntity, xReject, false))
-                        bHasRejects = true;
-                }
+            for (CXMLNode xCondition : xRule.getNodesByTagName(ANALYZER_TOKEN_CONDITION))
+            {
+                QMLAnalyzerCondition tCondition;
 
-                for (CXMLNode xAccept : vAccepts)
-                {
-                    if (runGrammar_Reject(pFile, sClassName, pEntity, xAccept, true))
-                        bHasRejects = true;
-                }
+                tCondition.sMember = xCondition.attributes()[ANALYZER_TOKEN_MEMBER].toLower();
+                tCondition.sOperation = xCondition.attributes()[ANALYZER_TOKEN_OPERATION];
+                tCondition.sEmpty = xCondition.attributes()[ANALYZER_TOKEN_EMPTY].toLower();
+                tCondition.sValue = xCondition.attributes()[TOKEN_VALUE];
+                tCondition.sClass = xCondition.attributes()[ANALYZER_TOKEN_CLASS];
+                tCondition.bNegate = xCondition.attributes()[ANALYZER_TOKEN_NEGATE].toLower() == ANALYZER_TOKEN_TRUE;
+
+                tRule.vConditions << tCondition;
             }
+
+            vRules << tRule;
         }
+    }
+
+    m_bRulesCompiled = true;
+}
+
+//-------------------------------------------------------------------------------------------------
 
-        for (QString sKey : mMembers.keys())
+/*!
+    Runs a check on the contents of \a pFile, appending errors to \a vErrors. \br\br
+    Only the compiled rules and the tree of \a pFile are read : files can be checked on several threads.
+*/
+void QMLAnalyzer::runGrammar(QMLFile* pFile, QVector<QMLAnalyzerError>& vErrors)
+{
+    for (QMLEntity* pEntity : pFile->contents())
+    {
+        runGrammar_Recurse(pFile, pEntity, vErrors);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Runs a check on the contents of \a pEntity. \br\br
+    \a pFile is the file being analyzed. Returns early when a stop is requested.
+*/
+void QMLAnalyzer::runGrammar_Recurse(QMLFile* pFile, QMLEntity* pEntity, QVector<QMLAnalyzerError>& vErrors)
+{
+    if (pEntity != nullptr && m_iStopAnalyzeRequested.loadAcquire() == 0)
+    {
+        const char* pClassName = pEntity->metaObject()->className();
+
+        QHash<QByteArray, QVector<QMLAnalyzerRule> >::const_iterator iter =
+                m_hRules.constFind(QByteArray::fromRawData(pClassName, int(qstrlen(pClassName))));
+
+        if (iter != m_hRules.constEnd())
         {
-            runGrammar_Recurse(pFile, mMembers[sKey]);
+            QString sClassName(pClassName);
+
+            for (const QMLAnalyzerRule& tRule : iter.value())
+            {
+                runGrammar_Reject(pFile, sClassName, pEntity, tRule, vErrors);
+            }
         }
 
+        pEntity->forEachMember([this, pFile, &vErrors](QMLEntity* pMember)
+        {
+            runGrammar_Recurse(pFile, pMember, vErrors);
+        });
+
         QMLComplexEntity* pComplex = dynamic_cast<QMLComplexEntity*>(pEntity);
 
         if (pComplex != nullptr)
         {
             for (QMLEntity* pChildItem : pComplex->contents())
             {
-                runGrammar_Recurse(pFile, pChildItem);
+                runGrammar_Recurse(pFile, pChildItem, vErrors);
             }
         }
     }
@@ -798,33 +1529,22 @@ void QMLAnalyzer::runGrammar_Recurse(QMLFile* pFile, QMLEntity* pEntity)
     Returns \c true if an error was yielded. \br\br
     \a pFile is the file being analyzed.
     \a sClassName is the class name of the entity being analyzed.
-    \a xRule is the grammar rule to check.
-    \a bInverseLogic inverses the result of the rule if \c true.
+    \a tRule is the compiled grammar rule to check, its inverse logic flag inverses the result of the rule.
+    \a vErrors receives the errors.
 */
-bool QMLAnalyzer::runGrammar_Reject(QMLFile* pFile, const QString& sClassName, QMLEntity* pEntity, CXMLNode xRule, bool bInverseLogic)
+bool QMLAnalyzer::runGrammar_Reject(QMLFile* pFile, const QString& sClassName, QMLEntity* pEntity, const QMLAnalyzerRule& tRule, QVector<QMLAnalyzerError>& vErrors)
 {
-    QString sMember = processMacros(xRule.attributes()[ANALYZER_TOKEN_MEMBER].toLower());
-    QString sValue = processMacros(xRule.attributes()[TOKEN_VALUE]);
-    QString sType = processMacros(xRule.attributes()[ANALYZER_TOKEN_TYPE]);
-    QString sText = processMacros(xRule.attributes()[ANALYZER_TOKEN_TEXT]);
-    QString sNestedCount = processMacros(xRule.attributes()[ANALYZER_TOKEN_NESTED_COUNT]);
-    QString sUnrefedSymbol = processMacros(xRule.attributes()[ANALYZER_TOKEN_UNREFED_SYMBOL]);
-    QString sCount = processMacros(xRule.attributes()[ANALYZER_TOKEN_COUNT]);
-    QString sRegExp = processMacros(xRule.attributes()[ANALYZER_TOKEN_REGEXP]);
-    QString sPath = processMacros(xRule.attributes()[ANALYZER_TOKEN_PATH]);
-    QString sList = processMacros(xRule.attributes()[ANALYZER_TOKEN_LIST]);
-    QString sClass = processMacros(xRule.attributes()[ANALYZER_TOKEN_CLASS]);
-    QString sUsed = processMacros(xRule.attributes()[ANALYZER_TOKEN_USED]);
-    QString sDeadCode = processMacros(xRule.attributes()[ANALYZER_TOKEN_DEAD_CODE]);
-
-    if (runGrammar_SatisfiesConditions(pFile, sClassName, pEntity, xRule))
+    bool bInverseLogic = tRule.bInverseLogic;
+    const QString& sText = tRule.sText;
+
+    if (runGrammar_SatisfiesConditions(pFile, sClassName, pEntity, tRule))
     {
-        QMap<QString, QMLEntity*> mMembers = pEntity->members();
+        QMLEntity* pMember = tRule.sMember.isEmpty() ? nullptr : pEntity->member(tRule.sMember);
 
         // Check nested count
-        if (sNestedCount.isEmpty() == false)
+        if (tRule.sNestedCount.isEmpty() == false)
         {
-            int iNestedCountAllowed = sNestedCount.toInt();
+            int iNestedCountAllowed = tRule.iNestedCount;
 
             if ((iNestedCountAllowed > 0) ^ bInverseLogic)
             {
@@ -832,13 +1552,13 @@ bool QMLAnalyzer::runGrammar_Reject(QMLFile* pFile, const QString& sClassName, Q
 
                 if (iNestedCount > iNestedCountAllowed)
                 {
-                    outputError(pFile->fileName(), pEntity->position(), sText);
+                    outputError(vErrors, pFile->fileName(), pEntity->position(), sText);
                     return true;
                 }
             }
         }
         // Check unreferenced symbols
-        else if (sUnrefedSymbol.isEmpty() == false)
+        else if (tRule.sUnrefedSymbol.isEmpty() == false)
         {
             // Check symbol usage if it is an item
             QMLItem* pItem = dynamic_cast<QMLItem*>(pEntity);
@@ -851,7 +1571,7 @@ bool QMLAnalyzer::runGrammar_Reject(QMLFile* pFile, const QString& sClassName, Q
                 {
                     for (QString sKey : unusedProperties.keys())
                     {
-                        outputError(pFile->fileName(), unusedProperties[sKey]->position(), "Unreferenced property");
+                        outputError(vErrors, pFile->fileName(), unusedProperties[sKey]->position(), "Unreferenced property");
                     }
 
                     return true;
@@ -869,7 +1589,7 @@ bool QMLAnalyzer::runGrammar_Reject(QMLFile* pFile, const QString& sClassName, Q
                 {
                     for (QString sKey : unusedVariables.keys())
                     {
-                        outputError(pFile->fileName(), unusedVariables[sKey]->position(), "Unreferenced variable");
+                        outputError(vErrors, pFile->fileName(), unusedVariables[sKey]->position(), "Unreferenced variable");
                     }
 
                     return true;
@@ -881,7 +1601,7 @@ bool QMLAnalyzer::runGrammar_Reject(QMLFile* pFile, const QString& sClassName, Q
                 {
                     for (QString sKey : unusedParameters.keys())
                     {
-                        outputError(pFile->fileName(), unusedParameters[sKey]->position(), "Unreferenced parameter");
+                        outputError(vErrors, pFile->fileName(), unusedParameters[sKey]->position(), "Unreferenced parameter");
                     }
 
                     return true;
@@ -889,7 +1609,7 @@ bool QMLAnalyzer::runGrammar_Reject(QMLFile* pFile, const QString& sClassName, Q
             }
         }
         // Check import usage
-        else if (sUsed.isEmpty() == false)
+        else if (tRule.sUsed.isEmpty() == false)
         {
             QMLImport* pImport = dynamic_cast<QMLImport*>(pEntity);
 
@@ -897,56 +1617,54 @@ bool QMLAnalyzer::runGrammar_Reject(QMLFile* pFile, const QString& sClassName, Q
             {
                 if ((runGrammar_importUsed(pFile, pImport) == false) ^ bInverseLogic)
                 {
-                    outputError(pFile->fileName(), pEntity->position(), sText);
+                    outputError(vErrors, pFile->fileName(), pEntity->position(), sText);
                     return true;
                 }
             }
         }
         // Check dead code statement
-        else if (sDeadCode.isEmpty() == false)
+        else if (tRule.sDeadCode.isEmpty() == false)
         {
             QMLComment* pComment = dynamic_cast<QMLComment*>(pEntity);
 
             if (pComment != nullptr)
             {
-                if ((pComment->deadCode() && sDeadCode.toLower() == ANALYZER_TOKEN_TRUE) ^ bInverseLogic)
+                if ((pComment->deadCode() && tRule.sDeadCode.toLower() == ANALYZER_TOKEN_TRUE) ^ bInverseLogic)
                 {
-                    outputError(pFile->fileName(), pEntity->position(), sText);
+                    outputError(vErrors, pFile->fileName(), pEntity->position(), sText);
                     return true;
                 }
             }
         }
-        else if (mMembers.contains(sMember) && mMembers[sMember] != nullptr)
+        else if (pMember != nullptr)
         {
-            QString sMemberToString = mMembers[sMember]->toString();
-            QString sMemberClass = mMembers[sMember]->metaObject()->className();
+            QString sMemberToString = pMember->toString();
+            QString sMemberClass = pMember->metaObject()->className();
 
             sMemberToString = sMemberToString.replace("\"", "");
 
             // Check inclusion (or exclusion) in a list
-            if (sList.isEmpty() == false)
+            if (tRule.lList.isEmpty() == false)
             {
-                QStringList lNames = sList.split(",");
-
-                if (lNames.contains(sMemberToString) ^ bInverseLogic)
+                if (tRule.lList.contains(sMemberToString) ^ bInverseLogic)
                 {
-                    outputError(pFile->fileName(), pEntity->position(), sText);
+                    outputError(vErrors, pFile->fileName(), pEntity->position(), sText);
                     return true;
                 }
             }
             // Check the class of the member
-            else if (sClass.isEmpty() == false)
+            else if (tRule.sClass.isEmpty() == false)
             {
-                if ((sMemberClass == sClass) ^ bInverseLogic)
+                if ((sMemberClass == tRule.sClass) ^ bInverseLogic)
                 {
-                    outputError(pFile->fileName(), pEntity->position(), sText);
+                    outputError(vErrors, pFile->fileName(), pEntity->position(), sText);
                     return true;
                 }
             }
             // Check the path if requested
-            else if (sPath.isEmpty() == false)
+            else if (tRule.sPath.isEmpty() == false)
             {
-                if (sPath == ANALYZER_TOKEN_EXISTS)
+                if (tRule.sPath == ANALYZER_TOKEN_EXISTS)
                 {
                     QFileInfo tFileInfo(pFile->fileName());
                     QString sDirectory = tFileInfo.absolutePath();
@@ -971,53 +1689,51 @@ bool QMLAnalyzer::runGrammar_Reject(QMLFile* pFile, const QString& sClassName, Q
 
                     if ((bExists == true) ^ bInverseLogic)
                     {
-                        outputError(pFile->fileName(), pEntity->position(), sText);
+                        outputError(vErrors, pFile->fileName(), pEntity->position(), sText);
                         return true;
                     }
                 }
             }
             // Match a regular expression if requested
-            else if (sRegExp.isEmpty() == false && sMemberToString.isEmpty() == false)
+            else if (tRule.sRegExp.isEmpty() == false && sMemberToString.isEmpty() == false)
             {
-                QRegExp tRegExp(sRegExp);
-
-                if ((tRegExp.exactMatch(sMemberToString)) ^ bInverseLogic)
+                if ((tRule.tRegExp.match(sMemberToString).hasMatch()) ^ bInverseLogic)
                 {
-                    outputError(pFile->fileName(), pEntity->position(), sText);
+                    outputError(vErrors, pFile->fileName(), pEntity->position(), sText);
                     return true;
                 }
             }
             // Check the count if requested
-            else if (sCount.isEmpty() == false)
+            else if (tRule.sCount.isEmpty() == false)
             {
-                int iCountToCheck = sCount.toInt();
-                QMLComplexEntity* pComplex = dynamic_cast<QMLComplexEntity*>(mMembers[sMember]);
+                int iCountToCheck = tRule.iCount;
+                QMLComplexEntity* pComplex = dynamic_cast<QMLComplexEntity*>(pMember);
 
                 if (pComplex != nullptr)
                 {
                     if ((pComplex->contents().count() > iCountToCheck) ^ bInverseLogic)
                     {
-                        outputError(pFile->fileName(), pEntity->position(), sText);
+                        outputError(vErrors, pFile->fileName(), pEntity->position(), sText);
                         return true;
                     }
                 }
             }
             // Check the type if requested
-            else if (sType.isEmpty() == false)
+            else if (tRule.sType.isEmpty() == false)
             {
-                QString sTypeToString = QMLType::typeToString(mMembers[sMember]->value().type());
+                QString sTypeToString = QMLType::typeToString(pMember->value().type());
 
-                if ((sTypeToString == sType) ^ bInverseLogic)
+                if ((sTypeToString == tRule.sType) ^ bInverseLogic)
                 {
-                    outputError(pFile->fileName(), pEntity->position(), sText);
+                    outputError(vErrors, pFile->fileName(), pEntity->position(), sText);
                     return true;
                 }
             }
             else
             {
-                if ((sMemberToString == sValue) ^ bInverseLogic)
+                if ((sMemberToString == tRule.sValue) ^ bInverseLogic)
                 {
-                    outputError(pFile->fileName(), pEntity->position(), sText);
+                    outputError(vErrors, pFile->fileName(), pEntity->position(), sText);
                     return true;
                 }
             }
@@ -1034,28 +1750,26 @@ bool QMLAnalyzer::runGrammar_Reject(QMLFile* pFile, const QString& sClassName, Q
     Returns \c true if all conditions passed. \br\br
     \a pFile is the file being analyzed.
     \a sClassName is the class name of the entity being analyzed.
-    \a xRule is the grammar rule to check.
+    \a tRule is the compiled grammar rule to check.
 */
-bool QMLAnalyzer::runGrammar_SatisfiesConditions(QMLFile* pFile, const QString& sClassName, QMLEntity* pEntity, CXMLNode xRule)
+bool QMLAnalyzer::runGrammar_SatisfiesConditions(QMLFile* pFile, const QString& sClassName, QMLEntity* pEntity, const QMLAnalyzerRule& tRule)
 {
     Q_UNUSED(sClassName);
 
-    CXMLNodeList vConditions = xRule.getNodesByTagName(ANALYZER_TOKEN_CONDITION);
+    for (const QMLAnalyzerCondition& tCondition : tRule.vConditions)
+    {
+        const QString& sMember = tCondition.sMember;
+        const QString& sOperation = tCondition.sOperation;
+        const QString& sEmpty = tCondition.sEmpty;
+        const QString& sValue = tCondition.sValue;
+        const QString& sClass = tCondition.sClass;
+        bool bNegate = tCondition.bNegate;
 
-    QMap<QString, QMLEntity*> mMembers = pEntity->members();
+        QMLEntity* pMember = pEntity->member(sMember);
 
-    for (CXMLNode xCondition : vConditions)
-    {
-        QString sMember = xCondition.attributes()[ANALYZER_TOKEN_MEMBER].toLower();
-        QString sOperation = xCondition.attributes()[ANALYZER_TOKEN_OPERATION];
-        QString sEmpty = xCondition.attributes()[ANALYZER_TOKEN_EMPTY].toLower();
-        QString sValue = xCondition.attributes()[TOKEN_VALUE];
-        QString sNegate = xCondition.attributes()[ANALYZER_TOKEN_NEGATE].toLower();
-        QString sClass = xCondition.attributes()[ANALYZER_TOKEN_CLASS];
-
-        if (mMembers.contains(sMember) && mMembers[sMember] != nullptr)
+        if (pMember != nullptr)
         {
-            QString sMemberToString = mMembers[sMember]->toString();
+            QString sMemberToString = pMember->toString();
 
             sMemberToString = sMemberToString.replace("\"", "");
 
@@ -1064,14 +1778,14 @@ bool QMLAnalyzer::runGrammar_SatisfiesConditions(QMLFile* pFile, const QString&
             {
                 if (sMemberToString == sValue)
                 {
-                    if (sNegate == ANALYZER_TOKEN_TRUE)
+                    if (bNegate)
                     {
                         return false;
                     }
                 }
                 else
                 {
-                    if (sNegate != ANALYZER_TOKEN_TRUE)
+                    if (bNegate == false)
                     {
                         return false;
                     }
@@ -1098,14 +1812,14 @@ bool QMLAnalyzer::runGrammar_SatisfiesConditions(QMLFile* pFile, const QString&
                     {
                         if (pParent->metaObject()->className() == sClass)
                         {
-                            if (sNegate == ANALYZER_TOKEN_TRUE)
+                            if (bNegate)
                             {
                                 return false;
                             }
                         }
                         else
                         {
-                            if (sNegate != ANALYZER_TOKEN_TRUE)
+                            if (bNegate == false)
                             {
                                 return false;
                             }
@@ -1120,14 +1834,14 @@ bool QMLAnalyzer::runGrammar_SatisfiesConditions(QMLFile* pFile, const QString&
                 {
                     if (pFile->fileName().contains(sValue))
                     {
-                        if (sNegate == ANALYZER_TOKEN_TRUE)
+                        if (bNegate)
                         {
                             return false;
                         }
                     }
                     else
                     {
-                        if (sNegate != ANALYZER_TOKEN_TRUE)
+                        if (bNegate == false)
                         {
                             return false;
                         }
@@ -1137,14 +1851,14 @@ bool QMLAnalyzer::runGrammar_SatisfiesConditions(QMLFile* pFile, const QString&
                 {
                     if (pFile->fileName() == sValue)
                     {
-                        if (sNegate == ANALYZER_TOKEN_TRUE)
+                        if (bNegate)
                         {
                             return false;
                         }
                     }
                     else
                     {
-                        if (sNegate != ANALYZER_TOKEN_TRUE)
+                        if (bNegate == false)
                         {
                             return false;
                         }
@@ -1175,15 +1889,13 @@ int QMLAnalyzer::runGrammar_CountNested(const QString& sClassName, QMLEntity* pE
 
     if (pEntity != nullptr)
     {
-        QMap<QString, QMLEntity*> mMembers = pEntity->members();
-
-        for (QString sKey : mMembers.keys())
+        pEntity->forEachMember([this, &sClassName, &iCount](QMLEntity* pMember)
         {
-            int iNewCount = runGrammar_CountNested(sClassName, mMembers[sKey]);
+            int iNewCount = runGrammar_CountNested(sClassName, pMember);
 
             if (iNewCount > iCount)
                 iCount = iNewCount;
-        }
+        });
 
         QMLComplexEntity* pComplex = dynamic_cast<QMLComplexEntity*>(pEntity);
 
@@ -1234,7 +1946,10 @@ bool QMLAnalyzer::runGrammar_importUsed(QMLFile* pFile, QMLImport* pImport)
         QFileInfo info(sImportDirectory + "/" + sFile);
         QString sClassName = info.baseName();
 
-        if (isClassUsed(pFile, pFile, sClassName))
+        // Identifiers of the context compare by name ID
+        int iClassId = m_pContext->names().find(sClassName);
+
+        if (isClassUsed(pFile, pFile, sClassName, iClassId))
         {
             return true;
         }
@@ -1249,8 +1964,9 @@ bool QMLAnalyzer::runGrammar_importUsed(QMLFile* pFile, QMLImport* pImport)
     Returns \c true if \a sClassName is used by the QML contents. \br\br
     \a pFile is the file being analyzed.
     \a pEntity is the entity being checked.
+    \a iClassId is the ID of \a sClassName in the name table of the context.
 */
-bool QMLAnalyzer::isClassUsed(QMLFile* pFile, QMLEntity* pEntity, const QString& sClassName)
+bool QMLAnalyzer::isClassUsed(QMLFile* pFile, QMLEntity* pEntity, const QString& sClassName, int iClassId)
 {
     if (pEntity == nullptr)
     {
@@ -1259,26 +1975,36 @@ bool QMLAnalyzer::isClassUsed(QMLFile* pFile, QMLEntity* pEntity, const QString&
 
     QMLItem* pItem = dynamic_cast<QMLItem*>(pEntity);
 
-    if (pItem != nullptr && pItem->name() != nullptr && pItem->name()->value().toString() == sClassName)
+    if (pItem != nullptr && pItem->name() != nullptr)
     {
-        return true;
+        QMLIdentifier* pName = dynamic_cast<QMLIdentifier*>(pItem->name());
+
+        if (pName != nullptr ? pName->hasName(sClassName, iClassId) : pItem->name()->value().toString() == sClassName)
+        {
+            return true;
+        }
     }
 
     QMLIdentifier* pIdentifier = dynamic_cast<QMLIdentifier*>(pEntity);
 
-    if (pIdentifier != nullptr && pIdentifier->value().toString() == sClassName)
+    if (pIdentifier != nullptr && pIdentifier->hasName(sClassName, iClassId))
     {
         return true;
     }
 
-    QMap<QString, QMLEntity*> mMembers = pEntity->members();
+    bool bUsedInMembers = false;
 
-    for (QString sKey : mMembers.keys())
+    pEntity->forEachMember([this, pFile, &sClassName, iClassId, &bUsedInMembers](QMLEntity* pMember)
     {
-        if (isClassUsed(pFile, mMembers[sKey], sClassName))
+        if (bUsedInMembers == false && isClassUsed(pFile, pMember, sClassName, iClassId))
         {
-            return true;
+            bUsedInMembers = true;
         }
+    });
+
+    if (bUsedInMembers)
+    {
+        return true;
     }
 
     QMLComplexEntity* pComplex = dynamic_cast<QMLComplexEntity*>(pEntity);
@@ -1287,7 +2013,7 @@ bool QMLAnalyzer::isClassUsed(QMLFile* pFile, QMLEntity* pEntity, const QString&
     {
         for (QMLEntity* pChildItem : pComplex->contents())
         {
-            if (isClassUsed(pFile, pChildItem, sClassName))
+            if (isClassUsed(pFile, pChildItem, sClassName, iClassId))
             {
                 return true;
             }
@@ -1300,13 +2026,26 @@ bool QMLAnalyzer::isClassUsed(QMLFile* pFile, QMLEntity* pEntity, const QString&
 //-------------------------------------------------------------------------------------------------
 
 /*!
-    Outputs the error in \a sText. \br\br
+    Appends the error in \a sText to \a vErrors. \br\br
     \a sFileName is the full name of the file being analyzed. \br
     \a pPosition is the position in the file of the concerned token (x = column, y = line)
 */
-void QMLAnalyzer::outputError(const QString& sFileName, const QPoint& pPosition, const QString& sText)
+void QMLAnalyzer::outputError(QVector<QMLAnalyzerError>& vErrors, const QString& sFileName, const QPoint& pPosition, const QString& sText)
+{
+    vErrors << QMLAnalyzerError(sFileName, pPosition, sText);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Appends \a vErrors to the error list and emits analyzeError() for each of them.
+*/
+void QMLAnalyzer::publishErrors(const QVector<QMLAnalyzerError>& vErrors)
 {
-    m_vErrors << QMLAnalyzerError(sFileName, pPosition, sText);
+    for (const QMLAnalyzerError& tError : vErrors)
+    {
+        m_vErrors << tError;
 
-    emit analyzeError(m_vErrors.last());
+        emit analyzeError(m_vErrors.last());
+    }
 }
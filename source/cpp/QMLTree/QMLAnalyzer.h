@@ -8,8 +8,15 @@
 // Qt
 #include <QThread>
 #include <QMutex>
+#include <QAtomicInt>
 #include <QString>
 #include <QVariant>
+#include <QHash>
+#include <QVector>
+#include <QSet>
+#include <QRegularExpression>
+#include <QFileSystemWatcher>
+#include <QTimer>
 
 // Foundations
 #include "../CXMLNode.h"
@@ -25,11 +32,72 @@
 
 //-------------------------------------------------------------------------------------------------
 
+// Delay between a change in a watched folder and its analysis, in milliseconds
+#define ANALYZER_WATCH_DELAY    200
+
+//-------------------------------------------------------------------------------------------------
+
+//! Defines a condition of a grammar rule, compiled from a <Condition> tag
+class QTPLUSSHARED_EXPORT QMLAnalyzerCondition
+{
+public:
+
+    QMLAnalyzerCondition()
+        : bNegate(false)
+    {
+    }
+
+    QString     sMember;                // Lower case
+    QString     sOperation;
+    QString     sEmpty;                 // Lower case
+    QString     sValue;
+    QString     sClass;
+    bool        bNegate;
+};
+
+//-------------------------------------------------------------------------------------------------
+
+//! Defines a grammar rule, compiled from an <Accept> or <Reject> tag with its macros expanded
+class QTPLUSSHARED_EXPORT QMLAnalyzerRule
+{
+public:
+
+    QMLAnalyzerRule()
+        : bInverseLogic(false)
+        , iNestedCount(0)
+        , iCount(0)
+    {
+    }
+
+    bool                            bInverseLogic;      // true for <Accept>
+    QString                         sMember;            // Lower case
+    QString                         sValue;
+    QString                         sType;
+    QString                         sText;
+    QString                         sNestedCount;
+    QString                         sUnrefedSymbol;
+    QString                         sCount;
+    QString                         sRegExp;
+    QString                         sPath;
+    QStringList                     lList;
+    QString                         sClass;
+    QString                         sUsed;
+    QString                         sDeadCode;
+    int                             iNestedCount;
+    int                             iCount;
+    QRegularExpression              tRegExp;            // Anchored, matches the whole text
+    QVector<QMLAnalyzerCondition>   vConditions;
+};
+
+//-------------------------------------------------------------------------------------------------
+
 //! Defines a static QML analyzer
 class QTPLUSSHARED_EXPORT QMLAnalyzer : public QThread, public CMacroable
 {
     Q_OBJECT
 
+    friend class QMLFileChecker;
+
 public:
 
     //-------------------------------------------------------------------------------------------------
@@ -64,6 +132,12 @@ public:
     //! Set remove unreferenced symbols
     void setRemoveUnreferencedSymbols(bool bValue);
 
+    //! Set the maximum number of parsing threads
+    void setMaxThreads(int iValue);
+
+    //! Set the folder of the parse cache
+    void setCacheFolder(const QString& sFolder);
+
     //-------------------------------------------------------------------------------------------------
     // Getters
     //-------------------------------------------------------------------------------------------------
@@ -77,6 +151,9 @@ public:
     //! Return the parse context
     QMLTreeContext* context();
 
+    //! Returns true if the analyzer watches its folder or file
+    bool isWatching() const;
+
     //-------------------------------------------------------------------------------------------------
     // Control methods
     //-------------------------------------------------------------------------------------------------
@@ -96,6 +173,18 @@ public:
     //!
     bool analyzeFile(const QString& sFileName);
 
+    //!
+    bool analyzeFiles(const QStringList& lFileNames);
+
+    //! Analyzes the folder or file, then re-analyzes whatever changes until stopWatching() is called
+    bool startWatching(const CXMLNode& xGrammar, const CXMLNode& xFormat = CXMLNode());
+
+    //! Stops watching the folder or file
+    void stopWatching();
+
+    //! Re-analyzes the files affected by changes to lPaths (files or folders) while watching
+    void reanalyzeFiles(const QStringList& lPaths);
+
     //-------------------------------------------------------------------------------------------------
     // Overridden methods
     //-------------------------------------------------------------------------------------------------
@@ -120,6 +209,21 @@ signals:
     //!
     void analyzeError(QMLAnalyzerError tError);
 
+    //! Emitted in watch mode once lFileNames were analyzed again, their previous errors no longer apply
+    void analysisUpdated(QStringList lFileNames);
+
+    //-------------------------------------------------------------------------------------------------
+    // Protected slots
+    //-------------------------------------------------------------------------------------------------
+
+protected slots:
+
+    //!
+    void onWatchedPathChanged(const QString& sPath);
+
+    //!
+    void onWatchTimeout();
+
     //-------------------------------------------------------------------------------------------------
     // Protected control methods
     //-------------------------------------------------------------------------------------------------
@@ -130,16 +234,55 @@ protected:
     bool analyzeRecurse(QString sDirectory);
 
     //!
-    void runGrammar(QMLFile* pFile);
+    void collectFiles(QString sDirectory, QStringList& lFileNames);
+
+    //! Creates a new parse context
+    void resetContext();
 
     //!
-    void runGrammar_Recurse(QMLFile* pFile, QMLEntity* pEntity);
+    void checkFile(const QString& sFileName);
+
+    //! Runs the grammar on the parsed files of lFileNames in parallel, publishes mFileErrors for the others
+    bool checkFiles(const QStringList& lFileNames, const QMap<QString, QMLAnalyzerError>& mFileErrors);
+
+    //! Returns the files to analyze, the folder's or the single file
+    QStringList analyzedFileNames();
+
+    //! Parses the unparsed files of the context and records the state of lFileNames
+    void parseWatchedFiles(const QStringList& lFileNames);
+
+    //! Updates the directories imported by sFileName in the dependency graph
+    void updateImports(const QString& sFileName);
+
+    //! Removes sFileName from the context and from the watch state
+    void forgetFile(const QString& sFileName);
+
+    //! Makes the watcher follow the analyzed files, their folders and imported folders
+    void updateWatchedPaths();
+
+    //! Returns the canonical path of sPath, or its clean absolute path if it does not exist
+    static QString pathKey(const QString& sPath);
+
+    //! Returns a hash of the contents of sFileName
+    static QByteArray fileStamp(const QString& sFileName);
+
+    //!
+    void rewriteFile(QMLFile* pFile);
+
+    //! Compiles the grammar into the rule table
+    void compileRules();
+
+    //! Runs the grammar on pFile, thread safe once the rules are compiled
+    void runGrammar(QMLFile* pFile, QVector<QMLAnalyzerError>& vErrors);
 
     //!
-    bool runGrammar_Reject(QMLFile* pFile, const QString& sClassName, QMLEntity* pEntity, CXMLNode xRule, bool bInverseLogic);
+    void runGrammar_Recurse(QMLFile* pFile, QMLEntity* pEntity, QVector<QMLAnalyzerError>& vErrors);
 
     //!
-    bool runGrammar_SatisfiesConditions(QMLFile* pFile, const QString& sClassName, QMLEntity* pEntity, CXMLNode xRule);
+    bool runGrammar_Reject(QMLFile* pFile, const QString& sClassName, QMLEntity* pEntity, const QMLAnalyzerRule& tRule, QVector<QMLAnalyzerError>& vErrors);
+
+    //!
+    bool runGrammar_SatisfiesConditions(QMLFile* pFile, const QString& sClassName, QMLEntity* pEntity, const QMLAnalyzerRule& tRule);
 
     //!
     int runGrammar_CountNested(const QString& sClassName, QMLEntity* pEntity);
@@ -148,10 +291,13 @@ protected:
     bool runGrammar_importUsed(QMLFile* pFile, QMLImport* pImport);
 
     //!
-    bool isClassUsed(QMLFile* pFile, QMLEntity* pEntity, const QString& sClassName);
+    bool isClassUsed(QMLFile* pFile, QMLEntity* pEntity, const QString& sClassName, int iClassId);
 
     //!
-    void outputError(const QString& sFileName, const QPoint& pPosition, const QString& sText);
+    void outputError(QVector<QMLAnalyzerError>& vErrors, const QString& sFileName, const QPoint& pPosition, const QString& sText);
+
+    //! Appends vErrors to the error list and emits them
+    void publishErrors(const QVector<QMLAnalyzerError>& vErrors);
 
 protected:
 
@@ -166,5 +312,21 @@ protected:
     bool                            m_bIncludeSubFolders;
     bool                            m_bRewriteFiles;
     bool                            m_bRemoveUnreferencedSymbols;
-    bool                            m_bStopAnalyzeRequested;
+    QAtomicInt                      m_iStopAnalyzeRequested;    // Read by the threads checking files
+    int                             m_iMaxThreads;
+    QString                         m_sCacheFolder;
+
+    // Compiled grammar
+    QHash<QByteArray, QVector<QMLAnalyzerRule> >    m_hRules;           // Class name -> rules, in grammar order
+    bool                                            m_bRulesCompiled;
+
+    // Watch mode
+    QFileSystemWatcher*                 m_pWatcher;
+    QTimer                              m_tWatchTimer;              // Gathers bursts of changes
+    QSet<QString>                       m_sPendingPaths;            // Changed paths not handled yet
+    QStringList                         m_lWatchedFiles;            // Analyzed files, in analysis order
+    QHash<QString, QByteArray>          m_hFileStamps;              // File -> hash of the contents last analyzed
+    QHash<QString, QStringList>         m_hFileImports;             // File -> keys of the folders it imports
+    QHash<QString, QSet<QString> >      m_hImporters;               // Folder key -> files importing it
+    QMap<QString, QMLAnalyzerError>     m_mParseErrors;             // Files that did not parse
 };
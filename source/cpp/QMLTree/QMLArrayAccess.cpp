@@ -4,6 +4,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLArrayAccess::instantiator()
+{
+    return new QMLArrayAccess(QPoint(), nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLArrayAccess::QMLArrayAccess(const QPoint& pPosition, QMLEntity* pLeft)
     : QMLComplexEntity(pPosition)
     , m_pLeft(pLeft)
@@ -27,13 +34,9 @@ QMLEntity* QMLArrayAccess::left() const
 
 //-------------------------------------------------------------------------------------------------
 
-QMap<QString, QMLEntity*> QMLArrayAccess::members()
+void QMLArrayAccess::visitMembers(QMLMemberVisitor& tVisitor)
 {
-    QMap<QString, QMLEntity*> vReturnValue;
-
-    vReturnValue["left"] = m_pLeft;
-
-    return vReturnValue;
+    tVisitor.visit("left", m_pLeft);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -67,15 +70,27 @@ void QMLArrayAccess::toQML(QTextStream& stream, QMLFormatter& formatter, const Q
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLArrayAccess::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLArrayAccess::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
 {
-    CXMLNode xNode = QMLComplexEntity::toXMLNode(pContext, pParent);
-    CXMLNode xLeft("Left");
+    QMLComplexEntity::writeXMLChildren(tWriter, pContext);
 
-    if (m_pLeft != nullptr)
-        xLeft.nodes() << m_pLeft->toXMLNode(pContext, this);
+    writeXMLMember(tWriter, pContext, "Left", m_pLeft);
+}
 
-    xNode.nodes() << xLeft;
+//-------------------------------------------------------------------------------------------------
+
+void QMLArrayAccess::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLComplexEntity::serialize(stream, pTracker);
+
+    serializeEntity(stream, pTracker, m_pLeft);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLArrayAccess::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLComplexEntity::deserialize(stream, pTracker, pRootObject);
 
-    return xNode;
+    m_pLeft = deserializeEntity(stream, pTracker, pRootObject);
 }
@@ -24,6 +24,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLArrayAccess
+    static QMLEntity* instantiator();
+
     //! Constructor with condition, then and else
     QMLArrayAccess(const QPoint& pPosition, QMLEntity* pLeft);
 
@@ -41,18 +44,24 @@ public:
     //!
     QMLEntity* left() const;
 
-    //! Returns all members
-    virtual QMap<QString, QMLEntity*> members() Q_DECL_OVERRIDE;
+    //! Calls tVisitor for each member
+    virtual void visitMembers(QMLMemberVisitor& tVisitor) Q_DECL_OVERRIDE;
 
     //-------------------------------------------------------------------------------------------------
     // Overridden methods
     //-------------------------------------------------------------------------------------------------
 
+    //!
+    virtual void serialize(QDataStream& stream, CObjectTracker* pTracker) const Q_DECL_OVERRIDE;
+
+    //!
+    virtual void deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject) Q_DECL_OVERRIDE;
+
     //!
     virtual void toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntity* pParent = nullptr) const Q_DECL_OVERRIDE;
 
     //!
-    virtual CXMLNode toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent) Q_DECL_OVERRIDE;
+    virtual void writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext) Q_DECL_OVERRIDE;
 
     //-------------------------------------------------------------------------------------------------
     // Properties
@@ -4,6 +4,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLBinaryOperation::instantiator()
+{
+    return new QMLBinaryOperation(QPoint(), nullptr, nullptr, boNone);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLBinaryOperation::QMLBinaryOperation(const QPoint& pPosition, QMLEntity* pLeft, QMLEntity* pRight, EOperator eOperator)
     : QMLEntity(pPosition)
     , m_pLeft(pLeft)
@@ -110,14 +117,10 @@ QString QMLBinaryOperation::operatorToString(EOperator eOperator) const
 
 //-------------------------------------------------------------------------------------------------
 
-QMap<QString, QMLEntity*> QMLBinaryOperation::members()
+void QMLBinaryOperation::visitMembers(QMLMemberVisitor& tVisitor)
 {
-    QMap<QString, QMLEntity*> vReturnValue;
-
-    vReturnValue["left"] = m_pLeft;
-    vReturnValue["right"] = m_pRight;
-
-    return vReturnValue;
+    tVisitor.visit("left", m_pLeft);
+    tVisitor.visit("right", m_pRight);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -154,22 +157,46 @@ void QMLBinaryOperation::toQML(QTextStream& stream, QMLFormatter& formatter, con
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLBinaryOperation::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLBinaryOperation::writeXMLAttributes(QMLXMLWriter& tWriter)
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
-    CXMLNode xLeft("Left");
-    CXMLNode xRight("Right");
+    QMLEntity::writeXMLAttributes(tWriter);
 
-    xNode.attributes()["Operator"] = operatorToString(m_eOperator);
+    tWriter.setAttribute("Operator", operatorToString(m_eOperator));
+}
 
-    if (m_pLeft != nullptr)
-        xLeft.nodes() << m_pLeft->toXMLNode(pContext, this);
+//-------------------------------------------------------------------------------------------------
 
-    if (m_pRight != nullptr)
-        xRight.nodes() << m_pRight->toXMLNode(pContext, this);
+void QMLBinaryOperation::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
+{
+    writeXMLMember(tWriter, pContext, "Left", m_pLeft);
+    writeXMLMember(tWriter, pContext, "Right", m_pRight);
+}
 
-    xNode.nodes() << xLeft;
-    xNode.nodes() << xRight;
+//-------------------------------------------------------------------------------------------------
 
-    return xNode;
+void QMLBinaryOperation::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLEntity::serialize(stream, pTracker);
+
+    serializeEntity(stream, pTracker, m_pLeft);
+    serializeEntity(stream, pTracker, m_pRight);
+    stream << qint32(m_eOperator);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLBinaryOperation::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
+
+    qint32 iOperator = 0;
+
+    m_pLeft = deserializeEntity(stream, pTracker, pRootObject);
+    m_pRight = deserializeEntity(stream, pTracker, pRootObject);
+    stream >> iOperator;
+
+    m_eOperator = EOperator(iOperator);
+
+    if (m_pLeft != nullptr) m_pLeft->setParent(this);
+    if (m_pRight != nullptr) m_pRight->setParent(this);
 }
@@ -55,6 +55,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLBinaryOperation
+    static QMLEntity* instantiator();
+
     //! Constructor with type and name
     QMLBinaryOperation(const QPoint& pPosition, QMLEntity *pLeft, QMLEntity* pRight, EOperator eOperator);
 
@@ -81,8 +84,8 @@ public:
     //!
     EOperator oper() const;
 
-    //! Returns all members
-    virtual QMap<QString, QMLEntity*> members() Q_DECL_OVERRIDE;
+    //! Calls tVisitor for each member
+    virtual void visitMembers(QMLMemberVisitor& tVisitor) Q_DECL_OVERRIDE;
 
     //-------------------------------------------------------------------------------------------------
     // Control methods
@@ -95,11 +98,20 @@ public:
     // Overridden methods
     //-------------------------------------------------------------------------------------------------
 
+    //!
+    virtual void serialize(QDataStream& stream, CObjectTracker* pTracker) const Q_DECL_OVERRIDE;
+
+    //!
+    virtual void deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject) Q_DECL_OVERRIDE;
+
     //!
     virtual void toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntity* pParent = nullptr) const Q_DECL_OVERRIDE;
 
     //!
-    virtual CXMLNode toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent) Q_DECL_OVERRIDE;
+    virtual void writeXMLAttributes(QMLXMLWriter& tWriter) Q_DECL_OVERRIDE;
+
+    //!
+    virtual void writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext) Q_DECL_OVERRIDE;
 
     //-------------------------------------------------------------------------------------------------
     // Properties
@@ -8,14 +8,19 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLComment::instantiator()
+{
+    return new QMLComment(QPoint(), QString(), ctSingleLine);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLComment::QMLComment(const QPoint& pPosition, const QString& sText, ECommentType eType)
     : QMLEntity(pPosition, sText)
     , m_pAttachedTo(nullptr)
     , m_eType(eType)
     , m_bDeadCode(false)
 {
-    QMLTreeContext context;
-
     checkForCode();
 }
 
@@ -142,11 +147,33 @@ void QMLComment::toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEn
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLComment::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLComment::writeXMLAttributes(QMLXMLWriter& tWriter)
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
+    QMLEntity::writeXMLAttributes(tWriter);
+
+    tWriter.setAttribute("Type", QString::number(int(m_eType)));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLComment::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLEntity::serialize(stream, pTracker);
+
+    stream << qint32(m_eType);
+    stream << m_bDeadCode;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLComment::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
+
+    qint32 iType = 0;
 
-    xNode.attributes()["Type"] = QString::number(int(m_eType));
+    stream >> iType;
+    stream >> m_bDeadCode;
 
-    return xNode;
+    m_eType = ECommentType(iType);
 }
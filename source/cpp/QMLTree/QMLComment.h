@@ -32,6 +32,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLComment
+    static QMLEntity* instantiator();
+
     //! Constructor
     QMLComment(const QPoint& pPosition, const QString& sText, ECommentType eType);
 
@@ -72,11 +75,17 @@ public:
     // Overridden methods
     //-------------------------------------------------------------------------------------------------
 
+    //!
+    virtual void serialize(QDataStream& stream, CObjectTracker* pTracker) const Q_DECL_OVERRIDE;
+
+    //!
+    virtual void deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject) Q_DECL_OVERRIDE;
+
     //!
     virtual void toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntity* pParent = nullptr) const Q_DECL_OVERRIDE;
 
     //!
-    virtual CXMLNode toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent) Q_DECL_OVERRIDE;
+    virtual void writeXMLAttributes(QMLXMLWriter& tWriter) Q_DECL_OVERRIDE;
 
     //-------------------------------------------------------------------------------------------------
     // Properties
@@ -19,6 +19,16 @@
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Instantiates a new QMLComplexEntity.
+*/
+QMLEntity* QMLComplexEntity::instantiator()
+{
+    return new QMLComplexEntity(QPoint());
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Constructs a QMLComplexEntity. \br\br
     \a pPosition is the position of the token in the file.
@@ -191,15 +201,11 @@ bool QMLComplexEntity::isArgumentList() const
 //-------------------------------------------------------------------------------------------------
 
 /*!
-    Returns a map of class members.
+    Calls \a tVisitor for each member.
 */
-QMap<QString, QMLEntity*> QMLComplexEntity::members()
+void QMLComplexEntity::visitMembers(QMLMemberVisitor& tVisitor)
 {
-    QMap<QString, QMLEntity*> vReturnValue;
-
-    vReturnValue["name"] = m_pName;
-
-    return vReturnValue;
+    tVisitor.visit("name", m_pName);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -546,42 +552,39 @@ void QMLComplexEntity::toQML(QTextStream& stream, QMLFormatter& formatter, const
 
 //-------------------------------------------------------------------------------------------------
 
-/*!
-    Returns a CXMLNode representation of this item. \br\br
-    \a pContext is a user defined context. \br
-    \a pParent is the caller of this method.
-*/
-CXMLNode QMLComplexEntity::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLComplexEntity::writeXMLAttributes(QMLXMLWriter& tWriter)
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
+    QMLEntity::writeXMLAttributes(tWriter);
 
     if (m_pName != nullptr)
     {
-        xNode.attributes()["Name"] = m_pName->toString();
+        tWriter.setAttribute("Name", m_pName->toString());
     }
 
     if (m_bIsArray)
-        xNode.attributes()["IsArray"] = "true";
+        tWriter.setAttribute("IsArray", "true");
 
     if (m_bIsObject)
-        xNode.attributes()["IsObject"] = "true";
+        tWriter.setAttribute("IsObject", "true");
 
     if (m_bIsBlock)
-        xNode.attributes()["IsBlock"] = "true";
+        tWriter.setAttribute("IsBlock", "true");
 
     if (m_bIsArgumentList)
-        xNode.attributes()["IsArgumentList"] = "true";
+        tWriter.setAttribute("IsArgumentList", "true");
+}
+
+//-------------------------------------------------------------------------------------------------
 
+void QMLComplexEntity::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
+{
     for (QMLEntity* pEntity : m_vContents)
     {
         if (pEntity != nullptr)
         {
-            CXMLNode xChild = pEntity->toXMLNode(pContext, this);
-            xNode.nodes() << xChild;
+            pEntity->writeXML(tWriter, pContext);
         }
     }
-
-    return xNode;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -622,3 +625,56 @@ QMLComplexEntity* QMLComplexEntity::makeBlock(QMLEntity* pEntity)
 
     return pComplex;
 }
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Writes the parsed state of the entity to \a stream. \br\br
+    \a pTracker is passed to child entities.
+*/
+void QMLComplexEntity::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLEntity::serialize(stream, pTracker);
+
+    serializeEntity(stream, pTracker, m_pName);
+
+    stream << qint32(m_vContents.count());
+
+    for (QMLEntity* pEntity : m_vContents)
+    {
+        serializeEntity(stream, pTracker, pEntity);
+    }
+
+    stream << m_bIsArray;
+    stream << m_bIsObject;
+    stream << m_bIsBlock;
+    stream << m_bIsArgumentList;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Reads the parsed state of the entity from \a stream. \br\br
+    \a pTracker is passed to child entities. \br
+    \a pRootObject is the QMLTreeContext that reads the tree.
+*/
+void QMLComplexEntity::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
+
+    qint32 iCount = 0;
+
+    m_pName = deserializeEntity(stream, pTracker, pRootObject);
+
+    stream >> iCount;
+
+    for (qint32 iIndex = 0; iIndex < iCount && stream.status() == QDataStream::Ok; iIndex++)
+    {
+        m_vContents << deserializeEntity(stream, pTracker, pRootObject);
+    }
+
+    stream >> m_bIsArray;
+    stream >> m_bIsObject;
+    stream >> m_bIsBlock;
+    stream >> m_bIsArgumentList;
+}
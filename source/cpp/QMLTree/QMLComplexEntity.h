@@ -25,6 +25,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLComplexEntity
+    static QMLEntity* instantiator();
+
     //! Default constructor
     QMLComplexEntity(const QPoint& pPosition, QMLEntity* pName = nullptr);
 
@@ -89,8 +92,14 @@ public:
     // Overridden methods
     //-------------------------------------------------------------------------------------------------
 
-    //! Returns all members
-    virtual QMap<QString, QMLEntity*> members() Q_DECL_OVERRIDE;
+    //!
+    virtual void serialize(QDataStream& stream, CObjectTracker* pTracker) const Q_DECL_OVERRIDE;
+
+    //!
+    virtual void deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject) Q_DECL_OVERRIDE;
+
+    //! Calls tVisitor for each member
+    virtual void visitMembers(QMLMemberVisitor& tVisitor) Q_DECL_OVERRIDE;
 
     //!
     virtual void solveSymbols(QMLTreeContext* pContext) Q_DECL_OVERRIDE;
@@ -117,7 +126,10 @@ public:
     virtual void toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntity* pParent = nullptr) const Q_DECL_OVERRIDE;
 
     //!
-    virtual CXMLNode toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent) Q_DECL_OVERRIDE;
+    virtual void writeXMLAttributes(QMLXMLWriter& tWriter) Q_DECL_OVERRIDE;
+
+    //!
+    virtual void writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext) Q_DECL_OVERRIDE;
 
     //-------------------------------------------------------------------------------------------------
     // Static methods
@@ -4,6 +4,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLConditional::instantiator()
+{
+    return new QMLConditional(QPoint(), nullptr, nullptr, nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLConditional::QMLConditional(const QPoint& pPosition, QMLEntity* pCondition, QMLEntity* pThen, QMLEntity* pElse)
     : QMLIf(pPosition, pCondition, pThen, pElse)
 {
@@ -24,6 +24,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLConditional
+    static QMLEntity* instantiator();
+
     //! Constructor with condition, then and else
     QMLConditional(const QPoint& pPosition, QMLEntity* pCondition, QMLEntity* pThen, QMLEntity* pElse);
 
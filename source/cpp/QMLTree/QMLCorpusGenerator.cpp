@@ -0,0 +1,522 @@
+
+// Qt
+#include <QDir>
+#include <QFile>
+
+// Application
+#include "QMLCorpusGenerator.h"
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    \class QMLCorpusGenerator
+    \inmodule qt-plus
+    \brief Generates synthetic QML projects. \br
+    Files are made of imports and a tree of items. Each item has an id, typed properties whose values refer
+    to other properties, property assignments, JS functions with declarations, conditions and loops, and
+    child items down to depth(). Comments are spread over declarations according to commentPercent(). \br
+    Generation is deterministic : a file only depends on the settings, the seed and its index, so a corpus
+    can be regenerated anywhere instead of being stored. \br
+    Used by the QML benchmarks to measure the throughput of QMLTreeContext, QMLAnalyzer and QMLFormatter.
+    \sa QMLTreeContext, QMLAnalyzer
+*/
+
+//-------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+const char* s_pImports[] =
+{
+    "QtQuick 2.5",
+    "QtQuick.Controls 1.4",
+    "QtQuick.Layouts 1.1",
+    "QtQuick.Window 2.2",
+    "QtQuick.Dialogs 1.2",
+    "QtGraphicalEffects 1.0"
+};
+
+const char* s_pItemTypes[] =
+{
+    "Item",
+    "Rectangle",
+    "Text",
+    "MouseArea",
+    "Column",
+    "Row"
+};
+
+const char* s_pPropertyTypes[] =
+{
+    "int",
+    "real",
+    "string",
+    "bool",
+    "var"
+};
+
+const char* s_pAssignments[] =
+{
+    "width: parent.width / 2",
+    "height: parent.height - 10",
+    "visible: enabled && opacity > 0.5",
+    "anchors.margins: 4",
+    "opacity: 0.8",
+    "clip: true"
+};
+
+const int s_iImportCount        = int(sizeof(s_pImports) / sizeof(s_pImports[0]));
+const int s_iItemTypeCount      = int(sizeof(s_pItemTypes) / sizeof(s_pItemTypes[0]));
+const int s_iPropertyTypeCount  = int(sizeof(s_pPropertyTypes) / sizeof(s_pPropertyTypes[0]));
+const int s_iAssignmentCount    = int(sizeof(s_pAssignments) / sizeof(s_pAssignments[0]));
+
+}
+
+//-------------------------------------------------------------------------------------------------
+
+QMLCorpusGenerator::Random::Random(quint32 iSeed)
+    : m_iState(iSeed != 0 ? iSeed : CORPUS_DEFAULT_SEED)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int QMLCorpusGenerator::Random::next(int iRange)
+{
+    m_iState ^= m_iState << 13;
+    m_iState ^= m_iState >> 17;
+    m_iState ^= m_iState << 5;
+
+    return iRange > 0 ? int(m_iState % quint32(iRange)) : 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool QMLCorpusGenerator::Random::chance(int iPercent)
+{
+    return next(100) < iPercent;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Constructs a QMLCorpusGenerator with settings producing files of a few hundred lines.
+*/
+QMLCorpusGenerator::QMLCorpusGenerator()
+    : m_iSeed(CORPUS_DEFAULT_SEED)
+    , m_iFileCount(10)
+    , m_iDepth(3)
+    , m_iChildrenPerItem(3)
+    , m_iPropertiesPerItem(4)
+    , m_iFunctionsPerItem(1)
+    , m_iStatementsPerFunction(6)
+    , m_iImportsPerFile(2)
+    , m_iCommentPercent(20)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Destroys a QMLCorpusGenerator.
+*/
+QMLCorpusGenerator::~QMLCorpusGenerator()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the seed of the generator to \a iValue.
+*/
+void QMLCorpusGenerator::setSeed(quint32 iValue)
+{
+    m_iSeed = iValue;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the number of files generated by generate() to \a iValue.
+*/
+void QMLCorpusGenerator::setFileCount(int iValue)
+{
+    m_iFileCount = qMax(0, iValue);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the nesting depth of items to \a iValue. A depth of 1 only generates the root item.
+*/
+void QMLCorpusGenerator::setDepth(int iValue)
+{
+    m_iDepth = qMax(1, iValue);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the number of child items of each item above the deepest level to \a iValue.
+*/
+void QMLCorpusGenerator::setChildrenPerItem(int iValue)
+{
+    m_iChildrenPerItem = qMax(0, iValue);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the number of properties declared by each item to \a iValue.
+*/
+void QMLCorpusGenerator::setPropertiesPerItem(int iValue)
+{
+    m_iPropertiesPerItem = qMax(0, iValue);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the number of JS functions declared by each item to \a iValue.
+*/
+void QMLCorpusGenerator::setFunctionsPerItem(int iValue)
+{
+    m_iFunctionsPerItem = qMax(0, iValue);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the number of statements of each function to \a iValue.
+*/
+void QMLCorpusGenerator::setStatementsPerFunction(int iValue)
+{
+    m_iStatementsPerFunction = qMax(0, iValue);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the number of imports of each file to \a iValue, at most the number of known modules.
+*/
+void QMLCorpusGenerator::setImportsPerFile(int iValue)
+{
+    m_iImportsPerFile = qBound(0, iValue, s_iImportCount);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the percentage of declarations preceded by a comment to \a iValue.
+*/
+void QMLCorpusGenerator::setCommentPercent(int iValue)
+{
+    m_iCommentPercent = qBound(0, iValue, 100);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the seed of the generator.
+*/
+quint32 QMLCorpusGenerator::seed() const
+{
+    return m_iSeed;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of files generated by generate().
+*/
+int QMLCorpusGenerator::fileCount() const
+{
+    return m_iFileCount;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the nesting depth of items.
+*/
+int QMLCorpusGenerator::depth() const
+{
+    return m_iDepth;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of child items of each item above the deepest level.
+*/
+int QMLCorpusGenerator::childrenPerItem() const
+{
+    return m_iChildrenPerItem;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of properties declared by each item.
+*/
+int QMLCorpusGenerator::propertiesPerItem() const
+{
+    return m_iPropertiesPerItem;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of JS functions declared by each item.
+*/
+int QMLCorpusGenerator::functionsPerItem() const
+{
+    return m_iFunctionsPerItem;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of statements of each function.
+*/
+int QMLCorpusGenerator::statementsPerFunction() const
+{
+    return m_iStatementsPerFunction;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of imports of each file.
+*/
+int QMLCorpusGenerator::importsPerFile() const
+{
+    return m_iImportsPerFile;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the percentage of declarations preceded by a comment.
+*/
+int QMLCorpusGenerator::commentPercent() const
+{
+    return m_iCommentPercent;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the text of file number \a iIndex. The text only depends on the settings, the seed and \a iIndex.
+*/
+QString QMLCorpusGenerator::generateFile(int iIndex) const
+{
+    QString sText;
+    QTextStream stream(&sText);
+
+    // Each file has its own sequence so that any file can be generated alone
+    Random tRandom(m_iSeed ^ (quint32(iIndex + 1) * 0x9E3779B9u));
+
+    stream << "// Generated file " << iIndex << "\n";
+
+    for (int iImport = 0; iImport < m_iImportsPerFile; iImport++)
+    {
+        stream << "import " << s_pImports[iImport] << "\n";
+    }
+
+    stream << "\n";
+
+    generateItem(stream, tRandom, 0, QString("item%1").arg(iIndex));
+
+    stream.flush();
+
+    return sText;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the name of file number \a iIndex, without folder.
+*/
+QString QMLCorpusGenerator::fileName(int iIndex) const
+{
+    return QString("Generated%1.qml").arg(iIndex, 4, 10, QChar('0'));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Writes fileCount() files in \a sFolder, creating it if needed. Returns the paths of the files, or an empty list if
+    a file could not be written.
+*/
+QStringList QMLCorpusGenerator::generate(const QString& sFolder) const
+{
+    QStringList lFileNames;
+
+    if (QDir().mkpath(sFolder) == false)
+        return QStringList();
+
+    for (int iIndex = 0; iIndex < m_iFileCount; iIndex++)
+    {
+        QString sFileName = QString("%1/%2").arg(sFolder).arg(fileName(iIndex));
+        QFile file(sFileName);
+
+        if (file.open(QFile::WriteOnly) == false)
+            return QStringList();
+
+        file.write(generateFile(iIndex).toLatin1());
+        file.close();
+
+        lFileNames << sFileName;
+    }
+
+    return lFileNames;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Writes an item of nesting level \a iLevel identified by \a sId, then its children.
+*/
+void QMLCorpusGenerator::generateItem(QTextStream& stream, Random& tRandom, int iLevel, const QString& sId) const
+{
+    QString sIndent = indent(iLevel);
+    QString sInner = indent(iLevel + 1);
+
+    generateComment(stream, tRandom, iLevel);
+
+    stream << sIndent << s_pItemTypes[tRandom.next(s_iItemTypeCount)] << " {\n";
+    stream << sInner << "id: " << sId << "\n";
+
+    // Properties refer to the previous ones so that symbols are used
+    for (int iProperty = 0; iProperty < m_iPropertiesPerItem; iProperty++)
+    {
+        int iType = tRandom.next(s_iPropertyTypeCount);
+
+        generateComment(stream, tRandom, iLevel + 1);
+
+        stream << sInner << "property " << s_pPropertyTypes[iType] << " value" << iProperty << ": ";
+
+        switch (iType)
+        {
+            case 0:
+                if (iProperty > 0)
+                    stream << "value" << tRandom.next(iProperty) << " + " << tRandom.next(100);
+                else
+                    stream << tRandom.next(100);
+                break;
+            case 1:
+                stream << tRandom.next(1000) << "." << tRandom.next(10);
+                break;
+            case 2:
+                stream << "\"Text " << tRandom.next(1000) << "\"";
+                break;
+            case 3:
+                stream << (tRandom.chance(50) ? "true" : "false");
+                break;
+            default:
+                stream << "[ " << tRandom.next(10) << ", " << tRandom.next(10) << " ]";
+                break;
+        }
+
+        stream << "\n";
+    }
+
+    stream << sInner << s_pAssignments[tRandom.next(s_iAssignmentCount)] << "\n";
+
+    for (int iFunction = 0; iFunction < m_iFunctionsPerItem; iFunction++)
+    {
+        stream << "\n";
+        generateFunction(stream, tRandom, iLevel + 1, iFunction);
+    }
+
+    if (iLevel + 1 < m_iDepth)
+    {
+        for (int iChild = 0; iChild < m_iChildrenPerItem; iChild++)
+        {
+            stream << "\n";
+            generateItem(stream, tRandom, iLevel + 1, QString("%1x%2").arg(sId).arg(iChild));
+        }
+    }
+
+    stream << sIndent << "}\n";
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Writes function number \a iIndex of an item, its body being at \a iLevel + 1.
+*/
+void QMLCorpusGenerator::generateFunction(QTextStream& stream, Random& tRandom, int iLevel, int iIndex) const
+{
+    QString sIndent = indent(iLevel);
+    QString sBody = indent(iLevel + 1);
+    QString sNested = indent(iLevel + 2);
+
+    generateComment(stream, tRandom, iLevel);
+
+    stream << sIndent << "function compute" << iIndex << "(first, second) {\n";
+    stream << sBody << "var total = first + second;\n";
+
+    int iVariables = 0;
+
+    for (int iStatement = 0; iStatement < m_iStatementsPerFunction; iStatement++)
+    {
+        generateComment(stream, tRandom, iLevel + 1);
+
+        switch (iVariables == 0 ? 0 : tRandom.next(5))
+        {
+            case 0:
+                stream << sBody << "var local" << iVariables << " = total * " << (tRandom.next(9) + 1) << ";\n";
+                iVariables++;
+                break;
+            case 1:
+                stream << sBody << "if (local" << tRandom.next(iVariables) << " > " << tRandom.next(100) << ") {\n";
+                stream << sNested << "total = total - 1;\n";
+                stream << sBody << "}\n";
+                break;
+            case 2:
+                stream << sBody << "for (var index = 0; index < " << (tRandom.next(8) + 1) << "; index++) {\n";
+                stream << sNested << "total += index;\n";
+                stream << sBody << "}\n";
+                break;
+            case 3:
+                stream << sBody << "total += local" << tRandom.next(iVariables) << " * 2;\n";
+                break;
+            default:
+                stream << sBody << "while (total > 1000) {\n";
+                stream << sNested << "total = total / 2;\n";
+                stream << sBody << "}\n";
+                break;
+        }
+    }
+
+    stream << sBody << "return total;\n";
+    stream << sIndent << "}\n";
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Writes a single or multi line comment at \a iLevel, with a probability of commentPercent().
+*/
+void QMLCorpusGenerator::generateComment(QTextStream& stream, Random& tRandom, int iLevel) const
+{
+    if (tRandom.chance(m_iCommentPercent))
+    {
+        if (tRandom.chance(75))
+            stream << indent(iLevel) << "// Comment " << tRandom.next(1000) << "\n";
+        else
+            stream << indent(iLevel) << "/* Comment " << tRandom.next(1000) << " */\n";
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the indentation of \a iLevel.
+*/
+QString QMLCorpusGenerator::indent(int iLevel)
+{
+    return QString(CORPUS_INDENTATION).repeated(iLevel);
+}
@@ -0,0 +1,162 @@
+
+#pragma once
+
+#include "../qtplus_global.h"
+
+//-------------------------------------------------------------------------------------------------
+
+// Qt
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+//-------------------------------------------------------------------------------------------------
+
+#define CORPUS_DEFAULT_SEED             0x51A7E5u
+#define CORPUS_INDENTATION              "    "
+
+//-------------------------------------------------------------------------------------------------
+
+//! Generates synthetic QML projects of configurable size and shape, used for benchmarks
+//! The same settings and seed always produce the same files
+class QTPLUSSHARED_EXPORT QMLCorpusGenerator
+{
+public:
+
+    //-------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    //-------------------------------------------------------------------------------------------------
+
+    //! Constructor
+    QMLCorpusGenerator();
+
+    //! Destructor
+    virtual ~QMLCorpusGenerator();
+
+    //-------------------------------------------------------------------------------------------------
+    // Setters
+    //-------------------------------------------------------------------------------------------------
+
+    //! Sets the seed of the generator
+    void setSeed(quint32 iValue);
+
+    //! Sets the number of files of a project
+    void setFileCount(int iValue);
+
+    //! Sets the nesting depth of items
+    void setDepth(int iValue);
+
+    //! Sets the number of child items of each item above the deepest level
+    void setChildrenPerItem(int iValue);
+
+    //! Sets the number of properties of each item
+    void setPropertiesPerItem(int iValue);
+
+    //! Sets the number of JS functions of each item
+    void setFunctionsPerItem(int iValue);
+
+    //! Sets the number of statements of each function
+    void setStatementsPerFunction(int iValue);
+
+    //! Sets the number of imports of each file
+    void setImportsPerFile(int iValue);
+
+    //! Sets the percentage of declarations preceded by a comment
+    void setCommentPercent(int iValue);
+
+    //-------------------------------------------------------------------------------------------------
+    // Getters
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the seed of the generator
+    quint32 seed() const;
+
+    //! Returns the number of files of a project
+    int fileCount() const;
+
+    //! Returns the nesting depth of items
+    int depth() const;
+
+    //! Returns the number of child items of each item
+    int childrenPerItem() const;
+
+    //! Returns the number of properties of each item
+    int propertiesPerItem() const;
+
+    //! Returns the number of JS functions of each item
+    int functionsPerItem() const;
+
+    //! Returns the number of statements of each function
+    int statementsPerFunction() const;
+
+    //! Returns the number of imports of each file
+    int importsPerFile() const;
+
+    //! Returns the percentage of declarations preceded by a comment
+    int commentPercent() const;
+
+    //-------------------------------------------------------------------------------------------------
+    // Control methods
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the text of file number iIndex
+    QString generateFile(int iIndex) const;
+
+    //! Returns the name of file number iIndex
+    QString fileName(int iIndex) const;
+
+    //! Writes all files of a project in sFolder, returns their paths or an empty list on failure
+    QStringList generate(const QString& sFolder) const;
+
+    //-------------------------------------------------------------------------------------------------
+    // Protected types and methods
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! A small deterministic random number generator (xorshift)
+    class Random
+    {
+    public:
+
+        Random(quint32 iSeed);
+
+        //! Returns a number in [0, iRange[
+        int next(int iRange);
+
+        //! Returns true with a probability of iPercent
+        bool chance(int iPercent);
+
+    protected:
+
+        quint32 m_iState;
+    };
+
+    //! Writes an item at iLevel and its children
+    void generateItem(QTextStream& stream, Random& tRandom, int iLevel, const QString& sId) const;
+
+    //! Writes a function of an item
+    void generateFunction(QTextStream& stream, Random& tRandom, int iLevel, int iIndex) const;
+
+    //! Writes a comment if the random generator decides so
+    void generateComment(QTextStream& stream, Random& tRandom, int iLevel) const;
+
+    //! Returns the indentation of iLevel
+    static QString indent(int iLevel);
+
+    //-------------------------------------------------------------------------------------------------
+    // Properties
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    quint32     m_iSeed;
+    int         m_iFileCount;
+    int         m_iDepth;
+    int         m_iChildrenPerItem;
+    int         m_iPropertiesPerItem;
+    int         m_iFunctionsPerItem;
+    int         m_iStatementsPerFunction;
+    int         m_iImportsPerFile;
+    int         m_iCommentPercent;
+};
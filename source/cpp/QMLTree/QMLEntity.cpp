@@ -12,6 +12,7 @@
 #include "QMLFor.h"
 #include "QMLForIn.h"
 #include "QMLComment.h"
+#include "QMLEntityFactory.h"
 
 //-------------------------------------------------------------------------------------------------
 
@@ -23,9 +24,20 @@
 
 //-------------------------------------------------------------------------------------------------
 
-QList<QMLEntity*> QMLEntity::s_vEntities;
-int QMLEntity::s_iCreatedEntities = 0;
-int QMLEntity::s_iDeletedEntities = 0;
+#ifdef TRACK_ENTITIES
+QAtomicInt QMLEntity::s_iCreatedEntities;
+QAtomicInt QMLEntity::s_iDeletedEntities;
+#endif
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Instantiates a new QMLEntity.
+*/
+QMLEntity* QMLEntity::instantiator()
+{
+    return new QMLEntity(QPoint());
+}
 
 //-------------------------------------------------------------------------------------------------
 
@@ -40,8 +52,7 @@ QMLEntity::QMLEntity(const QPoint& pPosition)
     , m_bIsParenthesized(false)
 {
 #ifdef TRACK_ENTITIES
-    s_iCreatedEntities++;
-    s_vEntities << this;
+    s_iCreatedEntities.ref();
 #endif
 }
 
@@ -58,8 +69,7 @@ QMLEntity::QMLEntity(const QPoint& pPosition, const QVariant& value)
     , m_bIsParenthesized(false)
 {
 #ifdef TRACK_ENTITIES
-    s_iCreatedEntities++;
-    s_vEntities << this;
+    s_iCreatedEntities.ref();
 #endif
 }
 
@@ -71,13 +81,32 @@ QMLEntity::QMLEntity(const QPoint& pPosition, const QVariant& value)
 QMLEntity::~QMLEntity()
 {
 #ifdef TRACK_ENTITIES
-    s_iDeletedEntities++;
-    s_vEntities.removeAll(this);
+    s_iDeletedEntities.ref();
 #endif
 }
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Allocates \a iSize bytes for an entity from the arena of the context being parsed, if any.
+*/
+void* QMLEntity::operator new(size_t iSize)
+{
+    return QMLEntityArena::allocate(iSize);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Releases \a pMemory. Memory from an arena is freed with the arena.
+*/
+void QMLEntity::operator delete(void* pMemory)
+{
+    QMLEntityArena::release(pMemory);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Sets the entity's value to \a value.
 */
@@ -195,11 +224,70 @@ QString QMLEntity::toSimpleString() const
 //-------------------------------------------------------------------------------------------------
 
 /*!
-    Returns a map of class members.
+    Returns a map of class members that are not null. \br\br
+    The map is built on each call, visitMembers() and forEachMember() iterate without allocating.
 */
 QMap<QString, QMLEntity*> QMLEntity::members()
 {
-    return QMap<QString, QMLEntity*>();
+    class MapBuilder : public QMLMemberVisitor
+    {
+    public:
+
+        virtual void visitMember(const char* sName, QMLEntity* pMember) Q_DECL_OVERRIDE
+        {
+            m_mMembers[QString(sName)] = pMember;
+        }
+
+        QMap<QString, QMLEntity*> m_mMembers;
+    };
+
+    MapBuilder tBuilder;
+    visitMembers(tBuilder);
+    return tBuilder.m_mMembers;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the member named \a sName, or \c nullptr if there is none or if it is null.
+*/
+QMLEntity* QMLEntity::member(const QString& sName)
+{
+    class MemberFinder : public QMLMemberVisitor
+    {
+    public:
+
+        MemberFinder(const QString& sName)
+            : m_sName(sName)
+            , m_pMember(nullptr)
+        {
+        }
+
+        virtual void visitMember(const char* sName, QMLEntity* pMember) Q_DECL_OVERRIDE
+        {
+            if (m_pMember == nullptr && m_sName == QLatin1String(sName))
+            {
+                m_pMember = pMember;
+            }
+        }
+
+        const QString&  m_sName;
+        QMLEntity*      m_pMember;
+    };
+
+    MemberFinder tFinder(sName);
+    visitMembers(tFinder);
+    return tFinder.m_pMember;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Calls \a tVisitor for each member. The base entity has none.
+*/
+void QMLEntity::visitMembers(QMLMemberVisitor& tVisitor)
+{
+    Q_UNUSED(tVisitor);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -261,16 +349,11 @@ QMLEntity* QMLEntity::clone() const
 */
 void QMLEntity::solveSymbols(QMLTreeContext* pContext)
 {
-    QMap<QString, QMLEntity*> mMembers = members();
-
-    for (QString sMemberKey : mMembers.keys())
+    forEachMember([this, pContext](QMLEntity* pMember)
     {
-        if (mMembers[sMemberKey] != nullptr)
-        {
-            mMembers[sMemberKey]->setParent(this);
-            mMembers[sMemberKey]->solveSymbols(pContext);
-        }
-    }
+        pMember->setParent(this);
+        pMember->solveSymbols(pContext);
+    });
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -282,15 +365,10 @@ void QMLEntity::solveSymbols(QMLTreeContext* pContext)
 */
 void QMLEntity::solveReferences(QMLTreeContext* pContext)
 {
-    QMap<QString, QMLEntity*> mMembers = members();
-
-    for (QString sMemberKey : mMembers.keys())
+    forEachMember([pContext](QMLEntity* pMember)
     {
-        if (mMembers[sMemberKey] != nullptr)
-        {
-            mMembers[sMemberKey]->solveReferences(pContext);
-        }
-    }
+        pMember->solveReferences(pContext);
+    });
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -302,15 +380,10 @@ void QMLEntity::solveReferences(QMLTreeContext* pContext)
 */
 void QMLEntity::solveSymbolUsages(QMLTreeContext* pContext)
 {
-    QMap<QString, QMLEntity*> mMembers = members();
-
-    for (QString sMemberKey : mMembers.keys())
+    forEachMember([pContext](QMLEntity* pMember)
     {
-        if (mMembers[sMemberKey] != nullptr)
-        {
-            mMembers[sMemberKey]->solveSymbolUsages(pContext);
-        }
-    }
+        pMember->solveSymbolUsages(pContext);
+    });
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -320,15 +393,10 @@ void QMLEntity::solveSymbolUsages(QMLTreeContext* pContext)
 */
 void QMLEntity::sortContents()
 {
-    QMap<QString, QMLEntity*> mMembers = members();
-
-    for (QString sMemberKey : mMembers.keys())
+    forEachMember([](QMLEntity* pMember)
     {
-        if (mMembers[sMemberKey] != nullptr)
-        {
-            mMembers[sMemberKey]->sortContents();
-        }
-    }
+        pMember->sortContents();
+    });
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -341,23 +409,18 @@ QMap<QString, QMLEntity*> QMLEntity::getDeclaredSymbols()
 {
     QMap<QString, QMLEntity*> mReturnValue;
 
-    QMap<QString, QMLEntity*> mMembers = members();
-
-    for (QString sMemberKey : mMembers.keys())
+    forEachMember([&mReturnValue](QMLEntity* pMember)
     {
-        if (mMembers[sMemberKey] != nullptr)
-        {
-            QMap<QString, QMLEntity*> memberSymbols = mMembers[sMemberKey]->getDeclaredSymbols();
+        QMap<QString, QMLEntity*> memberSymbols = pMember->getDeclaredSymbols();
 
-            for (QString sSymbolKey : memberSymbols.keys())
+        for (QString sSymbolKey : memberSymbols.keys())
+        {
+            if (mReturnValue.contains(sSymbolKey) == false)
             {
-                if (mReturnValue.contains(sSymbolKey) == false)
-                {
-                    mReturnValue[sSymbolKey] = memberSymbols[sSymbolKey];
-                }
+                mReturnValue[sSymbolKey] = memberSymbols[sSymbolKey];
             }
         }
-    }
+    });
 
     return mReturnValue;
 }
@@ -399,15 +462,10 @@ QMLEntity* QMLEntity::findSymbolDeclarationDescending(QStringList& lQualifiedNam
 */
 void QMLEntity::removeUnreferencedSymbols(QMLTreeContext* pContext)
 {
-    QMap<QString, QMLEntity*> mMembers = members();
-
-    for (QString sMemberKey : mMembers.keys())
+    forEachMember([pContext](QMLEntity* pMember)
     {
-        if (mMembers[sMemberKey] != nullptr)
-        {
-            mMembers[sMemberKey]->removeUnreferencedSymbols(pContext);
-        }
-    }
+        pMember->removeUnreferencedSymbols(pContext);
+    });
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -460,44 +518,129 @@ void QMLEntity::toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEnt
 */
 CXMLNode QMLEntity::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
 {
-    Q_UNUSED(pContext);
     Q_UNUSED(pParent);
 
-    CXMLNode xNode(metaObject()->className());
+    QMLXMLNodeWriter tWriter;
+    writeXML(tWriter, pContext);
+
+    return tWriter.root();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Writes the XML representation of this item to \a xStream. \br\br
+    The output is the same as the one of toXMLNode(), but elements are written as the tree is visited,
+    so memory use does not grow with the size of the tree. \a pContext is a user defined context.
+*/
+void QMLEntity::toXMLStream(QXmlStreamWriter& xStream, CXMLNodableContext* pContext)
+{
+    QMLXMLStreamWriter tWriter(xStream);
+    writeXML(tWriter, pContext);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Writes the element of this item to \a tWriter : its attributes, then its children.
+*/
+void QMLEntity::writeXML(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
+{
+    tWriter.startElement(metaObject()->className());
+    writeXMLAttributes(tWriter);
+    writeXMLChildren(tWriter, pContext);
+    tWriter.endElement();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Writes the attributes of this item to \a tWriter.
+*/
+void QMLEntity::writeXMLAttributes(QMLXMLWriter& tWriter)
+{
     QString sValue = m_vValue.value<QString>();
 
-    xNode.attributes()["Position"] = QString("[%1, %2]").arg(m_pPosition.x()).arg(m_pPosition.y());
+    tWriter.setAttribute("Position", QString("[%1, %2]").arg(m_pPosition.x()).arg(m_pPosition.y()));
 
     if (sValue.isEmpty() == false)
     {
-        xNode.attributes()["Value"] = sValue;
+        tWriter.setAttribute("Value", sValue);
     }
 
     if (m_bIsParenthesized)
     {
-        xNode.attributes()["IsParenthesized"] = "true";
+        tWriter.setAttribute("IsParenthesized", "true");
     }
 
     if (parent() == nullptr)
     {
-        xNode.attributes()["Parent"] = "NULL";
+        tWriter.setAttribute("Parent", "NULL");
     }
 
     if (m_pOrigin != nullptr)
     {
-        xNode.attributes()["Origin"] = QString("(Class: %1, Address: %2)")
+        tWriter.setAttribute("Origin", QString("(Class: %1, Address: %2)")
                 .arg(m_pOrigin->metaObject()->className())
-                .arg(QString("0x") + QString::number(qulonglong(m_pOrigin), 16));
+                .arg(QString("0x") + QString::number(qulonglong(m_pOrigin), 16)));
     }
 
     if (m_iUsageCount > 0)
     {
-        xNode.attributes()["UsageCount"] = QString::number(m_iUsageCount);
+        tWriter.setAttribute("UsageCount", QString::number(m_iUsageCount));
     }
 
-    xNode.attributes()["Address"] = QString("0x") + QString::number(qulonglong(this), 16);
+    tWriter.setAttribute("Address", QString("0x") + QString::number(qulonglong(this), 16));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Writes the child elements of this item to \a tWriter. A simple entity has none.
+*/
+void QMLEntity::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
+{
+    Q_UNUSED(tWriter);
+    Q_UNUSED(pContext);
+}
 
-    return xNode;
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Writes the parsed state of the entity to \a stream. \br\br
+    Only what the parser sets is written : symbols, references and usages are solved again after reading. \br
+    \a pTracker is passed to child entities.
+*/
+void QMLEntity::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    Q_UNUSED(pTracker);
+
+    stream << m_vValue;
+    stream << m_pPosition;
+    stream << qint32(m_iUsageCount);
+    stream << m_bIsParenthesized;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Reads the parsed state of the entity from \a stream. \br\br
+    \a pTracker is passed to child entities. \br
+    \a pRootObject is the QMLTreeContext that reads the tree.
+*/
+void QMLEntity::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    Q_UNUSED(pTracker);
+    Q_UNUSED(pRootObject);
+
+    qint32 iUsageCount = 0;
+
+    stream >> m_vValue;
+    stream >> m_pPosition;
+    stream >> iUsageCount;
+    stream >> m_bIsParenthesized;
+
+    m_iUsageCount = iUsageCount;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -585,33 +728,108 @@ bool QMLEntity::isComment(const QMLEntity* pEntity)
 //-------------------------------------------------------------------------------------------------
 
 /*!
-    Returns number of created QMLEntity objects.
+    Returns the number of live QMLEntity objects. Always 0 unless TRACK_ENTITIES is defined.
 */
 int QMLEntity::entityCount()
 {
-    return s_vEntities.count();
+    return createdEntities() - deletedEntities();
 }
 
 /*!
-    Returns number of created QMLEntity objects.
+    Returns the number of created QMLEntity objects. Always 0 unless TRACK_ENTITIES is defined.
 */
 int QMLEntity::createdEntities()
 {
-    return s_iCreatedEntities;
+#ifdef TRACK_ENTITIES
+    return s_iCreatedEntities.loadAcquire();
+#else
+    return 0;
+#endif
 }
 
 /*!
-    Returns number of deleted QMLEntity objects.
+    Returns the number of deleted QMLEntity objects. Always 0 unless TRACK_ENTITIES is defined.
 */
 int QMLEntity::deletedEntities()
 {
-    return s_iDeletedEntities;
+#ifdef TRACK_ENTITIES
+    return s_iDeletedEntities.loadAcquire();
+#else
+    return 0;
+#endif
 }
 
+//-------------------------------------------------------------------------------------------------
+
 /*!
-    Returns created QMLEntity objects.
+    Writes the class index of \a pEntity in QMLEntityFactory, followed by its state, to \a stream. \br\br
+    \a pEntity may be \c nullptr. \br
+    \a pTracker is passed to child entities.
 */
-QList<QMLEntity*>& QMLEntity::entities()
+void QMLEntity::serializeEntity(QDataStream& stream, CObjectTracker* pTracker, const QMLEntity* pEntity)
 {
-    return s_vEntities;
+    if (pEntity == nullptr)
+    {
+        stream << quint8(SERIAL_NULL_ENTITY);
+        return;
+    }
+
+    int iIndex = QMLEntityFactory::getInstance()->productIndex(pEntity->metaObject()->className());
+
+    Q_ASSERT_X(iIndex >= 0 && iIndex < SERIAL_NULL_ENTITY, "QMLEntity::serializeEntity", "Class not registered in QMLEntityFactory");
+
+    if (iIndex < 0 || iIndex >= SERIAL_NULL_ENTITY)
+    {
+        stream.setStatus(QDataStream::WriteFailed);
+        return;
+    }
+
+    stream << quint8(iIndex);
+
+    pEntity->serialize(stream, pTracker);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Reads an entity written by \c serializeEntity() from \a stream. \br\br
+    Returns \c nullptr for a null entity or if the stream is corrupt. \br
+    \a pTracker is passed to child entities. \br
+    \a pRootObject is the QMLTreeContext that reads the tree.
+*/
+QMLEntity* QMLEntity::deserializeEntity(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    quint8 iIndex = SERIAL_NULL_ENTITY;
+
+    stream >> iIndex;
+
+    if (iIndex == SERIAL_NULL_ENTITY || stream.status() != QDataStream::Ok)
+        return nullptr;
+
+    QMLEntity* pEntity = QMLEntityFactory::getInstance()->instanciateProduct(int(iIndex));
+
+    if (pEntity == nullptr)
+    {
+        stream.setStatus(QDataStream::ReadCorruptData);
+        return nullptr;
+    }
+
+    pEntity->deserialize(stream, pTracker, pRootObject);
+
+    return pEntity;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Writes an element named \a sTag to \a tWriter, holding the element of \a pMember if it is not null.
+*/
+void QMLEntity::writeXMLMember(QMLXMLWriter& tWriter, CXMLNodableContext* pContext, const QString& sTag, QMLEntity* pMember)
+{
+    tWriter.startElement(sTag);
+
+    if (pMember != nullptr)
+        pMember->writeXML(tWriter, pContext);
+
+    tWriter.endElement();
 }
@@ -10,23 +10,80 @@
 #include <QVariant>
 #include <QTextStream>
 #include <QPoint>
+#include <QDataStream>
+#include <QAtomicInt>
 
 // Library
 #include "../CDumpable.h"
 #include "../CXMLNodable.h"
+#include "../ISerializable.h"
 #include "QMLFormatter.h"
+#include "QMLEntityArena.h"
+#include "QMLXMLWriter.h"
 
+// Counts created and deleted entities and reports leaks when a context is destroyed
 // #define TRACK_ENTITIES
 
+// Written in place of a class index for null entities
+#define SERIAL_NULL_ENTITY  0xFF
+
 //-------------------------------------------------------------------------------------------------
 // Forward declarations
 
 class QMLTreeContext;
+class QMLEntity;
+
+//-------------------------------------------------------------------------------------------------
+
+//! Defines a visitor of the members of an entity, see QMLEntity::visitMembers()
+class QTPLUSSHARED_EXPORT QMLMemberVisitor
+{
+public:
+
+    //! Destructor
+    virtual ~QMLMemberVisitor() {}
+
+    //! Called for each member that is not null, in member name order
+    virtual void visitMember(const char* sName, QMLEntity* pMember) = 0;
+
+    //! Calls visitMember() if pMember is not null
+    void visit(const char* sName, QMLEntity* pMember)
+    {
+        if (pMember != nullptr)
+        {
+            visitMember(sName, pMember);
+        }
+    }
+};
+
+//-------------------------------------------------------------------------------------------------
+
+//! Adapts a function object taking a member entity to a QMLMemberVisitor
+template <class T>
+class QMLMemberFunctionVisitor : public QMLMemberVisitor
+{
+public:
+
+    QMLMemberFunctionVisitor(T& tFunction)
+        : m_tFunction(tFunction)
+    {
+    }
+
+    virtual void visitMember(const char* sName, QMLEntity* pMember) Q_DECL_OVERRIDE
+    {
+        Q_UNUSED(sName);
+        m_tFunction(pMember);
+    }
+
+protected:
+
+    T& m_tFunction;
+};
 
 //-------------------------------------------------------------------------------------------------
 
 //! Defines the base entity of a QML tree
-class QTPLUSSHARED_EXPORT QMLEntity : public QObject, public CDumpable, public CXMLNodable
+class QTPLUSSHARED_EXPORT QMLEntity : public QObject, public CDumpable, public CXMLNodable, public ISerializable
 {
     Q_OBJECT
 
@@ -36,6 +93,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLEntity
+    static QMLEntity* instantiator();
+
     //! Default constructor
     QMLEntity(const QPoint& pPosition);
 
@@ -45,6 +105,12 @@ public:
     //! Destructor
     virtual ~QMLEntity();
 
+    //! Allocates from the current QMLEntityArena
+    static void* operator new(size_t iSize);
+
+    //! Releases memory allocated by operator new
+    static void operator delete(void* pMemory);
+
     //-------------------------------------------------------------------------------------------------
     // Setters
     //-------------------------------------------------------------------------------------------------
@@ -86,8 +152,22 @@ public:
     //!
     QString toSimpleString() const;
 
-    //! Returns all members
-    virtual QMap<QString, QMLEntity*> members();
+    //! Returns all members that are not null, builds a map : use visitMembers() or forEachMember() to iterate
+    QMap<QString, QMLEntity*> members();
+
+    //! Returns the member named sName, nullptr if there is none
+    QMLEntity* member(const QString& sName);
+
+    //! Calls tVisitor for each member
+    virtual void visitMembers(QMLMemberVisitor& tVisitor);
+
+    //! Calls tFunction(QMLEntity*) for each member that is not null
+    template <class T>
+    void forEachMember(T tFunction)
+    {
+        QMLMemberFunctionVisitor<T> tVisitor(tFunction);
+        visitMembers(tVisitor);
+    }
 
     //!
     QMLEntity* previousSibling() const;
@@ -133,6 +213,18 @@ public:
     //!
     virtual void toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntity* pParent = nullptr) const;
 
+    //! Writes the XML representation of the entity to xStream without building a CXMLNode tree
+    void toXMLStream(QXmlStreamWriter& xStream, CXMLNodableContext* pContext = nullptr);
+
+    //! Writes the element of the entity to tWriter
+    void writeXML(QMLXMLWriter& tWriter, CXMLNodableContext* pContext);
+
+    //! Writes the attributes of the entity's element
+    virtual void writeXMLAttributes(QMLXMLWriter& tWriter);
+
+    //! Writes the child elements of the entity's element
+    virtual void writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext);
+
     //-------------------------------------------------------------------------------------------------
     // Overridden methods
     //-------------------------------------------------------------------------------------------------
@@ -140,6 +232,12 @@ public:
     //!
     virtual CXMLNode toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent) Q_DECL_OVERRIDE;
 
+    //! Writes the parsed state of the entity
+    virtual void serialize(QDataStream& stream, CObjectTracker* pTracker) const Q_DECL_OVERRIDE;
+
+    //! Reads the parsed state of the entity, pRootObject is the reading QMLTreeContext
+    virtual void deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject) Q_DECL_OVERRIDE;
+
     //-------------------------------------------------------------------------------------------------
     // Static methods
     //-------------------------------------------------------------------------------------------------
@@ -174,8 +272,30 @@ public:
     //!
     static int deletedEntities();
 
-    //!
-    static QList<QMLEntity*>& entities();
+    //! Writes the class and state of pEntity, which may be null
+    static void serializeEntity(QDataStream& stream, CObjectTracker* pTracker, const QMLEntity* pEntity);
+
+    //! Reads an entity written by serializeEntity
+    static QMLEntity* deserializeEntity(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject);
+
+    //! Writes an element named sTag holding the element of pMember, which may be null
+    static void writeXMLMember(QMLXMLWriter& tWriter, CXMLNodableContext* pContext, const QString& sTag, QMLEntity* pMember);
+
+    //! Reads an entity written by serializeEntity, flags the stream as corrupt if it is not a T
+    template <class T>
+    static T* deserializeEntityAs(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+    {
+        QMLEntity* pEntity = deserializeEntity(stream, pTracker, pRootObject);
+        T* pTypedEntity = dynamic_cast<T*>(pEntity);
+
+        if (pEntity != nullptr && pTypedEntity == nullptr)
+        {
+            delete pEntity;
+            stream.setStatus(QDataStream::ReadCorruptData);
+        }
+
+        return pTypedEntity;
+    }
 
     //-------------------------------------------------------------------------------------------------
     // Properties
@@ -189,7 +309,8 @@ protected:
     int         m_iUsageCount;
     bool        m_bIsParenthesized;
 
-    static QList<QMLEntity*>    s_vEntities;
-    static int                  s_iCreatedEntities;
-    static int                  s_iDeletedEntities;
+#ifdef TRACK_ENTITIES
+    static QAtomicInt           s_iCreatedEntities;
+    static QAtomicInt           s_iDeletedEntities;
+#endif
 };
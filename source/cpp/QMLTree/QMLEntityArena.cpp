@@ -0,0 +1,225 @@
+
+// std
+#include <cstdlib>
+#include <new>
+
+// Application
+#include "QMLEntityArena.h"
+#include "QMLEntity.h"
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    \class QMLEntityArena
+    \inmodule qt-plus
+    \brief A memory arena for QML entities. \br
+    While an arena is current for a thread, every QMLEntity created by that thread is placed in it.
+    Deleting such an entity runs its destructor but does not free its memory : all blocks are freed at once
+    when the arena is destroyed. Each QMLFile owns the arena of its entities, so the memory of a tree is
+    given back when its file is deleted. \br
+    Each allocation is preceded by a small header telling if it lives in an arena or on the heap, so entities
+    created outside of a parse can be mixed freely with arena ones.
+    \sa QMLFile, QMLTreeContext
+*/
+
+//-------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+//! Precedes every allocation
+struct QMLArenaHeader
+{
+    quint32 iSize;          // Size of the allocation, header excluded
+    quint32 iFlags;
+};
+
+enum EArenaFlags
+{
+    afInArena   = 0x0001,
+    afAlive     = 0x0002
+};
+
+static_assert(sizeof(QMLArenaHeader) <= ARENA_HEADER_SIZE, "QMLArenaHeader does not fit ARENA_HEADER_SIZE");
+
+thread_local QMLEntityArena* s_pCurrentArena = nullptr;
+
+size_t alignSize(size_t iSize)
+{
+    return (iSize + ARENA_ALIGNMENT - 1) & ~size_t(ARENA_ALIGNMENT - 1);
+}
+
+QMLArenaHeader* headerOf(void* pMemory)
+{
+    return reinterpret_cast<QMLArenaHeader*>(static_cast<char*>(pMemory) - ARENA_HEADER_SIZE);
+}
+
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Constructs an empty QMLEntityArena.
+*/
+QMLEntityArena::QMLEntityArena()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Destroys a QMLEntityArena, freeing all its memory. Entities still alive in it must not be used anymore.
+*/
+QMLEntityArena::~QMLEntityArena()
+{
+    for (const Block& tBlock : m_vBlocks)
+    {
+        std::free(tBlock.pData);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of bytes reserved by the arena.
+*/
+qint64 QMLEntityArena::reservedBytes() const
+{
+    qint64 iTotal = 0;
+
+    for (const Block& tBlock : m_vBlocks)
+    {
+        iTotal += qint64(tBlock.iCapacity);
+    }
+
+    return iTotal;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the entities allocated in the arena that were not deleted. Walks all blocks, meant for leak reports.
+*/
+QList<QMLEntity*> QMLEntityArena::liveEntities() const
+{
+    QList<QMLEntity*> lEntities;
+
+    for (const Block& tBlock : m_vBlocks)
+    {
+        size_t iOffset = 0;
+
+        while (iOffset < tBlock.iUsed)
+        {
+            QMLArenaHeader* pHeader = reinterpret_cast<QMLArenaHeader*>(tBlock.pData + iOffset);
+
+            if (pHeader->iFlags & afAlive)
+            {
+                lEntities << reinterpret_cast<QMLEntity*>(tBlock.pData + iOffset + ARENA_HEADER_SIZE);
+            }
+
+            iOffset += ARENA_HEADER_SIZE + alignSize(pHeader->iSize);
+        }
+    }
+
+    return lEntities;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the arena used for new entities by the calling thread, or \c nullptr if they go to the heap.
+*/
+QMLEntityArena* QMLEntityArena::current()
+{
+    return s_pCurrentArena;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the arena used for new entities by the calling thread to \a pArena. \c nullptr means the heap.
+*/
+void QMLEntityArena::setCurrent(QMLEntityArena* pArena)
+{
+    s_pCurrentArena = pArena;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Allocates \a iSize bytes from the current arena, or from the heap if there is none.
+*/
+void* QMLEntityArena::allocate(size_t iSize)
+{
+    QMLArenaHeader* pHeader = nullptr;
+
+    if (s_pCurrentArena != nullptr)
+    {
+        pHeader = reinterpret_cast<QMLArenaHeader*>(s_pCurrentArena->allocateInBlocks(iSize));
+        pHeader->iFlags = afInArena | afAlive;
+    }
+    else
+    {
+        pHeader = static_cast<QMLArenaHeader*>(std::malloc(ARENA_HEADER_SIZE + iSize));
+
+        if (pHeader == nullptr)
+            throw std::bad_alloc();
+
+        pHeader->iFlags = afAlive;
+    }
+
+    pHeader->iSize = quint32(iSize);
+
+    return reinterpret_cast<char*>(pHeader) + ARENA_HEADER_SIZE;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Releases \a pMemory, returned by \c allocate(). Memory from an arena stays reserved until the arena is destroyed.
+*/
+void QMLEntityArena::release(void* pMemory)
+{
+    if (pMemory == nullptr)
+        return;
+
+    QMLArenaHeader* pHeader = headerOf(pMemory);
+
+    if (pHeader->iFlags & afInArena)
+    {
+        pHeader->iFlags &= ~quint32(afAlive);
+    }
+    else
+    {
+        std::free(pHeader);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns room for \a iSize bytes plus a header, from the last block or from a new one.
+*/
+char* QMLEntityArena::allocateInBlocks(size_t iSize)
+{
+    size_t iNeeded = ARENA_HEADER_SIZE + alignSize(iSize);
+
+    if (m_vBlocks.isEmpty() || m_vBlocks.last().iUsed + iNeeded > m_vBlocks.last().iCapacity)
+    {
+        Block tBlock;
+        tBlock.iCapacity = qMax(size_t(ARENA_BLOCK_SIZE), iNeeded);
+        tBlock.iUsed = 0;
+        tBlock.pData = static_cast<char*>(std::malloc(tBlock.iCapacity));
+
+        if (tBlock.pData == nullptr)
+            throw std::bad_alloc();
+
+        m_vBlocks << tBlock;
+    }
+
+    Block& tBlock = m_vBlocks.last();
+    char* pMemory = tBlock.pData + tBlock.iUsed;
+    tBlock.iUsed += iNeeded;
+
+    return pMemory;
+}
@@ -0,0 +1,121 @@
+
+#pragma once
+
+#include "../qtplus_global.h"
+
+//-------------------------------------------------------------------------------------------------
+
+// Qt
+#include <QVector>
+#include <QList>
+
+//-------------------------------------------------------------------------------------------------
+// Forward declarations
+
+class QMLEntity;
+
+//-------------------------------------------------------------------------------------------------
+
+#define ARENA_BLOCK_SIZE        65536
+#define ARENA_ALIGNMENT         16
+#define ARENA_HEADER_SIZE       16
+
+//-------------------------------------------------------------------------------------------------
+
+//! Defines a memory arena from which the entities of a QMLFile are allocated
+//! Entities keep their destructors, but their memory is only given back when the arena is destroyed
+class QTPLUSSHARED_EXPORT QMLEntityArena
+{
+public:
+
+    //-------------------------------------------------------------------------------------------------
+    // Inner classes
+    //-------------------------------------------------------------------------------------------------
+
+    //! Makes an arena current for the calling thread during the lifetime of the object
+    class Scope
+    {
+    public:
+
+        Scope(QMLEntityArena* pArena)
+            : m_pPrevious(QMLEntityArena::current())
+        {
+            QMLEntityArena::setCurrent(pArena);
+        }
+
+        ~Scope()
+        {
+            QMLEntityArena::setCurrent(m_pPrevious);
+        }
+
+    protected:
+
+        QMLEntityArena* m_pPrevious;
+    };
+
+    //-------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    //-------------------------------------------------------------------------------------------------
+
+    //! Constructor
+    QMLEntityArena();
+
+    //! Destructor, frees all blocks
+    virtual ~QMLEntityArena();
+
+    //-------------------------------------------------------------------------------------------------
+    // Getters
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the number of bytes reserved by the arena
+    qint64 reservedBytes() const;
+
+    //! Returns entities allocated in the arena and not deleted
+    QList<QMLEntity*> liveEntities() const;
+
+    //-------------------------------------------------------------------------------------------------
+    // Static methods
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the arena used by new entities in the calling thread, nullptr for the heap
+    static QMLEntityArena* current();
+
+    //! Sets the arena used by new entities in the calling thread
+    static void setCurrent(QMLEntityArena* pArena);
+
+    //! Allocates iSize bytes from the current arena, or from the heap if there is none
+    static void* allocate(size_t iSize);
+
+    //! Releases memory returned by allocate()
+    static void release(void* pMemory);
+
+    //-------------------------------------------------------------------------------------------------
+    // Protected types and methods
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! A chunk of memory holding consecutive allocations
+    struct Block
+    {
+        char*   pData;
+        size_t  iUsed;
+        size_t  iCapacity;
+    };
+
+    //! Allocates iSize bytes, header included, from the last block or a new one
+    char* allocateInBlocks(size_t iSize);
+
+    //-------------------------------------------------------------------------------------------------
+    // Properties
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    QVector<Block>  m_vBlocks;
+
+private:
+
+    QMLEntityArena(const QMLEntityArena&);
+    QMLEntityArena& operator = (const QMLEntityArena&);
+};
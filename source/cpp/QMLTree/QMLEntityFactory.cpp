@@ -0,0 +1,129 @@
+
+// Application
+#include "QMLEntityFactory.h"
+#include "QMLComplexEntity.h"
+#include "QMLNameValue.h"
+#include "QMLIdentifier.h"
+#include "QMLType.h"
+#include "QMLImport.h"
+#include "QMLPragma.h"
+#include "QMLItem.h"
+#include "QMLSpecialValue.h"
+#include "QMLPropertyDeclaration.h"
+#include "QMLPropertyAssignment.h"
+#include "QMLPropertyAlias.h"
+#include "QMLFunction.h"
+#include "QMLFunctionCall.h"
+#include "QMLFunctionParameter.h"
+#include "QMLVariableDeclaration.h"
+#include "QMLQualifiedExpression.h"
+#include "QMLArrayAccess.h"
+#include "QMLOnExpression.h"
+#include "QMLUnaryOperation.h"
+#include "QMLBinaryOperation.h"
+#include "QMLIf.h"
+#include "QMLFor.h"
+#include "QMLForIn.h"
+#include "QMLSwitch.h"
+#include "QMLConditional.h"
+#include "QMLComment.h"
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    \class QMLEntityFactory
+    \inmodule qt-plus
+    \brief A factory of QML entities.
+    Every entity that the parser can produce must be registered with this object, so that a serialized tree can be read back.
+    \sa QMLEntity
+    \sa QMLTreeCache
+*/
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Constructs a QMLEntityFactory. \br\br
+    Registers all entities.
+*/
+QMLEntityFactory::QMLEntityFactory()
+{
+    registerProduct(QMLEntity::staticMetaObject.className(), QMLEntity::instantiator);
+    registerProduct(QMLComplexEntity::staticMetaObject.className(), QMLComplexEntity::instantiator);
+    registerProduct(QMLNameValue::staticMetaObject.className(), QMLNameValue::instantiator);
+    registerProduct(QMLIdentifier::staticMetaObject.className(), QMLIdentifier::instantiator);
+    registerProduct(QMLType::staticMetaObject.className(), QMLType::instantiator);
+    registerProduct(QMLImport::staticMetaObject.className(), QMLImport::instantiator);
+    registerProduct(QMLPragma::staticMetaObject.className(), QMLPragma::instantiator);
+    registerProduct(QMLItem::staticMetaObject.className(), QMLItem::instantiator);
+    registerProduct(QMLSpecialValue::staticMetaObject.className(), QMLSpecialValue::instantiator);
+    registerProduct(QMLPropertyDeclaration::staticMetaObject.className(), QMLPropertyDeclaration::instantiator);
+    registerProduct(QMLPropertyAssignment::staticMetaObject.className(), QMLPropertyAssignment::instantiator);
+    registerProduct(QMLPropertyAlias::staticMetaObject.className(), QMLPropertyAlias::instantiator);
+    registerProduct(QMLFunction::staticMetaObject.className(), QMLFunction::instantiator);
+    registerProduct(QMLFunctionCall::staticMetaObject.className(), QMLFunctionCall::instantiator);
+    registerProduct(QMLFunctionParameter::staticMetaObject.className(), QMLFunctionParameter::instantiator);
+    registerProduct(QMLVariableDeclaration::staticMetaObject.className(), QMLVariableDeclaration::instantiator);
+    registerProduct(QMLQualifiedExpression::staticMetaObject.className(), QMLQualifiedExpression::instantiator);
+    registerProduct(QMLArrayAccess::staticMetaObject.className(), QMLArrayAccess::instantiator);
+    registerProduct(QMLOnExpression::staticMetaObject.className(), QMLOnExpression::instantiator);
+    registerProduct(QMLUnaryOperation::staticMetaObject.className(), QMLUnaryOperation::instantiator);
+    registerProduct(QMLBinaryOperation::staticMetaObject.className(), QMLBinaryOperation::instantiator);
+    registerProduct(QMLIf::staticMetaObject.className(), QMLIf::instantiator);
+    registerProduct(QMLFor::staticMetaObject.className(), QMLFor::instantiator);
+    registerProduct(QMLForIn::staticMetaObject.className(), QMLForIn::instantiator);
+    registerProduct(QMLSwitch::staticMetaObject.className(), QMLSwitch::instantiator);
+    registerProduct(QMLConditional::staticMetaObject.className(), QMLConditional::instantiator);
+    registerProduct(QMLComment::staticMetaObject.className(), QMLComment::instantiator);
+
+    // Keys of the map are sorted, so indices only change when the set of classes changes
+    m_lProductNames = s_vInstanciators.keys();
+
+    for (int iIndex = 0; iIndex < m_lProductNames.count(); iIndex++)
+    {
+        m_hProductIndices[m_lProductNames[iIndex]] = iIndex;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Destroys a QMLEntityFactory.
+*/
+QMLEntityFactory::~QMLEntityFactory()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the index of \a sClassName in \c productNames(), or -1 if the class is not registered.
+*/
+int QMLEntityFactory::productIndex(const QString& sClassName) const
+{
+    return m_hProductIndices.value(sClassName, -1);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the names of all registered classes.
+*/
+const QStringList& QMLEntityFactory::productNames() const
+{
+    return m_lProductNames;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Instantiates the class at \a iIndex in \c productNames(). Returns \c nullptr if \a iIndex is out of range.
+*/
+QMLEntity* QMLEntityFactory::instanciateProduct(int iIndex) const
+{
+    if (iIndex >= 0 && iIndex < m_lProductNames.count())
+    {
+        return CFactory<QMLEntity>::instanciateProduct(m_lProductNames[iIndex]);
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,66 @@
+
+#pragma once
+
+#include "../qtplus_global.h"
+
+//-------------------------------------------------------------------------------------------------
+
+// Qt
+#include <QString>
+#include <QStringList>
+#include <QHash>
+
+// Library
+#include "../CSingleton.h"
+#include "../CFactory.h"
+#include "QMLEntity.h"
+
+//-------------------------------------------------------------------------------------------------
+
+//! Defines a factory of QML entities, used when deserializing a QML tree
+class QTPLUSSHARED_EXPORT QMLEntityFactory : public CSingleton<QMLEntityFactory>, public CFactory<QMLEntity>
+{
+    friend class CSingleton<QMLEntityFactory>;
+
+public:
+
+    //-------------------------------------------------------------------------------------------------
+    // Getters
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the index of sClassName in productNames(), -1 if not registered
+    int productIndex(const QString& sClassName) const;
+
+    //! Returns the names of all registered classes, in a stable order
+    const QStringList& productNames() const;
+
+    //-------------------------------------------------------------------------------------------------
+    // Control methods
+    //-------------------------------------------------------------------------------------------------
+
+    using CFactory<QMLEntity>::instanciateProduct;
+
+    //! Instantiates a product given its index in productNames()
+    QMLEntity* instanciateProduct(int iIndex) const;
+
+    //-------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! Default constructor
+    QMLEntityFactory();
+
+    //! Destructor
+    virtual ~QMLEntityFactory();
+
+    //-------------------------------------------------------------------------------------------------
+    // Properties
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    QStringList         m_lProductNames;
+    QHash<QString, int> m_hProductIndices;
+};
@@ -1,6 +1,11 @@
 
+// Std
+#include <algorithm>
+
 // Qt
 #include <QDebug>
+#include <QFile>
+#include <QXmlStreamWriter>
 
 // Application
 #include "QMLFile.h"
@@ -13,7 +18,9 @@
 /*!
     \class QMLFile
     \inmodule qt-plus
-    \brief A QML file.
+    \brief A QML file. \br
+    The entities parsed from a file are allocated in its own QMLEntityArena, so deleting a file, for
+    instance to parse it again, gives back the memory of its whole tree.
 */
 
 //-------------------------------------------------------------------------------------------------
@@ -28,6 +35,8 @@ QMLFile::QMLFile(const QPoint& pPosition, QMLTreeContext* pContext, const QStrin
     , m_sFileName(sFileName)
     , m_bParsed(false)
     , m_bIsSingleton(false)
+    , m_bPositionIndexValid(false)
+    , m_bResolvingSymbols(false)
 {
     Q_UNUSED(pContext);
 }
@@ -41,6 +50,8 @@ QMLFile::QMLFile(const QMLFile& target)
     : QMLComplexEntity(target.position())
     , m_bParsed(false)
     , m_bIsSingleton(false)
+    , m_bPositionIndexValid(false)
+    , m_bResolvingSymbols(false)
 {
 }
 
@@ -55,6 +66,51 @@ QMLFile::~QMLFile()
     {
         delete pComment;
     }
+
+    m_vComments.clear();
+
+    // The tree must be gone before the arena holding it, which is destroyed before the base classes
+    for (QMLEntity* pEntity : m_vContents)
+    {
+        if (pEntity != nullptr)
+        {
+            delete pEntity;
+        }
+    }
+
+    m_vContents.clear();
+
+    if (m_pName != nullptr)
+    {
+        delete m_pName;
+        m_pName = nullptr;
+    }
+
+    while (children().isEmpty() == false)
+    {
+        delete children().first();
+    }
+
+#ifdef TRACK_ENTITIES
+
+    // Whatever is still alive in the arena was never deleted by the tree
+    for (QMLEntity* pEntity : m_tArena.liveEntities())
+    {
+        qWarning() << QString("Leaked entity : ") + QString::number((qint64)pEntity) + " < " + pEntity->metaObject()->className() + " > " + " ( " + pEntity->toString() + " )";
+    }
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Allocates \a iSize bytes for a file on the heap. A file owns the arena of its entities, it cannot live in one.
+*/
+void* QMLFile::operator new(size_t iSize)
+{
+    QMLEntityArena::Scope tHeapScope(nullptr);
+
+    return QMLEntityArena::allocate(iSize);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -109,18 +165,54 @@ bool QMLFile::isSingleton() const
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Returns the arena holding the entities of the file.
+*/
+QMLEntityArena& QMLFile::arena()
+{
+    return m_tArena;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the arena holding the entities of the file.
+*/
+const QMLEntityArena& QMLFile::arena() const
+{
+    return m_tArena;
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Inserts comments stored in m_vComments where they should reside in the entity tree.
 */
 void QMLFile::solveComments()
 {
+    // Comments are inserted in the tree but not indexed : the index stays valid during the whole pass
+    updatePositionIndex();
+
+    int iPreviousLine = 0;
+    int iPreviousIndex = 0;
+
     for (int index = 0; index < m_vComments.count(); index++)
     {
         QMLComment* pComment = m_vComments[index];
 
+        // Comments come in file order : each search starts where the previous one ended
+        int iLine = pComment->position().y();
+        int iTargetIndex = treeOrderIndexAtOrAfterLine(iLine, iLine >= iPreviousLine ? iPreviousIndex : 0);
+
+        if (iTargetIndex >= 0)
+        {
+            iPreviousLine = iLine;
+            iPreviousIndex = iTargetIndex;
+        }
+
         if (pComment->type() == QMLComment::ctMultiLine || pComment->type() == QMLComment::ctMultiLineDoc)
         {
-            QMLEntity* pTarget = locateEntityAtOrAfterLine(pComment->position());
+            QMLEntity* pTarget = iTargetIndex < 0 ? nullptr : m_vTreeOrder[iTargetIndex];
 
             if (pTarget != nullptr)
             {
@@ -170,7 +262,7 @@ void QMLFile::solveComments()
         }
         else
         {
-            QMLEntity* pTarget = locateEntityAtOrAfterLine(pComment->position());
+            QMLEntity* pTarget = iTargetIndex < 0 ? nullptr : m_vTreeOrder[iTargetIndex];
 
             if (pTarget != nullptr)
             {
@@ -224,63 +316,161 @@ void QMLFile::solveComments()
 //-------------------------------------------------------------------------------------------------
 
 /*!
-    Locates an entity at a line specified by \a pPosition (the y component).
+    Locates an entity at a line specified by \a pPosition (the y component). \br\br
+    Returns the first entity, in tree order, that starts at or after the line. Comments are ignored.
 */
 QMLEntity* QMLFile::locateEntityAtOrAfterLine(const QPoint& pPosition)
 {
-    return locateEntityAtOrAfterLine_Recurse(this, pPosition);
+    updatePositionIndex();
+
+    int iIndex = treeOrderIndexAtOrAfterLine(pPosition.y(), 0);
+
+    return iIndex < 0 ? nullptr : m_vTreeOrder[iIndex];
 }
 
 //-------------------------------------------------------------------------------------------------
 
 /*!
-    Recursive part of locateEntityAtOrAfterLine. \br\br
-    \a pEntity is the current entity to process. \br
-    \a pPosition is the line to check (the y component).
+    Builds the position index of the file. \br\br
+    Entities are listed in tree order along with the highest line reached so far, which lets
+    locateEntityAtOrAfterLine() use a binary search, and sorted by position for entityAt(). \br
+    Queries build the index when first needed, there is no need to call this before them.
 */
-QMLEntity* QMLFile::locateEntityAtOrAfterLine_Recurse(QMLEntity* pEntity, const QPoint& pPosition)
+void QMLFile::buildPositionIndex()
 {
-    // Continue only if the current entity is not a comment
-    if (QMLEntity::isComment(pEntity) == false)
+    m_bPositionIndexValid = true;
+
+    m_vTreeOrder.clear();
+    m_vTreeOrderReach.clear();
+
+    buildPositionIndex_Recurse(this);
+
+    m_vPositionIndex = m_vTreeOrder;
+
+    std::stable_sort(m_vPositionIndex.begin(), m_vPositionIndex.end(), [](const QMLEntity* pEntity1, const QMLEntity* pEntity2)
     {
-        // If the line of the current entity is greater or equal to the specified line, return the current entity.
-        if (pEntity->position().y() >= pPosition.y())
-        {
-            return pEntity;
-        }
+        if (pEntity1->position().y() != pEntity2->position().y())
+            return pEntity1->position().y() < pEntity2->position().y();
 
-        // Look in the members of the current entity, if any
-        QMap<QString, QMLEntity*> mMembers = pEntity->members();
+        return pEntity1->position().x() < pEntity2->position().x();
+    });
+}
 
-        for (QString sMemberKey : mMembers.keys())
-        {
-            QMLEntity* pChildEntity = mMembers[sMemberKey];
+//-------------------------------------------------------------------------------------------------
 
-            if (pChildEntity != nullptr)
-            {
-                QMLEntity* pFoundEntity = locateEntityAtOrAfterLine_Recurse(pChildEntity, pPosition);
+/*!
+    Drops the position index, which holds pointers to the entities of the tree. \br\br
+    sortContents() and removeUnreferencedSymbols() call it. Code changing the tree through contents() must call it too.
+*/
+void QMLFile::invalidatePositionIndex()
+{
+    m_bPositionIndexValid = false;
+    m_vTreeOrder.clear();
+    m_vTreeOrderReach.clear();
+    m_vPositionIndex.clear();
+}
 
-                if (pFoundEntity != nullptr)
-                    return pFoundEntity;
-            }
-        }
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Builds the position index if it is not valid.
+*/
+void QMLFile::updatePositionIndex()
+{
+    if (m_bPositionIndexValid == false)
+    {
+        buildPositionIndex();
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns all entities of the file except comments, sorted by start position.
+*/
+const QVector<QMLEntity*>& QMLFile::positionIndex()
+{
+    updatePositionIndex();
+
+    return m_vPositionIndex;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the entity starting last at or before \a pPosition (x = column, y = line), \c nullptr if none. \br\br
+    Among entities starting at the same position, the innermost one is returned.
+*/
+QMLEntity* QMLFile::entityAt(const QPoint& pPosition)
+{
+    updatePositionIndex();
+
+    QVector<QMLEntity*>::const_iterator iter = std::upper_bound(m_vPositionIndex.constBegin(), m_vPositionIndex.constEnd(), pPosition, [](const QPoint& pTarget, const QMLEntity* pEntity)
+    {
+        if (pTarget.y() != pEntity->position().y())
+            return pTarget.y() < pEntity->position().y();
+
+        return pTarget.x() < pEntity->position().x();
+    });
+
+    if (iter == m_vPositionIndex.constBegin())
+        return nullptr;
+
+    return *(iter - 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Recursive part of buildPositionIndex. \br\br
+    \a pEntity is the current entity to process : itself, its members and its contents are added in that order.
+*/
+void QMLFile::buildPositionIndex_Recurse(QMLEntity* pEntity)
+{
+    // Comments are not indexed
+    if (QMLEntity::isComment(pEntity) == false)
+    {
+        int iReach = pEntity->position().y();
+
+        if (m_vTreeOrderReach.isEmpty() == false)
+            iReach = qMax(iReach, m_vTreeOrderReach.last());
+
+        m_vTreeOrder << pEntity;
+        m_vTreeOrderReach << iReach;
+
+        pEntity->forEachMember([this](QMLEntity* pChildEntity)
+        {
+            buildPositionIndex_Recurse(pChildEntity);
+        });
 
-        // Look in the children of the current entity, if it is a QMLComplexEntity
         QMLComplexEntity* pComplex = dynamic_cast<QMLComplexEntity*>(pEntity);
 
         if (pComplex != nullptr)
         {
             for (QMLEntity* pChildEntity : pComplex->contents())
             {
-                QMLEntity* pFoundEntity = locateEntityAtOrAfterLine_Recurse(pChildEntity, pPosition);
-
-                if (pFoundEntity != nullptr)
-                    return pFoundEntity;
+                if (pChildEntity != nullptr)
+                    buildPositionIndex_Recurse(pChildEntity);
             }
         }
     }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the index in tree order of the first entity starting at or after \a iLine, or -1. \br\br
+    The search starts at \a iFrom, which must not be after the result.
+*/
+int QMLFile::treeOrderIndexAtOrAfterLine(int iLine, int iFrom) const
+{
+    // The first entity reaching the line is the first one starting at or after it
+    QVector<int>::const_iterator iter = std::lower_bound(m_vTreeOrderReach.constBegin() + iFrom, m_vTreeOrderReach.constEnd(), iLine);
 
-    return nullptr;
+    if (iter == m_vTreeOrderReach.constEnd())
+        return -1;
+
+    return int(iter - m_vTreeOrderReach.constBegin());
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -291,8 +481,15 @@ QMLEntity* QMLFile::locateEntityAtOrAfterLine_Recurse(QMLEntity* pEntity, const
 */
 void QMLFile::solveReferences(QMLTreeContext* pContext)
 {
+    // Symbol tables do not change while references are solved : lookups can be memorized
+    m_hResolvedSymbols.clear();
+    m_bResolvingSymbols = true;
+
     QMLComplexEntity::solveReferences(pContext);
 
+    m_bResolvingSymbols = false;
+    m_hResolvedSymbols.clear();
+
     for (QMLEntity* pEntity : m_vContents)
     {
         QMLPragma* pPragma = dynamic_cast<QMLPragma*>(pEntity);
@@ -323,27 +520,69 @@ void QMLFile::solveReferences(QMLTreeContext* pContext)
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Sorts the contents of the file. Entities keep their positions but not their order : the position index is invalidated.
+*/
+void QMLFile::sortContents()
+{
+    QMLComplexEntity::sortContents();
+
+    invalidatePositionIndex();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Removes all unreferenced declarations in the file. \br\br
+    \a pContext is the context of this file. Removed entities are deleted : the position index is invalidated.
+*/
+void QMLFile::removeUnreferencedSymbols(QMLTreeContext* pContext)
+{
+    QMLComplexEntity::removeUnreferencedSymbols(pContext);
+
+    invalidatePositionIndex();
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Returns the item named \a sName, for identifier resolution. \br\br
 */
 QMLEntity* QMLFile::findSymbolDeclaration(const QString& sName)
 {
+    // Names not declared in an enclosing scope all end up here : avoid walking the whole file for each
+    if (m_bResolvingSymbols)
+    {
+        QHash<QString, QMLEntity*>::const_iterator iter = m_hResolvedSymbols.constFind(sName);
+
+        if (iter != m_hResolvedSymbols.constEnd())
+        {
+            return iter.value();
+        }
+    }
+
     QStringList sQualified = QMLEntity::qualifiedNameAsList(sName);
+    QMLEntity* pFoundEntity = nullptr;
 
     for (QMLEntity* pEntity : m_vContents)
     {
         if (pEntity != nullptr)
         {
-            QMLEntity* pFoundEntity = pEntity->findSymbolDeclarationDescending(sQualified);
+            pFoundEntity = pEntity->findSymbolDeclarationDescending(sQualified);
 
             if (pFoundEntity != nullptr)
             {
-                return pFoundEntity;
+                break;
             }
         }
     }
 
-    return nullptr;
+    if (m_bResolvingSymbols)
+    {
+        m_hResolvedSymbols.insert(sName, pFoundEntity);
+    }
+
+    return pFoundEntity;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -364,23 +603,94 @@ void QMLFile::toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntit
 
 //-------------------------------------------------------------------------------------------------
 
+void QMLFile::writeXMLAttributes(QMLXMLWriter& tWriter)
+{
+    QMLComplexEntity::writeXMLAttributes(tWriter);
+
+    tWriter.setAttribute("FileName", m_sFileName);
+    tWriter.setAttribute("Parsed", m_bParsed ? "true" : "false");
+
+    if (m_bIsSingleton)
+        tWriter.setAttribute("Singleton", "true");
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLFile::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
+{
+    QMLComplexEntity::writeXMLChildren(tWriter, pContext);
+
+    for (QMLComment* pComment : m_vComments)
+        pComment->writeXML(tWriter, pContext);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
-    Returns a CXMLNode representation of this item. \br\br
-    \a pContext is a user defined context. \br
-    \a pParent is the caller of this method.
+    Writes the XML representation of the file to \a sFileName, as CXMLNode::saveXMLToFile() would for toXMLNode(),
+    but without building the node tree first. \br\br
+    \a pContext is a user defined context. Returns \c false if the file cannot be written.
 */
-CXMLNode QMLFile::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+bool QMLFile::saveXMLToFile(const QString& sFileName, CXMLNodableContext* pContext)
 {
-    CXMLNode xNode = QMLComplexEntity::toXMLNode(pContext, pParent);
+    QFile xmlFile(sFileName);
 
-    xNode.attributes()["FileName"] = m_sFileName;
-    xNode.attributes()["Parsed"] = m_bParsed ? "true" : "false";
+    if (xmlFile.open(QIODevice::WriteOnly) == false)
+        return false;
 
-    if (m_bIsSingleton)
-        xNode.attributes()["Singleton"] = "true";
+    QXmlStreamWriter xStream(&xmlFile);
+    xStream.setAutoFormatting(true);
+    xStream.setAutoFormattingIndent(1);
+
+    xStream.writeStartDocument();
+    toXMLStream(xStream, pContext);
+    xStream.writeEndDocument();
+
+    xmlFile.close();
+
+    return xStream.hasError() == false;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Writes the parsed contents and comments of the file to \a stream. \br\br
+    \a pTracker is passed to child entities.
+*/
+void QMLFile::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLComplexEntity::serialize(stream, pTracker);
+
+    stream << qint32(m_vComments.count());
 
     for (QMLComment* pComment : m_vComments)
-        xNode << pComment->toXMLNode(pContext, this);
+    {
+        serializeEntity(stream, pTracker, pComment);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
 
-    return xNode;
+/*!
+    Reads the parsed contents and comments of the file from \a stream. \br\br
+    \a pTracker is passed to child entities. \br
+    \a pRootObject is the QMLTreeContext that reads the tree.
+*/
+void QMLFile::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLComplexEntity::deserialize(stream, pTracker, pRootObject);
+
+    qint32 iCount = 0;
+
+    stream >> iCount;
+
+    for (qint32 iIndex = 0; iIndex < iCount && stream.status() == QDataStream::Ok; iIndex++)
+    {
+        QMLComment* pComment = deserializeEntityAs<QMLComment>(stream, pTracker, pRootObject);
+
+        if (pComment != nullptr)
+        {
+            m_vComments << pComment;
+        }
+    }
 }
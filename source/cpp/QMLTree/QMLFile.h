@@ -9,10 +9,12 @@
 #include <QObject>
 #include <QVariant>
 #include <QTextStream>
+#include <QHash>
 
 // Library
 #include "QMLComplexEntity.h"
 #include "QMLComment.h"
+#include "QMLEntityArena.h"
 
 //-------------------------------------------------------------------------------------------------
 // Forward declarations
@@ -38,9 +40,12 @@ public:
     //! Copy constructor
     QMLFile(const QMLFile& target);
 
-    //! Destructor
+    //! Destructor, deletes the tree and then frees the arena holding it
     virtual ~QMLFile();
 
+    //! Allocates a file on the heap, never in an arena
+    static void* operator new(size_t iSize);
+
     //-------------------------------------------------------------------------------------------------
     // Setters
     //-------------------------------------------------------------------------------------------------
@@ -64,6 +69,12 @@ public:
     //!
     bool isSingleton() const;
 
+    //! Returns the arena holding the entities of the file
+    QMLEntityArena& arena();
+
+    //! Returns the arena holding the entities of the file
+    const QMLEntityArena& arena() const;
+
     //-------------------------------------------------------------------------------------------------
     // Control methods
     //-------------------------------------------------------------------------------------------------
@@ -74,23 +85,54 @@ public:
     //!
     QMLEntity* locateEntityAtOrAfterLine(const QPoint& pPosition);
 
+    //! Builds the position index now, it is otherwise built when first needed
+    void buildPositionIndex();
+
+    //! Drops the position index, to call when the tree is modified through contents()
+    void invalidatePositionIndex();
+
+    //! Returns all entities but comments, sorted by start position (line, then column)
+    const QVector<QMLEntity*>& positionIndex();
+
+    //! Returns the last entity of the position index starting at or before pPosition
+    QMLEntity* entityAt(const QPoint& pPosition);
+
     //-------------------------------------------------------------------------------------------------
     // Protected control methods
     //-------------------------------------------------------------------------------------------------
 
 protected:
 
-    QMLEntity* locateEntityAtOrAfterLine_Recurse(QMLEntity* pEntity, const QPoint& pPosition);
+    //! Builds the position index if it was invalidated
+    void updatePositionIndex();
+
+    //!
+    void buildPositionIndex_Recurse(QMLEntity* pEntity);
+
+    //! Returns the index in tree order of the first entity at or after iLine, searching from iFrom, -1 if none
+    int treeOrderIndexAtOrAfterLine(int iLine, int iFrom) const;
 
     //-------------------------------------------------------------------------------------------------
     // Overridden methods
     //-------------------------------------------------------------------------------------------------
 
+    //!
+    virtual void serialize(QDataStream& stream, CObjectTracker* pTracker) const Q_DECL_OVERRIDE;
+
+    //!
+    virtual void deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject) Q_DECL_OVERRIDE;
+
 public:
 
     //!
     virtual void solveReferences(QMLTreeContext* pContext) Q_DECL_OVERRIDE;
 
+    //! Sorts the contents and invalidates the position index
+    virtual void sortContents() Q_DECL_OVERRIDE;
+
+    //! Removes unreferenced declarations and invalidates the position index
+    virtual void removeUnreferencedSymbols(QMLTreeContext* pContext) Q_DECL_OVERRIDE;
+
     //!
     virtual QMLEntity* findSymbolDeclaration(const QString& sName);
 
@@ -98,7 +140,13 @@ public:
     virtual void toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntity* pParent = nullptr) const Q_DECL_OVERRIDE;
 
     //!
-    virtual CXMLNode toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent) Q_DECL_OVERRIDE;
+    virtual void writeXMLAttributes(QMLXMLWriter& tWriter) Q_DECL_OVERRIDE;
+
+    //!
+    virtual void writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext) Q_DECL_OVERRIDE;
+
+    //! Streams the XML representation of the file to sFileName, returns false if the file cannot be written
+    bool saveXMLToFile(const QString& sFileName, CXMLNodableContext* pContext = nullptr);
 
     //-------------------------------------------------------------------------------------------------
     // Properties
@@ -110,4 +158,15 @@ protected:
     QVector<QMLComment*>    m_vComments;
     bool                    m_bParsed;
     bool                    m_bIsSingleton;
+    QMLEntityArena          m_tArena;                   // Holds the entities of the file, freed with it
+
+    // Position index
+    bool                    m_bPositionIndexValid;
+    QVector<QMLEntity*>     m_vTreeOrder;               // Entities but comments, in tree order
+    QVector<int>            m_vTreeOrderReach;          // Highest line found up to each entity of m_vTreeOrder
+    QVector<QMLEntity*>     m_vPositionIndex;           // Entities of m_vTreeOrder sorted by position
+
+    // Lookups that reached the file, kept during solveReferences() only
+    QHash<QString, QMLEntity*>  m_hResolvedSymbols;
+    bool                        m_bResolvingSymbols;
 };
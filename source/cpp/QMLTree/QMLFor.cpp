@@ -5,6 +5,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLFor::instantiator()
+{
+    return new QMLFor(QPoint(), nullptr, nullptr, nullptr, nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLFor::QMLFor(const QPoint& pPosition, QMLEntity* pInitialization, QMLEntity* pCondition, QMLEntity* pIncrementation, QMLEntity* pContent)
     : QMLEntity(pPosition)
     , m_pInitialization(pInitialization)
@@ -66,16 +73,12 @@ QMLEntity* QMLFor::content() const
 
 //-------------------------------------------------------------------------------------------------
 
-QMap<QString, QMLEntity*> QMLFor::members()
+void QMLFor::visitMembers(QMLMemberVisitor& tVisitor)
 {
-    QMap<QString, QMLEntity*> vReturnValue;
-
-    vReturnValue["initialization"] = m_pInitialization;
-    vReturnValue["condition"] = m_pCondition;
-    vReturnValue["incrementation"] = m_pIncrementation;
-    vReturnValue["content"] = m_pContent;
-
-    return vReturnValue;
+    tVisitor.visit("condition", m_pCondition);
+    tVisitor.visit("content", m_pContent);
+    tVisitor.visit("incrementation", m_pIncrementation);
+    tVisitor.visit("initialization", m_pInitialization);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -153,30 +156,36 @@ void QMLFor::toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntity
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLFor::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLFor::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
-    CXMLNode xInitialization("Initialization");
-    CXMLNode xCondition("Condition");
-    CXMLNode xIncrementation("Incrementation");
-    CXMLNode xContent("Content");
+    writeXMLMember(tWriter, pContext, "Initialization", m_pInitialization);
+    writeXMLMember(tWriter, pContext, "Condition", m_pCondition);
+    writeXMLMember(tWriter, pContext, "Incrementation", m_pIncrementation);
+    writeXMLMember(tWriter, pContext, "Content", m_pContent);
+}
 
-    if (m_pInitialization != nullptr)
-        xInitialization.nodes() << m_pInitialization->toXMLNode(pContext, this);
+//-------------------------------------------------------------------------------------------------
 
-    if (m_pCondition != nullptr)
-        xCondition.nodes() << m_pCondition->toXMLNode(pContext, this);
+void QMLFor::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLEntity::serialize(stream, pTracker);
 
-    if (m_pIncrementation != nullptr)
-        xIncrementation.nodes() << m_pIncrementation->toXMLNode(pContext, this);
+    serializeEntity(stream, pTracker, m_pInitialization);
+    serializeEntity(stream, pTracker, m_pCondition);
+    serializeEntity(stream, pTracker, m_pIncrementation);
+    serializeEntity(stream, pTracker, m_pContent);
+    stream << m_bIsWhile;
+}
 
-    if (m_pContent != nullptr)
-        xContent.nodes() << m_pContent->toXMLNode(pContext, this);
+//-------------------------------------------------------------------------------------------------
 
-    xNode.nodes() << xInitialization;
-    xNode.nodes() << xCondition;
-    xNode.nodes() << xIncrementation;
-    xNode.nodes() << xContent;
+void QMLFor::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
 
-    return xNode;
+    m_pInitialization = deserializeEntity(stream, pTracker, pRootObject);
+    m_pCondition = deserializeEntity(stream, pTracker, pRootObject);
+    m_pIncrementation = deserializeEntity(stream, pTracker, pRootObject);
+    m_pContent = deserializeEntity(stream, pTracker, pRootObject);
+    stream >> m_bIsWhile;
 }
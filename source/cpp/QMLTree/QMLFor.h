@@ -24,6 +24,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLFor
+    static QMLEntity* instantiator();
+
     //! Constructor with condition, then and else
     QMLFor(const QPoint& pPosition, QMLEntity* pInitialization, QMLEntity* pCondition, QMLEntity* pIncrementation, QMLEntity* pContent);
 
@@ -53,18 +56,24 @@ public:
     //!
     QMLEntity* content() const;
 
-    //! Returns all members
-    virtual QMap<QString, QMLEntity*> members() Q_DECL_OVERRIDE;
+    //! Calls tVisitor for each member
+    virtual void visitMembers(QMLMemberVisitor& tVisitor) Q_DECL_OVERRIDE;
 
     //-------------------------------------------------------------------------------------------------
     // Overridden methods
     //-------------------------------------------------------------------------------------------------
 
+    //!
+    virtual void serialize(QDataStream& stream, CObjectTracker* pTracker) const Q_DECL_OVERRIDE;
+
+    //!
+    virtual void deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject) Q_DECL_OVERRIDE;
+
     //!
     virtual void toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntity* pParent = nullptr) const Q_DECL_OVERRIDE;
 
     //!
-    virtual CXMLNode toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent) Q_DECL_OVERRIDE;
+    virtual void writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext) Q_DECL_OVERRIDE;
 
     //-------------------------------------------------------------------------------------------------
     // Properties
@@ -5,6 +5,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLForIn::instantiator()
+{
+    return new QMLForIn(QPoint(), nullptr, nullptr, nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLForIn::QMLForIn(const QPoint& pPosition, QMLEntity* pVariable, QMLEntity* pExpression, QMLEntity* pContent)
     : QMLEntity(pPosition)
     , m_pVariable(pVariable)
@@ -51,15 +58,11 @@ QMLEntity* QMLForIn::content() const
 
 //-------------------------------------------------------------------------------------------------
 
-QMap<QString, QMLEntity*> QMLForIn::members()
+void QMLForIn::visitMembers(QMLMemberVisitor& tVisitor)
 {
-    QMap<QString, QMLEntity*> vReturnValue;
-
-    vReturnValue["variable"] = m_pVariable;
-    vReturnValue["expression"] = m_pExpression;
-    vReturnValue["content"] = m_pContent;
-
-    return vReturnValue;
+    tVisitor.visit("content", m_pContent);
+    tVisitor.visit("expression", m_pExpression);
+    tVisitor.visit("variable", m_pVariable);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -98,25 +101,35 @@ void QMLForIn::toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEnti
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLForIn::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLForIn::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
-    CXMLNode xVariable("Variable");
-    CXMLNode xExpression("Expression");
-    CXMLNode xContent("Content");
+    writeXMLMember(tWriter, pContext, "Variable", m_pVariable);
+    writeXMLMember(tWriter, pContext, "Expression", m_pExpression);
+    writeXMLMember(tWriter, pContext, "Content", m_pContent);
+}
 
-    if (m_pVariable != nullptr)
-        xVariable.nodes() << m_pVariable->toXMLNode(pContext, this);
+//-------------------------------------------------------------------------------------------------
 
-    if (m_pExpression != nullptr)
-        xExpression.nodes() << m_pExpression->toXMLNode(pContext, this);
+void QMLForIn::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLEntity::serialize(stream, pTracker);
 
-    if (m_pContent != nullptr)
-        xContent.nodes() << m_pContent->toXMLNode(pContext, this);
+    serializeEntity(stream, pTracker, m_pVariable);
+    serializeEntity(stream, pTracker, m_pExpression);
+    serializeEntity(stream, pTracker, m_pContent);
+}
+
+//-------------------------------------------------------------------------------------------------
 
-    xNode.nodes() << xVariable;
-    xNode.nodes() << xExpression;
-    xNode.nodes() << xContent;
+void QMLForIn::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
+
+    m_pVariable = deserializeEntity(stream, pTracker, pRootObject);
+    m_pExpression = deserializeEntity(stream, pTracker, pRootObject);
+    m_pContent = deserializeEntity(stream, pTracker, pRootObject);
 
-    return xNode;
+    if (m_pVariable != nullptr) m_pVariable->setParent(this);
+    if (m_pExpression != nullptr) m_pExpression->setParent(this);
+    if (m_pContent != nullptr) m_pContent->setParent(this);
 }
@@ -10,6 +10,7 @@
 
 QMLFormatter::QMLFormatter()
     : m_iIndentation(0)
+    , m_bFragmentsCompiled(false)
 {
 }
 
@@ -21,6 +22,16 @@ QMLFormatter::~QMLFormatter()
 
 //-------------------------------------------------------------------------------------------------
 
+void QMLFormatter::setGrammar(const CXMLNode& xGrammar)
+{
+    CMacroable::setGrammar(xGrammar);
+
+    // Compiled when first used
+    m_bFragmentsCompiled = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+
 void QMLFormatter::incIndentation()
 {
     m_iIndentation++;
@@ -40,12 +51,7 @@ void QMLFormatter::decIndentation()
 
 void QMLFormatter::writeNewLine(QTextStream& stream)
 {
-    stream << "\r\n";
-
-    for (int i = 0; i < m_iIndentation * 4; i++)
-    {
-        stream << " ";
-    }
+    stream << newLine();
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -60,41 +66,116 @@ void QMLFormatter::writeDoubleNewLine(QTextStream& stream)
 
 void QMLFormatter::processFragment(QTextStream& stream, EQMLFormatterFragment fragment)
 {
+    if (m_bFragmentsCompiled == false)
+        compileFragments();
+
+    if (int(fragment) < 0 || int(fragment) >= m_vFragmentActions.count())
+        return;
+
+    const QVector<EQMLFormatterAction>& vActions = m_vFragmentActions[fragment];
+
+    if (vActions.isEmpty())
+        return;
+
+    // The fragment's text is gathered and written to the stream at once
+    m_sBuffer.clear();
+
+    for (EQMLFormatterAction eAction : vActions)
+    {
+        switch (eAction)
+        {
+            case qfaNewLine:
+                m_sBuffer += newLine();
+                break;
+
+            case qfaDoubleNewLine:
+                m_sBuffer += "\r\n";
+                m_sBuffer += newLine();
+                break;
+
+            case qfaIndentationIncrement:
+                incIndentation();
+                break;
+
+            case qfaIndentationDecrement:
+                decIndentation();
+                break;
+        }
+    }
+
+    if (m_sBuffer.isEmpty() == false)
+        stream << m_sBuffer;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLFormatter::compileFragments()
+{
+    m_bFragmentsCompiled = true;
+    m_vFragmentActions.clear();
+
+    // Without a format definition no fragment has actions : processFragment() has nothing to look up
+    if (m_xGrammar.isEmpty())
+        return;
+
     QMetaEnum fragmentEnum = QMetaEnum::fromType<EQMLFormatterFragment>();
-    QString sFragment = QString(fragmentEnum.valueToKey(fragment)).remove("qff");
+
+    m_vFragmentActions.resize(fragmentEnum.keyCount());
 
     CXMLNodeList vFragments = m_xGrammar.getNodesByTagName(FORMATTER_TOKEN_FRAGMENT);
 
+    // Fragments matching several definitions get their actions in definition order
     for (CXMLNode xFragment : vFragments)
     {
         QString sNames = processMacros(xFragment.attributes()[FORMATTER_TOKEN_NAMES]);
         QStringList lNames = sNames.split(",");
 
-        if (lNames.contains(sFragment))
+        QVector<EQMLFormatterAction> vActions;
+        CXMLNodeList vXMLActions = xFragment.getNodesByTagName(FORMATTER_TOKEN_ACTION);
+
+        for (CXMLNode xAction : vXMLActions)
+        {
+            QString sType = processMacros(xAction.attributes()[FORMATTER_TOKEN_TYPE]);
+
+            if (sType == FORMATTER_ACTION_NEW_LINE)
+            {
+                vActions << qfaNewLine;
+            }
+            else if (sType == FORMATTER_ACTION_DOUBLE_NEW_LINE)
+            {
+                vActions << qfaDoubleNewLine;
+            }
+            else if (sType == FORMATTER_ACTION_INDENTATION_INC)
+            {
+                vActions << qfaIndentationIncrement;
+            }
+            else if (sType == FORMATTER_ACTION_INDENTATION_DEC)
+            {
+                vActions << qfaIndentationDecrement;
+            }
+        }
+
+        for (int iIndex = 0; iIndex < fragmentEnum.keyCount(); iIndex++)
         {
-            CXMLNodeList vActions = xFragment.getNodesByTagName(FORMATTER_TOKEN_ACTION);
+            int iFragment = fragmentEnum.value(iIndex);
+            QString sFragment = QString(fragmentEnum.key(iIndex)).remove("qff");
 
-            for (CXMLNode xAction : vActions)
+            if (iFragment >= 0 && iFragment < m_vFragmentActions.count() && lNames.contains(sFragment))
             {
-                QString sType = processMacros(xAction.attributes()[FORMATTER_TOKEN_TYPE]);
-
-                if (sType == FORMATTER_ACTION_NEW_LINE)
-                {
-                    writeNewLine(stream);
-                }
-                else if (sType == FORMATTER_ACTION_DOUBLE_NEW_LINE)
-                {
-                    writeDoubleNewLine(stream);
-                }
-                else if (sType == FORMATTER_ACTION_INDENTATION_INC)
-                {
-                    incIndentation();
-                }
-                else if (sType == FORMATTER_ACTION_INDENTATION_DEC)
-                {
-                    decIndentation();
-                }
+                m_vFragmentActions[iFragment] << vActions;
             }
         }
     }
 }
+
+//-------------------------------------------------------------------------------------------------
+
+const QString& QMLFormatter::newLine()
+{
+    while (m_vNewLines.count() <= m_iIndentation)
+    {
+        m_vNewLines << QString("\r\n") + QString(m_vNewLines.count() * 4, ' ');
+    }
+
+    return m_vNewLines[m_iIndentation];
+}
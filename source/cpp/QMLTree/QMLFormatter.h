@@ -7,6 +7,7 @@
 
 // Qt
 #include <QString>
+#include <QVector>
 #include <QTextStream>
 
 // Foundations
@@ -80,6 +81,13 @@ public:
 
     Q_ENUM(EQMLFormatterFragment);
 
+    enum EQMLFormatterAction {
+        qfaNewLine,
+        qfaDoubleNewLine,
+        qfaIndentationIncrement,
+        qfaIndentationDecrement
+    };
+
     //-------------------------------------------------------------------------------------------------
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
@@ -94,6 +102,9 @@ public:
     // Setters
     //-------------------------------------------------------------------------------------------------
 
+    //! Sets the format definition, its fragments are compiled when first used
+    virtual void setGrammar(const CXMLNode& xGrammar) Q_DECL_OVERRIDE;
+
     //-------------------------------------------------------------------------------------------------
     // Getters
     //-------------------------------------------------------------------------------------------------
@@ -115,7 +126,19 @@ public:
     void writeDoubleNewLine(QTextStream& stream);
 
     //! Processes a fragment of code text
-    void processFragment(QTextStream& stream, EQMLFormatterFragment fragment);
+    virtual void processFragment(QTextStream& stream, EQMLFormatterFragment fragment);
+
+    //-------------------------------------------------------------------------------------------------
+    // Protected control methods
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! Builds the action list of each fragment from the format definition
+    void compileFragments();
+
+    //! Returns a new line followed by the current indentation
+    const QString& newLine();
 
     //-------------------------------------------------------------------------------------------------
     // Properties
@@ -123,5 +146,9 @@ public:
 
 protected:
 
-    int m_iIndentation;
+    int                                         m_iIndentation;
+    QVector<QVector<EQMLFormatterAction> >      m_vFragmentActions;     // Actions of each fragment, indexed by EQMLFormatterFragment
+    bool                                        m_bFragmentsCompiled;   // m_vFragmentActions matches the format definition
+    QVector<QString>                            m_vNewLines;            // New line and indentation, indexed by indentation level
+    QString                                     m_sBuffer;              // Text of the fragment being processed
 };
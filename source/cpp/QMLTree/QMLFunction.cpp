@@ -9,6 +9,32 @@
 
 //-------------------------------------------------------------------------------------------------
 
+//! Returns mSymbols as a hash, for lookups during symbol resolution
+static QHash<QString, QMLEntity*> symbolTable(const QMap<QString, QMLEntity*>& mSymbols)
+{
+    QHash<QString, QMLEntity*> hTable;
+    hTable.reserve(mSymbols.count());
+
+    for (QMap<QString, QMLEntity*>::const_iterator iter = mSymbols.constBegin(); iter != mSymbols.constEnd(); ++iter)
+    {
+        hTable.insert(iter.key(), iter.value());
+    }
+
+    return hTable;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Instantiates a new QMLFunction.
+*/
+QMLEntity* QMLFunction::instantiator()
+{
+    return new QMLFunction(QPoint(), nullptr, nullptr, nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLFunction::QMLFunction(const QPoint& pPosition, QMLEntity* pName, QMLEntity* pParameters, QMLEntity* pContent)
     : QMLEntity(pPosition)
     , m_pName(pName)
@@ -71,11 +97,11 @@ QMap<QString, QMLEntity*> QMLFunction::unusedParameters()
 {
     QMap<QString, QMLEntity*> mReturnValue;
 
-    for (QString sKey : m_mParameterList.keys())
+    for (QHash<QString, QMLEntity*>::const_iterator iter = m_hParameterList.constBegin(); iter != m_hParameterList.constEnd(); ++iter)
     {
-        if (m_mParameterList[sKey]->usageCount() == 0)
+        if (iter.value()->usageCount() == 0)
         {
-            mReturnValue[sKey] = m_mParameterList[sKey];
+            mReturnValue[iter.key()] = iter.value();
         }
     }
 
@@ -88,11 +114,11 @@ QMap<QString, QMLEntity*> QMLFunction::unusedVariables()
 {
     QMap<QString, QMLEntity*> mReturnValue;
 
-    for (QString sKey : m_mVariableList.keys())
+    for (QHash<QString, QMLEntity*>::const_iterator iter = m_hVariableList.constBegin(); iter != m_hVariableList.constEnd(); ++iter)
     {
-        if (m_mVariableList[sKey]->usageCount() == 0)
+        if (iter.value()->usageCount() == 0)
         {
-            mReturnValue[sKey] = m_mVariableList[sKey];
+            mReturnValue[iter.key()] = iter.value();
         }
     }
 
@@ -101,15 +127,11 @@ QMap<QString, QMLEntity*> QMLFunction::unusedVariables()
 
 //-------------------------------------------------------------------------------------------------
 
-QMap<QString, QMLEntity*> QMLFunction::members()
+void QMLFunction::visitMembers(QMLMemberVisitor& tVisitor)
 {
-    QMap<QString, QMLEntity*> vReturnValue;
-
-    vReturnValue["name"] = m_pName;
-    vReturnValue["parameters"] = m_pParameters;
-    vReturnValue["content"] = m_pContent;
-
-    return vReturnValue;
+    tVisitor.visit("content", m_pContent);
+    tVisitor.visit("name", m_pName);
+    tVisitor.visit("parameters", m_pParameters);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -123,12 +145,12 @@ void QMLFunction::solveSymbols(QMLTreeContext* pContext)
     QMLEntity::solveSymbols(pContext);
 
     if (m_pContent != nullptr)
-        m_mVariableList = m_pContent->getDeclaredSymbols();
+        m_hVariableList = symbolTable(m_pContent->getDeclaredSymbols());
 
     if (m_bIsSignal == false)
     {
         if (m_pParameters != nullptr)
-            m_mParameterList = m_pParameters->getDeclaredSymbols();
+            m_hParameterList = symbolTable(m_pParameters->getDeclaredSymbols());
     }
 }
 
@@ -175,24 +197,25 @@ QMLEntity* QMLFunction::findSymbolDeclaration(const QString& sName)
     return QMLEntity::findSymbolDeclaration(sName);
     */
 
-    QStringList lQualifiedName = QMLEntity::qualifiedNameAsList(sName);
+    // Only the first part of a qualified name can be a parameter or a variable
+    int iDotIndex = sName.indexOf('.');
+    QString sFirstName = iDotIndex < 0 ? sName : sName.left(iDotIndex);
+
+    QHash<QString, QMLEntity*>::const_iterator iter = m_hParameterList.constFind(sFirstName);
 
-    if (lQualifiedName.count() > 0)
+    if (iter != m_hParameterList.constEnd())
     {
-        if (m_mParameterList.contains(lQualifiedName[0]))
-        {
-            return m_mParameterList[lQualifiedName[0]];
-        }
+        return iter.value();
+    }
 
-        if (m_mVariableList.contains(lQualifiedName[0]))
-        {
-            return m_mVariableList[lQualifiedName[0]];
-        }
+    iter = m_hVariableList.constFind(sFirstName);
 
-        return QMLEntity::findSymbolDeclaration(QMLEntity::listAsQualifiedName(lQualifiedName));
+    if (iter != m_hVariableList.constEnd())
+    {
+        return iter.value();
     }
 
-    return nullptr;
+    return QMLEntity::findSymbolDeclaration(sName);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -249,43 +272,71 @@ void QMLFunction::toQML(QTextStream& stream, QMLFormatter& formatter, const QMLE
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLFunction::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLFunction::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
-    CXMLNode xName("Name");
-    CXMLNode xParameterList("ParameterList");
-    CXMLNode xVariableList("VariableList");
-    CXMLNode xParameters("Parameters");
-    CXMLNode xContent("Content");
-
-    if (m_pName != nullptr)
-        xName.nodes() << m_pName->toXMLNode(pContext, this);
+    writeXMLMember(tWriter, pContext, "Name", m_pName);
 
-    if (m_pParameters != nullptr)
-        xParameters.nodes() << m_pParameters->toXMLNode(pContext, this);
+    QStringList lParameterNames = m_hParameterList.keys();
+    lParameterNames.sort();
 
-    if (m_pContent != nullptr)
-        xContent.nodes() << m_pContent->toXMLNode(pContext, this);
+    tWriter.startElement("ParameterList");
 
-    for (QString sKey : m_mParameterList.keys())
+    for (QString sKey : lParameterNames)
     {
-        CXMLNode xParameter("Parameter");
-        xParameter.attributes()["Name"] = sKey;
-        xParameterList << xParameter;
+        tWriter.startElement("Parameter");
+        tWriter.setAttribute("Name", sKey);
+        tWriter.endElement();
     }
 
-    for (QString sKey : m_mVariableList.keys())
+    tWriter.endElement();
+
+    QStringList lVariableNames = m_hVariableList.keys();
+    lVariableNames.sort();
+
+    tWriter.startElement("VariableList");
+
+    for (QString sKey : lVariableNames)
     {
-        CXMLNode xVariable("Variable");
-        xVariable.attributes()["Name"] = sKey;
-        xVariableList << xVariable;
+        tWriter.startElement("Variable");
+        tWriter.setAttribute("Name", sKey);
+        tWriter.endElement();
     }
 
-    xNode.nodes() << xName;
-    xNode.nodes() << xParameterList;
-    xNode.nodes() << xVariableList;
-    xNode.nodes() << xParameters;
-    xNode.nodes() << xContent;
+    tWriter.endElement();
+
+    writeXMLMember(tWriter, pContext, "Parameters", m_pParameters);
+    writeXMLMember(tWriter, pContext, "Content", m_pContent);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Writes the parsed state of the entity to \a stream. \br\br
+    \a pTracker is passed to child entities.
+*/
+void QMLFunction::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLEntity::serialize(stream, pTracker);
+
+    serializeEntity(stream, pTracker, m_pName);
+    serializeEntity(stream, pTracker, m_pParameters);
+    serializeEntity(stream, pTracker, m_pContent);
+    stream << m_bIsSignal;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Reads the parsed state of the entity from \a stream. \br\br
+    \a pTracker is passed to child entities. \br
+    \a pRootObject is the QMLTreeContext that reads the tree.
+*/
+void QMLFunction::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
 
-    return xNode;
+    m_pName = deserializeEntity(stream, pTracker, pRootObject);
+    m_pParameters = deserializeEntity(stream, pTracker, pRootObject);
+    m_pContent = deserializeEntity(stream, pTracker, pRootObject);
+    stream >> m_bIsSignal;
 }
@@ -7,6 +7,7 @@
 
 // Qt
 #include <QObject>
+#include <QHash>
 
 // Application
 #include "QMLEntity.h"
@@ -26,6 +27,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLFunction
+    static QMLEntity* instantiator();
+
     //! Constructor with name, parameters and content
     QMLFunction(const QPoint& pPosition, QMLEntity* pName, QMLEntity *pParameters, QMLEntity *pContent);
 
@@ -61,13 +65,19 @@ public:
     //!
     QMap<QString, QMLEntity*> unusedVariables();
 
-    //! Returns all members
-    virtual QMap<QString, QMLEntity*> members() Q_DECL_OVERRIDE;
+    //! Calls tVisitor for each member
+    virtual void visitMembers(QMLMemberVisitor& tVisitor) Q_DECL_OVERRIDE;
 
     //-------------------------------------------------------------------------------------------------
     // Overridden methods
     //-------------------------------------------------------------------------------------------------
 
+    //!
+    virtual void serialize(QDataStream& stream, CObjectTracker* pTracker) const Q_DECL_OVERRIDE;
+
+    //!
+    virtual void deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject) Q_DECL_OVERRIDE;
+
     //!
     virtual void solveSymbols(QMLTreeContext* pContext) Q_DECL_OVERRIDE;
 
@@ -81,7 +91,7 @@ public:
     virtual void toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntity* pParent = nullptr) const Q_DECL_OVERRIDE;
 
     //!
-    virtual CXMLNode toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent) Q_DECL_OVERRIDE;
+    virtual void writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext) Q_DECL_OVERRIDE;
 
     //-------------------------------------------------------------------------------------------------
     // Properties
@@ -95,6 +105,6 @@ protected:
     bool                        m_bIsSignal;
 
     // Constructed after parsing
-    QMap<QString, QMLEntity*>   m_mParameterList;
-    QMap<QString, QMLEntity*>   m_mVariableList;
+    QHash<QString, QMLEntity*>  m_hParameterList;
+    QHash<QString, QMLEntity*>  m_hVariableList;
 };
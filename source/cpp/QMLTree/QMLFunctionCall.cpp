@@ -4,6 +4,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLFunctionCall::instantiator()
+{
+    return new QMLFunctionCall(QPoint(), nullptr, nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLFunctionCall::QMLFunctionCall(const QPoint& pPosition, QMLEntity* pName, QMLComplexEntity* pArguments)
     : QMLEntity(pPosition)
     , m_pName(pName)
@@ -47,14 +54,10 @@ const QMLComplexEntity* QMLFunctionCall::arguments() const
 
 //-------------------------------------------------------------------------------------------------
 
-QMap<QString, QMLEntity*> QMLFunctionCall::members()
+void QMLFunctionCall::visitMembers(QMLMemberVisitor& tVisitor)
 {
-    QMap<QString, QMLEntity*> vReturnValue;
-
-    vReturnValue["name"] = m_pName;
-    vReturnValue["arguments"] = m_pArguments;
-
-    return vReturnValue;
+    tVisitor.visit("arguments", m_pArguments);
+    tVisitor.visit("name", m_pName);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -100,20 +103,31 @@ void QMLFunctionCall::toQML(QTextStream& stream, QMLFormatter& formatter, const
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLFunctionCall::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLFunctionCall::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
-    CXMLNode xName("Name");
-    CXMLNode xArguments("Arguments");
+    writeXMLMember(tWriter, pContext, "Name", m_pName);
+    writeXMLMember(tWriter, pContext, "Arguments", m_pArguments);
+}
 
-    if (m_pName != nullptr)
-        xName.nodes() << m_pName->toXMLNode(pContext, this);
+//-------------------------------------------------------------------------------------------------
 
-    if (m_pArguments != nullptr)
-        xArguments.nodes() << m_pArguments->toXMLNode(pContext, this);
+void QMLFunctionCall::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLEntity::serialize(stream, pTracker);
+
+    serializeEntity(stream, pTracker, m_pName);
+    serializeEntity(stream, pTracker, m_pArguments);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLFunctionCall::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
 
-    xNode.nodes() << xName;
-    xNode.nodes() << xArguments;
+    m_pName = deserializeEntity(stream, pTracker, pRootObject);
+    m_pArguments = deserializeEntityAs<QMLComplexEntity>(stream, pTracker, pRootObject);
 
-    return xNode;
+    if (m_pName != nullptr) m_pName->setParent(this);
+    if (m_pArguments != nullptr) m_pArguments->setParent(this);
 }
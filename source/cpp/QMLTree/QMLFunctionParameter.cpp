@@ -7,6 +7,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLFunctionParameter::instantiator()
+{
+    return new QMLFunctionParameter(QPoint(), nullptr, nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Constructs a QMLFunctionParameter. \br\br
     \a pPosition is the position of the token in the file \br
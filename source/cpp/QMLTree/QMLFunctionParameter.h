@@ -26,6 +26,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLFunctionParameter
+    static QMLEntity* instantiator();
+
     //! Constructor with filename
     QMLFunctionParameter(const QPoint& pPosition, QMLType* pType, QMLEntity* pName);
 
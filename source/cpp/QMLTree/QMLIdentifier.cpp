@@ -7,8 +7,16 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLIdentifier::instantiator()
+{
+    return new QMLIdentifier(QPoint());
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLIdentifier::QMLIdentifier(const QPoint& pPosition)
     : QMLEntity(pPosition)
+    , m_iNameId(NAME_TABLE_INVALID_ID)
 {
 }
 
@@ -16,7 +24,9 @@ QMLIdentifier::QMLIdentifier(const QPoint& pPosition)
 
 QMLIdentifier::QMLIdentifier(const QPoint& pPosition, const QString& value)
     : QMLEntity(pPosition, value)
+    , m_iNameId(NAME_TABLE_INVALID_ID)
 {
+    internName();
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -27,6 +37,81 @@ QMLIdentifier::~QMLIdentifier()
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Returns the ID of the name in the name table of the context that parsed the identifier, or
+    \c NAME_TABLE_INVALID_ID if the identifier was created outside of a parse.
+*/
+int QMLIdentifier::nameId() const
+{
+    return m_iNameId;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns \c true if the identifier holds \a sName. \br\br
+    \a iNameId is the ID of \a sName in the name table of the identifier's context, \c NAME_TABLE_INVALID_ID if the
+    table does not hold it. Interned identifiers only compare IDs : a name missing from the table is held by none of them.
+*/
+bool QMLIdentifier::hasName(const QString& sName, int iNameId) const
+{
+    if (m_iNameId != NAME_TABLE_INVALID_ID)
+    {
+        return m_iNameId == iNameId;
+    }
+
+    return m_vValue.toString() == sName;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the name of the identifier to \a value and interns it.
+*/
+void QMLIdentifier::setValue(const QVariant& value)
+{
+    QMLEntity::setValue(value);
+
+    m_iNameId = NAME_TABLE_INVALID_ID;
+
+    internName();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Reads the identifier from \a stream and interns its name. \br\br
+    \a pTracker and \a pRootObject are passed to the base class.
+*/
+void QMLIdentifier::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
+
+    m_iNameId = NAME_TABLE_INVALID_ID;
+
+    internName();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Replaces the name with the copy held by the current name table, if there is one, and records its ID.
+*/
+void QMLIdentifier::internName()
+{
+    QMLNameTable* pTable = QMLNameTable::current();
+
+    if (pTable != nullptr && m_vValue.type() == QVariant::String)
+    {
+        QString sName = m_vValue.toString();
+
+        m_iNameId = pTable->intern(sName);
+        m_vValue = sName;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Finds the origin of the entity. \br\br
     \a pContext is the context of this entity. \br
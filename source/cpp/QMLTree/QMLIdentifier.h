@@ -10,6 +10,7 @@
 
 // Library
 #include "QMLEntity.h"
+#include "QMLNameTable.h"
 
 //-------------------------------------------------------------------------------------------------
 
@@ -24,6 +25,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLIdentifier
+    static QMLEntity* instantiator();
+
     //! Default constructor
     QMLIdentifier(const QPoint& pPosition);
 
@@ -33,10 +37,26 @@ public:
     //! Destructor
     virtual ~QMLIdentifier();
 
+    //-------------------------------------------------------------------------------------------------
+    // Getters
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the ID of the name in the name table of the context, NAME_TABLE_INVALID_ID if not interned
+    int nameId() const;
+
+    //! Returns true if the identifier holds sName, whose ID in the same name table is iNameId
+    bool hasName(const QString& sName, int iNameId) const;
+
     //-------------------------------------------------------------------------------------------------
     // Overridden methods
     //-------------------------------------------------------------------------------------------------
 
+    //!
+    virtual void setValue(const QVariant& value) Q_DECL_OVERRIDE;
+
+    //!
+    virtual void deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject) Q_DECL_OVERRIDE;
+
     //!
     virtual void solveReferences(QMLTreeContext* pContext) Q_DECL_OVERRIDE;
 
@@ -46,9 +66,20 @@ public:
     //!
     virtual void toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntity* pParent = nullptr) const Q_DECL_OVERRIDE;
 
+    //-------------------------------------------------------------------------------------------------
+    // Protected control methods
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! Interns the name in the current name table, if any
+    void internName();
+
     //-------------------------------------------------------------------------------------------------
     // Properties
     //-------------------------------------------------------------------------------------------------
 
 protected:
+
+    int     m_iNameId;
 };
@@ -5,6 +5,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLIf::instantiator()
+{
+    return new QMLIf(QPoint(), nullptr, nullptr, nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLIf::QMLIf(const QPoint& pPosition, QMLEntity* pCondition, QMLEntity* pThen, QMLEntity* pElse)
     : QMLEntity(pPosition)
     , m_pCondition(pCondition)
@@ -48,15 +55,11 @@ QMLEntity* QMLIf::Else() const
 
 //-------------------------------------------------------------------------------------------------
 
-QMap<QString, QMLEntity*> QMLIf::members()
+void QMLIf::visitMembers(QMLMemberVisitor& tVisitor)
 {
-    QMap<QString, QMLEntity*> vReturnValue;
-
-    vReturnValue["condition"] = m_pCondition;
-    vReturnValue["then"] = m_pThen;
-    vReturnValue["else"] = m_pElse;
-
-    return vReturnValue;
+    tVisitor.visit("condition", m_pCondition);
+    tVisitor.visit("else", m_pElse);
+    tVisitor.visit("then", m_pThen);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -98,25 +101,31 @@ void QMLIf::toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntity*
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLIf::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLIf::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
-    CXMLNode xCondition("Condition");
-    CXMLNode xThen("Then");
-    CXMLNode xElse("Else");
+    writeXMLMember(tWriter, pContext, "Condition", m_pCondition);
+    writeXMLMember(tWriter, pContext, "Then", m_pThen);
+    writeXMLMember(tWriter, pContext, "Else", m_pElse);
+}
 
-    if (m_pCondition != nullptr)
-        xCondition.nodes() << m_pCondition->toXMLNode(pContext, this);
+//-------------------------------------------------------------------------------------------------
 
-    if (m_pThen != nullptr)
-        xThen.nodes() << m_pThen->toXMLNode(pContext, this);
+void QMLIf::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLEntity::serialize(stream, pTracker);
 
-    if (m_pElse != nullptr)
-        xElse.nodes() << m_pElse->toXMLNode(pContext, this);
+    serializeEntity(stream, pTracker, m_pCondition);
+    serializeEntity(stream, pTracker, m_pThen);
+    serializeEntity(stream, pTracker, m_pElse);
+}
+
+//-------------------------------------------------------------------------------------------------
 
-    xNode.nodes() << xCondition;
-    xNode.nodes() << xThen;
-    xNode.nodes() << xElse;
+void QMLIf::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
 
-    return xNode;
+    m_pCondition = deserializeEntity(stream, pTracker, pRootObject);
+    m_pThen = deserializeEntity(stream, pTracker, pRootObject);
+    m_pElse = deserializeEntity(stream, pTracker, pRootObject);
 }
@@ -8,13 +8,27 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLImport::instantiator()
+{
+    return new QMLImport(QPoint(), nullptr, nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLImport::QMLImport(const QPoint& pPosition, QMLTreeContext* pContext, QMLEntity* pName, QMLEntity* pVersion, QMLEntity* pAs)
     : QMLEntity(pPosition)
     , m_pName(pName)
     , m_pVersion(pVersion)
     , m_pAs(pAs)
 {
-    if (m_pName != nullptr && (m_pVersion == nullptr || m_pVersion->toString().isEmpty()))
+    importFiles(pContext);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLImport::importFiles(QMLTreeContext* pContext)
+{
+    if (pContext != nullptr && m_pName != nullptr && (m_pVersion == nullptr || m_pVersion->toString().isEmpty()))
     {
         QString sDirectory = pContext->folder() + "/" + m_pName->toString();
 
@@ -68,15 +82,11 @@ QMLEntity* QMLImport::as() const
 
 //-------------------------------------------------------------------------------------------------
 
-QMap<QString, QMLEntity*> QMLImport::members()
+void QMLImport::visitMembers(QMLMemberVisitor& tVisitor)
 {
-    QMap<QString, QMLEntity*> vReturnValue;
-
-    vReturnValue["name"] = m_pName;
-    vReturnValue["version"] = m_pVersion;
-    vReturnValue["as"] = m_pAs;
-
-    return vReturnValue;
+    tVisitor.visit("as", m_pAs);
+    tVisitor.visit("name", m_pName);
+    tVisitor.visit("version", m_pVersion);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -117,25 +127,33 @@ void QMLImport::toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEnt
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLImport::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLImport::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
-    CXMLNode xName("Name");
-    CXMLNode xVersion("Version");
-    CXMLNode xAs("As");
+    writeXMLMember(tWriter, pContext, "Name", m_pName);
+    writeXMLMember(tWriter, pContext, "Version", m_pVersion);
+    writeXMLMember(tWriter, pContext, "As", m_pAs);
+}
 
-    if (m_pName != nullptr)
-        xName.nodes() << m_pName->toXMLNode(pContext, this);
+//-------------------------------------------------------------------------------------------------
 
-    if (m_pVersion != nullptr)
-        xVersion.nodes() << m_pVersion->toXMLNode(pContext, this);
+void QMLImport::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLEntity::serialize(stream, pTracker);
 
-    if (m_pAs != nullptr)
-        xAs.nodes() << m_pAs->toXMLNode(pContext, this);
+    serializeEntity(stream, pTracker, m_pName);
+    serializeEntity(stream, pTracker, m_pVersion);
+    serializeEntity(stream, pTracker, m_pAs);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLImport::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
 
-    xNode.nodes() << xName;
-    xNode.nodes() << xVersion;
-    xNode.nodes() << xAs;
+    m_pName = deserializeEntity(stream, pTracker, pRootObject);
+    m_pVersion = deserializeEntity(stream, pTracker, pRootObject);
+    m_pAs = deserializeEntity(stream, pTracker, pRootObject);
 
-    return xNode;
+    // Imported files are not part of the cached tree : QMLTreeCache imports them once the entry is validated
 }
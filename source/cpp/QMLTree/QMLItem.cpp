@@ -9,6 +9,16 @@
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Instantiates a new QMLItem.
+*/
+QMLEntity* QMLItem::instantiator()
+{
+    return new QMLItem(QPoint());
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLItem::QMLItem(const QPoint& pPosition, QMLEntity* pName)
     : QMLComplexEntity(pPosition, pName)
     , m_bIsSingleton(false)
@@ -47,11 +57,11 @@ QMap<QString, QMLEntity*> QMLItem::unusedProperties()
 
     if (m_bIsSingleton == false)
     {
-        for (QString sKey : m_mPropertyList.keys())
+        for (QHash<QString, QMLEntity*>::const_iterator iter = m_hPropertyList.constBegin(); iter != m_hPropertyList.constEnd(); ++iter)
         {
-            if (m_mPropertyList[sKey]->usageCount() == 0)
+            if (iter.value()->usageCount() == 0)
             {
-                mReturnValue[sKey] = m_mPropertyList[sKey];
+                mReturnValue[iter.key()] = iter.value();
             }
         }
     }
@@ -87,7 +97,7 @@ void QMLItem::solveSymbols(QMLTreeContext* pContext)
             {
                 QString sName = pDeclaration->name()->toString();
 
-                m_mPropertyList[sName] = pDeclaration->name();
+                m_hPropertyList[sName] = pDeclaration->name();
             }
         }
         else
@@ -96,7 +106,7 @@ void QMLItem::solveSymbols(QMLTreeContext* pContext)
         }
     }
 
-    m_mPropertyList["id"] = this;
+    m_hPropertyList["id"] = this;
 
     for (QMLEntity* pEntity : m_vContents)
     {
@@ -142,6 +152,24 @@ void QMLItem::solveReferences(QMLTreeContext* pContext)
 */
 QMLEntity* QMLItem::findSymbolDeclaration(const QString& sName)
 {
+    // Plain names, by far the most common, need no splitting
+    if (sName.contains('.') == false)
+    {
+        if (sName == m_sID)
+        {
+            return this;
+        }
+
+        QHash<QString, QMLEntity*>::const_iterator iter = m_hPropertyList.constFind(sName);
+
+        if (iter != m_hPropertyList.constEnd())
+        {
+            return iter.value();
+        }
+
+        return QMLComplexEntity::findSymbolDeclaration(sName);
+    }
+
     QStringList lQualifiedName = QMLEntity::qualifiedNameAsList(sName);
 
     if (lQualifiedName.count() > 0)
@@ -160,9 +188,11 @@ QMLEntity* QMLItem::findSymbolDeclaration(const QString& sName)
 
         if (lQualifiedName.count() == 1)
         {
-            if (m_mPropertyList.contains(lQualifiedName[0]))
+            QHash<QString, QMLEntity*>::const_iterator iter = m_hPropertyList.constFind(lQualifiedName[0]);
+
+            if (iter != m_hPropertyList.constEnd())
             {
-                return m_mPropertyList[lQualifiedName[0]];
+                return iter.value();
             }
         }
 
@@ -195,9 +225,11 @@ QMLEntity* QMLItem::findSymbolDeclarationDescending(QStringList& lQualifiedName)
 
         if (lQualifiedName.count() == 1)
         {
-            if (m_mPropertyList.contains(lQualifiedName[0]))
+            QHash<QString, QMLEntity*>::const_iterator iter = m_hPropertyList.constFind(lQualifiedName[0]);
+
+            if (iter != m_hPropertyList.constEnd())
             {
-                return m_mPropertyList[lQualifiedName[0]];
+                return iter.value();
             }
         }
     }
@@ -229,19 +261,21 @@ void QMLItem::removeUnreferencedSymbols(QMLTreeContext* pContext)
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLItem::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLItem::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
 {
-    CXMLNode xNode = QMLComplexEntity::toXMLNode(pContext, pParent);
-    CXMLNode xPropertyList("PropertyList");
+    QMLComplexEntity::writeXMLChildren(tWriter, pContext);
+
+    QStringList lPropertyNames = m_hPropertyList.keys();
+    lPropertyNames.sort();
 
-    for (QString sKey : m_mPropertyList.keys())
+    tWriter.startElement("PropertyList");
+
+    for (QString sKey : lPropertyNames)
     {
-        CXMLNode xProperty("Property");
-        xProperty.attributes()["Name"] = sKey;
-        xPropertyList << xProperty;
+        tWriter.startElement("Property");
+        tWriter.setAttribute("Name", sKey);
+        tWriter.endElement();
     }
 
-    xNode.nodes() << xPropertyList;
-
-    return xNode;
+    tWriter.endElement();
 }
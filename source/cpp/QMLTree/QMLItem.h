@@ -7,6 +7,7 @@
 
 // Qt
 #include <QObject>
+#include <QHash>
 
 // Application
 #include "QMLComplexEntity.h"
@@ -25,6 +26,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLItem
+    static QMLEntity* instantiator();
+
     //! Constructor with name, parameters and content
     QMLItem(const QPoint& pPosition, QMLEntity* pName = nullptr);
 
@@ -75,7 +79,7 @@ public:
     virtual void removeUnreferencedSymbols(QMLTreeContext* pContext) Q_DECL_OVERRIDE;
 
     //!
-    virtual CXMLNode toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent) Q_DECL_OVERRIDE;
+    virtual void writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext) Q_DECL_OVERRIDE;
 
     //-------------------------------------------------------------------------------------------------
     // Protected methods
@@ -88,7 +92,7 @@ public:
 protected:
 
     // Constructed after parsing
-    QMap<QString, QMLEntity*>   m_mPropertyList;
+    QHash<QString, QMLEntity*>  m_hPropertyList;
     QString                     m_sID;
     bool                        m_bIsSingleton;
 };
@@ -0,0 +1,214 @@
+
+// Qt
+#include <QReadLocker>
+#include <QWriteLocker>
+
+// Application
+#include "QMLNameTable.h"
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    \class QMLNameTable
+    \inmodule qt-plus
+    \brief A table of interned names. \br
+    Large projects repeat the same few thousand identifiers a great many times. While a table is current for a
+    thread, every QMLIdentifier created by that thread interns its name : identifiers with the same name share
+    one copy of its characters and get the same compact ID. Equal names then compare by pointer, and by ID where
+    both are known. \br
+    A QMLTreeContext owns one table for all the files it parses, including those parsed by worker threads.
+    \sa QMLTreeContext, QMLIdentifier
+*/
+
+//-------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+thread_local QMLNameTable* s_pCurrentTable = nullptr;
+
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Constructs an empty QMLNameTable.
+*/
+QMLNameTable::QMLNameTable()
+    : m_iInternCount(0)
+    , m_iSavedBytes(0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Destroys a QMLNameTable. Identifiers keep their names, which are shared by reference.
+*/
+QMLNameTable::~QMLNameTable()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of distinct names in the table.
+*/
+int QMLNameTable::count() const
+{
+    QReadLocker locker(&m_tLock);
+
+    return m_vNames.count();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the name whose ID is \a iId, or an empty string if there is none.
+*/
+QString QMLNameTable::name(int iId) const
+{
+    QReadLocker locker(&m_tLock);
+
+    if (iId < 0 || iId >= m_vNames.count())
+        return QString();
+
+    return m_vNames[iId];
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the ID of \a sName, or \c NAME_TABLE_INVALID_ID if it was never interned.
+*/
+int QMLNameTable::find(const QString& sName) const
+{
+    QReadLocker locker(&m_tLock);
+
+    return m_hIds.value(sName, NAME_TABLE_INVALID_ID);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of calls to \c intern().
+*/
+qint64 QMLNameTable::internCount() const
+{
+    return m_iInternCount.loadAcquire();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of bytes that names already in the table would have used if they had not been shared.
+*/
+qint64 QMLNameTable::savedBytes() const
+{
+    return m_iSavedBytes.loadAcquire();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of bytes used by the distinct names of the table, hash excluded.
+*/
+qint64 QMLNameTable::tableBytes() const
+{
+    QReadLocker locker(&m_tLock);
+
+    qint64 iTotal = 0;
+
+    for (const QString& sName : m_vNames)
+    {
+        iTotal += stringBytes(sName.count());
+    }
+
+    return iTotal;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the ID of \a sName, adding the name to the table if needed. \br\br
+    \a sName is replaced with the copy held by the table, so that its own data can be freed. Thread safe : most names
+    are already known and only need a shared lock.
+*/
+int QMLNameTable::intern(QString& sName)
+{
+    {
+        QReadLocker locker(&m_tLock);
+
+        QHash<QString, int>::const_iterator iter = m_hIds.constFind(sName);
+
+        if (iter != m_hIds.constEnd())
+        {
+            int iId = iter.value();
+
+            m_iInternCount.fetchAndAddRelaxed(1);
+
+            if (m_vNames[iId].constData() != sName.constData())
+            {
+                m_iSavedBytes.fetchAndAddRelaxed(stringBytes(sName.count()));
+                sName = m_vNames[iId];
+            }
+
+            return iId;
+        }
+    }
+
+    QWriteLocker locker(&m_tLock);
+
+    m_iInternCount.fetchAndAddRelaxed(1);
+
+    // Another thread may have added the name in the meantime
+    QHash<QString, int>::const_iterator iter = m_hIds.constFind(sName);
+
+    if (iter != m_hIds.constEnd())
+    {
+        m_iSavedBytes.fetchAndAddRelaxed(stringBytes(sName.count()));
+        sName = m_vNames[iter.value()];
+        return iter.value();
+    }
+
+    // Keep a tight copy : the name may come from a larger token buffer
+    QString sCopy(sName.constData(), sName.count());
+    int iId = m_vNames.count();
+
+    m_vNames << sCopy;
+    m_hIds.insert(sCopy, iId);
+
+    sName = sCopy;
+
+    return iId;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the table used by new identifiers of the calling thread, or \c nullptr if names are not interned.
+*/
+QMLNameTable* QMLNameTable::current()
+{
+    return s_pCurrentTable;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the table used by new identifiers of the calling thread to \a pTable. \c nullptr disables interning.
+*/
+void QMLNameTable::setCurrent(QMLNameTable* pTable)
+{
+    s_pCurrentTable = pTable;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the heap size of a string of \a iLength characters : its header and its characters, terminator included.
+*/
+qint64 QMLNameTable::stringBytes(int iLength)
+{
+    return qint64(sizeof(QString::Data)) + qint64(iLength + 1) * qint64(sizeof(QChar));
+}
@@ -0,0 +1,120 @@
+
+#pragma once
+
+#include "../qtplus_global.h"
+
+//-------------------------------------------------------------------------------------------------
+
+// Qt
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QAtomicInteger>
+
+//-------------------------------------------------------------------------------------------------
+
+#define NAME_TABLE_INVALID_ID   -1
+
+//-------------------------------------------------------------------------------------------------
+
+//! Defines a table of interned names, shared by the identifiers of a QMLTreeContext
+//! Each distinct name is stored once and gets a compact ID : identifiers holding the same name share its data
+class QTPLUSSHARED_EXPORT QMLNameTable
+{
+public:
+
+    //-------------------------------------------------------------------------------------------------
+    // Inner classes
+    //-------------------------------------------------------------------------------------------------
+
+    //! Makes a table current for the calling thread during the lifetime of the object
+    class Scope
+    {
+    public:
+
+        Scope(QMLNameTable* pTable)
+            : m_pPrevious(QMLNameTable::current())
+        {
+            QMLNameTable::setCurrent(pTable);
+        }
+
+        ~Scope()
+        {
+            QMLNameTable::setCurrent(m_pPrevious);
+        }
+
+    protected:
+
+        QMLNameTable* m_pPrevious;
+    };
+
+    //-------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    //-------------------------------------------------------------------------------------------------
+
+    //! Constructor
+    QMLNameTable();
+
+    //! Destructor
+    virtual ~QMLNameTable();
+
+    //-------------------------------------------------------------------------------------------------
+    // Getters
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the number of distinct names
+    int count() const;
+
+    //! Returns the name of iId, an empty string if unknown
+    QString name(int iId) const;
+
+    //! Returns the ID of sName, NAME_TABLE_INVALID_ID if it was never interned
+    int find(const QString& sName) const;
+
+    //! Returns the number of names interned, duplicates included
+    qint64 internCount() const;
+
+    //! Returns the number of bytes duplicates would have used without interning
+    qint64 savedBytes() const;
+
+    //! Returns the number of bytes used by the distinct names
+    qint64 tableBytes() const;
+
+    //-------------------------------------------------------------------------------------------------
+    // Control methods
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the ID of sName, adding it if needed, and replaces sName with the shared copy
+    int intern(QString& sName);
+
+    //-------------------------------------------------------------------------------------------------
+    // Static methods
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the table used by new identifiers in the calling thread, nullptr if none
+    static QMLNameTable* current();
+
+    //! Sets the table used by new identifiers in the calling thread
+    static void setCurrent(QMLNameTable* pTable);
+
+    //! Returns the number of bytes used by a string of iLength characters
+    static qint64 stringBytes(int iLength);
+
+    //-------------------------------------------------------------------------------------------------
+    // Properties
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    mutable QReadWriteLock  m_tLock;
+    QHash<QString, int>     m_hIds;
+    QVector<QString>        m_vNames;
+    QAtomicInteger<qint64>  m_iInternCount;
+    QAtomicInteger<qint64>  m_iSavedBytes;
+
+private:
+
+    QMLNameTable(const QMLNameTable&);
+    QMLNameTable& operator = (const QMLNameTable&);
+};
@@ -12,6 +12,16 @@
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Instantiates a new QMLNameValue.
+*/
+QMLEntity* QMLNameValue::instantiator()
+{
+    return new QMLNameValue(QPoint());
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Constructs a QMLNameValue. \br\br
     \a pPosition is the position of the token in the file \br
@@ -63,19 +73,39 @@ QString QMLNameValue::name() const
 
 //-------------------------------------------------------------------------------------------------
 
-/*!
-    Returns a CXMLNode representation of this item. \br\br
-    \a pContext is a user defined context. \br
-    \a pParent is the caller of this method.
-*/
-CXMLNode QMLNameValue::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLNameValue::writeXMLAttributes(QMLXMLWriter& tWriter)
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
+    QMLEntity::writeXMLAttributes(tWriter);
 
     if (m_sName.isEmpty() == false)
     {
-        xNode.attributes()["Name"] = m_sName;
+        tWriter.setAttribute("Name", m_sName);
     }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Writes the parsed state of the entity to \a stream. \br\br
+    \a pTracker is passed to child entities.
+*/
+void QMLNameValue::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLEntity::serialize(stream, pTracker);
+
+    stream << m_sName;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Reads the parsed state of the entity from \a stream. \br\br
+    \a pTracker is passed to child entities. \br
+    \a pRootObject is the QMLTreeContext that reads the tree.
+*/
+void QMLNameValue::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
 
-    return xNode;
+    stream >> m_sName;
 }
@@ -26,6 +26,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLNameValue
+    static QMLEntity* instantiator();
+
     //! Default constructor
     QMLNameValue(const QPoint& pPosition);
 
@@ -54,7 +57,13 @@ public:
     //-------------------------------------------------------------------------------------------------
 
     //!
-    virtual CXMLNode toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent) Q_DECL_OVERRIDE;
+    virtual void serialize(QDataStream& stream, CObjectTracker* pTracker) const Q_DECL_OVERRIDE;
+
+    //!
+    virtual void deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject) Q_DECL_OVERRIDE;
+
+    //!
+    virtual void writeXMLAttributes(QMLXMLWriter& tWriter) Q_DECL_OVERRIDE;
 
     //-------------------------------------------------------------------------------------------------
     // Properties
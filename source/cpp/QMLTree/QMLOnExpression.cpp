@@ -4,6 +4,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLOnExpression::instantiator()
+{
+    return new QMLOnExpression(QPoint(), nullptr, nullptr, nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLOnExpression::QMLOnExpression(const QPoint& pPosition, QMLEntity* pTarget, QMLEntity* pName, QMLComplexEntity* pContents)
     : QMLComplexEntity(pPosition, pName)
     , m_pTarget(pTarget)
@@ -26,13 +33,11 @@ QMLOnExpression::~QMLOnExpression()
 
 //-------------------------------------------------------------------------------------------------
 
-QMap<QString, QMLEntity*> QMLOnExpression::members()
+void QMLOnExpression::visitMembers(QMLMemberVisitor& tVisitor)
 {
-    QMap<QString, QMLEntity*> vReturnValue = QMLComplexEntity::members();
+    QMLComplexEntity::visitMembers(tVisitor);
 
-    vReturnValue["target"] = m_pTarget;
-
-    return vReturnValue;
+    tVisitor.visit("target", m_pTarget);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -75,3 +80,23 @@ void QMLOnExpression::toQML(QTextStream& stream, QMLFormatter& formatter, const
         stream << "} ";
     }
 }
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLOnExpression::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLComplexEntity::serialize(stream, pTracker);
+
+    serializeEntity(stream, pTracker, m_pTarget);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLOnExpression::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLComplexEntity::deserialize(stream, pTracker, pRootObject);
+
+    m_pTarget = deserializeEntity(stream, pTracker, pRootObject);
+
+    if (m_pTarget != nullptr) m_pTarget->setParent(this);
+}
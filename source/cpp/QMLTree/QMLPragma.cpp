@@ -7,6 +7,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLPragma::instantiator()
+{
+    return new QMLPragma(QPoint(), nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLPragma::QMLPragma(const QPoint& pPosition, QMLEntity* pStatement)
     : QMLEntity(pPosition)
     , m_pStatement(pStatement)
@@ -33,13 +40,9 @@ QMLEntity* QMLPragma::statement() const
 
 //-------------------------------------------------------------------------------------------------
 
-QMap<QString, QMLEntity*> QMLPragma::members()
+void QMLPragma::visitMembers(QMLMemberVisitor& tVisitor)
 {
-    QMap<QString, QMLEntity*> vReturnValue;
-
-    vReturnValue["statement"] = m_pStatement;
-
-    return vReturnValue;
+    tVisitor.visit("statement", m_pStatement);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -62,15 +65,27 @@ void QMLPragma::toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEnt
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLPragma::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLPragma::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
-    CXMLNode xStatement("Statement");
+    writeXMLMember(tWriter, pContext, "Statement", m_pStatement);
+}
 
-    if (m_pStatement != nullptr)
-        xStatement.nodes() << m_pStatement->toXMLNode(pContext, this);
+//-------------------------------------------------------------------------------------------------
 
-    xNode.nodes() << xStatement;
+void QMLPragma::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLEntity::serialize(stream, pTracker);
+
+    serializeEntity(stream, pTracker, m_pStatement);
+}
+
+//-------------------------------------------------------------------------------------------------
 
-    return xNode;
+void QMLPragma::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
+
+    m_pStatement = deserializeEntity(stream, pTracker, pRootObject);
+
+    if (m_pStatement != nullptr) m_pStatement->setParent(this);
 }
@@ -4,6 +4,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLPropertyAlias::instantiator()
+{
+    return new QMLPropertyAlias(QPoint(), nullptr, nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLPropertyAlias::QMLPropertyAlias(const QPoint& pPosition, QMLEntity* pName, QMLEntity* pContent)
     : QMLPropertyAssignment(pPosition, pName, pContent)
 {
@@ -24,6 +24,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLPropertyAlias
+    static QMLEntity* instantiator();
+
     //! Constructor with name and content
     QMLPropertyAlias(const QPoint& pPosition, QMLEntity* pName, QMLEntity *pContent);
 
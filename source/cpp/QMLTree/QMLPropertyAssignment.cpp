@@ -4,6 +4,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLPropertyAssignment::instantiator()
+{
+    return new QMLPropertyAssignment(QPoint(), nullptr, nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLPropertyAssignment::QMLPropertyAssignment(const QPoint& pPosition, QMLEntity* pName, QMLEntity* pContent)
     : QMLPropertyDeclaration(pPosition, nullptr, pName, pContent)
 {
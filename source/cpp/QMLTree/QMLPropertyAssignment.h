@@ -24,6 +24,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLPropertyAssignment
+    static QMLEntity* instantiator();
+
     //! Constructor with name and content
     QMLPropertyAssignment(const QPoint& pPosition, QMLEntity* pName, QMLEntity *pContent);
 
@@ -13,6 +13,16 @@
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Instantiates a new QMLPropertyDeclaration.
+*/
+QMLEntity* QMLPropertyDeclaration::instantiator()
+{
+    return new QMLPropertyDeclaration(QPoint(), nullptr, nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Constructs a QMLPropertyDeclaration. \br\br
     \a pPosition is the position of the token in the file.
@@ -123,17 +133,13 @@ QMLPropertyDeclaration::EModifier QMLPropertyDeclaration::modifiers() const
 //-------------------------------------------------------------------------------------------------
 
 /*!
-    Returns a map of class members.
+    Calls \a tVisitor for each member.
 */
-QMap<QString, QMLEntity*> QMLPropertyDeclaration::members()
+void QMLPropertyDeclaration::visitMembers(QMLMemberVisitor& tVisitor)
 {
-    QMap<QString, QMLEntity*> vReturnValue;
-
-    vReturnValue["type"] = m_pType;
-    vReturnValue["name"] = m_pName;
-    vReturnValue["content"] = m_pContent;
-
-    return vReturnValue;
+    tVisitor.visit("content", m_pContent);
+    tVisitor.visit("name", m_pName);
+    tVisitor.visit("type", m_pType);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -198,32 +204,55 @@ void QMLPropertyDeclaration::toQML(QTextStream& stream, QMLFormatter& formatter,
 
 //-------------------------------------------------------------------------------------------------
 
+void QMLPropertyDeclaration::writeXMLAttributes(QMLXMLWriter& tWriter)
+{
+    QMLEntity::writeXMLAttributes(tWriter);
+
+    tWriter.setAttribute("Modifiers", QString::number((int) m_eModifiers));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLPropertyDeclaration::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
+{
+    writeXMLMember(tWriter, pContext, "Type", m_pType);
+    writeXMLMember(tWriter, pContext, "Name", m_pName);
+    writeXMLMember(tWriter, pContext, "Content", m_pContent);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
-    Returns a CXMLNode representation of this item. \br\br
-    \a pContext is a user defined context. \br
-    \a pParent is the caller of this method.
+    Writes the parsed state of the entity to \a stream. \br\br
+    \a pTracker is passed to child entities.
 */
-CXMLNode QMLPropertyDeclaration::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLPropertyDeclaration::serialize(QDataStream& stream, CObjectTracker* pTracker) const
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
-    CXMLNode xType("Type");
-    CXMLNode xName("Name");
-    CXMLNode xContent("Content");
+    QMLEntity::serialize(stream, pTracker);
 
-    xNode.attributes()["Modifiers"] = QString::number((int) m_eModifiers);
+    serializeEntity(stream, pTracker, m_pType);
+    serializeEntity(stream, pTracker, m_pName);
+    serializeEntity(stream, pTracker, m_pContent);
+    stream << qint32(m_eModifiers);
+}
 
-    if (m_pType != nullptr)
-        xType.nodes() << m_pType->toXMLNode(pContext, this);
+//-------------------------------------------------------------------------------------------------
 
-    if (m_pName != nullptr)
-        xName.nodes() << m_pName->toXMLNode(pContext, this);
+/*!
+    Reads the parsed state of the entity from \a stream. \br\br
+    \a pTracker is passed to child entities. \br
+    \a pRootObject is the QMLTreeContext that reads the tree.
+*/
+void QMLPropertyDeclaration::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
 
-    if (m_pContent != nullptr)
-        xContent.nodes() << m_pContent->toXMLNode(pContext, this);
+    qint32 iModifiers = 0;
 
-    xNode.nodes() << xType;
-    xNode.nodes() << xName;
-    xNode.nodes() << xContent;
+    m_pType = deserializeEntityAs<QMLType>(stream, pTracker, pRootObject);
+    m_pName = deserializeEntity(stream, pTracker, pRootObject);
+    m_pContent = deserializeEntity(stream, pTracker, pRootObject);
+    stream >> iModifiers;
 
-    return xNode;
+    m_eModifiers = EModifier(iModifiers);
 }
@@ -5,6 +5,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLQualifiedExpression::instantiator()
+{
+    return new QMLQualifiedExpression(QPoint());
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLQualifiedExpression::QMLQualifiedExpression(const QPoint& pPosition)
     : QMLComplexEntity(pPosition)
 {
@@ -24,7 +31,7 @@ QMLQualifiedExpression::~QMLQualifiedExpression()
 */
 void QMLQualifiedExpression::solveReferences(QMLTreeContext* pContext)
 {
-    QString sName = toString();
+    QString sName = qualifiedName();
 
     if (sName.isEmpty() == false)
     {
@@ -58,6 +65,33 @@ void QMLQualifiedExpression::solveSymbolUsages(QMLTreeContext* pContext)
 
 //-------------------------------------------------------------------------------------------------
 
+QString QMLQualifiedExpression::qualifiedName() const
+{
+    QStringList lNames;
+
+    // Dotted identifiers need no formatter, anything else is rendered through toString()
+    for (QMLEntity* pItem : m_vContents)
+    {
+        QMLIdentifier* pIdentifier = dynamic_cast<QMLIdentifier*>(pItem);
+
+        if (pIdentifier == nullptr)
+        {
+            return toString();
+        }
+
+        lNames << pIdentifier->value().toString();
+    }
+
+    if (m_bIsParenthesized)
+    {
+        return QString("(%1)").arg(lNames.join("."));
+    }
+
+    return lNames.join(".");
+}
+
+//-------------------------------------------------------------------------------------------------
+
 void QMLQualifiedExpression::toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntity* pParent) const
 {
     Q_UNUSED(pParent);
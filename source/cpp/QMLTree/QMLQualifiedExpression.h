@@ -25,6 +25,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLQualifiedExpression
+    static QMLEntity* instantiator();
+
     //! Default constructor
     QMLQualifiedExpression(const QPoint& pPosition);
 
@@ -44,6 +47,15 @@ public:
     //!
     virtual void toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntity* pParent = nullptr) const Q_DECL_OVERRIDE;
 
+    //-------------------------------------------------------------------------------------------------
+    // Protected methods
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! Returns the expression as written, used as the name to resolve
+    QString qualifiedName() const;
+
     //-------------------------------------------------------------------------------------------------
     // Properties
     //-------------------------------------------------------------------------------------------------
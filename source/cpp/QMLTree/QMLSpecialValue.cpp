@@ -4,6 +4,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLSpecialValue::instantiator()
+{
+    return new QMLSpecialValue(QPoint(), svNone);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLSpecialValue::QMLSpecialValue(const QPoint& pPosition)
     : QMLEntity(pPosition)
 {
@@ -56,11 +63,31 @@ void QMLSpecialValue::toQML(QTextStream& stream, QMLFormatter& formatter, const
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLSpecialValue::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLSpecialValue::writeXMLAttributes(QMLXMLWriter& tWriter)
+{
+    QMLEntity::writeXMLAttributes(tWriter);
+
+    tWriter.setAttribute("Value", toString());
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLSpecialValue::serialize(QDataStream& stream, CObjectTracker* pTracker) const
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
+    QMLEntity::serialize(stream, pTracker);
+
+    stream << qint32(m_eValue);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLSpecialValue::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
+
+    qint32 iValue = 0;
 
-    xNode.attributes()["Value"] = toString();
+    stream >> iValue;
 
-    return xNode;
+    m_eValue = ESpecialValue(iValue);
 }
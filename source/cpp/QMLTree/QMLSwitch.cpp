@@ -5,6 +5,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLSwitch::instantiator()
+{
+    return new QMLSwitch(QPoint(), nullptr, nullptr);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLSwitch::QMLSwitch(const QPoint& pPosition, QMLEntity* pExpression, QMLComplexEntity* pCases)
     : QMLEntity(pPosition)
     , m_pExpression(pExpression)
@@ -40,14 +47,10 @@ QMLEntity* QMLSwitch::cases() const
 
 //-------------------------------------------------------------------------------------------------
 
-QMap<QString, QMLEntity*> QMLSwitch::members()
+void QMLSwitch::visitMembers(QMLMemberVisitor& tVisitor)
 {
-    QMap<QString, QMLEntity*> vReturnValue;
-
-    vReturnValue["expression"] = m_pExpression;
-    vReturnValue["cases"] = m_pCases;
-
-    return vReturnValue;
+    tVisitor.visit("cases", m_pCases);
+    tVisitor.visit("expression", m_pExpression);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -85,20 +88,31 @@ void QMLSwitch::toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEnt
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLSwitch::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLSwitch::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
-    CXMLNode xExpression("Expression");
-    CXMLNode xCases("Cases");
+    writeXMLMember(tWriter, pContext, "Expression", m_pExpression);
+    writeXMLMember(tWriter, pContext, "Cases", m_pCases);
+}
 
-    if (m_pExpression != nullptr)
-        xExpression.nodes() << m_pExpression->toXMLNode(pContext, this);
+//-------------------------------------------------------------------------------------------------
 
-    if (m_pCases != nullptr)
-        xCases.nodes() << m_pCases->toXMLNode(pContext, this);
+void QMLSwitch::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLEntity::serialize(stream, pTracker);
+
+    serializeEntity(stream, pTracker, m_pExpression);
+    serializeEntity(stream, pTracker, m_pCases);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLSwitch::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
 
-    xNode.nodes() << xExpression;
-    xNode.nodes() << xCases;
+    m_pExpression = deserializeEntity(stream, pTracker, pRootObject);
+    m_pCases = deserializeEntityAs<QMLComplexEntity>(stream, pTracker, pRootObject);
 
-    return xNode;
+    if (m_pExpression != nullptr) m_pExpression->setParent(this);
+    if (m_pCases != nullptr) m_pCases->setParent(this);
 }
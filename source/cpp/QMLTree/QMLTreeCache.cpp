@@ -0,0 +1,251 @@
+
+// Qt
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QCryptographicHash>
+
+// Application
+#include "QMLTreeCache.h"
+#include "QMLEntityFactory.h"
+#include "QMLFile.h"
+#include "QMLImport.h"
+#include "QMLTreeContext.h"
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    \class QMLTreeCache
+    \inmodule qt-plus
+    \brief An on-disk cache of parsed QML files. \br
+    Entries are keyed by a hash of the file's contents and of the parser version, so a file that did not
+    change since the last run is read back instead of being parsed. \br
+    Several processes may share the same folder : entries are written to a temporary file which is then
+    renamed, so a reader sees either no entry or a complete one.
+    \sa QMLTreeContext
+*/
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Constructs a disabled QMLTreeCache.
+*/
+QMLTreeCache::QMLTreeCache()
+    : m_iHits(0)
+    , m_iMisses(0)
+{
+    // Any change in the list of entity classes changes their serialized indices
+    m_baSignature = QString("%1;%2;%3")
+            .arg(QMLTREE_CACHE_VERSION)
+            .arg(int(QDataStream::Qt_5_0))
+            .arg(QMLEntityFactory::getInstance()->productNames().join(","))
+            .toLatin1();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Destroys a QMLTreeCache.
+*/
+QMLTreeCache::~QMLTreeCache()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the folder of the cache to \a sFolder. An empty string disables the cache.
+*/
+void QMLTreeCache::setFolder(const QString& sFolder)
+{
+    m_sFolder = sFolder;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the folder of the cache.
+*/
+QString QMLTreeCache::folder() const
+{
+    return m_sFolder;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns \c true if a folder is set.
+*/
+bool QMLTreeCache::isEnabled() const
+{
+    return m_sFolder.isEmpty() == false;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of files read from the cache since the last \c resetStatistics().
+*/
+int QMLTreeCache::hits() const
+{
+    return m_iHits.loadAcquire();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of files not found in the cache since the last \c resetStatistics().
+*/
+int QMLTreeCache::misses() const
+{
+    return m_iMisses.loadAcquire();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the key of a file whose contents are \a sText.
+*/
+QByteArray QMLTreeCache::key(const QString& sText) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    hash.addData(m_baSignature);
+    hash.addData(reinterpret_cast<const char*>(sText.constData()), sText.size() * int(sizeof(QChar)));
+
+    return hash.result();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Reads the tree stored under \a baKey into \a pFile. Returns \c false if there is no valid entry. \br\br
+    \a pContext is the context parsing \a pFile, used by imports found in the tree.
+*/
+bool QMLTreeCache::load(const QByteArray& baKey, QMLFile* pFile, QMLTreeContext* pContext)
+{
+    QFile file(entryFileName(baKey));
+
+    if (file.open(QIODevice::ReadOnly) == false)
+    {
+        m_iMisses.ref();
+        return false;
+    }
+
+    QByteArray baData = file.readAll();
+    file.close();
+
+    QDataStream stream(baData);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 iMagic = 0;
+    quint32 iVersion = 0;
+    quint16 iChecksum = 0;
+    QByteArray baStoredKey;
+    QByteArray baPayload;
+
+    stream >> iMagic >> iVersion >> baStoredKey >> iChecksum >> baPayload;
+
+    if (stream.status() != QDataStream::Ok
+            || iMagic != QMLTREE_CACHE_MAGIC
+            || iVersion != QMLTREE_CACHE_VERSION
+            || baStoredKey != baKey
+            || qChecksum(baPayload.constData(), uint(baPayload.size())) != iChecksum)
+    {
+        m_iMisses.ref();
+        return false;
+    }
+
+    // Read into a scratch file so that a bad entry leaves pFile untouched
+    QMLFile tFile(QPoint(), pContext, pFile->fileName());
+    QDataStream payloadStream(baPayload);
+    payloadStream.setVersion(QDataStream::Qt_5_0);
+
+    tFile.deserialize(payloadStream, nullptr, pContext);
+
+    if (payloadStream.status() != QDataStream::Ok || payloadStream.atEnd() == false)
+    {
+        m_iMisses.ref();
+        return false;
+    }
+
+    // Imported files are not part of the cached tree, they are handled as if this file was parsed
+    for (QMLEntity* pEntity : tFile.contents())
+    {
+        QMLImport* pImport = dynamic_cast<QMLImport*>(pEntity);
+
+        if (pImport != nullptr)
+        {
+            pImport->importFiles(pContext);
+        }
+    }
+
+    pFile->contents() << tFile.grabContents();
+    pFile->comments() << tFile.comments();
+    tFile.comments().clear();
+
+    m_iHits.ref();
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Stores the tree of \a pFile under \a baKey. \br\br
+    Must be called right after parsing, before symbols are solved.
+*/
+void QMLTreeCache::store(const QByteArray& baKey, const QMLFile* pFile)
+{
+    QByteArray baPayload;
+    QDataStream payloadStream(&baPayload, QIODevice::WriteOnly);
+    payloadStream.setVersion(QDataStream::Qt_5_0);
+
+    pFile->serialize(payloadStream, nullptr);
+
+    if (payloadStream.status() != QDataStream::Ok)
+        return;
+
+    QByteArray baData;
+    QDataStream stream(&baData, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << quint32(QMLTREE_CACHE_MAGIC);
+    stream << quint32(QMLTREE_CACHE_VERSION);
+    stream << baKey;
+    stream << qChecksum(baPayload.constData(), uint(baPayload.size()));
+    stream << baPayload;
+
+    QDir().mkpath(m_sFolder);
+
+    // Concurrent writers of the same entry each rename their own complete copy
+    QSaveFile file(entryFileName(baKey));
+
+    if (file.open(QIODevice::WriteOnly))
+    {
+        file.write(baData);
+        file.commit();
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Resets hit and miss counters.
+*/
+void QMLTreeCache::resetStatistics()
+{
+    m_iHits.storeRelease(0);
+    m_iMisses.storeRelease(0);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the name of the file holding the entry for \a baKey.
+*/
+QString QMLTreeCache::entryFileName(const QByteArray& baKey) const
+{
+    return QString("%1/%2%3").arg(m_sFolder).arg(QString(baKey.toHex())).arg(QMLTREE_CACHE_EXTENSION);
+}
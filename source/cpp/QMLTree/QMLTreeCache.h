@@ -0,0 +1,102 @@
+
+#pragma once
+
+#include "../qtplus_global.h"
+
+//-------------------------------------------------------------------------------------------------
+
+// Qt
+#include <QString>
+#include <QByteArray>
+#include <QAtomicInt>
+
+//-------------------------------------------------------------------------------------------------
+// Forward declarations
+
+class QMLFile;
+class QMLTreeContext;
+
+//-------------------------------------------------------------------------------------------------
+
+// Change this whenever the grammar or the serialization of an entity changes
+#define QMLTREE_CACHE_VERSION   1
+
+#define QMLTREE_CACHE_MAGIC     0x514D4C43
+#define QMLTREE_CACHE_EXTENSION ".qmlc"
+
+//-------------------------------------------------------------------------------------------------
+
+//! Defines an on-disk cache of parsed QML files, keyed by file content
+class QTPLUSSHARED_EXPORT QMLTreeCache
+{
+public:
+
+    //-------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    //-------------------------------------------------------------------------------------------------
+
+    //! Constructor
+    QMLTreeCache();
+
+    //! Destructor
+    virtual ~QMLTreeCache();
+
+    //-------------------------------------------------------------------------------------------------
+    // Setters
+    //-------------------------------------------------------------------------------------------------
+
+    //! Sets the folder where entries are stored, an empty string disables the cache
+    void setFolder(const QString& sFolder);
+
+    //-------------------------------------------------------------------------------------------------
+    // Getters
+    //-------------------------------------------------------------------------------------------------
+
+    //!
+    QString folder() const;
+
+    //!
+    bool isEnabled() const;
+
+    //! Returns the number of files read from the cache
+    int hits() const;
+
+    //! Returns the number of files that had to be parsed
+    int misses() const;
+
+    //-------------------------------------------------------------------------------------------------
+    // Control methods
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the key of a file whose contents are sText
+    QByteArray key(const QString& sText) const;
+
+    //! Fills pFile with the tree stored under baKey, returns false on a miss
+    bool load(const QByteArray& baKey, QMLFile* pFile, QMLTreeContext* pContext);
+
+    //! Stores the tree of pFile under baKey
+    void store(const QByteArray& baKey, const QMLFile* pFile);
+
+    //! Resets hit and miss counters
+    void resetStatistics();
+
+    //-------------------------------------------------------------------------------------------------
+    // Protected control methods
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! Returns the name of the file holding the entry for baKey
+    QString entryFileName(const QByteArray& baKey) const;
+
+    //-------------------------------------------------------------------------------------------------
+    // Properties
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    QString     m_sFolder;
+    QByteArray  m_baSignature;      // Parser version and entity classes, part of every key
+    QAtomicInt  m_iHits;
+    QAtomicInt  m_iMisses;
+};
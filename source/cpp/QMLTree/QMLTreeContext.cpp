@@ -2,6 +2,8 @@
 // Qt
 #include <QDebug>
 #include <QDir>
+#include <QRunnable>
+#include <QMutexLocker>
 
 // Library
 #include "QMLTreeContext.h"
@@ -246,9 +248,9 @@
 //-------------------------------------------------------------------------------------------------
 
 #define SCOPE                   (*(m_sScopes.last()))
-#define GET(a)                  { (a) = getChar(); }
-#define UNGET(a)                { ungetChar((a)); }
-#define STORE(a)                { *(SCOPE.m_pCurrentTokenValue) += QString(QChar(a)); }
+#define GET(a)                  { (a) = tScope.getChar(); }
+#define UNGET(a)                { tScope.ungetChar((a)); }
+#define STORE(a)                { tScope.storeChar((a)); }
 
 #define TOKEN_IDENTIFIER        300
 #define TOKEN_LITERAL           301
@@ -327,6 +329,82 @@
 #define TOKEN_SIGNAL            528
 #define TOKEN_NEW               529
 
+#define KEYWORD_TABLE_SIZE      64
+#define KEYWORD_MAX_LENGTH      9
+
+//-------------------------------------------------------------------------------------------------
+
+struct QMLKeyword
+{
+    const char* pText;
+    int         iToken;
+};
+
+static const QMLKeyword s_tKeywords[] =
+{
+    { "import",     TOKEN_IMPORT },
+    { "property",   TOKEN_PROPERTY },
+    { "default",    TOKEN_DEFAULT },
+    { "readonly",   TOKEN_READ_ONLY },
+    { "alias",      TOKEN_ALIAS },
+    { "function",   TOKEN_FUNCTION },
+    { "if",         TOKEN_IF },
+    { "else",       TOKEN_ELSE },
+    { "for",        TOKEN_FOR },
+    { "in",         TOKEN_IN },
+    { "while",      TOKEN_WHILE },
+    { "switch",     TOKEN_SWITCH },
+    { "case",       TOKEN_CASE },
+    { "break",      TOKEN_BREAK },
+    { "continue",   TOKEN_CONTINUE },
+    { "with",       TOKEN_WITH },
+    { "return",     TOKEN_RETURN },
+    { "typeof",     TOKEN_TYPEOF },
+    { "pragma",     TOKEN_PRAGMA },
+    { "on",         TOKEN_ON },
+    { "as",         TOKEN_AS },
+    { "signal",     TOKEN_SIGNAL },
+    { "var",        TOKEN_VAR },
+    { "new",        TOKEN_NEW },
+    { "null",       TOKEN_NULL },
+    { "undefined",  TOKEN_UNDEFINED }
+};
+
+// Perfect hash of the keywords above : no two of them share a slot
+// Any new keyword must be checked against the assert in QMLKeywordTable
+static inline int keywordHash(int iLength, ushort uFirst, ushort uLast)
+{
+    return (iLength + uFirst * 9 + uLast * 29) & (KEYWORD_TABLE_SIZE - 1);
+}
+
+class QMLKeywordTable
+{
+public:
+
+    QMLKeywordTable()
+    {
+        for (int iSlot = 0; iSlot < KEYWORD_TABLE_SIZE; iSlot++)
+        {
+            m_pSlots[iSlot] = nullptr;
+            m_iLengths[iSlot] = 0;
+        }
+
+        for (const QMLKeyword& tKeyword : s_tKeywords)
+        {
+            int iLength = int(qstrlen(tKeyword.pText));
+            int iSlot = keywordHash(iLength, ushort(tKeyword.pText[0]), ushort(tKeyword.pText[iLength - 1]));
+
+            Q_ASSERT(m_pSlots[iSlot] == nullptr);
+
+            m_pSlots[iSlot] = &tKeyword;
+            m_iLengths[iSlot] = iLength;
+        }
+    }
+
+    const QMLKeyword*   m_pSlots[KEYWORD_TABLE_SIZE];
+    int                 m_iLengths[KEYWORD_TABLE_SIZE];
+};
+
 //-------------------------------------------------------------------------------------------------
 
 extern int yydebug;
@@ -410,7 +488,31 @@ void QMLAnalyzerError::revertToOriginalPosition()
 
 //-------------------------------------------------------------------------------------------------
 
-QStringList QMLTreeContext::s_lOperators;
+//! Parses one file of a parallel parse on a thread of the pool
+class QMLFileParser : public QRunnable
+{
+public:
+
+    QMLFileParser(QMLTreeContext* pContext, QMLFile* pFile, const QString& sFolder, bool bImport)
+        : m_pContext(pContext)
+        , m_pFile(pFile)
+        , m_sFolder(sFolder)
+        , m_bImport(bImport)
+    {
+    }
+
+    virtual void run() Q_DECL_OVERRIDE
+    {
+        m_pContext->parseFile_Worker(m_pFile, m_sFolder, m_bImport);
+    }
+
+protected:
+
+    QMLTreeContext* m_pContext;
+    QMLFile*        m_pFile;
+    QString         m_sFolder;
+    bool            m_bImport;
+};
 
 //-------------------------------------------------------------------------------------------------
 
@@ -420,51 +522,25 @@ QStringList QMLTreeContext::s_lOperators;
 QMLTreeContext::QMLTreeContext()
     : m_eError(peSuccess)
     , m_bIncludeImports(false)
+    , m_iMaxThreads(1)
+    , m_pParentContext(nullptr)
+    , m_pThreadPool(nullptr)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Constructs a QMLTreeContext used by a worker of \a pParentContext to parse one file. \br\br
+    Imports found in the file are handed back to \a pParentContext.
+*/
+QMLTreeContext::QMLTreeContext(QMLTreeContext* pParentContext)
+    : m_eError(peSuccess)
+    , m_bIncludeImports(pParentContext->m_bIncludeImports)
+    , m_iMaxThreads(1)
+    , m_pParentContext(pParentContext)
+    , m_pThreadPool(nullptr)
 {
-    m_mTokens["import"] = TOKEN_IMPORT;
-    m_mTokens["property"] = TOKEN_PROPERTY;
-    m_mTokens["default"] = TOKEN_DEFAULT;
-    m_mTokens["readonly"] = TOKEN_READ_ONLY;
-    m_mTokens["alias"] = TOKEN_ALIAS;
-    m_mTokens["function"] = TOKEN_FUNCTION;
-    m_mTokens["if"] = TOKEN_IF;
-    m_mTokens["else"] = TOKEN_ELSE;
-    m_mTokens["for"] = TOKEN_FOR;
-    m_mTokens["in"] = TOKEN_IN;
-    m_mTokens["while"] = TOKEN_WHILE;
-    m_mTokens["switch"] = TOKEN_SWITCH;
-    m_mTokens["case"] = TOKEN_CASE;
-    m_mTokens["break"] = TOKEN_BREAK;
-    m_mTokens["continue"] = TOKEN_CONTINUE;
-    m_mTokens["with"] = TOKEN_WITH;
-    m_mTokens["return"] = TOKEN_RETURN;
-    m_mTokens["typeof"] = TOKEN_TYPEOF;
-    m_mTokens["pragma"] = TOKEN_PRAGMA;
-    m_mTokens["on"] = TOKEN_ON;
-    m_mTokens["as"] = TOKEN_AS;
-    m_mTokens["signal"] = TOKEN_SIGNAL;
-    m_mTokens["var"] = TOKEN_VAR;
-    m_mTokens["new"] = TOKEN_NEW;
-    m_mTokens["null"] = TOKEN_NULL;
-    m_mTokens["undefined"] = TOKEN_UNDEFINED;
-
-    if (s_lOperators.count() == 0)
-    {
-        s_lOperators << "{";
-        s_lOperators << "}";
-        s_lOperators << "(";
-        s_lOperators << ")";
-        s_lOperators << "[";
-        s_lOperators << "]";
-        s_lOperators << "+";
-        s_lOperators << "-";
-        s_lOperators << "*";
-        s_lOperators << "/";
-        s_lOperators << ">";
-        s_lOperators << "<";
-        s_lOperators << ">=";
-        s_lOperators << "<=";
-    }
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -489,15 +565,11 @@ QMLTreeContext::~QMLTreeContext()
 
 #ifdef TRACK_ENTITIES
 
-    if (QMLEntity::createdEntities() != QMLEntity::deletedEntities())
+    // Leaked entities are reported by the files that held them
+    if (m_pParentContext == nullptr && QMLEntity::createdEntities() != QMLEntity::deletedEntities())
     {
         qWarning() << QString("Created entities : %1").arg(QMLEntity::createdEntities());
         qWarning() << QString("Deleted entities : %1").arg(QMLEntity::deletedEntities());
-
-        for (QMLEntity* pEntity : QMLEntity::entities())
-        {
-            qWarning() << QString("Leaked entity : ") + QString::number((qint64)pEntity) + " < " + pEntity->metaObject()->className() + " > " + " ( " + pEntity->toString() + " )";
-        }
     }
 #endif
 }
@@ -531,6 +603,95 @@ void QMLTreeContext::setFileParsed(const QString& sFileName, bool bValue)
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Sets the maximum number of threads used by \c parse() to \a iValue. \br\br
+    With more than one thread, files and their imports are parsed concurrently.
+*/
+void QMLTreeContext::setMaxThreads(int iValue)
+{
+    m_iMaxThreads = qMax(1, iValue);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the maximum number of threads used by \c parse().
+*/
+int QMLTreeContext::maxThreads() const
+{
+    return m_iMaxThreads;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the folder of the parse cache to \a sFolder. \br\br
+    Files whose contents are found in the cache are read back instead of being parsed.
+    An empty string, the default, disables the cache.
+*/
+void QMLTreeContext::setCacheFolder(const QString& sFolder)
+{
+    m_tCache.setFolder(sFolder);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the folder of the parse cache.
+*/
+QString QMLTreeContext::cacheFolder() const
+{
+    return m_tCache.folder();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the parse cache. The per-file contexts of a parallel parse share the cache of their parent.
+*/
+QMLTreeCache& QMLTreeContext::cache()
+{
+    if (m_pParentContext != nullptr)
+        return m_pParentContext->cache();
+
+    return m_tCache;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the number of bytes reserved by the arenas of all files. \br\br
+    Each file allocates its entities in its own arena, freed when the file is deleted. See QMLFile::arena().
+*/
+qint64 QMLTreeContext::arenaBytes() const
+{
+    qint64 iTotal = 0;
+
+    for (const QMLFile* pFile : m_vFiles)
+    {
+        iTotal += pFile->arena().reservedBytes();
+    }
+
+    return iTotal;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the table of identifier names. \br\br
+    Identifiers created while parsing intern their name in this table, shared by all the files of the context :
+    identical names share their characters and have the same ID.
+*/
+QMLNameTable& QMLTreeContext::names()
+{
+    if (m_pParentContext != nullptr)
+        return m_pParentContext->names();
+
+    return m_tNames;
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Returns the folder.
 */
@@ -571,6 +732,16 @@ QString QMLTreeContext::errorString() const
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Returns the errors of the last \c parse(), by file name.
+*/
+QMap<QString, QMLAnalyzerError> QMLTreeContext::fileErrors() const
+{
+    return m_mFileErrors;
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Returns the current position in the file. \br\br
     The x component is the column (from 0).\br
@@ -651,7 +822,10 @@ QStack<QMLTreeContext::QMLScope*>& QMLTreeContext::scopes()
 
 const QStringList& QMLTreeContext::operators()
 {
-    return s_lOperators;
+    // Initialized once, even when several threads get here together
+    static const QStringList lOperators({ "{", "}", "(", ")", "[", "]", "+", "-", "*", "/", ">", "<", ">=", "<=" });
+
+    return lOperators;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -666,6 +840,28 @@ void QMLTreeContext::addFile(const QString& sFileName)
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Removes \a sFileName from the context and deletes its tree. Returns \c false if the file is unknown. \br\br
+    Adding the file again makes the next parse() read it from disk. The memory of the deleted tree is
+    given back with the arena of the file, see QMLFile::arena().
+*/
+bool QMLTreeContext::removeFile(const QString& sFileName)
+{
+    for (int iIndex = 0; iIndex < m_vFiles.count(); iIndex++)
+    {
+        if (m_vFiles[iIndex]->fileName() == sFileName)
+        {
+            delete m_vFiles.takeAt(iIndex);
+            m_mFileErrors.remove(sFileName);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Parses the input file.
 */
@@ -673,6 +869,12 @@ QMLTreeContext::EParseError QMLTreeContext::parse()
 {
     m_eError = peSuccess;
     m_tErrorObject.clear();
+    m_mFileErrors.clear();
+
+    if (m_iMaxThreads > 1)
+    {
+        return parse_Parallel();
+    }
 
     for (QMLFile* pFile : m_vFiles)
     {
@@ -689,6 +891,11 @@ QMLTreeContext::EParseError QMLTreeContext::parse()
 
             m_eError = parse_Internal();
 
+            if (m_eError != peSuccess)
+            {
+                m_mFileErrors[pFile->fileName()] = m_tErrorObject;
+            }
+
             // Delete all scopes
             for (QMLScope* pScope : m_sScopes)
             {
@@ -716,6 +923,182 @@ QMLTreeContext::EParseError QMLTreeContext::parse()
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Parses all unparsed files on a thread pool. \br\br
+    Each file gets its own scope stack in a private context, so workers share nothing but the file list.
+    Imports are scheduled as soon as they are found. Once all workers are done, the file list is put
+    back in the order a sequential parse would have produced and errors are reported in that order.
+*/
+QMLTreeContext::EParseError QMLTreeContext::parse_Parallel()
+{
+    QThreadPool tThreadPool;
+    tThreadPool.setMaxThreadCount(m_iMaxThreads);
+
+    QVector<QMLFile*> vKnownFiles = m_vFiles;
+    QSet<QMLFile*> sKnownFiles;
+
+    {
+        QMutexLocker locker(&m_mFilesMutex);
+
+        m_pThreadPool = &tThreadPool;
+        m_mImports.clear();
+        m_sScheduledFiles.clear();
+
+        for (QMLFile* pFile : vKnownFiles)
+        {
+            sKnownFiles << pFile;
+
+            if (pFile->parsed() == false)
+            {
+                QFileInfo info(pFile->fileName());
+                m_sFolder = info.absoluteDir().path();
+
+                m_sScheduledFiles << pFile;
+                tThreadPool.start(new QMLFileParser(this, pFile, m_sFolder, false));
+            }
+        }
+    }
+
+    tThreadPool.waitForDone();
+
+    m_pThreadPool = nullptr;
+
+    // New files are listed in the order a sequential parse would have found them
+    QSet<QMLFile*> sVisitedFiles;
+    QVector<QMLFile*> vOrderedFiles = vKnownFiles;
+
+    for (QMLFile* pFile : vKnownFiles)
+    {
+        if (sVisitedFiles.contains(pFile) == false)
+        {
+            orderFiles(pFile, sKnownFiles, sVisitedFiles, vOrderedFiles);
+        }
+    }
+
+    m_vFiles = vOrderedFiles;
+
+    for (QMLFile* pFile : m_vFiles)
+    {
+        if (m_sScheduledFiles.contains(pFile))
+        {
+            if (m_mFileErrors.contains(pFile->fileName()) && m_eError == peSuccess)
+            {
+                m_eError = peSyntaxError;
+                m_tErrorObject = m_mFileErrors[pFile->fileName()];
+            }
+
+            pFile->setParsed(true);
+
+            // Tell the world parsing has ended
+            emit parsingFinished(pFile->fileName());
+        }
+    }
+
+    m_mImports.clear();
+    m_sScheduledFiles.clear();
+
+    return m_eError;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Parses \a pFile on a worker thread, in a private context whose folder is \a sFolder. \br\br
+    \a bImport tells if the file was found as an import.
+*/
+void QMLTreeContext::parseFile_Worker(QMLFile* pFile, const QString& sFolder, bool bImport)
+{
+    if (bImport)
+        emit importParsingStarted(pFile->fileName());
+    else
+        emit parsingStarted(pFile->fileName());
+
+    QMLTreeContext tFileContext(this);
+    tFileContext.m_sFolder = sFolder;
+    tFileContext.m_sScopes.push(new QMLScope(pFile));
+
+    EParseError eError = tFileContext.parse_Internal();
+
+    // Entities created here belong to the pool thread : hand them over to the thread of this context
+    // before solving, so that the parents set while solving never cross threads
+    for (QMLEntity* pEntity : pFile->arena().liveEntities())
+    {
+        if (pEntity->parent() == nullptr && pEntity->thread() == QThread::currentThread())
+        {
+            pEntity->moveToThread(thread());
+        }
+    }
+
+    // The file only holds its own entities : solving needs no lock
+    pFile->solveSymbols(this);
+    pFile->solveReferences(this);
+    pFile->solveSymbolUsages(this);
+    pFile->solveComments();
+
+    QMutexLocker locker(&m_mFilesMutex);
+
+    if (eError != peSuccess)
+    {
+        m_mFileErrors[pFile->fileName()] = tFileContext.m_tErrorObject;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Records that \a pImporter imports \a sFileName and schedules \a sFileName if not parsed yet. \br\br
+    \a sFolder is the folder of the importing context. Called by worker threads.
+*/
+void QMLTreeContext::scheduleImport(QMLFile* pImporter, const QString& sFileName, const QString& sFolder)
+{
+    QMutexLocker locker(&m_mFilesMutex);
+
+    if (fileParsed(sFileName))
+        return;
+
+    QMLFile* pFile = fileByFileName(sFileName);
+
+    // A file created by this worker must not stay bound to the pool thread
+    if (pFile->thread() == QThread::currentThread())
+    {
+        pFile->moveToThread(thread());
+    }
+
+    m_mImports[pImporter] << pFile;
+
+    if (m_sScheduledFiles.contains(pFile) == false)
+    {
+        m_sScheduledFiles << pFile;
+        m_pThreadPool->start(new QMLFileParser(this, pFile, sFolder, true));
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Appends to \a vOrderedFiles the files imported by \a pFile, depth first. \br\br
+    Files in \a sKnownFiles were in the list before parsing and keep their place.
+*/
+void QMLTreeContext::orderFiles(QMLFile* pFile, const QSet<QMLFile*>& sKnownFiles, QSet<QMLFile*>& sVisitedFiles, QVector<QMLFile*>& vOrderedFiles)
+{
+    sVisitedFiles << pFile;
+
+    for (QMLFile* pImport : m_mImports.value(pFile))
+    {
+        if (sVisitedFiles.contains(pImport) == false)
+        {
+            if (sKnownFiles.contains(pImport) == false)
+            {
+                vOrderedFiles << pImport;
+            }
+
+            orderFiles(pImport, sKnownFiles, sVisitedFiles, vOrderedFiles);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Parses the input string.
 */
@@ -774,11 +1157,34 @@ QMLTreeContext::EParseError QMLTreeContext::parse_Internal()
     // Assume success, will be changed on error
     SCOPE.m_eError = peSuccess;
 
+    // Entities created from here on belong to the file being parsed and share the names of this context
+    QMLEntityArena::Scope tArenaScope(&SCOPE.m_pFile->arena());
+    QMLNameTable::Scope tNameScope(&names());
+
+    QMLTreeCache& tCache = cache();
+    QByteArray baCacheKey;
+
+    if (tCache.isEnabled())
+    {
+        baCacheKey = tCache.key(SCOPE.m_sInputString);
+
+        if (tCache.load(baCacheKey, SCOPE.m_pFile, this))
+        {
+            return peSuccess;
+        }
+    }
+
     // yydebug = 1;
 
     // Call generated parser
     yyparse(this);
 
+    // Store the raw tree, symbols are solved again after a load
+    if (SCOPE.m_eError == peSuccess && baCacheKey.isEmpty() == false)
+    {
+        tCache.store(baCacheKey, SCOPE.m_pFile);
+    }
+
     return SCOPE.m_eError;
 }
 
@@ -791,7 +1197,12 @@ QMLTreeContext::EParseError QMLTreeContext::parseImportFile(const QString& sFile
 {
     if (m_bIncludeImports)
     {
-        if (fileParsed(sFileName) == false)
+        // In a parallel parse, the file goes to another worker
+        if (m_pParentContext != nullptr)
+        {
+            m_pParentContext->scheduleImport(SCOPE.m_pFile, sFileName, m_sFolder);
+        }
+        else if (fileParsed(sFileName) == false)
         {
             QMLFile* pFile = fileByFileName(sFileName);
 
@@ -817,7 +1228,12 @@ QMLTreeContext::EParseError QMLTreeContext::parseImportFile(const QString& sFile
 */
 int QMLTreeContext::nextToken(void* LVAL)
 {
-    return parseNextToken(reinterpret_cast<UParserValue*>(LVAL));
+    int iToken = parseNextToken(reinterpret_cast<UParserValue*>(LVAL));
+
+    // The token was scanned as an offset and length in the buffer, the parser wants a string
+    SCOPE.commitToken();
+
+    return iToken;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -832,6 +1248,49 @@ QString QMLTreeContext::tokenValue() const
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Scans \a sText and returns its tokens, one \c "code line column value" string per token. \br\br
+    Comments follow the tokens as \c "comment line column type text" strings. \br
+    Nothing is parsed, this exists to check the lexer.
+*/
+QStringList QMLTreeContext::tokenize(const QString& sText)
+{
+    QStringList lTokens;
+    QMLFile tFile(QPoint(), this, "");
+    UParserValue tValue;
+
+    m_sScopes.push(new QMLScope(&tFile, sText));
+
+    while (true)
+    {
+        int iToken = nextToken(&tValue);
+
+        if (iToken == 0)
+            break;
+
+        lTokens << QString("%1 %2 %3 %4")
+                   .arg(iToken)
+                   .arg(SCOPE.m_iPreviousLine)
+                   .arg(SCOPE.m_iPreviousColumn)
+                   .arg(tokenValue());
+    }
+
+    delete m_sScopes.pop();
+
+    for (QMLComment* pComment : tFile.comments())
+    {
+        lTokens << QString("comment %1 %2 %3 %4")
+                   .arg(pComment->position().y())
+                   .arg(pComment->position().x())
+                   .arg(int(pComment->type()))
+                   .arg(pComment->value().toString());
+    }
+
+    return lTokens;
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Shows the error text in \a sText.
 */
@@ -876,16 +1335,17 @@ void QMLTreeContext::run()
 
 int QMLTreeContext::parseNextToken(UParserValue* LVAL)
 {
-    if (SCOPE.m_pCurrentTokenValue != nullptr)
-        SCOPE.m_pCurrentTokenValue->clear();
+    QMLScope& tScope = SCOPE;
+
+    tScope.clearToken();
 
-    SCOPE.m_iCommentLevel   = 0;
-    SCOPE.m_bParsingFloat   = false;
-    SCOPE.m_bParsingHexa    = false;
+    tScope.m_iCommentLevel  = 0;
+    tScope.m_bParsingFloat  = false;
+    tScope.m_bParsingHexa   = false;
 
     int c, d, e;
     QPoint pCommentStartPosition;
-    bool bCommentStartLineEmpty = SCOPE.m_bLineEmpty;
+    bool bCommentStartLineEmpty = tScope.m_bLineEmpty;
 
     // Skip white spaces and comments
     // Whites are considered to be every ASCII code below 0x21
@@ -896,7 +1356,7 @@ int QMLTreeContext::parseNextToken(UParserValue* LVAL)
 
         if (c == EOF) return 0;
 
-        if (SCOPE.m_iCommentLevel > 0)
+        if (tScope.m_iCommentLevel > 0)
         {
             if (c == '*')
             {
@@ -905,16 +1365,13 @@ int QMLTreeContext::parseNextToken(UParserValue* LVAL)
                 {
                     // This is the end of a multi-line comment
 
-                    if (SCOPE.m_pCurrentTokenValue != nullptr)
-                    {
-                        QMLComment::ECommentType eType = SCOPE.m_bDocComment ? QMLComment::ctMultiLineDoc : QMLComment::ctMultiLine;
-                        QMLComment* pComment = new QMLComment(pCommentStartPosition, SCOPE.m_pCurrentTokenValue->trimmed(), eType);
-                        m_sScopes.last()->m_pFile->comments() << pComment;
+                    QMLComment::ECommentType eType = tScope.m_bDocComment ? QMLComment::ctMultiLineDoc : QMLComment::ctMultiLine;
+                    QMLComment* pComment = new QMLComment(pCommentStartPosition, tScope.tokenText().trimmed(), eType);
+                    tScope.m_pFile->comments() << pComment;
 
-                        SCOPE.m_pCurrentTokenValue->clear();
-                    }
+                    tScope.clearToken();
 
-                    SCOPE.m_iCommentLevel--;
+                    tScope.m_iCommentLevel--;
                 }
                 else
                 {
@@ -936,10 +1393,10 @@ int QMLTreeContext::parseNextToken(UParserValue* LVAL)
                 {
                     // This is the start of a multi-line doc comment
 
-                    SCOPE.m_iCommentLevel++;
-                    SCOPE.m_bDocComment = true;
+                    tScope.m_iCommentLevel++;
+                    tScope.m_bDocComment = true;
 
-                    pCommentStartPosition = QPoint(SCOPE.m_iColumn, SCOPE.m_iLine);
+                    pCommentStartPosition = QPoint(tScope.m_iColumn, tScope.m_iLine);
                 }
                 else
                 {
@@ -947,19 +1404,19 @@ int QMLTreeContext::parseNextToken(UParserValue* LVAL)
 
                     // This is the start of a multi-line comment
 
-                    SCOPE.m_iCommentLevel++;
-                    SCOPE.m_bDocComment = false;
+                    tScope.m_iCommentLevel++;
+                    tScope.m_bDocComment = false;
 
-                    pCommentStartPosition = QPoint(SCOPE.m_iColumn, SCOPE.m_iLine);
+                    pCommentStartPosition = QPoint(tScope.m_iColumn, tScope.m_iLine);
                 }
             }
             else if (d == '/')
             {
                 // This is a single-line comment
 
-                pCommentStartPosition = QPoint(SCOPE.m_iColumn, SCOPE.m_iLine);
+                pCommentStartPosition = QPoint(tScope.m_iColumn, tScope.m_iLine);
 
-                if (SCOPE.m_iCommentLevel == 0)
+                if (tScope.m_iCommentLevel == 0)
                 {
                     while (c != '\n')
                     {
@@ -967,14 +1424,11 @@ int QMLTreeContext::parseNextToken(UParserValue* LVAL)
                         if (c == EOF) return 0;
                     }
 
-                    if (SCOPE.m_pCurrentTokenValue != nullptr)
-                    {
-                        QMLComment::ECommentType eType = bCommentStartLineEmpty ? QMLComment::ctSingleLine : QMLComment::ctSingleLineAtEnd;
-                        QMLComment* pComment = new QMLComment(pCommentStartPosition, SCOPE.m_pCurrentTokenValue->trimmed(), eType);
-                        m_sScopes.last()->m_pFile->comments() << pComment;
+                    QMLComment::ECommentType eType = bCommentStartLineEmpty ? QMLComment::ctSingleLine : QMLComment::ctSingleLineAtEnd;
+                    QMLComment* pComment = new QMLComment(pCommentStartPosition, tScope.tokenText().trimmed(), eType);
+                    tScope.m_pFile->comments() << pComment;
 
-                        SCOPE.m_pCurrentTokenValue->clear();
-                    }
+                    tScope.clearToken();
                 }
             }
             else
@@ -988,17 +1442,16 @@ int QMLTreeContext::parseNextToken(UParserValue* LVAL)
         {
             if (c > ' ') { UNGET(c); break; }
 
-            bCommentStartLineEmpty = SCOPE.m_bLineEmpty;
+            bCommentStartLineEmpty = tScope.m_bLineEmpty;
         }
     }
 
-    if (SCOPE.m_pCurrentTokenValue != nullptr)
-        SCOPE.m_pCurrentTokenValue->clear();
+    tScope.clearToken();
 
     // Set context parsing stuff
 
-    SCOPE.m_iPreviousLine   = SCOPE.m_iLine;
-    SCOPE.m_iPreviousColumn = SCOPE.m_iColumn;
+    tScope.m_iPreviousLine   = tScope.m_iLine;
+    tScope.m_iPreviousColumn = tScope.m_iColumn;
 
     GET(c);
 
@@ -1175,11 +1628,11 @@ int QMLTreeContext::parseNextToken(UParserValue* LVAL)
             GET(c);
             if (c == EOF ) return 0;
             if (c == '"' ) break;
-            if (c == '\\') c = parseEscape();
+            if (c == '\\') c = parseEscape(tScope);
             STORE(c);
         }
 
-        LVAL->String = SCOPE.m_pCurrentTokenValue;
+        LVAL->String = tScope.m_pCurrentTokenValue;
         return TOKEN_LITERAL;
     }
 
@@ -1190,11 +1643,11 @@ int QMLTreeContext::parseNextToken(UParserValue* LVAL)
             GET(c);
             if (c == EOF ) return 0;
             if (c == '\'' ) break;
-            if (c == '\\') c = parseEscape();
+            if (c == '\\') c = parseEscape(tScope);
             STORE(c);
         }
 
-        LVAL->String = SCOPE.m_pCurrentTokenValue;
+        LVAL->String = tScope.m_pCurrentTokenValue;
         return TOKEN_LITERAL;
     }
 
@@ -1205,9 +1658,9 @@ int QMLTreeContext::parseNextToken(UParserValue* LVAL)
         GET(d);
         if (isdigit(d))
         {
-            SCOPE.m_bParsingFloat = true;
+            tScope.m_bParsingFloat = true;
             STORE('0'); STORE(c); STORE(d);
-            return parseNumber(LVAL);
+            return parseNumber(tScope, LVAL);
         }
         STORE(c); UNGET(d);
         return c;
@@ -1224,13 +1677,13 @@ int QMLTreeContext::parseNextToken(UParserValue* LVAL)
             {
                 STORE(c);
                 STORE(d);
-                SCOPE.m_bParsingHexa = true;
-                return parseNumber(LVAL);
+                tScope.m_bParsingHexa = true;
+                return parseNumber(tScope, LVAL);
             }
             else UNGET(d);
         }
         STORE(c);
-        return parseNumber(LVAL);
+        return parseNumber(tScope, LVAL);
     }
 
     if (isalpha(c) || c == '_' || c == '$')
@@ -1240,26 +1693,35 @@ int QMLTreeContext::parseNextToken(UParserValue* LVAL)
 
         UNGET(c);
 
-        if (SCOPE.m_pCurrentTokenValue->toLower() == "true")
+        QStringRef sToken = tScope.m_bTokenRewritten
+                ? QStringRef(&tScope.m_sTokenText)
+                : QStringRef(&tScope.m_sInputString, tScope.m_iTokenStart, tScope.m_iTokenLength);
+
+        if (sToken.compare(QLatin1String("true"), Qt::CaseInsensitive) == 0)
         {
             LVAL->Boolean = true;
             return TOKEN_BOOLCONSTANT;
         }
 
-        if (SCOPE.m_pCurrentTokenValue->toLower() == "false")
+        if (sToken.compare(QLatin1String("false"), Qt::CaseInsensitive) == 0)
         {
             LVAL->Boolean = false;
             return TOKEN_BOOLCONSTANT;
         }
 
-        // Check if this is a keyword
-        if (m_mTokens.contains(*(SCOPE.m_pCurrentTokenValue)))
+        // Check if this is a keyword, which only holds plain ASCII
+        if (tScope.m_bTokenRewritten == false)
         {
-            return m_mTokens[*(SCOPE.m_pCurrentTokenValue)];
+            int iKeyword = keywordToken(tScope.m_pBufferStart + tScope.m_iTokenStart, tScope.m_iTokenLength);
+
+            if (iKeyword != 0)
+            {
+                return iKeyword;
+            }
         }
 
         // This must be an identifier
-        LVAL->String = SCOPE.m_pCurrentTokenValue;
+        LVAL->String = tScope.m_pCurrentTokenValue;
         return TOKEN_IDENTIFIER;
     }
 
@@ -1269,7 +1731,7 @@ int QMLTreeContext::parseNextToken(UParserValue* LVAL)
 
 //-------------------------------------------------------------------------------------------------
 
-int QMLTreeContext::parseNumber(UParserValue* LVAL)
+int QMLTreeContext::parseNumber(QMLScope& tScope, UParserValue* LVAL)
 {
     int c;
     bool Done = false;
@@ -1288,15 +1750,15 @@ int QMLTreeContext::parseNumber(UParserValue* LVAL)
             case 'a' : case 'b' : case 'c' : case 'd' : case 'e' : case 'f' :
             case 'A' : case 'B' : case 'C' : case 'D' : case 'E' : case 'F' :
             {
-                if (SCOPE.m_bParsingHexa) { STORE(c); } else { UNGET(c); Done = true; }
+                if (tScope.m_bParsingHexa) { STORE(c); } else { UNGET(c); Done = true; }
             }
                 break;
 
             case '.' :
             {
-                if (!SCOPE.m_bParsingFloat)
+                if (!tScope.m_bParsingFloat)
                 {
-                    SCOPE.m_bParsingFloat = 1; STORE(c);
+                    tScope.m_bParsingFloat = 1; STORE(c);
                 }
                 else
                 {
@@ -1309,24 +1771,26 @@ int QMLTreeContext::parseNumber(UParserValue* LVAL)
         }
     }
 
-    if (SCOPE.m_bParsingFloat)
+    tScope.commitToken();
+
+    if (tScope.m_bParsingFloat)
     {
-        LVAL->Real = SCOPE.m_pCurrentTokenValue->toDouble();
+        LVAL->Real = tScope.m_pCurrentTokenValue->toDouble();
         return TOKEN_REALCONSTANT;
     }
-    else if (SCOPE.m_bParsingHexa)
+    else if (tScope.m_bParsingHexa)
     {
-        LVAL->Integer = SCOPE.m_pCurrentTokenValue->toInt();
+        LVAL->Integer = tScope.m_pCurrentTokenValue->toInt();
         return TOKEN_INTEGERCONSTANT;
     }
 
-    LVAL->Integer = SCOPE.m_pCurrentTokenValue->toInt();
+    LVAL->Integer = tScope.m_pCurrentTokenValue->toInt();
     return TOKEN_INTEGERCONSTANT;
 }
 
 //-------------------------------------------------------------------------------------------------
 
-int QMLTreeContext::parseEscape()
+int QMLTreeContext::parseEscape(QMLScope& tScope)
 {
     int c;
 
@@ -1352,33 +1816,63 @@ int QMLTreeContext::parseEscape()
 
 //-------------------------------------------------------------------------------------------------
 
-int QMLTreeContext::getChar()
+int QMLTreeContext::keywordToken(const QChar* pText, int iLength)
+{
+    static const QMLKeywordTable tTable;
+
+    if (iLength < 2 || iLength > KEYWORD_MAX_LENGTH)
+        return 0;
+
+    int iSlot = keywordHash(iLength, pText[0].unicode(), pText[iLength - 1].unicode());
+    const QMLKeyword* pKeyword = tTable.m_pSlots[iSlot];
+
+    if (pKeyword == nullptr || tTable.m_iLengths[iSlot] != iLength)
+        return 0;
+
+    for (int iIndex = 0; iIndex < iLength; iIndex++)
+    {
+        if (pText[iIndex].unicode() != ushort(pKeyword->pText[iIndex]))
+            return 0;
+    }
+
+    return pKeyword->iToken;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int QMLTreeContext::QMLScope::getChar()
 {
-    if (SCOPE.m_pStream->atEnd())
+    if (m_pCursor >= m_pBufferEnd)
+    {
+        m_bEndReached = true;
         return EOF;
+    }
+
+    m_bEndReached = false;
 
-    int iChar = SCOPE.m_pStream->read(1)[0].toLatin1();
+    // Characters outside Latin-1 read as 0, those above 0x7F as negative values (0xFF reads as EOF)
+    int iChar = (m_pCursor++)->toLatin1();
 
     switch (iChar)
     {
         case ' ' :
-            SCOPE.m_iColumn++;
+            m_iColumn++;
             break;
         case '\n' :
-            SCOPE.m_iColumn = 0;
-            SCOPE.m_iLine++;
-            SCOPE.m_bPreviousLineEmpty = SCOPE.m_bLineEmpty;
-            SCOPE.m_bLineEmpty = true;
+            m_iColumn = 0;
+            m_iLine++;
+            m_bPreviousLineEmpty = m_bLineEmpty;
+            m_bLineEmpty = true;
             break;
         case '\t' :
-            SCOPE.m_iColumn += 4;
+            m_iColumn += 4;
             break;
         case '\r' :
             break;
         default:
-            SCOPE.m_iColumn++;
-            SCOPE.m_bPreviousLineEmpty = SCOPE.m_bLineEmpty;
-            SCOPE.m_bLineEmpty = false;
+            m_iColumn++;
+            m_bPreviousLineEmpty = m_bLineEmpty;
+            m_bLineEmpty = false;
             break;
     }
 
@@ -1387,26 +1881,95 @@ int QMLTreeContext::getChar()
 
 //-------------------------------------------------------------------------------------------------
 
-int QMLTreeContext::ungetChar(int iChar)
+void QMLTreeContext::QMLScope::ungetChar(int iChar)
 {
-    SCOPE.m_pStream->seek(SCOPE.m_pStream->pos() - 1);
+    // Nothing was read at the end of the buffer
+    if ((iChar == EOF && m_bEndReached) || m_pCursor == m_pBufferStart)
+        return;
+
+    m_pCursor--;
 
     switch (iChar)
     {
         case '\n' :
-            SCOPE.m_iColumn = 1024;
-            SCOPE.m_iLine--;
-            SCOPE.m_bLineEmpty = SCOPE.m_bPreviousLineEmpty;
+            m_iColumn = 1024;
+            m_iLine--;
+            m_bLineEmpty = m_bPreviousLineEmpty;
             break;
         case '\t' :
-            SCOPE.m_iColumn -= 4;
+            m_iColumn -= 4;
             break;
         case '\r' :
             break;
         default:
-            SCOPE.m_iColumn--;
+            m_iColumn--;
             break;
     }
+}
 
-    return iChar;
+//-------------------------------------------------------------------------------------------------
+
+void QMLTreeContext::QMLScope::storeChar(int iChar)
+{
+    if (m_bTokenRewritten == false)
+    {
+        int iIndex = int(m_pCursor - m_pBufferStart) - 1;
+
+        // Most of the time the character is the one just read and follows the token in the buffer
+        if (iIndex >= 0 && iChar > 0 && iChar < 0x80 && m_pBufferStart[iIndex].unicode() == iChar)
+        {
+            if (m_iTokenLength == 0)
+            {
+                m_iTokenStart = iIndex;
+                m_iTokenLength = 1;
+                return;
+            }
+
+            if (m_iTokenStart + m_iTokenLength == iIndex)
+            {
+                m_iTokenLength++;
+                return;
+            }
+        }
+
+        // Escapes, skipped characters and substitutes : the token now lives in its own string
+        m_sTokenText = QString(m_pBufferStart + m_iTokenStart, m_iTokenLength);
+        m_bTokenRewritten = true;
+    }
+
+    m_sTokenText += QChar(iChar);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLTreeContext::QMLScope::clearToken()
+{
+    m_iTokenStart = 0;
+    m_iTokenLength = 0;
+
+    if (m_bTokenRewritten)
+    {
+        m_sTokenText.clear();
+        m_bTokenRewritten = false;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+QString QMLTreeContext::QMLScope::tokenText() const
+{
+    if (m_bTokenRewritten)
+        return m_sTokenText;
+
+    return QString(m_pBufferStart + m_iTokenStart, m_iTokenLength);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLTreeContext::QMLScope::commitToken()
+{
+    if (m_bTokenRewritten)
+        *m_pCurrentTokenValue = m_sTokenText;
+    else
+        m_pCurrentTokenValue->setUnicode(m_pBufferStart + m_iTokenStart, m_iTokenLength);
 }
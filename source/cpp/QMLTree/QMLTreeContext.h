@@ -13,12 +13,17 @@
 #include <QTextStream>
 #include <QStack>
 #include <QThread>
+#include <QThreadPool>
+#include <QMutex>
+#include <QSet>
 #include <QJSEngine>
 
 // Library
 #include "../CXMLNodable.h"
 #include "QMLComplexEntity.h"
 #include "QMLFile.h"
+#include "QMLTreeCache.h"
+#include "QMLNameTable.h"
 
 #define PURE_PARSER
 
@@ -106,6 +111,7 @@ class QTPLUSSHARED_EXPORT QMLTreeContext : public QThread, public CXMLNodableCon
     Q_OBJECT
 
     friend class QMLTreeContextWrapper;
+    friend class QMLFileParser;
 
 public:
 
@@ -132,6 +138,14 @@ public:
         QMLScope()
             : m_pFile(nullptr)
             , m_eError(peSuccess)
+            , m_pBufferStart(nullptr)
+            , m_pBufferEnd(nullptr)
+            , m_pCursor(nullptr)
+            , m_bEndReached(false)
+            , m_iTokenStart(0)
+            , m_iTokenLength(0)
+            , m_bTokenRewritten(false)
+            , m_pCurrentTokenValue(new QString())
             , m_iLine(0)
             , m_iColumn(0)
             , m_iPreviousLine(0)
@@ -141,9 +155,8 @@ public:
             , m_bLineEmpty(true)
             , m_bPreviousLineEmpty(true)
             , m_bDocComment(false)
-            , m_pStream(new QTextStream(&m_sInputString))
-            , m_pCurrentTokenValue(new QString())
         {
+            resetCursor();
         }
 
         QMLScope(QMLFile* pFile)
@@ -158,6 +171,8 @@ public:
                 m_sInputString = fInputFile.readAll();
                 fInputFile.close();
             }
+
+            resetCursor();
         }
 
         QMLScope(QMLFile* pFile, const QString& sText)
@@ -165,12 +180,13 @@ public:
         {
             m_pFile = pFile;
             m_sInputString = sText;
+
+            resetCursor();
         }
 
         ~QMLScope()
         {
             delete m_pCurrentTokenValue;
-            delete m_pStream;
         }
 
         QMLScope(const QMLScope& target)
@@ -193,10 +209,44 @@ public:
             return m_pFile->fileName();
         }
 
+        //! Points the cursor at the start of the input buffer
+        void resetCursor()
+        {
+            m_pBufferStart = m_sInputString.constData();
+            m_pBufferEnd = m_pBufferStart + m_sInputString.count();
+            m_pCursor = m_pBufferStart;
+            m_bEndReached = false;
+        }
+
+        //! Reads one character and updates the position
+        int getChar();
+
+        //! Steps back over iChar and restores the position
+        void ungetChar(int iChar);
+
+        //! Appends iChar, the last character read or a substitute, to the current token
+        void storeChar(int iChar);
+
+        //! Empties the current token
+        void clearToken();
+
+        //! Returns the text of the current token
+        QString tokenText() const;
+
+        //! Copies the current token into m_pCurrentTokenValue
+        void commitToken();
+
         QMLFile*            m_pFile;
         EParseError         m_eError;
         QString             m_sInputString;
-        QTextStream*        m_pStream;
+        const QChar*        m_pBufferStart;         // The whole file, never modified while lexing
+        const QChar*        m_pBufferEnd;
+        const QChar*        m_pCursor;
+        bool                m_bEndReached;          // True when the last read hit the end of the buffer
+        int                 m_iTokenStart;          // Offset of the current token in the buffer
+        int                 m_iTokenLength;         // Length of the current token in the buffer
+        bool                m_bTokenRewritten;      // True when the token differs from the buffer and lives in m_sTokenText
+        QString             m_sTokenText;
         QString*            m_pCurrentTokenValue;
         int                 m_iLine;
         int                 m_iColumn;
@@ -232,6 +282,12 @@ public:
     //!
     void setFileParsed(const QString& sFileName, bool bValue);
 
+    //!
+    void setMaxThreads(int iValue);
+
+    //!
+    void setCacheFolder(const QString& sFolder);
+
     //-------------------------------------------------------------------------------------------------
     // Getters
     //-------------------------------------------------------------------------------------------------
@@ -239,6 +295,21 @@ public:
     //!
     QString folder() const;
 
+    //!
+    int maxThreads() const;
+
+    //!
+    QString cacheFolder() const;
+
+    //!
+    QMLTreeCache& cache();
+
+    //!
+    qint64 arenaBytes() const;
+
+    //!
+    QMLNameTable& names();
+
     //!
     bool success() const;
 
@@ -248,6 +319,9 @@ public:
     //!
     QString errorString() const;
 
+    //!
+    QMap<QString, QMLAnalyzerError> fileErrors() const;
+
     //!
     QPoint position() const;
 
@@ -273,6 +347,9 @@ public:
     //!
     void addFile(const QString& sFileName);
 
+    //! Removes sFileName and deletes its tree, returns false if the file is unknown
+    bool removeFile(const QString& sFileName);
+
     //!
     EParseError parse();
 
@@ -291,6 +368,9 @@ public:
     //!
     QString tokenValue() const;
 
+    //!
+    QStringList tokenize(const QString& sText);
+
     //!
     void showError(const QString& sText);
 
@@ -320,6 +400,13 @@ signals:
 
 private:
 
+    //-------------------------------------------------------------------------------------------------
+    // Private constructors
+    //-------------------------------------------------------------------------------------------------
+
+    //! Constructs a context parsing a single file for pParentContext
+    QMLTreeContext(QMLTreeContext* pParentContext);
+
     //-------------------------------------------------------------------------------------------------
     // Private control methods
     //-------------------------------------------------------------------------------------------------
@@ -328,16 +415,13 @@ private:
     int parseNextToken(UParserValue* LVAL);
 
     //!
-    int parseNumber (UParserValue* lval);
+    int parseNumber(QMLScope& tScope, UParserValue* LVAL);
 
     //!
-    int parseEscape();
+    int parseEscape(QMLScope& tScope);
 
     //!
-    int getChar();
-
-    //!
-    int ungetChar(int iChar);
+    static int keywordToken(const QChar* pText, int iLength);
 
     //-------------------------------------------------------------------------------------------------
     // Protected control methods
@@ -347,6 +431,18 @@ protected:
 
     EParseError parse_Internal();
 
+    //!
+    EParseError parse_Parallel();
+
+    //!
+    void parseFile_Worker(QMLFile* pFile, const QString& sFolder, bool bImport);
+
+    //!
+    void scheduleImport(QMLFile* pImporter, const QString& sFileName, const QString& sFolder);
+
+    //!
+    void orderFiles(QMLFile* pFile, const QSet<QMLFile*>& sKnownFiles, QSet<QMLFile*>& sVisitedFiles, QVector<QMLFile*>& vOrderedFiles);
+
     //-------------------------------------------------------------------------------------------------
     // Properties
     //-------------------------------------------------------------------------------------------------
@@ -356,11 +452,17 @@ protected:
     EParseError             m_eError;
     QMLAnalyzerError        m_tErrorObject;
     QString                 m_sFolder;
-    QMap<QString, int>      m_mTokens;
     QVector<QMLFile*>       m_vFiles;
     QStack<QMLScope*>       m_sScopes;
     QString                 m_sText;
     bool                    m_bIncludeImports;
-
-    static QStringList      s_lOperators;
+    int                     m_iMaxThreads;
+    QMLTreeContext*         m_pParentContext;       // Set on the per-file contexts of a parallel parse
+    QThreadPool*            m_pThreadPool;          // Only valid during a parallel parse
+    QMutex                  m_mFilesMutex;          // Guards m_vFiles, m_mImports, m_sScheduledFiles and m_mFileErrors while workers run
+    QMap<QMLFile*, QVector<QMLFile*> >  m_mImports;
+    QSet<QMLFile*>          m_sScheduledFiles;
+    QMap<QString, QMLAnalyzerError>     m_mFileErrors;
+    QMLTreeCache            m_tCache;
+    QMLNameTable            m_tNames;               // Interned identifier names, only used on the root context
 };
@@ -4,6 +4,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLType::instantiator()
+{
+    return new QMLType(QPoint());
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLType::QMLType(const QPoint& pPosition)
     : QMLEntity(pPosition)
     , m_vType(QVariant::Invalid)
@@ -49,13 +56,11 @@ void QMLType::toQML(QTextStream& stream, QMLFormatter& formatter, const QMLEntit
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLType::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLType::writeXMLAttributes(QMLXMLWriter& tWriter)
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
+    QMLEntity::writeXMLAttributes(tWriter);
 
-    xNode.attributes()["Type"] = typeToString(m_vType);
-
-    return xNode;
+    tWriter.setAttribute("Type", typeToString(m_vType));
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -115,3 +120,25 @@ QMLType* QMLType::fromQMLEntity(QMLEntity* pEntity)
 
     return new QMLType(QPoint(), QVariant::Invalid);
 }
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLType::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLEntity::serialize(stream, pTracker);
+
+    stream << qint32(m_vType);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLType::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
+
+    qint32 iType = 0;
+
+    stream >> iType;
+
+    m_vType = QVariant::Type(iType);
+}
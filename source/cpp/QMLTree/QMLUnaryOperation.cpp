@@ -7,6 +7,13 @@
 
 //-------------------------------------------------------------------------------------------------
 
+QMLEntity* QMLUnaryOperation::instantiator()
+{
+    return new QMLUnaryOperation(QPoint(), nullptr, uoNone);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QMLUnaryOperation::QMLUnaryOperation(const QPoint& pPosition, QMLEntity* pExpression, EUnaryOperator eOperator, bool bIsPostFix)
     : QMLEntity(pPosition)
     , m_pExpression(pExpression)
@@ -74,13 +81,9 @@ QString QMLUnaryOperation::operatorToString(EUnaryOperator eOperator) const
 
 //-------------------------------------------------------------------------------------------------
 
-QMap<QString, QMLEntity*> QMLUnaryOperation::members()
+void QMLUnaryOperation::visitMembers(QMLMemberVisitor& tVisitor)
 {
-    QMap<QString, QMLEntity*> vReturnValue;
-
-    vReturnValue["expression"] = m_pExpression;
-
-    return vReturnValue;
+    tVisitor.visit("expression", m_pExpression);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -144,17 +147,44 @@ void QMLUnaryOperation::toQML(QTextStream& stream, QMLFormatter& formatter, cons
 
 //-------------------------------------------------------------------------------------------------
 
-CXMLNode QMLUnaryOperation::toXMLNode(CXMLNodableContext* pContext, CXMLNodable* pParent)
+void QMLUnaryOperation::writeXMLAttributes(QMLXMLWriter& tWriter)
 {
-    CXMLNode xNode = QMLEntity::toXMLNode(pContext, pParent);
-    CXMLNode xExpression("Expression");
+    QMLEntity::writeXMLAttributes(tWriter);
 
-    xNode.attributes()["Operator"] = operatorToString(m_eOperator);
+    tWriter.setAttribute("Operator", operatorToString(m_eOperator));
+}
 
-    if (m_pExpression != nullptr)
-        xExpression.nodes() << m_pExpression->toXMLNode(pContext, this);
+//-------------------------------------------------------------------------------------------------
+
+void QMLUnaryOperation::writeXMLChildren(QMLXMLWriter& tWriter, CXMLNodableContext* pContext)
+{
+    writeXMLMember(tWriter, pContext, "Expression", m_pExpression);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLUnaryOperation::serialize(QDataStream& stream, CObjectTracker* pTracker) const
+{
+    QMLEntity::serialize(stream, pTracker);
+
+    serializeEntity(stream, pTracker, m_pExpression);
+    stream << qint32(m_eOperator);
+    stream << m_bIsPostFix;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLUnaryOperation::deserialize(QDataStream& stream, CObjectTracker* pTracker, QObject* pRootObject)
+{
+    QMLEntity::deserialize(stream, pTracker, pRootObject);
+
+    qint32 iOperator = 0;
+
+    m_pExpression = deserializeEntity(stream, pTracker, pRootObject);
+    stream >> iOperator;
+    stream >> m_bIsPostFix;
 
-    xNode.nodes() << xExpression;
+    m_eOperator = EUnaryOperator(iOperator);
 
-    return xNode;
+    if (m_pExpression != nullptr) m_pExpression->setParent(this);
 }
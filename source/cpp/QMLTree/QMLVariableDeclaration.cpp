@@ -6,6 +6,16 @@
 
 //-------------------------------------------------------------------------------------------------
 
+/*!
+    Instantiates a new QMLVariableDeclaration.
+*/
+QMLEntity* QMLVariableDeclaration::instantiator()
+{
+    return new QMLVariableDeclaration(QPoint());
+}
+
+//-------------------------------------------------------------------------------------------------
+
 /*!
     Constructs a QMLVariableDeclaration. \br\br
     \a pPosition is the position of the token in the file \br
@@ -26,6 +26,9 @@ public:
     // Constructors and destructor
     //-------------------------------------------------------------------------------------------------
 
+    //! Instantiates a new QMLVariableDeclaration
+    static QMLEntity* instantiator();
+
     //! Constructor with filename
     QMLVariableDeclaration(const QPoint& pPosition);
 
@@ -0,0 +1,174 @@
+
+// Application
+#include "QMLXMLWriter.h"
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    \class QMLXMLWriter
+    \inmodule qt-plus
+    \brief The output of QMLEntity::writeXML(). \br
+    Entities describe themselves as elements and attributes, which QMLXMLNodeWriter turns into a CXMLNode tree
+    and QMLXMLStreamWriter writes to a QXmlStreamWriter. Both produce the same XML, but the stream writer only
+    keeps the element being written in memory.
+*/
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Constructs a QMLXMLWriter.
+*/
+QMLXMLWriter::QMLXMLWriter()
+    : m_bPending(false)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Destroys a QMLXMLWriter.
+*/
+QMLXMLWriter::~QMLXMLWriter()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Opens an element named \a sTag, child of the current element.
+*/
+void QMLXMLWriter::startElement(const QString& sTag)
+{
+    flushElement();
+
+    m_bPending = true;
+    m_sPendingTag = sTag;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Sets the attribute \a sName of the current element to \a sValue, replacing any previous value. \br\br
+    Attributes set after the first child element of the current element are ignored.
+*/
+void QMLXMLWriter::setAttribute(const QString& sName, const QString& sValue)
+{
+    if (m_bPending)
+    {
+        m_mPendingAttributes[sName] = sValue;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Closes the current element.
+*/
+void QMLXMLWriter::endElement()
+{
+    flushElement();
+    writeEndElement();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLXMLWriter::flushElement()
+{
+    if (m_bPending)
+    {
+        writeStartElement(m_sPendingTag, m_mPendingAttributes);
+
+        m_bPending = false;
+        m_sPendingTag.clear();
+        m_mPendingAttributes.clear();
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    \class QMLXMLNodeWriter
+    \inmodule qt-plus
+    \brief Builds a CXMLNode tree from the elements it receives.
+*/
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Constructs a QMLXMLNodeWriter.
+*/
+QMLXMLNodeWriter::QMLXMLNodeWriter()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Returns the root node.
+*/
+const CXMLNode& QMLXMLNodeWriter::root() const
+{
+    return m_xRoot;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLXMLNodeWriter::writeStartElement(const QString& sTag, const QMap<QString, QString>& mAttributes)
+{
+    CXMLNode xNode(sTag);
+    xNode.attributes() = mAttributes;
+
+    m_vOpenNodes << xNode;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLXMLNodeWriter::writeEndElement()
+{
+    if (m_vOpenNodes.isEmpty())
+        return;
+
+    CXMLNode xNode = m_vOpenNodes.takeLast();
+
+    if (m_vOpenNodes.isEmpty())
+        m_xRoot = xNode;
+    else
+        m_vOpenNodes.last().nodes() << xNode;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    \class QMLXMLStreamWriter
+    \inmodule qt-plus
+    \brief Writes the elements it receives to a QXmlStreamWriter.
+*/
+
+//-------------------------------------------------------------------------------------------------
+
+/*!
+    Constructs a QMLXMLStreamWriter writing to \a xStream.
+*/
+QMLXMLStreamWriter::QMLXMLStreamWriter(QXmlStreamWriter& xStream)
+    : m_xStream(xStream)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLXMLStreamWriter::writeStartElement(const QString& sTag, const QMap<QString, QString>& mAttributes)
+{
+    m_xStream.writeStartElement(sTag);
+
+    for (QMap<QString, QString>::const_iterator iter = mAttributes.constBegin(); iter != mAttributes.constEnd(); ++iter)
+    {
+        m_xStream.writeAttribute(iter.key(), iter.value());
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLXMLStreamWriter::writeEndElement()
+{
+    m_xStream.writeEndElement();
+}
@@ -0,0 +1,118 @@
+
+#pragma once
+
+#include "../qtplus_global.h"
+
+//-------------------------------------------------------------------------------------------------
+
+// Qt
+#include <QString>
+#include <QMap>
+#include <QVector>
+#include <QXmlStreamWriter>
+
+// Library
+#include "../CXMLNode.h"
+
+//-------------------------------------------------------------------------------------------------
+
+//! Receives the XML representation of entities, one element at a time
+//! Attributes of an element are collected until its first child or its end, then handed over sorted by name
+class QTPLUSSHARED_EXPORT QMLXMLWriter
+{
+public:
+
+    //-------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    //-------------------------------------------------------------------------------------------------
+
+    //! Constructor
+    QMLXMLWriter();
+
+    //! Destructor
+    virtual ~QMLXMLWriter();
+
+    //-------------------------------------------------------------------------------------------------
+    // Control methods
+    //-------------------------------------------------------------------------------------------------
+
+    //! Opens a child element of the current one
+    void startElement(const QString& sTag);
+
+    //! Sets an attribute of the current element, must be called before its first child
+    void setAttribute(const QString& sName, const QString& sValue);
+
+    //! Closes the current element
+    void endElement();
+
+    //-------------------------------------------------------------------------------------------------
+    // Protected control methods
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! Called when an element and its attributes are complete
+    virtual void writeStartElement(const QString& sTag, const QMap<QString, QString>& mAttributes) = 0;
+
+    //! Called when an element is closed
+    virtual void writeEndElement() = 0;
+
+    //! Hands over the pending element, if any
+    void flushElement();
+
+    //-------------------------------------------------------------------------------------------------
+    // Properties
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    bool                    m_bPending;
+    QString                 m_sPendingTag;
+    QMap<QString, QString>  m_mPendingAttributes;
+};
+
+//-------------------------------------------------------------------------------------------------
+
+//! Builds a CXMLNode tree
+class QTPLUSSHARED_EXPORT QMLXMLNodeWriter : public QMLXMLWriter
+{
+public:
+
+    //! Constructor
+    QMLXMLNodeWriter();
+
+    //! Returns the root node, complete once all elements are closed
+    const CXMLNode& root() const;
+
+protected:
+
+    virtual void writeStartElement(const QString& sTag, const QMap<QString, QString>& mAttributes) Q_DECL_OVERRIDE;
+
+    virtual void writeEndElement() Q_DECL_OVERRIDE;
+
+protected:
+
+    QVector<CXMLNode>       m_vOpenNodes;
+    CXMLNode                m_xRoot;
+};
+
+//-------------------------------------------------------------------------------------------------
+
+//! Writes elements to a QXmlStreamWriter as soon as they are complete
+class QTPLUSSHARED_EXPORT QMLXMLStreamWriter : public QMLXMLWriter
+{
+public:
+
+    //! Constructor
+    QMLXMLStreamWriter(QXmlStreamWriter& xStream);
+
+protected:
+
+    virtual void writeStartElement(const QString& sTag, const QMap<QString, QString>& mAttributes) Q_DECL_OVERRIDE;
+
+    virtual void writeEndElement() Q_DECL_OVERRIDE;
+
+protected:
+
+    QXmlStreamWriter&       m_xStream;
+};
@@ -0,0 +1,234 @@
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QXmlStreamWriter>
+#include <QFile>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+#include "../QMLTree/QMLTreeContext.h"
+#include "../QMLTree/QMLAnalyzer.h"
+#include "../QMLTree/QMLFormatter.h"
+#include "../QMLTree/QMLCorpusGenerator.h"
+
+QString sGrammarFile = "../source/misc/CodingRules.xml";
+QString sFormatFile = "../source/misc/Format.xml";
+
+// Resets the peak resident memory so that the next stage measures its own, returns false if the system can not
+bool resetPeakMemory()
+{
+#if defined(Q_OS_LINUX)
+    // Writing 5 to clear_refs resets VmHWM to the current resident size
+    QFile file("/proc/self/clear_refs");
+
+    if (file.open(QFile::WriteOnly | QFile::Unbuffered))
+        return file.write("5") == 1;
+#endif
+
+    return false;
+}
+
+// Returns the peak resident memory of the process in bytes, since the last resetPeakMemory() if it succeeded, -1 if unknown
+qint64 peakMemoryBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS tCounters;
+
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &tCounters, sizeof(tCounters)))
+        return qint64(tCounters.PeakWorkingSetSize);
+#elif defined(Q_OS_LINUX)
+    QFile file("/proc/self/status");
+
+    if (file.open(QFile::ReadOnly))
+    {
+        for (QByteArray baLine = file.readLine(); baLine.isEmpty() == false; baLine = file.readLine())
+        {
+            if (baLine.startsWith("VmHWM:"))
+                return baLine.mid(6).trimmed().split(' ').first().toLongLong() * 1024;
+        }
+    }
+#endif
+
+    return -1;
+}
+
+// Prints the figures of a stage, bStagePeak tells whether the peak memory was reset when it started
+void report(QTextStream& out, const QString& sStage, qint64 iLines, qint64 iNanoSeconds, bool bStagePeak)
+{
+    double dSeconds = double(iNanoSeconds) / 1e9;
+    double dLinesPerSecond = dSeconds > 0.0 ? double(iLines) / dSeconds : 0.0;
+    qint64 iPeakMemory = peakMemoryBytes();
+
+    out << sStage.leftJustified(12)
+        << QString::number(dSeconds * 1000.0, 'f', 1).rightJustified(12) << " ms"
+        << QString::number(dLinesPerSecond, 'f', 0).rightJustified(14) << " lines/s"
+        << (iPeakMemory >= 0 ? QString::number(iPeakMemory / (1024 * 1024)).rightJustified(10) + (bStagePeak ? " MB stage peak" : " MB process peak") : QString("  peak memory unknown"))
+        << "\n";
+
+    out.flush();
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures the throughput of the QML tools on a synthetic corpus");
+    parser.addHelpOption();
+
+    QCommandLineOption tFiles("files", "Number of files.", "count", "50");
+    QCommandLineOption tDepth("depth", "Nesting depth of items.", "count", "4");
+    QCommandLineOption tChildren("children", "Child items of each item.", "count", "3");
+    QCommandLineOption tProperties("properties", "Properties of each item.", "count", "4");
+    QCommandLineOption tFunctions("functions", "Functions of each item.", "count", "1");
+    QCommandLineOption tStatements("statements", "Statements of each function.", "count", "6");
+    QCommandLineOption tImports("imports", "Imports of each file.", "count", "2");
+    QCommandLineOption tComments("comments", "Percentage of commented declarations.", "percent", "20");
+    QCommandLineOption tSeed("seed", "Seed of the generator.", "value", QString::number(CORPUS_DEFAULT_SEED));
+    QCommandLineOption tThreads("threads", "Threads used for parsing and analysis.", "count", "1");
+    QCommandLineOption tGrammar("grammar", "Analyzer grammar file.", "file", sGrammarFile);
+    QCommandLineOption tFormat("format", "Formatter definition file.", "file", sFormatFile);
+    QCommandLineOption tOutput("output", "Keeps the corpus in this folder.", "folder");
+
+    parser.addOptions({ tFiles, tDepth, tChildren, tProperties, tFunctions, tStatements, tImports, tComments, tSeed, tThreads, tGrammar, tFormat, tOutput });
+    parser.process(app);
+
+    QMLCorpusGenerator generator;
+    generator.setFileCount(parser.value(tFiles).toInt());
+    generator.setDepth(parser.value(tDepth).toInt());
+    generator.setChildrenPerItem(parser.value(tChildren).toInt());
+    generator.setPropertiesPerItem(parser.value(tProperties).toInt());
+    generator.setFunctionsPerItem(parser.value(tFunctions).toInt());
+    generator.setStatementsPerFunction(parser.value(tStatements).toInt());
+    generator.setImportsPerFile(parser.value(tImports).toInt());
+    generator.setCommentPercent(parser.value(tComments).toInt());
+    generator.setSeed(parser.value(tSeed).toUInt());
+
+    int iThreads = qMax(1, parser.value(tThreads).toInt());
+
+    QTemporaryDir tTemporaryDir;
+    QString sFolder = parser.isSet(tOutput) ? parser.value(tOutput) : tTemporaryDir.path();
+    QStringList lFileNames = generator.generate(sFolder);
+
+    QTextStream out(stdout);
+
+    if (lFileNames.isEmpty())
+    {
+        out << "Could not write the corpus in " << sFolder << "\n";
+        return 1;
+    }
+
+    QStringList lTexts;
+    qint64 iLines = 0;
+
+    for (int iIndex = 0; iIndex < lFileNames.count(); iIndex++)
+    {
+        lTexts << generator.generateFile(iIndex);
+        iLines += lTexts.last().count('\n');
+    }
+
+    out << lFileNames.count() << " files, " << iLines << " lines in " << sFolder << "\n\n";
+
+    QElapsedTimer tTimer;
+    bool bStagePeak = false;
+
+    // Lexing
+    {
+        QMLTreeContext tContext;
+
+        bStagePeak = resetPeakMemory();
+        tTimer.start();
+
+        for (const QString& sText : lTexts)
+        {
+            tContext.tokenize(sText);
+        }
+
+        report(out, "Lexing", iLines, tTimer.nsecsElapsed(), bStagePeak);
+    }
+
+    // Parsing, kept for formatting and export
+    QMLTreeContext tContext;
+    tContext.setMaxThreads(iThreads);
+
+    for (const QString& sFileName : lFileNames)
+    {
+        tContext.addFile(sFileName);
+    }
+
+    bStagePeak = resetPeakMemory();
+    tTimer.start();
+    QMLTreeContext::EParseError eError = tContext.parse();
+    report(out, "Parsing", iLines, tTimer.nsecsElapsed(), bStagePeak);
+
+    if (eError != QMLTreeContext::peSuccess)
+    {
+        out << "Parse error : " << tContext.errorString() << "\n";
+        return 1;
+    }
+
+    out << tContext.names().internCount() << " identifiers, " << tContext.names().count() << " distinct names in "
+        << tContext.names().tableBytes() / 1024 << " KB, " << tContext.names().savedBytes() / 1024 << " KB saved by interning\n";
+
+    // Analysis, which parses the files again
+    {
+        QMLAnalyzer tAnalyzer;
+        tAnalyzer.setFolder(sFolder);
+        tAnalyzer.setMaxThreads(iThreads);
+
+        CXMLNode xGrammar = CXMLNode::load(parser.value(tGrammar));
+
+        bStagePeak = resetPeakMemory();
+        tTimer.start();
+        tAnalyzer.analyze(xGrammar);
+        report(out, "Analysis", iLines, tTimer.nsecsElapsed(), bStagePeak);
+
+        out << tAnalyzer.errors().count() << " analyzer errors\n";
+    }
+
+    // Formatting
+    {
+        QMLFormatter formatter;
+        formatter.setGrammar(CXMLNode::load(parser.value(tFormat)));
+
+        bStagePeak = resetPeakMemory();
+        tTimer.start();
+
+        for (QMLFile* pFile : tContext.files())
+        {
+            QString sText;
+            QTextStream stream(&sText);
+
+            pFile->toQML(stream, formatter);
+            stream.flush();
+        }
+
+        report(out, "Formatting", iLines, tTimer.nsecsElapsed(), bStagePeak);
+    }
+
+    // XML export
+    {
+        bStagePeak = resetPeakMemory();
+        tTimer.start();
+
+        for (QMLFile* pFile : tContext.files())
+        {
+            QString sText;
+            QXmlStreamWriter xStream(&sText);
+
+            xStream.writeStartDocument();
+            pFile->toXMLStream(xStream, &tContext);
+            xStream.writeEndDocument();
+        }
+
+        report(out, "XML export", iLines, tTimer.nsecsElapsed(), bStagePeak);
+    }
+
+    return 0;
+}
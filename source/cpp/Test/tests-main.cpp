@@ -202,7 +202,7 @@ void TestRunner::runQMLTreeTests()
     {
         if (pContext->files().count() > 0)
         {
-            pContext->files().first()->toXMLNode(pContext, nullptr).saveXMLToFile("Test_Output.xml");
+            pContext->files().first()->saveXMLToFile("Test_Output.xml", pContext);
 
             QFile file("Test_Output.qml");
 
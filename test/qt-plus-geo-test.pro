@@ -0,0 +1,42 @@
+
+QT += core testlib
+
+# The library only builds its QGeoCoordinate methods with Qt Positioning on Windows
+win32 {
+    QT += positioning
+}
+
+CONFIG += console
+
+TEMPLATE = app
+
+# Dependencies
+INCLUDEPATH += $$PWD/../source/cpp
+DEPENDPATH += $$PWD/../source
+
+# Directories
+DESTDIR = $$PWD/../bin
+OBJECTS_DIR = $$PWD/obj/qt-plus-geo-test
+MOC_DIR = $$PWD/moc/qt-plus-geo-test
+RCC_DIR = $$PWD/rcc/qt-plus-geo-test
+
+# Target
+CONFIG(debug, debug|release) {
+    TARGET = qt-plus-geo-testd
+} else {
+    TARGET = qt-plus-geo-test
+}
+
+# Libraries
+CONFIG(debug, debug|release) {
+    LIBS += -L$$PWD/../bin -lqt-plusd
+} else {
+    LIBS += -L$$PWD/../bin -lqt-plus
+}
+
+# Code
+SOURCES += \
+    source/CGeoTests.cpp
+
+HEADERS += \
+    source/CGeoTests.h
@@ -34,7 +34,11 @@ CONFIG(debug, debug|release) {
 
 # Code
 SOURCES += \
-    source/CUnitTests.cpp
+    source/CUnitTests.cpp \
+    source/QMLReferenceLexer.cpp \
+    source/QMLReferenceFormatter.cpp
 
 HEADERS += \
-    source/CUnitTests.h
+    source/CUnitTests.h \
+    source/QMLReferenceLexer.h \
+    source/QMLReferenceFormatter.h
@@ -0,0 +1,962 @@
+
+#include <math.h>
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+#ifdef QT_POSITIONING_LIB
+#include <QGeoCoordinate>
+#endif
+
+#include "CGeoUtilities.h"
+#include "CGeoReferenceFrame.h"
+#include "GeoTools/geocent.h"
+#include "GeoTools/geobatch.h"
+#include "GeoTools/utm.h"
+#include "GeoTools/ups.h"
+#include "GeoTools/mgrs.h"
+#include "GeoTools/polarst.h"
+#include "GeoTools/tranmerc.h"
+#include "GeoTools/coordcnv.h"
+#include "GeoTools/geotrans.h"
+#include "GeoTools/UtmMgrs.h"
+
+#include "CGeoTests.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+// WGS 84
+const double WGS84_A = 6378137.0;
+const double WGS84_F = 1.0 / 298.257223563;
+
+// International 1924
+const double INTL_A = 6378388.0;
+const double INTL_F = 1.0 / 297.0;
+
+// The values of the *Reference() tests were computed with PROJ, through its pyproj Python binding, for the ellipsoid,
+// projection and parameters of each test, then rounded to 0.1 mm. They are literals : the tests need neither PROJ nor Python
+
+// Tolerances, in meters
+const double PROJECTION_TOLERANCE = 0.001;      // Projections against PROJ and their own inverse
+const double UPS_TOLERANCE = 0.02;              // UPS uses a latitude of true scale instead of the 0.994 scale factor
+const double GEOCENTRIC_TOLERANCE = 0.01;       // Inverse geocentric conversion, up to 1000 km above the ellipsoid
+const double GEOSTATIONARY_TOLERANCE = 0.5;     // Inverse geocentric conversion, at the geostationary altitude
+const double MGRS_TOLERANCE = 1.5;              // 1 meter precision strings
+const double VECTOR3D_TOLERANCE = 5.0;          // QVector3D and QMatrix4x4 hold floats
+
+// Conversion paths measured by CGeoTests::throughput()
+enum EConversion
+{
+    cGeodeticToGeocentric,
+    cGeocentricToGeodetic,
+    cGeodeticToGeocentricBatch,
+    cGeocentricToGeodeticBatch,
+    cGeodeticToLocalENU,
+    cGeodeticToUTM,
+    cUTMToGeodetic,
+    cGeodeticToUTMBatch,
+    cUTMToGeodeticBatch,
+    cGeodeticToUTMThreads,
+    cGeodeticToMGRS,
+    cMGRSToGeodetic,
+    cGeodeticToMGRSBatch,
+    cMGRSToGeodeticBatch,
+    cGeodeticToUPS,
+    cUPSToGeodetic,
+    cGeodeticToPolarStereographic,
+    cGeodeticToTransverseMercator,
+    cGeoCoordinateToVector3D
+};
+
+// Returns the distance in meters between two close geodetic points, in radians
+double groundDistance(double dLatitude1, double dLongitude1, double dLatitude2, double dLongitude2)
+{
+    double dNorth = (dLatitude2 - dLatitude1) * WGS84_A;
+    double dEast = remainder(dLongitude2 - dLongitude1, 2.0 * M_PI) * WGS84_A * cos(dLatitude1);
+
+    return sqrt(dNorth * dNorth + dEast * dEast);
+}
+
+// Fills vLatitudes and vLongitudes with a grid of points, in radians, bounds included
+void makeGrid(double dMinLatitude, double dMaxLatitude, double dLatitudeStep, double dMinLongitude, double dMaxLongitude, double dLongitudeStep,
+              QVector<double>& vLatitudes, QVector<double>& vLongitudes)
+{
+    vLatitudes.clear();
+    vLongitudes.clear();
+
+    for (double dLatitude = dMinLatitude; dLatitude <= dMaxLatitude + 1e-9; dLatitude += dLatitudeStep)
+    {
+        for (double dLongitude = dMinLongitude; dLongitude <= dMaxLongitude + 1e-9; dLongitude += dLongitudeStep)
+        {
+            vLatitudes << qMin(dLatitude, dMaxLatitude) * DEG_TO_RAD;
+            vLongitudes << qMin(dLongitude, dMaxLongitude) * DEG_TO_RAD;
+        }
+    }
+}
+
+}
+
+//-------------------------------------------------------------------------------------------------
+
+CGeoTests::CGeoTests()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+CGeoTests::~CGeoTests()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::geocentricReference()
+{
+    // Latitude, longitude, height, X, Y, Z
+    const double dReferences[][6] = {
+        { 0.0, 0.0, 0.0, 6378137.0000, 0.0000, 0.0000 },
+        { 90.0, 0.0, 0.0, 0.0000, 0.0000, 6356752.3142 },
+        { -90.0, 0.0, 0.0, 0.0000, 0.0000, -6356752.3142 },
+        { 45.0, 45.0, 1000.0, 3194919.1451, 3194919.1451, 4488055.5156 },
+        { -33.9, 151.2, -100.0, -4643873.2929, 2552990.9470, -3537189.5734 },
+        { 10.0, -170.0, -6000.0, -6180617.9882, -1089809.7088, 1099206.6587 },
+        { 89.9999, -120.0, 10000.0, -5.5934, -9.6881, 6366752.3142 },
+        { 0.0, 180.0, 35786000.0, -42164137.0000, 0.0000, 0.0000 }
+    };
+
+    Geocentric_Context tContext;
+    Init_Geocentric_Context(&tContext);
+
+    for (const auto& dReference : dReferences)
+    {
+        double dX, dY, dZ;
+
+        QCOMPARE(Convert_Geodetic_To_Geocentric_Ctx(&tContext, dReference[0] * DEG_TO_RAD, dReference[1] * DEG_TO_RAD, dReference[2], &dX, &dY, &dZ), long(GEOCENT_NO_ERROR));
+        QVERIFY(qAbs(dX - dReference[3]) < PROJECTION_TOLERANCE);
+        QVERIFY(qAbs(dY - dReference[4]) < PROJECTION_TOLERANCE);
+        QVERIFY(qAbs(dZ - dReference[5]) < PROJECTION_TOLERANCE);
+    }
+
+    // Out of range
+    double dX, dY, dZ;
+
+    QCOMPARE(Convert_Geodetic_To_Geocentric_Ctx(&tContext, 91.0 * DEG_TO_RAD, 0.0, 0.0, &dX, &dY, &dZ), long(GEOCENT_LAT_ERROR));
+    QCOMPARE(Convert_Geodetic_To_Geocentric_Ctx(&tContext, 0.0, 361.0 * DEG_TO_RAD, 0.0, &dX, &dY, &dZ), long(GEOCENT_LON_ERROR));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::geocentricRoundTrips()
+{
+    const double dHeights[] = { -10000.0, 0.0, 1000.0, 10000.0, 100000.0, 1000000.0, 35786000.0 };
+
+    Geocentric_Context tContext;
+    Init_Geocentric_Context(&tContext);
+
+    QVector<double> vLatitudes, vLongitudes;
+    makeGrid(-90.0, 90.0, 0.5, -180.0, 180.0, 22.5, vLatitudes, vLongitudes);
+
+    for (double dHeight : dHeights)
+    {
+        double dTolerance = dHeight > 1000000.0 ? GEOSTATIONARY_TOLERANCE : GEOCENTRIC_TOLERANCE;
+
+        for (int iIndex = 0; iIndex < vLatitudes.count(); iIndex++)
+        {
+            double dX, dY, dZ, dLatitude, dLongitude, dBackHeight;
+
+            Convert_Geodetic_To_Geocentric_Ctx(&tContext, vLatitudes[iIndex], vLongitudes[iIndex], dHeight, &dX, &dY, &dZ);
+            Convert_Geocentric_To_Geodetic_Ctx(&tContext, dX, dY, dZ, &dLatitude, &dLongitude, &dBackHeight);
+
+            // The longitude is undefined at the poles
+            if (qAbs(vLatitudes[iIndex]) < M_PI / 2.0)
+                QVERIFY(groundDistance(vLatitudes[iIndex], vLongitudes[iIndex], dLatitude, dLongitude) < dTolerance);
+            else
+                QVERIFY(qAbs(dLatitude - vLatitudes[iIndex]) * WGS84_A < dTolerance);
+
+            QVERIFY(qAbs(dBackHeight - dHeight) < dTolerance);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::utmReference()
+{
+    // Zone edges, the equator, the antimeridian and the Norway and Svalbard exceptions
+    struct
+    {
+        double  dLatitude;
+        double  dLongitude;
+        long    iZone;
+        char    cHemisphere;
+        double  dEasting;
+        double  dNorthing;
+    }
+    const tReferences[] = {
+        { 0.0, 3.0, 31, 'N', 500000.0000, 0.0000 },
+        { 0.0, -177.0, 1, 'N', 500000.0000, 0.0000 },
+        { 0.0, 177.0, 60, 'N', 500000.0000, 0.0000 },
+        { 0.0001, 0.0, 31, 'N', 166021.4431, 11.0683 },
+        { -0.0001, 174.0, 60, 'S', 166021.4431, 9999988.9317 },
+        { -45.0, -0.0001, 30, 'S', 736438.1446, 5012670.7874 },
+        { 43.9397103, 3.1230947, 31, 'N', 509878.9964, 4865183.9958 },
+        { 45.5, -73.6, 18, 'N', 609377.3474, 5039449.7130 },
+        { -33.9, 151.2, 56, 'S', 333568.9410, 6247473.3368 },
+        { 51.5, -0.1, 30, 'N', 701277.6651, 5709417.1248 },
+        { 56.0, 3.0, 32, 'N', 126049.9707, 6222336.3353 },
+        { 60.0, 5.0, 32, 'N', 276979.9264, 6658157.2024 },
+        { 72.0, 40.0, 37, 'N', 534489.0185, 7989218.7546 },
+        { 78.0, 15.0, 33, 'N', 500000.0000, 8658369.5858 },
+        { 83.9, 10.0, 33, 'N', 440754.2778, 9319502.2688 },
+        { -79.9, -60.0, 21, 'S', 441292.5527, 1128062.1714 }
+    };
+
+    UTM_Context tContext;
+    Init_UTM_Context(&tContext);
+
+    for (const auto& tReference : tReferences)
+    {
+        long iZone;
+        char cHemisphere;
+        double dEasting, dNorthing;
+
+        QCOMPARE(Convert_Geodetic_To_UTM_Ctx(&tContext, tReference.dLatitude * DEG_TO_RAD, tReference.dLongitude * DEG_TO_RAD, &iZone, &cHemisphere, &dEasting, &dNorthing), long(UTM_NO_ERROR));
+        QCOMPARE(iZone, tReference.iZone);
+        QCOMPARE(cHemisphere, tReference.cHemisphere);
+        QVERIFY(qAbs(dEasting - tReference.dEasting) < PROJECTION_TOLERANCE);
+        QVERIFY(qAbs(dNorthing - tReference.dNorthing) < PROJECTION_TOLERANCE);
+
+        // The inverse only warns far from the central meridian near the poles
+        double dLatitude, dLongitude;
+
+        Convert_UTM_To_Geodetic_Ctx(&tContext, iZone, cHemisphere, dEasting, dNorthing, &dLatitude, &dLongitude);
+        QVERIFY(groundDistance(tReference.dLatitude * DEG_TO_RAD, tReference.dLongitude * DEG_TO_RAD, dLatitude, dLongitude) < PROJECTION_TOLERANCE);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::utmRoundTrips()
+{
+    UTM_Context tContext;
+    Init_UTM_Context(&tContext);
+
+    UTM_Zone_Cache tCache;
+    QCOMPARE(Init_UTM_Zone_Cache(&tCache, &tContext), long(UTM_NO_ERROR));
+
+    // Every zone, with points on their edges
+    QVector<double> vLatitudes, vLongitudes;
+    makeGrid(-80.0, 84.0, 0.5, -180.0, 179.75, 0.75, vLatitudes, vLongitudes);
+
+    long iCount = vLatitudes.count();
+    QVector<long> vZones(iCount), vCodes(iCount);
+    QVector<char> vHemispheres(iCount);
+    QVector<double> vEastings(iCount), vNorthings(iCount), vBackLatitudes(iCount), vBackLongitudes(iCount);
+
+    QCOMPARE(Convert_Geodetic_To_UTM_Batch(&tCache, iCount, vLatitudes.constData(), vLongitudes.constData(),
+                                           vZones.data(), vHemispheres.data(), vEastings.data(), vNorthings.data(), nullptr), long(UTM_NO_ERROR));
+
+    Convert_UTM_To_Geodetic_Batch(&tCache, iCount, vZones.constData(), vHemispheres.constData(), vEastings.constData(), vNorthings.constData(),
+                                  vBackLatitudes.data(), vBackLongitudes.data(), vCodes.data());
+
+    for (int iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        // Only the distortion warning of the inverse is expected, poleward of 56 degrees
+        QVERIFY(vCodes[iIndex] == UTM_NO_ERROR || (vCodes[iIndex] == UTM_EASTING_ERROR && qAbs(vLatitudes[iIndex]) >= 56.0 * DEG_TO_RAD));
+        QVERIFY(groundDistance(vLatitudes[iIndex], vLongitudes[iIndex], vBackLatitudes[iIndex], vBackLongitudes[iIndex]) < PROJECTION_TOLERANCE);
+
+        // The single conversions give the same results
+        if (iIndex % 97 == 0)
+        {
+            long iZone;
+            char cHemisphere;
+            double dEasting, dNorthing;
+
+            Convert_Geodetic_To_UTM_Ctx(&tContext, vLatitudes[iIndex], vLongitudes[iIndex], &iZone, &cHemisphere, &dEasting, &dNorthing);
+            QCOMPARE(iZone, vZones[iIndex]);
+            QCOMPARE(cHemisphere, vHemispheres[iIndex]);
+            QCOMPARE(dEasting, vEastings[iIndex]);
+            QCOMPARE(dNorthing, vNorthings[iIndex]);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::utmLimits()
+{
+    UTM_Context tContext;
+    Init_UTM_Context(&tContext);
+
+    long iZone;
+    char cHemisphere;
+    double dEasting, dNorthing, dLatitude, dLongitude;
+
+    // Latitude limits of UTM
+    QCOMPARE(Convert_Geodetic_To_UTM_Ctx(&tContext, 84.4 * DEG_TO_RAD, 0.0, &iZone, &cHemisphere, &dEasting, &dNorthing), long(UTM_NO_ERROR));
+    QCOMPARE(Convert_Geodetic_To_UTM_Ctx(&tContext, -80.4 * DEG_TO_RAD, 0.0, &iZone, &cHemisphere, &dEasting, &dNorthing), long(UTM_NO_ERROR));
+    QCOMPARE(Convert_Geodetic_To_UTM_Ctx(&tContext, 84.6 * DEG_TO_RAD, 0.0, &iZone, &cHemisphere, &dEasting, &dNorthing), long(UTM_LAT_ERROR));
+    QCOMPARE(Convert_Geodetic_To_UTM_Ctx(&tContext, -80.6 * DEG_TO_RAD, 0.0, &iZone, &cHemisphere, &dEasting, &dNorthing), long(UTM_LAT_ERROR));
+    QCOMPARE(Convert_Geodetic_To_UTM_Ctx(&tContext, 0.0, 361.0 * DEG_TO_RAD, &iZone, &cHemisphere, &dEasting, &dNorthing), long(UTM_LON_ERROR));
+
+    // Zones on both sides of a zone edge
+    QCOMPARE(Convert_Geodetic_To_UTM_Ctx(&tContext, 0.0, 6.0 * DEG_TO_RAD - 1e-9, &iZone, &cHemisphere, &dEasting, &dNorthing), long(UTM_NO_ERROR));
+    QCOMPARE(iZone, 31L);
+    QCOMPARE(Convert_Geodetic_To_UTM_Ctx(&tContext, 0.0, 6.0 * DEG_TO_RAD + 1e-9, &iZone, &cHemisphere, &dEasting, &dNorthing), long(UTM_NO_ERROR));
+    QCOMPARE(iZone, 32L);
+
+    // A zone override of a neighbour zone
+    QCOMPARE(Set_UTM_Parameters_Ctx(&tContext, WGS84_A, WGS84_F, 32), long(UTM_NO_ERROR));
+    QCOMPARE(Convert_Geodetic_To_UTM_Ctx(&tContext, 45.0 * DEG_TO_RAD, 5.0 * DEG_TO_RAD, &iZone, &cHemisphere, &dEasting, &dNorthing), long(UTM_NO_ERROR));
+    QCOMPARE(iZone, 32L);
+    QCOMPARE(Convert_UTM_To_Geodetic_Ctx(&tContext, iZone, cHemisphere, dEasting, dNorthing, &dLatitude, &dLongitude), long(UTM_NO_ERROR));
+    QVERIFY(groundDistance(45.0 * DEG_TO_RAD, 5.0 * DEG_TO_RAD, dLatitude, dLongitude) < PROJECTION_TOLERANCE);
+
+    // Invalid UTM coordinates
+    Init_UTM_Context(&tContext);
+
+    QCOMPARE(Convert_UTM_To_Geodetic_Ctx(&tContext, 0, 'N', 500000.0, 0.0, &dLatitude, &dLongitude), long(UTM_ZONE_ERROR));
+    QCOMPARE(Convert_UTM_To_Geodetic_Ctx(&tContext, 31, 'X', 500000.0, 0.0, &dLatitude, &dLongitude), long(UTM_HEMISPHERE_ERROR));
+    QCOMPARE(Convert_UTM_To_Geodetic_Ctx(&tContext, 31, 'N', 50000.0, 0.0, &dLatitude, &dLongitude), long(UTM_EASTING_ERROR));
+    QCOMPARE(Convert_UTM_To_Geodetic_Ctx(&tContext, 31, 'N', 500000.0, -1.0, &dLatitude, &dLongitude), long(UTM_NORTHING_ERROR));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::upsReference()
+{
+    // Latitude, longitude, easting, northing
+    const double dReferences[][4] = {
+        { 90.0, 0.0, 2000000.0000, 2000000.0000 },
+        { 85.0, 45.0, 2392767.6881, 1607232.3119 },
+        { 84.0, -120.0, 1422596.8712, 2333363.8518 },
+        { -90.0, 0.0, 2000000.0000, 2000000.0000 },
+        { -80.0, 10.0, 2193261.9368, 3096042.9084 },
+        { -85.0, 179.9, 2000969.4555, 1444543.4546 }
+    };
+
+    UPS_Context tContext;
+    Init_UPS_Context(&tContext);
+
+    for (const auto& dReference : dReferences)
+    {
+        char cHemisphere;
+        double dEasting, dNorthing;
+
+        QCOMPARE(Convert_Geodetic_To_UPS_Ctx(&tContext, dReference[0] * DEG_TO_RAD, dReference[1] * DEG_TO_RAD, &cHemisphere, &dEasting, &dNorthing), long(UPS_NO_ERROR));
+        QCOMPARE(cHemisphere, dReference[0] > 0.0 ? 'N' : 'S');
+        QVERIFY(qAbs(dEasting - dReference[2]) < UPS_TOLERANCE);
+        QVERIFY(qAbs(dNorthing - dReference[3]) < UPS_TOLERANCE);
+    }
+
+    // UPS only covers the polar caps
+    char cHemisphere;
+    double dEasting, dNorthing;
+
+    QCOMPARE(Convert_Geodetic_To_UPS_Ctx(&tContext, 83.0 * DEG_TO_RAD, 0.0, &cHemisphere, &dEasting, &dNorthing), long(UPS_LAT_ERROR));
+    QCOMPARE(Convert_Geodetic_To_UPS_Ctx(&tContext, -79.0 * DEG_TO_RAD, 0.0, &cHemisphere, &dEasting, &dNorthing), long(UPS_LAT_ERROR));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::upsRoundTrips()
+{
+    UPS_Context tContext;
+    Init_UPS_Context(&tContext);
+
+    QVector<double> vNorthLatitudes, vNorthLongitudes, vSouthLatitudes, vSouthLongitudes;
+    makeGrid(83.6, 90.0, 0.2, -180.0, 180.0, 5.0, vNorthLatitudes, vNorthLongitudes);
+    makeGrid(-90.0, -79.6, 0.2, -180.0, 180.0, 5.0, vSouthLatitudes, vSouthLongitudes);
+
+    QVector<double> vLatitudes = vNorthLatitudes + vSouthLatitudes;
+    QVector<double> vLongitudes = vNorthLongitudes + vSouthLongitudes;
+
+    for (int iIndex = 0; iIndex < vLatitudes.count(); iIndex++)
+    {
+        char cHemisphere;
+        double dEasting, dNorthing, dLatitude, dLongitude;
+
+        QCOMPARE(Convert_Geodetic_To_UPS_Ctx(&tContext, vLatitudes[iIndex], vLongitudes[iIndex], &cHemisphere, &dEasting, &dNorthing), long(UPS_NO_ERROR));
+        QCOMPARE(Convert_UPS_To_Geodetic_Ctx(&tContext, cHemisphere, dEasting, dNorthing, &dLatitude, &dLongitude), long(UPS_NO_ERROR));
+
+        if (qAbs(vLatitudes[iIndex]) < M_PI / 2.0)
+            QVERIFY(groundDistance(vLatitudes[iIndex], vLongitudes[iIndex], dLatitude, dLongitude) < PROJECTION_TOLERANCE);
+        else
+            QVERIFY(qAbs(dLatitude - vLatitudes[iIndex]) * WGS84_A < PROJECTION_TOLERANCE);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::polarStereographicReference()
+{
+    // Latitude of true scale, longitude down from pole, then latitude, longitude, easting, northing
+    const double dReferences[][6] = {
+        { 70.0, -45.0, 75.0, -45.0, 0.0000, -1633879.4975 },
+        { 70.0, -45.0, 80.0, 0.0, 767861.6061, -767861.6061 },
+        { 70.0, -45.0, 89.0, 100.0, 62135.5122, 88738.7079 },
+        { 70.0, -45.0, 60.0, -170.0, -2722173.5292, 1906086.4255 },
+        { -71.0, 0.0, -75.0, 0.0, 0.0000, 1638783.2384 },
+        { -71.0, 0.0, -80.0, 90.0, 1089179.4556, 0.0000 },
+        { -71.0, 0.0, -89.0, -100.0, -107004.3740, -18867.7582 },
+        { -71.0, 0.0, -65.0, 170.0, 479008.8371, -2716594.1091 }
+    };
+
+    Polar_Stereographic_Context tContext;
+    Init_Polar_Stereographic_Context(&tContext);
+
+    for (const auto& dReference : dReferences)
+    {
+        double dEasting, dNorthing, dLatitude, dLongitude;
+
+        QCOMPARE(Set_Polar_Stereographic_Parameters_Ctx(&tContext, WGS84_A, WGS84_F, dReference[0] * DEG_TO_RAD, dReference[1] * DEG_TO_RAD, 0.0, 0.0), long(POLAR_NO_ERROR));
+        QCOMPARE(Convert_Geodetic_To_Polar_Stereographic_Ctx(&tContext, dReference[2] * DEG_TO_RAD, dReference[3] * DEG_TO_RAD, &dEasting, &dNorthing), long(POLAR_NO_ERROR));
+        QVERIFY(qAbs(dEasting - dReference[4]) < PROJECTION_TOLERANCE);
+        QVERIFY(qAbs(dNorthing - dReference[5]) < PROJECTION_TOLERANCE);
+
+        QCOMPARE(Convert_Polar_Stereographic_To_Geodetic_Ctx(&tContext, dEasting, dNorthing, &dLatitude, &dLongitude), long(POLAR_NO_ERROR));
+        QVERIFY(groundDistance(dReference[2] * DEG_TO_RAD, dReference[3] * DEG_TO_RAD, dLatitude, dLongitude) < PROJECTION_TOLERANCE);
+    }
+
+    // The other hemisphere is out of range
+    double dEasting, dNorthing;
+
+    QVERIFY(Convert_Geodetic_To_Polar_Stereographic_Ctx(&tContext, 10.0 * DEG_TO_RAD, 0.0, &dEasting, &dNorthing) & POLAR_LAT_ERROR);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::transverseMercatorReference()
+{
+    // Latitude, longitude, easting, northing, with the origin and scale of the British national grid
+    const double dReferences[][4] = {
+        { 50.0, -1.0, 471666.5387, 11654.1761 },
+        { 55.0, -4.0, 272071.6459, 569165.7766 },
+        { 52.0, 1.5, 640241.1176, 239368.2545 },
+        { 58.0, -7.0, 104618.2135, 912196.5541 }
+    };
+
+    Transverse_Mercator_Context tContext;
+    Init_Transverse_Mercator_Context(&tContext);
+
+    QCOMPARE(Set_Transverse_Mercator_Parameters_Ctx(&tContext, WGS84_A, WGS84_F, 49.0 * DEG_TO_RAD, -2.0 * DEG_TO_RAD, 400000.0, -100000.0, 0.9996012717), long(TRANMERC_NO_ERROR));
+
+    for (const auto& dReference : dReferences)
+    {
+        double dEasting, dNorthing, dLatitude, dLongitude;
+
+        QCOMPARE(Convert_Geodetic_To_Transverse_Mercator_Ctx(&tContext, dReference[0] * DEG_TO_RAD, dReference[1] * DEG_TO_RAD, &dEasting, &dNorthing), long(TRANMERC_NO_ERROR));
+        QVERIFY(qAbs(dEasting - dReference[2]) < PROJECTION_TOLERANCE);
+        QVERIFY(qAbs(dNorthing - dReference[3]) < PROJECTION_TOLERANCE);
+
+        Convert_Transverse_Mercator_To_Geodetic_Ctx(&tContext, dEasting, dNorthing, &dLatitude, &dLongitude);
+        QVERIFY(groundDistance(dReference[0] * DEG_TO_RAD, dReference[1] * DEG_TO_RAD, dLatitude, dLongitude) < PROJECTION_TOLERANCE);
+    }
+
+    // Invalid parameters
+    QCOMPARE(Set_Transverse_Mercator_Parameters_Ctx(&tContext, WGS84_A, WGS84_F, 49.0 * DEG_TO_RAD, -2.0 * DEG_TO_RAD, 400000.0, -100000.0, 4.0), long(TRANMERC_SCALE_FACTOR_ERROR));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::mgrsReference()
+{
+    // Strings of the UTM and UPS references
+    struct
+    {
+        double      dLatitude;
+        double      dLongitude;
+        const char* sMGRS;
+    }
+    const tReferences[] = {
+        { 0.0, 3.0, "31NEA0000000000" },
+        { 43.9397103, 3.1230947, "31TEJ0987965184" },
+        { 51.5, -0.1, "30UYC0127809417" },
+        { -33.9, 151.2, "56HLH3356947473" },
+        { 72.0, 40.0, "37XEV3448989219" },
+        { 85.0, 45.0, "ZFD9276807232" },
+        { -80.0, 10.0, "32CNS1938518248" }
+    };
+
+    MGRS_Context tContext;
+    Init_MGRS_Context(&tContext);
+
+    for (const auto& tReference : tReferences)
+    {
+        char sMGRS[MGRS_STRING_SIZE];
+        double dLatitude, dLongitude;
+
+        QCOMPARE(Convert_Geodetic_To_MGRS_Ctx(&tContext, tReference.dLatitude * DEG_TO_RAD, tReference.dLongitude * DEG_TO_RAD, 5, sMGRS), long(MGRS_NO_ERROR));
+        QCOMPARE(QString(sMGRS), QString(tReference.sMGRS));
+
+        QCOMPARE(Convert_MGRS_To_Geodetic_Ctx(&tContext, sMGRS, &dLatitude, &dLongitude), long(MGRS_NO_ERROR));
+        QVERIFY(groundDistance(tReference.dLatitude * DEG_TO_RAD, tReference.dLongitude * DEG_TO_RAD, dLatitude, dLongitude) < MGRS_TOLERANCE);
+    }
+
+    // Lower precisions round the coordinates
+    char sMGRS[MGRS_STRING_SIZE];
+
+    QCOMPARE(Convert_Geodetic_To_MGRS_Ctx(&tContext, 43.9397103 * DEG_TO_RAD, 3.1230947 * DEG_TO_RAD, 2, sMGRS), long(MGRS_NO_ERROR));
+    QCOMPARE(QString(sMGRS), QString("31TEJ1065"));
+
+    // Invalid strings
+    double dLatitude, dLongitude;
+    char sBadZone[] = "32XMH1234512345";
+    char sBadLetters[] = "31TZZ0987965184";
+
+    QVERIFY(Convert_MGRS_To_Geodetic_Ctx(&tContext, sBadZone, &dLatitude, &dLongitude) & MGRS_STRING_ERROR);
+    QVERIFY(Convert_MGRS_To_Geodetic_Ctx(&tContext, sBadLetters, &dLatitude, &dLongitude) & MGRS_STRING_ERROR);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::mgrsRoundTrips()
+{
+    MGRS_Context tContext;
+    Init_MGRS_Context(&tContext);
+
+    MGRS_Zone_Cache tCache;
+    QCOMPARE(Init_MGRS_Zone_Cache(&tCache, &tContext), long(MGRS_NO_ERROR));
+
+    // The whole globe, UPS areas included
+    QVector<double> vLatitudes, vLongitudes;
+    makeGrid(-89.5, 89.5, 0.7, -179.5, 179.5, 1.3, vLatitudes, vLongitudes);
+
+    long iCount = vLatitudes.count();
+    QVector<char> vMGRS(iCount * MGRS_STRING_SIZE);
+    QVector<long> vCodes(iCount);
+    QVector<double> vBackLatitudes(iCount), vBackLongitudes(iCount);
+
+    QCOMPARE(Convert_Geodetic_To_MGRS_Batch(&tCache, iCount, vLatitudes.constData(), vLongitudes.constData(), 5, vMGRS.data(), nullptr), long(MGRS_NO_ERROR));
+    Convert_MGRS_To_Geodetic_Batch(&tCache, iCount, vMGRS.constData(), vBackLatitudes.data(), vBackLongitudes.data(), vCodes.data());
+
+    int iChecked = 0;
+
+    for (int iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        // Far from the central meridian of high latitude zones, the inverse reports the distortion instead of a position
+        if (vCodes[iIndex] != MGRS_NO_ERROR)
+        {
+            QVERIFY(qAbs(vLatitudes[iIndex]) >= 56.0 * DEG_TO_RAD);
+            continue;
+        }
+
+        QVERIFY(groundDistance(vLatitudes[iIndex], vLongitudes[iIndex], vBackLatitudes[iIndex], vBackLongitudes[iIndex]) < MGRS_TOLERANCE);
+        iChecked++;
+    }
+
+    QVERIFY(iChecked > iCount * 9 / 10);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::ellipsoidParameters()
+{
+    // UTM on the International 1924 ellipsoid
+    struct
+    {
+        double  dLatitude;
+        double  dLongitude;
+        long    iZone;
+        double  dEasting;
+        double  dNorthing;
+    }
+    const tReferences[] = {
+        { 43.9397103, 3.1230947, 31, 509879.4527, 4865272.9770 },
+        { -33.9, 151.2, 56, 333561.6572, 6247415.1407 }
+    };
+
+    UTM_Context tContext;
+    Init_UTM_Context(&tContext);
+
+    QCOMPARE(Set_UTM_Parameters_Ctx(&tContext, INTL_A, INTL_F, 0), long(UTM_NO_ERROR));
+
+    for (const auto& tReference : tReferences)
+    {
+        long iZone;
+        char cHemisphere;
+        double dEasting, dNorthing, dLatitude, dLongitude;
+
+        QCOMPARE(Convert_Geodetic_To_UTM_Ctx(&tContext, tReference.dLatitude * DEG_TO_RAD, tReference.dLongitude * DEG_TO_RAD, &iZone, &cHemisphere, &dEasting, &dNorthing), long(UTM_NO_ERROR));
+        QCOMPARE(iZone, tReference.iZone);
+        QVERIFY(qAbs(dEasting - tReference.dEasting) < PROJECTION_TOLERANCE);
+        QVERIFY(qAbs(dNorthing - tReference.dNorthing) < PROJECTION_TOLERANCE);
+
+        QCOMPARE(Convert_UTM_To_Geodetic_Ctx(&tContext, iZone, cHemisphere, dEasting, dNorthing, &dLatitude, &dLongitude), long(UTM_NO_ERROR));
+        QVERIFY(groundDistance(tReference.dLatitude * DEG_TO_RAD, tReference.dLongitude * DEG_TO_RAD, dLatitude, dLongitude) < PROJECTION_TOLERANCE);
+    }
+
+    // The geocentric conversions follow the ellipsoid too
+    Geocentric_Context tGeocentric;
+    Init_Geocentric_Context(&tGeocentric);
+
+    double dX, dY, dZ;
+
+    QCOMPARE(Set_Geocentric_Parameters_Ctx(&tGeocentric, INTL_A, INTL_F), long(GEOCENT_NO_ERROR));
+    Convert_Geodetic_To_Geocentric_Ctx(&tGeocentric, 0.0, 0.0, 0.0, &dX, &dY, &dZ);
+    QCOMPARE(dX, INTL_A);
+    Convert_Geodetic_To_Geocentric_Ctx(&tGeocentric, M_PI / 2.0, 0.0, 0.0, &dX, &dY, &dZ);
+    QVERIFY(qAbs(dZ - INTL_A * (1.0 - INTL_F)) < PROJECTION_TOLERANCE);
+
+    // Invalid ellipsoids
+    QCOMPARE(Set_UTM_Parameters_Ctx(&tContext, -1.0, WGS84_F, 0), long(UTM_A_ERROR));
+    QCOMPARE(Set_UTM_Parameters_Ctx(&tContext, WGS84_A, 1.0 / 100.0, 0), long(UTM_INV_F_ERROR));
+    QCOMPARE(Set_UTM_Parameters_Ctx(&tContext, WGS84_A, WGS84_F, 61), long(UTM_ZONE_OVERRIDE_ERROR));
+    QCOMPARE(Set_Geocentric_Parameters_Ctx(&tGeocentric, 0.0, WGS84_F), long(GEOCENT_A_ERROR));
+    QCOMPARE(Set_Geocentric_Parameters_Ctx(&tGeocentric, WGS84_A, 1.0 / 100.0), long(GEOCENT_INV_F_ERROR));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::geoTransConversions()
+{
+    // Reference of GeoTrans::mgrsToLatLong() : 31 TEJ 09879 65184 is 43.9397103 N, 3.1230947 E
+    double dLatitude, dLongitude;
+    char cLatitudeOrientation, cLongitudeOrientation;
+
+    GeoTrans::mgrsToLatLong("09879;65184;31T;EJ", dLatitude, dLongitude, cLatitudeOrientation, cLongitudeOrientation);
+    QVERIFY(groundDistance(43.9397103 * DEG_TO_RAD, 3.1230947 * DEG_TO_RAD, dLatitude * DEG_TO_RAD, dLongitude * DEG_TO_RAD) < MGRS_TOLERANCE);
+    QCOMPARE(cLatitudeOrientation, 'N');
+    QCOMPARE(cLongitudeOrientation, 'E');
+
+    // UTM of the default context
+    long iZone;
+    char cHemisphere;
+    double dEasting, dNorthing;
+
+    QCOMPARE(GeoTrans::Convert_Geodetic_To_UTM(43.9397103 * DEG_TO_RAD, 3.1230947 * DEG_TO_RAD, &iZone, &cHemisphere, &dEasting, &dNorthing), long(UTM_NO_ERROR));
+    QCOMPARE(iZone, 31L);
+    QVERIFY(qAbs(dEasting - 509878.9964) < PROJECTION_TOLERANCE);
+    QVERIFY(qAbs(dNorthing - 4865183.9958) < PROJECTION_TOLERANCE);
+
+    QCOMPARE(GeoTrans::Convert_UTM_To_Geodetic(iZone, cHemisphere, dEasting, dNorthing, &dLatitude, &dLongitude), long(UTM_NO_ERROR));
+    QVERIFY(groundDistance(43.9397103 * DEG_TO_RAD, 3.1230947 * DEG_TO_RAD, dLatitude, dLongitude) < PROJECTION_TOLERANCE);
+
+    char sMGRS[MGRS_STRING_SIZE];
+    QCOMPARE(GeoTrans::Convert_Geodetic_To_MGRS(43.9397103 * DEG_TO_RAD, 3.1230947 * DEG_TO_RAD, 5, sMGRS), long(MGRS_NO_ERROR));
+    QCOMPARE(QString(sMGRS), QString("31TEJ0987965184"));
+
+    // Degrees, minutes and seconds
+    int iDegrees, iMinutes, iSeconds;
+
+    GeoTrans::DegreeToDegMinSec(43.9397103, &iDegrees, &iMinutes, &iSeconds);
+    QCOMPARE(iDegrees, 43);
+    QCOMPARE(iMinutes, 56);
+    QCOMPARE(iSeconds, 22);
+
+    UtmMgrs::OrientationMDS tLatitude, tLongitude;
+
+    QVERIFY(UtmMgrs::convertUTMtoGeodeticDegMinSec(31, 'N', 509879.0, 4865184.0, tLatitude, tLongitude));
+    QCOMPARE(tLatitude.degrees, 43);
+    QCOMPARE(tLatitude.minutes, 56);
+    QVERIFY(qAbs(tLatitude.secondes - 23.0f) < 0.1f);
+    QCOMPARE(tLatitude.ExWxNxS, 'N');
+    QCOMPARE(tLongitude.degrees, 3);
+    QCOMPARE(tLongitude.minutes, 7);
+    QVERIFY(qAbs(tLongitude.secondes - 23.1f) < 0.1f);
+    QCOMPARE(tLongitude.ExWxNxS, 'E');
+
+    QVERIFY(UtmMgrs::convertUTMtoGeodeticDegMinSec(0, 'N', 509879.0, 4865184.0, tLatitude, tLongitude) == false);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::geoUtilitiesRoundTrips()
+{
+    CGeoUtilities* pUtilities = CGeoUtilities::getInstance();
+
+    // The QGeoCoordinate methods are only built in the library with Qt Positioning
+#ifdef QT_POSITIONING_LIB
+    const QGeoCoordinate gReferences[] = {
+        QGeoCoordinate(43.9397103, 3.1230947, 250.0),
+        QGeoCoordinate(-33.9, 151.2, 0.0),
+        QGeoCoordinate(70.0, -45.0, 3000.0),
+        QGeoCoordinate(-5.0, -80.0, -50.0)
+    };
+
+    for (const QGeoCoordinate& gReference : gReferences)
+    {
+        for (int iIndex = 0; iIndex < 50; iIndex++)
+        {
+            QGeoCoordinate gPosition(gReference.latitude() + ((iIndex * 37 % 41) - 20) * 0.005,
+                                     gReference.longitude() + ((iIndex * 53 % 43) - 21) * 0.005,
+                                     gReference.altitude() + (iIndex * 7919 % 5000));
+
+            QVector3D vPosition = pUtilities->GeoCoordinateToVector3D(gPosition, gReference);
+
+            // East, up and north in the frame of the reference
+            CGeoReferenceFrame tReference(gReference.latitude() * DEG_TO_RAD, gReference.longitude() * DEG_TO_RAD, gReference.altitude());
+            double dLatitude = gPosition.latitude() * DEG_TO_RAD, dLongitude = gPosition.longitude() * DEG_TO_RAD, dAltitude = gPosition.altitude();
+            double dEast, dNorth, dUp;
+
+            QVERIFY(tReference.geodeticToENU(1, &dLatitude, &dLongitude, &dAltitude, &dEast, &dNorth, &dUp));
+            QVERIFY(qAbs(double(vPosition.x()) - dEast) < VECTOR3D_TOLERANCE);
+            QVERIFY(qAbs(double(vPosition.y()) - dUp) < VECTOR3D_TOLERANCE);
+            QVERIFY(qAbs(double(vPosition.z()) - dNorth) < VECTOR3D_TOLERANCE);
+
+            // Rotations keep the straight-line distance between the geocentric points
+            double dX1, dY1, dZ1, dX2, dY2, dZ2;
+
+            Convert_Geodetic_To_Geocentric(gPosition.latitude() * DEG_TO_RAD, gPosition.longitude() * DEG_TO_RAD, gPosition.altitude(), &dX1, &dY1, &dZ1);
+            Convert_Geodetic_To_Geocentric(gReference.latitude() * DEG_TO_RAD, gReference.longitude() * DEG_TO_RAD, gReference.altitude(), &dX2, &dY2, &dZ2);
+
+            double dDistance = sqrt((dX1 - dX2) * (dX1 - dX2) + (dY1 - dY2) * (dY1 - dY2) + (dZ1 - dZ2) * (dZ1 - dZ2));
+
+            QVERIFY(qAbs(double(vPosition.length()) - dDistance) < VECTOR3D_TOLERANCE);
+
+            QGeoCoordinate gBack = pUtilities->Vector3DToGeoCoordinate(vPosition, gReference);
+
+            QVERIFY(groundDistance(gPosition.latitude() * DEG_TO_RAD, gPosition.longitude() * DEG_TO_RAD, gBack.latitude() * DEG_TO_RAD, gBack.longitude() * DEG_TO_RAD) < VECTOR3D_TOLERANCE);
+            QVERIFY(qAbs(gBack.altitude() - gPosition.altitude()) < VECTOR3D_TOLERANCE);
+        }
+    }
+#endif
+
+    // The cached frames give the same local coordinates as their own frame
+    CGeoReferenceFrame tFrame(45.0 * DEG_TO_RAD, 6.0 * DEG_TO_RAD, 500.0);
+    CGeoReferenceFrame tCached = pUtilities->referenceFrame(45.0 * DEG_TO_RAD, 6.0 * DEG_TO_RAD, 500.0);
+
+    QVERIFY(qAbs(tCached.originX() - tFrame.originX()) < GEOCENTRIC_TOLERANCE);
+    QVERIFY(qAbs(tCached.originY() - tFrame.originY()) < GEOCENTRIC_TOLERANCE);
+    QVERIFY(qAbs(tCached.originZ() - tFrame.originZ()) < GEOCENTRIC_TOLERANCE);
+
+    // The reference matrix, on Y/Z-swapped geocentric vectors, gives East, Up and North of the frame
+    QMatrix4x4 mReference = pUtilities->getGeoReferenceMatrix(QVector3D(tFrame.originX(), tFrame.originZ(), tFrame.originY()));
+    double dX = tFrame.originX() + 3000.0, dY = tFrame.originY() - 2000.0, dZ = tFrame.originZ() + 1000.0;
+    double dEast, dNorth, dUp;
+
+    tFrame.geocentricToENU(1, &dX, &dY, &dZ, &dEast, &dNorth, &dUp);
+
+    QVector3D vLocal = QVector3D(3000.0, 1000.0, -2000.0) * mReference;
+
+    QVERIFY(qAbs(double(vLocal.x()) - dEast) < VECTOR3D_TOLERANCE);
+    QVERIFY(qAbs(double(vLocal.y()) - dUp) < VECTOR3D_TOLERANCE);
+    QVERIFY(qAbs(double(vLocal.z()) - dNorth) < VECTOR3D_TOLERANCE);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::throughput_data()
+{
+    QTest::addColumn<int>("iConversion");
+
+    QTest::newRow("geodetic to geocentric") << int(cGeodeticToGeocentric);
+    QTest::newRow("geocentric to geodetic") << int(cGeocentricToGeodetic);
+    QTest::newRow("geodetic to geocentric, batch") << int(cGeodeticToGeocentricBatch);
+    QTest::newRow("geocentric to geodetic, batch") << int(cGeocentricToGeodeticBatch);
+    QTest::newRow("geodetic to local ENU, frame") << int(cGeodeticToLocalENU);
+    QTest::newRow("geodetic to UTM") << int(cGeodeticToUTM);
+    QTest::newRow("UTM to geodetic") << int(cUTMToGeodetic);
+    QTest::newRow("geodetic to UTM, batch") << int(cGeodeticToUTMBatch);
+    QTest::newRow("UTM to geodetic, batch") << int(cUTMToGeodeticBatch);
+    QTest::newRow("geodetic to UTM, batch, all threads") << int(cGeodeticToUTMThreads);
+    QTest::newRow("geodetic to MGRS") << int(cGeodeticToMGRS);
+    QTest::newRow("MGRS to geodetic") << int(cMGRSToGeodetic);
+    QTest::newRow("geodetic to MGRS, batch") << int(cGeodeticToMGRSBatch);
+    QTest::newRow("MGRS to geodetic, batch") << int(cMGRSToGeodeticBatch);
+    QTest::newRow("geodetic to UPS") << int(cGeodeticToUPS);
+    QTest::newRow("UPS to geodetic") << int(cUPSToGeodetic);
+    QTest::newRow("geodetic to polar stereographic") << int(cGeodeticToPolarStereographic);
+    QTest::newRow("geodetic to transverse Mercator") << int(cGeodeticToTransverseMercator);
+#ifdef QT_POSITIONING_LIB
+    QTest::newRow("GeoCoordinateToVector3D") << int(cGeoCoordinateToVector3D);
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CGeoTests::throughput()
+{
+    QFETCH(int, iConversion);
+
+    const long iCount = 20000;
+
+    // Points of the UTM area, or of the north polar cap for the polar projections
+    bool bPolar = iConversion == cGeodeticToUPS || iConversion == cUPSToGeodetic || iConversion == cGeodeticToPolarStereographic;
+
+    QVector<double> vLatitudes(iCount), vLongitudes(iCount), vHeights(iCount);
+
+    for (long iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        vLatitudes[iIndex] = (bPolar ? 84.0 + (iIndex % 59) * 0.1 : -79.0 + (iIndex % 161)) * DEG_TO_RAD;
+        vLongitudes[iIndex] = (-179.5 + (iIndex * 7 % 359)) * DEG_TO_RAD;
+        vHeights[iIndex] = double(iIndex % 9000);
+    }
+
+    Geocentric_Context tGeocentric;
+    UTM_Context tUTM;
+    UPS_Context tUPS;
+    MGRS_Context tMGRS;
+    Polar_Stereographic_Context tPolar;
+    Transverse_Mercator_Context tTransverseMercator;
+    UTM_Zone_Cache tUTMCache;
+    MGRS_Zone_Cache tMGRSCache;
+
+    Init_Geocentric_Context(&tGeocentric);
+    Init_UTM_Context(&tUTM);
+    Init_UPS_Context(&tUPS);
+    Init_MGRS_Context(&tMGRS);
+    Init_Polar_Stereographic_Context(&tPolar);
+    Init_Transverse_Mercator_Context(&tTransverseMercator);
+    Init_UTM_Zone_Cache(&tUTMCache, &tUTM);
+    Init_MGRS_Zone_Cache(&tMGRSCache, &tMGRS);
+
+    Set_Transverse_Mercator_Parameters_Ctx(&tTransverseMercator, WGS84_A, WGS84_F, 0.0, 0.0, 500000.0, 0.0, 0.9996);
+
+    CGeoReferenceFrame tFrame(43.9397103 * DEG_TO_RAD, 3.1230947 * DEG_TO_RAD, 250.0);
+
+    QVector<double> vX(iCount), vY(iCount), vZ(iCount);
+    QVector<long> vZones(iCount);
+    QVector<char> vHemispheres(iCount);
+    QVector<char> vMGRS(iCount * MGRS_STRING_SIZE);
+
+    // Inputs of the inverse conversions
+    Convert_Geodetic_To_Geocentric_Batch(&tGeocentric, iCount, vLatitudes.constData(), vLongitudes.constData(), vHeights.constData(), vX.data(), vY.data(), vZ.data());
+
+    if (bPolar)
+    {
+        for (long iIndex = 0; iIndex < iCount; iIndex++)
+        {
+            Convert_Geodetic_To_UPS_Ctx(&tUPS, vLatitudes[iIndex], vLongitudes[iIndex], &vHemispheres[iIndex], &vX[iIndex], &vY[iIndex]);
+        }
+    }
+    else if (iConversion == cUTMToGeodetic || iConversion == cUTMToGeodeticBatch)
+    {
+        Convert_Geodetic_To_UTM_Batch(&tUTMCache, iCount, vLatitudes.constData(), vLongitudes.constData(), vZones.data(), vHemispheres.data(), vX.data(), vY.data(), nullptr);
+    }
+
+    Convert_Geodetic_To_MGRS_Batch(&tMGRSCache, iCount, vLatitudes.constData(), vLongitudes.constData(), 5, vMGRS.data(), nullptr);
+
+#ifdef QT_POSITIONING_LIB
+    QGeoCoordinate gReference(43.9397103, 3.1230947, 250.0);
+    QVector<QGeoCoordinate> vCoordinates(iCount);
+
+    for (long iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        vCoordinates[iIndex] = QGeoCoordinate(vLatitudes[iIndex] * RAD_TO_DEG * 0.01 + 43.9, vLongitudes[iIndex] * RAD_TO_DEG * 0.01 + 3.1, vHeights[iIndex]);
+    }
+#endif
+
+    QVector<double> vOut1(iCount), vOut2(iCount), vOut3(iCount);
+
+    QElapsedTimer tTimer;
+    qint64 iPoints = 0;
+
+    tTimer.start();
+
+    QBENCHMARK
+    {
+        switch (iConversion)
+        {
+            case cGeodeticToGeocentric:
+                for (long iIndex = 0; iIndex < iCount; iIndex++)
+                    Convert_Geodetic_To_Geocentric_Ctx(&tGeocentric, vLatitudes[iIndex], vLongitudes[iIndex], vHeights[iIndex], &vOut1[iIndex], &vOut2[iIndex], &vOut3[iIndex]);
+                break;
+
+            case cGeocentricToGeodetic:
+                for (long iIndex = 0; iIndex < iCount; iIndex++)
+                    Convert_Geocentric_To_Geodetic_Ctx(&tGeocentric, vX[iIndex], vY[iIndex], vZ[iIndex], &vOut1[iIndex], &vOut2[iIndex], &vOut3[iIndex]);
+                break;
+
+            case cGeodeticToGeocentricBatch:
+                Convert_Geodetic_To_Geocentric_Batch(&tGeocentric, iCount, vLatitudes.constData(), vLongitudes.constData(), vHeights.constData(), vOut1.data(), vOut2.data(), vOut3.data());
+                break;
+
+            case cGeocentricToGeodeticBatch:
+                Convert_Geocentric_To_Geodetic_Batch(&tGeocentric, iCount, vX.constData(), vY.constData(), vZ.constData(), vOut1.data(), vOut2.data(), vOut3.data());
+                break;
+
+            case cGeodeticToLocalENU:
+                tFrame.geodeticToENU(int(iCount), vLatitudes.constData(), vLongitudes.constData(), vHeights.constData(), vOut1.data(), vOut2.data(), vOut3.data());
+                break;
+
+            case cGeodeticToUTM:
+                for (long iIndex = 0; iIndex < iCount; iIndex++)
+                    Convert_Geodetic_To_UTM_Ctx(&tUTM, vLatitudes[iIndex], vLongitudes[iIndex], &vZones[iIndex], &vHemispheres[iIndex], &vOut1[iIndex], &vOut2[iIndex]);
+                break;
+
+            case cUTMToGeodetic:
+                for (long iIndex = 0; iIndex < iCount; iIndex++)
+                    Convert_UTM_To_Geodetic_Ctx(&tUTM, vZones[iIndex], vHemispheres[iIndex], vX[iIndex], vY[iIndex], &vOut1[iIndex], &vOut2[iIndex]);
+                break;
+
+            case cGeodeticToUTMBatch:
+                Convert_Geodetic_To_UTM_Batch(&tUTMCache, iCount, vLatitudes.constData(), vLongitudes.constData(), vZones.data(), vHemispheres.data(), vOut1.data(), vOut2.data(), nullptr);
+                break;
+
+            case cUTMToGeodeticBatch:
+                Convert_UTM_To_Geodetic_Batch(&tUTMCache, iCount, vZones.constData(), vHemispheres.constData(), vX.constData(), vY.constData(), vOut1.data(), vOut2.data(), nullptr);
+                break;
+
+            case cGeodeticToUTMThreads:
+                GeoTrans::Convert_Geodetic_To_UTM_Batch(iCount, vLatitudes.constData(), vLongitudes.constData(), vZones.data(), vHemispheres.data(), vOut1.data(), vOut2.data(),
+                                                        nullptr, QThread::idealThreadCount());
+                break;
+
+            case cGeodeticToMGRS:
+                for (long iIndex = 0; iIndex < iCount; iIndex++)
+                    Convert_Geodetic_To_MGRS_Ctx(&tMGRS, vLatitudes[iIndex], vLongitudes[iIndex], 5, &vMGRS[iIndex * MGRS_STRING_SIZE]);
+                break;
+
+            case cMGRSToGeodetic:
+                for (long iIndex = 0; iIndex < iCount; iIndex++)
+                    Convert_MGRS_To_Geodetic_Ctx(&tMGRS, &vMGRS[iIndex * MGRS_STRING_SIZE], &vOut1[iIndex], &vOut2[iIndex]);
+                break;
+
+            case cGeodeticToMGRSBatch:
+                Convert_Geodetic_To_MGRS_Batch(&tMGRSCache, iCount, vLatitudes.constData(), vLongitudes.constData(), 5, vMGRS.data(), nullptr);
+                break;
+
+            case cMGRSToGeodeticBatch:
+                Convert_MGRS_To_Geodetic_Batch(&tMGRSCache, iCount, vMGRS.constData(), vOut1.data(), vOut2.data(), nullptr);
+                break;
+
+            case cGeodeticToUPS:
+                for (long iIndex = 0; iIndex < iCount; iIndex++)
+                    Convert_Geodetic_To_UPS_Ctx(&tUPS, vLatitudes[iIndex], vLongitudes[iIndex], &vHemispheres[iIndex], &vOut1[iIndex], &vOut2[iIndex]);
+                break;
+
+            case cUPSToGeodetic:
+                for (long iIndex = 0; iIndex < iCount; iIndex++)
+                    Convert_UPS_To_Geodetic_Ctx(&tUPS, vHemispheres[iIndex], vX[iIndex], vY[iIndex], &vOut1[iIndex], &vOut2[iIndex]);
+                break;
+
+            case cGeodeticToPolarStereographic:
+                for (long iIndex = 0; iIndex < iCount; iIndex++)
+                    Convert_Geodetic_To_Polar_Stereographic_Ctx(&tPolar, vLatitudes[iIndex], vLongitudes[iIndex], &vOut1[iIndex], &vOut2[iIndex]);
+                break;
+
+            case cGeodeticToTransverseMercator:
+                for (long iIndex = 0; iIndex < iCount; iIndex++)
+                    Convert_Geodetic_To_Transverse_Mercator_Ctx(&tTransverseMercator, vLatitudes[iIndex] * 0.1, vLongitudes[iIndex] * 0.02, &vOut1[iIndex], &vOut2[iIndex]);
+                break;
+
+#ifdef QT_POSITIONING_LIB
+            case cGeoCoordinateToVector3D:
+            {
+                CGeoUtilities* pUtilities = CGeoUtilities::getInstance();
+
+                for (long iIndex = 0; iIndex < iCount; iIndex++)
+                    pUtilities->GeoCoordinateToVector3D(vCoordinates[iIndex], gReference);
+                break;
+            }
+#endif
+        }
+
+        iPoints += iCount;
+    }
+
+    qint64 iNanoSeconds = tTimer.nsecsElapsed();
+
+    if (iNanoSeconds > 0)
+    {
+        qInfo().noquote() << QString("%1 : %2 points/s").arg(QTest::currentDataTag()).arg(double(iPoints) * 1e9 / double(iNanoSeconds), 0, 'f', 0);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+QTEST_MAIN(CGeoTests)
@@ -0,0 +1,46 @@
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+//! Accuracy and throughput tests of the geodetic conversions
+//! Reference values come from PROJ, tolerances are in meters on the ground
+class CGeoTests : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    //-------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    //-------------------------------------------------------------------------------------------------
+
+    //! Constructor
+    CGeoTests();
+
+    //! Destructor
+    virtual ~CGeoTests();
+
+    //-------------------------------------------------------------------------------------------------
+    // Tests
+    //-------------------------------------------------------------------------------------------------
+
+private slots:
+
+    void geocentricReference();
+    void geocentricRoundTrips();
+    void utmReference();
+    void utmRoundTrips();
+    void utmLimits();
+    void upsReference();
+    void upsRoundTrips();
+    void polarStereographicReference();
+    void transverseMercatorReference();
+    void mgrsReference();
+    void mgrsRoundTrips();
+    void ellipsoidParameters();
+    void geoTransConversions();
+    void geoUtilitiesRoundTrips();
+    void throughput_data();
+    void throughput();
+};
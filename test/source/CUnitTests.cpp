@@ -1,15 +1,148 @@
 
 // Qt
 #include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QXmlStreamWriter>
+#include <QSignalSpy>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
 
 // qt-plus
 #include "CXMLNode.h"
+#include "CGeoUtilities.h"
+#include "CGeoIndex.h"
+#include "CSoundRingBuffer.h"
+#include "CSoundVoiceBank.h"
 #include "RemoteControl/CRemoteControl.h"
+#include "Assembly/CAssemblyHeap.h"
+#include "Assembly/CAssemblyEngine.h"
+#include "QMLTree/QMLTreeContext.h"
+#include "QMLTree/QMLAnalyzer.h"
+#include "QMLTree/QMLEntityArena.h"
+#include "QMLTree/QMLIdentifier.h"
+#include "QMLTree/QMLItem.h"
+#include "QMLTree/QMLFunction.h"
+#include "QMLTree/QMLFormatter.h"
+#include "QMLTree/QMLCorpusGenerator.h"
+#include "GeoTools/geocent.h"
+#include "GeoTools/geobatch.h"
+#include "GeoTools/utm.h"
+#include "GeoTools/mgrs.h"
+#include "GeoTools/coordcnv.h"
+#include "GeoTools/geotrans.h"
+#include "GeoTools/wmm.h"
 
+#include "QMLReferenceLexer.h"
+#include "QMLReferenceFormatter.h"
 #include "CUnitTests.h"
 
 //-------------------------------------------------------------------------------------------------
 
+namespace
+{
+
+// Keeps pausing or stopping an assembly engine from another thread until told to finish
+class CAssemblyDebugTask : public QRunnable
+{
+public:
+
+    CAssemblyDebugTask(CAssemblyEngine* pEngine, bool bStop, QAtomicInt* pDone)
+        : m_pEngine(pEngine)
+        , m_bStop(bStop)
+        , m_pDone(pDone)
+    {
+    }
+
+    virtual void run() override
+    {
+        while (m_pDone->loadAcquire() == 0)
+        {
+            if (m_bStop)
+                m_pEngine->debugStop();
+            else
+                m_pEngine->debugPause();
+
+            QThread::msleep(10);
+        }
+    }
+
+protected:
+
+    CAssemblyEngine*    m_pEngine;
+    bool                m_bStop;
+    QAtomicInt*         m_pDone;
+};
+
+// Converts a set of positions with the contexts of one ellipsoid, used to run conversions in parallel
+class CGeoConversionTask : public QRunnable
+{
+public:
+
+    CGeoConversionTask(const Geocentric_Context* pGeocentric, const UTM_Context* pUTM, const MGRS_Context* pMGRS, const QVector<double>& vLatitudes, const QVector<double>& vLongitudes)
+        : m_pGeocentric(pGeocentric)
+        , m_pUTM(pUTM)
+        , m_pMGRS(pMGRS)
+        , m_vLatitudes(vLatitudes)
+        , m_vLongitudes(vLongitudes)
+    {
+        setAutoDelete(false);
+    }
+
+    virtual void run() override
+    {
+        m_lResults.clear();
+
+        for (int iIndex = 0; iIndex < m_vLatitudes.count(); iIndex++)
+        {
+            double dX, dY, dZ, dEasting, dNorthing;
+            long lZone;
+            char cHemisphere;
+            char sMGRS[32];
+
+            Convert_Geodetic_To_Geocentric_Ctx(m_pGeocentric, m_vLatitudes[iIndex], m_vLongitudes[iIndex], 100.0, &dX, &dY, &dZ);
+            Convert_Geodetic_To_UTM_Ctx(m_pUTM, m_vLatitudes[iIndex], m_vLongitudes[iIndex], &lZone, &cHemisphere, &dEasting, &dNorthing);
+            Convert_Geodetic_To_MGRS_Ctx(m_pMGRS, m_vLatitudes[iIndex], m_vLongitudes[iIndex], 5, sMGRS);
+
+            m_lResults << QString("%1 %2 %3 %4%5 %6 %7 %8")
+                          .arg(dX, 0, 'f', 4).arg(dY, 0, 'f', 4).arg(dZ, 0, 'f', 4)
+                          .arg(lZone).arg(cHemisphere).arg(dEasting, 0, 'f', 4).arg(dNorthing, 0, 'f', 4)
+                          .arg(sMGRS);
+        }
+    }
+
+    QStringList results() const { return m_lResults; }
+
+protected:
+
+    const Geocentric_Context*   m_pGeocentric;
+    const UTM_Context*          m_pUTM;
+    const MGRS_Context*         m_pMGRS;
+    QVector<double>             m_vLatitudes;
+    QVector<double>             m_vLongitudes;
+    QStringList                 m_lResults;
+};
+
+// Writes lLines, one per line, to the file sName of tDirectory, returns its path or an empty string if it could not be written
+QString writeQMLFile(const QTemporaryDir& tDirectory, const QString& sName, const QStringList& lLines)
+{
+    QString sFileName = tDirectory.path() + "/" + sName;
+    QFile file(sFileName);
+
+    if (file.open(QFile::WriteOnly) == false)
+        return QString();
+
+    file.write(lLines.join("\n").toLatin1());
+
+    return sFileName;
+}
+
+}
+
+//-------------------------------------------------------------------------------------------------
+
 CUnitTests::CUnitTests()
 {
 }
@@ -47,4 +180,2528 @@ void CUnitTests::remoteControlMultiClient()
 
 //-------------------------------------------------------------------------------------------------
 
+void CUnitTests::assemblyHeap()
+{
+    CAssemblyHeap tHeap(1024, 1024 + 256);
+
+    qint32 iBlock1 = tHeap.alloc(10);
+    qint32 iBlock2 = tHeap.alloc(32);
+    qint32 iBlock3 = tHeap.alloc(64);
+
+    QCOMPARE(iBlock1, 1024);
+    QCOMPARE(tHeap.blockSize(iBlock1), 12);
+    QVERIFY(iBlock2 >= iBlock1 + 12);
+    QVERIFY(iBlock3 != 0);
+    QCOMPARE(tHeap.alloc(1024), 0);
+
+    // Freeing all blocks must coalesce the heap back into a single block
+    QVERIFY(tHeap.free(iBlock2));
+    QVERIFY(tHeap.free(iBlock1));
+    QVERIFY(tHeap.free(iBlock3));
+    QVERIFY(tHeap.free(iBlock3) == false);
+
+    CAssemblyHeapStatistics tStatistics = tHeap.statistics();
+
+    QVERIFY(tHeap.isEmpty());
+    QCOMPARE(tStatistics.iFreeBlocks, 1);
+    QCOMPARE(tStatistics.iLargestFreeBlock, 256);
+    QCOMPARE(tStatistics.iBytesAllocated, 0);
+    QCOMPARE(tStatistics.iAllocCount, qint64(3));
+    QCOMPARE(tStatistics.iFreeCount, qint64(3));
+    QCOMPARE(tStatistics.iFailedAllocCount, qint64(1));
+    QCOMPARE(tStatistics.iInvalidFreeCount, qint64(1));
+    QCOMPARE(tHeap.alloc(256), 1024);
+
+    // Through INT_MEM, the heap region may only move once all its blocks are freed
+    QString sProgram = QStringList({
+        "a1 < 16384", "a2 < 20480", "d2 < 64", "d1 < 1", "!! 2", "d5 < d1",
+        "a2 < 24576", "d1 < 1", "!! 2", "d6 < d1",
+        "a2 < 20480", "a3 < d5", "d1 < 2", "!! 2",
+        "a2 < 24576", "d1 < 1", "!! 2", "d7 < d1", "d1 < d6", "<="
+    }).join("\n");
+
+    CAssemblyEngine tEngine;
+
+    QCOMPARE(tEngine.evaluate(sProgram, 0, 0, 0, 0), INT_MEM_ERROR_HEAP_IN_USE);
+    QVERIFY(tEngine.compileErrors().isEmpty());
+    QCOMPARE(tEngine.registers().D5, 16384);
+    QCOMPARE(tEngine.registers().D7, 16384);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::assemblyHeapStress()
+{
+    CAssemblyHeap tHeap(4096, 4096 + 4 * 1024 * 1024);
+    QVector<qint32> vBlocks;
+
+    QBENCHMARK
+    {
+        qsrand(42);
+
+        // Mixed pattern : small and large blocks, frees in random order
+        for (int iLoop = 0; iLoop < 20000; iLoop++)
+        {
+            if (vBlocks.count() > 0 && qrand() % 3 == 0)
+            {
+                int iIndex = qrand() % vBlocks.count();
+                QVERIFY(tHeap.free(vBlocks[iIndex]));
+                vBlocks.remove(iIndex);
+            }
+            else
+            {
+                qint32 iSize = (qrand() % 8 == 0) ? 256 + qrand() % 4096 : 4 + qrand() % 60;
+                qint32 iAddress = tHeap.alloc(iSize);
+
+                if (iAddress != 0)
+                {
+                    vBlocks << iAddress;
+                }
+            }
+        }
+
+        for (qint32 iAddress : vBlocks)
+        {
+            QVERIFY(tHeap.free(iAddress));
+        }
+
+        vBlocks.clear();
+    }
+
+    CAssemblyHeapStatistics tStatistics = tHeap.statistics();
+
+    QVERIFY(tHeap.isEmpty());
+    QCOMPARE(tStatistics.iFreeBlocks, 1);
+    QCOMPARE(tStatistics.iLargestFreeBlock, tStatistics.iHeapSize);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::assemblyOptimizer()
+{
+    QStringList lPrograms;
+
+    // Constant folding, redundant moves, push/pop pairs and size changes
+    lPrograms << QStringList({
+        "d1 < 5", "d1 + 3", "d1 * 2", "d2 < d2", "d3 < 7", "d3 < 9",
+        "-< d3", "-> d4", "-< d1", "-> d1", "@l", "@l", "d5 < 100", "d5 / 0", "<="
+    }).join("\n");
+
+    // Jump threading, a jump to the next instruction and jumps in a loop writing RAM
+    lPrograms << QStringList({
+        "a1 < 2048", "d1 < 0", "d2 < 10", "d8 < 4", "=|> :loop",
+        ":loop", "[a1 < d1", "a1 + d8", "d1 + 1", "d1 ? d2", "=<> :hop", "=|> :end",
+        ":hop", "=|> :loop",
+        ":end", "<="
+    }).join("\n");
+
+    // Calls and byte operand size
+    lPrograms << QStringList({
+        "d1 < 1", "=> :func", "d1 + 10", "@b", "d6 < 120", "d6 + 100", "@l", "<=",
+        ":func", "d1 * 3", "d2 < 4", "d2 + 4", "-< d2", "-> d7", "<="
+    }).join("\n");
+
+    // Reserved data addressed through a label
+    lPrograms << QStringList({
+        "a1 < :text", "a2 < 1000", "a2 + 24", "@b", "d2 < 0",
+        ":copy", "d1 < [a1", "d1 ? d2", "==> :done", "[a2 < d1", "d8 < 1", "a1 + d8", "d8 < 4", "a2 + d8", "=|> :copy",
+        ":done", "@l", "a1 < 0", "<=",
+        ":text", ". 'hello'"
+    }).join("\n");
+
+    for (const QString& sProgram : lPrograms)
+    {
+        CAssemblyEngine tReference;
+        CAssemblyEngine tOptimized;
+
+        tOptimized.setOptimize(true);
+
+        int iReference = tReference.evaluate(sProgram, 1, 2, 3, 4);
+        int iOptimized = tOptimized.evaluate(sProgram, 1, 2, 3, 4);
+
+        QVERIFY(tReference.compileErrors().isEmpty());
+        QVERIFY(tOptimized.compileErrors().isEmpty());
+        QCOMPARE(iOptimized, iReference);
+
+        // Every program has something to rewrite
+        QVERIFY(tReference.isOptimized() == false);
+        QVERIFY(tOptimized.isOptimized());
+        QVERIFY(tOptimized.codeSize() < tReference.codeSize());
+
+        CAssemblyMachine::CRegisters tReferenceRegisters = tReference.registers();
+        CAssemblyMachine::CRegisters tOptimizedRegisters = tOptimized.registers();
+
+        QCOMPARE(tOptimizedRegisters.SP, tReferenceRegisters.SP);
+        QCOMPARE(tOptimizedRegisters.A1, tReferenceRegisters.A1);
+        QCOMPARE(tOptimizedRegisters.A2, tReferenceRegisters.A2);
+        QCOMPARE(tOptimizedRegisters.D1, tReferenceRegisters.D1);
+        QCOMPARE(tOptimizedRegisters.D2, tReferenceRegisters.D2);
+        QCOMPARE(tOptimizedRegisters.D3, tReferenceRegisters.D3);
+        QCOMPARE(tOptimizedRegisters.D4, tReferenceRegisters.D4);
+        QCOMPARE(tOptimizedRegisters.D5, tReferenceRegisters.D5);
+        QCOMPARE(tOptimizedRegisters.D6, tReferenceRegisters.D6);
+        QCOMPARE(tOptimizedRegisters.D7, tReferenceRegisters.D7);
+        QCOMPARE(tOptimizedRegisters.D8, tReferenceRegisters.D8);
+        QCOMPARE(tOptimizedRegisters.Flags.Bits.m_iSame, tReferenceRegisters.Flags.Bits.m_iSame);
+        QCOMPARE(tOptimizedRegisters.Flags.Bits.m_iGreater, tReferenceRegisters.Flags.Bits.m_iGreater);
+        QCOMPARE(tOptimizedRegisters.Flags.Bits.m_iLower, tReferenceRegisters.Flags.Bits.m_iLower);
+        QCOMPARE(tOptimizedRegisters.Flags.Bits.m_iSize, tReferenceRegisters.Flags.Bits.m_iSize);
+
+        // The code itself moves, so only RAM below it is compared
+        QCOMPARE(tOptimized.ram(0, RAM_USER), tReference.ram(0, RAM_USER));
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::assemblyConsoleFrames()
+{
+    const int iCells = CONSOLE_W * CONSOLE_H;
+    const int iHalf = iCells / 2;
+
+    // Writes its index in every cell of the console, long by long
+    QString sFill = QStringList({
+        QString("a1 < %1").arg(RAM_CONSOLE_LOW), "d1 < 0", QString("d2 < %1").arg(iCells), "d8 < 4",
+        ":loop", "[a1 < d1", "a1 + d8", "d1 + 1", "d1 ? d2", "=<> :loop", "<="
+    }).join("\n");
+
+    // Same, with a yield once half of the cells are written
+    QString sFillYield = QStringList({
+        QString("a1 < %1").arg(RAM_CONSOLE_LOW), "d1 < 0", QString("d2 < %1").arg(iCells), QString("d3 < %1").arg(iHalf), "d8 < 4",
+        ":loop", "[a1 < d1", "a1 + d8", "d1 + 1", "d1 ? d3", "=<> :next",
+        "d4 < d1", "d1 < 3", "!! 4", "d1 < d4",
+        ":next", "d1 ? d2", "=<> :loop", "<="
+    }).join("\n");
+
+    CAssemblyEngine tEngine;
+    QVector<QRect> vRegions;
+    QVector<QVector<qint32> > vSnapshots;
+
+    connect(&tEngine, &CAssemblyEngine::consoleRegionChanged, &tEngine, [&](const QRect& rRegion, const QVector<qint32>& vSnapshot) {
+        vRegions << rRegion;
+        vSnapshots << vSnapshot;
+    }, Qt::DirectConnection);
+
+    // The whole run fits in one frame
+    tEngine.setConsoleFrameInterval(60000);
+
+    // A full screen written in one frame is notified once, with the whole screen
+    QCOMPARE(tEngine.evaluate(sFill, 0, 0, 0, 0), iCells);
+    QCOMPARE(vRegions.count(), 1);
+    QCOMPARE(vRegions[0], QRect(0, 0, CONSOLE_W, CONSOLE_H));
+    QCOMPARE(vSnapshots[0].count(), iCells);
+
+    for (int iCell = 0; iCell < iCells; iCell++)
+    {
+        QCOMPARE(vSnapshots[0][iCell], iCell);
+    }
+
+    QCOMPARE(tEngine.console(), vSnapshots[0]);
+
+    // A yield notifies what was written before it, the end of the run the rest
+    vRegions.clear();
+    vSnapshots.clear();
+
+    QCOMPARE(tEngine.evaluate(sFillYield, 0, 0, 0, 0), iCells);
+    QCOMPARE(vRegions.count(), 2);
+
+    int iHalfRow = iHalf / CONSOLE_W;
+    int iLastRow = (iHalf - 1) / CONSOLE_W;
+
+    QCOMPARE(vRegions[0], QRect(0, 0, CONSOLE_W, iLastRow + 1));
+    QCOMPARE(vRegions[1], QRect(0, iHalfRow, CONSOLE_W, CONSOLE_H - iHalfRow));
+    QCOMPARE(vSnapshots[0].count(), (iLastRow + 1) * CONSOLE_W);
+    QCOMPARE(vSnapshots[1].count(), (CONSOLE_H - iHalfRow) * CONSOLE_W);
+
+    // Cells after the yield are still empty in the first snapshot
+    for (int iCell = 0; iCell < vSnapshots[0].count(); iCell++)
+    {
+        QCOMPARE(vSnapshots[0][iCell], iCell < iHalf ? iCell : 0);
+    }
+
+    for (int iCell = 0; iCell < vSnapshots[1].count(); iCell++)
+    {
+        QCOMPARE(vSnapshots[1][iCell], iHalfRow * CONSOLE_W + iCell);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::assemblyDebugPauseStop()
+{
+    QString sCount = QStringList({ "d1 < 0", "d2 < 1000", ":loop", "d1 + 1", "d1 ? d2", "=<> :loop", "<=" }).join("\n");
+    QString sForever = QStringList({ "d1 < 0", ":loop", "d1 + 1", "=|> :loop", "<=" }).join("\n");
+
+    CAssemblyEngine tEngine;
+    QThreadPool tThreadPool;
+    int iPauses = 0;
+    CAssemblyMachine::EDebugCommand eOnPause = CAssemblyMachine::dcContinue;
+
+    // Runs on the thread of evaluate(), before the machine reads its command
+    connect(&tEngine, &CAssemblyEngine::debugPaused, &tEngine, [&](int, qint32) {
+        iPauses++;
+
+        if (eOnPause == CAssemblyMachine::dcStop)
+            tEngine.debugStop();
+        else if (eOnPause == CAssemblyMachine::dcContinue)
+            tEngine.debugContinue();
+    }, Qt::DirectConnection);
+
+    // A pause requested between runs or outside debug mode is dropped
+    tEngine.debugPause();
+    QCOMPARE(tEngine.evaluate(sCount, 0, 0, 0, 0, false), 1000);
+
+    tEngine.debugPause();
+    QCOMPARE(tEngine.evaluate(sCount, 0, 0, 0, 0, true), 1000);
+    QCOMPARE(iPauses, 0);
+
+    // A pause from another thread breaks a running loop, which is then stopped
+    {
+        QAtomicInt iDone(0);
+        eOnPause = CAssemblyMachine::dcStop;
+
+        tThreadPool.start(new CAssemblyDebugTask(&tEngine, false, &iDone));
+        tEngine.evaluate(sForever, 0, 0, 0, 0, true);
+        iDone.storeRelease(1);
+        tThreadPool.waitForDone();
+
+        QCOMPARE(iPauses, 1);
+    }
+
+    // A stop from another thread ends a running loop by itself
+    {
+        QAtomicInt iDone(0);
+        eOnPause = CAssemblyMachine::dcNone;
+        iPauses = 0;
+
+        tThreadPool.start(new CAssemblyDebugTask(&tEngine, true, &iDone));
+        tEngine.evaluate(sForever, 0, 0, 0, 0, true);
+        iDone.storeRelease(1);
+        tThreadPool.waitForDone();
+
+        QCOMPARE(iPauses, 1);
+    }
+
+    // The pending requests of the stopped runs do not leak into the next one
+    QCOMPARE(tEngine.evaluate(sCount, 0, 0, 0, 0, true), 1000);
+    QCOMPARE(iPauses, 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::assemblyDebugBreakpoints()
+{
+    // Lines are 1-based : the loop stores twice its counter at 20000 through a call, ten times
+    QString sProgram = QStringList({
+        "a1 < 20000",       // 1
+        "d1 < 0",           // 2
+        ":loop",            // 3
+        "d1 + 1",           // 4
+        "=> :twice",        // 5
+        "[a1 < d2",         // 6
+        "d1 ? d3",          // 7
+        "=<> :loop",        // 8
+        "d1 < d2",          // 9
+        "<=",               // 10
+        ":twice",           // 11
+        "d2 < d1",          // 12
+        "d2 * 2",           // 13
+        "<="                // 14
+    }).join("\n");
+
+    CAssemblyEngine tEngine;
+    QVector<int> vLines;
+    QVector<qint32> vAddresses;
+    QVector<CAssemblyMachine::CRegisters> vRegisters;
+    QList<CAssemblyMachine::EDebugCommand> lCommands;
+
+    // Runs on the thread of evaluate() : records the pause and sends the next command, continue by default
+    connect(&tEngine, &CAssemblyEngine::debugPaused, &tEngine, [&](int iLine, qint32 iAddress) {
+        vLines << iLine;
+        vAddresses << iAddress;
+        vRegisters << tEngine.registers();
+
+        CAssemblyMachine::EDebugCommand eCommand = lCommands.isEmpty() ? CAssemblyMachine::dcContinue : lCommands.takeFirst();
+
+        if (eCommand == CAssemblyMachine::dcStep)
+            tEngine.debugStep();
+        else if (eCommand == CAssemblyMachine::dcStepOver)
+            tEngine.debugStepOver();
+        else if (eCommand == CAssemblyMachine::dcStop)
+            tEngine.debugStop();
+        else
+            tEngine.debugContinue();
+    }, Qt::DirectConnection);
+
+    // Line breakpoint on the call, only when d1 is 3, then step over the call and continue to the end
+    {
+        CAssemblyMachine::CBreakpoint tBreakpoint;
+        tBreakpoint.iLine = 5;
+        tBreakpoint.eCondition = CAssemblyMachine::CBreakpoint::bcRegister;
+        tBreakpoint.eRegister = CAssemblyMachine::Op_D1;
+        tBreakpoint.iValue = 3;
+
+        int iBreakpoint = tEngine.addBreakpoint(tBreakpoint);
+
+        lCommands << CAssemblyMachine::dcStepOver;
+
+        QCOMPARE(tEngine.evaluate(sProgram, 0, 0, 10, 0, true), 20);
+        QCOMPARE(vLines, QVector<int>({ 5, 6 }));
+        QCOMPARE(vRegisters[0].D1, 3);
+        QCOMPARE(vRegisters[0].D2, 4);
+        QCOMPARE(vRegisters[1].D1, 3);
+        QCOMPARE(vRegisters[1].D2, 6);
+        QCOMPARE(vRegisters[1].SP, vRegisters[0].SP);
+
+        tEngine.removeBreakpoint(iBreakpoint);
+    }
+
+    // Stepping on the call enters it
+    {
+        vLines.clear();
+        vRegisters.clear();
+
+        int iBreakpoint = tEngine.addLineBreakpoint(5);
+
+        lCommands << CAssemblyMachine::dcStep << CAssemblyMachine::dcStop;
+
+        tEngine.evaluate(sProgram, 0, 0, 10, 0, true);
+        QCOMPARE(vLines, QVector<int>({ 5, 12 }));
+        QCOMPARE(vRegisters[1].D1, 1);
+
+        tEngine.removeBreakpoint(iBreakpoint);
+    }
+
+    // Address breakpoint, found with a line breakpoint, only when the stored long is above 10
+    {
+        vLines.clear();
+        vAddresses.clear();
+        vRegisters.clear();
+
+        int iBreakpoint = tEngine.addLineBreakpoint(7);
+
+        lCommands << CAssemblyMachine::dcStop;
+
+        tEngine.evaluate(sProgram, 0, 0, 10, 0, true);
+        QCOMPARE(vLines, QVector<int>({ 7 }));
+
+        tEngine.removeBreakpoint(iBreakpoint);
+
+        CAssemblyMachine::CBreakpoint tBreakpoint;
+        tBreakpoint.iAddress = vAddresses[0];
+        tBreakpoint.eCondition = CAssemblyMachine::CBreakpoint::bcRam;
+        tBreakpoint.eComparison = CAssemblyMachine::CBreakpoint::bcGreater;
+        tBreakpoint.iRamAddress = 20000;
+        tBreakpoint.iValue = 10;
+
+        iBreakpoint = tEngine.addBreakpoint(tBreakpoint);
+
+        vLines.clear();
+        vRegisters.clear();
+
+        // Pauses once per loop from the sixth one
+        QCOMPARE(tEngine.evaluate(sProgram, 0, 0, 10, 0, true), 20);
+        QCOMPARE(vLines, QVector<int>({ 7, 7, 7, 7, 7 }));
+        QCOMPARE(vRegisters[0].D1, 6);
+        QCOMPARE(vRegisters[0].D2, 12);
+        QCOMPARE(vRegisters[4].D1, 10);
+
+        tEngine.removeBreakpoint(iBreakpoint);
+    }
+
+    // Without breakpoints the run goes to the end
+    vLines.clear();
+
+    QCOMPARE(tEngine.evaluate(sProgram, 0, 0, 10, 0, true), 20);
+    QVERIFY(vLines.isEmpty());
+    QCOMPARE(tEngine.ram(20000, 4), QByteArray("\x14\0\0\0", 4));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlLexer()
+{
+    // Every kind of token, comments, tabs and a carriage return
+    QString sText = QStringList({
+        "import QtQuick 2.0",
+        "// Single line",
+        "Item {",
+        "\tid: root /* multi * line */",
+        "    property real value: .5 + 0x1F - 1.25e",
+        "    /*! Doc */",
+        "    readonly property string text: \"a\\\"b\\n\" + 'c'",
+        "    function f(a) { if (a !== null && a >= 2) return [ ]; else return TRUE }\r",
+        "    onValueChanged: a <<= b >>> c",
+        "}"
+    }).join("\n") + "\n";
+
+    // Expected tokens, then comments, for the text above
+    QStringList lExpected({
+        "500 0 0 import",
+        "300 0 7 QtQuick",
+        "304 0 15 2.0",
+        "300 2 0 Item",
+        "123 2 5 {",
+        "300 3 4 id",
+        "58 3 6 :",
+        "300 3 8 root",
+        "501 4 4 property",
+        "300 4 13 real",
+        "300 4 18 value",
+        "58 4 23 :",
+        "304 4 25 0.5",
+        "311 4 28 +",
+        "303 4 30 0x1F",
+        "312 4 35 -",
+        "304 4 37 1.25",
+        "300 4 41 e",
+        "503 6 4 readonly",
+        "501 6 13 property",
+        "300 6 22 string",
+        "300 6 29 text",
+        "58 6 33 :",
+        "301 6 35 a\"b\n",
+        "311 6 44 +",
+        "301 6 46 c",
+        "512 7 4 function",
+        "300 7 13 f",
+        "40 7 14 (",
+        "300 7 15 a",
+        "41 7 16 )",
+        "123 7 18 {",
+        "513 7 20 if",
+        "40 7 23 (",
+        "300 7 24 a",
+        "338 7 26 !==",
+        "305 7 30 null",
+        "339 7 35 &&",
+        "300 7 38 a",
+        "334 7 40 >=",
+        "303 7 43 2",
+        "41 7 44 )",
+        "523 7 46 return",
+        "346 7 53 []",
+        "59 7 56 ;",
+        "514 7 58 else",
+        "523 7 63 return",
+        "302 7 70 TRUE",
+        "125 7 75 }",
+        "300 8 4 onValueChanged",
+        "58 8 18 :",
+        "300 8 20 a",
+        "329 8 22 <<=",
+        "300 8 26 b",
+        "320 8 28 >>",
+        "332 8 30 >",
+        "300 8 32 c",
+        "125 9 0 }",
+        "comment 1 2 1 Single line",
+        "comment 3 15 2 multi  line",
+        "comment 5 7 3 Doc"
+    });
+
+    QMLTreeContext tContext;
+    QMLReferenceLexer tReference;
+
+    QCOMPARE(tReference.tokenize(sText), lExpected);
+    QCOMPARE(tContext.tokenize(sText), lExpected);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlLexerCorpus()
+{
+    // The corpus of the QML benchmarks with their default settings
+    QMLCorpusGenerator generator;
+    generator.setFileCount(50);
+    generator.setDepth(4);
+    generator.setChildrenPerItem(3);
+    generator.setPropertiesPerItem(4);
+    generator.setFunctionsPerItem(1);
+    generator.setStatementsPerFunction(6);
+    generator.setImportsPerFile(2);
+    generator.setCommentPercent(20);
+
+    QMLTreeContext tContext;
+    QMLReferenceLexer tReference;
+
+    // Whole files must give the same tokens and comments as the former lexer
+    for (int iIndex = 0; iIndex < generator.fileCount(); iIndex++)
+    {
+        QString sText = generator.generateFile(iIndex);
+        QStringList lExpected = tReference.tokenize(sText);
+        QStringList lTokens = tContext.tokenize(sText);
+
+        QVERIFY(lExpected.count() > 1000);
+
+        for (int iToken = 0; iToken < qMin(lTokens.count(), lExpected.count()); iToken++)
+        {
+            if (lTokens[iToken] != lExpected[iToken])
+            {
+                QFAIL(qPrintable(QString("%1, token %2 : %3 instead of %4").arg(generator.fileName(iIndex)).arg(iToken).arg(lTokens[iToken]).arg(lExpected[iToken])));
+            }
+        }
+
+        QCOMPARE(lTokens.count(), lExpected.count());
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlParallelParse()
+{
+    // A project of items, each importing a folder of widgets
+    QTemporaryDir tDirectory;
+    QVERIFY(tDirectory.isValid());
+    QVERIFY(QDir(tDirectory.path()).mkdir("Widgets"));
+
+    QStringList lFileNames;
+
+    for (int iIndex = 0; iIndex < 16; iIndex++)
+    {
+        QFile widget(QString("%1/Widgets/Widget%2.qml").arg(tDirectory.path()).arg(iIndex));
+        QVERIFY(widget.open(QFile::WriteOnly));
+        widget.write(QString("import QtQuick 2.5\n\nRectangle {\n    property int index: %1\n    width: index * 2\n}\n").arg(iIndex).toLatin1());
+        widget.close();
+    }
+
+    for (int iIndex = 0; iIndex < 64; iIndex++)
+    {
+        QString sFileName = QString("%1/Item%2.qml").arg(tDirectory.path()).arg(iIndex);
+        QFile item(sFileName);
+        QVERIFY(item.open(QFile::WriteOnly));
+
+        QString sText = "import QtQuick 2.5\nimport \"Widgets\"\n\nItem {\n    id: root\n";
+
+        for (int iProperty = 0; iProperty < 200; iProperty++)
+        {
+            sText += QString("    property real value%1: %2 + root.value%3 * 0.5 // Value %1\n").arg(iProperty).arg(iIndex).arg(iProperty > 0 ? iProperty - 1 : 0);
+        }
+
+        sText += "    function sum(a, b) { var c = a + b; return c; }\n}\n";
+
+        item.write(sText.toLatin1());
+        item.close();
+
+        lFileNames << sFileName;
+    }
+
+    // Parse sequentially, then on all cores : both must give the same files in the same order
+    QStringList lOutputs[2];
+    int iThreads[2] = { 1, qMax(2, QThread::idealThreadCount()) };
+
+    for (int iPass = 0; iPass < 2; iPass++)
+    {
+        QMLTreeContext tContext;
+        tContext.setIncludeImports(true);
+        tContext.setMaxThreads(iThreads[iPass]);
+
+        for (const QString& sFileName : lFileNames)
+        {
+            tContext.addFile(sFileName);
+        }
+
+        QCOMPARE(tContext.parse(), QMLTreeContext::peSuccess);
+
+        for (QMLFile* pFile : tContext.files())
+        {
+            QString sText;
+            QTextStream stream(&sText);
+            QMLFormatter formatter;
+
+            pFile->toQML(stream, formatter);
+            stream.flush();
+
+            lOutputs[iPass] << pFile->fileName() << sText;
+
+            // Entities built by workers must belong to the thread of the context
+            QCOMPARE(pFile->thread(), tContext.thread());
+
+            for (QMLEntity* pEntity : pFile->contents())
+            {
+                QCOMPARE(pEntity->thread(), tContext.thread());
+            }
+        }
+    }
+
+    QCOMPARE(lOutputs[0].count(), (64 + 16) * 2);
+    QCOMPARE(lOutputs[1], lOutputs[0]);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlParallelParseScaling_data()
+{
+    QTest::addColumn<int>("iThreads");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow(QString("%1 threads").arg(QThread::idealThreadCount()).toLatin1().constData()) << QThread::idealThreadCount();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlParallelParseScaling()
+{
+    QFETCH(int, iThreads);
+
+    QTemporaryDir tDirectory;
+    QVERIFY(tDirectory.isValid());
+
+    // The default corpus of the benchmarks
+    QMLCorpusGenerator generator;
+    QStringList lFileNames = generator.generate(tDirectory.path());
+    QVERIFY(lFileNames.isEmpty() == false);
+
+    QBENCHMARK
+    {
+        QMLTreeContext tContext;
+        tContext.setMaxThreads(iThreads);
+
+        for (const QString& sFileName : lFileNames)
+        {
+            tContext.addFile(sFileName);
+        }
+
+        QCOMPARE(tContext.parse(), QMLTreeContext::peSuccess);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlParseCache()
+{
+    QTemporaryDir tDirectory;
+    QVERIFY(tDirectory.isValid());
+
+    QString sCacheFolder = tDirectory.path() + "/cache";
+    QString sFileName = tDirectory.path() + "/Item.qml";
+
+    QString sText = QStringList({
+        "import QtQuick 2.5",
+        "",
+        "// The root item",
+        "Item {",
+        "    id: root",
+        "    readonly property int count: (1 + 2) * 3",
+        "    property var list: [ 1, \"two\", null ]",
+        "    signal done(int value)",
+        "    /*! Doubles a value */",
+        "    function twice(a) { for (var i = 0; i < 2; i++) { a += a; } return a > 0 ? a : -a; }",
+        "    onCountChanged: { if (count === undefined) done(0); else done(twice(count)); }",
+        "    Rectangle { anchors.fill: parent }",
+        "}",
+        ""
+    }).join("\n");
+
+    auto writeFile = [&](const QString& sContents) {
+        QFile file(sFileName);
+        QVERIFY(file.open(QFile::WriteOnly));
+        file.write(sContents.toLatin1());
+        file.close();
+    };
+
+    auto parseFile = [&](int& iHits, int& iMisses) -> QString {
+        QMLTreeContext tContext;
+        tContext.setCacheFolder(sCacheFolder);
+        tContext.addFile(sFileName);
+
+        if (tContext.parse() != QMLTreeContext::peSuccess)
+            return QString();
+
+        iHits = tContext.cache().hits();
+        iMisses = tContext.cache().misses();
+
+        QString sOutput;
+        QTextStream stream(&sOutput);
+        QMLFormatter formatter;
+        tContext.files().first()->toQML(stream, formatter);
+        stream.flush();
+
+        return sOutput;
+    };
+
+    int iHits = 0;
+    int iMisses = 0;
+
+    writeFile(sText);
+
+    // First run fills the cache
+    QString sParsed = parseFile(iHits, iMisses);
+    QVERIFY(sParsed.isEmpty() == false);
+    QCOMPARE(iHits, 0);
+    QCOMPARE(iMisses, 1);
+
+    // Second run reads the same tree back
+    QCOMPARE(parseFile(iHits, iMisses), sParsed);
+    QCOMPARE(iHits, 1);
+    QCOMPARE(iMisses, 0);
+
+    // A changed file is parsed again
+    writeFile(sText + "// Changed\n");
+    QVERIFY(parseFile(iHits, iMisses).isEmpty() == false);
+    QCOMPARE(iMisses, 1);
+
+    // A damaged entry is ignored
+    writeFile(sText);
+
+    for (QString sEntry : QDir(sCacheFolder).entryList(QDir::Files))
+    {
+        QFile entry(sCacheFolder + "/" + sEntry);
+        QVERIFY(entry.open(QFile::ReadWrite));
+        entry.seek(entry.size() / 2);
+        entry.write("garbage");
+        entry.close();
+    }
+
+    QCOMPARE(parseFile(iHits, iMisses), sParsed);
+    QCOMPARE(iHits, 0);
+    QCOMPARE(iMisses, 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlEntityArena()
+{
+    QMLEntityArena tArena;
+    QMLEntity* pHeapEntity = new QMLEntity(QPoint());
+    QVector<QMLEntity*> vEntities;
+
+    {
+        QMLEntityArena::Scope tScope(&tArena);
+
+        for (int iIndex = 0; iIndex < 10000; iIndex++)
+        {
+            vEntities << new QMLIdentifier(QPoint(iIndex, 0), QString("id%1").arg(iIndex));
+        }
+    }
+
+    QVERIFY(QMLEntityArena::current() == nullptr);
+    QVERIFY(tArena.reservedBytes() >= qint64(10000 * sizeof(QMLIdentifier)));
+    QCOMPARE(tArena.liveEntities().count(), 10000);
+
+    // Deleted entities run their destructor, their memory stays in the arena
+    for (int iIndex = 0; iIndex < 10000; iIndex += 2)
+    {
+        delete vEntities[iIndex];
+    }
+
+    QList<QMLEntity*> lLiveEntities = tArena.liveEntities();
+    QCOMPARE(lLiveEntities.count(), 5000);
+    QCOMPARE(lLiveEntities.first(), vEntities[1]);
+    QCOMPARE(lLiveEntities.first()->value().toString(), QString("id1"));
+
+    // A file is never allocated in an arena, its entities are allocated in its own one
+    QMLFile* pFile = nullptr;
+
+    {
+        QMLEntityArena::Scope tScope(&tArena);
+
+        pFile = new QMLFile(QPoint(), nullptr, "");
+        QMLEntityArena::Scope tFileScope(&pFile->arena());
+
+        pFile->contents() << new QMLIdentifier(QPoint(), QString("child"));
+    }
+
+    QCOMPARE(tArena.liveEntities().count(), 5000);
+    QCOMPARE(pFile->arena().liveEntities().count(), 1);
+
+    delete pFile;
+    delete pHeapEntity;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlSymbolResolution()
+{
+    QTemporaryDir tDirectory;
+    QVERIFY(tDirectory.isValid());
+
+    QString sFileName = writeQMLFile(tDirectory, "Item.qml", {
+        "import QtQuick 2.5",
+        "Item {",
+        "    id: root",
+        "    property int used: 1",
+        "    property int unused: 2",
+        "    property int alsoUsed: 3",
+        "    width: root.used",
+        "    function f(a, b) { var v = a; var w = 0; return v; }",
+        "    Rectangle { height: alsoUsed }",
+        "}",
+        ""
+    });
+    QVERIFY(sFileName.isEmpty() == false);
+
+    QMLTreeContext tContext;
+    tContext.addFile(sFileName);
+    QCOMPARE(tContext.parse(), QMLTreeContext::peSuccess);
+
+    QMLItem* pItem = nullptr;
+    QMLFunction* pFunction = nullptr;
+
+    for (QMLEntity* pEntity : tContext.files().first()->contents())
+    {
+        if (dynamic_cast<QMLItem*>(pEntity) != nullptr)
+            pItem = dynamic_cast<QMLItem*>(pEntity);
+    }
+
+    QVERIFY(pItem != nullptr);
+    QCOMPARE(pItem->id(), QString("root"));
+
+    for (QMLEntity* pEntity : pItem->contents())
+    {
+        if (dynamic_cast<QMLFunction*>(pEntity) != nullptr)
+            pFunction = dynamic_cast<QMLFunction*>(pEntity);
+    }
+
+    QVERIFY(pFunction != nullptr);
+
+    // Qualified names, plain names and names from a nested item resolve to the declarations
+    QMap<QString, QMLEntity*> mUnusedProperties = pItem->unusedProperties();
+    QVERIFY(mUnusedProperties.contains("unused"));
+    QVERIFY(mUnusedProperties.contains("used") == false);
+    QVERIFY(mUnusedProperties.contains("alsoUsed") == false);
+
+    QMap<QString, QMLEntity*> mUnusedParameters = pFunction->unusedParameters();
+    QCOMPARE(mUnusedParameters.keys(), QStringList({ "b" }));
+
+    QMap<QString, QMLEntity*> mUnusedVariables = pFunction->unusedVariables();
+    QCOMPARE(mUnusedVariables.keys(), QStringList({ "w" }));
+
+    // The member map and the member visitor agree
+    QMap<QString, QMLEntity*> mMembers = pFunction->members();
+    int iVisitedMembers = 0;
+
+    pFunction->forEachMember([&](QMLEntity* pMember) {
+        QVERIFY(mMembers.values().contains(pMember));
+        iVisitedMembers++;
+    });
+
+    QVERIFY(mMembers.contains("content"));
+    QCOMPARE(iVisitedMembers, mMembers.count());
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlAnalyzerRules()
+{
+    QTemporaryDir tDirectory;
+    QVERIFY(tDirectory.isValid());
+
+    for (int iIndex = 0; iIndex < 8; iIndex++)
+    {
+        QVERIFY(writeQMLFile(tDirectory, QString("Item%1.qml").arg(iIndex), {
+            "import QtQuick 2.5",
+            "Rectangle {",
+            "    property int goodName: 1",
+            "    property int Bad_Name: 2",
+            "    color: \"red\"",
+            "    border.color: \"red\"",
+            "}",
+            ""
+        }).isEmpty() == false);
+    }
+
+    // A macro, an accept with a regular expression and a conditional reject
+    CXMLNode xGrammar("Grammar");
+
+    CXMLNode xMacro("Macro");
+    xMacro.attributes()["Name"] = "CamelCasingRegExp";
+    xMacro.attributes()["Value"] = "([a-z])([a-zA-Z0-9]*)";
+    xGrammar.nodes() << xMacro;
+
+    CXMLNode xNameCheck("Check");
+    xNameCheck.attributes()["Class"] = "QMLPropertyDeclaration";
+    CXMLNode xNameRule("Accept");
+    xNameRule.attributes()["Member"] = "name";
+    xNameRule.attributes()["RegExp"] = "$CamelCasingRegExp$";
+    xNameRule.attributes()["Text"] = "Only camel casing allowed in names";
+    xNameCheck.nodes() << xNameRule;
+    xGrammar.nodes() << xNameCheck;
+
+    CXMLNode xColorCheck("Check");
+    xColorCheck.attributes()["Class"] = "QMLPropertyAssignment";
+    CXMLNode xColorRule("Reject");
+    xColorRule.attributes()["Member"] = "content";
+    xColorRule.attributes()["Value"] = "red";
+    xColorRule.attributes()["Text"] = "No hardcoded colors allowed";
+    CXMLNode xColorCondition("Condition");
+    xColorCondition.attributes()["Member"] = "name";
+    xColorCondition.attributes()["Value"] = "color";
+    xColorRule.nodes() << xColorCondition;
+    xColorCheck.nodes() << xColorRule;
+    xGrammar.nodes() << xColorCheck;
+
+    // Sequential and parallel analyses must yield the same errors in the same order
+    QStringList lErrors[2];
+    int iThreads[2] = { 1, 4 };
+
+    for (int iPass = 0; iPass < 2; iPass++)
+    {
+        QMLAnalyzer tAnalyzer;
+        tAnalyzer.setFolder(tDirectory.path());
+        tAnalyzer.setMaxThreads(iThreads[iPass]);
+        QVERIFY(tAnalyzer.analyze(xGrammar));
+
+        for (const QMLAnalyzerError& tError : tAnalyzer.errors())
+        {
+            lErrors[iPass] << QString("%1:%2:%3")
+                              .arg(QFileInfo(tError.fileName()).fileName())
+                              .arg(tError.position().y())
+                              .arg(tError.text());
+        }
+    }
+
+    QCOMPARE(lErrors[0].count(), 16);
+    QCOMPARE(lErrors[0].filter("Only camel casing").count(), 8);
+    QCOMPARE(lErrors[0].filter("No hardcoded colors").count(), 8);
+    QCOMPARE(lErrors[1], lErrors[0]);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlPositionIndex()
+{
+    QTemporaryDir tDirectory;
+    QVERIFY(tDirectory.isValid());
+
+    QString sFileName = writeQMLFile(tDirectory, "Item.qml", {
+        "import QtQuick 2.5",
+        "// The root item",
+        "Item {",
+        "    id: root",
+        "    /* Size */",
+        "    width: 100",
+        "    height: 50 // Half",
+        "    property int unused: 1",
+        "    // A child",
+        "    Rectangle {",
+        "        color: \"red\"",
+        "    }",
+        "    function f(a) { return a; }",
+        "}",
+        ""
+    });
+    QVERIFY(sFileName.isEmpty() == false);
+
+    QMLTreeContext tContext;
+    tContext.addFile(sFileName);
+    QCOMPARE(tContext.parse(), QMLTreeContext::peSuccess);
+
+    QMLFile* pFile = tContext.files().first();
+
+    // All comments found a place in the tree
+    QVERIFY(pFile->comments().isEmpty());
+
+    int iComments = 0;
+
+    QVector<QMLEntity*> vPending({ pFile });
+
+    while (vPending.isEmpty() == false)
+    {
+        QMLEntity* pEntity = vPending.takeLast();
+
+        if (QMLEntity::isComment(pEntity))
+            iComments++;
+
+        QMLComplexEntity* pComplex = dynamic_cast<QMLComplexEntity*>(pEntity);
+
+        if (pComplex != nullptr)
+        {
+            for (QMLEntity* pChild : pComplex->contents())
+            {
+                if (pChild != nullptr)
+                    vPending << pChild;
+            }
+        }
+    }
+
+    QCOMPARE(iComments, 4);
+
+    // The index holds no comment and is sorted by position
+    const QVector<QMLEntity*>& vIndex = pFile->positionIndex();
+    QVERIFY(vIndex.count() > 1);
+
+    for (int iIndex = 0; iIndex < vIndex.count(); iIndex++)
+    {
+        QVERIFY(QMLEntity::isComment(vIndex[iIndex]) == false);
+
+        if (iIndex > 0)
+        {
+            QPoint pPrevious = vIndex[iIndex - 1]->position();
+            QPoint pCurrent = vIndex[iIndex]->position();
+            QVERIFY(pPrevious.y() < pCurrent.y() || (pPrevious.y() == pCurrent.y() && pPrevious.x() <= pCurrent.x()));
+        }
+
+        // Position queries land on an entity starting at the same place
+        QMLEntity* pFound = pFile->entityAt(vIndex[iIndex]->position());
+        QVERIFY(pFound != nullptr);
+        QCOMPARE(pFound->position(), vIndex[iIndex]->position());
+    }
+
+    QVERIFY(pFile->entityAt(QPoint(-1, -1)) == nullptr);
+
+    // Line queries return an entity at or after the line, or nothing past the end
+    for (int iLine = 0; iLine < 12; iLine++)
+    {
+        QMLEntity* pEntity = pFile->locateEntityAtOrAfterLine(QPoint(0, iLine));
+        QVERIFY(pEntity != nullptr);
+        QVERIFY(pEntity->position().y() >= iLine);
+        QVERIFY(QMLEntity::isComment(pEntity) == false);
+    }
+
+    QVERIFY(pFile->locateEntityAtOrAfterLine(QPoint(0, 1000)) == nullptr);
+
+    // Changing the tree drops the index, the next query rebuilds it without the removed entities
+    int iIndexCount = pFile->positionIndex().count();
+
+    pFile->removeUnreferencedSymbols(&tContext);
+
+    QVERIFY(pFile->positionIndex().count() < iIndexCount);
+    QVERIFY(pFile->locateEntityAtOrAfterLine(QPoint(0, 7))->position().y() > 7);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlFormatterFragments()
+{
+    CXMLNode xFormat = CXMLNode::parseXML(QStringList({
+        "<Format>",
+        "    <Macro Name=\"Open\" Value=\"BeforeItemContent\"/>",
+        "    <Fragment Names=\"$Open$,BeforeFunction\">",
+        "        <Action Type=\"NewLine\"/>",
+        "        <Action Type=\"IndentationIncrement\"/>",
+        "    </Fragment>",
+        "    <Fragment Names=\"BeforeItemContent\">",
+        "        <Action Type=\"NewLine\"/>",
+        "        <Action Type=\"Unknown\"/>",
+        "    </Fragment>",
+        "    <Fragment Names=\"AfterItemContent\">",
+        "        <Action Type=\"IndentationDecrement\"/>",
+        "        <Action Type=\"DoubleNewLine\"/>",
+        "    </Fragment>",
+        "</Format>"
+    }).join("\n"));
+
+    QString sText;
+    QTextStream stream(&sText);
+
+    QMLFormatter formatter;
+
+    // Without a definition, fragments output nothing
+    formatter.processFragment(stream, QMLFormatter::qffBeforeItemContent);
+    stream.flush();
+    QVERIFY(sText.isEmpty());
+
+    // Matching definitions apply in order, macros are expanded and unknown actions ignored
+    formatter.setGrammar(xFormat);
+
+    formatter.processFragment(stream, QMLFormatter::qffBeforeItemContent);
+    stream << "a";
+    formatter.processFragment(stream, QMLFormatter::qffBeforeFunction);
+    stream << "b";
+    formatter.processFragment(stream, QMLFormatter::qffAfterItemContent);
+    stream << "c";
+    formatter.processFragment(stream, QMLFormatter::qffAfterItemContent);
+    formatter.processFragment(stream, QMLFormatter::qffAfterItemContent);
+    formatter.processFragment(stream, QMLFormatter::qffBeforeImport);
+    stream.flush();
+
+    QCOMPARE(sText, QString("\r\n\r\n    a\r\n    b\r\n\r\n    c\r\n\r\n\r\n\r\n"));
+
+    // A new definition replaces the compiled one
+    QString sEmptyText;
+    QTextStream emptyStream(&sEmptyText);
+
+    formatter.setGrammar(CXMLNode());
+    formatter.processFragment(emptyStream, QMLFormatter::qffBeforeItemContent);
+    emptyStream.flush();
+    QVERIFY(sEmptyText.isEmpty());
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlFormatterCorpus()
+{
+    // The format definition shipped with the library
+    QString sFormatFileName = QFINDTESTDATA("../../source/misc/Format.xml");
+    QVERIFY(sFormatFileName.isEmpty() == false);
+
+    CXMLNode xFormat = CXMLNode::load(sFormatFileName);
+    QVERIFY(xFormat.getNodesByTagName(FORMATTER_TOKEN_FRAGMENT).isEmpty() == false);
+
+    // The corpus of the QML benchmarks with their default settings
+    QTemporaryDir tDirectory;
+    QVERIFY(tDirectory.isValid());
+
+    QMLCorpusGenerator generator;
+    generator.setFileCount(50);
+    generator.setDepth(4);
+    generator.setChildrenPerItem(3);
+    generator.setPropertiesPerItem(4);
+    generator.setFunctionsPerItem(1);
+    generator.setStatementsPerFunction(6);
+    generator.setImportsPerFile(2);
+    generator.setCommentPercent(20);
+
+    QStringList lFileNames = generator.generate(tDirectory.path());
+    QCOMPARE(lFileNames.count(), generator.fileCount());
+
+    QMLTreeContext tContext;
+
+    for (const QString& sFileName : lFileNames)
+    {
+        tContext.addFile(sFileName);
+    }
+
+    QCOMPARE(tContext.parse(), QMLTreeContext::peSuccess);
+
+    // Whole files must be formatted to the same text as with the former fragment processing
+    for (QMLFile* pFile : tContext.files())
+    {
+        QString sExpected;
+        QString sText;
+        QTextStream expectedStream(&sExpected);
+        QTextStream stream(&sText);
+
+        QMLReferenceFormatter tReference;
+        QMLFormatter formatter;
+
+        tReference.setGrammar(xFormat);
+        formatter.setGrammar(xFormat);
+
+        pFile->toQML(expectedStream, tReference);
+        pFile->toQML(stream, formatter);
+        expectedStream.flush();
+        stream.flush();
+
+        QVERIFY(sExpected.contains("\r\n\r\n    "));
+
+        if (sText != sExpected)
+        {
+            int iOffset = 0;
+
+            while (iOffset < qMin(sText.count(), sExpected.count()) && sText[iOffset] == sExpected[iOffset])
+                iOffset++;
+
+            QFAIL(qPrintable(QString("%1 differs at character %2").arg(pFile->fileName()).arg(iOffset)));
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlXMLStream()
+{
+    QTemporaryDir tDirectory;
+    QVERIFY(tDirectory.isValid());
+
+    QString sFileName = writeQMLFile(tDirectory, "Item.qml", {
+        "import QtQuick 2.5",
+        "// The root item",
+        "Item {",
+        "    id: root",
+        "    property string text: \"<a & \\\"b\\\">\"",
+        "    property var list: [ 1, 2.5, null ]",
+        "    function twice(a) { var b = a * 2; for (var i = 0; i < 2; i++) { b++; } return b > 0 ? b : -b; }",
+        "    onWidthChanged: { if (width === undefined) twice(0); else twice(width); }",
+        "    Rectangle { anchors.fill: parent }",
+        "}",
+        ""
+    });
+    QVERIFY(sFileName.isEmpty() == false);
+
+    QMLTreeContext tContext;
+    tContext.addFile(sFileName);
+    QCOMPARE(tContext.parse(), QMLTreeContext::peSuccess);
+
+    QMLFile* pFile = tContext.files().first();
+    CXMLNode xExpected = pFile->toXMLNode(&tContext, nullptr);
+
+    QVERIFY(xExpected.nodes().isEmpty() == false);
+
+    // Streamed to a string
+    QString sText;
+    QXmlStreamWriter xStream(&sText);
+    xStream.writeStartDocument();
+    pFile->toXMLStream(xStream, &tContext);
+    xStream.writeEndDocument();
+
+    QVERIFY(CXMLNode::parseXML(sText) == xExpected);
+
+    // Streamed to a file
+    QString sXMLFileName = tDirectory.path() + "/Item.xml";
+    QVERIFY(pFile->saveXMLToFile(sXMLFileName, &tContext));
+    QVERIFY(CXMLNode::loadXMLFromFile(sXMLFileName) == xExpected);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlAnalyzerWatch()
+{
+    QTemporaryDir tDirectory;
+    QVERIFY(tDirectory.isValid());
+    QVERIFY(QDir(tDirectory.path()).mkdir("Components"));
+
+    QStringList lMain({
+        "import \"Components\"",
+        "Button {",
+        "    property int Bad_Name: 1",
+        "}",
+        ""
+    });
+
+    QString sMainFileName = writeQMLFile(tDirectory, "Main.qml", lMain);
+    QVERIFY(sMainFileName.isEmpty() == false);
+
+    QString sButtonFileName = writeQMLFile(tDirectory, "Components/Button.qml", {
+        "Item {",
+        "    property int goodName: 1",
+        "}",
+        ""
+    });
+    QVERIFY(sButtonFileName.isEmpty() == false);
+
+    CXMLNode xGrammar("Grammar");
+    CXMLNode xNameCheck("Check");
+    xNameCheck.attributes()["Class"] = "QMLPropertyDeclaration";
+    CXMLNode xNameRule("Accept");
+    xNameRule.attributes()["Member"] = "name";
+    xNameRule.attributes()["RegExp"] = "([a-z])([a-zA-Z0-9]*)";
+    xNameRule.attributes()["Text"] = "Only camel casing allowed in names";
+    xNameCheck.nodes() << xNameRule;
+    xGrammar.nodes() << xNameCheck;
+
+    QMLAnalyzer tAnalyzer;
+    tAnalyzer.setFolder(tDirectory.path());
+    tAnalyzer.setIncludeSubFolders(true);
+
+    QSignalSpy tSpy(&tAnalyzer, SIGNAL(analysisUpdated(QStringList)));
+
+    QVERIFY(tAnalyzer.startWatching(xGrammar));
+    QVERIFY(tAnalyzer.isWatching());
+    QCOMPARE(tAnalyzer.errors().count(), 1);
+
+    // Touching a file without changing it does not analyze anything
+    QVERIFY(writeQMLFile(tDirectory, "Main.qml", lMain).isEmpty() == false);
+
+    tAnalyzer.reanalyzeFiles(QStringList({ sMainFileName }));
+    QCOMPARE(tSpy.count(), 0);
+
+    // A changed file is parsed again and the file importing its folder is checked again
+    QVERIFY(writeQMLFile(tDirectory, "Components/Button.qml", {
+        "Item {",
+        "    property int Bad_Too: 1",
+        "}",
+        ""
+    }).isEmpty() == false);
+
+    tAnalyzer.reanalyzeFiles(QStringList({ sButtonFileName }));
+    QCOMPARE(tSpy.count(), 1);
+
+    QStringList lUpdatedFiles = tSpy.takeFirst().at(0).toStringList();
+    QCOMPARE(lUpdatedFiles.count(), 2);
+    QVERIFY(lUpdatedFiles.contains(sMainFileName));
+    QVERIFY(lUpdatedFiles.contains(sButtonFileName));
+    QCOMPARE(tAnalyzer.errors().count(), 2);
+
+    // A removed file drops its errors
+    QVERIFY(QFile::remove(sButtonFileName));
+
+    tAnalyzer.reanalyzeFiles(QStringList({ tDirectory.path() + "/Components" }));
+    QCOMPARE(tSpy.count(), 1);
+    QCOMPARE(tAnalyzer.errors().count(), 1);
+    QCOMPARE(tAnalyzer.errors().first().fileName(), sMainFileName);
+
+    tAnalyzer.stopWatching();
+    QVERIFY(tAnalyzer.isWatching() == false);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlAnalyzerWatchMemory()
+{
+    QTemporaryDir tDirectory;
+    QVERIFY(tDirectory.isValid());
+
+    QString sFileName = tDirectory.path() + "/Main.qml";
+
+    // The same tree with another value, so that each write is a change
+    auto writeMain = [&](int iValue) {
+        QFile file(sFileName);
+        QVERIFY(file.open(QFile::WriteOnly));
+
+        QString sText = "import QtQuick 2.5\n\nItem {\n";
+
+        for (int iProperty = 0; iProperty < 500; iProperty++)
+        {
+            sText += QString("    property int value%1: %2 * (%1 + 1) // Value %1\n").arg(iProperty).arg(iValue % 10);
+        }
+
+        sText += "}\n";
+
+        file.write(sText.toLatin1());
+        file.close();
+    };
+
+    writeMain(0);
+
+    QMLAnalyzer tAnalyzer;
+    tAnalyzer.setFolder(tDirectory.path());
+
+    QVERIFY(tAnalyzer.startWatching(CXMLNode("Grammar")));
+
+    qint64 iInitialBytes = tAnalyzer.context()->arenaBytes();
+    QVERIFY(iInitialBytes > 0);
+
+    // Each reparse frees the tree it replaces
+    for (int iPass = 1; iPass <= 20; iPass++)
+    {
+        writeMain(iPass);
+        tAnalyzer.reanalyzeFiles(QStringList({ sFileName }));
+
+        QCOMPARE(tAnalyzer.context()->files().count(), 1);
+        QCOMPARE(tAnalyzer.context()->arenaBytes(), iInitialBytes);
+    }
+
+    tAnalyzer.stopWatching();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlCorpusGenerator()
+{
+    QTemporaryDir tDirectory;
+    QVERIFY(tDirectory.isValid());
+
+    QMLCorpusGenerator generator;
+    generator.setFileCount(4);
+    generator.setDepth(3);
+    generator.setChildrenPerItem(2);
+    generator.setPropertiesPerItem(5);
+    generator.setFunctionsPerItem(2);
+    generator.setStatementsPerFunction(8);
+    generator.setImportsPerFile(3);
+    generator.setCommentPercent(30);
+
+    // The same settings give the same files, another seed gives other files
+    QMLCorpusGenerator other(generator);
+    QCOMPARE(other.generateFile(2), generator.generateFile(2));
+    QVERIFY(generator.generateFile(1) != generator.generateFile(2));
+
+    other.setSeed(generator.seed() + 1);
+    QVERIFY(other.generateFile(2) != generator.generateFile(2));
+
+    QString sText = generator.generateFile(0);
+    QCOMPARE(sText.count("import "), 3);
+    QCOMPARE(sText.count("function compute"), 7 * 2);
+
+    // Generated files must parse
+    QStringList lFileNames = generator.generate(tDirectory.path());
+    QCOMPARE(lFileNames.count(), 4);
+
+    QMLTreeContext tContext;
+
+    for (const QString& sFileName : lFileNames)
+    {
+        tContext.addFile(sFileName);
+    }
+
+    QCOMPARE(tContext.parse(), QMLTreeContext::peSuccess);
+    QCOMPARE(tContext.files().count(), 4);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::qmlNameInterning()
+{
+    QTemporaryDir tDirectory;
+    QVERIFY(tDirectory.isValid());
+
+    QMLCorpusGenerator generator;
+    generator.setFileCount(6);
+    QStringList lFileNames = generator.generate(tDirectory.path());
+    QCOMPARE(lFileNames.count(), 6);
+
+    // Workers of a parallel parse share the table of the context
+    QMLTreeContext tContext;
+    tContext.setMaxThreads(4);
+
+    for (const QString& sFileName : lFileNames)
+    {
+        tContext.addFile(sFileName);
+    }
+
+    QCOMPARE(tContext.parse(), QMLTreeContext::peSuccess);
+
+    QHash<QString, QMLIdentifier*> hFirstIdentifiers;
+    int iIdentifiers = 0;
+
+    for (QMLFile* pFile : tContext.files())
+    {
+        pFile->buildPositionIndex();
+
+        for (QMLEntity* pEntity : pFile->positionIndex())
+        {
+            QMLIdentifier* pIdentifier = dynamic_cast<QMLIdentifier*>(pEntity);
+
+            if (pIdentifier == nullptr)
+                continue;
+
+            QString sName = pIdentifier->value().toString();
+            iIdentifiers++;
+
+            QVERIFY(pIdentifier->nameId() != NAME_TABLE_INVALID_ID);
+            QCOMPARE(tContext.names().name(pIdentifier->nameId()), sName);
+
+            // The same name has the same ID and the same characters everywhere
+            QMLIdentifier* pFirst = hFirstIdentifiers.value(sName, nullptr);
+
+            if (pFirst == nullptr)
+            {
+                hFirstIdentifiers[sName] = pIdentifier;
+            }
+            else
+            {
+                QCOMPARE(pIdentifier->nameId(), pFirst->nameId());
+                QVERIFY(pIdentifier->value().toString().constData() == pFirst->value().toString().constData());
+            }
+
+            QVERIFY(pIdentifier->hasName(sName, tContext.names().find(sName)));
+            QVERIFY(pIdentifier->hasName("notAName", tContext.names().find("notAName")) == false);
+        }
+    }
+
+    QVERIFY(iIdentifiers > hFirstIdentifiers.count());
+    QVERIFY(tContext.names().count() >= hFirstIdentifiers.count());
+    QVERIFY(tContext.names().savedBytes() > 0);
+    QCOMPARE(tContext.names().find("notAName"), NAME_TABLE_INVALID_ID);
+
+    // Identifiers created outside of a parse are not interned
+    QMLIdentifier tIdentifier(QPoint(), "value0");
+    QCOMPARE(tIdentifier.nameId(), NAME_TABLE_INVALID_ID);
+    QVERIFY(tIdentifier.hasName("value0", tContext.names().find("value0")));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::geoReentrantContexts()
+{
+    const double dClarkeA = 6378206.4;
+    const double dClarkeF = 1 / 294.9786982;
+
+    QVector<double> vLatitudes;
+    QVector<double> vLongitudes;
+
+    for (int iIndex = 0; iIndex < 500; iIndex++)
+    {
+        vLatitudes << (-79.0 + (iIndex * 37 % 163)) * DEG_TO_RAD;
+        vLongitudes << (-179.0 + (iIndex * 53 % 359)) * DEG_TO_RAD;
+    }
+
+    // One set of contexts per ellipsoid
+    Geocentric_Context tGeocentricWGS84, tGeocentricClarke;
+    UTM_Context tUTMWGS84, tUTMClarke;
+    MGRS_Context tMGRSWGS84, tMGRSClarke;
+
+    Init_Geocentric_Context(&tGeocentricWGS84);
+    Init_UTM_Context(&tUTMWGS84);
+    Init_MGRS_Context(&tMGRSWGS84);
+    Init_Geocentric_Context(&tGeocentricClarke);
+    Init_UTM_Context(&tUTMClarke);
+    Init_MGRS_Context(&tMGRSClarke);
+
+    QCOMPARE(Set_Geocentric_Parameters_Ctx(&tGeocentricClarke, dClarkeA, dClarkeF), long(GEOCENT_NO_ERROR));
+    QCOMPARE(Set_UTM_Parameters_Ctx(&tUTMClarke, dClarkeA, dClarkeF, 0), long(UTM_NO_ERROR));
+    QCOMPARE(Set_MGRS_Parameters_Ctx(&tMGRSClarke, dClarkeA, dClarkeF, (char*) "CC"), long(MGRS_NO_ERROR));
+
+    // Sequential references
+    CGeoConversionTask tReferenceWGS84(&tGeocentricWGS84, &tUTMWGS84, &tMGRSWGS84, vLatitudes, vLongitudes);
+    CGeoConversionTask tReferenceClarke(&tGeocentricClarke, &tUTMClarke, &tMGRSClarke, vLatitudes, vLongitudes);
+
+    tReferenceWGS84.run();
+    tReferenceClarke.run();
+
+    QCOMPARE(tReferenceWGS84.results().count(), vLatitudes.count());
+    QVERIFY(tReferenceWGS84.results() != tReferenceClarke.results());
+
+    // The functions without a context use the WGS 84 default
+    double dX, dY, dZ;
+    double dContextX, dContextY, dContextZ;
+
+    Convert_Geodetic_To_Geocentric(vLatitudes[1], vLongitudes[1], 100.0, &dX, &dY, &dZ);
+    Convert_Geodetic_To_Geocentric_Ctx(&tGeocentricWGS84, vLatitudes[1], vLongitudes[1], 100.0, &dContextX, &dContextY, &dContextZ);
+    QCOMPARE(dX, dContextX);
+    QCOMPARE(dY, dContextY);
+    QCOMPARE(dZ, dContextZ);
+
+    // Threads sharing contexts, with two ellipsoids at once
+    QThreadPool tThreadPool;
+    tThreadPool.setMaxThreadCount(8);
+
+    QVector<CGeoConversionTask*> vTasks;
+
+    for (int iIndex = 0; iIndex < 16; iIndex++)
+    {
+        if (iIndex % 2 == 0)
+            vTasks << new CGeoConversionTask(&tGeocentricWGS84, &tUTMWGS84, &tMGRSWGS84, vLatitudes, vLongitudes);
+        else
+            vTasks << new CGeoConversionTask(&tGeocentricClarke, &tUTMClarke, &tMGRSClarke, vLatitudes, vLongitudes);
+
+        tThreadPool.start(vTasks.last());
+    }
+
+    tThreadPool.waitForDone();
+
+    for (int iIndex = 0; iIndex < vTasks.count(); iIndex++)
+    {
+        QCOMPARE(vTasks[iIndex]->results(), iIndex % 2 == 0 ? tReferenceWGS84.results() : tReferenceClarke.results());
+    }
+
+    qDeleteAll(vTasks);
+
+    // Conversions with a context leave the default parameters alone
+    double dA, dF;
+    long lOverride;
+
+    Get_UTM_Parameters(&dA, &dF, &lOverride);
+    QCOMPARE(dA, 6378137.0);
+    QCOMPARE(lOverride, 0L);
+
+    // Two CoordCnv contexts with different database origins
+    COORDCNV_CONTEXT tFirst;
+    COORDCNV_CONTEXT tSecond;
+    double dFirstX, dFirstY, dFirstZ;
+    double dSecondX, dSecondY, dSecondZ;
+
+    CoordCnv::NIU_InitializeCoordinates(&tFirst, 0.6, -2.1, 100.0);
+    CoordCnv::NIU_InitializeCoordinates(&tSecond, -0.4, 0.3, 0.0);
+    CoordCnv::NIU_InitializeCoordinates(0.6, -2.1, 100.0);
+
+    CoordCnv::NIU_UTMLocalToGeocentric(&tFirst, 1000.0, 2000.0, 50.0, &dFirstX, &dFirstY, &dFirstZ);
+    CoordCnv::NIU_UTMLocalToGeocentric(&tSecond, 1000.0, 2000.0, 50.0, &dSecondX, &dSecondY, &dSecondZ);
+    CoordCnv::NIU_UTMLocalToGeocentric(1000.0, 2000.0, 50.0, &dX, &dY, &dZ);
+
+    QCOMPARE(dFirstX, dX);
+    QCOMPARE(dFirstY, dY);
+    QCOMPARE(dFirstZ, dZ);
+    QVERIFY(qAbs(dSecondX - dFirstX) > 1000.0);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::geoBatchConversions()
+{
+    const long iCount = 1000;
+
+    Geocentric_Context tContext;
+    Init_Geocentric_Context(&tContext);
+
+    QVector<double> vLatitudes, vLongitudes, vHeights;
+
+    // Poles, equator and antimeridian included
+    for (long iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        vLatitudes << (-90.0 + (iIndex * 37 % 181)) * DEG_TO_RAD;
+        vLongitudes << (-180.0 + (iIndex * 53 % 361)) * DEG_TO_RAD;
+        vHeights << -500.0 + (iIndex * 7919 % 10000) * 3.0;
+    }
+
+    QVector<double> vX(iCount), vY(iCount), vZ(iCount);
+
+    QCOMPARE(Convert_Geodetic_To_Geocentric_Batch(&tContext, iCount, vLatitudes.constData(), vLongitudes.constData(), vHeights.constData(),
+                                                  vX.data(), vY.data(), vZ.data()), long(GEOCENT_NO_ERROR));
+
+    // Same points as the scalar conversion
+    for (long iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        double dX, dY, dZ;
+
+        Convert_Geodetic_To_Geocentric_Ctx(&tContext, vLatitudes[iIndex], vLongitudes[iIndex], vHeights[iIndex], &dX, &dY, &dZ);
+
+        QVERIFY(qAbs(vX[iIndex] - dX) < 1e-7);
+        QVERIFY(qAbs(vY[iIndex] - dY) < 1e-7);
+        QVERIFY(qAbs(vZ[iIndex] - dZ) < 1e-7);
+    }
+
+    // Round trip, in place : the arrays hold geocentric coordinates until they are converted
+    QVector<double> vBackLatitudes = vX, vBackLongitudes = vY, vBackHeights = vZ;
+
+    Convert_Geocentric_To_Geodetic_Batch(&tContext, iCount, vBackLatitudes.constData(), vBackLongitudes.constData(), vBackHeights.constData(),
+                                         vBackLatitudes.data(), vBackLongitudes.data(), vBackHeights.data());
+
+    for (long iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        QVERIFY(qAbs(vBackLatitudes[iIndex] - vLatitudes[iIndex]) < 1e-12);
+        QVERIFY(qAbs(vBackHeights[iIndex] - vHeights[iIndex]) < 1e-6);
+
+        // Longitude is free at the poles
+        if (qAbs(vLatitudes[iIndex]) < M_PI_2 - 1e-6)
+        {
+            QVERIFY(qAbs(remainder(vBackLongitudes[iIndex] - vLongitudes[iIndex], 2.0 * M_PI)) < 1e-12);
+        }
+    }
+
+    // Points near the center of the Earth, where the closed form is not defined, give the results of single conversions
+    QVector<double> vCenterX({ 0.0, 1.0, 0.0, 1000.0, 20000.0, 7000000.0 });
+    QVector<double> vCenterY({ 0.0, 0.0, 0.0, 1000.0, 0.0, 0.0 });
+    QVector<double> vCenterZ({ 0.0, 0.0, 1000.0, -1000.0, 30000.0, 0.0 });
+    QVector<double> vCenterLatitudes(vCenterX.count()), vCenterLongitudes(vCenterX.count()), vCenterHeights(vCenterX.count());
+
+    Convert_Geocentric_To_Geodetic_Batch(&tContext, vCenterX.count(), vCenterX.constData(), vCenterY.constData(), vCenterZ.constData(),
+                                         vCenterLatitudes.data(), vCenterLongitudes.data(), vCenterHeights.data());
+
+    for (int iIndex = 0; iIndex < vCenterX.count(); iIndex++)
+    {
+        double dLatitude, dLongitude, dHeight;
+        Convert_Geocentric_To_Geodetic_Ctx(&tContext, vCenterX[iIndex], vCenterY[iIndex], vCenterZ[iIndex], &dLatitude, &dLongitude, &dHeight);
+
+        QVERIFY(qIsFinite(vCenterLatitudes[iIndex]) && qIsFinite(vCenterLongitudes[iIndex]) && qIsFinite(vCenterHeights[iIndex]));
+        QVERIFY(qAbs(vCenterLatitudes[iIndex] - dLatitude) < 1e-9);
+        QVERIFY(qAbs(vCenterHeights[iIndex] - dHeight) < 1e-3);
+    }
+
+    // Points between the evolute and a few hundred kilometers from the center go back to the same geocentric point
+    QVector<double> vDeepX({ 50000.0, 0.0, 30000.0, 100000.0, 0.0, -60000.0 });
+    QVector<double> vDeepY({ 0.0, 0.0, 20000.0, 0.0, 0.0, 50000.0 });
+    QVector<double> vDeepZ({ 0.0, 50000.0, 33166.2, 0.0, -100000.0, 58309.5 });
+    QVector<double> vDeepLatitudes(vDeepX.count()), vDeepLongitudes(vDeepX.count()), vDeepHeights(vDeepX.count());
+    QVector<double> vDeepBackX(vDeepX.count()), vDeepBackY(vDeepX.count()), vDeepBackZ(vDeepX.count());
+
+    Convert_Geocentric_To_Geodetic_Batch(&tContext, vDeepX.count(), vDeepX.constData(), vDeepY.constData(), vDeepZ.constData(),
+                                         vDeepLatitudes.data(), vDeepLongitudes.data(), vDeepHeights.data());
+
+    QCOMPARE(Convert_Geodetic_To_Geocentric_Batch(&tContext, vDeepX.count(), vDeepLatitudes.constData(), vDeepLongitudes.constData(), vDeepHeights.constData(),
+                                                  vDeepBackX.data(), vDeepBackY.data(), vDeepBackZ.data()), long(GEOCENT_NO_ERROR));
+
+    for (int iIndex = 0; iIndex < vDeepX.count(); iIndex++)
+    {
+        QVERIFY(qAbs(vDeepBackX[iIndex] - vDeepX[iIndex]) < 1e-6);
+        QVERIFY(qAbs(vDeepBackY[iIndex] - vDeepY[iIndex]) < 1e-6);
+        QVERIFY(qAbs(vDeepBackZ[iIndex] - vDeepZ[iIndex]) < 1e-6);
+    }
+
+    // Local frame around a point of the set, and back
+    QVector<double> vEast(iCount), vNorth(iCount), vUp(iCount);
+    double dOriginLatitude = 45.0 * DEG_TO_RAD;
+    double dOriginLongitude = 6.0 * DEG_TO_RAD;
+
+    QCOMPARE(Convert_Geodetic_To_Local_ENU_Batch(&tContext, dOriginLatitude, dOriginLongitude, 200.0, iCount,
+                                                 vLatitudes.constData(), vLongitudes.constData(), vHeights.constData(),
+                                                 vEast.data(), vNorth.data(), vUp.data()), long(GEOCENT_NO_ERROR));
+
+    double dOrigin[3];
+    Convert_Geodetic_To_Geocentric_Ctx(&tContext, dOriginLatitude, dOriginLongitude, 200.0, &dOrigin[0], &dOrigin[1], &dOrigin[2]);
+
+    // The frame is a rotation : distances to the origin are kept
+    for (long iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        double dLocal = sqrt(vEast[iIndex] * vEast[iIndex] + vNorth[iIndex] * vNorth[iIndex] + vUp[iIndex] * vUp[iIndex]);
+        double dDX = vX[iIndex] - dOrigin[0], dDY = vY[iIndex] - dOrigin[1], dDZ = vZ[iIndex] - dOrigin[2];
+
+        QVERIFY(qAbs(dLocal - sqrt(dDX * dDX + dDY * dDY + dDZ * dDZ)) < 1e-6);
+    }
+
+    QCOMPARE(Convert_Local_ENU_To_Geodetic_Batch(&tContext, dOriginLatitude, dOriginLongitude, 200.0, iCount,
+                                                 vEast.constData(), vNorth.constData(), vUp.constData(),
+                                                 vBackLatitudes.data(), vBackLongitudes.data(), vBackHeights.data()), long(GEOCENT_NO_ERROR));
+
+    for (long iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        QVERIFY(qAbs(vBackLatitudes[iIndex] - vLatitudes[iIndex]) < 1e-12);
+        QVERIFY(qAbs(vBackHeights[iIndex] - vHeights[iIndex]) < 1e-6);
+    }
+
+    // One invalid point cancels the whole conversion
+    vX.fill(0.0);
+    vLatitudes[iCount / 2] = 91.0 * DEG_TO_RAD;
+    vLongitudes[iCount / 3] = -181.0 * DEG_TO_RAD;
+
+    QCOMPARE(Convert_Geodetic_To_Geocentric_Batch(&tContext, iCount, vLatitudes.constData(), vLongitudes.constData(), vHeights.constData(),
+                                                  vX.data(), vY.data(), vZ.data()), long(GEOCENT_LAT_ERROR | GEOCENT_LON_ERROR));
+    QCOMPARE(vX.count(0.0), int(iCount));
+
+    // Approximations against the math library
+    double dAngles[] = { -2.0 * M_PI, -3.0, -M_PI_2, -0.1, 0.0, 0.7, M_PI_2, 2.5, 6.0 };
+    double dSines[9], dCosines[9], dArcs[9];
+
+    Sin_Cos_Batch(9, dAngles, dSines, dCosines);
+    Atan2_Batch(9, dSines, dCosines, dArcs);
+
+    for (int iIndex = 0; iIndex < 9; iIndex++)
+    {
+        QVERIFY(qAbs(dSines[iIndex] - sin(dAngles[iIndex])) < 1e-15);
+        QVERIFY(qAbs(dCosines[iIndex] - cos(dAngles[iIndex])) < 1e-15);
+        QVERIFY(qAbs(dArcs[iIndex] - atan2(dSines[iIndex], dCosines[iIndex])) < 1e-15);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::geoBatchThroughput()
+{
+    const long iCount = 100000;
+
+    Geocentric_Context tContext;
+    Init_Geocentric_Context(&tContext);
+
+    QVector<double> vLatitudes(iCount), vLongitudes(iCount), vHeights(iCount);
+    QVector<double> vX(iCount), vY(iCount), vZ(iCount);
+
+    for (long iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        vLatitudes[iIndex] = (-89.0 + (iIndex % 179)) * DEG_TO_RAD;
+        vLongitudes[iIndex] = (-179.0 + (iIndex % 359)) * DEG_TO_RAD;
+        vHeights[iIndex] = double(iIndex % 9000);
+    }
+
+    QBENCHMARK
+    {
+        Convert_Geodetic_To_Geocentric_Batch(&tContext, iCount, vLatitudes.constData(), vLongitudes.constData(), vHeights.constData(),
+                                             vX.data(), vY.data(), vZ.data());
+
+        Convert_Geocentric_To_Geodetic_Batch(&tContext, iCount, vX.constData(), vY.constData(), vZ.constData(),
+                                             vLatitudes.data(), vLongitudes.data(), vHeights.data());
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::geoBatchUTMMGRS()
+{
+    const long iCount = 20000;
+
+    QVector<double> vLatitudes(iCount), vLongitudes(iCount);
+
+    // All zones and bands, both hemispheres, poles included
+    for (long iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        vLatitudes[iIndex] = (-90.0 + (iIndex * 37 % 18001) * 0.01) * DEG_TO_RAD;
+        vLongitudes[iIndex] = (-180.0 + (iIndex * 53 % 35999) * 0.01) * DEG_TO_RAD;
+    }
+
+    // Norway and Svalbard zone exceptions
+    vLatitudes[0] = 60.5 * DEG_TO_RAD;
+    vLongitudes[0] = 4.0 * DEG_TO_RAD;
+    vLatitudes[1] = 78.0 * DEG_TO_RAD;
+    vLongitudes[1] = 20.0 * DEG_TO_RAD;
+    vLatitudes[2] = 56.5 * DEG_TO_RAD;
+    vLongitudes[2] = 2.5 * DEG_TO_RAD;
+
+    // UTM : batch results are those of single conversions
+    UTM_Context tUTM;
+    Init_UTM_Context(&tUTM);
+
+    QScopedPointer<UTM_Zone_Cache> pUTMCache(new UTM_Zone_Cache);
+    QCOMPARE(Init_UTM_Zone_Cache(pUTMCache.data(), &tUTM), long(UTM_NO_ERROR));
+
+    QVector<long> vZones(iCount), vErrors(iCount);
+    QVector<char> vHemispheres(iCount);
+    QVector<double> vEastings(iCount), vNorthings(iCount);
+    QVector<double> vBackLatitudes(iCount), vBackLongitudes(iCount);
+
+    Convert_Geodetic_To_UTM_Batch(pUTMCache.data(), iCount, vLatitudes.constData(), vLongitudes.constData(),
+                                  vZones.data(), vHemispheres.data(), vEastings.data(), vNorthings.data(), vErrors.data());
+
+    QCOMPARE(vZones[0], 32L);
+    QCOMPARE(vZones[1], 33L);
+    QCOMPARE(vZones[2], 31L);
+
+    int iUTMPoints = 0;
+
+    for (long iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        long lZone;
+        char cHemisphere;
+        double dEasting, dNorthing;
+
+        long lError = Convert_Geodetic_To_UTM_Ctx(&tUTM, vLatitudes[iIndex], vLongitudes[iIndex], &lZone, &cHemisphere, &dEasting, &dNorthing);
+
+        QCOMPARE(vErrors[iIndex], lError);
+
+        if (lError == UTM_NO_ERROR)
+        {
+            QCOMPARE(vZones[iIndex], lZone);
+            QCOMPARE(vHemispheres[iIndex], cHemisphere);
+            QCOMPARE(vEastings[iIndex], dEasting);
+            QCOMPARE(vNorthings[iIndex], dNorthing);
+            iUTMPoints++;
+        }
+    }
+
+    QVERIFY(iUTMPoints > iCount * 3 / 4);
+
+    // UTM round trip, sequential and threaded
+    long lSequential = GeoTrans::Convert_UTM_To_Geodetic_Batch(iCount, vZones.constData(), vHemispheres.constData(),
+                                                               vEastings.constData(), vNorthings.constData(),
+                                                               vBackLatitudes.data(), vBackLongitudes.data(), vErrors.data(), 1);
+
+    QVector<double> vThreadedLatitudes(iCount), vThreadedLongitudes(iCount);
+    QVector<long> vThreadedErrors(iCount);
+
+    long lThreaded = GeoTrans::Convert_UTM_To_Geodetic_Batch(iCount, vZones.constData(), vHemispheres.constData(),
+                                                             vEastings.constData(), vNorthings.constData(),
+                                                             vThreadedLatitudes.data(), vThreadedLongitudes.data(), vThreadedErrors.data(), 4);
+
+    QCOMPARE(lThreaded, lSequential);
+    QCOMPARE(vThreadedErrors, vErrors);
+    QCOMPARE(vThreadedLatitudes, vBackLatitudes);
+    QCOMPARE(vThreadedLongitudes, vBackLongitudes);
+
+    for (long iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        if (vErrors[iIndex] == UTM_NO_ERROR && qAbs(vLatitudes[iIndex]) <= 84.0 * DEG_TO_RAD)
+        {
+            QVERIFY(qAbs(vBackLatitudes[iIndex] - vLatitudes[iIndex]) < 1e-9);
+            QVERIFY(qAbs(remainder(vBackLongitudes[iIndex] - vLongitudes[iIndex], 2 * M_PI)) < 1e-9);
+        }
+    }
+
+    // MGRS : batch results are those of single conversions, threads included
+    MGRS_Context tMGRS;
+    Init_MGRS_Context(&tMGRS);
+
+    QScopedPointer<MGRS_Zone_Cache> pMGRSCache(new MGRS_Zone_Cache);
+    QCOMPARE(Init_MGRS_Zone_Cache(pMGRSCache.data(), &tMGRS), long(MGRS_NO_ERROR));
+
+    QVector<char> vMGRS(iCount * MGRS_STRING_SIZE), vThreadedMGRS(iCount * MGRS_STRING_SIZE);
+
+    Convert_Geodetic_To_MGRS_Batch(pMGRSCache.data(), iCount, vLatitudes.constData(), vLongitudes.constData(), 5, vMGRS.data(), vErrors.data());
+    GeoTrans::Convert_Geodetic_To_MGRS_Batch(iCount, vLatitudes.constData(), vLongitudes.constData(), 5, vThreadedMGRS.data(), vThreadedErrors.data(), 4);
+
+    QCOMPARE(vThreadedErrors, vErrors);
+    QCOMPARE(vThreadedMGRS, vMGRS);
+    QCOMPARE(QString(&vMGRS[0]), QString("32VKN2551017531"));
+
+    for (long iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        char sMGRS[MGRS_STRING_SIZE];
+
+        QCOMPARE(vErrors[iIndex], Convert_Geodetic_To_MGRS_Ctx(&tMGRS, vLatitudes[iIndex], vLongitudes[iIndex], 5, sMGRS));
+
+        if (vErrors[iIndex] == MGRS_NO_ERROR)
+            QCOMPARE(QString(&vMGRS[iIndex * MGRS_STRING_SIZE]), QString(sMGRS));
+    }
+
+    // MGRS round trip, within the 1 meter precision
+    GeoTrans::Convert_MGRS_To_Geodetic_Batch(iCount, vMGRS.constData(), vBackLatitudes.data(), vBackLongitudes.data(), vThreadedErrors.data(), 4);
+
+    for (long iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        double dLatitude, dLongitude;
+
+        QCOMPARE(vThreadedErrors[iIndex], Convert_MGRS_To_Geodetic_Ctx(&tMGRS, &vMGRS[iIndex * MGRS_STRING_SIZE], &dLatitude, &dLongitude));
+
+        if (vErrors[iIndex] == MGRS_NO_ERROR && vThreadedErrors[iIndex] == MGRS_NO_ERROR)
+        {
+            QCOMPARE(vBackLatitudes[iIndex], dLatitude);
+            QVERIFY(qAbs(vBackLatitudes[iIndex] - vLatitudes[iIndex]) < 5e-7);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::geoMagneticModel()
+{
+    QFile file(":/WMM.COF");
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray baText = file.readAll();
+
+    WMM_Model tModel;
+    QCOMPARE(Parse_WMM_Coefficients(&tModel, baText.constData()), long(WMM_NO_ERROR));
+    QCOMPARE(tModel.Epoch, 2015.0);
+    QCOMPARE(tModel.Degree, long(WMM_MAX_DEGREE));
+    QCOMPARE(QString(tModel.Name), QString("WMM-2015"));
+
+    // Test values of the WMM 2015 report : year, height (km), latitude, longitude, X, Y, Z (nT), D, I (degrees)
+    const double dTestValues[12][9] =
+    {
+        { 2015.0,   0,  80,   0,  6627.1,  -445.9,  54432.3, -3.85,  83.04 },
+        { 2015.0,   0,   0, 120, 39518.2,   392.9, -11252.4,  0.57, -15.89 },
+        { 2015.0,   0, -80, 240,  5797.3, 15761.1, -52919.1, 69.81, -72.39 },
+        { 2015.0, 100,  80,   0,  6314.3,  -471.6,  52269.8, -4.27,  83.09 },
+        { 2015.0, 100,   0, 120, 37535.6,   364.4, -10773.4,  0.56, -16.01 },
+        { 2015.0, 100, -80, 240,  5613.1, 14791.5, -50378.6, 69.22, -72.57 },
+        { 2017.5,   0,  80,   0,  6599.4,  -317.1,  54459.2, -2.75,  83.08 },
+        { 2017.5,   0,   0, 120, 39571.4,   222.5, -11030.1,  0.32, -15.57 },
+        { 2017.5,   0, -80, 240,  5873.8, 15781.4, -52687.9, 69.58, -72.28 },
+        { 2017.5, 100,  80,   0,  6290.5,  -348.5,  52292.7, -3.17,  83.13 },
+        { 2017.5, 100,   0, 120, 37585.5,   209.5, -10564.2,  0.32, -15.70 },
+        { 2017.5, 100, -80, 240,  5683.5, 14808.8, -50163.0, 69.00, -72.45 },
+    };
+
+    for (int iIndex = 0; iIndex < 12; iIndex++)
+    {
+        const double* pValues = dTestValues[iIndex];
+        WMM_Field tField;
+
+        QCOMPARE(Compute_WMM_Field(&tModel, pValues[2] * DEG_TO_RAD, pValues[3] * DEG_TO_RAD, pValues[1] * 1000.0, pValues[0], &tField), long(WMM_NO_ERROR));
+        QVERIFY(qAbs(tField.X - pValues[4]) <= 0.1);
+        QVERIFY(qAbs(tField.Y - pValues[5]) <= 0.1);
+        QVERIFY(qAbs(tField.Z - pValues[6]) <= 0.1);
+        QVERIFY(qAbs(tField.Declination / DEG_TO_RAD - pValues[7]) <= 0.01);
+        QVERIFY(qAbs(tField.Inclination / DEG_TO_RAD - pValues[8]) <= 0.01);
+    }
+
+    // The batch gives the results of single evaluations, poles included
+    QVector<double> vLatitudes, vLongitudes, vHeights;
+
+    for (int iIndex = 0; iIndex < 200; iIndex++)
+    {
+        vLatitudes << (-90.0 + (iIndex * 37 % 181)) * DEG_TO_RAD;
+        vLongitudes << (-180.0 + (iIndex * 53 % 361)) * DEG_TO_RAD;
+        vHeights << (iIndex % 7) * 10000.0;
+    }
+
+    QVector<WMM_Field> vFields(vLatitudes.count());
+    const double dYear = WMM_Decimal_Year(2017, 7, 2);
+
+    QVERIFY(qAbs(dYear - 2017.4986) < 1e-4);
+    QCOMPARE(Compute_WMM_Field_Batch(&tModel, dYear, vLatitudes.count(), vLatitudes.constData(), vLongitudes.constData(), vHeights.constData(), vFields.data()), long(WMM_NO_ERROR));
+
+    for (int iIndex = 0; iIndex < vLatitudes.count(); iIndex++)
+    {
+        WMM_Field tField;
+
+        Compute_WMM_Field(&tModel, vLatitudes[iIndex], vLongitudes[iIndex], vHeights[iIndex], dYear, &tField);
+        QCOMPARE(vFields[iIndex].X, tField.X);
+        QCOMPARE(vFields[iIndex].Y, tField.Y);
+        QCOMPARE(vFields[iIndex].Z, tField.Z);
+        QVERIFY(vFields[iIndex].F > 20000.0 && vFields[iIndex].F < 70000.0);
+    }
+
+    // The field is continuous at the poles
+    WMM_Field tPole, tNearPole;
+
+    Compute_WMM_Field(&tModel, M_PI_2, 0.5, 0.0, 2016.0, &tPole);
+    Compute_WMM_Field(&tModel, M_PI_2 - 1e-9, 0.5, 0.0, 2016.0, &tNearPole);
+    QVERIFY(qAbs(tPole.X - tNearPole.X) < 0.01);
+    QVERIFY(qAbs(tPole.Y - tNearPole.Y) < 0.01);
+
+    // Errors
+    WMM_Field tField;
+
+    QCOMPARE(Compute_WMM_Field(&tModel, 0.0, 0.0, 0.0, 2022.0, &tField), long(WMM_DATE_WARNING));
+    QCOMPARE(Compute_WMM_Field(&tModel, 2.0, 0.0, 0.0, 2016.0, &tField), long(WMM_LAT_ERROR));
+    QCOMPARE(Parse_WMM_Coefficients(&tModel, "    2015.0            WMM-2015        12/15/2014\n  1  0  -29438.5\n"), long(WMM_FORMAT_ERROR));
+    QCOMPARE(Read_WMM_Coefficients(&tModel, "missing/WMM.COF"), long(WMM_FILE_ERROR));
+
+    // Bundled model
+    double dDeclination = 0.0, dInclination = 0.0;
+
+    QCOMPARE(GeoTrans::Compute_Magnetic_Declination(80.0 * DEG_TO_RAD, 0.0, 0.0, 2015.0, &dDeclination, &dInclination), long(WMM_NO_ERROR));
+    QVERIFY(qAbs(dDeclination / DEG_TO_RAD + 3.85) <= 0.01);
+    QVERIFY(qAbs(dInclination / DEG_TO_RAD - 83.04) <= 0.01);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::geoReferenceFrames()
+{
+    const double dOriginLatitude = 43.9397103 * DEG_TO_RAD;
+    const double dOriginLongitude = 3.1230947 * DEG_TO_RAD;
+    const double dOriginAltitude = 250.0;
+    const int iCount = 500;
+
+    CGeoReferenceFrame tFrame(dOriginLatitude, dOriginLongitude, dOriginAltitude);
+
+    QVector<double> vLatitudes(iCount), vLongitudes(iCount), vAltitudes(iCount);
+
+    for (int iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        vLatitudes[iIndex] = dOriginLatitude + ((iIndex * 37 % 201) - 100) * 1e-4;
+        vLongitudes[iIndex] = dOriginLongitude + ((iIndex * 53 % 201) - 100) * 1e-4;
+        vAltitudes[iIndex] = (iIndex * 7919 % 5000) - 100.0;
+    }
+
+    // Same results as the batch conversions of GeoTools
+    Geocentric_Context tContext;
+    Init_Geocentric_Context(&tContext);
+
+    QVector<double> vEast(iCount), vNorth(iCount), vUp(iCount);
+    QVector<double> vReferenceEast(iCount), vReferenceNorth(iCount), vReferenceUp(iCount);
+
+    QVERIFY(tFrame.geodeticToENU(iCount, vLatitudes.constData(), vLongitudes.constData(), vAltitudes.constData(), vEast.data(), vNorth.data(), vUp.data()));
+    QCOMPARE(Convert_Geodetic_To_Local_ENU_Batch(&tContext, dOriginLatitude, dOriginLongitude, dOriginAltitude, iCount,
+                                                 vLatitudes.constData(), vLongitudes.constData(), vAltitudes.constData(),
+                                                 vReferenceEast.data(), vReferenceNorth.data(), vReferenceUp.data()), long(GEOCENT_NO_ERROR));
+
+    for (int iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        QVERIFY(qAbs(vEast[iIndex] - vReferenceEast[iIndex]) < 1e-6);
+        QVERIFY(qAbs(vNorth[iIndex] - vReferenceNorth[iIndex]) < 1e-6);
+        QVERIFY(qAbs(vUp[iIndex] - vReferenceUp[iIndex]) < 1e-6);
+    }
+
+    // NED is ENU with swapped horizontal axes and a downward vertical
+    QVector<double> vNEDNorth(iCount), vNEDEast(iCount), vNEDDown(iCount);
+
+    QVERIFY(tFrame.geodeticToNED(iCount, vLatitudes.constData(), vLongitudes.constData(), vAltitudes.constData(), vNEDNorth.data(), vNEDEast.data(), vNEDDown.data()));
+
+    for (int iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        QCOMPARE(vNEDNorth[iIndex], vNorth[iIndex]);
+        QCOMPARE(vNEDEast[iIndex], vEast[iIndex]);
+        QCOMPARE(vNEDDown[iIndex], -vUp[iIndex]);
+    }
+
+    // Round trips, in place
+    tFrame.ENUToGeodetic(iCount, vEast.constData(), vNorth.constData(), vUp.constData(), vEast.data(), vNorth.data(), vUp.data());
+    tFrame.NEDToGeodetic(iCount, vNEDNorth.constData(), vNEDEast.constData(), vNEDDown.constData(), vNEDNorth.data(), vNEDEast.data(), vNEDDown.data());
+
+    for (int iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        QVERIFY(qAbs(vEast[iIndex] - vLatitudes[iIndex]) < 1e-12);
+        QVERIFY(qAbs(vNorth[iIndex] - vLongitudes[iIndex]) < 1e-12);
+        QVERIFY(qAbs(vUp[iIndex] - vAltitudes[iIndex]) < 1e-5);
+        QVERIFY(qAbs(vNEDNorth[iIndex] - vLatitudes[iIndex]) < 1e-12);
+        QVERIFY(qAbs(vNEDEast[iIndex] - vLongitudes[iIndex]) < 1e-12);
+        QVERIFY(qAbs(vNEDDown[iIndex] - vAltitudes[iIndex]) < 1e-5);
+    }
+
+    // The origin maps to 0, the normal of the ellipsoid to Up
+    double dX = tFrame.originX(), dY = tFrame.originY(), dZ = tFrame.originZ();
+    double dEast, dNorth, dUp;
+
+    tFrame.geocentricToENU(1, &dX, &dY, &dZ, &dEast, &dNorth, &dUp);
+    QVERIFY(qAbs(dEast) < 1e-9 && qAbs(dNorth) < 1e-9 && qAbs(dUp) < 1e-9);
+
+    dEast = 0.0; dNorth = 0.0; dUp = 100.0;
+    tFrame.ENUToGeodetic(1, &dEast, &dNorth, &dUp, &dX, &dY, &dZ);
+    QVERIFY(qAbs(dX - dOriginLatitude) < 1e-12);
+    QVERIFY(qAbs(dY - dOriginLongitude) < 1e-12);
+    QVERIFY(qAbs(dZ - (dOriginAltitude + 100.0)) < 1e-6);
+
+    // Out of range coordinates
+    double dBadLatitude = 2.0;
+    QVERIFY(tFrame.geodeticToENU(1, &dBadLatitude, &dOriginLongitude, &dOriginAltitude, &dEast, &dNorth, &dUp) == false);
+
+    // Frame cache
+    CGeoUtilities* pUtilities = CGeoUtilities::getInstance();
+    pUtilities->setReferenceFrameCacheSize(2);
+
+    int iHits = pUtilities->referenceFrameHits();
+    int iMisses = pUtilities->referenceFrameMisses();
+
+    CGeoReferenceFrame tFirst = pUtilities->referenceFrame(dOriginLatitude, dOriginLongitude, dOriginAltitude);
+    CGeoReferenceFrame tAgain = pUtilities->referenceFrame(dOriginLatitude + CGeoUtilities::FRAME_ANGLE_STEP * 0.1, dOriginLongitude, dOriginAltitude + 0.001);
+
+    QCOMPARE(pUtilities->referenceFrameMisses(), iMisses + 1);
+    QCOMPARE(pUtilities->referenceFrameHits(), iHits + 1);
+    QCOMPARE(tAgain.originX(), tFirst.originX());
+    QVERIFY(qAbs(tFirst.latitude() - dOriginLatitude) <= CGeoUtilities::FRAME_ANGLE_STEP);
+    QVERIFY(qAbs(tFirst.originX() - tFrame.originX()) < 0.01);
+
+    // The least recently used frame goes first
+    pUtilities->referenceFrame(0.1, 0.2, 0.0);
+    pUtilities->referenceFrame(dOriginLatitude, dOriginLongitude, dOriginAltitude);
+    pUtilities->referenceFrame(0.3, 0.4, 0.0);
+    pUtilities->referenceFrame(dOriginLatitude, dOriginLongitude, dOriginAltitude);
+
+    QCOMPARE(pUtilities->referenceFrameHits(), iHits + 3);
+    QCOMPARE(pUtilities->referenceFrameMisses(), iMisses + 3);
+
+    pUtilities->referenceFrame(0.1, 0.2, 0.0);
+    QCOMPARE(pUtilities->referenceFrameMisses(), iMisses + 4);
+
+    // The cache is shared by the whole process
+    pUtilities->setReferenceFrameCacheSize(CGeoUtilities::FRAME_CACHE_SIZE);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+//! Fills vLatitudes and vLongitudes with iCount points spread over the sphere
+static void makeGeoIndexPoints(int iCount, quint32 uSeed, QVector<qint64>& vIds, QVector<double>& vLatitudes, QVector<double>& vLongitudes)
+{
+    vIds.resize(iCount);
+    vLatitudes.resize(iCount);
+    vLongitudes.resize(iCount);
+
+    for (int iIndex = 0; iIndex < iCount; iIndex++)
+    {
+        uSeed = uSeed * 1664525u + 1013904223u;
+        double dZ = (uSeed / 4294967296.0) * 2.0 - 1.0;
+        uSeed = uSeed * 1664525u + 1013904223u;
+        double dLongitude = (uSeed / 4294967296.0) * 2.0 * M_PI - M_PI;
+
+        vIds[iIndex] = iIndex;
+        vLatitudes[iIndex] = asin(dZ);
+        vLongitudes[iIndex] = dLongitude;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::geoIndexQueries()
+{
+    const int iCount = 5000;
+
+    QVector<qint64> vIds;
+    QVector<double> vLatitudes, vLongitudes;
+
+    makeGeoIndexPoints(iCount, 12345, vIds, vLatitudes, vLongitudes);
+
+    // A few points at the poles and on the antimeridian
+    vLatitudes[0] = M_PI / 2.0;
+    vLatitudes[1] = -M_PI / 2.0;
+    vLongitudes[2] = M_PI;
+    vLongitudes[3] = -M_PI;
+
+    CGeoIndex tIndex;
+    tIndex.build(vIds, vLatitudes, vLongitudes);
+
+    QCOMPARE(tIndex.count(), iCount);
+
+    // Great-circle distances
+    QVERIFY(qAbs(CGeoIndex::greatCircleDistance(0.0, 0.0, 0.0, M_PI) - M_PI * CGeoIndex::EARTH_RADIUS) < 1e-6);
+    QVERIFY(qAbs(CGeoIndex::greatCircleDistance(M_PI / 2.0, 0.0, 0.0, 1.0) - M_PI / 2.0 * CGeoIndex::EARTH_RADIUS) < 1e-6);
+    QVERIFY(qAbs(CGeoIndex::greatCircleDistance(0.1, M_PI - 1e-7, 0.1, -M_PI + 1e-7) - 2e-7 * cos(0.1) * CGeoIndex::EARTH_RADIUS) < 1e-3);
+
+    // Queries against brute force, the index is changed between rounds
+    for (int iRound = 0; iRound < 3; iRound++)
+    {
+        for (int iQuery = 0; iQuery < 50; iQuery++)
+        {
+            double dLatitude = vLatitudes[iQuery * 97 % iCount];
+            double dLongitude = vLongitudes[iQuery * 89 % iCount];
+
+            if (iQuery == 0) { dLatitude = M_PI / 2.0; }
+            if (iQuery == 1) { dLongitude = M_PI; }
+
+            QVector<QPair<double, qint64>> vExpected;
+
+            for (int iIndex = 0; iIndex < iCount; iIndex++)
+            {
+                if (tIndex.contains(vIds[iIndex]))
+                    vExpected << QPair<double, qint64>(CGeoIndex::greatCircleDistance(dLatitude, dLongitude, vLatitudes[iIndex], vLongitudes[iIndex]), vIds[iIndex]);
+            }
+
+            std::sort(vExpected.begin(), vExpected.end());
+
+            // k nearest neighbours
+            QVector<CGeoIndex::Neighbour> vNearest = tIndex.nearest(dLatitude, dLongitude, 10);
+
+            QCOMPARE(vNearest.count(), 10);
+
+            for (int iIndex = 0; iIndex < vNearest.count(); iIndex++)
+            {
+                QVERIFY(qAbs(vNearest[iIndex].dDistance - vExpected[iIndex].first) < 1e-6);
+            }
+
+            // Radius
+            const double dRadius = 500000.0;
+            QVector<CGeoIndex::Neighbour> vWithin = tIndex.withinDistance(dLatitude, dLongitude, dRadius);
+            int iExpected = 0;
+
+            while (iExpected < vExpected.count() && vExpected[iExpected].first <= dRadius)
+                iExpected++;
+
+            QCOMPARE(vWithin.count(), iExpected);
+
+            for (int iIndex = 1; iIndex < vWithin.count(); iIndex++)
+            {
+                QVERIFY(vWithin[iIndex].dDistance >= vWithin[iIndex - 1].dDistance);
+            }
+        }
+
+        // Boxes, including one across the antimeridian and one around a pole
+        const double dBoxes[][4] = {
+            { -0.3, -0.5, 0.2, 0.4 },
+            { -0.4, 3.0, 0.5, -2.9 },
+            { 1.3, -M_PI, M_PI / 2.0, M_PI },
+            { -M_PI / 2.0, -0.1, -1.2, 2.5 }
+        };
+
+        for (const auto& dBox : dBoxes)
+        {
+            QVector<qint64> vBox = tIndex.withinBox(dBox[0], dBox[1], dBox[2], dBox[3]);
+            QVector<qint64> vExpected;
+
+            for (int iIndex = 0; iIndex < iCount; iIndex++)
+            {
+                if (tIndex.contains(vIds[iIndex]) == false)
+                    continue;
+
+                bool bLongitude = dBox[1] <= dBox[3]
+                        ? (vLongitudes[iIndex] >= dBox[1] && vLongitudes[iIndex] <= dBox[3])
+                        : (vLongitudes[iIndex] >= dBox[1] || vLongitudes[iIndex] <= dBox[3]);
+
+                if (vLatitudes[iIndex] >= dBox[0] && vLatitudes[iIndex] <= dBox[2] && bLongitude)
+                    vExpected << vIds[iIndex];
+            }
+
+            std::sort(vBox.begin(), vBox.end());
+            QCOMPARE(vBox, vExpected);
+        }
+
+        // Remove some points and move others
+        for (int iIndex = iRound; iIndex < iCount; iIndex += 7)
+        {
+            QVERIFY(tIndex.remove(vIds[iIndex]));
+            QVERIFY(tIndex.remove(vIds[iIndex]) == false);
+        }
+
+        for (int iIndex = iRound + 3; iIndex < iCount; iIndex += 11)
+        {
+            vLatitudes[iIndex] = -vLatitudes[iIndex];
+            vLongitudes[iIndex] = vLongitudes[iIndex] / 2.0;
+            tIndex.insert(vIds[iIndex], vLatitudes[iIndex], vLongitudes[iIndex]);
+        }
+
+        int iLive = 0;
+
+        for (int iIndex = 0; iIndex < iCount; iIndex++)
+        {
+            if (tIndex.contains(vIds[iIndex]))
+                iLive++;
+        }
+
+        QCOMPARE(tIndex.count(), iLive);
+    }
+
+    tIndex.clear();
+    QCOMPARE(tIndex.count(), 0);
+    QVERIFY(tIndex.nearest(0.0, 0.0, 5).isEmpty());
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::geoIndexThroughput_data()
+{
+    QTest::addColumn<bool>("bIndexed");
+    QTest::addColumn<int>("iCount");
+
+    QTest::newRow("brute force, 10000 points") << false << 10000;
+    QTest::newRow("index, 10000 points") << true << 10000;
+    QTest::newRow("brute force, 100000 points") << false << 100000;
+    QTest::newRow("index, 100000 points") << true << 100000;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::geoIndexThroughput()
+{
+    QFETCH(bool, bIndexed);
+    QFETCH(int, iCount);
+
+    const int iQueries = 100;
+
+    QVector<qint64> vIds;
+    QVector<double> vLatitudes, vLongitudes;
+
+    makeGeoIndexPoints(iCount, 54321, vIds, vLatitudes, vLongitudes);
+
+    CGeoIndex tIndex;
+    tIndex.build(vIds, vLatitudes, vLongitudes);
+
+    // 10 nearest neighbours of iQueries points
+    QBENCHMARK
+    {
+        for (int iQuery = 0; iQuery < iQueries; iQuery++)
+        {
+            double dLatitude = vLatitudes[iQuery];
+            double dLongitude = vLongitudes[iQuery] + 0.001;
+
+            if (bIndexed)
+            {
+                tIndex.nearest(dLatitude, dLongitude, 10);
+            }
+            else
+            {
+                QVector<QPair<double, qint64>> vDistances(iCount);
+
+                for (int iIndex = 0; iIndex < iCount; iIndex++)
+                {
+                    vDistances[iIndex].first = CGeoIndex::greatCircleDistance(dLatitude, dLongitude, vLatitudes[iIndex], vLongitudes[iIndex]);
+                    vDistances[iIndex].second = vIds[iIndex];
+                }
+
+                std::partial_sort(vDistances.begin(), vDistances.begin() + 10, vDistances.end());
+            }
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::soundRingBuffer()
+{
+    CSoundRingBuffer tRing(8);
+    char vData[16];
+
+    QCOMPARE(tRing.size(), 8);
+
+    // Reads before the first fill are not underruns
+    QCOMPARE(tRing.read(vData, 4), qint64(0));
+    QCOMPARE(tRing.underrunCount(), qint64(0));
+
+    // Writes and reads wrap around the end of the buffer
+    for (int iPass = 0; iPass < 5; iPass++)
+    {
+        QCOMPARE(tRing.write("abcdef", 6), qint64(6));
+        QCOMPARE(tRing.bufferedBytes(), qint64(6));
+        QCOMPARE(tRing.freeBytes(), qint64(2));
+        QCOMPARE(tRing.read(vData, 6), qint64(6));
+        QCOMPARE(QByteArray(vData, 6), QByteArray("abcdef"));
+    }
+
+    QCOMPARE(tRing.underrunCount(), qint64(0));
+    QCOMPARE(tRing.overrunCount(), qint64(0));
+
+    // A write that does not fit is an overrun
+    QCOMPARE(tRing.write("0123456789", 10), qint64(8));
+    QCOMPARE(tRing.overrunCount(), qint64(1));
+
+    // A read larger than the buffer that empties it is not an underrun
+    QCOMPARE(tRing.read(vData, 16), qint64(8));
+    QCOMPARE(QByteArray(vData, 8), QByteArray("01234567"));
+    QCOMPARE(tRing.underrunCount(), qint64(0));
+
+    // A short read once filled is an underrun
+    QCOMPARE(tRing.write("uvwxyz!", 7), qint64(7));
+    QCOMPARE(tRing.read(vData, 8), qint64(7));
+    QCOMPARE(tRing.underrunCount(), qint64(1));
+
+    // Reserved space is split at the end of the buffer
+    char* pFirst = nullptr;
+    char* pSecond = nullptr;
+    qint64 iFirst = 0;
+
+    QCOMPARE(tRing.reserve(6, pFirst, iFirst, pSecond), qint64(6));
+    QCOMPARE(iFirst, qint64(3));
+    memcpy(pFirst, "ABC", 3);
+    memcpy(pSecond, "DEF", 3);
+    tRing.commit(6);
+
+    QCOMPARE(tRing.reserve(6, pFirst, iFirst, pSecond), qint64(2));
+    QCOMPARE(tRing.read(vData, 6), qint64(6));
+    QCOMPARE(QByteArray(vData, 6), QByteArray("ABCDEF"));
+    QCOMPARE(tRing.underrunCount(), qint64(1));
+    QCOMPARE(tRing.overrunCount(), qint64(1));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::soundVoiceBank()
+{
+    const int iSampleRate = 44100;
+
+    // A sine of 441 Hz has a period of 100 samples
+    {
+        CSoundVoiceBank tBank(4, iSampleRate);
+        tBank.setEnvelope(0.0, 0.0, 1.0, 0.0);
+
+        QCOMPARE(tBank.noteOn(CSoundVoiceBank::wSine, 441.0, 1.0), 0);
+        QCOMPARE(tBank.activeVoiceCount(), 1);
+
+        QVector<float> vSamples(iSampleRate);
+        tBank.render(vSamples.data(), vSamples.count());
+
+        for (int iIndex = CSoundVoiceBank::BlockFrames; iIndex < vSamples.count(); iIndex++)
+        {
+            QVERIFY(qAbs(vSamples[iIndex] - sin(2.0 * M_PI * 441.0 * iIndex / iSampleRate)) < 2e-3);
+        }
+    }
+
+    // Envelope : 10 ms attack to 1, 10 ms decay to 0.5, 10 ms release
+    {
+        CSoundVoiceBank tBank(4, iSampleRate);
+        tBank.setEnvelope(0.01, 0.01, 0.5, 0.01);
+
+        int iVoice = tBank.noteOn(CSoundVoiceBank::wSquare, 100.0, 1.0);
+
+        QVector<float> vSamples(4410);
+        tBank.render(vSamples.data(), vSamples.count());
+
+        QVERIFY(qAbs(vSamples[0]) < 0.01f);
+        QVERIFY(qAbs(qAbs(vSamples[441]) - 1.0f) < 0.02f);
+        QVERIFY(qAbs(qAbs(vSamples[4000]) - 0.5f) < 0.01f);
+
+        tBank.noteOff(iVoice);
+        tBank.render(vSamples.data(), vSamples.count());
+
+        QVERIFY(qAbs(vSamples[4000]) < 1e-6f);
+        QCOMPARE(tBank.activeVoiceCount(), 0);
+    }
+
+    // Saw and noise stay in range, voices are stolen when the bank is full
+    {
+        CSoundVoiceBank tBank(2, iSampleRate);
+        tBank.setEnvelope(0.0, 0.0, 1.0, 0.1);
+
+        tBank.noteOn(CSoundVoiceBank::wSaw, 1000.0, 0.5);
+        int iNoise = tBank.noteOn(CSoundVoiceBank::wNoise, 0.0, 0.5);
+
+        QVector<float> vSamples(iSampleRate);
+        tBank.render(vSamples.data(), vSamples.count());
+
+        double dSum = 0.0;
+
+        for (float fSample : vSamples)
+        {
+            QVERIFY(qAbs(fSample) <= 1.0f);
+            dSum += fSample;
+        }
+
+        QVERIFY(qAbs(dSum / vSamples.count()) < 0.01);
+
+        tBank.noteOff(iNoise);
+        QCOMPARE(tBank.noteOn(CSoundVoiceBank::wSine, 440.0, 0.5), iNoise);
+        QCOMPARE(tBank.activeVoiceCount(), 2);
+    }
+
+    // 16 bit samples are clipped
+    {
+        CSoundVoiceBank tBank(1, iSampleRate);
+        tBank.setEnvelope(0.0, 0.0, 1.0, 0.0);
+        tBank.setMasterGain(4.0);
+        tBank.noteOn(CSoundVoiceBank::wSquare, 100.0, 1.0);
+
+        QVector<qint16> vSamples(1000);
+        tBank.render(vSamples.data(), vSamples.count());
+
+        QCOMPARE(vSamples[100], qint16(32767));
+        QCOMPARE(vSamples[300], qint16(-32767));
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::soundVoiceBankThroughput_data()
+{
+    QTest::addColumn<int>("iVoiceCount");
+
+    QTest::newRow("64 voices") << 64;
+    QTest::newRow("512 voices") << 512;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void CUnitTests::soundVoiceBankThroughput()
+{
+    QFETCH(int, iVoiceCount);
+
+    const int iSampleRate = 44100;
+
+    CSoundVoiceBank tBank(iVoiceCount, iSampleRate);
+    tBank.setEnvelope(0.01, 0.1, 0.5, 0.2);
+
+    for (int iVoice = 0; iVoice < iVoiceCount; iVoice++)
+    {
+        tBank.noteOn(CSoundVoiceBank::EWaveform(iVoice % 4), 100.0 + iVoice, 1.0 / iVoiceCount);
+    }
+
+    // One second of audio per iteration
+    QVector<qint16> vSamples(iSampleRate);
+
+    QBENCHMARK
+    {
+        tBank.render(vSamples.data(), vSamples.count());
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
 QTEST_MAIN(CUnitTests)
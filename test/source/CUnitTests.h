@@ -27,4 +27,40 @@ private slots:
 
     void xml();
     void remoteControlMultiClient();
+    void assemblyHeap();
+    void assemblyHeapStress();
+    void assemblyOptimizer();
+    void assemblyConsoleFrames();
+    void assemblyDebugPauseStop();
+    void assemblyDebugBreakpoints();
+    void qmlLexer();
+    void qmlLexerCorpus();
+    void qmlParallelParse();
+    void qmlParallelParseScaling_data();
+    void qmlParallelParseScaling();
+    void qmlParseCache();
+    void qmlEntityArena();
+    void qmlSymbolResolution();
+    void qmlAnalyzerRules();
+    void qmlPositionIndex();
+    void qmlFormatterFragments();
+    void qmlFormatterCorpus();
+    void qmlXMLStream();
+    void qmlAnalyzerWatch();
+    void qmlAnalyzerWatchMemory();
+    void qmlCorpusGenerator();
+    void qmlNameInterning();
+    void geoReentrantContexts();
+    void geoBatchConversions();
+    void geoBatchThroughput();
+    void geoBatchUTMMGRS();
+    void geoMagneticModel();
+    void geoReferenceFrames();
+    void geoIndexQueries();
+    void geoIndexThroughput_data();
+    void geoIndexThroughput();
+    void soundRingBuffer();
+    void soundVoiceBank();
+    void soundVoiceBankThroughput_data();
+    void soundVoiceBankThroughput();
 };
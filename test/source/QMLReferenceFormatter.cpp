@@ -0,0 +1,81 @@
+
+// Qt
+#include <QMetaEnum>
+
+// Application
+#include "QMLReferenceFormatter.h"
+
+//-------------------------------------------------------------------------------------------------
+
+QMLReferenceFormatter::QMLReferenceFormatter()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+QMLReferenceFormatter::~QMLReferenceFormatter()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLReferenceFormatter::writeReferenceNewLine(QTextStream& stream)
+{
+    stream << "\r\n";
+
+    for (int i = 0; i < m_iIndentation * 4; i++)
+    {
+        stream << " ";
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLReferenceFormatter::writeReferenceDoubleNewLine(QTextStream& stream)
+{
+    stream << "\r\n";
+    writeReferenceNewLine(stream);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLReferenceFormatter::processFragment(QTextStream& stream, EQMLFormatterFragment fragment)
+{
+    QMetaEnum fragmentEnum = QMetaEnum::fromType<EQMLFormatterFragment>();
+    QString sFragment = QString(fragmentEnum.valueToKey(fragment)).remove("qff");
+
+    CXMLNodeList vFragments = m_xGrammar.getNodesByTagName(FORMATTER_TOKEN_FRAGMENT);
+
+    for (CXMLNode xFragment : vFragments)
+    {
+        QString sNames = processMacros(xFragment.attributes()[FORMATTER_TOKEN_NAMES]);
+        QStringList lNames = sNames.split(",");
+
+        if (lNames.contains(sFragment))
+        {
+            CXMLNodeList vActions = xFragment.getNodesByTagName(FORMATTER_TOKEN_ACTION);
+
+            for (CXMLNode xAction : vActions)
+            {
+                QString sType = processMacros(xAction.attributes()[FORMATTER_TOKEN_TYPE]);
+
+                if (sType == FORMATTER_ACTION_NEW_LINE)
+                {
+                    writeReferenceNewLine(stream);
+                }
+                else if (sType == FORMATTER_ACTION_DOUBLE_NEW_LINE)
+                {
+                    writeReferenceDoubleNewLine(stream);
+                }
+                else if (sType == FORMATTER_ACTION_INDENTATION_INC)
+                {
+                    incIndentation();
+                }
+                else if (sType == FORMATTER_ACTION_INDENTATION_DEC)
+                {
+                    decIndentation();
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,49 @@
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+
+// Qt
+#include <QTextStream>
+
+// Application
+#include "QMLTree/QMLFormatter.h"
+
+//-------------------------------------------------------------------------------------------------
+
+//! The fragment processing that QMLFormatter used before it compiled the format definition
+//! Kept unchanged as the reference of the formatter tests : every fragment looks up the definition and writes each action to the stream
+class QMLReferenceFormatter : public QMLFormatter
+{
+public:
+
+    //-------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    //-------------------------------------------------------------------------------------------------
+
+    //! Constructor
+    QMLReferenceFormatter();
+
+    //! Destructor
+    virtual ~QMLReferenceFormatter();
+
+    //-------------------------------------------------------------------------------------------------
+    // Control methods
+    //-------------------------------------------------------------------------------------------------
+
+    //! Processes a fragment of code text
+    virtual void processFragment(QTextStream& stream, EQMLFormatterFragment fragment) Q_DECL_OVERRIDE;
+
+    //-------------------------------------------------------------------------------------------------
+    // Protected control methods
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! Outputs a new line, then the indentation one space at a time
+    void writeReferenceNewLine(QTextStream& stream);
+
+    //! Outputs a double new line
+    void writeReferenceDoubleNewLine(QTextStream& stream);
+};
@@ -0,0 +1,724 @@
+
+// Std
+#include <ctype.h>
+#include <stdio.h>
+
+// Qt
+#include <QChar>
+
+// Application
+#include "QMLTree/QMLComment.h"
+#include "QMLReferenceLexer.h"
+
+//-------------------------------------------------------------------------------------------------
+
+#define SCOPE                   (m_tScope)
+#define GET(a)                  { (a) = getChar(); }
+#define UNGET(a)                { ungetChar((a)); }
+#define STORE(a)                { *(SCOPE.m_pCurrentTokenValue) += QString(QChar(a)); }
+
+#define TOKEN_IDENTIFIER        300
+#define TOKEN_LITERAL           301
+#define TOKEN_BOOLCONSTANT      302
+#define TOKEN_INTEGERCONSTANT   303
+#define TOKEN_REALCONSTANT      304
+#define TOKEN_NULL              305
+#define TOKEN_UNDEFINED         306
+
+#define TOKEN_ASSIGN            310
+#define TOKEN_ADD               311
+#define TOKEN_SUB               312
+#define TOKEN_MUL               313
+#define TOKEN_DIV               314
+#define TOKEN_MOD               315
+#define TOKEN_AND               316
+#define TOKEN_OR                317
+#define TOKEN_XOR               318
+#define TOKEN_SHL               319
+#define TOKEN_SHR               320
+#define TOKEN_ADD_ASSIGN        321
+#define TOKEN_SUB_ASSIGN        322
+#define TOKEN_MUL_ASSIGN        323
+#define TOKEN_DIV_ASSIGN        324
+#define TOKEN_MOD_ASSIGN        325
+#define TOKEN_AND_ASSIGN        326
+#define TOKEN_OR_ASSIGN         327
+#define TOKEN_XOR_ASSIGN        328
+#define TOKEN_SHL_ASSIGN        329
+#define TOKEN_SHR_ASSIGN        330
+#define TOKEN_LOWER             331
+#define TOKEN_GREATER           332
+#define TOKEN_LOWER_EQUALS      333
+#define TOKEN_GREATER_EQUALS    334
+#define TOKEN_EQUALS            335
+#define TOKEN_EQUALS_CHECK      336
+#define TOKEN_NOT_EQUALS        337
+#define TOKEN_NOT_EQUALS_CHECK  338
+#define TOKEN_LOGICAL_AND       339
+#define TOKEN_LOGICAL_OR        340
+#define TOKEN_NOT               341
+#define TOKEN_NOT_NOT           342
+#define TOKEN_INC               343
+#define TOKEN_DEC               344
+#define TOKEN_COMPLEMENT        345
+#define TOKEN_DIMENSION         346
+
+#define TOKEN_IMPORT            500
+#define TOKEN_PROPERTY          501
+#define TOKEN_DEFAULT           502
+#define TOKEN_READ_ONLY         503
+#define TOKEN_ALIAS             504
+#define TOKEN_VAR               505
+#define TOKEN_BOOL              506
+#define TOKEN_INT               507
+#define TOKEN_REAL              508
+#define TOKEN_STRING            509
+#define TOKEN_VARIANT           510
+#define TOKEN_COLOR             511
+#define TOKEN_FUNCTION          512
+#define TOKEN_IF                513
+#define TOKEN_ELSE              514
+#define TOKEN_FOR               515
+#define TOKEN_IN                516
+#define TOKEN_WHILE             517
+#define TOKEN_SWITCH            518
+#define TOKEN_CASE              519
+#define TOKEN_BREAK             520
+#define TOKEN_CONTINUE          521
+#define TOKEN_WITH              522
+#define TOKEN_RETURN            523
+#define TOKEN_TYPEOF            524
+#define TOKEN_PRAGMA            525
+#define TOKEN_ON                526
+#define TOKEN_AS                527
+#define TOKEN_SIGNAL            528
+#define TOKEN_NEW               529
+
+//-------------------------------------------------------------------------------------------------
+
+QMLReferenceLexer::QMLReferenceLexer()
+{
+    m_mTokens["import"] = TOKEN_IMPORT;
+    m_mTokens["property"] = TOKEN_PROPERTY;
+    m_mTokens["default"] = TOKEN_DEFAULT;
+    m_mTokens["readonly"] = TOKEN_READ_ONLY;
+    m_mTokens["alias"] = TOKEN_ALIAS;
+    m_mTokens["function"] = TOKEN_FUNCTION;
+    m_mTokens["if"] = TOKEN_IF;
+    m_mTokens["else"] = TOKEN_ELSE;
+    m_mTokens["for"] = TOKEN_FOR;
+    m_mTokens["in"] = TOKEN_IN;
+    m_mTokens["while"] = TOKEN_WHILE;
+    m_mTokens["switch"] = TOKEN_SWITCH;
+    m_mTokens["case"] = TOKEN_CASE;
+    m_mTokens["break"] = TOKEN_BREAK;
+    m_mTokens["continue"] = TOKEN_CONTINUE;
+    m_mTokens["with"] = TOKEN_WITH;
+    m_mTokens["return"] = TOKEN_RETURN;
+    m_mTokens["typeof"] = TOKEN_TYPEOF;
+    m_mTokens["pragma"] = TOKEN_PRAGMA;
+    m_mTokens["on"] = TOKEN_ON;
+    m_mTokens["as"] = TOKEN_AS;
+    m_mTokens["signal"] = TOKEN_SIGNAL;
+    m_mTokens["var"] = TOKEN_VAR;
+    m_mTokens["new"] = TOKEN_NEW;
+    m_mTokens["null"] = TOKEN_NULL;
+    m_mTokens["undefined"] = TOKEN_UNDEFINED;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+QMLReferenceLexer::~QMLReferenceLexer()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+
+QStringList QMLReferenceLexer::tokenize(const QString& sText)
+{
+    QStringList lTokens;
+    QString sInput(sText);
+    QString sTokenValue;
+    QTextStream tStream(&sInput);
+    UValue tValue;
+
+    SCOPE.m_iLine = 0;
+    SCOPE.m_iColumn = 0;
+    SCOPE.m_iPreviousLine = 0;
+    SCOPE.m_iPreviousColumn = 0;
+    SCOPE.m_iCommentLevel = 0;
+    SCOPE.m_bParsingFloat = false;
+    SCOPE.m_bParsingHexa = false;
+    SCOPE.m_bLineEmpty = true;
+    SCOPE.m_bPreviousLineEmpty = true;
+    SCOPE.m_bDocComment = false;
+    SCOPE.m_pStream = &tStream;
+    SCOPE.m_pCurrentTokenValue = &sTokenValue;
+
+    m_lComments.clear();
+
+    while (true)
+    {
+        int iToken = parseNextToken(&tValue);
+
+        if (iToken == 0)
+            break;
+
+        lTokens << QString("%1 %2 %3 %4")
+                   .arg(iToken)
+                   .arg(SCOPE.m_iPreviousLine)
+                   .arg(SCOPE.m_iPreviousColumn)
+                   .arg(sTokenValue);
+    }
+
+    SCOPE.m_pStream = nullptr;
+    SCOPE.m_pCurrentTokenValue = nullptr;
+
+    return lTokens + m_lComments;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void QMLReferenceLexer::addComment(QPoint pPosition, const QString& sText, int iType)
+{
+    m_lComments << QString("comment %1 %2 %3 %4").arg(pPosition.y()).arg(pPosition.x()).arg(iType).arg(sText);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+// Below is the former lexer of QMLTreeContext, unchanged
+
+int QMLReferenceLexer::parseNextToken(UValue* LVAL)
+{
+    if (SCOPE.m_pCurrentTokenValue != nullptr)
+        SCOPE.m_pCurrentTokenValue->clear();
+
+    SCOPE.m_iCommentLevel   = 0;
+    SCOPE.m_bParsingFloat   = false;
+    SCOPE.m_bParsingHexa    = false;
+
+    int c, d, e;
+    QPoint pCommentStartPosition;
+    bool bCommentStartLineEmpty = SCOPE.m_bLineEmpty;
+
+    // Skip white spaces and comments
+    // Whites are considered to be every ASCII code below 0x21
+
+    while (true)
+    {
+        GET(c);
+
+        if (c == EOF) return 0;
+
+        if (SCOPE.m_iCommentLevel > 0)
+        {
+            if (c == '*')
+            {
+                GET(d);
+                if (d == '/')
+                {
+                    // This is the end of a multi-line comment
+
+                    if (SCOPE.m_pCurrentTokenValue != nullptr)
+                    {
+                        QMLComment::ECommentType eType = SCOPE.m_bDocComment ? QMLComment::ctMultiLineDoc : QMLComment::ctMultiLine;
+                        addComment(pCommentStartPosition, SCOPE.m_pCurrentTokenValue->trimmed(), eType);
+
+                        SCOPE.m_pCurrentTokenValue->clear();
+                    }
+
+                    SCOPE.m_iCommentLevel--;
+                }
+                else
+                {
+                    UNGET(d);
+                }
+            }
+            else
+            {
+                STORE(c);
+            }
+        }
+        else if (c == '/')
+        {
+            GET(d);
+            if (d == '*')
+            {
+                GET(e);
+                if (e == '!')
+                {
+                    // This is the start of a multi-line doc comment
+
+                    SCOPE.m_iCommentLevel++;
+                    SCOPE.m_bDocComment = true;
+
+                    pCommentStartPosition = QPoint(SCOPE.m_iColumn, SCOPE.m_iLine);
+                }
+                else
+                {
+                    UNGET(e);
+
+                    // This is the start of a multi-line comment
+
+                    SCOPE.m_iCommentLevel++;
+                    SCOPE.m_bDocComment = false;
+
+                    pCommentStartPosition = QPoint(SCOPE.m_iColumn, SCOPE.m_iLine);
+                }
+            }
+            else if (d == '/')
+            {
+                // This is a single-line comment
+
+                pCommentStartPosition = QPoint(SCOPE.m_iColumn, SCOPE.m_iLine);
+
+                if (SCOPE.m_iCommentLevel == 0)
+                {
+                    while (c != '\n')
+                    {
+                        GET(c); STORE(c);
+                        if (c == EOF) return 0;
+                    }
+
+                    if (SCOPE.m_pCurrentTokenValue != nullptr)
+                    {
+                        QMLComment::ECommentType eType = bCommentStartLineEmpty ? QMLComment::ctSingleLine : QMLComment::ctSingleLineAtEnd;
+                        addComment(pCommentStartPosition, SCOPE.m_pCurrentTokenValue->trimmed(), eType);
+
+                        SCOPE.m_pCurrentTokenValue->clear();
+                    }
+                }
+            }
+            else
+            {
+                UNGET(d);
+                UNGET(c);
+                break;
+            }
+        }
+        else
+        {
+            if (c > ' ') { UNGET(c); break; }
+
+            bCommentStartLineEmpty = SCOPE.m_bLineEmpty;
+        }
+    }
+
+    if (SCOPE.m_pCurrentTokenValue != nullptr)
+        SCOPE.m_pCurrentTokenValue->clear();
+
+    // Set context parsing stuff
+
+    SCOPE.m_iPreviousLine   = SCOPE.m_iLine;
+    SCOPE.m_iPreviousColumn = SCOPE.m_iColumn;
+
+    GET(c);
+
+    if (c == EOF) return 0;
+
+    // Add, increment, add assign
+    if (c == '+')
+    {
+        STORE(c); GET(d);
+        if (d == '+') { STORE(d); return TOKEN_INC; }
+        if (d == '=') { STORE(d); return TOKEN_ADD_ASSIGN; }
+        UNGET(d); return TOKEN_ADD;
+    }
+
+    // Sub, decrement, sub assign
+    if (c == '-')
+    {
+        STORE(c); GET(d);
+        if (d == '-') { STORE(d); return TOKEN_DEC; }
+        if (d == '=') { STORE(d); return TOKEN_SUB_ASSIGN; }
+        UNGET(d); return TOKEN_SUB;
+    }
+
+    // Mul, mul assign
+    if (c == '*')
+    {
+        STORE(c); GET(d);
+        if (d == '=') { STORE(d); return TOKEN_MUL_ASSIGN; }
+        UNGET(d); return TOKEN_MUL;
+    }
+
+    // Div, div assign
+    if (c == '/')
+    {
+        STORE(c); GET(d);
+        if (d == '=') { STORE(d); return TOKEN_DIV_ASSIGN; }
+        UNGET(d); return TOKEN_DIV;
+    }
+
+    // Modulo, modulo assign (division remainder)
+    if (c == '%')
+    {
+        STORE(c); GET(d);
+        if (d == '=') { STORE(d); return TOKEN_MOD_ASSIGN; }
+        UNGET(d); return TOKEN_MOD;
+    }
+
+    // And, logical and, and assign
+    if (c == '&')
+    {
+        STORE(c); GET(d);
+        if (d == '&') { STORE(d); return TOKEN_LOGICAL_AND; }
+        if (d == '=') { STORE(d); return TOKEN_AND_ASSIGN; }
+        UNGET(d); return TOKEN_AND;
+    }
+
+    // Or, logical or, or assign
+    if (c == '|')
+    {
+        STORE(c); GET(d);
+        if (d == '|') { STORE(d); return TOKEN_LOGICAL_OR; }
+        if (d == '=') { STORE(d); return TOKEN_OR_ASSIGN; }
+        UNGET(d); return TOKEN_OR;
+    }
+
+    // Xor, xor assign
+    if (c == '^')
+    {
+        STORE(c); GET(d);
+        if (d == '=') { STORE(d); return TOKEN_XOR_ASSIGN; }
+        UNGET(d); return TOKEN_XOR;
+    }
+
+    // Lower than, lower or equal, shift left, shift left assign
+    if (c == '<')
+    {
+        STORE(c); GET(d);
+        if (d == '=') { STORE(d); return TOKEN_LOWER_EQUALS; }
+        else
+            if (d == '<')
+            {
+                STORE(d); GET(e);
+                if (e == '=') { STORE(e); return TOKEN_SHL_ASSIGN; }
+                UNGET(e); return TOKEN_SHL;
+            }
+            else
+                if (d == '>')
+                {
+                    // ParserWarning(Ctx, "'<>' operator should be '!='. This is not BASIC ! :)");
+                    STORE(d); return TOKEN_NOT_EQUALS;
+                }
+        UNGET(d); return TOKEN_LOWER;
+    }
+
+    // Greater than, greater or equal, shift right, shift right assign
+    if (c == '>')
+    {
+        STORE(c); GET(d);
+        if (d == '=') { STORE(d); return TOKEN_GREATER_EQUALS; }
+        else
+            if (d == '>')
+            {
+                STORE(d); GET(e);
+                if (e == '=') { STORE(e); return TOKEN_SHR_ASSIGN; }
+                UNGET(e); return TOKEN_SHR;
+            }
+        UNGET(d); return TOKEN_GREATER;
+    }
+
+    // Assign, equals
+    if (c == '=')
+    {
+        STORE(c); GET(d);
+        if (d == '=')
+        {
+            STORE(d); GET(e);
+            if (e == '=')
+            {
+                STORE(e);
+                return TOKEN_EQUALS_CHECK;
+            }
+            UNGET(e); return TOKEN_EQUALS;
+        }
+        UNGET(d); return TOKEN_ASSIGN;
+    }
+
+    // Not, not not, not equals
+    if (c == '!')
+    {
+        STORE(c); GET(d);
+        if (d == '!')
+        {
+            STORE(d);
+            return TOKEN_NOT_NOT;
+        }
+        else if (d == '=')
+        {
+            STORE(d); GET(e);
+            if (e == '=')
+            {
+                STORE(e);
+                return TOKEN_NOT_EQUALS_CHECK;
+            }
+            UNGET(e); return TOKEN_NOT_EQUALS;
+        }
+        UNGET(d); return TOKEN_NOT;
+    }
+
+    // 2's complement
+    if (c == '~') { STORE(c); return TOKEN_COMPLEMENT; }
+
+    // Simple '[' or '[]' dimension operator
+    if (c == '[')
+    {
+        STORE(c);
+        while (1)
+        {
+            GET(d);
+            if (d > ' ')
+            {
+                if (d == ']') { STORE(d); return TOKEN_DIMENSION; }
+                else { UNGET(d); break; }
+            }
+        }
+        return c;
+    }
+
+    // Literal constants
+
+    if (c == '"')
+    {
+        while (1)
+        {
+            GET(c);
+            if (c == EOF ) return 0;
+            if (c == '"' ) break;
+            if (c == '\\') c = parseEscape();
+            STORE(c);
+        }
+
+        LVAL->String = SCOPE.m_pCurrentTokenValue;
+        return TOKEN_LITERAL;
+    }
+
+    if (c == '\'')
+    {
+        while (1)
+        {
+            GET(c);
+            if (c == EOF ) return 0;
+            if (c == '\'' ) break;
+            if (c == '\\') c = parseEscape();
+            STORE(c);
+        }
+
+        LVAL->String = SCOPE.m_pCurrentTokenValue;
+        return TOKEN_LITERAL;
+    }
+
+    // Number starting with a dot
+
+    if (c == '.')
+    {
+        GET(d);
+        if (isdigit(d))
+        {
+            SCOPE.m_bParsingFloat = true;
+            STORE('0'); STORE(c); STORE(d);
+            return parseNumber(LVAL);
+        }
+        STORE(c); UNGET(d);
+        return c;
+    }
+
+    // Number
+
+    if (isdigit(c))
+    {
+        if (c == '0')
+        {
+            GET(d);
+            if (d == 'x' || d == 'X')
+            {
+                STORE(c);
+                STORE(d);
+                SCOPE.m_bParsingHexa = true;
+                return parseNumber(LVAL);
+            }
+            else UNGET(d);
+        }
+        STORE(c);
+        return parseNumber(LVAL);
+    }
+
+    if (isalpha(c) || c == '_' || c == '$')
+    {
+        do { STORE(c); GET(c); }
+        while (c != EOF && (isalnum(c) || c == '_' || c == '$'));
+
+        UNGET(c);
+
+        if (SCOPE.m_pCurrentTokenValue->toLower() == "true")
+        {
+            LVAL->Boolean = true;
+            return TOKEN_BOOLCONSTANT;
+        }
+
+        if (SCOPE.m_pCurrentTokenValue->toLower() == "false")
+        {
+            LVAL->Boolean = false;
+            return TOKEN_BOOLCONSTANT;
+        }
+
+        // Check if this is a keyword
+        if (m_mTokens.contains(*(SCOPE.m_pCurrentTokenValue)))
+        {
+            return m_mTokens[*(SCOPE.m_pCurrentTokenValue)];
+        }
+
+        // This must be an identifier
+        LVAL->String = SCOPE.m_pCurrentTokenValue;
+        return TOKEN_IDENTIFIER;
+    }
+
+    STORE(c);
+    return c;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int QMLReferenceLexer::parseNumber(UValue* LVAL)
+{
+    int c;
+    bool Done = false;
+
+    while (Done == false)
+    {
+        GET(c);
+
+        if (c == EOF) Done = true;
+
+        switch (c)
+        {
+            case '0' : case '1' : case '2' : case '3' : case '4' :
+            case '5' : case '6' : case '7' : case '8' : case '9' : STORE(c); break;
+
+            case 'a' : case 'b' : case 'c' : case 'd' : case 'e' : case 'f' :
+            case 'A' : case 'B' : case 'C' : case 'D' : case 'E' : case 'F' :
+            {
+                if (SCOPE.m_bParsingHexa) { STORE(c); } else { UNGET(c); Done = true; }
+            }
+                break;
+
+            case '.' :
+            {
+                if (!SCOPE.m_bParsingFloat)
+                {
+                    SCOPE.m_bParsingFloat = 1; STORE(c);
+                }
+                else
+                {
+                    UNGET(c); Done = true;
+                }
+            }
+                break;
+
+            default : UNGET(c); Done = true; break;
+        }
+    }
+
+    if (SCOPE.m_bParsingFloat)
+    {
+        LVAL->Real = SCOPE.m_pCurrentTokenValue->toDouble();
+        return TOKEN_REALCONSTANT;
+    }
+    else if (SCOPE.m_bParsingHexa)
+    {
+        LVAL->Integer = SCOPE.m_pCurrentTokenValue->toInt();
+        return TOKEN_INTEGERCONSTANT;
+    }
+
+    LVAL->Integer = SCOPE.m_pCurrentTokenValue->toInt();
+    return TOKEN_INTEGERCONSTANT;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int QMLReferenceLexer::parseEscape()
+{
+    int c;
+
+    GET(c);
+
+    switch (c)
+    {
+        case '"'  : return '"';
+        case '\\' : return '\\'; // Backslash
+        case 'a'  : return '\a'; // Alert
+        case 'b'  : return '\b'; // Back space
+        case 'f'  : return '\f'; // Page feed
+        case 'n'  : return '\n'; // Line feed
+        case 'r'  : return '\r'; // Carriage return
+        case 't'  : return '\t'; // Horizontal tab
+        case 'v'  : return '\v'; // Vertical tab
+    }
+
+    // ParserWarning(Ctx, String("Invalid escape character : ") + String((char)c));
+
+    return ' ';
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int QMLReferenceLexer::getChar()
+{
+    if (SCOPE.m_pStream->atEnd())
+        return EOF;
+
+    int iChar = SCOPE.m_pStream->read(1)[0].toLatin1();
+
+    switch (iChar)
+    {
+        case ' ' :
+            SCOPE.m_iColumn++;
+            break;
+        case '\n' :
+            SCOPE.m_iColumn = 0;
+            SCOPE.m_iLine++;
+            SCOPE.m_bPreviousLineEmpty = SCOPE.m_bLineEmpty;
+            SCOPE.m_bLineEmpty = true;
+            break;
+        case '\t' :
+            SCOPE.m_iColumn += 4;
+            break;
+        case '\r' :
+            break;
+        default:
+            SCOPE.m_iColumn++;
+            SCOPE.m_bPreviousLineEmpty = SCOPE.m_bLineEmpty;
+            SCOPE.m_bLineEmpty = false;
+            break;
+    }
+
+    return iChar;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int QMLReferenceLexer::ungetChar(int iChar)
+{
+    SCOPE.m_pStream->seek(SCOPE.m_pStream->pos() - 1);
+
+    switch (iChar)
+    {
+        case '\n' :
+            SCOPE.m_iColumn = 1024;
+            SCOPE.m_iLine--;
+            SCOPE.m_bLineEmpty = SCOPE.m_bPreviousLineEmpty;
+            break;
+        case '\t' :
+            SCOPE.m_iColumn -= 4;
+            break;
+        case '\r' :
+            break;
+        default:
+            SCOPE.m_iColumn--;
+            break;
+    }
+
+    return iChar;
+}
@@ -0,0 +1,95 @@
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+
+// Qt
+#include <QMap>
+#include <QPoint>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+//-------------------------------------------------------------------------------------------------
+
+//! The character stream lexer that QMLTreeContext used before it scanned a contiguous buffer
+//! Kept unchanged as the reference of the lexer tests, tokenize() has the output format of QMLTreeContext::tokenize()
+class QMLReferenceLexer
+{
+public:
+
+    //-------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    //-------------------------------------------------------------------------------------------------
+
+    //! Constructor
+    QMLReferenceLexer();
+
+    //! Destructor
+    virtual ~QMLReferenceLexer();
+
+    //-------------------------------------------------------------------------------------------------
+    // Control methods
+    //-------------------------------------------------------------------------------------------------
+
+    //! Returns the tokens then the comments of sText
+    QStringList tokenize(const QString& sText);
+
+    //-------------------------------------------------------------------------------------------------
+    // Protected types
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    //! The token value given to the parser
+    union UValue
+    {
+        bool        Boolean;
+        int         Integer;
+        double      Real;
+        QString*    String;
+    };
+
+    //! The state of the former QMLTreeContext::QMLScope used by the lexer
+    class QMLScope
+    {
+    public:
+
+        int                 m_iLine;
+        int                 m_iColumn;
+        int                 m_iPreviousLine;
+        int                 m_iPreviousColumn;
+        int                 m_iCommentLevel;
+        bool                m_bParsingFloat;
+        bool                m_bParsingHexa;
+        bool                m_bLineEmpty;
+        bool                m_bPreviousLineEmpty;
+        bool                m_bDocComment;
+        QTextStream*        m_pStream;
+        QString*            m_pCurrentTokenValue;
+    };
+
+    //-------------------------------------------------------------------------------------------------
+    // Protected control methods
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    int parseNextToken(UValue* LVAL);
+    int parseNumber(UValue* LVAL);
+    int parseEscape();
+    int getChar();
+    int ungetChar(int iChar);
+    void addComment(QPoint pPosition, const QString& sText, int iType);
+
+    //-------------------------------------------------------------------------------------------------
+    // Properties
+    //-------------------------------------------------------------------------------------------------
+
+protected:
+
+    QMap<QString, int>      m_mTokens;
+    QMLScope                m_tScope;
+    QStringList             m_lComments;
+};